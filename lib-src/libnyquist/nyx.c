@@ -72,6 +72,7 @@ LOCAL LVAL                nyx_result;
 LOCAL nyx_rval            nyx_result_type = nyx_error;
 LOCAL XLCONTEXT           nyx_cntxt;
 LOCAL int                 nyx_first_time = 1;
+LOCAL int                 nyx_retain_memory = 0;
 LOCAL LVAL                nyx_obarray;
 LOCAL FLOTYPE             nyx_warp_stretch;
 LOCAL long                nyx_input_length = 0;
@@ -488,6 +489,11 @@ void nyx_init()
 #endif
 }
 
+void nyx_set_retain_memory(int retain)
+{
+   nyx_retain_memory = retain;
+}
+
 void nyx_cleanup()
 {
    // Garbage-collect nyx_result
@@ -509,11 +515,18 @@ void nyx_cleanup()
    // nodes whose value does not get copied during a full copy of the obarray.
    setvalue(xlenter(nyx_get_audio_name()), NIL);
 
-   // Free excess memory segments - does a gc()
-   freesegs();
+   if (nyx_retain_memory) {
+      // Keep the allocated segments and sample pools warm for the next
+      // nyx_init(); just reclaim the garbage now
+      gc();
+   }
+   else {
+      // Free excess memory segments - does a gc()
+      freesegs();
 
-   // Free unused memory pools
-   falloc_gc();
+      // Free unused memory pools
+      falloc_gc();
+   }
 
    // No longer need the callbacks
    nyx_output_cb = NULL;
@@ -29,6 +29,11 @@ extern "C"
    
    void        nyx_init();
    void        nyx_cleanup();
+
+   /* When set, nyx_cleanup() keeps the interpreter's memory segments and
+      sample pools allocated, so the next nyx_init() starts warm instead of
+      regrowing the heap.  Defaults to off. */
+   void        nyx_set_retain_memory(int retain);
    void        nyx_set_xlisp_path(const char *path);
 
    /* should return return 0 for success, -1 for error */
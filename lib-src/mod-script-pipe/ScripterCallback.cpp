@@ -19,6 +19,8 @@
 #include "../../src/Audacity.h"
 #include "../../src/ShuttleGui.h"
 
+#include <string>
+
 #if defined(__WXMSW__)
 #include <wx/init.h>
 #  if defined(__WXDEBUG__)
@@ -145,40 +147,31 @@ int DLL_API RegScriptServerFunc( tpExecScriptServerFunc pFn )
 }
 
 
-wxString Str2;
-wxArrayString aStr;
-unsigned int currentLine;
+// The response, as one flat buffer of UTF-8 bytes.  This used to be split
+// into an array of per-line wxStrings, which for a very large response
+// duplicated it with considerable per-line overhead, and counted characters
+// while writing bytes, corrupting multi-byte characters at chunk edges.
+std::string Str2;
 size_t currentPosition;
 
-// Send the received command to Audacity and build an array of response lines.
-// The response lines can be retrieved by calling DoSrvMore repeatedly.
+// Send the received command to Audacity and keep its response for
+// retrieval in chunks by DoSrvMore.
 int DoSrv(char *pIn)
 {
    // Interpret string as unicode.
    // wxWidgets (now) uses unicode internally.
    // Scripts must send unicode strings (if going beyond 7-bit ASCII).
    // Important for filenames in commands.
-   wxString Str1(pIn, wxConvUTF8); 
+   wxString Str1(pIn, wxConvUTF8);
    Str1.Replace( wxT("\r"), wxT(""));
    Str1.Replace( wxT("\n"), wxT(""));
-   Str2 = wxEmptyString;
-   (*pScriptServerFn)( &Str1 , &Str2);
-
-   Str2 += wxT('\n');
-   size_t outputLength = Str2.Length();
-   aStr.Clear();
-   size_t iStart = 0;
-   size_t i;
-   for(i = 0; i < outputLength; ++i)
-   {
-      if( Str2[i] == wxT('\n') )
-      {
-         aStr.Add( Str2.Mid( iStart, i-iStart) + wxT("\n") );
-         iStart = i+1;
-      }
-   }
+   wxString Out;
+   (*pScriptServerFn)( &Str1 , &Out);
+
+   Out += wxT('\n');
+   const wxScopedCharBuffer buf = Out.utf8_str();
+   Str2.assign( buf.data(), buf.length() );
 
-   currentLine     = 0;
    currentPosition = 0;
 
    return 1;
@@ -186,47 +179,24 @@ int DoSrv(char *pIn)
 
 size_t smin(size_t a, size_t b) { return a < b ? a : b; }
 
-// Write up to nMax characters of the prepared (by DoSrv) response lines.
-// Returns the number of characters sent, including null.
+// Write up to nMax bytes of the response prepared by DoSrv.
+// Returns the number of bytes sent, including null.
 // Zero returned if and only if there's nothing else to send.
 int DoSrvMore(char *pOut, size_t nMax)
 {
-   wxASSERT(currentLine >= 0);
-   wxASSERT(currentPosition >= 0);
-
-   size_t totalLines = aStr.GetCount();
-   while (currentLine < totalLines)
-   {
-      wxString lineString    = aStr[currentLine];
-      size_t lineLength      = lineString.Length();
-      size_t charsLeftInLine = lineLength - currentPosition;
-
-      wxASSERT(charsLeftInLine >= 0);
-
-      if (charsLeftInLine == 0)
-      {
-         // Move to next line
-         ++currentLine;
-         currentPosition = 0;
-      }
-      else
-      {
-         // Write as much of the rest of the line as will fit in the buffer
-         size_t charsToWrite = smin(charsLeftInLine, nMax - 1);
-         memcpy(pOut, 
-                lineString.Mid(currentPosition, 
-                               currentPosition + charsToWrite).mb_str(), 
-                charsToWrite);
-         pOut[charsToWrite] = '\0';
-         currentPosition    += charsToWrite;
-         // Need to cast to prevent compiler warnings
-         int charsWritten = static_cast<int>(charsToWrite + 1);
-         // (Check cast was safe)
-         wxASSERT(static_cast<size_t>(charsWritten) == charsToWrite + 1);
-         return charsWritten;
-      }
-   }
-   return 0;
+   size_t bytesLeft = Str2.size() - currentPosition;
+   if (bytesLeft == 0)
+      return 0;
+
+   size_t bytesToWrite = smin(bytesLeft, nMax - 1);
+   memcpy(pOut, Str2.data() + currentPosition, bytesToWrite);
+   pOut[bytesToWrite] = '\0';
+   currentPosition += bytesToWrite;
+   // Need to cast to prevent compiler warnings
+   int bytesWritten = static_cast<int>(bytesToWrite + 1);
+   // (Check cast was safe)
+   wxASSERT(static_cast<size_t>(bytesWritten) == bytesToWrite + 1);
+   return bytesWritten;
 }
 
 } // End extern "C"
@@ -20,6 +20,9 @@ It handles initialization and termination by subclassing wxApp.
 
 #include "Experimental.h"
 
+#include <chrono>
+#include <vector>
+
 #if 0
 // This may be used to debug memory leaks.
 // See: Visual Leak Dectector @ http://vld.codeplex.com/
@@ -1179,6 +1182,52 @@ AudacityApp::~AudacityApp()
 {
 }
 
+namespace {
+
+// Accumulates the wall time each phase of OnInit takes.  The marks are
+// always collected (a clock read each is all they cost), but the report
+// is written to the log only when --profile-startup was given, so that
+// slow starts can be broken down without a special build.
+class StartupTimer {
+public:
+   StartupTimer()
+   {
+      mLast = mStart = std::chrono::steady_clock::now();
+   }
+
+   // Call at the end of a phase; charges the time since the previous
+   // mark (or construction) to the named phase.
+   void Phase(const wxChar *name)
+   {
+      auto now = std::chrono::steady_clock::now();
+      mPhases.push_back( { name, std::chrono::duration<double>(
+         now - mLast ).count() } );
+      mLast = now;
+   }
+
+   // Writes one line per phase, and a total, to the wxWidgets log
+   // target, which AudacityLogger has replaced by now.
+   void Report()
+   {
+      for (const auto &phase : mPhases)
+         wxLogMessage(wxT("startup: %7.1f ms  %s"),
+            phase.seconds * 1000.0, phase.name);
+      wxLogMessage(wxT("startup: %7.1f ms  total"),
+         std::chrono::duration<double>( mLast - mStart ).count() * 1000.0);
+   }
+
+private:
+   struct Mark {
+      const wxChar *name;
+      double seconds;
+   };
+
+   std::chrono::steady_clock::time_point mStart, mLast;
+   std::vector<Mark> mPhases;
+};
+
+}
+
 // The `main program' equivalent, creating the windows and returning the
 // main frame
 bool AudacityApp::OnInit()
@@ -1199,6 +1248,8 @@ bool AudacityApp::OnInit()
    // cause initialization of wxWidgets' global logger target
    (void) AudacityLogger::Get();
 
+   StartupTimer startupTimer;
+
 #if defined(__WXMAC__)
    // Disable window animation
    wxSystemOptions::SetOption(wxMAC_WINDOW_PLAIN_TRANSITION, 1);
@@ -1345,6 +1396,8 @@ bool AudacityApp::OnInit()
 
    FileNames::SetAudacityPathList( std::move( audacityPathList ) );
 
+   startupTimer.Phase(wxT("search paths"));
+
    // Define languanges for which we have translations, but that are not yet
    // supported by wxWidgets.
    //
@@ -1374,11 +1427,15 @@ bool AudacityApp::OnInit()
    this->AssociateFileTypes();
 #endif
 
+   startupTimer.Phase(wxT("preferences and language"));
+
    theTheme.EnsureInitialised();
 
    // AColor depends on theTheme.
    AColor::Init();
 
+   startupTimer.Phase(wxT("theme"));
+
    // Init DirManager, which initializes the temp directory
    // If this fails, we must exit the program.
    if (!InitTempDir()) {
@@ -1391,14 +1448,15 @@ bool AudacityApp::OnInit()
    // If we're waiitng in a dialog before then we can very easily
    // start multiple instances, defeating the single instance checker.
 
+   startupTimer.Phase(wxT("temporary directory"));
+
    // Initialize the CommandHandler
    InitCommandHandler();
 
    // Initialize the PluginManager
    PluginManager::Get().Initialize();
 
-   // Initialize the ModuleManager, including loading found modules
-   ModuleManager::Get().Initialize(*mCmdHandler);
+   startupTimer.Phase(wxT("plugin registry"));
 
    // Parse command line and handle options that might require
    // immediate exit...no need to initialize all of the audio
@@ -1416,6 +1474,14 @@ bool AudacityApp::OnInit()
       exit(0);
    }
 
+   // Prefs may select larger on-disk blocks, trading some memory for far
+   // fewer files in the project folder; the -b option below overrides.
+   long blockSizeMB = 0;
+   gPrefs->Read(wxT("/Directories/MaxDiskBlockSizeMB"), &blockSizeMB, 0L);
+   if (blockSizeMB > 0)
+      Sequence::SetMaxDiskBlockSize(
+         std::min(100L, std::max(1L, blockSizeMB)) * 1048576);
+
    long lval;
    if (parser->Found(wxT("b"), &lval))
    {
@@ -1488,13 +1554,27 @@ bool AudacityApp::OnInit()
       //wxEventLoopBase::GetActive()->YieldFor(wxEVT_CATEGORY_UI|wxEVT_CATEGORY_USER_INPUT|wxEVT_CATEGORY_UNKNOWN);
       wxEventLoopBase::GetActive()->YieldFor(wxEVT_CATEGORY_UI);
 
+      startupTimer.Phase(wxT("splash screen"));
+
       //JKC: Would like to put module loading here.
 
+      // Initialize the ModuleManager, including loading found modules.
+      // Deferred to here, as JKC wished:  the splash screen is already
+      // up while the module DLLs load, and command lines that only
+      // print a version or decode a file never load them at all.  Any
+      // module that hijacks the panel is still loaded in time for
+      // MakeHijackPanel below.
+      ModuleManager::Get().Initialize(*mCmdHandler);
+
+      startupTimer.Phase(wxT("modules"));
+
       // More initialization
 
       InitDitherers();
       AudioIO::Init();
 
+      startupTimer.Phase(wxT("audio"));
+
 #ifdef __WXMAC__
 
       // On the Mac, users don't expect a program to quit when you close the last window.
@@ -1550,6 +1630,8 @@ bool AudacityApp::OnInit()
       }
    }
 
+   startupTimer.Phase(wxT("project window"));
+
    if( ProjectSettings::Get( *project ).GetShowSplashScreen() ){
       // This may do a check-for-updates at every start up.
       // Mainly this is to tell users of ALPHAS who don't know that they have an ALPHA.
@@ -1559,11 +1641,19 @@ bool AudacityApp::OnInit()
    }
 
    #ifdef USE_FFMPEG
-   FFmpegStartup();
+   // Load the FFmpeg libraries once the window is up rather than before
+   // it; resolving their many symbols is good for a second or two on a
+   // cold start.  They stay resident once loaded, so the first import
+   // finds them ready.
+   CallAfter([]{ FFmpegStartup(); });
    #endif
 
    Importer::Get().Initialize();
 
+   startupTimer.Phase(wxT("importers"));
+   if (parser->Found(wxT("profile-startup")))
+      startupTimer.Report();
+
    // Bug1561: delay the recovery dialog, to avoid crashes.
    CallAfter( [=] () mutable {
       //
@@ -2015,6 +2105,10 @@ std::unique_ptr<wxCmdLineParser> AudacityApp::ParseCommandLine()
    /*i18n-hint: This displays the Audacity version */
    parser->AddSwitch(wxT("v"), wxT("version"), _("display Audacity version"));
 
+   /*i18n-hint: This writes a breakdown of startup times to the log */
+   parser->AddSwitch(wxEmptyString, wxT("profile-startup"),
+                     _("report startup phase timings in the log"));
+
    /*i18n-hint: This is a list of one or more files that Audacity
     *           should open upon startup */
    parser->AddParam(_("audio or project file name"),
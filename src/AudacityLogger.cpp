@@ -53,6 +53,17 @@ enum
    LoggerID_Close
 };
 
+namespace {
+
+// Oldest records fall off the front once this many are retained, so a
+// week of FFmpeg warnings cannot grow the log without bound
+const size_t kMaxLogRecords = 1000;
+
+// The window refreshes at most this often, not once per message
+const int kLogRefreshInterval = 500; // milliseconds
+
+}
+
 AudacityLogger *AudacityLogger::Get()
 {
    static std::once_flag flag;
@@ -75,39 +86,67 @@ AudacityLogger::AudacityLogger()
 {
    mText = NULL;
    mUpdated = false;
+   mLevelLimit = wxLOG_Info;
+
+   mTimer.SetOwner(this);
+   Bind(wxEVT_TIMER, &AudacityLogger::OnTimer, this);
 }
 
 void AudacityLogger::Flush()
 {
-   if (mUpdated && mFrame && mFrame->IsShown()) {
+   if (!(mFrame && mFrame->IsShown()))
+      return;
+
+   wxString text;
+   {
+      std::lock_guard< std::mutex > guard{ mRecordsMutex };
+      if (!mUpdated)
+         return;
       mUpdated = false;
-      mText->ChangeValue(mBuffer);
+      for (const auto &record : mRecords)
+         text << record;
    }
+   mText->ChangeValue(text);
 }
 
-void AudacityLogger::DoLogText(const wxString & str)
+void AudacityLogger::DoLogRecord(wxLogLevel level, const wxString & msg,
+                                 const wxLogRecordInfo & WXUNUSED(info))
 {
-   if (!wxIsMainThread()) {
-      wxMutexGuiEnter();
-   }
+   // Suppressed levels pay only for this comparison; the formatting and
+   // the record are skipped entirely
+   if (level > mLevelLimit)
+      return;
 
-   if (mBuffer.empty()) {
+   wxString record;
+   if (level <= wxLOG_Error)
+      record << _("Error: ");
+   else if (level == wxLOG_Warning)
+      record << _("Warning: ");
+   record << msg << wxT("\n");
+
+   // Only the ring is touched here, so any thread may log without
+   // entering the GUI; the window catches up on the next timer tick
+   std::lock_guard< std::mutex > guard{ mRecordsMutex };
+
+   if (mRecords.empty()) {
       wxString stamp;
 
       TimeStamp(&stamp);
 
-      mBuffer << stamp << _TS("Audacity ") << AUDACITY_VERSION_STRING << wxT("\n");
+      mRecords.push_back(
+         stamp + _TS("Audacity ") + AUDACITY_VERSION_STRING + wxT("\n"));
    }
 
-   mBuffer << str << wxT("\n");
+   mRecords.push_back(record);
+   while (mRecords.size() > kMaxLogRecords)
+      mRecords.pop_front();
 
    mUpdated = true;
+}
 
+void AudacityLogger::OnTimer(wxTimerEvent & WXUNUSED(e))
+{
    Flush();
-
-   if (!wxIsMainThread()) {
-      wxMutexGuiLeave();
-   }
 }
 
 void AudacityLogger::Show(bool show)
@@ -117,18 +156,20 @@ void AudacityLogger::Show(bool show)
       if (mFrame) {
          mFrame->Show(false);
       }
+      mTimer.Stop();
       return;
    }
 
    // If the frame already exists, refresh its contents and show it
    if (mFrame) {
       if (!mFrame->IsShown()) {
-         mText->ChangeValue(mBuffer);
+         mText->ChangeValue(GetLog());
          mText->SetInsertionPointEnd();
          mText->ShowPosition(mText->GetLastPosition());
       }
       mFrame->Show();
       mFrame->Raise();
+      mTimer.Start(kLogRefreshInterval);
       return;
    }
 
@@ -162,7 +203,7 @@ void AudacityLogger::Show(bool show)
       S.StartVerticalLay(true);
       {
          S.SetStyle(wxTE_MULTILINE | wxHSCROLL | wxTE_READONLY);
-         mText = S.AddTextWindow(mBuffer);
+         mText = S.AddTextWindow(GetLog());
 
          S.AddSpace(0, 5);
          S.StartHorizontalLay(wxALIGN_CENTER, 0);
@@ -213,15 +254,19 @@ void AudacityLogger::Show(bool show)
 
    mFrame->Show();
 
+   mTimer.Start(kLogRefreshInterval);
+
    Flush();
 }
 
-#if defined(EXPERIMENTAL_CRASH_REPORT)
 wxString AudacityLogger::GetLog()
 {
-   return mBuffer;
+   wxString text;
+   std::lock_guard< std::mutex > guard{ mRecordsMutex };
+   for (const auto &record : mRecords)
+      text << record;
+   return text;
 }
-#endif
 
 void AudacityLogger::OnCloseWindow(wxCloseEvent & WXUNUSED(e))
 {
@@ -229,6 +274,7 @@ void AudacityLogger::OnCloseWindow(wxCloseEvent & WXUNUSED(e))
    // On the Mac, destroy the window rather than hiding it since the
    // log menu will override the root windows menu if there is no
    // project window open.
+   mTimer.Stop();
    mFrame.reset();
 #else
    Show(false);
@@ -243,8 +289,12 @@ void AudacityLogger::OnClose(wxCommandEvent & WXUNUSED(e))
 
 void AudacityLogger::OnClear(wxCommandEvent & WXUNUSED(e))
 {
-   mBuffer = wxEmptyString;
-   DoLogText(wxT("Log Cleared."));
+   {
+      std::lock_guard< std::mutex > guard{ mRecordsMutex };
+      mRecords.clear();
+   }
+   wxLogMessage(wxT("Log Cleared."));
+   Flush();
 }
 
 void AudacityLogger::OnSave(wxCommandEvent & WXUNUSED(e))
@@ -19,27 +19,33 @@
 #include "Experimental.h"
 
 #include "MemoryX.h"
+#include <deque>
+#include <mutex>
 #include <wx/log.h> // to inherit
 #include <wx/event.h> // to inherit wxEvtHandler
+#include <wx/timer.h> // member variable
 
 class wxFrame;
 class wxTextCtrl;
 
 class AudacityLogger final : public wxEvtHandler, public wxLog {
  public:
- 
+
    // Get the singleton instance or null
    static AudacityLogger *Get();
 
    void Show(bool show = true);
 
-#if defined(EXPERIMENTAL_CRASH_REPORT)
+   // Records above this severity are dropped before formatting, so a
+   // verbose caller costs almost nothing when its level is filtered out
+   void SetLevelLimit(wxLogLevel level) { mLevelLimit = level; }
+
    wxString GetLog();
-#endif
 
  protected:
    void Flush()  override;
-   void DoLogText(const wxString & msg) override;
+   void DoLogRecord(wxLogLevel level, const wxString & msg,
+                    const wxLogRecordInfo & info) override;
 
  private:
    AudacityLogger();
@@ -48,11 +54,18 @@ class AudacityLogger final : public wxEvtHandler, public wxLog {
    void OnClose(wxCommandEvent & e);
    void OnClear(wxCommandEvent & e);
    void OnSave(wxCommandEvent & e);
+   void OnTimer(wxTimerEvent & e);
 
    Destroy_ptr<wxFrame> mFrame;
    wxTextCtrl *mText;
-   wxString mBuffer;
+   wxTimer mTimer;
+
+   // The ring of retained records; oldest records fall off the front
+   // once the ring is full, bounding memory over long sessions
+   std::mutex mRecordsMutex;
+   std::deque<wxString> mRecords;
    bool mUpdated;
+   wxLogLevel mLevelLimit;
 };
 
 #endif
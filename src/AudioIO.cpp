@@ -449,6 +449,7 @@ time warp info and AudioIOListener and whether the playback is looped.
 #include <wx/intl.h>
 #include <wx/debug.h>
 
+#include "Diags.h"
 #include "MissingAliasFileDialog.h"
 #include "Mix.h"
 #include "Resample.h"
@@ -456,6 +457,7 @@ time warp info and AudioIOListener and whether the playback is looped.
 #include "prefs/GUISettings.h"
 #include "Prefs.h"
 #include "Project.h"
+#include "WaveClip.h"
 #include "WaveTrack.h"
 #include "AutoRecovery.h"
 
@@ -469,6 +471,10 @@ time warp info and AudioIOListener and whether the playback is looped.
 
 #ifdef EXPERIMENTAL_MIDI_OUT
    #define MIDI_SLEEP 10 /* milliseconds */
+   // longest the MidiThread waits between deadline checks; a safety net
+   // bounding the end-of-play test and any wake-up that races with the
+   // deadline computation
+   #define MIDI_MAX_SLEEP 100 /* milliseconds */
    // how long do we think the thread that fills MIDI buffers,
    // if it is separate from the portaudio thread,
    // might be delayed due to other threads?
@@ -882,6 +888,109 @@ class MidiThread final : public AudioThread {
 #endif
 
 
+//////////////////////////////////////////////////////////////////////
+//
+//     class PlaybackBufferFillPool
+//
+//////////////////////////////////////////////////////////////////////
+
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+/// \brief A small pool of worker threads over which FillBuffers()
+/// distributes the filling of per-track playback ring buffers.
+///
+/// Each track's Mixer and RingBuffer are touched by exactly one worker
+/// during a dispatch, so those objects need no locking.  The pool's own
+/// bookkeeping uses a mutex and condition variables, which is acceptable
+/// because dispatches happen only on the AudioThread, never in the
+/// PortAudio callback.
+class PlaybackBufferFillPool {
+ public:
+   explicit PlaybackBufferFillPool(size_t nThreads)
+   {
+      mWorkers.reserve(nThreads);
+      for (size_t ii = 0; ii < nThreads; ++ii)
+         mWorkers.emplace_back([this]{ WorkerLoop(); });
+   }
+
+   ~PlaybackBufferFillPool()
+   {
+      {
+         std::lock_guard<std::mutex> guard{ mMutex };
+         mStop = true;
+      }
+      mStartCondition.notify_all();
+      for (auto &worker : mWorkers)
+         worker.join();
+   }
+
+   /// Call function(ii) for each ii in [0, count), distributing the calls
+   /// over the workers, and block until all calls have completed.
+   void FillAll(size_t count, const std::function<void(size_t)> &function)
+   {
+      if (count == 0)
+         return;
+      {
+         std::lock_guard<std::mutex> guard{ mMutex };
+         mFunction = &function;
+         mCount = count;
+         mNextIndex.store(0, std::memory_order_relaxed);
+         mBusy = mWorkers.size();
+         ++mGeneration;
+      }
+      mStartCondition.notify_all();
+      std::unique_lock<std::mutex> lock{ mMutex };
+      mDoneCondition.wait(lock, [this]{ return mBusy == 0; });
+      mFunction = nullptr;
+   }
+
+ private:
+   void WorkerLoop()
+   {
+      unsigned lastGeneration = 0;
+      for (;;) {
+         const std::function<void(size_t)> *function;
+         size_t count;
+         {
+            std::unique_lock<std::mutex> lock{ mMutex };
+            mStartCondition.wait(lock,
+               [&]{ return mStop || mGeneration != lastGeneration; });
+            if (mStop)
+               return;
+            lastGeneration = mGeneration;
+            function = mFunction;
+            count = mCount;
+         }
+         // Claim track indices until none remain
+         for (auto index = mNextIndex.fetch_add(1, std::memory_order_relaxed);
+              index < count;
+              index = mNextIndex.fetch_add(1, std::memory_order_relaxed))
+            (*function)(index);
+         {
+            std::lock_guard<std::mutex> guard{ mMutex };
+            if (--mBusy == 0)
+               mDoneCondition.notify_one();
+         }
+      }
+   }
+
+   std::vector<std::thread> mWorkers;
+   std::mutex mMutex;
+   std::condition_variable mStartCondition;
+   std::condition_variable mDoneCondition;
+   const std::function<void(size_t)> *mFunction{ nullptr };
+   std::atomic<size_t> mNextIndex{ 0 };
+   size_t mCount{ 0 };
+   size_t mBusy{ 0 };
+   unsigned mGeneration{ 0 };
+   bool mStop{ false };
+};
+
 //////////////////////////////////////////////////////////////////////
 //
 //     UI Thread Context
@@ -1178,6 +1287,238 @@ wxArrayString AudioIO::GetInputSourceNames()
 #endif
 }
 
+namespace {
+
+// Bounds and steps of the adaptive buffer length, in milliseconds
+const double MinAdaptiveLatency = 20.0;
+const double MaxAdaptiveLatency = 1000.0;
+const double AdaptiveGrowFactor = 1.5;
+const double AdaptiveShrinkFactor = 0.9;
+// A run must be at least this long, without dropouts, before the
+// learned value shrinks
+const double MinAdaptiveLearnSecs = 30.0;
+
+// Where the buffer length learned for the currently chosen devices is
+// persisted
+wxString LearnedLatencyKey()
+{
+   wxString key = gPrefs->Read(wxT("/AudioIO/Host"), wxT("")) +
+      wxT(":") + gPrefs->Read(wxT("/AudioIO/PlaybackDevice"), wxT("")) +
+      wxT("|") + gPrefs->Read(wxT("/AudioIO/RecordingDevice"), wxT(""));
+   // Device names may contain the preference path separator
+   key.Replace(wxT("/"), wxT("_"));
+   return wxT("/AudioIO/LearnedLatencyDuration/") + key;
+}
+
+// The buffer length to open streams with: the static preference, or the
+// per-device learned value when adaptive sizing is enabled
+double EffectiveLatencyDuration()
+{
+   double latencyDuration = DEFAULT_LATENCY_DURATION;
+   gPrefs->Read(wxT("/AudioIO/LatencyDuration"), &latencyDuration);
+
+   bool adaptive = false;
+   gPrefs->Read(wxT("/AudioIO/AdaptiveLatency"), &adaptive, false);
+   if (adaptive) {
+      double learned = latencyDuration;
+      gPrefs->Read(LearnedLatencyKey(), &learned, latencyDuration);
+      latencyDuration = std::max( MinAdaptiveLatency,
+         std::min( MaxAdaptiveLatency, learned ) );
+   }
+   return latencyDuration;
+}
+
+// Steady-clock seconds, for measuring how long a stream ran
+double StreamClockSeconds()
+{
+   using namespace std::chrono;
+   return duration<double>(
+      steady_clock::now().time_since_epoch() ).count();
+}
+
+// State shared with the callback of the latency measurement stream
+struct LatencyTestData {
+   const float *signal;    // the mono test signal
+   size_t signalLen;
+   size_t played{ 0 };     // frames of the signal emitted so far
+   float *captured;        // receives the first channel of the input
+   size_t capturedLen{ 0 };
+   size_t capacity;
+   unsigned numPlaybackChannels;
+   unsigned numCaptureChannels;
+};
+
+// Emits the test signal on every output channel and keeps the first input
+// channel, until the capture buffer is full
+int audacityLatencyTestCallback(
+   const void *inputBuffer, void *outputBuffer,
+   unsigned long framesPerBuffer, const PaStreamCallbackTimeInfo *,
+   PaStreamCallbackFlags, void *userData)
+{
+   auto &data = *static_cast<LatencyTestData*>(userData);
+
+   if (outputBuffer) {
+      float *out = (float *)outputBuffer;
+      for (unsigned long ii = 0; ii < framesPerBuffer; ++ii) {
+         const float value = data.played < data.signalLen
+            ? data.signal[ data.played++ ] : 0.0f;
+         for (unsigned ch = 0; ch < data.numPlaybackChannels; ++ch)
+            *out++ = value;
+      }
+   }
+
+   if (inputBuffer) {
+      const float *in = (const float *)inputBuffer;
+      for (unsigned long ii = 0;
+           ii < framesPerBuffer && data.capturedLen < data.capacity; ++ii) {
+         data.captured[ data.capturedLen++ ] = *in;
+         in += data.numCaptureChannels;
+      }
+   }
+
+   return data.capturedLen < data.capacity ? paContinue : paComplete;
+}
+
+}
+
+bool AudioIO::MeasureLatencyCorrection(double &correctionMillis)
+{
+   if (IsBusy() || IsStreamActive())
+      return false;
+
+   const PaDeviceInfo *playInfo = Pa_GetDeviceInfo( getPlayDevIndex() );
+   const PaDeviceInfo *recInfo = Pa_GetDeviceInfo( getRecordDevIndex() );
+   if (!playInfo || !recInfo ||
+       playInfo->maxOutputChannels < 1 || recInfo->maxInputChannels < 1)
+      return false;
+
+   const double rate = GetBestRate( true, true, 44100.0 );
+   if (rate == 0.0)
+      return false;
+
+   // The test signal: lead-in silence, then a short rising chirp under a
+   // raised-cosine envelope, so its ends do not click and its echo
+   // correlates sharply at just one lag
+   const size_t leadIn = (size_t)( 0.5 * rate );
+   const size_t chirpLen = (size_t)( 0.2 * rate );
+   const size_t signalLen = leadIn + chirpLen;
+   Floats signal{ signalLen, true };
+   {
+      const double f0 = 500.0, f1 = 4000.0;
+      double phase = 0.0;
+      for (size_t ii = 0; ii < chirpLen; ++ii) {
+         const double frac = double(ii) / chirpLen;
+         phase += 2.0 * M_PI * ( f0 + (f1 - f0) * frac ) / rate;
+         const double envelope = 0.5 * (1.0 - cos(2.0 * M_PI * frac));
+         signal[ leadIn + ii ] = 0.8 * envelope * sin(phase);
+      }
+   }
+
+   // Listen past the end of the signal for the worst plausible round trip
+   const size_t captureLen = signalLen + (size_t)( 1.0 * rate );
+   Floats captured{ captureLen, true };
+
+   // Open the devices the way StartPortAudioStream would, with the
+   // buffer length of the preferences, so the measurement reflects the
+   // configuration that recording will actually use
+   double latencyDuration = EffectiveLatencyDuration();
+
+   PaStreamParameters playbackParameters{};
+   playbackParameters.device = getPlayDevIndex();
+   playbackParameters.sampleFormat = paFloat32;
+   playbackParameters.hostApiSpecificStreamInfo = NULL;
+   playbackParameters.channelCount =
+      std::min( 2, playInfo->maxOutputChannels );
+   {
+      // Match the WASAPI special case of StartPortAudioStream (bug 1949)
+      const PaHostApiInfo *hostInfo = Pa_GetHostApiInfo(playInfo->hostApi);
+      bool isWASAPI = (hostInfo && hostInfo->type == paWASAPI);
+      playbackParameters.suggestedLatency =
+         isWASAPI ? 0.0 : latencyDuration / 1000.0;
+   }
+
+   PaStreamParameters captureParameters{};
+   captureParameters.device = getRecordDevIndex();
+   captureParameters.sampleFormat = paFloat32;
+   captureParameters.hostApiSpecificStreamInfo = NULL;
+   captureParameters.channelCount = 1;
+   captureParameters.suggestedLatency = latencyDuration / 1000.0;
+
+   LatencyTestData data{
+      signal.get(), signalLen, 0,
+      captured.get(), 0, captureLen,
+      (unsigned)playbackParameters.channelCount,
+      (unsigned)captureParameters.channelCount };
+
+   PaStream *stream = NULL;
+   PaError err = Pa_OpenStream( &stream,
+      &captureParameters, &playbackParameters, rate,
+      paFramesPerBufferUnspecified, paNoFlag,
+      audacityLatencyTestCallback, &data );
+   if (err != paNoError)
+      return false;
+
+   err = Pa_StartStream( stream );
+   if (err != paNoError) {
+      Pa_CloseStream( stream );
+      return false;
+   }
+
+   while (Pa_IsStreamActive( stream ) == 1)
+      wxMilliSleep( 50 );
+   Pa_CloseStream( stream );
+
+   if (data.capturedLen < captureLen)
+      return false;
+
+   // Find the chirp in the capture by normalized cross-correlation, so
+   // neither the playback level nor the input gain matters.  The window
+   // energy rolls from lag to lag; only the dot product is O(chirpLen).
+   const float *chirp = signal.get() + leadIn;
+   double chirpEnergy = 0.0;
+   for (size_t ii = 0; ii < chirpLen; ++ii)
+      chirpEnergy += chirp[ii] * (double)chirp[ii];
+   if (chirpEnergy <= 0.0)
+      return false;
+
+   double windowEnergy = 0.0;
+   for (size_t ii = 0; ii < chirpLen; ++ii)
+      windowEnergy += captured[ii] * (double)captured[ii];
+
+   const size_t nLags = captureLen - chirpLen;
+   double bestScore = 0.0;
+   size_t bestLag = 0;
+   for (size_t lag = 0; lag < nLags; ++lag) {
+      double dot = 0.0;
+      const float *in = captured.get() + lag;
+      for (size_t ii = 0; ii < chirpLen; ++ii)
+         dot += in[ii] * (double)chirp[ii];
+      const double score = dot / sqrt( chirpEnergy *
+         std::max( windowEnergy, 1e-12 ) );
+      if (score > bestScore) {
+         bestScore = score;
+         bestLag = lag;
+      }
+      windowEnergy += captured[lag + chirpLen] * (double)captured[lag + chirpLen]
+         - captured[lag] * (double)captured[lag];
+   }
+
+   // Anything this weak is noise, not an echo of the chirp
+   if (bestScore < 0.25)
+      return false;
+
+   // The chirp went out leadIn frames into the output signal and came
+   // back bestLag frames into the input; the difference is the round trip
+   const double roundTrip = ( double(bestLag) - double(leadIn) ) / rate;
+   if (roundTrip < 0.0)
+      return false;
+
+   // The compensation preference shifts recorded audio leftward, so it
+   // is the negative of the round trip
+   correctionMillis = -1000.0 * roundTrip;
+   return true;
+}
+
 static PaSampleFormat AudacityToPortAudioSampleFormat(sampleFormat format)
 {
    switch(format) {
@@ -1250,8 +1591,18 @@ bool AudioIO::StartPortAudioStream(const AudioIOStartStreamOptions &options,
    PaStreamParameters playbackParameters{};
    PaStreamParameters captureParameters{};
 
-   double latencyDuration = DEFAULT_LATENCY_DURATION;
-   gPrefs->Read(wxT("/AudioIO/LatencyDuration"), &latencyDuration);
+   double latencyDuration = EffectiveLatencyDuration();
+
+   // Note the configuration for UpdateAdaptiveLatency() and reset its
+   // diagnostics for the run beginning now
+   mUsedLatencyDuration = latencyDuration;
+   mXRunsDetected.store( 0, std::memory_order_relaxed );
+   mPlaybackLowWaterMark.store( (size_t)-1, std::memory_order_relaxed );
+   mFillDeadlineMisses.store( 0, std::memory_order_relaxed );
+   mMaxFillUs.store( 0, std::memory_order_relaxed );
+   mWorstFillTrackIoUs.store( 0, std::memory_order_relaxed );
+   mStreamStartClockTime = StreamClockSeconds();
+   mStreamEndClockTime = 0.0;
 
    if( numPlaybackChannels > 0)
    {
@@ -1558,6 +1909,8 @@ int AudioIO::StartStream(const TransportTracks &tracks,
    mPlaybackMixers.reset();
    mCaptureBuffers.reset();
    mResample.reset();
+   mCaptureScratch.reset();
+   mResampleScratch.reset();
    mTimeQueue.mData.reset();
 
 #ifdef EXPERIMENTAL_MIDI_OUT
@@ -1684,6 +2037,9 @@ int AudioIO::StartStream(const TransportTracks &tracks,
       mTimeQueue.mData[0] = mTimeQueue.mLastTime;
    // else recording only without overdub
 
+   // Stale anchors must not leak into this stream's GetStreamTime()
+   ResetStreamTime( mTimeQueue.mLastTime );
+
 #ifdef EXPERIMENTAL_SCRUBBING_SUPPORT
    if (scrubbing)
    {
@@ -1704,9 +2060,12 @@ int AudioIO::StartStream(const TransportTracks &tracks,
    // so that they will have data in them when the stream starts.  Having the
    // audio thread call FillBuffers here makes the code more predictable, since
    // FillBuffers will ALWAYS get called from the Audio thread.
-   mAudioThreadShouldCallFillBuffersOnce = true;
+   const auto primeCount =
+      mFillOnceCompleteCount.load( std::memory_order_relaxed );
+   PostTransportCommand( TransportCommand::FillBuffersOnce );
 
-   while( mAudioThreadShouldCallFillBuffersOnce ) {
+   while( mFillOnceCompleteCount.load( std::memory_order_acquire )
+         == primeCount ) {
       auto interval = 50ull;
       if (options.playbackStreamPrimer) {
          interval = options.playbackStreamPrimer();
@@ -1746,7 +2105,7 @@ int AudioIO::StartStream(const TransportTracks &tracks,
       // Probably not needed so urgently before portaudio thread start for usual
       // playback, since our ring buffers have been primed already with 4 sec
       // of audio, but then we might be scrubbing, so do it.
-      mAudioThreadFillBuffersLoopRunning = true;
+      PostTransportCommand( TransportCommand::StartFillLoop );
 
       // Now start the PortAudio stream!
       PaError err;
@@ -1755,7 +2114,7 @@ int AudioIO::StartStream(const TransportTracks &tracks,
       if( err != paNoError )
       {
          mStreamToken = 0;
-         mAudioThreadFillBuffersLoopRunning = false;
+         PostTransportCommand( TransportCommand::StopFillLoop );
          if (pListener && mNumCaptureChannels > 0)
             pListener->OnAudioIOStopRecording();
          StartStreamCleanup();
@@ -1858,6 +2217,17 @@ bool AudioIO::AllocateBuffers(
             mPlaybackBuffers.reinit(mPlaybackTracks.size());
             mPlaybackMixers.reinit(mPlaybackTracks.size());
 
+            // Start workers to fill the ring buffers in parallel when
+            // there are enough tracks for that to pay; the pool persists
+            // across streams once created.
+            if (!mFillPool && mPlaybackTracks.size() > 1) {
+               const auto nThreads = std::min<size_t>(
+                  mPlaybackTracks.size(),
+                  std::max( 2u, std::thread::hardware_concurrency() ) );
+               mFillPool =
+                  std::make_unique<PlaybackBufferFillPool>( nThreads );
+            }
+
             const Mixer::WarpOptions &warpOptions =
 #ifdef EXPERIMENTAL_SCRUBBING_SUPPORT
                scrubbing
@@ -1879,6 +2249,16 @@ bool AudioIO::AllocateBuffers(
             mPlaybackQueueMinimum =
                std::min( mPlaybackQueueMinimum, playbackBufferSize );
 
+            // If the Audio thread kept a pre-roll cache for this start
+            // position, start the mixers beyond the cached span, and below
+            // copy the cached samples into the ring buffers, so that the
+            // priming FillBuffers does no decoding for the first seconds
+            std::unique_lock<std::mutex> prerollLock{ mPrerollMutex };
+            size_t prerollFrames = 0;
+            if ( !scrubbing && tracks.prerollTracks.empty() )
+               prerollFrames = ValidPrerollFrames( t0, t1 );
+            const double prerollTime = prerollFrames / mRate;
+
             for (unsigned int i = 0; i < mPlaybackTracks.size(); i++)
             {
                // Bug 1763 - We must fade in from zero to avoid a click on starting.
@@ -1913,7 +2293,7 @@ bool AudioIO::AllocateBuffers(
                   // Don't throw for read errors, just play silence:
                   false,
                   warpOptions,
-                  mPlaybackSchedule.mT0,
+                  mPlaybackSchedule.mT0 + prerollTime,
                   endTime,
                   1,
                   std::max( mPlaybackSamplesToCopy, mPlaybackQueueMinimum ),
@@ -1921,6 +2301,21 @@ bool AudioIO::AllocateBuffers(
                   mRate, floatSample, false);
                mPlaybackMixers[i]->ApplyTrackGains(false);
             }
+
+            if (prerollFrames > 0) {
+               // Advance the schedule over the cached span and queue the
+               // samples, just as a first FillBuffers pass would have
+               mPlaybackSchedule.RealTimeAdvance( prerollTime );
+               mTimeQueue.Producer( mPlaybackSchedule, mRate, 1.0,
+                  prerollFrames );
+               for (unsigned int i = 0; i < mPlaybackTracks.size(); i++)
+                  mPlaybackBuffers[i]->Put(
+                     (samplePtr)mPrerollCache.buffers[i].data(),
+                     floatSample, prerollFrames, 0 );
+               // Single-shot: the mixers have moved past the cached span
+               mPrerollCache.valid = false;
+            }
+            prerollLock.unlock();
          }
 
          if( mNumCaptureChannels > 0 )
@@ -1940,8 +2335,15 @@ bool AudioIO::AllocateBuffers(
 
             mCaptureBuffers.reinit(mCaptureTracks.size());
             mResample.reinit(mCaptureTracks.size());
+            mCaptureScratch.reinit(mCaptureTracks.size());
+            mResampleScratch.reinit(mCaptureTracks.size());
             mFactor = sampleRate / mRate;
 
+            // A drain can consume at most a ring buffer's worth at once;
+            // float covers the widest of the sample formats
+            const size_t scratchSize = (size_t)
+               lrint( captureBufferSize * std::max( 1.0, mFactor ) ) + 1;
+
             for( unsigned int i = 0; i < mCaptureTracks.size(); i++ )
             {
                mCaptureBuffers[i] = std::make_unique<RingBuffer>(
@@ -1949,6 +2351,20 @@ bool AudioIO::AllocateBuffers(
                mResample[i] =
                   std::make_unique<Resample>(true, mFactor, mFactor);
                   // constant rate resampling
+               mCaptureScratch[i].Allocate( scratchSize, floatSample );
+               mResampleScratch[i].Allocate( captureBufferSize, floatSample );
+            }
+
+            // The same worker pool that fills playback ring buffers also
+            // drains the capture side, one channel per task, so many-channel
+            // recordings do not serialize all their appends and summary
+            // computation on the AudioThread
+            if (!mFillPool && mCaptureTracks.size() > 1) {
+               const auto nThreads = std::min<size_t>(
+                  mCaptureTracks.size(),
+                  std::max( 2u, std::thread::hardware_concurrency() ) );
+               mFillPool =
+                  std::make_unique<PlaybackBufferFillPool>( nThreads );
             }
          }
       }
@@ -1990,6 +2406,8 @@ void AudioIO::StartStreamCleanup(bool bOnlyBuffers)
    mPlaybackMixers.reset();
    mCaptureBuffers.reset();
    mResample.reset();
+   mCaptureScratch.reset();
+   mResampleScratch.reset();
    mTimeQueue.mData.reset();
 
    if(!bOnlyBuffers)
@@ -2100,6 +2518,7 @@ bool AudioIO::StartPortMidiStream()
       Pm_Synchronize(mMidiStream); // start using timestamps
       // start midi output flowing (pending first audio callback)
       mMidiThreadFillBuffersLoopRunning = true;
+      WakeMidiThread();
    }
    return (mLastPmError == pmNoError);
 }
@@ -2145,9 +2564,8 @@ void AudioIO::StopStream()
    {
       // PortAudio callback can use the information that we are stopping to fade
       // out the audio.  Give PortAudio callback a chance to do so.
-      mAudioThreadFillBuffersLoopRunning = false;
-      long latency;
-      gPrefs->Read(  wxT("/AudioIO/LatencyDuration"), &latency, DEFAULT_LATENCY_DURATION );
+      PostTransportCommand( TransportCommand::StopFillLoop );
+      long latency = (long) EffectiveLatencyDuration();
       // If we can gracefully fade out in 200ms, with the faded-out play buffers making it through 
       // the sound card, then do so.  If we can't, don't wait around.  Just stop quickly and accept 
       // there will be a click.
@@ -2188,7 +2606,7 @@ void AudioIO::StopStream()
    // if the user brought us here.
    //
 
-   mAudioThreadFillBuffersLoopRunning = false;
+   PostTransportCommand( TransportCommand::StopFillLoop );
 
    // Audacity can deadlock if it tries to update meters while
    // we're stopping PortAudio (because the meter updating code
@@ -2228,6 +2646,7 @@ void AudioIO::StopStream()
 
 #ifdef USE_MIDI_THREAD
       mMidiThreadFillBuffersLoopRunning = false; // stop output to stream
+      WakeMidiThread();
       // but output is in another thread. Wait for output to stop...
       while (mMidiThreadFillBuffersLoopActive) {
          wxMilliSleep(1);
@@ -2276,15 +2695,37 @@ void AudioIO::StopStream()
       // to the target WaveTrack.  To do this, we ask the audio thread to
       // call FillBuffers one last time (it normally would not do so since
       // Pa_GetStreamActive() would now return false
-      mAudioThreadShouldCallFillBuffersOnce = true;
+      const auto flushCount =
+         mFillOnceCompleteCount.load( std::memory_order_relaxed );
+      PostTransportCommand( TransportCommand::FillBuffersOnce );
 
-      while( mAudioThreadShouldCallFillBuffersOnce )
+      while( mFillOnceCompleteCount.load( std::memory_order_acquire )
+            == flushCount )
       {
          // LLL:  Experienced recursive yield here...once.
          wxTheApp->Yield(true); // Pass true for onlyIfNeeded to avoid recursive call error.
          wxMilliSleep( 50 );
       }
 
+      // One learning step of adaptive buffer sizing, now that the run's
+      // dropout record is complete
+      UpdateAdaptiveLatency();
+
+      // One structured line per stream for the log, healthy or not;
+      // field=value so scripts can grep a glitchy machine's history
+      mStreamEndClockTime = StreamClockSeconds();
+      {
+         const auto t = GetTelemetry();
+         wxLogMessage(
+            wxT("AudioIO telemetry: duration_s=%.1f latency_ms=%.0f")
+            wxT(" xruns=%u playback_low_water=%lld")
+            wxT(" fill_deadline_misses=%u max_fill_ms=%.1f")
+            wxT(" worst_fill_io_ms=%.1f"),
+            t.streamSeconds, t.latencyMs, t.xruns,
+            t.playbackLowWaterFrames, t.fillDeadlineMisses,
+            t.maxFillMs, t.worstFillTrackIoMs );
+      }
+
       //
       // Everything is taken care of.  Now, just free all the resources
       // we allocated in StartStream()
@@ -2304,6 +2745,8 @@ void AudioIO::StopStream()
       {
          mCaptureBuffers.reset();
          mResample.reset();
+         mCaptureScratch.reset();
+         mResampleScratch.reset();
 
          //
          // We only apply latency correction when we actually played back
@@ -2388,6 +2831,12 @@ void AudioIO::StopStream()
    mNumCaptureChannels = 0;
    mNumPlaybackChannels = 0;
 
+   // Keep the first seconds at this position decoded, so an immediate
+   // replay from the same place starts without priming latency
+   if (!mPlaybackTracks.empty() && mPlaybackSchedule.PlayingStraight())
+      SchedulePreroll( mPlaybackTracks, mPlaybackSchedule.mT0,
+         mPlaybackSchedule.mT1, mRate, mPlaybackSchedule.mEnvelope );
+
    mPlaybackTracks.clear();
    mCaptureTracks.clear();
 #ifdef USE_MIDI
@@ -2407,6 +2856,149 @@ void AudioIO::StopStream()
    mPlaybackSchedule.ResetMode();
 }
 
+namespace {
+// How much audio the pre-roll cache keeps decoded ahead of a stopped cursor
+const double PrerollCacheSecs = 4.0;
+}
+
+void AudioIO::SchedulePreroll( const WaveTrackArray &tracks, double t0,
+   double t1, double rate, const BoundedEnvelope *envelope )
+{
+   if (IsStreamActive() || tracks.empty() || rate <= 0 || t1 <= t0)
+      return;
+   mPrerollRequest.Write( { tracks, t0, t1, rate, envelope } );
+   mPrerollNeeded.store( true, std::memory_order_release );
+   // Wake the AudioThread so decoding starts at once
+   { std::lock_guard<std::mutex> guard{ mAudioThreadWakeMutex }; }
+   mAudioThreadWakeCondition.notify_all();
+}
+
+int AudioIO::TrackDirtySignature( const WaveTrack &track )
+{
+   // Summarize the clips' dirty counters, which the same editing paths that
+   // invalidate WaveClip's display caches increment
+   int result = 0;
+   for ( const auto &clip : track.GetClips() )
+      result += clip->GetDirty() + 1;
+   return result;
+}
+
+size_t AudioIO::ValidPrerollFrames( double t0, double t1 )
+{
+   const auto &cache = mPrerollCache;
+   if ( !cache.valid || !mPlaybackSchedule.PlayingStraight() )
+      return 0;
+   if ( cache.rate != mRate || cache.t0 != t0 || cache.t1 != t1 ||
+        cache.envelope != mPlaybackSchedule.mEnvelope )
+      return 0;
+   if ( cache.tracks.size() != mPlaybackTracks.size() )
+      return 0;
+   for (size_t ii = 0; ii < cache.tracks.size(); ++ii)
+      if ( cache.tracks[ii] != mPlaybackTracks[ii] ||
+           cache.signatures[ii] !=
+              TrackDirtySignature( *mPlaybackTracks[ii] ) )
+         return 0;
+   return cache.frames;
+}
+
+void AudioIO::FillPrerollCache()
+{
+   const auto request = mPrerollRequest.Read();
+   if (request.tracks.empty() || request.rate <= 0)
+      return;
+
+   std::lock_guard<std::mutex> guard{ mPrerollMutex };
+   auto &cache = mPrerollCache;
+   cache.valid = false;
+   cache.tracks = request.tracks;
+   cache.t0 = request.t0;
+   cache.t1 = request.t1;
+   cache.rate = request.rate;
+   cache.envelope = request.envelope;
+
+   const double endTime =
+      std::min( request.t1, request.t0 + PrerollCacheSecs );
+   const auto frames = (size_t)std::max( 0.0,
+      floor( ( endTime - request.t0 ) * request.rate ) );
+   if (frames == 0)
+      return;
+
+   const auto nTracks = request.tracks.size();
+   cache.buffers.resize( nTracks );
+   cache.signatures.resize( nTracks );
+   const size_t bufferSize = 4096;
+   for (size_t ii = 0; ii < nTracks; ++ii) {
+      auto &buffer = cache.buffers[ii];
+      buffer.assign( frames, 0.0f );
+      cache.signatures[ii] = TrackDirtySignature( *request.tracks[ii] );
+
+      // As in StartStream, one mixer per track: no actual mixing, just
+      // decode, resampling, format conversion and possible warping
+      WaveTrackConstArray mixTracks;
+      mixTracks.push_back( request.tracks[ii] );
+      Mixer mixer( mixTracks,
+         // Don't throw for read errors, just cache silence:
+         false,
+         Mixer::WarpOptions{ request.envelope },
+         request.t0, endTime, 1, bufferSize, false,
+         request.rate, floatSample, false );
+      mixer.ApplyTrackGains(false);
+
+      size_t position = 0;
+      while (position < frames) {
+         const auto processed =
+            mixer.Process( std::min( bufferSize, frames - position ) );
+         if (processed == 0)
+            break;
+         const auto samples = (const float *)mixer.GetBuffer();
+         const auto count = std::min( processed, frames - position );
+         std::copy( samples, samples + count, buffer.begin() + position );
+         position += count;
+      }
+   }
+   cache.frames = frames;
+   cache.valid = true;
+}
+
+void AudioIO::UpdateAdaptiveLatency()
+{
+   bool adaptive = false;
+   gPrefs->Read(wxT("/AudioIO/AdaptiveLatency"), &adaptive, false);
+   if (!adaptive || mUsedLatencyDuration <= 0)
+      return;
+
+   const auto xruns = mXRunsDetected.load( std::memory_order_relaxed );
+   const double ranSecs = StreamClockSeconds() - mStreamStartClockTime;
+
+   double learned = mUsedLatencyDuration;
+   if (xruns > 0)
+      // Dropouts are what the user hears; back off quickly
+      learned *= AdaptiveGrowFactor;
+   else if (ranSecs >= MinAdaptiveLearnSecs) {
+      // A long clean run earns a small step toward lower latency -- but
+      // not if the playback queue ever ran dry meanwhile; such a gap is
+      // the fill side's fault and no smaller device buffer can be
+      // inferred from surviving it
+      const auto lowWater =
+         mPlaybackLowWaterMark.load( std::memory_order_relaxed );
+      if (mNumPlaybackChannels == 0 || lowWater > 0)
+         learned *= AdaptiveShrinkFactor;
+      else
+         return;
+   }
+   else
+      // Too short a run to conclude anything
+      return;
+
+   learned = std::max( MinAdaptiveLatency,
+      std::min( MaxAdaptiveLatency, learned ) );
+   if (learned != mUsedLatencyDuration) {
+      gPrefs->Write( LearnedLatencyKey(), learned );
+      gPrefs->Flush();
+   }
+   mUsedLatencyDuration = 0.0;
+}
+
 void AudioIO::SetPaused(bool state)
 {
    if (state != mPaused)
@@ -2422,6 +3014,11 @@ void AudioIO::SetPaused(bool state)
    }
 
    mPaused = state;
+
+#ifdef EXPERIMENTAL_MIDI_OUT
+   // Let the MidiThread send its all-notes-off, or resume, right away
+   WakeMidiThread();
+#endif
 }
 
 #ifdef EXPERIMENTAL_SCRUBBING_SUPPORT
@@ -2546,24 +3143,65 @@ AudioThread::ExitCode AudioThread::Entry()
       auto loopPassStart = Clock::now();
       const auto interval = ScrubPollInterval_ms;
 
+      // Drain the transport commands sent from the UI thread and the
+      // PortAudio callback.  Only this thread writes the state flags now.
+      bool fillOnce = false;
+      for (;;) {
+         const auto command = gAudioIO->mTransportCommands.Read();
+         if (command == TransportCommand::None)
+            break;
+         switch (command) {
+         case TransportCommand::FillBuffersOnce:
+            fillOnce = true;
+            break;
+         case TransportCommand::StartFillLoop:
+            gAudioIO->mAudioThreadFillBuffersLoopRunning = true;
+            break;
+         case TransportCommand::StopFillLoop:
+            gAudioIO->mAudioThreadFillBuffersLoopRunning = false;
+            break;
+         default:
+            break;
+         }
+      }
+
       // Set LoopActive outside the tests to avoid race condition
       gAudioIO->mAudioThreadFillBuffersLoopActive = true;
-      if( gAudioIO->mAudioThreadShouldCallFillBuffersOnce )
+      if( fillOnce )
       {
+         // The flag tells FillBuffers itself that this is a priming or
+         // flushing call; the counter acknowledges completion to the
+         // sender of the command
+         gAudioIO->mAudioThreadShouldCallFillBuffersOnce = true;
          gAudioIO->FillBuffers();
          gAudioIO->mAudioThreadShouldCallFillBuffersOnce = false;
+         gAudioIO->mFillOnceCompleteCount
+            .fetch_add( 1, std::memory_order_release );
       }
       else if( gAudioIO->mAudioThreadFillBuffersLoopRunning )
       {
          gAudioIO->FillBuffers();
       }
+      else if( gAudioIO->mPrerollNeeded.exchange( false ) )
+      {
+         // The transport is stopped; use the idle time to keep the next
+         // start position decoded and mixed
+         gAudioIO->FillPrerollCache();
+      }
       gAudioIO->mAudioThreadFillBuffersLoopActive = false;
 
+      // Sleep, but wake at once if another command arrives
+      std::unique_lock<std::mutex> lock{ gAudioIO->mAudioThreadWakeMutex };
+      const auto pending = [gAudioIO]{
+         return gAudioIO->mTransportCommands.Pending() ||
+            gAudioIO->mPrerollNeeded.load( std::memory_order_relaxed );
+      };
       if ( gAudioIO->mPlaybackSchedule.Interactive() )
-         std::this_thread::sleep_until(
-            loopPassStart + std::chrono::milliseconds( interval ) );
+         gAudioIO->mAudioThreadWakeCondition.wait_until( lock,
+            loopPassStart + std::chrono::milliseconds( interval ), pending );
       else
-         Sleep(10);
+         gAudioIO->mAudioThreadWakeCondition.wait_for( lock,
+            std::chrono::milliseconds( 10 ), pending );
    }
 
    return 0;
@@ -2579,14 +3217,30 @@ MidiThread::ExitCode MidiThread::Entry()
    {
       // Set LoopActive outside the tests to avoid race condition
       gAudioIO->mMidiThreadFillBuffersLoopActive = true;
-      if( gAudioIO->mMidiThreadFillBuffersLoopRunning &&
+      double waitMs = MIDI_SLEEP;
+      const bool running = gAudioIO->mMidiThreadFillBuffersLoopRunning;
+      if( running &&
           // mNumFrames signals at least one callback, needed for MidiTime()
           gAudioIO->mNumFrames > 0)
       {
-         gAudioIO->FillMidiBuffers();
+         waitMs = gAudioIO->FillMidiBuffers();
       }
+      else if( !running )
+         // Nothing to emit until the transport restarts MIDI output, and
+         // WakeMidiThread() interrupts the wait when it does
+         waitMs = MIDI_MAX_SLEEP;
       gAudioIO->mMidiThreadFillBuffersLoopActive = false;
-      Sleep(MIDI_SLEEP);
+
+      // Wait out the deadline computed from the audio clock, but wake at
+      // once when the transport starts, stops or pauses meanwhile
+      const bool paused = gAudioIO->IsPaused();
+      std::unique_lock<std::mutex> lock{ gAudioIO->mMidiThreadWakeMutex };
+      gAudioIO->mMidiThreadWakeCondition.wait_for( lock,
+         std::chrono::milliseconds( (long long) waitMs ),
+         [&]{
+            return gAudioIO->mMidiThreadFillBuffersLoopRunning != running ||
+               gAudioIO->IsPaused() != paused;
+         } );
    }
    return 0;
 }
@@ -2629,6 +3283,22 @@ size_t AudioIO::GetCommonlyAvailCapture()
 // (which communicates with the audio device).
 void AudioIO::FillBuffers()
 {
+   DIAG_SCOPE( "AudioThread FillBuffers" );
+
+   // Telemetry: note how much queued playback the consumer still held.
+   // If this pass takes longer than that, the callback can underrun
+   // before the refill lands.  Ignore the priming pass, whose queue is
+   // legitimately empty.
+   const bool steadyState =
+      mAudioThreadFillBuffersLoopRunning.load( std::memory_order_relaxed ) &&
+      !mAudioThreadShouldCallFillBuffersOnce.load( std::memory_order_relaxed );
+   const double secsQueued = mPlaybackTracks.empty()
+      ? -1.0 : GetCommonlyReadyPlayback() / mRate;
+   const double tPassStart = StreamClockSeconds();
+   // Time spent fetching from and appending to tracks in this pass,
+   // accumulated also by the pool threads; mostly block-file I/O
+   std::atomic<long long> trackIoUs{ 0 };
+
    unsigned int i;
 
    auto delayedHandler = [this] ( AudacityException * pException ) {
@@ -2740,7 +3410,7 @@ void AudioIO::FillBuffers()
                (mPlaybackSchedule.Interactive() ? mScrubSpeed : 1.0),
                frames);
 
-            for (i = 0; i < mPlaybackTracks.size(); i++)
+            const auto fillTrack = [&](size_t ii)
             {
                // The mixer here isn't actually mixing: it's just doing
                // resampling, format conversion, and possibly time track
@@ -2749,18 +3419,34 @@ void AudioIO::FillBuffers()
 
                if (frames > 0)
                {
+                  const double t0 = StreamClockSeconds();
                   size_t processed = 0;
                   if ( toProcess )
-                     processed = mPlaybackMixers[i]->Process( toProcess );
+                     processed = mPlaybackMixers[ii]->Process( toProcess );
                   //wxASSERT(processed <= toProcess);
-                  warpedSamples = mPlaybackMixers[i]->GetBuffer();
-                  const auto put = mPlaybackBuffers[i]->Put(
+                  warpedSamples = mPlaybackMixers[ii]->GetBuffer();
+                  const auto put = mPlaybackBuffers[ii]->Put(
                      warpedSamples, floatSample, processed, frames - processed);
                   // wxASSERT(put == frames);
                   // but we can't assert in this thread
                   wxUnusedVar(put);
-               }               
-            }
+                  trackIoUs.fetch_add(
+                     (long long)( ( StreamClockSeconds() - t0 ) * 1.0e6 ),
+                     std::memory_order_relaxed );
+               }
+            };
+
+            // Until MixBuffers in the callback, each track's Mixer and
+            // RingBuffer are independent of all the others, so with many
+            // tracks, spread the work over the pool; the AudioThread only
+            // coordinates.  With few tracks the dispatch overhead is not
+            // repaid.
+            const auto nTracks = mPlaybackTracks.size();
+            if (mFillPool && nTracks > 1)
+               mFillPool->FillAll(nTracks, fillTrack);
+            else
+               for (size_t ii = 0; ii < nTracks; ++ii)
+                  fillTrack(ii);
 
             available -= frames;
             wxASSERT(available >= 0);
@@ -2841,7 +3527,9 @@ void AudioIO::FillBuffers()
             std::max(0.0, mRecordingSchedule.ToConsume());
          // This may be a very big double number:
          const auto remainingSamples = remainingTime * mRate;
-         bool latencyCorrected = true;
+         // Atomic, because the channel drains below may run concurrently;
+         // they only ever clear it
+         std::atomic<bool> latencyCorrected{ true };
 
          double deltat = avail / mRate;
 
@@ -2853,11 +3541,16 @@ void AudioIO::FillBuffers()
             AutoSaveFile blockFileLog;
             auto numChannels = mCaptureTracks.size();
 
-            for( i = 0; i < numChannels; i++ )
-            {
-               sampleFormat trackFormat = mCaptureTracks[i]->GetSampleFormat();
+            // Per-channel outputs of the drains, which may run concurrently
+            std::vector<AutoSaveFile> appendLogs( numChannels );
+            std::vector<std::exception_ptr> failures( numChannels );
+
+            const auto drainChannel = [&]( size_t ch )
+            { try {
+               const double t0 = StreamClockSeconds();
+               sampleFormat trackFormat = mCaptureTracks[ch]->GetSampleFormat();
 
-               AutoSaveFile appendLog;
+               auto &appendLog = appendLogs[ch];
                size_t discarded = 0;
 
                if (!mRecordingSchedule.mLatencyCorrected) {
@@ -2869,7 +3562,7 @@ void AudioIO::FillBuffers()
                      size_t size = floor( correction * mRate * mFactor);
                      SampleBuffer temp(size, trackFormat);
                      ClearSamples(temp.ptr(), trackFormat, 0, size);
-                     mCaptureTracks[i]->Append(temp.ptr(), trackFormat,
+                     mCaptureTracks[ch]->Append(temp.ptr(), trackFormat,
                                                size, 1, &appendLog);
                   }
                   else {
@@ -2880,26 +3573,27 @@ void AudioIO::FillBuffers()
 
                      // The ring buffer might have grown concurrently -- don't discard more
                      // than the "avail" value noted above.
-                     discarded = mCaptureBuffers[i]->Discard(std::min(avail, size));
+                     discarded = mCaptureBuffers[ch]->Discard(std::min(avail, size));
 
                      if (discarded < size)
                         // We need to visit this again to complete the
                         // discarding.
-                        latencyCorrected = false;
+                        latencyCorrected.store( false,
+                           std::memory_order_relaxed );
                   }
                }
 
                const float *pCrossfadeSrc = nullptr;
                size_t crossfadeStart = 0, totalCrossfadeLength = 0;
-               if (i < mRecordingSchedule.mCrossfadeData.size())
+               if (ch < mRecordingSchedule.mCrossfadeData.size())
                {
                   // Do crossfading
                   // The supplied crossfade samples are at the same rate as the track
-                  const auto &data = mRecordingSchedule.mCrossfadeData[i];
+                  const auto &data = mRecordingSchedule.mCrossfadeData[ch];
                   totalCrossfadeLength = data.size();
                   if (totalCrossfadeLength) {
                      crossfadeStart =
-                        floor(mRecordingSchedule.Consumed() * mCaptureTracks[i]->GetRate());
+                        floor(mRecordingSchedule.Consumed() * mCaptureTracks[ch]->GetRate());
                      if (crossfadeStart < totalCrossfadeLength)
                         pCrossfadeSrc = data.data() + crossfadeStart;
                   }
@@ -2907,7 +3601,9 @@ void AudioIO::FillBuffers()
 
                wxASSERT(discarded <= avail);
                size_t toGet = avail - discarded;
-               SampleBuffer temp;
+               // Scratch preallocated at stream start, ample for any format
+               // and for any amount the ring buffer can hold
+               SampleBuffer &temp = mCaptureScratch[ch];
                size_t size;
                sampleFormat format;
                if( mFactor == 1.0 )
@@ -2919,9 +3615,8 @@ void AudioIO::FillBuffers()
                      format = floatSample;
                   else
                      format = trackFormat;
-                  temp.Allocate(size, format);
                   const auto got =
-                     mCaptureBuffers[i]->Get(temp.ptr(), format, toGet);
+                     mCaptureBuffers[ch]->Get(temp.ptr(), format, toGet);
                   // wxASSERT(got == toGet);
                   // but we can't assert in this thread
                   wxUnusedVar(got);
@@ -2932,10 +3627,9 @@ void AudioIO::FillBuffers()
                {
                   size = lrint(toGet * mFactor);
                   format = floatSample;
-                  SampleBuffer temp1(toGet, floatSample);
-                  temp.Allocate(size, format);
+                  SampleBuffer &temp1 = mResampleScratch[ch];
                   const auto got =
-                     mCaptureBuffers[i]->Get(temp1.ptr(), floatSample, toGet);
+                     mCaptureBuffers[ch]->Get(temp1.ptr(), floatSample, toGet);
                   // wxASSERT(got == toGet);
                   // but we can't assert in this thread
                   wxUnusedVar(got);
@@ -2947,7 +3641,7 @@ void AudioIO::FillBuffers()
                      if (double(toGet) > remainingSamples)
                         toGet = floor(remainingSamples);
                      const auto results =
-                     mResample[i]->Process(mFactor, (float *)temp1.ptr(), toGet,
+                     mResample[ch]->Process(mFactor, (float *)temp1.ptr(), toGet,
                                            !IsStreamActive(), (float *)temp.ptr(), size);
                      size = results.second;
                   }
@@ -2957,25 +3651,54 @@ void AudioIO::FillBuffers()
                   wxASSERT(format == floatSample);
                   size_t crossfadeLength = std::min(size, totalCrossfadeLength - crossfadeStart);
                   if (crossfadeLength) {
-                     auto ratio = double(crossfadeStart) / totalCrossfadeLength;
-                     auto ratioStep = 1.0 / totalCrossfadeLength;
+                     const float invLength = 1.0f / totalCrossfadeLength;
                      auto pCrossfadeDst = (float*)temp.ptr();
 
-                     // Crossfade loop here
+                     // Crossfade loop here.  The ratio comes from the index
+                     // rather than a running sum, so the iterations are
+                     // independent and the compiler can vectorize them
                      for (size_t ii = 0; ii < crossfadeLength; ++ii) {
-                        *pCrossfadeDst = ratio * *pCrossfadeDst + (1.0 - ratio) * *pCrossfadeSrc;
-                        ++pCrossfadeSrc, ++pCrossfadeDst;
-                        ratio += ratioStep;
+                        const float ratio = (crossfadeStart + ii) * invLength;
+                        pCrossfadeDst[ii] = pCrossfadeSrc[ii] +
+                           ratio * (pCrossfadeDst[ii] - pCrossfadeSrc[ii]);
                      }
                   }
                }
 
                // Now append
                // see comment in second handler about guarantee
-               mCaptureTracks[i]->Append(temp.ptr(), format,
+               mCaptureTracks[ch]->Append(temp.ptr(), format,
                   size, 1,
                   &appendLog);
+               trackIoUs.fetch_add(
+                  (long long)( ( StreamClockSeconds() - t0 ) * 1.0e6 ),
+                  std::memory_order_relaxed );
+            }
+            catch ( ... ) {
+               // To be rethrown on the AudioThread below
+               failures[ch] = std::current_exception();
+            } };
+
+            // Each channel's drain touches only its own ring buffer,
+            // resampler and track, and DirManager serializes block file
+            // creation, so with many channels, spread the conversion,
+            // append and summary work over the pool
+            if (mFillPool && numChannels > 1)
+               mFillPool->FillAll(numChannels, drainChannel);
+            else
+               for (size_t ch = 0; ch < numChannels; ++ch)
+                  drainChannel(ch);
+
+            // All channels' writers have finished; surface the first
+            // failure, if any, to GuardedCall, which handles it as before
+            for (auto &pException : failures)
+               if (pException)
+                  std::rethrow_exception(pException);
 
+            // Assemble the recovery log serially, in channel order
+            for( i = 0; i < numChannels; i++ )
+            {
+               auto &appendLog = appendLogs[i];
                if (!appendLog.IsEmpty())
                {
                   blockFileLog.StartTag(wxT("recordingrecovery"));
@@ -3011,6 +3734,42 @@ void AudioIO::FillBuffers()
       },
       delayedHandler
    );
+
+   // Close out this pass's telemetry
+   const double elapsed = StreamClockSeconds() - tPassStart;
+   if (steadyState && secsQueued >= 0.0 && elapsed > secsQueued)
+      mFillDeadlineMisses.fetch_add( 1, std::memory_order_relaxed );
+   const auto elapsedUs = (long long)( elapsed * 1.0e6 );
+   if (elapsedUs > mMaxFillUs.load( std::memory_order_relaxed )) {
+      mMaxFillUs.store( elapsedUs, std::memory_order_relaxed );
+      mWorstFillTrackIoUs.store(
+         trackIoUs.load( std::memory_order_relaxed ),
+         std::memory_order_relaxed );
+   }
+}
+
+auto AudioIoCallback::GetTelemetry() const -> Telemetry
+{
+   Telemetry result;
+
+   const double end = mStreamEndClockTime > 0.0
+      ? mStreamEndClockTime : StreamClockSeconds();
+   result.streamSeconds = mStreamStartClockTime > 0.0
+      ? end - mStreamStartClockTime : 0.0;
+   result.latencyMs = mUsedLatencyDuration;
+   result.xruns = mXRunsDetected.load( std::memory_order_relaxed );
+   const auto lowWater =
+      mPlaybackLowWaterMark.load( std::memory_order_relaxed );
+   result.playbackLowWaterFrames =
+      lowWater == (size_t)-1 ? -1 : (long long)lowWater;
+   result.fillDeadlineMisses =
+      mFillDeadlineMisses.load( std::memory_order_relaxed );
+   result.maxFillMs =
+      mMaxFillUs.load( std::memory_order_relaxed ) / 1000.0;
+   result.worstFillTrackIoMs =
+      mWorstFillTrackIoUs.load( std::memory_order_relaxed ) / 1000.0;
+
+   return result;
 }
 
 void AudioIoCallback::SetListener(
@@ -3224,7 +3983,7 @@ bool AudioIO::SetHasSolo(bool hasSolo)
 }
 
 
-void AudioIO::FillMidiBuffers()
+double AudioIO::FillMidiBuffers()
 {
    // Keep track of time paused. If not paused, fill buffers.
    if (IsPaused()) {
@@ -3232,7 +3991,8 @@ void AudioIO::FillMidiBuffers()
          mMidiPaused = true;
          AllNotesOff(); // to avoid hanging notes during pause
       }
-      return;
+      // Nothing more to emit until unpause, which wakes the MidiThread
+      return MIDI_MAX_SLEEP;
    }
 
    if (mMidiPaused) {
@@ -3276,6 +4036,16 @@ void AudioIO::FillMidiBuffers()
       GetNextEvent();
    }
 
+   // The audio clock and the compute-to time advance together in real
+   // time, so the next event falls due in just their difference; that is
+   // the deadline for the next wake, bounded so the end test below still
+   // runs at a useful rate
+   double waitMs = MIDI_MAX_SLEEP;
+   if (mNextEvent) {
+      const double due = (UncorrectedMidiEventTime() - time) * 1000.0;
+      waitMs = std::max( 1.0, std::min( due, (double) MIDI_MAX_SLEEP ) );
+   }
+
    // test for end
    double realTime = MidiTime() * 0.001 -
                       PauseTime();
@@ -3301,6 +4071,8 @@ void AudioIO::FillMidiBuffers()
       (mPlaybackSchedule.PlayingStraight() && // PRL:  what if scrubbing?
        timeAtSpeed >= mPlaybackSchedule.mT1 + loopDelay);
    // !mNextEvent);
+
+   return waitMs;
 }
 
 double AudioIO::PauseTime()
@@ -3309,6 +4081,15 @@ double AudioIO::PauseTime()
 }
 
 
+void AudioIO::WakeMidiThread()
+{
+   // Taking the mutex pairs with the MidiThread's predicate check, so a
+   // change made just before it begins to wait is never missed
+   { std::lock_guard<std::mutex> guard{ mMidiThreadWakeMutex }; }
+   mMidiThreadWakeCondition.notify_all();
+}
+
+
 // MidiTime() is an estimate in milliseconds of the current audio
 // output (DAC) time + 1s. In other words, what audacity track time
 // corresponds to the audio (including pause insertions) at the output?
@@ -3560,25 +4341,56 @@ void AudioIO::AILAProcess(double maxPeak) {
 
 #define MAX(a,b) ((a) > (b) ? (a) : (b))
 
+// Monitor by converting capture frames straight from the raw PortAudio
+// input pointer into the interleaved stereo output -- one pass, with no
+// intermediate buffers, so the monitor tap costs no more than the format
+// conversion itself.  The common float case reduces to a contiguous copy
+// and the integer conversions are tight loops over the frames, which the
+// vector units handle.  One mono input channel goes to both output
+// channels; any input channels past the first two are not monitored.
 static void DoSoftwarePlaythrough(const void *inputBuffer,
                                   sampleFormat inputFormat,
                                   unsigned inputChannels,
                                   float *outputBuffer,
                                   int len)
 {
-   for (unsigned int i=0; i < inputChannels; i++) {
-      samplePtr inputPtr = ((samplePtr)inputBuffer) + (i * SAMPLE_SIZE(inputFormat));
-      samplePtr outputPtr = ((samplePtr)outputBuffer) + (i * SAMPLE_SIZE(floatSample));
-
-      CopySamples(inputPtr, inputFormat,
-                  (samplePtr)outputPtr, floatSample,
-                  len, true, inputChannels, 2);
+   const unsigned stride = inputChannels;
+   switch (inputFormat) {
+   case floatSample: {
+      const float *input = (const float *)inputBuffer;
+      if (inputChannels == 2)
+         memcpy(outputBuffer, input, 2 * len * sizeof(float));
+      else if (inputChannels == 1)
+         for (int i = 0; i < len; i++)
+            outputBuffer[2*i + 1] = outputBuffer[2*i] = input[i];
+      else
+         for (int i = 0; i < len; i++) {
+            outputBuffer[2*i] = input[i * stride];
+            outputBuffer[2*i + 1] = input[i * stride + 1];
+         }
+      break;
+   }
+   case int16Sample: {
+      const short *input = (const short *)inputBuffer;
+      const float scale = 1.0f / float(1 << 15);
+      if (inputChannels == 1)
+         for (int i = 0; i < len; i++)
+            outputBuffer[2*i + 1] = outputBuffer[2*i] = input[i] * scale;
+      else
+         for (int i = 0; i < len; i++) {
+            outputBuffer[2*i] = input[i * stride] * scale;
+            outputBuffer[2*i + 1] = input[i * stride + 1] * scale;
+         }
+      break;
+   }
+   default:
+      // We should never get here. Audacity's int24Sample format
+      // is different from PortAudio's sample format and so we
+      // make PortAudio return float samples when recording in
+      // 24-bit samples.
+      wxASSERT(false);
+      break;
    }
-
-   // One mono input channel goes to both output channels...
-   if (inputChannels == 1)
-      for (int i=0; i < len; i++)
-         outputBuffer[2*i + 1] = outputBuffer[2*i];
 }
 
 int audacityAudioCallback(const void *inputBuffer, void *outputBuffer,
@@ -3807,8 +4619,15 @@ bool AudioIoCallback::FillOutputBuffers(
    int chanCnt = 0;
 
    // Choose a common size to take from all ring buffers
-   const auto toGet =
-      std::min<size_t>(framesPerBuffer, GetCommonlyReadyPlayback());
+   const auto ready = GetCommonlyReadyPlayback();
+   const auto toGet = std::min<size_t>(framesPerBuffer, ready);
+
+   // Note the leanest the queue ever ran, for adaptive buffer sizing,
+   // but not the legitimate rundown at the end of the selection; the
+   // callback is the only writer
+   if (ready < mPlaybackLowWaterMark.load( std::memory_order_relaxed ) &&
+       mPlaybackSchedule.RealTimeRemaining() > 1.0)
+      mPlaybackLowWaterMark.store( ready, std::memory_order_relaxed );
 
    // The drop and dropQuickly booleans are so named for historical reasons.
    // JKC: The original code attempted to be faster by doing nothing on silenced audio.
@@ -3961,6 +4780,10 @@ void AudioIoCallback::UpdateTimePosition(unsigned long framesPerBuffer)
       mPlaybackSchedule.SetTrackTime( mTimeQueue.Consumer( mMaxFramesOutput, mRate ) );
    else
       mPlaybackSchedule.TrackTimeUpdate( framesPerBuffer / mRate );
+
+   // Anchor the new position to the wall clock, for the interpolating
+   // readers of GetStreamTime()
+   PublishStreamTime( mPlaybackSchedule.GetTrackTime() );
 }
 
 // return true, IFF we have fully handled the callback.
@@ -4135,21 +4958,24 @@ void AudioIoCallback::DoPlaythrough(
       return;
 
    float *outputFloats = (float *)outputBuffer;
-   for(unsigned i = 0; i < framesPerBuffer*numPlaybackChannels; i++)
-      outputFloats[i] = 0.0;
 
-   if (inputBuffer && mSoftwarePlaythrough) {
+   const bool playthrough = inputBuffer && mSoftwarePlaythrough;
+   // The monitor tap rewrites a stereo output completely, so priming
+   // with zeroes is only needed when it leaves samples uncovered
+   if (!(playthrough && numPlaybackChannels == 2))
+      for(unsigned i = 0; i < framesPerBuffer*numPlaybackChannels; i++)
+         outputFloats[i] = 0.0;
+
+   if (playthrough) {
       DoSoftwarePlaythrough(inputBuffer, mCaptureFormat,
                               numCaptureChannels,
                               (float *)outputBuffer, (int)framesPerBuffer);
    }
 
    // Copy the results to outputMeterFloats if necessary
-   if (outputMeterFloats != outputFloats) {
-      for (unsigned i = 0; i < framesPerBuffer*numPlaybackChannels; ++i) {
-         outputMeterFloats[i] = outputFloats[i];
-      }
-   }
+   if (outputMeterFloats != outputFloats)
+      memcpy(outputMeterFloats, outputFloats,
+             framesPerBuffer * numPlaybackChannels * sizeof(float));
 }
 
 /* Send data to recording VU meter if applicable */
@@ -4319,6 +5145,11 @@ int AudioIoCallback::AudioCallback(const void *inputBuffer, void *outputBuffer,
    mbHasSoloTracks = CountSoloingTracks() > 0 ;
    mCallbackReturn = paContinue;
 
+   // Count the host's dropout reports, for adaptive buffer sizing
+   if ( !(statusFlags & paPrimingOutput) &&
+        (statusFlags & (paOutputUnderflow | paInputOverflow)) )
+      mXRunsDetected.fetch_add( 1, std::memory_order_relaxed );
+
 #ifdef EXPERIMENTAL_MIDI_OUT
    // MIDI
    // ComputeMidiTimings may modify mFramesPerBuffer and mNumFrames,
@@ -4406,6 +5237,15 @@ int AudioIoCallback::AudioCallback(const void *inputBuffer, void *outputBuffer,
    return mCallbackReturn;
 }
 
+void AudioIoCallback::PostTransportCommand(TransportCommand command)
+{
+   mTransportCommands.Write( command );
+   // Lock and unlock the mutex, so the notification cannot fall between
+   // the AudioThread's test of the queue and its wait
+   { std::lock_guard<std::mutex> guard{ mAudioThreadWakeMutex }; }
+   mAudioThreadWakeCondition.notify_all();
+}
+
 PaStreamCallbackResult AudioIoCallback::CallbackDoSeek()
 {
    const int token = mStreamToken;
@@ -4417,8 +5257,9 @@ PaStreamCallbackResult AudioIoCallback::CallbackDoSeek()
    const auto numPlaybackTracks = mPlaybackTracks.size();
 
    // Pause audio thread and wait for it to finish
-   mAudioThreadFillBuffersLoopRunning = false;
-   while( mAudioThreadFillBuffersLoopActive )
+   PostTransportCommand( TransportCommand::StopFillLoop );
+   while( mAudioThreadFillBuffersLoopRunning ||
+      mAudioThreadFillBuffersLoopActive )
    {
       wxMilliSleep( 50 );
    }
@@ -4446,14 +5287,17 @@ PaStreamCallbackResult AudioIoCallback::CallbackDoSeek()
    }
 
    // Reload the ring buffers
-   mAudioThreadShouldCallFillBuffersOnce = true;
-   while( mAudioThreadShouldCallFillBuffersOnce )
+   const auto seekCount =
+      mFillOnceCompleteCount.load( std::memory_order_relaxed );
+   PostTransportCommand( TransportCommand::FillBuffersOnce );
+   while( mFillOnceCompleteCount.load( std::memory_order_acquire )
+         == seekCount )
    {
       wxMilliSleep( 50 );
    }
 
    // Reenable the audio thread
-   mAudioThreadFillBuffersLoopRunning = true;
+   PostTransportCommand( TransportCommand::StartFillLoop );
 
    return paContinue;
 }
@@ -19,7 +19,10 @@
 
 #include "Experimental.h"
 
+#include <atomic>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <utility>
 #include <wx/atomic.h> // member variable
 
@@ -43,6 +46,7 @@ using NoteTrackConstArray = std::vector < std::shared_ptr< const NoteTrack > >;
 
 #include <wx/event.h> // to declare custom event types
 
+#include "MessageBuffer.h"
 #include "SampleFormat.h"
 
 class wxArrayString;
@@ -52,6 +56,7 @@ class RingBuffer;
 class Mixer;
 class Resample;
 class AudioThread;
+class PlaybackBufferFillPool;
 class SelectedRegion;
 
 class AudacityProject;
@@ -125,108 +130,96 @@ int audacityAudioCallback(
    const PaStreamCallbackTimeInfo *timeInfo,
    PaStreamCallbackFlags statusFlags, void *userData );
 
-// Communicate data from one writer to one reader.
-// This is not a queue: it is not necessary for each write to be read.
-// Rather loss of a message is allowed:  writer may overwrite.
-// Data must be default-constructible and either copyable or movable.
-template<typename Data>
-class MessageBuffer {
+// Commands that the UI thread or the PortAudio callback sends to the
+// AudioThread.  The state flags that these affect are then written only by
+// the AudioThread itself, which acknowledges each FillBuffersOnce by
+// incrementing a counter that the sender can wait on.
+enum class TransportCommand : unsigned char {
+   None,
+   FillBuffersOnce,  //!< prime or flush the ring buffers, then acknowledge
+   StartFillLoop,    //!< begin steady-state refilling of the ring buffers
+   StopFillLoop,     //!< cease refilling
+};
+
+// Communicate a bounded sequence of messages from possibly several writer
+// threads to one reader, without locking.  Unlike MessageBuffer, no message
+// is ever overwritten:  each slot carries a sequence number, as in Dmitry
+// Vyukov's bounded queue, so a writer claims a slot with one
+// compare-exchange and never blocks the reader.
+// Data must be default-constructible, and the default value is returned
+// from Read() to mean "nothing pending".
+template<typename Data, size_t Size> // Size must be a power of two
+class CommandQueue {
+   static_assert( (Size & (Size - 1)) == 0,
+      "CommandQueue size must be a power of two" );
+
    struct alignas( 64
       //std::hardware_destructive_interference_size // C++17
-   ) UpdateSlot {
-      std::atomic<bool> mBusy{ false };
+   ) Slot {
+      std::atomic<size_t> mSequence{ 0 };
       Data mData;
-   } mSlots[2];
+   } mSlots[Size];
 
-   std::atomic<unsigned char> mLastWrittenSlot{ 0 };
+   std::atomic<size_t> mWriteIndex{ 0 };
+   size_t mReadIndex{ 0 };
 
 public:
-   void Initialize();
-
-   // Move data out (if available), or else copy it out
-   Data Read();
-   
-   // Copy data in
-   void Write( const Data &data );
-   // Move data in
-   void Write( Data &&data );
-};
-
-template<typename Data>
-void MessageBuffer<Data>::Initialize()
-{
-   for (auto &slot : mSlots)
-      // Lock both slots first, maybe spinning a little
-      while ( slot.mBusy.exchange( true, std::memory_order_acquire ) )
-         {}
+   CommandQueue()
+   {
+      for (size_t ii = 0; ii < Size; ++ii)
+         mSlots[ii].mSequence.store( ii, std::memory_order_relaxed );
+   }
 
-   mSlots[0].mData = {};
-   mSlots[1].mData = {};
-   mLastWrittenSlot.store( 0, std::memory_order_relaxed );
+   // Any thread may write.  Returns false if the queue was full, losing the
+   // message; commands are rare, so that case should never be reached.
+   bool Write( const Data &data )
+   {
+      auto pos = mWriteIndex.load( std::memory_order_relaxed );
+      Slot *slot;
+      for (;;) {
+         slot = &mSlots[pos & (Size - 1)];
+         const auto sequence =
+            slot->mSequence.load( std::memory_order_acquire );
+         const auto difference = (ptrdiff_t)sequence - (ptrdiff_t)pos;
+         if (difference == 0) {
+            // The slot is free; try to claim it
+            if (mWriteIndex.compare_exchange_weak(
+                  pos, pos + 1, std::memory_order_relaxed ))
+               break;
+         }
+         else if (difference < 0)
+            // A whole lap behind the reader
+            return false;
+         else
+            pos = mWriteIndex.load( std::memory_order_relaxed );
+      }
+      slot->mData = data;
+      slot->mSequence.store( pos + 1, std::memory_order_release );
+      return true;
+   }
 
-   for (auto &slot : mSlots)
-      slot.mBusy.exchange( false, std::memory_order_release );
-}
+   // Only the single reader thread may call the functions below.
+   bool Pending() const
+   {
+      const auto &slot = mSlots[mReadIndex & (Size - 1)];
+      return slot.mSequence.load( std::memory_order_acquire )
+         == mReadIndex + 1;
+   }
 
-template<typename Data>
-Data MessageBuffer<Data>::Read()
-{
-   // Whichever slot was last written, prefer to read that.
-   auto idx = mLastWrittenSlot.load( std::memory_order_relaxed );
-   idx = 1 - idx;
-   bool wasBusy = false;
-   do {
-      // This loop is unlikely to execute twice, but it might because the
-      // producer thread is writing a slot.
-      idx = 1 - idx;
-      wasBusy = mSlots[idx].mBusy.exchange( true, std::memory_order_acquire );
-   } while ( wasBusy );
-
-   // Copy the slot
-   auto result = std::move( mSlots[idx].mData );
-
-   mSlots[idx].mBusy.store( false, std::memory_order_release );
-
-   return result;
-}
-
-template<typename Data>
-void MessageBuffer<Data>::Write( const Data &data )
-{
-   // Whichever slot was last written, prefer to write the other.
-   auto idx = mLastWrittenSlot.load( std::memory_order_relaxed );
-   bool wasBusy = false;
-   do {
-      // This loop is unlikely to execute twice, but it might because the
-      // consumer thread is reading a slot.
-      idx = 1 - idx;
-      wasBusy = mSlots[idx].mBusy.exchange( true, std::memory_order_acquire );
-   } while ( wasBusy );
-
-   mSlots[idx].mData = data;
-   mLastWrittenSlot.store( idx, std::memory_order_relaxed );
-
-   mSlots[idx].mBusy.store( false, std::memory_order_release );
-}
-
-template<typename Data>
-void MessageBuffer<Data>::Write( Data &&data )
-{
-   // Whichever slot was last written, prefer to write the other.
-   auto idx = mLastWrittenSlot.load( std::memory_order_relaxed );
-   bool wasBusy = false;
-   do {
-      // This loop is unlikely to execute twice, but it might because the
-      // consumer thread is reading a slot.
-      idx = 1 - idx;
-      wasBusy = mSlots[idx].mBusy.exchange( true, std::memory_order_acquire );
-   } while ( wasBusy );
-
-   mSlots[idx].mData = std::move( data );
-   mLastWrittenSlot.store( idx, std::memory_order_relaxed );
-
-   mSlots[idx].mBusy.store( false, std::memory_order_release );
-}
+   // Move the oldest message out, or return a default-constructed Data if
+   // nothing was pending
+   Data Read()
+   {
+      auto &slot = mSlots[mReadIndex & (Size - 1)];
+      if ( slot.mSequence.load( std::memory_order_acquire )
+            != mReadIndex + 1 )
+         return {};
+      auto result = std::move( slot.mData );
+      slot.mSequence.store( mReadIndex + Size, std::memory_order_release );
+      ++mReadIndex;
+      return result;
+   }
+};
 
 class AUDACITY_DLL_API AudioIoCallback /* not final */
    : public AudioIOBase
@@ -247,6 +240,10 @@ public:
       { return mListener.lock(); }
    void SetListener( const std::shared_ptr< AudioIOListener > &listener);
    
+   // Send a command to the AudioThread and wake it promptly.  Any thread
+   // may call this.
+   void PostTransportCommand(TransportCommand command);
+
    // Part of the callback
    PaStreamCallbackResult CallbackDoSeek();
 
@@ -320,6 +317,22 @@ public:
    * they are different. */
    size_t GetCommonlyReadyPlayback();
 
+   /** \brief Snapshot of the stream health counters.
+   *
+   * Readable from any thread, while a stream runs or after it stops.
+   * Logged as one structured line at stream stop and queryable with the
+   * GetTelemetry scripting command. */
+   struct Telemetry {
+      double streamSeconds;
+      double latencyMs;
+      unsigned xruns;
+      long long playbackLowWaterFrames; //!< -1 when nothing was played
+      unsigned fillDeadlineMisses;
+      double maxFillMs;
+      double worstFillTrackIoMs;
+   };
+   Telemetry GetTelemetry() const;
+
 
 #ifdef EXPERIMENTAL_MIDI_OUT
    //   MIDI_PLAYBACK:
@@ -419,12 +432,18 @@ public:
 #endif
 #endif
    ArrayOf<std::unique_ptr<Resample>> mResample;
+   // Per-channel scratch for the capture drains of FillBuffers, sized once
+   // at stream start so the writer tasks allocate nothing per pass
+   ArrayOf<SampleBuffer> mCaptureScratch;
+   ArrayOf<SampleBuffer> mResampleScratch;
    ArrayOf<std::unique_ptr<RingBuffer>> mCaptureBuffers;
    WaveTrackArray      mCaptureTracks;
    ArrayOf<std::unique_ptr<RingBuffer>> mPlaybackBuffers;
    WaveTrackArray      mPlaybackTracks;
 
    ArrayOf<std::unique_ptr<Mixer>> mPlaybackMixers;
+   /// Workers over which FillBuffers() spreads per-track buffer filling
+   std::unique_ptr<PlaybackBufferFillPool> mFillPool;
    static int          mNextStreamToken;
    double              mFactor;
    unsigned long       mMaxFramesOutput; // The actual number of frames output.
@@ -448,15 +467,49 @@ public:
    unsigned int        mNumPlaybackChannels;
    sampleFormat        mCaptureFormat;
    unsigned long long  mLostSamples{ 0 };
-   volatile bool       mAudioThreadShouldCallFillBuffersOnce;
-   volatile bool       mAudioThreadFillBuffersLoopRunning;
-   volatile bool       mAudioThreadFillBuffersLoopActive;
+   // Diagnostics for adaptive buffer sizing: the host's dropout reports
+   // and the leanest the playback queue ever ran, written by the
+   // callback and read when the stream stops
+   std::atomic<unsigned> mXRunsDetected{ 0 };
+   std::atomic<size_t> mPlaybackLowWaterMark{ 0 };
+   // Telemetry written by the AudioThread: fill passes that outlasted
+   // the audio the consumer still held, the slowest pass, and how much
+   // of that pass went to track fetch and append, which is mostly
+   // block-file I/O -- so a slow disk shows as a large share of it
+   std::atomic<unsigned> mFillDeadlineMisses{ 0 };
+   std::atomic<long long> mMaxFillUs{ 0 };
+   std::atomic<long long> mWorstFillTrackIoUs{ 0 };
+   // The buffer length the stream was opened with, in milliseconds, and
+   // when it started and stopped, for the learning step and the
+   // telemetry record at stream stop
+   double              mUsedLatencyDuration{ 0.0 };
+   double              mStreamStartClockTime{ 0.0 };
+   double              mStreamEndClockTime{ 0.0 };
+   // Written only by the AudioThread while it services the command queue,
+   // read anywhere
+   std::atomic<bool>   mAudioThreadShouldCallFillBuffersOnce;
+   std::atomic<bool>   mAudioThreadFillBuffersLoopRunning;
+   std::atomic<bool>   mAudioThreadFillBuffersLoopActive;
+
+   // Carries transport commands to the AudioThread; written by the UI
+   // thread and by the PortAudio callback, read only by the AudioThread
+   CommandQueue<TransportCommand, 16> mTransportCommands;
+   // Counts serviced FillBuffersOnce commands, so a sender can wait for
+   // its own request to complete
+   std::atomic<unsigned> mFillOnceCompleteCount{ 0 };
+   // Wake the AudioThread promptly when a command is posted
+   std::mutex          mAudioThreadWakeMutex;
+   std::condition_variable mAudioThreadWakeCondition;
 
    wxLongLong          mLastPlaybackTimeMillis;
 
 #ifdef EXPERIMENTAL_MIDI_OUT
    volatile bool       mMidiThreadFillBuffersLoopRunning;
    volatile bool       mMidiThreadFillBuffersLoopActive;
+   // Wake the MidiThread from its deadline wait as soon as the transport
+   // starts, stops or pauses
+   std::mutex          mMidiThreadWakeMutex;
+   std::condition_variable mMidiThreadWakeCondition;
 #endif
 
    volatile double     mLastRecordingOffset;
@@ -586,6 +639,16 @@ public:
     * by the specified amount from where it is now */
    void SeekStream(double seconds) { mSeek = seconds; }
 
+   /** \brief While the transport is stopped, ask the Audio thread to keep
+    * the first seconds of playback after the given position decoded and
+    * mixed, so the next StartStream there only copies samples into its ring
+    * buffers.
+    *
+    * The cache is distrusted if any track's clips change meanwhile, using
+    * the same dirty counters that invalidate WaveClip's display caches. */
+   void SchedulePreroll( const WaveTrackArray &tracks, double t0, double t1,
+      double rate, const BoundedEnvelope *envelope );
+
 #ifdef EXPERIMENTAL_SCRUBBING_SUPPORT
    bool IsScrubbing() const { return IsBusy() && mScrubState != 0; }
 
@@ -679,6 +742,18 @@ public:
     */
    static bool ValidateDeviceNames(const wxString &play, const wxString &rec);
 
+   /** \brief Measure the round-trip latency of the selected devices
+    *
+    * Plays a short chirp through the output while recording the input,
+    * using the devices and buffer length of the preferences, and finds the
+    * chirp in the recording by correlation.  On success, stores into
+    * correctionMillis the (negative) value suitable for the
+    * /AudioIO/LatencyCorrection preference and returns true.  Fails if a
+    * stream is already running, the devices cannot be opened, or no
+    * recognizable echo of the chirp arrives (no loopback path).  Blocks
+    * for a few seconds while sound plays; call from the main thread only. */
+   bool MeasureLatencyCorrection(double &correctionMillis);
+
    /** \brief Function to automatically set an acceptable volume
     *
     */
@@ -721,6 +796,43 @@ private:
     * each call to StartStream currently */
    void SetMeters();
 
+   /** \brief Decode and mix the requested pre-roll span into mPrerollCache.
+    * Runs on the Audio thread while no stream is rolling. */
+   void FillPrerollCache();
+
+   /** \brief How many cached frames StartStream may copy for a start at
+    * [t0, t1), or zero if the cache does not apply.
+    * Caller must hold mPrerollMutex. */
+   size_t ValidPrerollFrames( double t0, double t1 );
+
+   /** \brief Summarize a track's clip dirty counters, to detect edits that
+    * stale the pre-roll cache */
+   static int TrackDirtySignature( const WaveTrack &track );
+
+   struct PrerollRequest {
+      WaveTrackArray tracks;
+      double t0{ 0 }, t1{ 0 };
+      double rate{ 0 };
+      const BoundedEnvelope *envelope{ nullptr };
+   };
+   // UI thread writes a request, Audio thread reads it
+   MessageBuffer<PrerollRequest> mPrerollRequest;
+   std::atomic<bool> mPrerollNeeded{ false };
+
+   // Guards mPrerollCache between the Audio thread filling it and
+   // StartStream consuming it
+   std::mutex mPrerollMutex;
+   struct PrerollCache {
+      WaveTrackArray tracks;
+      std::vector<int> signatures;
+      std::vector<std::vector<float>> buffers;
+      double t0{ 0 }, t1{ 0 };
+      double rate{ 0 };
+      const BoundedEnvelope *envelope{ nullptr };
+      size_t frames{ 0 };
+      bool valid{ false };
+   } mPrerollCache;
+
 
    /** \brief Opens the portaudio stream(s) used to do playback or recording
     * (or both) through.
@@ -736,6 +848,15 @@ private:
                              unsigned int numPlaybackChannels,
                              unsigned int numCaptureChannels,
                              sampleFormat captureFormat);
+
+   /** \brief One learning step of adaptive buffer sizing, at stream stop
+    *
+    * When the adaptive mode preference is on, grows the buffer length
+    * learned for the current devices after a run with dropouts, shrinks
+    * it a little after a long clean run, and persists the result, so
+    * successive runs converge on the lowest safe latency. */
+   void UpdateAdaptiveLatency();
+
    void FillBuffers();
 
 #ifdef EXPERIMENTAL_MIDI_OUT
@@ -747,10 +868,20 @@ private:
    double UncorrectedMidiEventTime();
 
    void OutputEvent();
-   void FillMidiBuffers();
+
+   /** \brief Output all MIDI events due by now, and say when to wake next
+    *
+    * Emits every event whose time falls within the current compute-ahead
+    * window, then returns the number of milliseconds until the next event
+    * (bounded by MIDI_MAX_SLEEP) so the MidiThread can wait out a precise
+    * deadline instead of polling. */
+   double FillMidiBuffers();
    void GetNextEvent();
    double PauseTime();
    void AllNotesOff(bool looping = false);
+
+   // Interrupt the MidiThread's deadline wait after a transport change
+   void WakeMidiThread();
 #endif
 
    /** \brief Get the number of audio samples free in all of the playback
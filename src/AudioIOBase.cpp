@@ -13,6 +13,9 @@ Paul Licameli split from AudioIO.cpp
 
 #include "Experimental.h"
 
+#include <chrono>
+#include <cmath>
+
 #include <wx/sstream.h>
 #include <wx/txtstrm.h>
 
@@ -474,16 +477,17 @@ double AudioIOBase::PlaybackSchedule::NormalizeTrackTime() const
    //          mode. In this case, we should jump over a defined "gap" in the
    //          audio.
 
-   double absoluteTime;
+   return NormalizeTime( GetTrackTime() );
+}
 
+double AudioIOBase::PlaybackSchedule::NormalizeTime( double absoluteTime ) const
+{
 #ifdef EXPERIMENTAL_SCRUBBING_SUPPORT
    // Limit the time between t0 and t1 if not scrubbing.
    // Should the limiting be necessary in any play mode if there are no bugs?
-   if (Interactive())
-      absoluteTime = GetTrackTime();
-   else
+   if (!Interactive())
 #endif
-      absoluteTime = LimitTrackTime();
+      absoluteTime = ClampTrackTime( absoluteTime );
 
    if (mCutPreviewGapLen > 0)
    {
@@ -496,6 +500,65 @@ double AudioIOBase::PlaybackSchedule::NormalizeTrackTime() const
    return absoluteTime;
 }
 
+namespace {
+
+// Steady-clock seconds, the common reference for snapshot anchors
+inline double StreamClockTime()
+{
+   using namespace std::chrono;
+   return duration<double>( steady_clock::now().time_since_epoch() ).count();
+}
+
+// Rates of advance beyond even scrubbing's reach mark a discontinuity,
+// such as the wrap of looping play; never extrapolate across one
+const double MaxStreamTimeSpeed = 8.0;
+
+// Never extrapolate further past an anchor than the callback can have
+// played since; should publications stop, the playhead freezes here
+const double MaxStreamTimeLookahead = 0.2;
+
+}
+
+void AudioIOBase::PublishStreamTime(double trackTime)
+{
+   const double now = StreamClockTime();
+
+   // The callback is the sole writer, so the previous snapshot can be
+   // read back without the sequence dance
+   const double lastTime =
+      mStreamTimeSnapshot.trackTime.load( std::memory_order_relaxed );
+   const double lastClock =
+      mStreamTimeSnapshot.clockTime.load( std::memory_order_relaxed );
+   double speed = 0.0;
+   if (lastClock > 0.0 && now > lastClock) {
+      speed = (trackTime - lastTime) / (now - lastClock);
+      if (fabs(speed) > MaxStreamTimeSpeed)
+         speed = 0.0;
+   }
+
+   // Seqlock write; an odd sequence marks the fields inconsistent
+   const auto seq = mStreamTimeSequence.load( std::memory_order_relaxed );
+   mStreamTimeSequence.store( seq + 1, std::memory_order_relaxed );
+   std::atomic_thread_fence( std::memory_order_release );
+   mStreamTimeSnapshot.trackTime.store( trackTime, std::memory_order_relaxed );
+   mStreamTimeSnapshot.clockTime.store( now, std::memory_order_relaxed );
+   mStreamTimeSnapshot.speed.store( speed, std::memory_order_relaxed );
+   mStreamTimeSequence.store( seq + 2, std::memory_order_release );
+}
+
+void AudioIOBase::ResetStreamTime(double trackTime)
+{
+   // A zero anchor makes readers fall back to mTime, and keeps the next
+   // publication from computing a rate across the gap between streams
+   const auto seq = mStreamTimeSequence.load( std::memory_order_relaxed );
+   mStreamTimeSequence.store( seq + 1, std::memory_order_relaxed );
+   std::atomic_thread_fence( std::memory_order_release );
+   mStreamTimeSnapshot.trackTime.store( trackTime, std::memory_order_relaxed );
+   mStreamTimeSnapshot.clockTime.store( 0.0, std::memory_order_relaxed );
+   mStreamTimeSnapshot.speed.store( 0.0, std::memory_order_relaxed );
+   mStreamTimeSequence.store( seq + 2, std::memory_order_release );
+}
+
 double AudioIOBase::GetStreamTime()
 {
    // Track time readout for the main thread
@@ -503,7 +566,31 @@ double AudioIOBase::GetStreamTime()
    if( !IsStreamActive() )
       return BAD_STREAM_TIME;
 
-   return mPlaybackSchedule.NormalizeTrackTime();
+   // Seqlock read of the position the callback last published; retry the
+   // rare coincidence with a publication in progress
+   double trackTime, clockTime, speed;
+   unsigned seq;
+   do {
+      seq = mStreamTimeSequence.load( std::memory_order_acquire );
+      trackTime =
+         mStreamTimeSnapshot.trackTime.load( std::memory_order_relaxed );
+      clockTime =
+         mStreamTimeSnapshot.clockTime.load( std::memory_order_relaxed );
+      speed = mStreamTimeSnapshot.speed.load( std::memory_order_relaxed );
+      std::atomic_thread_fence( std::memory_order_acquire );
+   } while ( (seq & 1) ||
+      seq != mStreamTimeSequence.load( std::memory_order_relaxed ) );
+
+   if (clockTime <= 0.0 || IsPaused())
+      // Nothing published yet this stream, or time is standing still
+      return mPlaybackSchedule.NormalizeTrackTime();
+
+   // Interpolate from the wall-clock anchor, so that the playhead moves
+   // smoothly between the stepwise updates of mTime, however often the
+   // display asks
+   const double elapsed = std::max( 0.0,
+      std::min( StreamClockTime() - clockTime, MaxStreamTimeLookahead ) );
+   return mPlaybackSchedule.NormalizeTime( trackTime + speed * elapsed );
 }
 
 std::vector<long> AudioIOBase::GetSupportedPlaybackRates(int devIndex, double rate)
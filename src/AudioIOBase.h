@@ -407,6 +407,10 @@ protected:
        */
       double NormalizeTrackTime() const;
 
+      /** \brief Normalizes an arbitrary time as NormalizeTrackTime does mTime
+       */
+      double NormalizeTime( double absoluteTime ) const;
+
       void ResetMode() { mPlayMode = PLAY_STRAIGHT; }
 
       bool PlayingStraight() const { return mPlayMode == PLAY_STRAIGHT; }
@@ -453,6 +457,31 @@ protected:
 
    } mPlaybackSchedule;
 
+   /** \brief Lock-free versioned snapshot of the playing position
+    *
+    * Published by the audio callback once per buffer and read, seqlock
+    * style, by any number of UI threads at once, which interpolate from
+    * the wall-clock anchor so the playhead moves smoothly between the
+    * stepwise updates of mTime. */
+   struct StreamTimeSnapshot {
+      std::atomic<double> trackTime{ 0.0 }; //!< mTime as of the anchor
+      std::atomic<double> clockTime{ 0.0 }; //!< steady-clock seconds at publication
+      std::atomic<double> speed{ 0.0 }; //!< track seconds per wall-clock second
+   };
+   std::atomic<unsigned> mStreamTimeSequence{ 0 };
+   StreamTimeSnapshot  mStreamTimeSnapshot;
+
+   /** \brief Publish the position the audio callback just advanced to
+    *
+    * Estimates the rate of advance from the previous snapshot; across a
+    * discontinuity, such as the wrap of looping play, a zero rate is
+    * published and readers hold position until the next buffer. */
+   void PublishStreamTime(double trackTime);
+
+   /** \brief Invalidate the snapshot when a stream starts, so readers do
+    * not extrapolate from the previous stream */
+   void ResetStreamTime(double trackTime);
+
    /** \brief get the index of the supplied (named) recording device, or the
     * device selected in the preferences if none given.
     *
@@ -195,6 +195,82 @@ XMLTagHandler* RecordingRecoveryHandler::HandleXMLChild(const wxChar *tag)
    return NULL;
 }
 
+////////////////////////////////////////////////////////////////////////////
+/// Track delta recovery handler
+
+TrackDeltaRecoveryHandler::TrackDeltaRecoveryHandler(AudacityProject* proj)
+{
+   mProject = proj;
+   mIdent = 0;
+}
+
+bool TrackDeltaRecoveryHandler::HandleXMLTag(const wxChar *tag,
+                                             const wxChar **attrs)
+{
+   if (wxStrcmp(tag, wxT("trackdelta")) != 0)
+      return false;
+
+   mIdent = 0;
+   mTrack.reset();
+
+   long nValue;
+   while(*attrs)
+   {
+      const wxChar *attr = *attrs++;
+      const wxChar *value = *attrs++;
+
+      if (!value)
+         break;
+
+      const wxString strValue = value;
+      if (wxStrcmp(attr, wxT("ident")) == 0)
+      {
+         if (!XMLValueChecker::IsGoodInt(strValue) ||
+             !strValue.ToLong(&nValue) || nValue < 1)
+            return false;
+         mIdent = nValue;
+      }
+   }
+
+   return true;
+}
+
+XMLTagHandler* TrackDeltaRecoveryHandler::HandleXMLChild(const wxChar *tag)
+{
+   if (wxStrcmp(tag, wxT("wavetrack")) == 0)
+   {
+      // Parse the replacement track just as a project load would
+      mTrack = TrackFactory::Get( *mProject ).NewWaveTrack();
+      return mTrack.get();
+   }
+
+   return NULL;
+}
+
+void TrackDeltaRecoveryHandler::HandleXMLEndTag(const wxChar *tag)
+{
+   if (wxStrcmp(tag, wxT("trackdelta")) != 0)
+      return;
+
+   if (mTrack && mIdent)
+   {
+      // Swap the replacement in for the stale track of the base snapshot.
+      // Deltas were appended in order, so a later delta for the same
+      // ident supersedes an earlier one the same way.
+      auto &tracks = TrackList::Get( *mProject );
+      for (auto old : tracks.Any< WaveTrack >())
+      {
+         if (old->GetAutoSaveIdent() == mIdent)
+         {
+            tracks.Replace(old, mTrack);
+            break;
+         }
+      }
+   }
+
+   mTrack.reset();
+}
+
 ///
 /// AutoSaveFile class
 ///
@@ -450,6 +526,209 @@ bool AutoSaveFile::IsEmpty() const
    return mBuffer.GetLength() == 0;
 }
 
+namespace {
+
+// The inverse of the encoding above: replay one encoded document into
+// any XMLWriter.  Returns false when the stream is malformed, and then
+// the output may be incomplete.
+bool DecodeStream(wxMemoryInputStream &in, XMLWriter &out)
+{
+   using WxChars = ArrayOf < wxChar >;
+
+   IdMap mIds;
+   std::vector<IdMap> mIdStack;
+
+   mIds.clear();
+
+   struct Error{};
+   auto Lookup = [&mIds]( short id ) -> const wxString & {
+      auto iter = mIds.find( id );
+      if ( iter == mIds.end() )
+         throw Error{};
+      return iter->second;
+   };
+
+   try { while ( !in.Eof() ) {
+      short id;
+
+      switch (in.GetC())
+      {
+         case FT_Push:
+         {
+            mIdStack.push_back(mIds);
+            mIds.clear();
+         }
+         break;
+
+         case FT_Pop:
+         {
+            mIds = mIdStack.back();
+            mIdStack.pop_back();
+         }
+         break;
+
+         case FT_Name:
+         {
+            short len;
+
+            in.Read(&id, sizeof(id));
+            in.Read(&len, sizeof(len));
+            WxChars name{ len / sizeof(wxChar) };
+            in.Read(name.get(), len);
+
+            mIds[id] = wxString(name.get(), len / sizeof(wxChar));
+         }
+         break;
+
+         case FT_StartTag:
+         {
+            in.Read(&id, sizeof(id));
+
+            out.StartTag(Lookup(id));
+         }
+         break;
+
+         case FT_EndTag:
+         {
+            in.Read(&id, sizeof(id));
+
+            out.EndTag(Lookup(id));
+         }
+         break;
+
+         case FT_String:
+         {
+            int len;
+
+            in.Read(&id, sizeof(id));
+            in.Read(&len, sizeof(len));
+            WxChars val{ len / sizeof(wxChar) };
+            in.Read(val.get(), len);
+
+            out.WriteAttr(Lookup(id), wxString(val.get(), len / sizeof(wxChar)));
+         }
+         break;
+
+         case FT_Float:
+         {
+            float val;
+            int dig;
+
+            in.Read(&id, sizeof(id));
+            in.Read(&val, sizeof(val));
+            in.Read(&dig, sizeof(dig));
+
+            out.WriteAttr(Lookup(id), val, dig);
+         }
+         break;
+
+         case FT_Double:
+         {
+            double val;
+            int dig;
+
+            in.Read(&id, sizeof(id));
+            in.Read(&val, sizeof(val));
+            in.Read(&dig, sizeof(dig));
+
+            out.WriteAttr(Lookup(id), val, dig);
+         }
+         break;
+
+         case FT_Int:
+         {
+            int val;
+
+            in.Read(&id, sizeof(id));
+            in.Read(&val, sizeof(val));
+
+            out.WriteAttr(Lookup(id), val);
+         }
+         break;
+
+         case FT_Bool:
+         {
+            bool val;
+
+            in.Read(&id, sizeof(id));
+            in.Read(&val, sizeof(val));
+
+            out.WriteAttr(Lookup(id), val);
+         }
+         break;
+
+         case FT_Long:
+         {
+            long val;
+
+            in.Read(&id, sizeof(id));
+            in.Read(&val, sizeof(val));
+
+            out.WriteAttr(Lookup(id), val);
+         }
+         break;
+
+         case FT_LongLong:
+         {
+            long long val;
+
+            in.Read(&id, sizeof(id));
+            in.Read(&val, sizeof(val));
+
+            out.WriteAttr(Lookup(id), val);
+         }
+         break;
+
+         case FT_SizeT:
+         {
+            size_t val;
+
+            in.Read(&id, sizeof(id));
+            in.Read(&val, sizeof(val));
+
+            out.WriteAttr(Lookup(id), val);
+         }
+         break;
+
+         case FT_Data:
+         {
+            int len;
+
+            in.Read(&len, sizeof(len));
+            WxChars val{ len / sizeof(wxChar) };
+            in.Read(val.get(), len);
+
+            out.WriteData(wxString(val.get(), len / sizeof(wxChar)));
+         }
+         break;
+
+         case FT_Raw:
+         {
+            int len;
+
+            in.Read(&len, sizeof(len));
+            WxChars val{ len / sizeof(wxChar) };
+            in.Read(val.get(), len);
+
+            out.Write(wxString(val.get(), len / sizeof(wxChar)));
+         }
+         break;
+
+         default:
+            wxASSERT(true);
+         break;
+      }
+   } }
+   catch( const Error & )
+   {
+      return false;
+   }
+
+   return true;
+}
+
+}
+
 bool AutoSaveFile::Decode(const FilePath & fileName)
 {
    char ident[sizeof(AutoSaveIdent)];
@@ -512,7 +791,6 @@ bool AutoSaveFile::Decode(const FilePath & fileName)
 
    len = file.Length() - len;
    using Chars = ArrayOf < char >;
-   using WxChars = ArrayOf < wxChar >;
    Chars buf{ len };
    if (file.Read(buf.get(), len) != len)
    {
@@ -531,197 +809,54 @@ bool AutoSaveFile::Decode(const FilePath & fileName)
    return GuardedCall< bool >( [&] {
       XMLFileWriter out{ fileName, _("Error Decoding File") };
 
-      IdMap mIds;
-      std::vector<IdMap> mIdStack;
-
-      mIds.clear();
-   
-      struct Error{};
-      auto Lookup = [&mIds]( short id ) -> const wxString & {
-         auto iter = mIds.find( id );
-         if ( iter == mIds.end() )
-            throw Error{};
-         return iter->second;
-      };
-
-      try { while ( !in.Eof() ) {
-         short id;
-
-         switch (in.GetC())
-         {
-            case FT_Push:
-            {
-               mIdStack.push_back(mIds);
-               mIds.clear();
-            }
-            break;
-
-            case FT_Pop:
-            {
-               mIds = mIdStack.back();
-               mIdStack.pop_back();
-            }
-            break;
-
-            case FT_Name:
-            {
-               short len;
-
-               in.Read(&id, sizeof(id));
-               in.Read(&len, sizeof(len));
-               WxChars name{ len / sizeof(wxChar) };
-               in.Read(name.get(), len);
-
-               mIds[id] = wxString(name.get(), len / sizeof(wxChar));
-            }
-            break;
-
-            case FT_StartTag:
-            {
-               in.Read(&id, sizeof(id));
-
-               out.StartTag(Lookup(id));
-            }
-            break;
-
-            case FT_EndTag:
-            {
-               in.Read(&id, sizeof(id));
-
-               out.EndTag(Lookup(id));
-            }
-            break;
-
-            case FT_String:
-            {
-               int len;
-
-               in.Read(&id, sizeof(id));
-               in.Read(&len, sizeof(len));
-               WxChars val{ len / sizeof(wxChar) };
-               in.Read(val.get(), len);
-
-               out.WriteAttr(Lookup(id), wxString(val.get(), len / sizeof(wxChar)));
-            }
-            break;
-
-            case FT_Float:
-            {
-               float val;
-               int dig;
-
-               in.Read(&id, sizeof(id));
-               in.Read(&val, sizeof(val));
-               in.Read(&dig, sizeof(dig));
-
-               out.WriteAttr(Lookup(id), val, dig);
-            }
-            break;
-
-            case FT_Double:
-            {
-               double val;
-               int dig;
-
-               in.Read(&id, sizeof(id));
-               in.Read(&val, sizeof(val));
-               in.Read(&dig, sizeof(dig));
-
-               out.WriteAttr(Lookup(id), val, dig);
-            }
-            break;
-
-            case FT_Int:
-            {
-               int val;
-
-               in.Read(&id, sizeof(id));
-               in.Read(&val, sizeof(val));
-
-               out.WriteAttr(Lookup(id), val);
-            }
-            break;
-
-            case FT_Bool:
-            {
-               bool val;
-
-               in.Read(&id, sizeof(id));
-               in.Read(&val, sizeof(val));
-
-               out.WriteAttr(Lookup(id), val);
-            }
-            break;
-
-            case FT_Long:
-            {
-               long val;
-
-               in.Read(&id, sizeof(id));
-               in.Read(&val, sizeof(val));
-
-               out.WriteAttr(Lookup(id), val);
-            }
-            break;
-
-            case FT_LongLong:
-            {
-               long long val;
-
-               in.Read(&id, sizeof(id));
-               in.Read(&val, sizeof(val));
+      if (!DecodeStream(in, out))
+         // return before committing, so we do not overwrite the recovery file!
+         return false;
 
-               out.WriteAttr(Lookup(id), val);
-            }
-            break;
+      out.Commit();
 
-            case FT_SizeT:
-            {
-               size_t val;
+      return true;
+   } );
+}
 
-               in.Read(&id, sizeof(id));
-               in.Read(&val, sizeof(val));
+bool AutoSaveFile::DecodeString(const FilePath & fileName, wxString & xmldata)
+{
+   char ident[sizeof(AutoSaveIdent)];
+   size_t len = strlen(AutoSaveIdent);
 
-               out.WriteAttr(Lookup(id), val);
-            }
-            break;
+   wxFFile file;
 
-            case FT_Data:
-            {
-               int len;
+   if (!file.Open(fileName, wxT("rb")))
+   {
+      return false;
+   }
 
-               in.Read(&len, sizeof(len));
-               WxChars val{ len / sizeof(wxChar) };
-               in.Read(val.get(), len);
+   if (file.Read(&ident, len) != len || strncmp(ident, AutoSaveIdent, len) != 0)
+   {
+      // Not the encoded format; the caller falls back to Decode, which
+      // also knows how to repair plain XML files from 2.1.0 and earlier
+      return false;
+   }
 
-               out.WriteData(wxString(val.get(), len / sizeof(wxChar)));
-            }
-            break;
+   len = file.Length() - len;
+   using Chars = ArrayOf < char >;
+   Chars buf{ len };
+   if (file.Read(buf.get(), len) != len)
+   {
+      return false;
+   }
 
-            case FT_Raw:
-            {
-               int len;
+   wxMemoryInputStream in(buf.get(), len);
 
-               in.Read(&len, sizeof(len));
-               WxChars val{ len / sizeof(wxChar) };
-               in.Read(val.get(), len);
+   file.Close();
 
-               out.Write(wxString(val.get(), len / sizeof(wxChar)));
-            }
-            break;
+   return GuardedCall< bool >( [&] {
+      XMLStringWriter out;
 
-            default:
-               wxASSERT(true);
-            break;
-         }
-      } }
-      catch( const Error & )
-      {
-         // return before committing, so we do not overwrite the recovery file!
+      if (!DecodeStream(in, out))
          return false;
-      }
 
-      out.Commit();
+      xmldata = out;
 
       return true;
    } );
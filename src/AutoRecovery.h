@@ -15,11 +15,13 @@
 
 #include <wx/mstream.h> // member variables
 
+#include <memory>
 #include <unordered_map>
 #include "audacity/Types.h"
 
 class wxFFile;
 class AudacityProject;
+class WaveTrack;
 
 //
 // XML Handler for a <recordingrecovery> tag
@@ -44,6 +46,27 @@ private:
    int mAutoSaveIdent;
 };
 
+//
+// XML Handler for a <trackdelta> tag, appended to the auto-save file
+// when only some tracks changed since the last full snapshot
+//
+class TrackDeltaRecoveryHandler final : public XMLTagHandler
+{
+public:
+   TrackDeltaRecoveryHandler(AudacityProject* proj);
+   bool HandleXMLTag(const wxChar *tag, const wxChar **attrs) override;
+   void HandleXMLEndTag(const wxChar *tag) override;
+   XMLTagHandler *HandleXMLChild(const wxChar *tag) override;
+
+   // This class only knows reading tags
+
+private:
+   AudacityProject* mProject;
+   int mIdent;
+   // The replacement track being parsed from the delta
+   std::shared_ptr<WaveTrack> mTrack;
+};
+
 ///
 /// AutoSaveFile
 ///
@@ -91,6 +114,13 @@ public:
 
    bool Decode(const FilePath & fileName);
 
+   // Decode the file into XML held in memory, leaving the file itself
+   // untouched; recovery can parse the result directly instead of
+   // rewriting the file on disk and reading it back.  Returns false,
+   // reporting no error, for files not in the encoded format; the
+   // caller then falls back to Decode.
+   bool DecodeString(const FilePath & fileName, wxString & xmldata);
+
 private:
    void WriteName(const wxString & name);
    void CheckSpace(wxMemoryOutputStream & buf);
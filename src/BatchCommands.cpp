@@ -740,7 +740,9 @@ bool MacroCommands::DoAudacityCommand(
       PushState(longDesc, shortDesc);
    }
 */
-   window.RedrawProject();
+   // One redraw happens when the whole macro is done
+   if (project.mBatchMode == 0)
+      window.RedrawProject();
    return true;
 }
 
@@ -969,8 +971,11 @@ bool MacroCommands::ApplyMacro(
 
    if (!proj)
       return false;
-   if( MacroReentryCount <= 1 )
+   if( MacroReentryCount <= 1 ) {
       ProjectHistory::Get( *proj ).PushState(longDesc, shortDesc);
+      // The per-command redraws were suppressed while in batch mode
+      ProjectWindow::Get( *proj ).RedrawProject();
+   }
    return true;
 }
 
@@ -49,6 +49,8 @@
 #include "SelectUtilities.h"
 #include "commands/CommandManager.h"
 #include "effects/Effect.h"
+#include "effects/TrackIOQueue.h"
+#include <wx/ffile.h>
 #include "../images/Arrow.xpm"
 #include "../images/Empty9x16.xpm"
 #include "UndoManager.h"
@@ -455,6 +457,26 @@ void ApplyMacroDialog::OnApplyToFiles(wxCommandEvent & WXUNUSED(event))
    // and hiding this one temporarily has some advantages.
    Hide();
 
+   // Importing, processing and exporting cannot leave this thread: the
+   // command system, the effects and every AudacityProject assume use of
+   // the GUI thread only.  But the biggest idle gap between files is the
+   // disk, so while one file goes through the macro a worker reads the
+   // next one sequentially, and it is already in the system cache when
+   // its turn to be imported comes.
+   TrackIOQueue prefetchQueue;
+   auto Prefetch = [&prefetchQueue](const wxString &fileName){
+      prefetchQueue.Post([fileName]{
+         wxFFile file(fileName, wxT("rb"));
+         if (!file.IsOpened())
+            return;
+         char buffer[65536];
+         while (!file.Eof() && file.Read(buffer, sizeof(buffer)) > 0)
+            ;
+      });
+   };
+   if (files.size() > 0)
+      Prefetch(files[0]);
+
    mMacroCommands.ReadMacro(name);
    for (i = 0; i < (int)files.size(); i++) {
       wxWindowDisabler wd(&activityWin);
@@ -465,6 +487,9 @@ void ApplyMacroDialog::OnApplyToFiles(wxCommandEvent & WXUNUSED(event))
       fileList->SetItemImage(i, 1, 1);
       fileList->EnsureVisible(i);
 
+      if (i + 1 < (int)files.size())
+         Prefetch(files[i + 1]);
+
       auto success = GuardedCall< bool >( [&] {
          ProjectFileManager::Get( *project ).Import(files[i]);
          ProjectWindow::Get( *project ).ZoomAfterImport(nullptr);
@@ -12,6 +12,14 @@
 \brief BenchmarkDialog is used for measuring performance and accuracy
 of the BlockFile system.
 
+*//****************************************************************//**
+
+\class BenchmarkCommand
+\brief Scriptable benchmark suite.  Where BenchmarkDialog stresses the
+BlockFile system interactively, BenchmarkCommand times the program's
+hot paths and emits machine-readable results, for tracking performance
+across releases from a script.
+
 *//*******************************************************************/
 
 
@@ -33,15 +41,25 @@ of the BlockFile system.
 #include <wx/valgen.h>
 #include <wx/valtext.h>
 #include <wx/intl.h>
+#include <wx/textfile.h>
+
+#include <wx/dcmemory.h>
 
 #include "DirManager.h"
+#include "Mix.h"
+#include "Shuttle.h"
 #include "ShuttleGui.h"
 #include "Project.h"
+#include "TrackArtist.h"
+#include "TrackPanel.h"
+#include "TrackPanelDrawingContext.h"
 #include "WaveClip.h"
 #include "WaveTrack.h"
 #include "Sequence.h"
 #include "Prefs.h"
 #include "ViewInfo.h"
+#include "commands/CommandContext.h"
+#include "tracks/playabletrack/wavetrack/ui/WaveformView.h"
 
 #include "FileNames.h"
 #include "widgets/AudacityMessageBox.h"
@@ -560,3 +578,379 @@ void BenchmarkDialog::OnRun( wxCommandEvent & WXUNUSED(event))
    Printf(_("Benchmark completed successfully.\n"));
    HoldPrint(false);
 }
+
+//
+// BenchmarkCommand
+//
+
+bool BenchmarkCommand::DefineParams( ShuttleParams & S ){
+   S.Define( mDataSize,      wxT("DataSize"),     32, 1, 2000 );
+   S.Define( mNumEdits,      wxT("NumEdits"),     100, 1, 10000 );
+   S.Define( mWarmup,        wxT("Warmup"),       1, 0, 100 );
+   S.Define( mIterations,    wxT("Iterations"),   3, 1, 100 );
+   S.Define( mRandSeed,      wxT("RandSeed"),     234657, 0, 100000000 );
+   S.Define( mThreshold,     wxT("Threshold"),    1.2, 1.0, 100.0 );
+   S.Define( mBaseline,      wxT("Baseline"),     "" );
+   S.Define( mbSaveBaseline, wxT("SaveBaseline"), false );
+   return true;
+}
+
+void BenchmarkCommand::PopulateOrExchange(ShuttleGui & S)
+{
+   S.AddSpace(0, 5);
+
+   S.StartMultiColumn(2, wxALIGN_CENTER);
+   {
+      S.TieTextBox(_("Test Data Size (MB):"), mDataSize);
+      S.TieTextBox(_("Number of Edits:"), mNumEdits);
+      S.TieTextBox(_("Warmup Runs:"), mWarmup);
+      S.TieTextBox(_("Timed Runs:"), mIterations);
+      S.TieTextBox(_("Random Seed:"), mRandSeed);
+      S.TieTextBox(_("Regression Threshold:"), mThreshold);
+      S.TieTextBox(_("Baseline File:"), mBaseline);
+      S.TieCheckBox(_("Save Baseline:"), mbSaveBaseline);
+   }
+   S.EndMultiColumn();
+}
+
+bool BenchmarkCommand::Apply(const CommandContext & context)
+{
+   // The suite works on a private track with its own DirManager, so the
+   // open project is left alone.  The cut-and-paste case relies on clips
+   // closing the gap, just as the dialog benchmark does.
+   bool editClipCanMove = true;
+   gPrefs->Read(wxT("/GUI/EditClipCanMove"), &editClipCanMove);
+   gPrefs->Write(wxT("/GUI/EditClipCanMove"), false);
+   gPrefs->Flush();
+
+   const auto cleanup = finally( [&] {
+      gPrefs->Write(wxT("/GUI/EditClipCanMove"), editClipCanMove);
+      gPrefs->Flush();
+   } );
+
+   // Results of an earlier run, for regression detection.
+   std::vector< std::pair< wxString, double > > baseline;
+   if (!mBaseline.empty() && wxTextFile::Exists(mBaseline)) {
+      wxTextFile file(mBaseline);
+      if (file.Open()) {
+         for (size_t i = 0; i < file.GetLineCount(); i++) {
+            const wxString line = file[i];
+            double ms;
+            if (line.AfterLast(wxT(' ')).ToDouble(&ms))
+               baseline.push_back( { line.BeforeLast(wxT(' ')), ms } );
+         }
+      }
+   }
+
+   std::vector< std::pair< wxString, double > > results;
+   bool regressed = false;
+   wxStopWatch timer;
+
+   // Run a case mWarmup times unmeasured, then mIterations times for the
+   // clock, and report the best and mean times as one structured result,
+   // so a sweep script gets JSON rather than text to parse.
+   const auto Time = [&]( const wxString &name, const auto &body )
+   {
+      for (int i = 0; i < mWarmup; i++)
+         body();
+
+      double best = 0.0, total = 0.0;
+      for (int i = 0; i < mIterations; i++) {
+         timer.Start();
+         body();
+         const double ms = timer.Time();
+         total += ms;
+         if (i == 0 || ms < best)
+            best = ms;
+      }
+      results.push_back( { name, best } );
+
+      context.StartStruct();
+      context.AddItem( name, wxT("name") );
+      context.AddItem( (double)mIterations, wxT("runs") );
+      context.AddItem( best, wxT("best_ms") );
+      context.AddItem( total / mIterations, wxT("mean_ms") );
+      for (const auto &pair : baseline) {
+         if (pair.first == name && pair.second > 0.0) {
+            const double ratio = best / pair.second;
+            context.AddItem( pair.second, wxT("baseline_ms") );
+            context.AddItem( ratio, wxT("ratio") );
+            context.AddBool( ratio > mThreshold, wxT("regression") );
+            if (ratio > mThreshold)
+               regressed = true;
+            break;
+         }
+      }
+      context.EndStruct();
+   };
+
+   ZoomInfo zoomInfo(0.0, ZoomInfo::GetDefaultZoom());
+   auto dd = DirManager::Create();
+   TrackFactory factory{ dd, &zoomInfo };
+
+   const double rate = 44100.0;
+   const size_t nSamples = (size_t)mDataSize * 1048576 / sizeof(float);
+   const size_t chunkSize = 65536;
+
+   srand(mRandSeed);
+
+   Floats buffer{ chunkSize };
+   for (size_t i = 0; i < chunkSize; i++)
+      buffer[i] = (rand() / (float)RAND_MAX) * 2.0f - 1.0f;
+
+   // rand() % range is unusable here; RAND_MAX may be less than the
+   // sample counts involved.
+   const auto Random = [](size_t range) {
+      return (size_t)((rand() / (RAND_MAX + 1.0)) * range);
+   };
+
+   std::shared_ptr<WaveTrack> t;
+
+   context.StartArray();
+
+   // Sequence::Append, which also computes the 256 and 64K summaries of
+   // every block file as it goes.
+   Time( wxT("append"), [&]{
+      t = factory.NewWaveTrack(floatSample, rate);
+      size_t remaining = nSamples;
+      while (remaining > 0) {
+         const size_t block = std::min(remaining, chunkSize);
+         t->Append((samplePtr)buffer.get(), floatSample, block);
+         remaining -= block;
+      }
+      t->Flush();
+   } );
+
+   // The cut-and-paste pattern of the dialog benchmark, at the default
+   // block size.
+   Time( wxT("edits"), [&]{
+      for (int z = 0; z < mNumEdits; z++) {
+         const size_t x0 = Random(nSamples);
+         const size_t xlen = 1 + Random(nSamples - x0);
+         auto tmp = t->Cut(x0 / rate, (x0 + xlen) / rate);
+         const size_t y0 = Random(nSamples - xlen + 1);
+         t->Paste(y0 / rate, tmp.get());
+      }
+   } );
+
+   // Sequential read of every sample, as playback and effects do.
+   Time( wxT("read"), [&]{
+      Floats out{ t->GetMaxBlockSize() };
+      const auto end = t->GetClipByIndex(0)->GetSequence()->GetNumSamples();
+      sampleCount pos = 0;
+      while (pos < end) {
+         const auto block =
+            limitSampleBufferSize( t->GetBestBlockSize(pos), end - pos );
+         t->Get((samplePtr)out.get(), floatSample, pos, block);
+         pos += block;
+      }
+   } );
+
+   // Whole-track min, max and RMS, answered from the block summaries.
+   Time( wxT("summary"), [&]{
+      const double end = t->GetEndTime();
+      t->GetMinMax(0.0, end);
+      t->GetRMS(0.0, end);
+   } );
+
+   // The block loop of Effect::ProcessTrack: read a block, work on it,
+   // write it back.  (A token gain stands in for the effect's own DSP,
+   // which this suite is not trying to measure.)
+   Time( wxT("process"), [&]{
+      Floats out{ t->GetMaxBlockSize() };
+      const auto end = t->GetClipByIndex(0)->GetSequence()->GetNumSamples();
+      sampleCount pos = 0;
+      while (pos < end) {
+         const auto block =
+            limitSampleBufferSize( t->GetBestBlockSize(pos), end - pos );
+         t->Get((samplePtr)out.get(), floatSample, pos, block);
+         for (size_t i = 0; i < block; i++)
+            out[i] *= 0.999f;
+         t->Set((samplePtr)out.get(), floatSample, pos, block);
+         pos += block;
+      }
+   } );
+
+   // Mixer::Process to interleaved stereo int16, which is the body of a
+   // WAV export.
+   Time( wxT("mix"), [&]{
+      WaveTrackConstArray waveTracks;
+      waveTracks.push_back(t);
+      Mixer mixer(waveTracks, true, Mixer::WarpOptions{ nullptr },
+                  0.0, t->GetEndTime(), 2, chunkSize, true,
+                  rate, int16Sample);
+      while (mixer.Process(chunkSize))
+         ;
+   } );
+
+   // GetWaveDisplay at several zooms, from roughly whole-track view to
+   // nearly sample level.  Each run clears the wave cache first; it is
+   // the cold computation that we want to time.
+   for (double pps : { 1.0, 10.0, 100.0, 1000.0 }) {
+      const auto clip = t->GetClipByIndex(0);
+      const int width =
+         std::min( 1000, (int)(clip->GetEndTime() * pps) );
+      if (width <= 0)
+         continue;
+      Time( wxString::Format(wxT("display_pps%g"), pps), [&]{
+         clip->ClearWaveCache();
+         WaveDisplay display{ width };
+         bool isLoadingOD = false;
+         clip->GetWaveDisplay(display, 0.0, pps, isLoadingOD);
+      } );
+   }
+
+   context.EndArray();
+
+   if (mbSaveBaseline && !mBaseline.empty()) {
+      wxTextFile file(mBaseline);
+      if (file.Exists() ? file.Open() : file.Create()) {
+         file.Clear();
+         for (const auto &pair : results)
+            file.AddLine( wxString::Format(
+               wxT("%s %.1f"), pair.first, pair.second ) );
+         file.Write();
+         context.Status(wxString::Format(
+            wxT("Baseline saved to %s"), mBaseline));
+      }
+      else {
+         context.Error(wxString::Format(
+            wxT("Could not write baseline file %s"), mBaseline));
+         return false;
+      }
+   }
+
+   if (regressed) {
+      context.Error(wxT("Benchmark regressed against the baseline!"));
+      return false;
+   }
+
+   return true;
+}
+
+//
+// RenderBenchmarkCommand
+//
+
+bool RenderBenchmarkCommand::DefineParams( ShuttleParams & S ){
+   S.Define( mNumTracks,     wxT("Tracks"),        8, 1, 200 );
+   S.Define( mClipsPerTrack, wxT("ClipsPerTrack"), 4, 1, 100 );
+   S.Define( mClipSeconds,   wxT("ClipSeconds"),   5.0, 0.1, 600.0 );
+   S.Define( mWidth,         wxT("Width"),         1000, 100, 8192 );
+   S.Define( mTrackHeight,   wxT("TrackHeight"),   120, 20, 1000 );
+   S.Define( mFrames,        wxT("Frames"),        50, 1, 10000 );
+   S.Define( mRandSeed,      wxT("RandSeed"),      234657, 0, 100000000 );
+   return true;
+}
+
+void RenderBenchmarkCommand::PopulateOrExchange(ShuttleGui & S)
+{
+   S.AddSpace(0, 5);
+
+   S.StartMultiColumn(2, wxALIGN_CENTER);
+   {
+      S.TieTextBox(_("Number of Tracks:"), mNumTracks);
+      S.TieTextBox(_("Clips per Track:"), mClipsPerTrack);
+      S.TieTextBox(_("Clip Length (s):"), mClipSeconds);
+      S.TieTextBox(_("Frame Width (px):"), mWidth);
+      S.TieTextBox(_("Track Height (px):"), mTrackHeight);
+      S.TieTextBox(_("Frames per Zoom:"), mFrames);
+      S.TieTextBox(_("Random Seed:"), mRandSeed);
+   }
+   S.EndMultiColumn();
+}
+
+bool RenderBenchmarkCommand::Apply(const CommandContext & context)
+{
+   // Build the synthetic project shape on private tracks with their own
+   // DirManager, so the open project is left alone
+   ZoomInfo dummyZoom(0.0, ZoomInfo::GetDefaultZoom());
+   auto dd = DirManager::Create();
+   TrackFactory factory{ dd, &dummyZoom };
+
+   const double rate = 44100.0;
+   const size_t clipSamples = (size_t)(mClipSeconds * rate);
+   const size_t chunkSize = 65536;
+
+   srand(mRandSeed);
+
+   Floats buffer{ chunkSize };
+   for (size_t i = 0; i < chunkSize; i++)
+      buffer[i] = (rand() / (float)RAND_MAX) * 2.0f - 1.0f;
+
+   // Clips alternate with gaps of half a clip's length
+   const double clipSpacing = mClipSeconds * 1.5;
+   std::vector< std::shared_ptr<WaveTrack> > tracks;
+   for (int tt = 0; tt < mNumTracks; ++tt) {
+      auto t = factory.NewWaveTrack(floatSample, rate);
+      for (int cc = 0; cc < mClipsPerTrack; ++cc) {
+         const auto clip = t->CreateClip();
+         clip->SetOffset( cc * clipSpacing );
+         size_t remaining = clipSamples;
+         while (remaining > 0) {
+            const size_t block = std::min(remaining, chunkSize);
+            clip->Append((samplePtr)buffer.get(), floatSample, block);
+            remaining -= block;
+         }
+         clip->Flush();
+      }
+      tracks.push_back(t);
+   }
+   const double totalSeconds = mClipsPerTrack * clipSpacing;
+
+   // A private artist, drawing into a memory bitmap rather than the
+   // screen; the flags are those of a plain repaint with no tool down
+   auto &project = context.project;
+   auto artist = std::make_unique<TrackArtist>( &TrackPanel::Get( project ) );
+   SelectedRegion selectedRegion;
+   artist->pSelectedRegion = &selectedRegion;
+
+   wxBitmap bitmap(mWidth, mTrackHeight * mNumTracks);
+   wxMemoryDC dc(bitmap);
+
+   wxStopWatch timer;
+
+   // Zooms from whole-project view down to nearly sample level, each
+   // scrolled across the project in mFrames steps.  The first frame at
+   // a zoom computes the wave caches cold; later frames measure the
+   // scrolling partial recomputation that dominates interactive use.
+   const double wholeProject = mWidth / totalSeconds;
+   context.StartArray();
+   for (const double pps : { wholeProject, 100.0, 1000.0, 10000.0 }) {
+      ZoomInfo zoomInfo(0.0, pps);
+      artist->pZoomInfo = &zoomInfo;
+
+      const double visible = mWidth / pps;
+      const double span = std::max( 0.0, totalSeconds - visible );
+
+      double best = 0.0, worst = 0.0, total = 0.0;
+      for (int frame = 0; frame < mFrames; ++frame) {
+         zoomInfo.h = mFrames > 1 ? span * frame / (mFrames - 1) : 0.0;
+
+         timer.Start();
+         TrackPanelDrawingContext ctx{ dc, {}, {}, artist.get() };
+         for (int tt = 0; tt < mNumTracks; ++tt) {
+            const wxRect rect{ 0, tt * mTrackHeight, mWidth, mTrackHeight };
+            WaveformView::DoDraw( ctx, tracks[tt].get(), rect, false );
+         }
+         const double ms = timer.Time();
+
+         total += ms;
+         if (frame == 0 || ms < best)
+            best = ms;
+         if (ms > worst)
+            worst = ms;
+      }
+
+      context.StartStruct();
+      context.AddItem( pps, wxT("pps") );
+      context.AddItem( (double)mFrames, wxT("frames") );
+      context.AddItem( best, wxT("best_ms") );
+      context.AddItem( total / mFrames, wxT("mean_ms") );
+      context.AddItem( worst, wxT("worst_ms") );
+      context.EndStruct();
+   }
+   context.EndArray();
+
+   return true;
+}
@@ -11,6 +11,76 @@
 #ifndef __AUDACITY_BENCHMARK__
 #define __AUDACITY_BENCHMARK__
 
+#include "commands/AudacityCommand.h"
+
+class ShuttleGui;
+
 void RunBenchmark(wxWindow *parent);
 
+#define BENCHMARK_SUITE_PLUGIN_SYMBOL \
+   ComponentInterfaceSymbol{ XO("Benchmark Suite") }
+
+// Scriptable counterpart of the benchmark dialog.  Times the hot paths --
+// appending (with summary computation), reading, editing, effect-style
+// processing, mixing and waveform display -- on a private track, and
+// reports each measurement as a structured result, which mod-script-pipe
+// delivers as JSON.  Results can be
+// saved to a baseline file and later runs compared against it, so
+// regressions show up as a failed command.
+class BenchmarkCommand final : public AudacityCommand
+{
+public:
+   // ComponentInterface overrides
+   ComponentInterfaceSymbol GetSymbol() override {return BENCHMARK_SUITE_PLUGIN_SYMBOL;};
+   wxString GetDescription() override {return _("Times disk, mixing and display hot paths and reports the results.");};
+   bool DefineParams( ShuttleParams & S ) override;
+   void PopulateOrExchange(ShuttleGui & S) override;
+   bool Apply(const CommandContext & context) override;
+
+   // AudacityCommand overrides
+   wxString ManualPage() override {return wxT("Extra_Menu:_Scriptables_II");};
+
+private:
+   int mDataSize;
+   int mNumEdits;
+   int mWarmup;
+   int mIterations;
+   int mRandSeed;
+   double mThreshold;
+   wxString mBaseline;
+   bool mbSaveBaseline;
+};
+
+#define RENDER_BENCHMARK_PLUGIN_SYMBOL \
+   ComponentInterfaceSymbol{ XO("Render Benchmark") }
+
+// Scriptable waveform-drawing benchmark.  Builds private tracks of a
+// given shape -- track count, clips per track, clip length -- then
+// paints them with the track artist into a memory bitmap, scrolling
+// across the project at several zoom levels, and reports per-frame
+// times as structured results.  Display regressions become measurable
+// from a script, without a visible window.
+class RenderBenchmarkCommand final : public AudacityCommand
+{
+public:
+   // ComponentInterface overrides
+   ComponentInterfaceSymbol GetSymbol() override {return RENDER_BENCHMARK_PLUGIN_SYMBOL;};
+   wxString GetDescription() override {return _("Times offscreen waveform drawing and reports per-frame results.");};
+   bool DefineParams( ShuttleParams & S ) override;
+   void PopulateOrExchange(ShuttleGui & S) override;
+   bool Apply(const CommandContext & context) override;
+
+   // AudacityCommand overrides
+   wxString ManualPage() override {return wxT("Extra_Menu:_Scriptables_II");};
+
+private:
+   int mNumTracks;
+   int mClipsPerTrack;
+   double mClipSeconds;
+   int mWidth;
+   int mTrackHeight;
+   int mFrames;
+   int mRandSeed;
+};
+
 #endif // define __AUDACITY_BENCHMARK__
@@ -42,6 +42,7 @@ out.
 #include "Audacity.h"
 #include "BlockFile.h"
 
+#include <algorithm>
 #include <float.h>
 #include <cmath>
 
@@ -51,8 +52,21 @@ out.
 #include <wx/log.h>
 
 #include "sndfile.h"
+#include "blockfile/BlockReclaimQueue.h"
 #include "FileException.h"
 #include "FileFormats.h"
+#include "SndfileReadahead.h"
+
+// Summary computation runs on every recorded or imported block; use the
+// vector unit where the compiler is already targeting one.
+#if defined(__AVX__) || defined(__SSE2__) || defined(_M_X64) || \
+   (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SUMMARY_VECTOR_SSE
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define SUMMARY_VECTOR_NEON
+#include <arm_neon.h>
+#endif
 
 // msmeyer: Define this to add debug output via wxPrintf()
 //#define DEBUG_BLOCKFILE
@@ -68,6 +82,76 @@ out.
 static const int headerTagLen = 20;
 static char headerTag[headerTagLen + 1] = "AudacityBlockFile112";
 
+/// Min, max and sum of squares of a run of samples in one pass.
+/// Returns the sum of squares; a float accumulator suffices for the runs
+/// of at most 256 samples that summaries are built from.
+static float MinMaxSumSq(const float *buffer, size_t len,
+                         float *outMin, float *outMax)
+{
+   float min = buffer[0];
+   float max = buffer[0];
+   float sumsq = 0.0f;
+   size_t i = 0;
+
+#ifdef SUMMARY_VECTOR_SSE
+   if (len >= 4) {
+      __m128 vmin = _mm_loadu_ps(buffer);
+      __m128 vmax = vmin;
+      __m128 vsum = _mm_mul_ps(vmin, vmin);
+      for (i = 4; i + 4 <= len; i += 4) {
+         const __m128 v = _mm_loadu_ps(buffer + i);
+         vmin = _mm_min_ps(vmin, v);
+         vmax = _mm_max_ps(vmax, v);
+         vsum = _mm_add_ps(vsum, _mm_mul_ps(v, v));
+      }
+      float lanes[4];
+      _mm_storeu_ps(lanes, vsum);
+      sumsq = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+      _mm_storeu_ps(lanes, vmin);
+      min = lanes[0];
+      for (int j = 1; j < 4; j++)
+         if (lanes[j] < min)
+            min = lanes[j];
+      _mm_storeu_ps(lanes, vmax);
+      max = lanes[0];
+      for (int j = 1; j < 4; j++)
+         if (lanes[j] > max)
+            max = lanes[j];
+   }
+#elif defined(SUMMARY_VECTOR_NEON)
+   if (len >= 4) {
+      float32x4_t vmin = vld1q_f32(buffer);
+      float32x4_t vmax = vmin;
+      float32x4_t vsum = vmulq_f32(vmin, vmin);
+      for (i = 4; i + 4 <= len; i += 4) {
+         const float32x4_t v = vld1q_f32(buffer + i);
+         vmin = vminq_f32(vmin, v);
+         vmax = vmaxq_f32(vmax, v);
+         vsum = vmlaq_f32(vsum, v, v);
+      }
+      float32x2_t pair = vpmin_f32(vget_low_f32(vmin), vget_high_f32(vmin));
+      min = vget_lane_f32(vpmin_f32(pair, pair), 0);
+      pair = vpmax_f32(vget_low_f32(vmax), vget_high_f32(vmax));
+      max = vget_lane_f32(vpmax_f32(pair, pair), 0);
+      pair = vadd_f32(vget_low_f32(vsum), vget_high_f32(vsum));
+      sumsq = vget_lane_f32(vpadd_f32(pair, pair), 0);
+   }
+#endif
+
+   for (; i < len; i++) {
+      const float f1 = buffer[i];
+      sumsq += f1 * f1;
+      if (f1 < min)
+         min = f1;
+      else if (f1 > max)
+         max = f1;
+   }
+
+   *outMin = min;
+   *outMax = max;
+   return sumsq;
+}
+
 SummaryInfo::SummaryInfo(size_t samples)
 {
    format = floatSample;
@@ -106,13 +190,14 @@ BlockFile::BlockFile(wxFileNameWrapper &&fileName, size_t samples):
 }
 
 // static
-unsigned long BlockFile::gBlockFileDestructionCount { 0 };
+std::atomic<unsigned long> BlockFile::gBlockFileDestructionCount { 0 };
 
 BlockFile::~BlockFile()
 {
    if (!IsLocked() && mFileName.HasName())
-      // PRL: what should be done if this fails?
-      wxRemoveFile(mFileName.GetFullPath());
+      // Journaled and removed in batches off the main thread; undo
+      // history of any size is discarded without a pause
+      BlockReclaimQueue::Get().Delete(mFileName.GetFullPath());
 
    ++gBlockFileDestructionCount;
 }
@@ -192,6 +277,8 @@ void *BlockFile::CalcSummary(samplePtr buffer, size_t len,
    // Caller has nothing to deallocate
    cleanup.reset();
 
+   mContentHash = ContentHash(buffer, len, format);
+
    fullSummary.reinit(mSummaryInfo.totalSummaryBytes);
 
    memcpy(fullSummary.get(), headerTag, headerTagLen);
@@ -208,6 +295,32 @@ void *BlockFile::CalcSummary(samplePtr buffer, size_t len,
    return fullSummary.get();
 }
 
+unsigned long long BlockFile::ContentHash(
+   samplePtr buffer, size_t len, sampleFormat format)
+{
+   // 64-bit FNV-1a over the format code and then the raw sample bytes.
+   // Mixing in the format keeps equal byte patterns of different formats
+   // from colliding.
+   unsigned long long hash = 14695981039346656037ULL;
+   const unsigned long long prime = 1099511628211ULL;
+
+   unsigned formatCode = (unsigned)format;
+   for (unsigned ii = 0; ii < sizeof formatCode; ++ii) {
+      hash ^= (formatCode >> (8 * ii)) & 0xffu;
+      hash *= prime;
+   }
+
+   const unsigned char *bytes = (const unsigned char *)buffer;
+   const size_t nBytes = len * SAMPLE_SIZE(format);
+   for (size_t ii = 0; ii < nBytes; ++ii) {
+      hash ^= bytes[ii];
+      hash *= prime;
+   }
+
+   // Reserve 0 to mean "never computed"
+   return hash ? hash : prime;
+}
+
 void BlockFile::CalcSummaryFromBuffer(const float *fbuffer, size_t len,
                                       float *summary256, float *summary64K)
 {
@@ -218,27 +331,24 @@ void BlockFile::CalcSummaryFromBuffer(const float *fbuffer, size_t len,
    double totalSquares = 0.0;
    double fraction { 0.0 };
 
-   // Recalc 256 summaries
+   // Recalc 256 summaries, and roll the 64K summaries up in the same pass
+   // so the data are traversed once and summary256 is never re-read
    sumLen = (len + 255) / 256;
-   int summaries = 256;
+
+   float min64 = FLT_MAX;
+   float max64 = -FLT_MAX;
+   float sumsq64 = 0.0f;
+   decltype(sumLen) count64 = 0;
+   decltype(sumLen) sumLen64 = 0;
 
    for (decltype(sumLen) i = 0; i < sumLen; i++) {
-      min = fbuffer[i * 256];
-      max = fbuffer[i * 256];
-      sumsq = ((float)min) * ((float)min);
       decltype(len) jcount = 256;
       if (jcount > len - i * 256) {
          jcount = len - i * 256;
          fraction = 1.0 - (jcount / 256.0);
       }
-      for (decltype(jcount) j = 1; j < jcount; j++) {
-         float f1 = fbuffer[i * 256 + j];
-         sumsq += ((float)f1) * ((float)f1);
-         if (f1 < min)
-            min = f1;
-         else if (f1 > max)
-            max = f1;
-      }
+
+      sumsq = MinMaxSumSq(&fbuffer[i * 256], jcount, &min, &max);
 
       totalSquares += sumsq;
       float rms = (float)sqrt(sumsq / jcount);
@@ -246,11 +356,33 @@ void BlockFile::CalcSummaryFromBuffer(const float *fbuffer, size_t len,
       summary256[i * 3] = min;
       summary256[i * 3 + 1] = max;
       summary256[i * 3 + 2] = rms;  // The rms is correct, but this may be for less than 256 samples in last loop.
+
+      if (min < min64)
+         min64 = min;
+      if (max > max64)
+         max64 = max;
+      sumsq64 += rms * rms;
+      count64++;
+
+      if (count64 == 256 || i == sumLen - 1) {
+         // The partial last 256 frame weighs for only its fraction;
+         // count64 is short of 256 only in the last 64K frame
+         double denom = (i == sumLen - 1) ? count64 - fraction : 256.0;
+         float rms64 = (float)sqrt(sumsq64 / denom);
+
+         summary64K[sumLen64 * 3] = min64;
+         summary64K[sumLen64 * 3 + 1] = max64;
+         summary64K[sumLen64 * 3 + 2] = rms64;
+         sumLen64++;
+
+         min64 = FLT_MAX;
+         max64 = -FLT_MAX;
+         sumsq64 = 0.0f;
+         count64 = 0;
+      }
    }
    for (auto i = sumLen; i < mSummaryInfo.frames256; i++) {
       // filling in the remaining bits with non-harming/contributing values
-      // rms values are not "non-harming", so keep  count of them:
-      summaries--;
       summary256[i * 3] = FLT_MAX;  // min
       summary256[i * 3 + 1] = -FLT_MAX;   // max
       summary256[i * 3 + 2] = 0.0f; // rms
@@ -259,31 +391,8 @@ void BlockFile::CalcSummaryFromBuffer(const float *fbuffer, size_t len,
    // Calculate now while we can do it accurately
    mRMS = sqrt(totalSquares/len);
 
-   // Recalc 64K summaries
-   sumLen = (len + 65535) / 65536;
-
-   for (decltype(sumLen) i = 0; i < sumLen; i++) {
-      min = summary256[3 * i * 256];
-      max = summary256[3 * i * 256 + 1];
-      sumsq = (float)summary256[3 * i * 256 + 2];
-      sumsq *= sumsq;
-      for (decltype(len) j = 1; j < 256; j++) {   // we can overflow the useful summary256 values here, but have put non-harmful values in them
-         if (summary256[3 * (i * 256 + j)] < min)
-            min = summary256[3 * (i * 256 + j)];
-         if (summary256[3 * (i * 256 + j) + 1] > max)
-            max = summary256[3 * (i * 256 + j) + 1];
-         float r1 = summary256[3 * (i * 256 + j) + 2];
-         sumsq += r1*r1;
-      }
-
-      double denom = (i < sumLen - 1) ? 256.0 : summaries - fraction;
-      float rms = (float)sqrt(sumsq / denom);
-
-      summary64K[i * 3] = min;
-      summary64K[i * 3 + 1] = max;
-      summary64K[i * 3 + 2] = rms;
-   }
-   for (auto i = sumLen; i < mSummaryInfo.frames64K; i++) {
+   wxASSERT(sumLen64 == (len + 65535) / 65536);
+   for (auto i = sumLen64; i < mSummaryInfo.frames64K; i++) {
       wxASSERT_MSG(false, wxT("Out of data for mSummaryInfo"));   // Do we ever get here?
       summary64K[i * 3] = 0.0f;  // probably should be FLT_MAX, need a test case
       summary64K[i * 3 + 1] = 0.0f; // probably should be -FLT_MAX, need a test case
@@ -294,7 +403,7 @@ void BlockFile::CalcSummaryFromBuffer(const float *fbuffer, size_t len,
    min = summary64K[0];
    max = summary64K[1];
 
-   for (decltype(sumLen) i = 1; i < sumLen; i++) {
+   for (decltype(sumLen64) i = 1; i < sumLen64; i++) {
       if (summary64K[3*i] < min)
          min = summary64K[3*i];
       if (summary64K[3*i+1] > max)
@@ -377,27 +486,102 @@ void BlockFile::FixSummary(void *data)
 auto BlockFile::GetMinMaxRMS(size_t start, size_t len, bool mayThrow)
    const -> MinMaxRMS
 {
-   // TODO: actually use summaries
-   SampleBuffer blockData(len, floatSample);
-
-   this->ReadData(blockData.ptr(), floatSample, start, len, mayThrow);
-
    float min = FLT_MAX;
    float max = -FLT_MAX;
-   float sumsq = 0;
+   double sumsq = 0;
+   size_t count = 0;
 
-   for( decltype(len) i = 0; i < len; i++ )
-   {
-      float sample = ((float*)blockData.ptr())[i];
+   auto accumulateRaw = [&](size_t from, size_t n) {
+      if (n == 0)
+         return;
+      SampleBuffer blockData(n, floatSample);
+      this->ReadData(blockData.ptr(), floatSample, from, n, mayThrow);
+      const float *samples = (const float*)blockData.ptr();
+      for (decltype(n) i = 0; i < n; i++) {
+         const float sample = samples[i];
+         if (sample > max)
+            max = sample;
+         if (sample < min)
+            min = sample;
+         sumsq += sample * sample;
+      }
+      count += n;
+   };
+
+   const size_t blockLen = GetLength();
+   const size_t end = start + len;
+
+   // Frame-aligned interior of the range, as whole 256 sample frames;
+   // a partial final frame of the block counts as whole
+   const size_t totalFrames256 = (blockLen + 255) / 256;
+   const size_t first256 = (start + 255) / 256;
+   const size_t last256 =
+      (end == blockLen) ? totalFrames256 : end / 256;
+
+   // Serve the aligned interior of the range from the summaries and read
+   // raw samples only for the sub-frame fringes, so the edge blocks of a
+   // long selection cost a few hundred samples rather than the whole
+   // block.  The widest aligned span comes from the 64K level.
+   if (len > 512 && last256 > first256 && IsSummaryAvailable()) {
+      // The summary readers only consult, and at need repair, summary
+      // data; sample data stay untouched
+      auto &file = const_cast<BlockFile&>(*this);
+
+      auto accumulate256 = [&](size_t from, size_t to) {
+         if (to <= from)
+            return;
+         const auto n = to - from;
+         Floats summary{ n * 3 };
+         file.Read256(summary.get(), from, n);
+         for (decltype(n) i = 0; i < n; i++) {
+            if (summary[i * 3] < min)
+               min = summary[i * 3];
+            if (summary[i * 3 + 1] > max)
+               max = summary[i * 3 + 1];
+            // The frame's rms was computed over the samples it covers
+            const auto frameLen =
+               std::min<size_t>(256, blockLen - (from + i) * 256);
+            const double rms = summary[i * 3 + 2];
+            sumsq += rms * rms * frameLen;
+            count += frameLen;
+         }
+      };
+
+      const size_t first64K = (first256 + 255) / 256;
+      const size_t last64K = (last256 == totalFrames256)
+         ? (blockLen + 65535) / 65536
+         : last256 / 256;
+
+      if (last64K > first64K) {
+         const auto n = last64K - first64K;
+         Floats summary{ n * 3 };
+         file.Read64K(summary.get(), first64K, n);
+         for (decltype(n) i = 0; i < n; i++) {
+            if (summary[i * 3] < min)
+               min = summary[i * 3];
+            if (summary[i * 3 + 1] > max)
+               max = summary[i * 3 + 1];
+            const auto frameLen =
+               std::min<size_t>(65536, blockLen - (first64K + i) * 65536);
+            const double rms = summary[i * 3 + 2];
+            sumsq += rms * rms * frameLen;
+            count += frameLen;
+         }
+         accumulate256(first256, first64K * 256);
+         accumulate256(last64K * 256, last256);
+      }
+      else
+         accumulate256(first256, last256);
 
-      if( sample > max )
-         max = sample;
-      if( sample < min )
-         min = sample;
-      sumsq += (sample*sample);
+      // Raw fringes before and after the aligned interior
+      accumulateRaw(start, first256 * 256 - start);
+      if (last256 * 256 < end)
+         accumulateRaw(last256 * 256, end - last256 * 256);
    }
+   else
+      accumulateRaw(start, len);
 
-   return { min, max, (float)sqrt(sumsq/len) };
+   return { min, max, (float)sqrt(sumsq / std::max<size_t>(1, count)) };
 }
 
 /// Retrieves the minimum, maximum, and maximum RMS of this entire
@@ -543,6 +727,9 @@ size_t BlockFile::CommonReadData(
 
    wxFile f;   // will be closed when it goes out of scope
    SFFile sf;
+   SNDFILE *sfp = NULL;
+   std::shared_ptr<SndfileReadCache::Entry> cacheEntry;
+   std::unique_lock<std::mutex> cacheLock;
 
    {
       Maybe<wxLogNull> silence{};
@@ -550,14 +737,29 @@ size_t BlockFile::CommonReadData(
          silence.create();
 
       const auto fullPath = fileName.GetFullPath();
-      if (wxFile::Exists(fullPath) && f.Open(fullPath)) {
+
+      if (pAliasFile && !pLegacyFormat) {
+         // Aliased files live outside the project, often on slow or
+         // remote storage, and are read block by block; go through the
+         // shared readahead cache, which keeps the handle open between
+         // blocks and prefetches ahead of sequential reads
+         cacheEntry = SndfileReadCache::Get().Open(fullPath);
+         if (cacheEntry) {
+            cacheLock = std::unique_lock<std::mutex>{ cacheEntry->mMutex };
+            info = cacheEntry->mInfo;
+            sfp = cacheEntry->mSndfile.get();
+         }
+      }
+
+      if (!sfp && wxFile::Exists(fullPath) && f.Open(fullPath)) {
          // Even though there is an sf_open() that takes a filename, use the one that
          // takes a file descriptor since wxWidgets can open a file with a Unicode name and
          // libsndfile can't (under Windows).
          sf.reset(SFCall<SNDFILE*>(sf_open_fd, f.fd(), SFM_READ, &info, FALSE));
+         sfp = sf.get();
       }
 
-      if (!sf) {
+      if (!sfp) {
 
          memset(data, 0, SAMPLE_SIZE(format)*len);
 
@@ -569,12 +771,12 @@ size_t BlockFile::CommonReadData(
          }
       }
    }
-   mSilentLog = !sf;
+   mSilentLog = !sfp;
 
    size_t framesRead = 0;
-   if (sf) {
+   if (sfp) {
       auto seek_result = SFCall<sf_count_t>(
-         sf_seek, sf.get(), ( origin + start ).as_long_long(), SEEK_SET);
+         sf_seek, sfp, ( origin + start ).as_long_long(), SEEK_SET);
 
       if (seek_result < 0)
          // error
@@ -590,13 +792,13 @@ size_t BlockFile::CommonReadData(
             // If both the src and dest formats are integer formats,
             // read integers directly from the file, comversions not needed
             framesRead = SFCall<sf_count_t>(
-               sf_readf_short, sf.get(), (short *)data, len);
+               sf_readf_short, sfp, (short *)data, len);
          }
          else if (channels == 1 &&
                   format == int24Sample &&
                   sf_subtype_is_integer(info.format)) {
             framesRead = SFCall<sf_count_t>(
-               sf_readf_int, sf.get(), (int *)data, len);
+               sf_readf_int, sfp, (int *)data, len);
 
             // libsndfile gave us the 3 byte sample in the 3 most
             // significant bytes -- we want it in the 3 least
@@ -613,7 +815,7 @@ size_t BlockFile::CommonReadData(
             // case, as most audio files are 16-bit.
             SampleBuffer buffer(len * channels, int16Sample);
             framesRead = SFCall<sf_count_t>(
-               sf_readf_short, sf.get(), (short *)buffer.ptr(), len);
+               sf_readf_short, sfp, (short *)buffer.ptr(), len);
             for (size_t i = 0; i < framesRead; i++)
                ((short *)data)[i] =
                ((short *)buffer.ptr())[(channels * i) + channel];
@@ -624,7 +826,7 @@ size_t BlockFile::CommonReadData(
             // then convert to whatever format we want.
             SampleBuffer buffer(len * channels, floatSample);
             framesRead = SFCall<sf_count_t>(
-               sf_readf_float, sf.get(), (float *)buffer.ptr(), len);
+               sf_readf_float, sfp, (float *)buffer.ptr(), len);
             auto bufferPtr = (samplePtr)((float *)buffer.ptr() + channel);
             CopySamples(bufferPtr, floatSample,
                         (samplePtr)data, format,
@@ -635,6 +837,13 @@ size_t BlockFile::CommonReadData(
       }
    }
 
+   if (cacheEntry) {
+      cacheLock.unlock();
+      // Load the next chunk in the background while the caller works on
+      // this one
+      SndfileReadCache::Get().Prefetch(cacheEntry);
+   }
+
    if ( framesRead < len ) {
       if (mayThrow)
          throw FileException{ FileException::Cause::Read, fileName };
@@ -18,6 +18,7 @@
 
 #include "ondemand/ODTaskThread.h"
 
+#include <atomic>
 #include <functional>
 
 class XMLWriter;
@@ -65,7 +66,9 @@ class PROFILE_DLL_API BlockFile /* not final, abstract */ {
    BlockFile(wxFileNameWrapper &&fileName, size_t samples);
    virtual ~BlockFile();
 
-   static unsigned long gBlockFileDestructionCount;
+   // Bumped whenever any block file is destroyed, possibly on a worker
+   // thread, so atomic
+   static std::atomic<unsigned long> gBlockFileDestructionCount;
 
    // Reading
 
@@ -145,6 +148,15 @@ class PROFILE_DLL_API BlockFile /* not final, abstract */ {
    /// Returns TRUE if this block references another disk file
    virtual bool IsAlias() const { return false; }
 
+   /// 64-bit hash of the sample contents, computed when the summary is
+   /// calculated; 0 when never computed.  Equal hashes (with equal
+   /// lengths) identify blocks with identical samples, for deduplication.
+   unsigned long long GetContentHash() const { return mContentHash; }
+
+   /// Hash sample data as it would be hashed for a block's content hash
+   static unsigned long long ContentHash(
+      samplePtr buffer, size_t len, sampleFormat format);
+
    /// Returns TRUE if this block's complete summary has been computed and is ready (for OD)
    virtual bool IsSummaryAvailable() const {return true;}
 
@@ -184,6 +196,12 @@ class PROFILE_DLL_API BlockFile /* not final, abstract */ {
    /// Allows reading on other threads.
    virtual void UnlockRead() const {}
 
+   /// Pointer to this block's samples resident in memory as floats, or
+   /// null when the data is not resident or is not stored as floats.  The
+   /// pointer stays valid while the caller holds the read lock and a
+   /// reference on the block file.
+   virtual const float *GetCachedFloats() const { return nullptr; }
+
    struct ReadLocker { void operator () ( const BlockFile *p ) const {
       if (p) p->LockRead(); } };
    struct ReadUnlocker { void operator () ( const BlockFile *p ) const {
@@ -245,6 +263,7 @@ class PROFILE_DLL_API BlockFile /* not final, abstract */ {
    size_t mLen;
    SummaryInfo mSummaryInfo;
    float mMin, mMax, mRMS;
+   unsigned long long mContentHash{ 0 };
    mutable bool mSilentLog;
 };
 
@@ -30,10 +30,12 @@
 #include "Audacity.h"
 #include "CellularPanel.h"
 
+#include <wx/dc.h>
 #include <wx/eventfilter.h>
 #include <wx/setup.h> // for wxUSE_* macros
 #include "KeyboardCapture.h"
 #include "UIHandle.h"
+#include "TrackPanelDrawingContext.h"
 #include "TrackPanelMouseEvent.h"
 #include "HitTestResult.h"
 #include "RefreshCode.h"
@@ -88,8 +90,15 @@ struct CellularPanel::State
    int mMouseMostRecentY;
    
    std::weak_ptr<TrackPanelCell> mpClickedCell;
-   
+
    bool mEnableTab{};
+
+   // Flat summary of the subdivision into cells, rebuilt by FindCell when
+   // invalid, and the index of the last cell found there -- consecutive
+   // mouse events usually stay within one cell
+   std::vector<CellularPanel::FoundCell> mCellLayout;
+   size_t mLastFoundCell{ 0 };
+   bool mCellLayoutValid{ false };
 };
 
 
@@ -989,6 +998,28 @@ namespace {
 
       return result;
    };
+
+   // Recursively flatten the subdivision into a table of leaf cells and
+   // their rectangles, computed just as Visit computes them
+   void CollectCells( const wxRect &rect,
+      const std::shared_ptr<TrackPanelNode> &node,
+      std::vector<CellularPanel::FoundCell> &table )
+   {
+      if (auto pCell = std::dynamic_pointer_cast<TrackPanelCell>(node))
+         table.push_back( { pCell, rect } );
+      else if (auto pGroup = dynamic_cast<TrackPanelGroup*>(node.get())) {
+         const auto results = pGroup->Children( rect );
+         const bool divideX = results.first == TrackPanelGroup::Axis::X;
+         const auto &children = results.second;
+         const auto begin = children.begin(), end = children.end();
+         for (auto iter = begin; iter != end; ++iter)
+            CollectCells(
+               Subdivide(rect, divideX, children, iter), iter->second,
+               table );
+      }
+      // else: nulls in the array of children are allowed, to define a void
+      // with no cell
+   }
 }
 
 // Private, recursive implementation function of Visit
@@ -1018,43 +1049,43 @@ void CellularPanel::Visit(
 
 auto CellularPanel::FindCell(int mouseX, int mouseY) -> FoundCell
 {
-   auto rect = this->GetClientRect();
-   auto node = Root();
-   while (node) {
-      if ( auto pCell = std::dynamic_pointer_cast< TrackPanelCell >( node ) )
-         // Found the bottom of the hierarchy
-         return { pCell, rect };
-      else if ( auto pGroup = dynamic_cast< TrackPanelGroup* >( node.get() ) ) {
-         // Ask node for its subdivision
-         const auto results = pGroup->Children( rect );
-         const bool divideX = results.first == TrackPanelGroup::Axis::X;
-         const auto &children = results.second;
+   auto &state = *mState;
+   if ( !state.mCellLayoutValid ) {
+      // Walk the subdivision once and flatten it, so that the many
+      // searches that follow before it changes again are no more than
+      // rectangle tests
+      state.mCellLayout.clear();
+      CollectCells( GetClientRect(), Root(), state.mCellLayout );
+      state.mLastFoundCell = 0;
+      state.mCellLayoutValid = true;
+   }
 
-         // Find the correct child
-         const auto begin = children.begin(), end = children.end();
-         auto iter = std::upper_bound( begin, end,
-            (divideX ? mouseX : mouseY),
-            [&]( wxCoord coord, const TrackPanelGroup::Child &child ) {
-               return coord < child.first;
-            }
-         );
-         if (iter == begin)
-            break;
-         --iter;
-
-         // Descend the hierarchy of nodes
-         rect = Subdivide(rect, divideX, children, iter);
-         node = iter->second;
+   // Try first the cell found last time, then the rest in order; the
+   // rectangles are disjoint, so any hit is the only hit
+   const auto &table = state.mCellLayout;
+   const auto size = table.size();
+   for ( size_t ii = 0, jj = state.mLastFoundCell; ii < size;
+         ++ii, jj = ( jj + 1 == size ? 0 : jj + 1 ) ) {
+      if ( table[jj].rect.Contains( mouseX, mouseY ) ) {
+         state.mLastFoundCell = jj;
+         return table[jj];
       }
-      else
-         // Nulls in the array of children are allowed, to define a void with
-         // no cell
-         break;
    }
 
    return { {}, {} };
 }
 
+void CellularPanel::InvalidateCellLayout()
+{
+   mState->mCellLayoutValid = false;
+}
+
+void CellularPanel::Refresh(bool eraseBackground, const wxRect *rect)
+{
+   InvalidateCellLayout();
+   OverlayPanel::Refresh(eraseBackground, rect);
+}
+
 wxRect CellularPanel::FindRect( const TrackPanelCell &cell )
 {
    wxRect result;
@@ -1119,6 +1150,17 @@ std::shared_ptr<TrackPanelCell> CellularPanel::LastCell() const
 void CellularPanel::Draw( TrackPanelDrawingContext &context, unsigned nPasses )
 {
    const auto panelRect = GetClientRect();
+
+   // If a clipping region is set on the DC, it delimits the damage under
+   // repair; nodes wholly outside it would draw nothing visible, so skip
+   // their (possibly expensive) Draw calls entirely
+   wxRect cullRect;
+   context.dc.GetClippingBox( cullRect );
+   if ( cullRect.IsEmpty() )
+      cullRect = panelRect;
+   else
+      cullRect.Intersect( panelRect );
+
    auto lastCell = LastCell();
    for ( unsigned iPass = 0; iPass < nPasses; ++iPass ) {
 
@@ -1126,7 +1168,7 @@ void CellularPanel::Draw( TrackPanelDrawingContext &context, unsigned nPasses )
 
          // Draw the node
          const auto newRect = node.DrawingArea( rect, panelRect, iPass );
-         if ( newRect.Intersects( panelRect ) )
+         if ( newRect.Intersects( cullRect ) )
             node.Draw( context, newRect, iPass );
 
          // Draw the current handle if it is associated with the node
@@ -1135,7 +1177,7 @@ void CellularPanel::Draw( TrackPanelDrawingContext &context, unsigned nPasses )
             if ( target ) {
                const auto targetRect =
                   target->DrawingArea( rect, panelRect, iPass );
-               if ( targetRect.Intersects( panelRect ) )
+               if ( targetRect.Intersects( cullRect ) )
                   target->Draw( context, targetRect, iPass );
             }
          }
@@ -88,6 +88,18 @@ public:
 
    FoundCell FindCell(int mouseX, int mouseY);
 
+   // Forget the flat table of cell rectangles that FindCell consults, so
+   // that it is recomputed from the subdivision at the next search.  Call
+   // this whenever the subdivision may have changed.  Mouse movements are
+   // far more frequent than such changes, so searching the cached table
+   // beats re-walking the tree of groups on every event.
+   void InvalidateCellLayout();
+
+   // A refresh of the panel usually follows some change of its contents,
+   // which may have included a change of its subdivision into cells
+   void Refresh(bool eraseBackground = true,
+                const wxRect *rect = (const wxRect *) NULL) override;
+
    // Search the tree of subdivisions of the panel area for the given cell.
    // If more than one sub-area is associated with the same cell object, it
    // is not specified which rectangle is returned.
@@ -14,9 +14,12 @@
 
 #include "wxFileNameWrapper.h"
 #include "AudacityLogger.h"
+#include "AudioIO.h"
 #include "AudioIOBase.h"
+#include "Diags.h"
 #include "FileNames.h"
 #include "Internat.h"
+#include "ondemand/ODManager.h"
 #include "prefs/GUIPrefs.h"
 #include "widgets/ErrorDialog.h"
 
@@ -50,6 +53,43 @@ void Generate(wxDebugReport::Context ctx)
    {
       rpt.AddText(wxT("log.txt"), logger->GetLog(), _TS("Audacity Log"));
    }
+
+   // What the machine was doing when it went down: stream health, any
+   // pending on-demand work, and the Diags counters with their ring of
+   // recent timed spans.  Deadline-miss crashes are unreadable without
+   // this context.
+   {
+      wxString perf;
+
+      auto pAudioIO = AudioIO::Get();
+      if (pAudioIO)
+      {
+         const auto telemetry = pAudioIO->GetTelemetry();
+         perf << wxString::Format(
+            wxT("Stream: duration_s=%.1f latency_ms=%.1f xruns=%u ")
+            wxT("playback_low_water=%lld fill_deadline_misses=%u ")
+            wxT("max_fill_ms=%.1f worst_fill_io_ms=%.1f\n\n"),
+            telemetry.streamSeconds,
+            telemetry.latencyMs,
+            telemetry.xruns,
+            telemetry.playbackLowWaterFrames,
+            telemetry.fillDeadlineMisses,
+            telemetry.maxFillMs,
+            telemetry.worstFillTrackIoMs);
+      }
+
+      if (ODManager::IsInstanceCreated())
+      {
+         perf << wxString::Format(
+            wxT("On-demand tasks: %d, %.0f%% complete overall\n\n"),
+            ODManager::Instance()->GetTotalNumTasks(),
+            ODManager::Instance()->GetOverallPercentComplete() * 100.0);
+      }
+
+      perf << Diags::Dump();
+
+      rpt.AddText(wxT("perf.txt"), perf, wxT("Performance Snapshot"));
+   }
    
    bool ok = wxDebugReportPreviewStd().Show(rpt);
    
@@ -112,6 +112,14 @@ void FindDependencies(AudacityProject *project,
    const auto &settings = ProjectSettings::Get( *project );
    sampleFormat format = settings.GetDefaultFormat();
 
+   // DirManager maintains the set of aliased files incrementally; when
+   // it is empty, no sequence can reference an external file, and the
+   // walk over every block of every clip below is saved.  (A nonempty
+   // set may still mean only the undo history aliases anything, so the
+   // exact per-track scan must follow.)
+   if (DirManager::Get( *project ).GetAliasedFiles().empty())
+      return;
+
    BlockPtrArray blocks;
    GetAllSeqBlocks(project, &blocks);
 
@@ -602,6 +610,24 @@ bool ShowDependencyDialogIfNeeded(AudacityProject *project,
                                   bool isSaving)
 {
    auto pWindow = FindProjectFrame( project );
+
+#ifdef EXPERIMENTAL_OD_DATA
+   wxString action;
+   if (isSaving)
+   {
+      // Read the choice before looking for dependencies: a user who
+      // keeps source media external and never copies it in should not
+      // pay for a scan of every block on every save
+      action =
+         gPrefs->Read(
+            wxT("/FileFormats/SaveProjectWithDependencies"),
+            wxT("ask"));
+      if (action == wxT("never"))
+         // User never wants to remove dependencies
+         return true;
+   }
+#endif
+
    AliasedFileArray aliasedFiles;
    FindDependencies(project, aliasedFiles);
 
@@ -631,20 +657,13 @@ New projects will be self-contained and are less risky.");
    if (isSaving)
    {
 #ifdef EXPERIMENTAL_OD_DATA
-      wxString action =
-         gPrefs->Read(
-            wxT("/FileFormats/SaveProjectWithDependencies"),
-            wxT("ask"));
       if (action == wxT("copy"))
       {
          // User always wants to remove dependencies
          RemoveDependencies(project, aliasedFiles);
          return true;
       }
-      if (action == wxT("never"))
-         // User never wants to remove dependencies
-         return true;
-#else 
+#else
       RemoveDependencies(project, aliasedFiles);
       return true;
 #endif
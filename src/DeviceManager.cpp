@@ -24,6 +24,7 @@
 #endif
 
 #ifndef WX_PRECOMP
+#include <wx/app.h>
 #include <wx/choice.h>
 #include <wx/event.h>
 #include <wx/intl.h>
@@ -33,6 +34,7 @@
 #include <wx/tooltip.h>
 #endif
 
+#include "Prefs.h"
 #include "Project.h"
 
 #include "AudioIOBase.h"
@@ -306,7 +308,87 @@ void DeviceManager::Rescan()
    }
 
    m_inited = true;
+   mUsingCache = false;
    mRescanTime = std::chrono::steady_clock::now();
+
+   WriteCacheToPrefs();
+}
+
+//--------------- Device List Caching --------------------------
+
+namespace {
+
+const wxChar *CacheRoot = wxT("/DeviceCache/");
+
+void WriteCachedMaps(const wxString &group,
+                     const std::vector<DeviceSourceMap> &maps)
+{
+   gPrefs->Write(CacheRoot + group + wxT("Count"), (long) maps.size());
+   for (size_t i = 0; i < maps.size(); i++) {
+      wxString prefix = wxString::Format(wxT("%s%s%d/"),
+         CacheRoot, group, (int) i);
+      const DeviceSourceMap &map = maps[i];
+      gPrefs->Write(prefix + wxT("DeviceIndex"),  map.deviceIndex);
+      gPrefs->Write(prefix + wxT("SourceIndex"),  map.sourceIndex);
+      gPrefs->Write(prefix + wxT("HostIndex"),    map.hostIndex);
+      gPrefs->Write(prefix + wxT("TotalSources"), map.totalSources);
+      gPrefs->Write(prefix + wxT("NumChannels"),  map.numChannels);
+      gPrefs->Write(prefix + wxT("SourceString"), map.sourceString);
+      gPrefs->Write(prefix + wxT("DeviceString"), map.deviceString);
+      gPrefs->Write(prefix + wxT("HostString"),   map.hostString);
+   }
+}
+
+bool ReadCachedMaps(const wxString &group, std::vector<DeviceSourceMap> &maps)
+{
+   long count = 0;
+   if (!gPrefs->Read(CacheRoot + group + wxT("Count"), &count) || count <= 0)
+      return false;
+
+   for (long i = 0; i < count; i++) {
+      wxString prefix = wxString::Format(wxT("%s%s%d/"),
+         CacheRoot, group, (int) i);
+      DeviceSourceMap map;
+      long val;
+      if (!gPrefs->Read(prefix + wxT("DeviceIndex"), &val))
+         return false;
+      map.deviceIndex = val;
+      gPrefs->Read(prefix + wxT("SourceIndex"),  &val, -1L);
+      map.sourceIndex = val;
+      gPrefs->Read(prefix + wxT("HostIndex"),    &val, 0L);
+      map.hostIndex = val;
+      gPrefs->Read(prefix + wxT("TotalSources"), &val, 0L);
+      map.totalSources = val;
+      gPrefs->Read(prefix + wxT("NumChannels"),  &val, 0L);
+      map.numChannels = val;
+      gPrefs->Read(prefix + wxT("SourceString"), &map.sourceString, {});
+      gPrefs->Read(prefix + wxT("DeviceString"), &map.deviceString, {});
+      gPrefs->Read(prefix + wxT("HostString"),   &map.hostString, {});
+      maps.push_back(map);
+   }
+   return true;
+}
+
+}
+
+bool DeviceManager::ReadCacheFromPrefs()
+{
+   mInputDeviceSourceMaps.clear();
+   mOutputDeviceSourceMaps.clear();
+   if (ReadCachedMaps(wxT("Input"), mInputDeviceSourceMaps) &&
+       ReadCachedMaps(wxT("Output"), mOutputDeviceSourceMaps))
+      return true;
+
+   mInputDeviceSourceMaps.clear();
+   mOutputDeviceSourceMaps.clear();
+   return false;
+}
+
+void DeviceManager::WriteCacheToPrefs()
+{
+   WriteCachedMaps(wxT("Input"), mInputDeviceSourceMaps);
+   WriteCachedMaps(wxT("Output"), mOutputDeviceSourceMaps);
+   gPrefs->Flush();
 }
 
 
@@ -326,6 +408,7 @@ DeviceManager::DeviceManager()
 #endif
 {
    m_inited = false;
+   mUsingCache = false;
    mRescanTime = std::chrono::steady_clock::now();
 }
 
@@ -336,7 +419,22 @@ DeviceManager::~DeviceManager()
 
 void DeviceManager::Init()
 {
-    Rescan();
+   // Show the device list of the previous run at once, and defer the
+   // real scan -- which can stall for many seconds on a misbehaving
+   // driver -- until after the pending events, when the window is up.
+   // Rescan() tells the toolbars with EVT_RESCANNED_DEVICES when the
+   // live list replaces the cached one.
+   if (ReadCacheFromPrefs()) {
+      m_inited = true;
+      mUsingCache = true;
+      wxTheApp->CallAfter([this]{
+         // An explicit rescan may already have happened meanwhile
+         if (mUsingCache)
+            Rescan();
+      });
+   }
+   else
+      Rescan();
 
 #if defined(EXPERIMENTAL_DEVICE_CHANGE_HANDLER)
 #if defined(HAVE_DEVICE_CHANGE)
@@ -89,9 +89,18 @@ private:
    /// Called by GetInputDeviceMaps and GetOutputDeviceMaps when needed.
    void Init();
 
+   /// Reads the device list of the previous run from the preferences,
+   /// so that it can be shown while the real scan is deferred.
+   bool ReadCacheFromPrefs();
+   /// Saves the scanned device list to the preferences.
+   void WriteCacheToPrefs();
+
    DeviceSourceMap* GetDefaultDevice(int hostIndex, int isInput);
 
    bool m_inited;
+   // True while the maps still hold the previous run's list and the
+   // deferred first Rescan() has not yet replaced it
+   bool mUsingCache;
 
    std::vector<DeviceSourceMap> mInputDeviceSourceMaps;
    std::vector<DeviceSourceMap> mOutputDeviceSourceMaps;
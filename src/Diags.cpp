@@ -97,3 +97,280 @@ void diagnostics_do_perfmon_stop( t_diag_struct ** ppDiag ){
 void diag_sample_test(){
    DIAG("Flip counter");// Flip counter will show in log ten times, then just count.
 }
+
+// ----------------------------------------------------------------------------
+// Scoped hot-path profiling
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+
+#include <wx/font.h>
+#include <wx/frame.h>
+#include <wx/textctrl.h>
+#include <wx/timer.h>
+
+namespace {
+
+// Registries of every site and memory tag constructed so far;
+// construction happens once each, so the lock never matters in a hot
+// path
+std::mutex sSiteMutex;
+DiagSite *sSiteList;
+DiagMemTag *sMemTagList;
+
+// Ring of the most recent timed spans.  Writers only move the head
+// atomically; a reader racing a writer may see one torn entry, which is
+// acceptable in a diagnostic readout and keeps the hot path wait-free.
+enum : size_t { kDiagRingSize = 32 };
+struct DiagEvent {
+   const wchar_t *pName;
+   long long endUs;
+   long long durationUs;
+};
+DiagEvent sRing[ kDiagRingSize ];
+std::atomic<size_t> sRingHead{ 0 };
+
+// Steady-clock microseconds, common to all sites
+long long DiagClockUs()
+{
+   using namespace std::chrono;
+   return duration_cast<microseconds>(
+      steady_clock::now().time_since_epoch() ).count();
+}
+
+}
+
+DiagSite::DiagSite( const wchar_t *name )
+   : pName{ name }
+{
+   std::lock_guard<std::mutex> guard{ sSiteMutex };
+   pNext = sSiteList;
+   sSiteList = this;
+}
+
+void DiagSite::Record( long long microseconds )
+{
+   count.fetch_add( 1, std::memory_order_relaxed );
+   totalUs.fetch_add( microseconds, std::memory_order_relaxed );
+
+   auto least = leastUs.load( std::memory_order_relaxed );
+   while ( ( least < 0 || microseconds < least ) &&
+      !leastUs.compare_exchange_weak( least, microseconds,
+         std::memory_order_relaxed ) )
+      ;
+   auto most = mostUs.load( std::memory_order_relaxed );
+   while ( microseconds > most &&
+      !mostUs.compare_exchange_weak( most, microseconds,
+         std::memory_order_relaxed ) )
+      ;
+
+   size_t bucket = 0;
+   for ( auto us = microseconds;
+         us > 1 && bucket < kDiagHistogramBuckets - 1; us >>= 1 )
+      ++bucket;
+   histogram[ bucket ].fetch_add( 1, std::memory_order_relaxed );
+}
+
+void DiagSite::Count( long long amount )
+{
+   count.fetch_add( amount, std::memory_order_relaxed );
+}
+
+DiagMemTag::DiagMemTag( const wchar_t *name )
+   : pName{ name }
+{
+   std::lock_guard<std::mutex> guard{ sSiteMutex };
+   pNext = sMemTagList;
+   sMemTagList = this;
+}
+
+void DiagMemTag::Adjust( long long deltaBytes )
+{
+   const auto now =
+      bytes.fetch_add( deltaBytes, std::memory_order_relaxed ) + deltaBytes;
+   auto peak = peakBytes.load( std::memory_order_relaxed );
+   while ( now > peak &&
+      !peakBytes.compare_exchange_weak( peak, now,
+         std::memory_order_relaxed ) )
+      ;
+}
+
+DiagScope::DiagScope( DiagSite &site )
+   : mSite{ site }
+   , mStartUs{ DiagClockUs() }
+{
+}
+
+DiagScope::~DiagScope()
+{
+   const auto endUs = DiagClockUs();
+   const auto durationUs = endUs - mStartUs;
+   mSite.Record( durationUs );
+
+   const auto slot =
+      sRingHead.fetch_add( 1, std::memory_order_relaxed ) % kDiagRingSize;
+   sRing[ slot ] = { mSite.pName, endUs, durationUs };
+}
+
+wxString Diags::Dump()
+{
+   wxString result;
+   result += wxString::Format(
+      wxT("%-36s %10s %12s %10s %10s %10s\n"),
+      wxT("site"), wxT("count"), wxT("total ms"),
+      wxT("least ms"), wxT("mean ms"), wxT("most ms") );
+
+   {
+      std::lock_guard<std::mutex> guard{ sSiteMutex };
+      for ( auto pSite = sSiteList; pSite; pSite = pSite->pNext ) {
+         const auto count = pSite->count.load( std::memory_order_relaxed );
+         const auto totalUs =
+            pSite->totalUs.load( std::memory_order_relaxed );
+         const auto leastUs =
+            pSite->leastUs.load( std::memory_order_relaxed );
+         const auto mostUs = pSite->mostUs.load( std::memory_order_relaxed );
+
+         if ( leastUs < 0 ) {
+            // A pure counter, never timed
+            result += wxString::Format( wxT("%-36s %10lld\n"),
+               pSite->pName, (long long)count );
+            continue;
+         }
+
+         result += wxString::Format(
+            wxT("%-36s %10lld %12.3f %10.3f %10.3f %10.3f\n"),
+            pSite->pName, (long long)count, totalUs / 1000.0,
+            leastUs / 1000.0,
+            count ? totalUs / ( 1000.0 * count ) : 0.0,
+            mostUs / 1000.0 );
+
+         wxString buckets;
+         for ( size_t ii = 0; ii < kDiagHistogramBuckets; ++ii ) {
+            const auto n =
+               pSite->histogram[ ii ].load( std::memory_order_relaxed );
+            if ( n )
+               buckets += wxString::Format( wxT(" %lldus:%lld"),
+                  1LL << ii, (long long)n );
+         }
+         if ( !buckets.empty() )
+            result += wxT("   histogram") + buckets + wxT("\n");
+      }
+   }
+
+   {
+      std::lock_guard<std::mutex> guard{ sSiteMutex };
+      if ( sMemTagList ) {
+         result += wxString::Format( wxT("\n%-36s %12s %12s\n"),
+            wxT("memory"), wxT("now MB"), wxT("peak MB") );
+         for ( auto pTag = sMemTagList; pTag; pTag = pTag->pNext )
+            result += wxString::Format( wxT("%-36s %12.1f %12.1f\n"),
+               pTag->pName,
+               pTag->bytes.load( std::memory_order_relaxed )
+                  / ( 1024.0 * 1024.0 ),
+               pTag->peakBytes.load( std::memory_order_relaxed )
+                  / ( 1024.0 * 1024.0 ) );
+      }
+   }
+
+   result += wxT("\nrecent spans, newest first:\n");
+   const auto head = sRingHead.load( std::memory_order_relaxed );
+   const auto now = DiagClockUs();
+   const auto limit = std::min( head, (size_t)kDiagRingSize );
+   for ( size_t ii = 1; ii <= limit; ++ii ) {
+      const auto &event = sRing[ ( head - ii ) % kDiagRingSize ];
+      if ( !event.pName )
+         continue;
+      result += wxString::Format(
+         wxT("%8.3fs ago %-36s %10.3f ms\n"),
+         ( now - event.endUs ) / 1000000.0,
+         event.pName, event.durationUs / 1000.0 );
+   }
+
+   return result;
+}
+
+void Diags::Reset()
+{
+   std::lock_guard<std::mutex> guard{ sSiteMutex };
+   for ( auto pSite = sSiteList; pSite; pSite = pSite->pNext ) {
+      pSite->count.store( 0, std::memory_order_relaxed );
+      pSite->totalUs.store( 0, std::memory_order_relaxed );
+      pSite->leastUs.store( -1, std::memory_order_relaxed );
+      pSite->mostUs.store( 0, std::memory_order_relaxed );
+      for ( size_t ii = 0; ii < kDiagHistogramBuckets; ++ii )
+         pSite->histogram[ ii ].store( 0, std::memory_order_relaxed );
+   }
+   for ( auto &event : sRing )
+      event = {};
+   sRingHead.store( 0, std::memory_order_relaxed );
+
+   // Memory tallies track live allocations; only the peaks start over
+   for ( auto pTag = sMemTagList; pTag; pTag = pTag->pNext )
+      pTag->peakBytes.store(
+         pTag->bytes.load( std::memory_order_relaxed ),
+         std::memory_order_relaxed );
+}
+
+void Diags::VisitMemory( const std::function< void(
+   const wchar_t *tag, long long bytes, long long peakBytes ) > &visit )
+{
+   std::lock_guard<std::mutex> guard{ sSiteMutex };
+   for ( auto pTag = sMemTagList; pTag; pTag = pTag->pNext )
+      visit( pTag->pName,
+         pTag->bytes.load( std::memory_order_relaxed ),
+         pTag->peakBytes.load( std::memory_order_relaxed ) );
+}
+
+namespace {
+
+// The HUD: a modeless readout of Dump(), refreshed once a second
+class DiagsHUD final : public wxFrame
+{
+public:
+   explicit DiagsHUD( wxWindow *parent )
+      : wxFrame{ parent, wxID_ANY, _("Performance Monitor"),
+           wxDefaultPosition, wxSize{ 640, 480 } }
+      , mTimer{ this }
+   {
+      mText = safenew wxTextCtrl{ this, wxID_ANY, wxEmptyString,
+         wxDefaultPosition, wxDefaultSize,
+         wxTE_MULTILINE | wxTE_READONLY | wxTE_DONTWRAP };
+      mText->SetFont( wxFont{ wxFontInfo{}
+         .Family( wxFONTFAMILY_TELETYPE ) } );
+      mText->SetValue( Diags::Dump() );
+
+      Bind( wxEVT_TIMER, &DiagsHUD::OnTimer, this );
+      Bind( wxEVT_CLOSE_WINDOW, &DiagsHUD::OnClose, this );
+      mTimer.Start( 1000 );
+   }
+
+private:
+   void OnTimer( wxTimerEvent & )
+   {
+      mText->SetValue( Diags::Dump() );
+   }
+
+   void OnClose( wxCloseEvent & );
+
+   wxTextCtrl *mText;
+   wxTimer mTimer;
+};
+
+DiagsHUD *sHUD;
+
+void DiagsHUD::OnClose( wxCloseEvent & )
+{
+   sHUD = nullptr;
+   Destroy();
+}
+
+}
+
+void Diags::ShowHUD( wxWindow *parent )
+{
+   if ( !sHUD )
+      sHUD = safenew DiagsHUD{ parent };
+   sHUD->Show();
+   sHUD->Raise();
+}
@@ -78,6 +78,102 @@ extern void diagnostics_do_perfmon_stop( t_diag_struct ** ppDiag);
       diagnostics_do_perfmon_stop( &timername );\
 }
 
+// ----------------------------------------------------------------------------
+// Scoped hot-path profiling
+//
+// Where the macros above log the first few occurrences, these never log;
+// they accumulate statistics cheaply enough to leave in hot paths of
+// release builds, for finding where a stutter came from without
+// attaching an external profiler.  Sites update with relaxed atomics, so
+// they are safe in the audio threads and cost a few uncontended stores.
+// Read the whole picture with Diags::Dump(), or watch it live in the
+// Performance Monitor window of the Diagnostics menu.
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+
+class wxString;
+class wxWindow;
+
+// Power-of-two microsecond buckets; bucket n counts durations of
+// [2^n, 2^(n+1)) microseconds, the last bucket whatever is longer
+enum : size_t { kDiagHistogramBuckets = 20 };
+
+// One instrumented site: a named counter with duration statistics and a
+// histogram.  Sites register themselves on construction and are meant
+// to be function-local statics made by the macros below.
+struct DiagSite {
+   explicit DiagSite( const wchar_t *name );
+
+   void Record( long long microseconds );
+   void Count( long long amount );
+
+   const wchar_t * const pName;
+   std::atomic<long long> count{ 0 };
+   std::atomic<long long> totalUs{ 0 };
+   std::atomic<long long> leastUs{ -1 };
+   std::atomic<long long> mostUs{ 0 };
+   std::atomic<long long> histogram[ kDiagHistogramBuckets ]{};
+   DiagSite *pNext{};   // chains the registry of all sites
+};
+
+// Times the enclosing scope into a site, and notes the span in the ring
+// of recent events that Dump() reports
+class DiagScope {
+public:
+   explicit DiagScope( DiagSite &site );
+   ~DiagScope();
+
+   DiagScope( const DiagScope& ) = delete;
+   DiagScope &operator=( const DiagScope& ) = delete;
+private:
+   DiagSite &mSite;
+   long long mStartUs;
+};
+
+// One named byte tally, adjusted by a subsystem as it allocates and
+// frees, so the big consumers of a 20 GB session can be told apart.
+// Each subsystem defines one tag at file scope and calls Adjust with
+// positive and negative deltas; Dump() reports current and peak.
+struct DiagMemTag {
+   explicit DiagMemTag( const wchar_t *name );
+
+   void Adjust( long long deltaBytes );
+
+   const wchar_t * const pName;
+   std::atomic<long long> bytes{ 0 };
+   std::atomic<long long> peakBytes{ 0 };
+   DiagMemTag *pNext{};   // chains the registry of all tags
+};
 
+namespace Diags {
+   // The statistics of every site, the memory tallies, and the most
+   // recent timed spans, as a text table
+   wxString Dump();
+   // Start all statistics over; memory tallies keep their current
+   // figure but restart their peak from it
+   void Reset();
+   // Modeless window refreshing Dump() periodically
+   void ShowHUD( wxWindow *parent );
+   // Call back once per memory tag, for the scripting query
+   void VisitMemory( const std::function< void(
+      const wchar_t *tag, long long bytes, long long peakBytes ) > &visit );
+}
+
+// USAGE:
+// At most one of each per scope.
+//
+// Use DIAG_SCOPE to time a scope into a per-site histogram.
+// Use DIAG_COUNT to count events, such as cache misses.
+
+#define DIAG_SCOPE( message ) \
+   static DiagSite diagScopeSite{ wxT(message) }; \
+   DiagScope diagScopeTimer{ diagScopeSite };
+
+#define DIAG_COUNT( message, amount ) { \
+   static DiagSite diagCountSite{ wxT(message) }; \
+   diagCountSite.Count( amount ); \
+}
 
 #endif
@@ -66,6 +66,9 @@
 
 #include <time.h> // to use time() for srand()
 
+#include <atomic>
+#include <thread>
+
 #include <wx/wxcrtvararg.h>
 #include <wx/defs.h>
 #include <wx/dir.h>
@@ -86,7 +89,12 @@
 #endif
 
 #include "BlockFile.h"
+#include "FileCopyPool.h"
 #include "FileNames.h"
+#include "blockfile/BlockReclaimQueue.h"
+#include "blockfile/BlockWriteQueue.h"
+#include "effects/TrackIOQueue.h"
+#include "blockfile/MappedBlockPool.h"
 #include "InconsistencyException.h"
 #include "Prefs.h"
 #include "Project.h"
@@ -394,6 +402,10 @@ DirManager::DirManager()
 
    mLastBlockFileDestructionCount = BlockFile::gBlockFileDestructionCount;
 
+   // Before this session assigns any block file names, remove files a
+   // crashed session had doomed but not yet deleted
+   BlockReclaimQueue::Get().ReplayLeftoverJournal();
+
    // Seed the random number generator.
    // this need not be strictly uniform or random, but it should give
    // unclustered numbers
@@ -439,6 +451,9 @@ DirManager::DirManager()
 
 DirManager::~DirManager()
 {
+   // Join the name-probing worker before anything is torn down
+   mReserveWorker.reset();
+
    auto start = sDirManagers.begin(), finish = sDirManagers.end(),
       iter = std::remove_if( start, finish,
          [=]( const std::weak_ptr<DirManager> &ptr ){
@@ -448,6 +463,9 @@ DirManager::~DirManager()
 
    numDirManagers--;
    if (numDirManagers == 0) {
+      // Let deferred deletions finish so the temp cleanup below can
+      // remove the emptied directories
+      BlockReclaimQueue::Get().Drain();
       CleanTempDir();
       //::wxRmdir(temp);
    } else if( projFull.empty() && !mytemp.empty()) {
@@ -615,6 +633,14 @@ DirManager::ProjectSetter::Impl::Impl(
 : dirManager{ dm }
 , moving{ moving_ }
 {
+   // Whole files are about to be copied or moved; any queued block
+   // writes and deferred deletions must land first
+   BlockWriteQueue::Get().Drain();
+
+   // Reserved block file names embed the old project directory
+   dirManager.ResetNameReservoir();
+   BlockReclaimQueue::Get().Drain();
+
    // Choose new paths
    if (newProjPath.empty())
       newProjPath = ::wxGetCwd();
@@ -692,6 +718,7 @@ DirManager::ProjectSetter::Impl::Impl(
 
       int total = dirManager.mBlockFileHash.size();
 
+      FileCopyPool copyPool;
       bool link = moving;
       for (const auto &pair : dirManager.mBlockFileHash) {
          if( progress.Update(newPaths.size(), total) != ProgressResult::Success )
@@ -700,7 +727,8 @@ DirManager::ProjectSetter::Impl::Impl(
          FilePath newPath;
          if (auto b = pair.second.lock()) {
             auto result =
-               dirManager.LinkOrCopyToNewProjectDirectory( &*b, link );
+               dirManager.LinkOrCopyToNewProjectDirectory(
+                  &*b, link, &copyPool );
             if (!result.first)
                return;
             newPath = result.second;
@@ -708,6 +736,15 @@ DirManager::ProjectSetter::Impl::Impl(
          }
          newPaths.push_back( newPath );
       }
+
+      // The loop above was quick: hard links, or copies merely queued.
+      // Now run the copies on several threads, so the target disk sees
+      // many large requests in flight instead of one at a time.
+      if (!copyPool.Run( [&]( size_t done, size_t copyTotal ){
+            return progress.Update(done, copyTotal) ==
+               ProgressResult::Success;
+         } ))
+         return;
    }
 
    ok = true;
@@ -752,11 +789,18 @@ void DirManager::ProjectSetter::Impl::Commit()
          if (moving || !b->IsLocked()) {
             auto result = b->GetFileName();
             auto oldPath = result.name.GetFullPath();
-            if (!oldPath.empty())
+            if (!oldPath.empty()) {
+               MappedBlockPool::Get().Forget( oldPath );
                wxRemoveFile( oldPath );
+            }
          }
 
-         if (ii < size)
+         // A block shared by reference from another open project must
+         // keep reading that project's file; the copy just made under
+         // the same name satisfies the project file being written, and
+         // repointing the shared object would disturb the other project
+         if (ii < size &&
+             dirManager.mForeignBlockFiles.count( pair.first ) == 0)
             b->SetFileName(
                wxFileNameWrapper{ wxFileName{ newPaths[ii] } } );
       }
@@ -764,6 +808,10 @@ void DirManager::ProjectSetter::Impl::Commit()
       ++ii;
    }
 
+   // The NEW directory now holds its own copies of any blocks that were
+   // shared from other projects
+   dirManager.mForeignBlockFiles.clear();
+
    // Some subtlety; SetProject is used both to move a temp project
    // into a permanent home as well as just set up path variables when
    // loading a project; in this latter case, the movement code does
@@ -998,7 +1046,7 @@ auto DirManager::GetBalanceInfo() -> BalanceInfo &
    // see whether any block files have disappeared,
    // and if so update
 
-   auto count = BlockFile::gBlockFileDestructionCount;
+   unsigned long count = BlockFile::gBlockFileDestructionCount;
    if ( mLastBlockFileDestructionCount != count ) {
       auto it = mBlockFileHash.begin(), end = mBlockFileHash.end();
       while (it != end)
@@ -1008,6 +1056,7 @@ auto DirManager::GetBalanceInfo() -> BalanceInfo &
             auto name = it->first;
             mBlockFileHash.erase( it++ );
             BalanceInfoDel( name );
+            AliasInfoDel( name );
          }
          else
             ++it;
@@ -1089,9 +1138,112 @@ void DirManager::BalanceInfoDel(const wxString &file)
    }
 }
 
+// Record one registered block file in the aliased-file set.  Callers
+// hold mCreationLock, or register on the main thread during a load.
+void DirManager::AliasInfoAdd(const wxString &key, const BlockFile &b)
+{
+   if (!b.IsAlias())
+      return;
+
+   const auto path =
+      static_cast<const AliasBlockFile&>(b).GetAliasedFileName().GetFullPath();
+   // Empty can happen if user already chose to "replace... with silence"
+   if (path.empty())
+      return;
+
+   // Re-registration of the same name must not count twice
+   AliasInfoDel(key);
+
+   mAliasBlockPaths[key] = path;
+   ++mAliasedFiles[path];
+}
+
+void DirManager::AliasInfoDel(const wxString &key)
+{
+   auto it = mAliasBlockPaths.find(key);
+   if (it == mAliasBlockPaths.end())
+      return;
+
+   auto count = mAliasedFiles.find(it->second);
+   if (count != mAliasedFiles.end() && --count->second <= 0)
+      mAliasedFiles.erase(count);
+   mAliasBlockPaths.erase(it);
+}
+
+std::unordered_map<wxString, int> DirManager::GetAliasedFiles()
+{
+   wxCriticalSectionLocker locker{ mCreationLock };
+
+   // First sweep out block files that expired since the last look
+   GetBalanceInfo();
+
+   return mAliasedFiles;
+}
+
+// The number of block file names the background worker probes per batch,
+// and the reservoir level below which another batch is scheduled
+enum : size_t {
+   kNameReservoirBatch = 64,
+   kNameReservoirLow = 16,
+};
+
+wxFileNameWrapper DirManager::MakeBlockFileName()
+{
+   // Prefer a name reserved ahead of time, already verified against the
+   // disk by the worker, so that steady recording rarely opens and scans
+   // a directory on the path that feeds the capture drain
+   if (!mReservedNames.empty()) {
+      auto ret = std::move( mReservedNames.back() );
+      mReservedNames.pop_back();
+      mReservedNameSet.erase( ret.GetName() );
+      ScheduleNameReservation();
+      return ret;
+   }
+
+   // Reservoir empty -- first use, or the worker fell behind -- so probe
+   // now, and prime the reservoir for the names that will follow
+   auto ret = ProbeBlockFileName();
+   ScheduleNameReservation();
+   return ret;
+}
+
+void DirManager::ScheduleNameReservation()
+{
+   // Caller holds mCreationLock
+   if (mReservingNames || mReservedNames.size() >= kNameReservoirLow)
+      return;
+   mReservingNames = true;
+   if (!mReserveWorker)
+      mReserveWorker = std::make_unique<TrackIOQueue>();
+   mReserveWorker->Post( [this]{
+      // Take the lock once per name, so creations on other threads are
+      // never held up for more than a single probe
+      for (size_t ii = 0; ii < kNameReservoirBatch; ++ii) {
+         wxCriticalSectionLocker locker{ mCreationLock };
+         auto name = ProbeBlockFileName();
+         mReservedNameSet.insert( name.GetName() );
+         mReservedNames.push_back( std::move( name ) );
+      }
+      wxCriticalSectionLocker locker{ mCreationLock };
+      mReservingNames = false;
+   } );
+}
+
+void DirManager::ResetNameReservoir()
+{
+   // Wait out any probing in flight, then forget the reserved names:
+   // they embed a project directory that is about to change
+   if (mReserveWorker)
+      mReserveWorker->Finish();
+   wxCriticalSectionLocker locker{ mCreationLock };
+   mReservedNames.clear();
+   mReservedNameSet.clear();
+   mReservingNames = false;
+}
+
 // only determines appropriate filename and subdir balance; does not
 // perform maintainence
-wxFileNameWrapper DirManager::MakeBlockFileName()
+wxFileNameWrapper DirManager::ProbeBlockFileName()
 {
    auto &balanceInfo = GetBalanceInfo();
    auto &dirMidPool = balanceInfo.dirMidPool;
@@ -1185,7 +1337,8 @@ wxFileNameWrapper DirManager::MakeBlockFileName()
 
       baseFileName.Printf(wxT("e%02x%02x%03x"),topnum,midnum,filenum);
 
-      if (!ContainsBlockFile(baseFileName)) {
+      if (!ContainsBlockFile(baseFileName) &&
+          !mReservedNameSet.count(baseFileName)) {
          // not in the hash, good.
          if (!this->AssignFile(ret, baseFileName, true))
          {
@@ -1209,10 +1362,15 @@ wxFileNameWrapper DirManager::MakeBlockFileName()
 
 BlockFilePtr DirManager::NewBlockFile( const BlockFileFactory &factory )
 {
+   // Effects may store to several tracks concurrently, and all block file
+   // creation funnels through here or CopyBlockFile
+   wxCriticalSectionLocker locker{ mCreationLock };
+
    wxFileNameWrapper filePath{ MakeBlockFileName() };
    const wxString fileName{ filePath.GetName() };
    auto newBlockFile = factory( std::move(filePath) );
    mBlockFileHash[fileName] = newBlockFile;
+   AliasInfoAdd(fileName, *newBlockFile);
    auto &aliasName = newBlockFile->GetExternalFileName();
    if ( aliasName.IsOk() )
       //OD TODO: check to see if we need to remove this when done decoding.
@@ -1221,6 +1379,38 @@ BlockFilePtr DirManager::NewBlockFile( const BlockFileFactory &factory )
    return newBlockFile;
 }
 
+BlockFilePtr DirManager::FindIdenticalBlockFile(
+   unsigned long long contentHash, size_t len)
+{
+   if (contentHash == 0)
+      return {};
+
+   wxCriticalSectionLocker locker{ mCreationLock };
+
+   auto range = mContentHashes.equal_range(contentHash);
+   for (auto iter = range.first; iter != range.second;) {
+      auto b = iter->second.lock();
+      if (!b) {
+         // Tidy expired entries as they are encountered
+         iter = mContentHashes.erase(iter);
+         continue;
+      }
+      if (b->GetLength() == len && b->GetContentHash() == contentHash)
+         return b;
+      ++iter;
+   }
+   return {};
+}
+
+void DirManager::RegisterContentHash(
+   unsigned long long contentHash, const BlockFilePtr &file)
+{
+   if (contentHash != 0 && file) {
+      wxCriticalSectionLocker locker{ mCreationLock };
+      mContentHashes.insert({ contentHash, file });
+   }
+}
+
 bool DirManager::ContainsBlockFile(const BlockFile *b) const
 {
    if (!b)
@@ -1250,6 +1440,8 @@ BlockFilePtr DirManager::CopyBlockFile(const BlockFilePtr &b)
    if (!b)
       THROW_INCONSISTENCY_EXCEPTION;
 
+   wxCriticalSectionLocker locker{ mCreationLock };
+
    auto result = b->GetFileName();
    const auto &fn = result.name;
 
@@ -1259,11 +1451,40 @@ BlockFilePtr DirManager::CopyBlockFile(const BlockFilePtr &b)
       //but it's something to watch out for.
       //
       // LLL: Except for silent block files which have uninitialized filename.
-      if (fn.IsOk())
+      if (fn.IsOk()) {
          mBlockFileHash[fn.GetName()] = b;
+         AliasInfoAdd(fn.GetName(), *b);
+      }
       return b;
    }
 
+   // A locked block is owned by a saved project file, but that is no bar
+   // to sharing it within the same project:  blocks are never written in
+   // place (see Sequence::SetSamples), and the lock already keeps the
+   // disk file alive when the last reference goes away.  Blocks of
+   // another project can usually be shared too, and copied only at
+   // save time.  Effects duplicating long saved selections
+   // thus start at once, and use disk only for audio they modify.
+   if (fn.IsOk()) {
+      auto it = mBlockFileHash.find(fn.GetName());
+      if (it != mBlockFileHash.end() && it->second.lock() == b)
+         return b;
+
+      // A locked block of another open project.  Its file is kept on
+      // disk by that project's save, and blocks are never written in
+      // place, so the reference can be shared now -- pasting an hour of
+      // audio copies nothing -- and the data copied only when this
+      // project is saved (MaterializeForeignBlocks).  A name collision
+      // with a different block of this project forces the physical copy
+      // below.
+      if (it == mBlockFileHash.end() || it->second.expired()) {
+         mBlockFileHash[fn.GetName()] = b;
+         AliasInfoAdd(fn.GetName(), *b);
+         mForeignBlockFiles[fn.GetName()] = b;
+         return b;
+      }
+   }
+
    // Copy the blockfile
    BlockFilePtr b2;
    if (!fn.IsOk())
@@ -1284,6 +1505,9 @@ BlockFilePtr DirManager::CopyBlockFile(const BlockFilePtr &b)
       //a summary file, so we should check before we copy.
       if(b->IsSummaryAvailable())
       {
+         // The source file must exist; wait out any queued write of it
+         BlockWriteQueue::Get().Finish(fn.GetFullPath(), false);
+
          if( !FileNames::CopyFile(fn.GetFullPath(),
                   newFile.GetFullPath()) )
             // Disk space exhaustion, maybe
@@ -1297,6 +1521,7 @@ BlockFilePtr DirManager::CopyBlockFile(const BlockFilePtr &b)
       b2 = b->Copy(std::move(newFile));
 
       mBlockFileHash[newName] = b2;
+      AliasInfoAdd(newName, *b2);
       aliasList.push_back(newPath);
    }
 
@@ -1306,6 +1531,46 @@ BlockFilePtr DirManager::CopyBlockFile(const BlockFilePtr &b)
    return b2;
 }
 
+void DirManager::MaterializeForeignBlocks()
+{
+   wxCriticalSectionLocker locker{ mCreationLock };
+
+   for (auto it = mForeignBlockFiles.begin();
+        it != mForeignBlockFiles.end();
+        it = mForeignBlockFiles.erase(it)) {
+      auto b = it->second.lock();
+      if (!b)
+         // All references went away; nothing to own
+         continue;
+
+      auto result = b->GetFileName();
+      const auto &fn = result.name;
+      if (!fn.IsOk())
+         continue;
+
+      // The path a block of this name belongs at; the project file
+      // writes names only, and the loader will look just here
+      wxFileNameWrapper ourName;
+      if (!AssignFile(ourName, fn.GetFullName(), false))
+         throw FileException{ FileException::Cause::Write, ourName };
+
+      if (ourName == fn)
+         // Already a file of this project after all
+         continue;
+
+      // The source file must exist; wait out any queued write of it
+      BlockWriteQueue::Get().Finish(fn.GetFullPath(), false);
+
+      if (!FileNames::CopyFile(fn.GetFullPath(), ourName.GetFullPath()))
+         // Disk space exhaustion, maybe
+         throw FileException{ FileException::Cause::Write, ourName };
+
+      // The in-memory block object, still shared with the other
+      // project, keeps reading its original file; only the saved
+      // project needs the copy
+   }
+}
+
 namespace {
 
 using Deserializers =
@@ -1383,6 +1648,7 @@ bool DirManager::HandleXMLTag(const wxChar *tag, const wxChar **attrs)
 
    // This is a NEW object
    wRetrieved = target;
+   AliasInfoAdd(name, *target);
    // MakeBlockFileName wasn't used so we must add the directory
    // balancing information
    BalanceInfoAdd(name);
@@ -1391,7 +1657,7 @@ bool DirManager::HandleXMLTag(const wxChar *tag, const wxChar **attrs)
 }
 
 std::pair<bool, FilePath> DirManager::LinkOrCopyToNewProjectDirectory(
-   BlockFile *f, bool &link )
+   BlockFile *f, bool &link, FileCopyPool *copyPool )
 {
    FilePath newPath;
    auto result = f->GetFileName();
@@ -1422,9 +1688,17 @@ std::pair<bool, FilePath> DirManager::LinkOrCopyToNewProjectDirectory(
          bool success = false;
          if (link)
             success = FileNames::HardLinkFile( oldPath, newPath );
-         if (!success)
-             link = false,
-             success = FileNames::CopyFile( oldPath, newPath );
+         if (!success) {
+            link = false;
+            if (copyPool) {
+               // Queue the copy; the caller runs the pool and learns of
+               // failures there
+               copyPool->Add( oldPath, newPath );
+               success = true;
+            }
+            else
+               success = FileNames::CopyFile( oldPath, newPath );
+         }
          if (!success)
             return { false, {} };
       }
@@ -1586,10 +1860,57 @@ bool DirManager::EnsureSafeFilename(const wxFileName &fName)
    return true;
 }
 
+namespace {
+
+// Applies the test to each index on concurrent workers and collects the
+// results.  The project check stats one file per block, and on a large
+// project those waits dominate the open; overlapping them hides most of
+// the latency, so use more workers than cores.  The test must touch no
+// shared state; the caller examines the results, and logs, serially.
+std::vector<unsigned char> RunFileChecks(
+   size_t count, const std::function< bool(size_t) > &test)
+{
+   std::vector<unsigned char> results( count );
+
+   const auto nWorkers = std::min<size_t>( count,
+      4 * std::max( 1u, std::thread::hardware_concurrency() ) );
+   if (nWorkers <= 1) {
+      for (size_t ii = 0; ii < count; ii++)
+         results[ii] = test( ii );
+      return results;
+   }
+
+   std::atomic<size_t> next{ 0 };
+   auto work = [&]{
+      for (;;) {
+         auto index = next++;
+         if (index >= count)
+            break;
+         results[index] = test( index );
+      }
+   };
+
+   std::vector<std::thread> workers;
+   workers.reserve(nWorkers);
+   for (size_t ii = 0; ii < nWorkers; ii++)
+      workers.emplace_back(work);
+   for (auto &worker : workers)
+      worker.join();
+
+   return results;
+}
+
+}
+
 void DirManager::FindMissingAliasFiles(
       BlockHash& missingAliasFilesAUFHash,     // output: (.auf) AliasBlockFiles whose aliased files are missing
       BlockHash& missingAliasFilesPathHash)    // output: full paths of missing aliased files
 {
+   // Gather the aliased file names first, then test for their existence
+   // on concurrent workers
+   std::vector<wxString> keys;
+   std::vector<BlockFilePtr> blocks;
+   std::vector<wxString> paths;
    BlockHash::iterator iter = mBlockFileHash.begin();
    while (iter != mBlockFileHash.end())
    {
@@ -1602,21 +1923,33 @@ void DirManager::FindMissingAliasFiles(
             static_cast< AliasBlockFile* > ( &*b )->GetAliasedFileName();
             wxString aliasedFileFullPath = aliasedFileName.GetFullPath();
             // wxEmptyString can happen if user already chose to "replace... with silence".
-            if ((!aliasedFileFullPath.empty()) &&
-                !aliasedFileName.FileExists())
+            if (!aliasedFileFullPath.empty())
             {
-               missingAliasFilesAUFHash[key] = b;
-               if (missingAliasFilesPathHash.find(aliasedFileFullPath) ==
-                   missingAliasFilesPathHash.end()) // Add it only once.
-                  // Not actually using the block here, just the path,
-                  // so set the block to NULL to create the entry.
-                  missingAliasFilesPathHash[aliasedFileFullPath] = {};
+               keys.push_back(key);
+               blocks.push_back(b);
+               paths.push_back(aliasedFileFullPath);
             }
          }
       }
       ++iter;
    }
 
+   auto missing = RunFileChecks( paths.size(),
+      [&]( size_t ii ){ return !wxFileName::FileExists( paths[ii] ); } );
+
+   for (size_t ii = 0; ii < paths.size(); ii++)
+   {
+      if (missing[ii])
+      {
+         missingAliasFilesAUFHash[keys[ii]] = blocks[ii];
+         if (missingAliasFilesPathHash.find(paths[ii]) ==
+             missingAliasFilesPathHash.end()) // Add it only once.
+            // Not actually using the block here, just the path,
+            // so set the block to NULL to create the entry.
+            missingAliasFilesPathHash[paths[ii]] = {};
+      }
+   }
+
    iter = missingAliasFilesPathHash.begin();
    while (iter != missingAliasFilesPathHash.end())
    {
@@ -1628,6 +1961,12 @@ void DirManager::FindMissingAliasFiles(
 void DirManager::FindMissingAUFs(
       BlockHash& missingAUFHash)                // output: missing (.auf) AliasBlockFiles
 {
+   // Compute the expected file names first (MakeBlockFilePath may make
+   // directories, so it stays on this thread), then test for their
+   // existence on concurrent workers
+   std::vector<wxString> keys;
+   std::vector<BlockFilePtr> blocks;
+   std::vector<wxString> paths;
    BlockHash::iterator iter = mBlockFileHash.begin();
    while (iter != mBlockFileHash.end())
    {
@@ -1641,21 +1980,35 @@ void DirManager::FindMissingAUFs(
             wxFileNameWrapper fileName{ MakeBlockFilePath(key) };
             fileName.SetName(key);
             fileName.SetExt(wxT("auf"));
-            if (!fileName.FileExists())
-            {
-               missingAUFHash[key] = b;
-               wxLogWarning(_("Missing alias (.auf) block file: '%s'"),
-                            fileName.GetFullPath());
-            }
+            keys.push_back(key);
+            blocks.push_back(b);
+            paths.push_back(fileName.GetFullPath());
          }
       }
       ++iter;
    }
+
+   auto missing = RunFileChecks( paths.size(),
+      [&]( size_t ii ){ return !wxFileName::FileExists( paths[ii] ); } );
+
+   for (size_t ii = 0; ii < paths.size(); ii++)
+   {
+      if (missing[ii])
+      {
+         missingAUFHash[keys[ii]] = blocks[ii];
+         wxLogWarning(_("Missing alias (.auf) block file: '%s'"),
+                      paths[ii]);
+      }
+   }
 }
 
 void DirManager::FindMissingAUs(
       BlockHash& missingAUHash)                 // missing data (.au) blockfiles
 {
+   // As in FindMissingAUFs, name the files serially, test concurrently
+   std::vector<wxString> keys;
+   std::vector<BlockFilePtr> blocks;
+   std::vector<wxString> paths;
    BlockHash::iterator iter = mBlockFileHash.begin();
    while (iter != mBlockFileHash.end())
    {
@@ -1669,17 +2022,28 @@ void DirManager::FindMissingAUs(
             wxFileNameWrapper fileName{ MakeBlockFilePath(key) };
             fileName.SetName(key);
             fileName.SetExt(wxT("au"));
-            const auto path = fileName.GetFullPath();
-            if (!fileName.FileExists() ||
-                wxFile{ path }.Length() == 0)
-            {
-               missingAUHash[key] = b;
-               wxLogWarning(_("Missing data block file: '%s'"), path);
-            }
+            keys.push_back(key);
+            blocks.push_back(b);
+            paths.push_back(fileName.GetFullPath());
          }
       }
       ++iter;
    }
+
+   auto missing = RunFileChecks( paths.size(),
+      [&]( size_t ii ){
+         return !wxFileName::FileExists( paths[ii] ) ||
+            wxFile{ paths[ii] }.Length() == 0;
+      } );
+
+   for (size_t ii = 0; ii < paths.size(); ii++)
+   {
+      if (missing[ii])
+      {
+         missingAUHash[keys[ii]] = blocks[ii];
+         wxLogWarning(_("Missing data block file: '%s'"), paths[ii]);
+      }
+   }
 }
 
 // Find .au and .auf files that are not in the project.
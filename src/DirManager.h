@@ -17,14 +17,20 @@
 #include <functional>
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <wx/thread.h> // member variable
 
 #include "ClientData.h"
+#include "wxFileNameWrapper.h" // member variable
 
-class wxFileNameWrapper;
 class AudacityProject;
 class BlockArray;
 class BlockFile;
+class FileCopyPool;
 class ProgressDialog;
+class TrackIOQueue;
 
 using DirHash = std::unordered_map<int, int>;
 
@@ -142,6 +148,15 @@ class PROFILE_DLL_API DirManager final
    using BlockFileFactory = std::function< BlockFilePtr( wxFileNameWrapper ) >;
    BlockFilePtr NewBlockFile( const BlockFileFactory &factory );
 
+   // Content-addressed block identity:
+   /// Find a live block file with identical samples, so that duplicated
+   /// audio can share one file instead of writing another copy.
+   BlockFilePtr FindIdenticalBlockFile(
+      unsigned long long contentHash, size_t len);
+   /// Index a newly created block file by its content hash.
+   void RegisterContentHash(
+      unsigned long long contentHash, const BlockFilePtr &file);
+
    /// Returns true if the blockfile pointed to by b is contained by the DirManager
    bool ContainsBlockFile(const BlockFile *b) const;
    /// Check for existing using filename using complete filename
@@ -150,10 +165,21 @@ class PROFILE_DLL_API DirManager final
    // Adds one to the reference count of the block file,
    // UNLESS it is "locked", then it makes a NEW copy of
    // the BlockFile.
+   // Locked blocks of another open project are also shared by reference
+   // when possible (blocks are never written in place), and remembered
+   // so that MaterializeForeignBlocks can make this project
+   // self-contained at save.
    // May throw an exception in case of disk space exhaustion, otherwise
    // returns non-null.
    BlockFilePtr CopyBlockFile(const BlockFilePtr &b);
 
+   /// Copy the disk files of blocks shared from other projects into this
+   /// project's data directory, under their own names, so that the
+   /// project file about to be written refers only to files it owns.
+   /// Called before a plain save; Save As materializes through
+   /// ProjectSetter instead.  May throw FileException.
+   void MaterializeForeignBlocks();
+
    BlockFile *LoadBlockFile(const wxChar **attrs, sampleFormat format);
    void SaveBlockFile(BlockFile *f, int depth, FILE *fp);
 
@@ -162,8 +188,11 @@ class PROFILE_DLL_API DirManager final
    void SaveBlockFile(BlockFile * f, wxTextFile * out);
 #endif
 
+   // When a copy pool is given, needed copies are queued there instead
+   // of done at once, and the caller runs them afterwards
    std::pair<bool, FilePath>
-      LinkOrCopyToNewProjectDirectory(BlockFile *f, bool &link);
+      LinkOrCopyToNewProjectDirectory(
+         BlockFile *f, bool &link, FileCopyPool *copyPool = nullptr);
 
    bool EnsureSafeFilename(const wxFileName &fName);
 
@@ -214,6 +243,15 @@ class PROFILE_DLL_API DirManager final
    // project and thus worthless anyway.
    void RemoveOrphanBlockfiles();
 
+   // The external audio files aliased by live block files, as full path
+   // -> count of alias blocks, maintained incrementally as blocks are
+   // registered and swept.  The set may conservatively keep files whose
+   // aliases were since renamed or silenced, and counts blocks that only
+   // the undo history still holds; but it is empty exactly when no live
+   // block aliases anything, so an empty result lets a caller skip
+   // scanning every sequence for dependencies.
+   std::unordered_map<wxString, int> GetAliasedFiles();
+
    // Get directory where data files are in. Note that projects are normally
    // not interested in this information, but it is important for the
    // auto-save functionality
@@ -237,10 +275,42 @@ class PROFILE_DLL_API DirManager final
  private:
 
    wxFileNameWrapper MakeBlockFileName();
+   wxFileNameWrapper ProbeBlockFileName();
+   void ScheduleNameReservation();
+   void ResetNameReservoir();
    wxFileNameWrapper MakeBlockFilePath(const wxString &value);
 
+   void AliasInfoAdd(const wxString &key, const BlockFile &b);
+   void AliasInfoDel(const wxString &key);
+
    BlockHash mBlockFileHash; // repository for blockfiles
 
+   // Blocks shared by reference from other projects' directories, to be
+   // copied in by MaterializeForeignBlocks; guarded by mCreationLock
+   BlockHash mForeignBlockFiles;
+
+   // Maintained by AliasInfoAdd and AliasInfoDel; see GetAliasedFiles
+   std::unordered_map<wxString, int> mAliasedFiles;
+   std::unordered_map<wxString, wxString> mAliasBlockPaths; // block name -> aliased path
+
+   // Guards block file creation -- the filename balance structures,
+   // mBlockFileHash insertion, and the content hash index -- so that
+   // concurrent workers storing to different tracks may all create
+   // blocks through one DirManager
+   wxCriticalSection mCreationLock;
+
+   // content hash -> block files with that hash, for deduplication
+   std::unordered_multimap< unsigned long long, std::weak_ptr<BlockFile> >
+      mContentHashes;
+
+   // Block file names probed against the disk ahead of need, so that
+   // steady recording claims names without directory metadata operations;
+   // refilled in batches by mReserveWorker.  Guarded by mCreationLock.
+   std::vector<wxFileNameWrapper> mReservedNames;
+   std::unordered_set<wxString> mReservedNameSet;
+   bool mReservingNames{ false };
+   std::unique_ptr<TrackIOQueue> mReserveWorker;
+
    // Hashes for management of the sub-directory tree of _data
    struct BalanceInfo
    {
@@ -54,6 +54,17 @@ and get deterministic behaviour.
 
 #include <wx/defs.h>
 
+// Vector kernels for the contiguous conversions, which sit in every
+// import, export, block read, and mix path
+#if defined(__AVX__) || defined(__SSE2__) || defined(_M_X64) || \
+   (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define DITHER_VECTOR_SSE
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define DITHER_VECTOR_NEON
+#include <arm_neon.h>
+#endif
+
 //////////////////////////////////////////////////////////////////////////
 
 // Constants for the noise shaping buffer
@@ -64,7 +75,7 @@ const int Dither::BUF_SIZE = 8;
 const float Dither::SHAPED_BS[] = { 2.033f, -2.165f, 1.959f, -1.590f, 0.6149f };
 
 // This is supposed to produce white noise and no dc
-#define DITHER_NOISE (rand() / (float)RAND_MAX - 0.5f)
+#define DITHER_NOISE (Noise())
 
 // The following is a rather ugly, but fast implementation
 // of a dither loop. The macro "DITHER" is expanded to an implementation
@@ -207,6 +218,207 @@ const float Dither::SHAPED_BS[] = { 2.033f, -2.165f, 1.959f, -1.590f, 0.6149f };
     } while (0)
 
 
+// Vectorized kernels for the conversions between contiguous buffers.
+// They reproduce the scalar paths exactly: conversions to int round to
+// nearest like lrintf (the vector conversion instructions follow the
+// same default rounding mode) and clip like the STORE macros.  Returns
+// false when no kernel matches, in particular whenever real dithering
+// is wanted, and the caller falls through to the usual loops.
+static bool FastConvert(DitherType ditherType,
+                        const samplePtr source, sampleFormat sourceFormat,
+                        samplePtr dest, sampleFormat destFormat,
+                        unsigned int len)
+{
+#if !defined(DITHER_VECTOR_SSE) && !defined(DITHER_VECTOR_NEON)
+    (void)ditherType; (void)source; (void)sourceFormat;
+    (void)dest; (void)destFormat; (void)len;
+    return false;
+#else
+    unsigned int i = 0;
+
+    if (destFormat == floatSample && sourceFormat == int16Sample)
+    {
+        const short *s = (const short*)source;
+        float *d = (float*)dest;
+#ifdef DITHER_VECTOR_SSE
+        const __m128 scale = _mm_set1_ps(1.0f / CONVERT_DIV16);
+        for (; i + 8 <= len; i += 8) {
+            const __m128i v =
+               _mm_loadu_si128((const __m128i*)(s + i));
+            // Unpacking against itself then shifting sign-extends
+            const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+            const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+            _mm_storeu_ps(d + i,
+               _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+            _mm_storeu_ps(d + i + 4,
+               _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+        }
+#else
+        for (; i + 4 <= len; i += 4)
+            vst1q_f32(d + i, vmulq_n_f32(
+               vcvtq_f32_s32(vmovl_s16(vld1_s16(s + i))),
+               1.0f / CONVERT_DIV16));
+#endif
+        for (; i < len; i++)
+            d[i] = s[i] / CONVERT_DIV16;
+        return true;
+    }
+
+    if (destFormat == floatSample && sourceFormat == int24Sample)
+    {
+        const int *s = (const int*)source;
+        float *d = (float*)dest;
+#ifdef DITHER_VECTOR_SSE
+        const __m128 scale = _mm_set1_ps(1.0f / CONVERT_DIV24);
+        for (; i + 4 <= len; i += 4)
+            _mm_storeu_ps(d + i, _mm_mul_ps(
+               _mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*)(s + i))),
+               scale));
+#else
+        for (; i + 4 <= len; i += 4)
+            vst1q_f32(d + i, vmulq_n_f32(
+               vcvtq_f32_s32(vld1q_s32(s + i)), 1.0f / CONVERT_DIV24));
+#endif
+        for (; i < len; i++)
+            d[i] = s[i] / CONVERT_DIV24;
+        return true;
+    }
+
+    if (destFormat == int24Sample && sourceFormat == int16Sample)
+    {
+        const short *s = (const short*)source;
+        int *d = (int*)dest;
+#ifdef DITHER_VECTOR_SSE
+        for (; i + 8 <= len; i += 8) {
+            const __m128i v =
+               _mm_loadu_si128((const __m128i*)(s + i));
+            const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+            const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+            _mm_storeu_si128((__m128i*)(d + i), _mm_slli_epi32(lo, 8));
+            _mm_storeu_si128((__m128i*)(d + i + 4), _mm_slli_epi32(hi, 8));
+        }
+#else
+        for (; i + 4 <= len; i += 4)
+            vst1q_s32(d + i,
+               vshlq_n_s32(vmovl_s16(vld1_s16(s + i)), 8));
+#endif
+        for (; i < len; i++)
+            d[i] = ((int)s[i]) << 8;
+        return true;
+    }
+
+    // The remaining conversions narrow, so they go through the
+    // ditherers unless no dithering was asked for
+    if (ditherType != DitherType::none)
+        return false;
+
+#ifdef DITHER_VECTOR_NEON
+#if !defined(__aarch64__)
+    // vcvtnq (round to nearest) is ARMv8 only; older NEON truncates,
+    // which would not match lrintf
+    return false;
+#endif
+#endif
+
+    if (destFormat == int16Sample && sourceFormat == floatSample)
+    {
+        const float *s = (const float*)source;
+        short *d = (short*)dest;
+#ifdef DITHER_VECTOR_SSE
+        const __m128 bound = _mm_set1_ps(1.0f);
+        const __m128 scale = _mm_set1_ps(CONVERT_DIV16);
+        for (; i + 8 <= len; i += 8) {
+            __m128 v0 = _mm_loadu_ps(s + i);
+            __m128 v1 = _mm_loadu_ps(s + i + 4);
+            v0 = _mm_max_ps(_mm_min_ps(v0, bound), _mm_sub_ps(_mm_setzero_ps(), bound));
+            v1 = _mm_max_ps(_mm_min_ps(v1, bound), _mm_sub_ps(_mm_setzero_ps(), bound));
+            const __m128i x0 = _mm_cvtps_epi32(_mm_mul_ps(v0, scale));
+            const __m128i x1 = _mm_cvtps_epi32(_mm_mul_ps(v1, scale));
+            // The pack saturates, which is exactly the clipping wanted
+            _mm_storeu_si128((__m128i*)(d + i), _mm_packs_epi32(x0, x1));
+        }
+#elif defined(__aarch64__)
+        for (; i + 4 <= len; i += 4) {
+            float32x4_t v = vld1q_f32(s + i);
+            v = vmaxq_f32(vminq_f32(v, vdupq_n_f32(1.0f)), vdupq_n_f32(-1.0f));
+            const int32x4_t x = vcvtnq_s32_f32(vmulq_n_f32(v, CONVERT_DIV16));
+            vst1_s16(d + i, vqmovn_s32(x));
+        }
+#endif
+        int x;
+        for (; i < len; i++)
+            STORE_INT16(d + i, PROMOTE_TO_INT16(FROM_FLOAT(s + i)));
+        return true;
+    }
+
+    if (destFormat == int24Sample && sourceFormat == floatSample)
+    {
+        const float *s = (const float*)source;
+        int *d = (int*)dest;
+#ifdef DITHER_VECTOR_SSE
+        const __m128 bound = _mm_set1_ps(1.0f);
+        const __m128 scale = _mm_set1_ps(CONVERT_DIV24);
+        const __m128i top = _mm_set1_epi32(1 << 23);
+        for (; i + 4 <= len; i += 4) {
+            __m128 v = _mm_loadu_ps(s + i);
+            v = _mm_max_ps(_mm_min_ps(v, bound), _mm_sub_ps(_mm_setzero_ps(), bound));
+            __m128i x = _mm_cvtps_epi32(_mm_mul_ps(v, scale));
+            // Clamped input can still round up to exactly 1<<23;
+            // adding the all-ones compare mask takes just that back
+            // down to the maximum representable value
+            x = _mm_add_epi32(x, _mm_cmpeq_epi32(x, top));
+            _mm_storeu_si128((__m128i*)(d + i), x);
+        }
+#elif defined(__aarch64__)
+        for (; i + 4 <= len; i += 4) {
+            float32x4_t v = vld1q_f32(s + i);
+            v = vmaxq_f32(vminq_f32(v, vdupq_n_f32(1.0f)), vdupq_n_f32(-1.0f));
+            int32x4_t x = vcvtnq_s32_f32(vmulq_n_f32(v, CONVERT_DIV24));
+            x = vaddq_s32(x,
+               vreinterpretq_s32_u32(vceqq_s32(x, vdupq_n_s32(1 << 23))));
+            vst1q_s32(d + i, x);
+        }
+#endif
+        int x;
+        for (; i < len; i++)
+            STORE_INT24(d + i, PROMOTE_TO_INT24(FROM_FLOAT(s + i)));
+        return true;
+    }
+
+    if (destFormat == int16Sample && sourceFormat == int24Sample)
+    {
+        const int *s = (const int*)source;
+        short *d = (short*)dest;
+#ifdef DITHER_VECTOR_SSE
+        // The scalar path scales through float and rounds, which is a
+        // division by 256 with rounding to nearest, not a plain shift
+        const __m128 scale = _mm_set1_ps(1.0f / 256.0f);
+        for (; i + 8 <= len; i += 8) {
+            const __m128i x0 = _mm_cvtps_epi32(_mm_mul_ps(
+               _mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*)(s + i))),
+               scale));
+            const __m128i x1 = _mm_cvtps_epi32(_mm_mul_ps(
+               _mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*)(s + i + 4))),
+               scale));
+            _mm_storeu_si128((__m128i*)(d + i), _mm_packs_epi32(x0, x1));
+        }
+#elif defined(__aarch64__)
+        for (; i + 4 <= len; i += 4) {
+            const int32x4_t x = vcvtnq_s32_f32(vmulq_n_f32(
+               vcvtq_f32_s32(vld1q_s32(s + i)), 1.0f / 256.0f));
+            vst1_s16(d + i, vqmovn_s32(x));
+        }
+#endif
+        int x;
+        for (; i < len; i++)
+            STORE_INT16(d + i, PROMOTE_TO_INT16(FROM_INT24(s + i)));
+        return true;
+    }
+
+    return false;
+#endif
+}
+
 Dither::Dither()
 {
     // On startup, initialize dither by resetting values
@@ -218,6 +430,7 @@ void Dither::Reset()
     mTriangleState = 0;
     mPhase = 0;
     memset(mBuffer, 0, sizeof(float) * BUF_SIZE);
+    mRandState = 0x9e3779b9;
 }
 
 // This only decides if we must dither at all, the dithers
@@ -259,6 +472,12 @@ void Dither::Apply(enum DitherType ditherType,
     if (len == 0)
         return; // nothing to do
 
+    // Contiguous buffers take the vectorized kernels where they apply
+    if (sourceStride == 1 && destStride == 1 &&
+        FastConvert(ditherType, source, sourceFormat,
+                    dest, destFormat, len))
+        return;
+
     if (destFormat == sourceFormat)
     {
         // No need to dither, because source and destination
@@ -350,6 +569,20 @@ void Dither::Apply(enum DitherType ditherType,
 
 // Dither implementations
 
+// White noise in [-0.5, 0.5), from a xorshift generator.  A library
+// rand() call per sample (two for shaped dither) dominated the whole
+// conversion loop; this is a handful of shifts and xors, all inline,
+// and keeps its state in the Dither instance, so Reset() really does
+// give deterministic behaviour and concurrent converters don't share
+// hidden library state.
+inline float Dither::Noise()
+{
+    mRandState ^= mRandState << 13;
+    mRandState ^= mRandState >> 17;
+    mRandState ^= mRandState << 5;
+    return (int)mRandState * (0.5f / 2147483648.0f);
+}
+
 // No dither, just return sample
 inline float Dither::NoDither(float sample)
 {
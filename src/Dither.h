@@ -51,6 +51,9 @@ private:
     float TriangleDither(float sample);
     float ShapedDither(float sample);
 
+    // Noise source for the ditherers
+    float Noise();
+
     // Dither constants
     static const int BUF_SIZE; /* = 8 */
     static const int BUF_MASK; /* = 7 */
@@ -60,6 +63,7 @@ private:
     int mPhase;
     float mTriangleState;
     float mBuffer[8 /* = BUF_SIZE */];
+    unsigned int mRandState;
 };
 
 #endif /* __AUDACITY_DITHER_H__ */
@@ -134,6 +134,7 @@ void Envelope::Flatten(double value)
 {
    mEnv.clear();
    mDefaultValue = ClampValue(value);
+   Changed();
 }
 
 void Envelope::SetDragPoint(int dragPoint)
@@ -359,16 +360,19 @@ void Envelope::WriteXML(XMLWriter &xmlFile) const
 void Envelope::Delete( int point )
 {
    mEnv.erase(mEnv.begin() + point);
+   Changed();
 }
 
 void Envelope::Insert(int point, const EnvPoint &p)
 {
    mEnv.insert(mEnv.begin() + point, p);
+   Changed();
 }
 
 void Envelope::Insert(double when, double value)
 {
    mEnv.push_back( EnvPoint{ when, value });
+   Changed();
 }
 
 void Envelope::CollapseRegion( double t0, double t1, double sampleDur )
@@ -429,8 +433,10 @@ void Envelope::CollapseRegion( double t0, double t1, double sampleDur )
       if ( leftPoint )
          rightPoint = false;
    }
-   else
+   else {
       mEnv.erase( mEnv.begin() + begin, mEnv.begin() + end );
+      Changed();
+   }
 
    // Shift points left after deleted region.
    auto len = mEnv.size();
@@ -513,6 +519,7 @@ void Envelope::PasteEnvelope( double t0, const Envelope *e, double sampleDur )
    if ( otherSize != 0 && otherOffset == 0.0 && e->mEnv[ 0 ].GetT() == 0.0 )
       ++begin, --otherSize;
    mEnv.insert( mEnv.begin() + insertAt, begin, end );
+   Changed();
 
    // Adjust their times
    for ( size_t index = insertAt, last = insertAt + otherSize;
@@ -784,6 +791,7 @@ void Envelope::SetOffset(double newOffset)
 // NOFAIL-GUARANTEE
 {
    mOffset = newOffset;
+   Changed();
 }
 
 void Envelope::SetTrackLen( double trackLen, double sampleDur )
@@ -805,6 +813,8 @@ void Envelope::SetTrackLen( double trackLen, double sampleDur )
 
    if ( needPoint )
       AddPointAtEnd( mTrackLen, value );
+
+   Changed();
 }
 
 void Envelope::RescaleTimes( double newLength )
@@ -820,6 +830,7 @@ void Envelope::RescaleTimes( double newLength )
          point.SetT( point.GetT() * ratio );
    }
    mTrackLen = newLength;
+   Changed();
 }
 
 // Accessors
@@ -1036,11 +1047,33 @@ void Envelope::GetValuesRelative
 
          buffer[b] = v;
       } else {
-         if (mDB){
-            buffer[b] = buffer[b - 1] * vstep;
-         }else{
-            buffer[b] = buffer[b - 1] + vstep;
+         // Every sample until tnext stays in this point-to-point interval
+         // and needs only the recurrence, so consume the whole run here
+         // instead of repeating the case analysis above per sample.  This
+         // is the inner loop of playback and export mixing whenever a
+         // track has a gain envelope.
+         double v = buffer[b - 1];
+         if (mDB) {
+            do {
+               v *= vstep;
+               buffer[b] = v;
+               t += tstep;
+               ++b;
+            } while (b < bufferLen &&
+               ( leftLimit ? t + increment <= tnext : t + increment < tnext ));
          }
+         else {
+            do {
+               v += vstep;
+               buffer[b] = v;
+               t += tstep;
+               ++b;
+            } while (b < bufferLen &&
+               ( leftLimit ? t + increment <= tnext : t + increment < tnext ));
+         }
+         // The loop went one past the run; the enclosing loop re-increments.
+         --b;
+         continue;
       }
 
       t += tstep;
@@ -1292,6 +1325,76 @@ double Envelope::IntegralOfInverse( double t0, double t1 ) const
    }
 }
 
+void Envelope::PrepareInverseIntegralTable() const
+{
+   // Main thread only.  Once the mixer workers are running they treat
+   // the table as read-only, so all writes must happen here first.
+   if (mEnv.size() >= 2 &&
+       (!mInverseIntegralValid || mInverseIntegralVersion != mVersion))
+      RebuildInverseIntegralTable();
+}
+
+void Envelope::RebuildInverseIntegralTable() const
+{
+   const auto count = mEnv.size();
+   mInverseIntegralTable.resize(count);
+   if (count > 0) {
+      mInverseIntegralTable[0] = 0.0;
+      for (size_t i = 1; i < count; ++i)
+         mInverseIntegralTable[i] = mInverseIntegralTable[i - 1] +
+            IntegrateInverseInterpolated(
+               mEnv[i - 1].GetVal(), mEnv[i].GetVal(),
+               mEnv[i].GetT() - mEnv[i - 1].GetT(), mDB);
+   }
+   mInverseIntegralVersion = mVersion;
+   mInverseIntegralValid = true;
+}
+
+double Envelope::CumulativeInverseIntegral(double t) const
+{
+   // Callers guarantee at least two points and a current table
+   const auto count = mEnv.size();
+   if (t <= mEnv[0].GetT())
+      // Constant extension before the first point
+      return (t - mEnv[0].GetT()) / mEnv[0].GetVal();
+   else if (t >= mEnv[count - 1].GetT())
+      // Constant extension after the last point
+      return mInverseIntegralTable[count - 1] +
+         (t - mEnv[count - 1].GetT()) / mEnv[count - 1].GetVal();
+   else {
+      int lo, hi;
+      BinarySearchForTime(lo, hi, t);
+      const double t0 = mEnv[lo].GetT(), t1 = mEnv[hi].GetT();
+      const double midVal = InterpolatePoints(
+         mEnv[lo].GetVal(), mEnv[hi].GetVal(), (t - t0) / (t1 - t0), mDB);
+      // The part of the segment up to t is itself an interpolated segment
+      return mInverseIntegralTable[lo] + IntegrateInverseInterpolated(
+         mEnv[lo].GetVal(), midVal, t - t0, mDB);
+   }
+}
+
+double Envelope::IntegralOfInverseCached( double t0, double t1 ) const
+{
+   if(t0 == t1)
+      return 0.0;
+   if(t0 > t1)
+      return -IntegralOfInverseCached(t1, t0);
+
+   if(mEnv.size() < 2)
+      // Too few points for the table to pay; the direct computation has
+      // no loop to save in this case
+      return IntegralOfInverse(t0, t1);
+
+   if(!mInverseIntegralValid || mInverseIntegralVersion != mVersion)
+      // The envelope was edited since PrepareInverseIntegralTable ran.
+      // Several mixer workers may be here at once, so rebuilding now
+      // would race; compute the slow way until the next preparation.
+      return IntegralOfInverse(t0, t1);
+
+   return CumulativeInverseIntegral(t1 - mOffset)
+        - CumulativeInverseIntegral(t0 - mOffset);
+}
+
 double Envelope::SolveIntegralOfInverse( double t0, double area ) const
 {
    if(area == 0.0)
@@ -99,6 +99,11 @@ public:
    double GetOffset() const { return mOffset; }
    double GetTrackLen() const { return mTrackLen; }
 
+   /** \brief Counter incremented by every edit; lets caches of rendered
+    * audio detect that envelope data they were computed from is stale */
+   size_t GetVersion() const { return mVersion; }
+   void Changed() { ++mVersion; }
+
    bool GetExponential() const { return mDB; }
    void SetExponential(bool db) { mDB = db; }
 
@@ -165,6 +170,11 @@ private:
    void GetValuesRelative
       (double *buffer, int len, double t0, double tstep, bool leftLimit = false)
       const;
+   void RebuildInverseIntegralTable() const;
+   // relative time; cumulative integral of the inverse from the first
+   // control point, read from mInverseIntegralTable
+   double CumulativeInverseIntegral(double t) const;
+
    // relative time
    int NumberOfPointsAfter(double t) const;
    // relative time
@@ -177,12 +187,31 @@ public:
    double IntegralOfInverse( double t0, double t1 ) const;
    double SolveIntegralOfInverse( double t0, double area) const;
 
+   /** \brief Build the table that answers IntegralOfInverseCached, if an
+    * edit has made it stale.
+    *
+    * Call on the main thread before concurrent queries begin (as Mixer
+    * construction does); the query itself never mutates. */
+   void PrepareInverseIntegralTable() const;
+
+   /** \brief As IntegralOfInverse, but answered from a table of cumulative
+    * integrals at the control points, built by PrepareInverseIntegralTable.
+    *
+    * Playback warping through a time track queries this once per mixing
+    * chunk of every track; the table turns each query into a binary search
+    * and two closed-form segment integrals instead of a walk over all the
+    * points in range.  If the table is stale -- the envelope was edited
+    * after the last Prepare -- the answer is computed the slow way rather
+    * than rebuilding, so concurrent mixer workers never write shared
+    * state. */
+   double IntegralOfInverseCached( double t0, double t1 ) const;
+
    void print() const;
    void testMe();
 
    bool IsDirty() const;
 
-   void Clear() { mEnv.clear(); }
+   void Clear() { mEnv.clear(); Changed(); }
 
    /** \brief Add a point at a particular absolute time coordinate */
    int InsertOrReplace(double when, double value)
@@ -263,6 +292,17 @@ private:
    double mMinValue, mMaxValue;
    double mDefaultValue;
 
+   // Edit counter, for GetVersion()
+   size_t mVersion { 0 };
+
+   // Cumulative integral of the inverse from the first control point to
+   // each control point, for IntegralOfInverseCached; written only by
+   // PrepareInverseIntegralTable on the main thread, and ignored by
+   // queries when mInverseIntegralVersion falls behind mVersion
+   mutable std::vector<double> mInverseIntegralTable;
+   mutable size_t mInverseIntegralVersion { 0 };
+   mutable bool mInverseIntegralValid { false };
+
    // UI stuff
    bool mDragPointValid { false };
    int mDragPoint { -1 };
@@ -272,8 +312,10 @@ private:
 
 inline void EnvPoint::SetVal( Envelope *pEnvelope, double val )
 {
-   if ( pEnvelope )
+   if ( pEnvelope ) {
       val = pEnvelope->ClampValue(val);
+      pEnvelope->Changed();
+   }
    mVal = val;
 }
 
@@ -131,6 +131,9 @@
 // similarly for FFmpeg:
 // Won't build on Fedora 17 or Windows VC++, per http://bugzilla.audacityteam.org/show_bug.cgi?id=539.
 //#define EXPERIMENTAL_OD_FFMPEG 1
+// similarly for MP3, using an exact frame seek index built by a fast
+// header-only scan at import time:
+//#define EXPERIMENTAL_OD_MP3
 
 // Paul Licameli (PRL) 5 Oct 2014
 #define EXPERIMENTAL_SPECTRAL_EDITING
@@ -48,13 +48,29 @@
 
 #include <wx/wxcrtvararg.h>
 #include <wx/intl.h>
+#include <wx/thread.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <math.h>
+#include <algorithm>
+#include <memory>
+#include <vector>
 
 #include "RealFFTf.h"
 
+// Vector kernels for the windowed-multiply and magnitude-squared loops,
+// which spectral analysis calls once per hop
+#if defined(__AVX__) || defined(__SSE2__) || defined(_M_X64) || \
+   (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FFT_VECTOR_SSE
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define FFT_VECTOR_NEON
+#include <arm_neon.h>
+#endif
+
 static ArraysOf<int> gFFTBitTable;
+static wxCriticalSection gFFTBitTableMutex;
 static const size_t MaxFastBits = 16;
 
 /* Declare Static functions */
@@ -142,8 +158,13 @@ void FFT(size_t NumSamples,
       exit(1);
    }
 
-   if (!gFFTBitTable)
-      InitFFT();
+   {
+      // Effects may call this concurrently from worker threads; the table
+      // is immutable once built, so only the first build needs the lock
+      wxCriticalSectionLocker locker{ gFFTBitTableMutex };
+      if (!gFFTBitTable)
+         InitFFT();
+   }
 
    if (!InverseTransform)
       angle_numerator = -angle_numerator;
@@ -313,11 +334,33 @@ void PowerSpectrum(size_t NumSamples, const float *In, float *Out)
    // Perform the FFT
    RealFFTf(pFFT.get(), hFFT.get());
 
-   // Copy the data into the real and imaginary outputs
-   for (size_t i = 1; i<NumSamples / 2; i++) {
-      Out[i]= (pFFT[hFFT->BitReversed[i]  ]*pFFT[hFFT->BitReversed[i]  ])
-         + (pFFT[hFFT->BitReversed[i]+1]*pFFT[hFFT->BitReversed[i]+1]);
-   }
+   // Square the magnitudes while still in the buffer's own (bit-reversed)
+   // order, where the loop vectorizes, then scatter into frequency order
+   const auto half = NumSamples / 2;
+   Floats power{ half };
+   size_t ii = 0;
+#ifdef FFT_VECTOR_SSE
+   for (; ii + 4 <= half; ii += 4) {
+      const __m128 v0 = _mm_loadu_ps(&pFFT[2 * ii]);
+      const __m128 v1 = _mm_loadu_ps(&pFFT[2 * ii + 4]);
+      const __m128 re = _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(2, 0, 2, 0));
+      const __m128 im = _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(3, 1, 3, 1));
+      _mm_storeu_ps(&power[ii],
+         _mm_add_ps(_mm_mul_ps(re, re), _mm_mul_ps(im, im)));
+   }
+#elif defined(FFT_VECTOR_NEON)
+   for (; ii + 4 <= half; ii += 4) {
+      const float32x4x2_t v = vld2q_f32(&pFFT[2 * ii]);
+      vst1q_f32(&power[ii],
+         vmlaq_f32(vmulq_f32(v.val[0], v.val[0]), v.val[1], v.val[1]));
+   }
+#endif
+   for (; ii < half; ++ii)
+      power[ii] = pFFT[2 * ii] * pFFT[2 * ii]
+         + pFFT[2 * ii + 1] * pFFT[2 * ii + 1];
+
+   for (size_t i = 1; i < half; i++)
+      Out[i] = power[hFFT->BitReversed[i] / 2];
    // Handle the (real-only) DC and Fs/2 bins
    Out[0] = pFFT[0]*pFFT[0];
    Out[NumSamples / 2] = pFFT[1]*pFFT[1];
@@ -359,7 +402,9 @@ const wxChar *WindowFuncName(int whichFunction)
    }
 }
 
-void NewWindowFunc(int whichFunction, size_t NumSamplesIn, bool extraSample, float *in)
+// Multiply the given coefficients into the window in-place.  This body,
+// applied to a buffer of ones, is also how the cached tables below are built.
+static void ComputeWindowFunc(int whichFunction, size_t NumSamplesIn, bool extraSample, float *in)
 {
    int NumSamples = (int)NumSamplesIn;
    if (extraSample) {
@@ -503,6 +548,79 @@ void NewWindowFunc(int whichFunction, size_t NumSamplesIn, bool extraSample, flo
    }
 }
 
+namespace {
+   struct WindowTable {
+      int which;
+      size_t len;
+      bool extra;
+      Floats coefficients;
+   };
+}
+
+enum : size_t { MAX_WINDOW_TABLES = 12 };
+
+// Maintain a pool, as for the FFT tables above; entries are never removed,
+// so pointers into it stay valid after the lock is dropped
+static std::vector< std::unique_ptr<WindowTable> > gWindowTables;
+static wxCriticalSection getWindowTableMutex;
+
+static const float *GetWindowTable(
+   int whichFunction, size_t NumSamples, bool extraSample)
+{
+   wxCriticalSectionLocker locker{ getWindowTableMutex };
+
+   for (auto &pTable : gWindowTables)
+      if (pTable->which == whichFunction &&
+          pTable->len == NumSamples &&
+          pTable->extra == extraSample)
+         return pTable->coefficients.get();
+
+   if (gWindowTables.size() >= MAX_WINDOW_TABLES)
+      // Unusual variety of windows in flight; make the caller compute
+      return nullptr;
+
+   auto pTable = std::make_unique<WindowTable>( WindowTable{
+      whichFunction, NumSamples, extraSample, Floats{ NumSamples } } );
+   auto coefficients = pTable->coefficients.get();
+   std::fill(coefficients, coefficients + NumSamples, 1.0f);
+   ComputeWindowFunc(whichFunction, NumSamples, extraSample, coefficients);
+   gWindowTables.push_back( std::move( pTable ) );
+   return coefficients;
+}
+
+static inline void MultiplyWindow(
+   float *in, const float *coefficients, size_t len)
+{
+   size_t ii = 0;
+#ifdef FFT_VECTOR_SSE
+   for (; ii + 4 <= len; ii += 4)
+      _mm_storeu_ps(in + ii,
+         _mm_mul_ps(_mm_loadu_ps(in + ii), _mm_loadu_ps(coefficients + ii)));
+#elif defined(FFT_VECTOR_NEON)
+   for (; ii + 4 <= len; ii += 4)
+      vst1q_f32(in + ii,
+         vmulq_f32(vld1q_f32(in + ii), vld1q_f32(coefficients + ii)));
+#endif
+   for (; ii < len; ++ii)
+      in[ii] *= coefficients[ii];
+}
+
+void NewWindowFunc(int whichFunction, size_t NumSamplesIn, bool extraSample, float *in)
+{
+   if (whichFunction == eWinFuncRectangular)
+      // Multiply all by 1.0f -- do nothing
+      return;
+
+   // The callers in spectral analysis apply the same window at the same
+   // length once per hop; look the coefficients up rather than rerunning
+   // the transcendental functions every time
+   if (auto coefficients =
+       GetWindowTable(whichFunction, NumSamplesIn, extraSample))
+      MultiplyWindow(in, coefficients, NumSamplesIn);
+   else
+      ComputeWindowFunc(whichFunction, NumSamplesIn, extraSample, in);
+}
+
 // See cautions in FFT.h !
 void WindowFunc(int whichFunction, size_t NumSamples, float *in)
 {
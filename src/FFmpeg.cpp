@@ -64,7 +64,12 @@ void DropFFmpegLibs()
    if (FFmpegLibsPtr)
    {
       FFmpegLibsPtr->refcount--;
-      if (FFmpegLibsPtr->refcount == 0)
+      // Keep a validly loaded library resident even when the last user
+      // lets go of it, so scripted runs that export file after file do
+      // not reload and re-resolve the shared objects for every file.
+      // The preference dialog still unloads explicitly with FreeLibs
+      // before dropping, and that warm copy is discarded here.
+      if (FFmpegLibsPtr->refcount == 0 && !FFmpegLibsPtr->ValidLibsLoaded())
          FFmpegLibsPtr.reset();
    }
 }
@@ -755,6 +760,18 @@ bool FFmpegLibs::LoadLibs(wxWindow * WXUNUSED(parent), bool showerr)
    }
 
    wxLogMessage(wxT("FFmpeg libraries loaded successfully."));
+
+   // Remember where they were found, so that the next launch loads
+   // directly from there instead of probing the default and system
+   // paths again.  FindLibs only records a path the user picked by
+   // hand; without this, a copy found by searching was re-searched-for
+   // at every startup.
+   if (gPrefs &&
+       gPrefs->Read(wxT("/FFmpeg/FFmpegLibPath"), wxT("")) != mLibAVFormatPath) {
+      gPrefs->Write(wxT("/FFmpeg/FFmpegLibPath"), mLibAVFormatPath);
+      gPrefs->Flush();
+   }
+
    return true;
 }
 
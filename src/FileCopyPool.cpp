@@ -0,0 +1,159 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  FileCopyPool.cpp
+
+*******************************************************************//**
+
+\class FileCopyPool
+\brief Copies many files at once with a few threads and large buffers.
+
+The copies of a Save As or Save Lossless Copy are independent of one
+another, so several can be in flight at a time; the disk's own queue
+then merges and reorders them far better than one synchronous copy at
+a time allows.  Each worker moves data through a one-megabyte buffer,
+so even file systems with small default transfer sizes see long
+sequential requests.
+
+*//*******************************************************************/
+
+#include "Audacity.h"
+#include "FileCopyPool.h"
+
+#include <algorithm>
+#include <thread>
+
+#include <wx/file.h>
+#include <wx/filefn.h>
+#include <wx/log.h>
+
+#include "MemoryX.h"
+
+namespace {
+
+// Large enough that rotational targets stream; small enough that a few
+// workers' buffers together cost little memory
+const size_t kCopyBufferSize = 1024 * 1024;
+
+// Beyond a few threads the disk, not the CPU, is the limit
+const unsigned kMaxCopyThreads = 4;
+
+/// Copy one file through a large buffer, with the same length check
+/// against silent truncation that FileNames::CopyFile does
+bool CopyFileLarge(const FilePath &source, const FilePath &target)
+{
+   wxFile in(source, wxFile::read);
+   if (!in.IsOpened())
+      return false;
+
+   wxFile out(target, wxFile::write);
+   if (!out.IsOpened())
+      return false;
+
+   ArrayOf<char> buffer{ kCopyBufferSize };
+   auto remaining = in.Length();
+   while (remaining > 0) {
+      const auto chunk =
+         (size_t) std::min(remaining, (wxFileOffset) kCopyBufferSize);
+      if (in.Read(buffer.get(), chunk) != (ssize_t) chunk)
+         return false;
+      if (out.Write(buffer.get(), chunk) != chunk)
+         return false;
+      remaining -= chunk;
+   }
+
+   return out.Flush() && in.Length() == out.Tell();
+}
+
+}
+
+FileCopyPool::FileCopyPool()
+{
+}
+
+void FileCopyPool::Add(const FilePath &source, const FilePath &target)
+{
+   mTasks.push_back({ source, target });
+}
+
+bool FileCopyPool::Run(const std::function<bool(size_t, size_t)> &progress)
+{
+   mFailures.clear();
+   mNextTask = 0;
+   mDone = 0;
+   mCancelled = false;
+
+   const auto total = mTasks.size();
+   if (total == 0)
+      return true;
+
+   unsigned nThreads = std::thread::hardware_concurrency();
+   nThreads = std::max(1u,
+      std::min({ nThreads, kMaxCopyThreads, (unsigned) total }));
+
+   std::vector<std::thread> workers;
+   for (unsigned ii = 0; ii < nThreads; ++ii)
+      workers.emplace_back([this]{ WorkerLoop(); });
+
+   // Pump the progress callback from the calling thread, which keeps
+   // the dialog responsive and lets the user cancel
+   for (;;) {
+      size_t done, finished;
+      {
+         std::lock_guard<std::mutex> guard{ mMutex };
+         done = mDone;
+         finished = mDone + mFailures.size();
+      }
+      if (progress && !progress(done, total)) {
+         std::lock_guard<std::mutex> guard{ mMutex };
+         mCancelled = true;
+         break;
+      }
+      if (finished == total)
+         break;
+      ::wxMilliSleep(50);
+   }
+
+   for (auto &worker : workers)
+      worker.join();
+
+   const bool success = !mCancelled && mFailures.empty() && mDone == total;
+   if (!success) {
+      // Leave no partial targets behind
+      for (const auto &failure : mFailures)
+         if (wxFileExists(failure))
+            ::wxRemoveFile(failure);
+      std::lock_guard<std::mutex> guard{ mMutex };
+      for (size_t ii = mNextTask; ii < total; ++ii)
+         if (wxFileExists(mTasks[ii].target))
+            ::wxRemoveFile(mTasks[ii].target);
+   }
+
+   mTasks.clear();
+   return success;
+}
+
+void FileCopyPool::WorkerLoop()
+{
+   for (;;) {
+      size_t index;
+      {
+         std::lock_guard<std::mutex> guard{ mMutex };
+         if (mCancelled || mNextTask >= mTasks.size())
+            return;
+         index = mNextTask++;
+      }
+
+      const auto &task = mTasks[index];
+      const bool copied = CopyFileLarge(task.source, task.target);
+
+      std::lock_guard<std::mutex> guard{ mMutex };
+      if (copied)
+         ++mDone;
+      else {
+         wxLogDebug(wxT("FileCopyPool: could not copy to %s"), task.target);
+         mFailures.push_back(task.target);
+      }
+   }
+}
@@ -0,0 +1,63 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  FileCopyPool.h
+
+**********************************************************************/
+
+#ifndef __AUDACITY_FILE_COPY_POOL__
+#define __AUDACITY_FILE_COPY_POOL__
+
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "audacity/Types.h"
+
+/// \brief A pool of threads copying many files with large sequential
+/// reads and writes.
+///
+/// Saving a copy of a project duplicates every block file; doing that
+/// one file at a time on the main thread leaves the target disk mostly
+/// idle.  Queue the copies here instead, then Run() them across a few
+/// worker threads, each using a large transfer buffer so the disk sees
+/// long sequential requests.  Completion is accounted per file, so the
+/// caller can drive a progress dialog and learn which copies failed.
+class FileCopyPool {
+public:
+   FileCopyPool();
+
+   /// Queue one copy.  No work happens until Run().
+   void Add(const FilePath &source, const FilePath &target);
+
+   size_t Count() const { return mTasks.size(); }
+
+   /// Copy everything queued, reporting (filesDone, filesTotal) to the
+   /// callback on the calling thread.  A false return from the callback
+   /// cancels the rest.  Returns true only when every copy succeeded.
+   /// Targets of failed or cancelled copies are removed.
+   bool Run(const std::function<bool(size_t, size_t)> &progress);
+
+   /// Paths of targets that could not be copied in the last Run()
+   const FilePaths &Failures() const { return mFailures; }
+
+private:
+   struct Task {
+      FilePath source;
+      FilePath target;
+   };
+
+   void WorkerLoop();
+
+   std::vector<Task> mTasks;
+   FilePaths mFailures;
+
+   // Shared by the workers during Run()
+   std::mutex mMutex;
+   size_t mNextTask{ 0 };
+   size_t mDone{ 0 };
+   bool mCancelled{ false };
+};
+
+#endif
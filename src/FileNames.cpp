@@ -248,6 +248,11 @@ FilePath FileNames::PluginSettings()
    return wxFileName( DataDir(), wxT("pluginsettings.cfg") ).GetFullPath();
 }
 
+FilePath FileNames::PluginScanCache()
+{
+   return wxFileName( DataDir(), wxT("pluginscancache.cfg") ).GetFullPath();
+}
+
 FilePath FileNames::BaseDir()
 {
    wxFileName baseDir;
@@ -75,6 +75,7 @@ public:
    static FilePath NRPFile();
    static FilePath PluginRegistry();
    static FilePath PluginSettings();
+   static FilePath PluginScanCache();
 
    static FilePath BaseDir();
    static FilePath ModulesDir();
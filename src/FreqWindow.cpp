@@ -44,6 +44,9 @@ and in the spectrogram spectral selection.
 #include "FreqWindow.h"
 
 #include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
 
 #include <wx/setup.h> // for wxUSE_* macros
 
@@ -67,6 +70,7 @@ and in the spectrogram spectral selection.
 
 #include <wx/textctrl.h>
 #include <wx/textfile.h>
+#include <wx/utils.h>
 
 #include <math.h>
 
@@ -1261,18 +1265,22 @@ bool SpectrumAnalyst::Calculate(Algorithm alg, int windowFunc,
       progress->SetRange(dataLen);
    }
 
-   size_t start = 0;
-   int windows = 0;
-   while (start + mWindowSize <= dataLen) {
+   const size_t nWindows = (dataLen - mWindowSize) / half + 1;
+
+   // One window's worth of accumulation.  inBuf, outBuf and out2Buf are
+   // scratch of the window size; sums gathers half a window of totals.
+   auto accumulate = [&]( size_t start,
+      float *inBuf, float *outBuf, float *out2Buf, float *sums )
+   {
       for (size_t i = 0; i < mWindowSize; i++)
-         in[i] = win[i] * data[start + i];
+         inBuf[i] = win[i] * data[start + i];
 
       switch (alg) {
          case Spectrum:
-            PowerSpectrum(mWindowSize, in.get(), out.get());
+            PowerSpectrum(mWindowSize, inBuf, outBuf);
 
             for (size_t i = 0; i < half; i++)
-               mProcessed[i] += out[i];
+               sums[i] += outBuf[i];
             break;
 
          case Autocorrelation:
@@ -1280,14 +1288,14 @@ bool SpectrumAnalyst::Calculate(Algorithm alg, int windowFunc,
          case EnhancedAutocorrelation:
 
             // Take FFT
-            RealFFT(mWindowSize, in.get(), out.get(), out2.get());
+            RealFFT(mWindowSize, inBuf, outBuf, out2Buf);
             // Compute power
             for (size_t i = 0; i < mWindowSize; i++)
-               in[i] = (out[i] * out[i]) + (out2[i] * out2[i]);
+               inBuf[i] = (outBuf[i] * outBuf[i]) + (out2Buf[i] * out2Buf[i]);
 
             if (alg == Autocorrelation) {
                for (size_t i = 0; i < mWindowSize; i++)
-                  in[i] = sqrt(in[i]);
+                  inBuf[i] = sqrt(inBuf[i]);
             }
             if (alg == CubeRootAutocorrelation ||
                 alg == EnhancedAutocorrelation) {
@@ -1295,18 +1303,18 @@ bool SpectrumAnalyst::Calculate(Algorithm alg, int windowFunc,
                // of the power, instead of the square root
 
                for (size_t i = 0; i < mWindowSize; i++)
-                  in[i] = pow(in[i], 1.0f / 3.0f);
+                  inBuf[i] = pow(inBuf[i], 1.0f / 3.0f);
             }
             // Take FFT
-            RealFFT(mWindowSize, in.get(), out.get(), out2.get());
+            RealFFT(mWindowSize, inBuf, outBuf, out2Buf);
 
             // Take real part of result
             for (size_t i = 0; i < half; i++)
-               mProcessed[i] += out[i];
+               sums[i] += outBuf[i];
             break;
 
          case Cepstrum:
-            RealFFT(mWindowSize, in.get(), out.get(), out2.get());
+            RealFFT(mWindowSize, inBuf, outBuf, out2Buf);
 
             // Compute log power
             // Set a sane lower limit assuming maximum time amplitude of 1.0
@@ -1315,18 +1323,18 @@ bool SpectrumAnalyst::Calculate(Algorithm alg, int windowFunc,
                float minpower = 1e-20*mWindowSize*mWindowSize;
                for (size_t i = 0; i < mWindowSize; i++)
                {
-                  power = (out[i] * out[i]) + (out2[i] * out2[i]);
+                  power = (outBuf[i] * outBuf[i]) + (out2Buf[i] * out2Buf[i]);
                   if(power < minpower)
-                     in[i] = log(minpower);
+                     inBuf[i] = log(minpower);
                   else
-                     in[i] = log(power);
+                     inBuf[i] = log(power);
                }
                // Take IFFT
-               InverseRealFFT(mWindowSize, in.get(), NULL, out.get());
+               InverseRealFFT(mWindowSize, inBuf, NULL, outBuf);
 
                // Take real part of result
                for (size_t i = 0; i < half; i++)
-                  mProcessed[i] += out[i];
+                  sums[i] += outBuf[i];
             }
 
             break;
@@ -1335,14 +1343,61 @@ bool SpectrumAnalyst::Calculate(Algorithm alg, int windowFunc,
             wxASSERT(false);
             break;
       }                         //switch
+   };
+
+   // The windows are independent accumulations, so long selections divide
+   // among worker threads, each summing into its own partial total.  The
+   // FFT tables come from the common pool and are shared read-only.  Short
+   // analyses, such as the frequency snapping of selections, are not worth
+   // the thread launches and stay on this thread.
+   const unsigned nThreads = nWindows < 8 ? 1 : std::min<size_t>(
+      std::max( 1u, std::thread::hardware_concurrency() ), nWindows );
+
+   if (nThreads <= 1) {
+      for (size_t w = 0; w < nWindows; w++) {
+         accumulate(w * half, in.get(), out.get(), out2.get(),
+            mProcessed.data());
+
+         // Update the progress bar
+         if (progress) {
+            progress->SetValue(w * half);
+         }
+      }
+   }
+   else {
+      std::atomic<size_t> windowsDone{ 0 };
+      std::vector<Floats> partialSums;
+      std::vector<std::thread> workers;
+      partialSums.reserve(nThreads);
+      workers.reserve(nThreads);
+      for (unsigned t = 0; t < nThreads; t++)
+         partialSums.emplace_back(half, true);
+      for (unsigned t = 0; t < nThreads; t++)
+         workers.emplace_back( [&, t]{
+            Floats tIn{ mWindowSize };
+            Floats tOut{ mWindowSize };
+            Floats tOut2{ mWindowSize };
+            const auto sums = partialSums[t].get();
+            for (size_t w = t; w < nWindows; w += nThreads) {
+               accumulate(w * half, tIn.get(), tOut.get(), tOut2.get(), sums);
+               ++windowsDone;
+            }
+         } );
 
-      // Update the progress bar
+      // Keep the progress bar moving while the workers run
       if (progress) {
-         progress->SetValue(start);
+         while (windowsDone.load() < nWindows) {
+            progress->SetValue(windowsDone.load() * half);
+            wxMilliSleep(50);
+         }
       }
 
-      start += half;
-      windows++;
+      for (auto &worker : workers)
+         worker.join();
+
+      for (const auto &sums : partialSums)
+         for (size_t i = 0; i < half; i++)
+            mProcessed[i] += sums[i];
    }
 
    if (progress) {
@@ -1357,7 +1412,7 @@ bool SpectrumAnalyst::Calculate(Algorithm alg, int windowFunc,
       // Convert to decibels
       mYMin = 1000000.;
       mYMax = -1000000.;
-      scale = wss / (double)windows;
+      scale = wss / (double)nWindows;
       for (size_t i = 0; i < half; i++)
       {
          mProcessed[i] = 10 * log10(mProcessed[i] * scale);
@@ -1371,7 +1426,7 @@ bool SpectrumAnalyst::Calculate(Algorithm alg, int windowFunc,
    case Autocorrelation:
    case CubeRootAutocorrelation:
       for (size_t i = 0; i < half; i++)
-         mProcessed[i] = mProcessed[i] / windows;
+         mProcessed[i] = mProcessed[i] / nWindows;
 
       // Find min/max
       mYMin = mProcessed[0];
@@ -1385,7 +1440,7 @@ bool SpectrumAnalyst::Calculate(Algorithm alg, int windowFunc,
 
    case EnhancedAutocorrelation:
       for (size_t i = 0; i < half; i++)
-         mProcessed[i] = mProcessed[i] / windows;
+         mProcessed[i] = mProcessed[i] / nWindows;
 
       // Peak Pruning as described by Tolonen and Karjalainen, 2000
 
@@ -1421,7 +1476,7 @@ bool SpectrumAnalyst::Calculate(Algorithm alg, int windowFunc,
 
    case Cepstrum:
       for (size_t i = 0; i < half; i++)
-         mProcessed[i] = mProcessed[i] / windows;
+         mProcessed[i] = mProcessed[i] / nWindows;
 
       // Find min/max, ignoring first and last few values
       {
@@ -1449,6 +1504,20 @@ bool SpectrumAnalyst::Calculate(Algorithm alg, int windowFunc,
    return true;
 }
 
+bool SpectrumAnalyst::Adopt(double rate, size_t windowSize,
+                            std::vector<float> &&processed)
+{
+   if (processed.size() != windowSize || windowSize < 32)
+      return false;
+
+   mAlg = Spectrum;
+   mRate = rate;
+   mWindowSize = windowSize;
+   mProcessed = std::move(processed);
+
+   return true;
+}
+
 const float *SpectrumAnalyst::GetProcessed() const
 {
    return &mProcessed[0];
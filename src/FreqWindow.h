@@ -57,6 +57,14 @@ public:
       float *pYMin = NULL, float *pYMax = NULL, // outputs
       FreqGauge *progress = NULL);
 
+   // Take possession of an externally computed spectrum, shaped as
+   // Calculate would have left it for the Spectrum algorithm:
+   // windowSize dB values of which the first half are meaningful.  Lets
+   // callers reuse cached spectrogram columns instead of transforming
+   // the samples again.  Return true iff successful.
+   bool Adopt(double rate, size_t windowSize,
+      std::vector<float> &&processed);
+
    const float *GetProcessed() const;
    int GetProcessedSize() const;
 
@@ -19,6 +19,9 @@ undo memory so as to free up space.
 #include "Audacity.h"
 #include "HistoryWindow.h"
 
+#include <utility>
+#include <vector>
+
 #include <wx/app.h>
 #include <wx/defs.h>
 #include <wx/button.h>
@@ -50,6 +53,59 @@ enum {
    ID_DISCARD_CLIPBOARD
 };
 
+// The list is virtual:  the control asks back for the text, image, and
+// attributes of only the rows it is painting, so opening the window and
+// refreshing it after an edit cost a few dozen widget calls no matter
+// how many undo states the session has accumulated.
+class HistoryList final : public wxListCtrl {
+public:
+   HistoryList(wxWindow *parent)
+   : wxListCtrl{ parent, wxID_ANY, wxDefaultPosition, wxSize(230, 120),
+        wxLC_REPORT | wxLC_HRULES | wxLC_VRULES | wxSUNKEN_BORDER |
+        wxLC_VIRTUAL | wxLC_SINGLE_SEL }
+   {
+      mGreyed.SetTextColour(*wxLIGHT_GREY);
+   }
+
+   // Replace all rows at once.  Sizes may be stale or empty while the
+   // space usage walk is still running in the background.
+   void SetRows(std::vector< std::pair<wxString, wxString> > rows)
+   {
+      mRows.swap(rows);
+      SetItemCount(mRows.size());
+      Refresh(false);
+   }
+
+   // Set which state is current; later rows are the redo states
+   void SetCurrent(long current)
+   {
+      mCurrent = current;
+      Refresh(false);
+   }
+
+private:
+   wxString OnGetItemText(long item, long column) const override
+   {
+      if (item < 0 || item >= (long)mRows.size())
+         return {};
+      return column == 0 ? mRows[item].first : mRows[item].second;
+   }
+
+   int OnGetItemImage(long item) const override
+   {
+      return item == mCurrent ? 1 : 0;
+   }
+
+   wxListItemAttr *OnGetItemAttr(long item) const override
+   {
+      return item > mCurrent ? &mGreyed : nullptr;
+   }
+
+   std::vector< std::pair<wxString, wxString> > mRows;
+   long mCurrent{ -1 };
+   mutable wxListItemAttr mGreyed;
+};
+
 BEGIN_EVENT_TABLE(HistoryWindow, wxDialogWrapper)
    EVT_SIZE(HistoryWindow::OnSize)
    EVT_CLOSE(HistoryWindow::OnCloseWindow)
@@ -83,10 +139,8 @@ HistoryWindow::HistoryWindow(AudacityProject *parent, UndoManager *manager):
    {
       S.StartStatic(_("&Manage History"), 1);
       {
-         mList = S.AddListControlReportMode();
-         // Do this BEFORE inserting the columns.  On the Mac at least, the
-         // columns are deleted and later InsertItem()s will cause Audacity to crash.
-         mList->SetSingleStyle(wxLC_SINGLE_SEL);
+         mList = safenew HistoryList(S.GetParent());
+         S.Prop(1).AddWindow(mList, wxEXPAND);
          mList->InsertColumn(0, _("Action"), wxLIST_FORMAT_LEFT, 260);
          mList->InsertColumn(1, _("Reclaimable Space"), wxLIST_FORMAT_LEFT, 125);
 
@@ -162,6 +216,7 @@ HistoryWindow::HistoryWindow(AudacityProject *parent, UndoManager *manager):
    parent->Bind(EVT_UNDO_MODIFIED, &HistoryWindow::UpdateDisplay, this);
    parent->Bind(EVT_UNDO_OR_REDO, &HistoryWindow::UpdateDisplay, this);
    parent->Bind(EVT_UNDO_RESET, &HistoryWindow::UpdateDisplay, this);
+   parent->Bind(EVT_UNDO_SPACE_USAGE, &HistoryWindow::UpdateDisplay, this);
 }
 
 void HistoryWindow::OnAudioIO(wxCommandEvent& evt)
@@ -192,21 +247,24 @@ bool HistoryWindow::Show( bool show )
 
 void HistoryWindow::DoUpdate()
 {
-   int i;
-
+   // When this returns false the sizes below are stale or zero; a
+   // background walk is under way and EVT_UNDO_SPACE_USAGE brings us
+   // back here when it lands, so the window need not wait for it
    mManager->CalculateSpaceUsage();
 
-   mList->DeleteAllItems();
-
    wxLongLong_t total = 0;
    mSelected = mManager->GetCurrentState() - 1;
-   for (i = 0; i < (int)mManager->GetNumStates(); i++) {
+
+   std::vector< std::pair<wxString, wxString> > rows;
+   rows.reserve(mManager->GetNumStates());
+   for (int i = 0; i < (int)mManager->GetNumStates(); i++) {
       wxString desc, size;
 
       total += mManager->GetLongDescription(i + 1, &desc, &size);
-      mList->InsertItem(i, desc, i == mSelected ? 1 : 0);
-      mList->SetItem(i, 1, size);
+      rows.emplace_back(std::move(desc), std::move(size));
    }
+   mList->SetRows(std::move(rows));
+   mList->SetCurrent(mSelected);
 
    mTotal->SetValue(Internat::FormatSize(total));
 
@@ -258,9 +316,6 @@ void HistoryWindow::OnDiscard(wxCommandEvent & WXUNUSED(event))
    mManager->RemoveStates(i);
    ProjectHistory::Get( *mProject ).SetStateTo(mSelected + 1);
 
-   while(--i >= 0)
-      mList->DeleteItem(i);
-
    DoUpdate();
 }
 
@@ -279,16 +334,10 @@ void HistoryWindow::OnItemSelected(wxListEvent &event)
    }
 
    int selected = event.GetIndex();
-   int i;
-
-   for (i = 0; i < mList->GetItemCount(); i++) {
-      mList->SetItemImage(i, 0);
-      if (i > selected)
-         mList->SetItemTextColour(i, *wxLIGHT_GREY);
-      else
-         mList->SetItemTextColour(i, mList->GetTextColour());
-   }
-   mList->SetItemImage(selected, 1);
+
+   // The arrow and the greying of the redo states follow from this;
+   // the control repaints the visible rows only
+   mList->SetCurrent(selected);
 
    // Do not do a SetStateTo() if we're not actually changing the selected
    // entry.  Doing so can cause unnecessary delays upon initial load or while
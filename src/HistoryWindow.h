@@ -14,11 +14,11 @@
 #include "widgets/wxPanelWrapper.h" // to inherit
 
 class wxButton;
-class wxListCtrl;
 class wxListEvent;
 class wxSpinCtrl;
 class wxTextCtrl;
 class AudacityProject;
+class HistoryList;
 class ShuttleGui;
 class UndoManager;
 
@@ -44,7 +44,7 @@ class HistoryWindow final : public wxDialogWrapper {
 
    AudacityProject   *mProject;
    UndoManager       *mManager;
-   wxListCtrl        *mList;
+   HistoryList       *mList;
    wxTextCtrl        *mTotal;
    wxTextCtrl        *mClipboard;
    wxTextCtrl        *mAvail;
@@ -77,6 +77,61 @@ static void LinearInterpolateAudio(float *buffer, int len,
    }
 }
 
+// Solve the symmetric positive definite Toeplitz system T x = y, where
+// column holds the first column of T, by Levinson recursion.  O(n^2)
+// time and O(n) memory, where general elimination would need O(n^3).
+// Returns false if the recursion degenerates, as it does when T is
+// singular or indefinite.
+static bool SolveToeplitz(const double *column, const double *y,
+                          double *x, size_t n)
+{
+   const double t0 = column[0];
+   if (!(t0 > 0))
+      return false;
+
+   x[0] = y[0] / t0;
+   if (n == 1)
+      return true;
+
+   Doubles r{ n };         // the column, normalized so that r[0] == 1
+   Doubles g{ n };         // the backward (prediction) vector
+   Doubles z{ n };         // scratch for updating g
+   for (size_t i = 1; i < n; i++)
+      r[i] = column[i] / t0;
+
+   double beta = 1.0;
+   double alpha = -r[1];
+   g[0] = alpha;
+
+   for (size_t m = 1; m < n; m++) {
+      beta *= 1.0 - alpha * alpha;
+      if (!(beta > 1e-12))
+         return false;
+
+      double mu = y[m] / t0;
+      for (size_t i = 1; i <= m; i++)
+         mu -= r[i] * x[m - i];
+      mu /= beta;
+      for (size_t i = 0; i < m; i++)
+         x[i] += mu * g[m - 1 - i];
+      x[m] = mu;
+
+      if (m + 1 < n) {
+         alpha = -r[m + 1];
+         for (size_t i = 1; i <= m; i++)
+            alpha -= r[i] * g[m - i];
+         alpha /= beta;
+         for (size_t i = 0; i < m; i++)
+            z[i] = g[i] + alpha * g[m - 1 - i];
+         for (size_t i = 0; i < m; i++)
+            g[i] = z[i];
+         g[m] = alpha;
+      }
+   }
+
+   return true;
+}
+
 // Here's the main interpolate function, using
 // Least Squares AutoRegression (LSAR):
 void InterpolateAudio(float *buffer, const size_t len,
@@ -130,7 +185,8 @@ void InterpolateAudio(float *buffer, const size_t len,
 
    // Solve for the best autoregression coefficients
    // using a least-squares fit to all of the non-bad
-   // data we have in the buffer
+   // data we have in the buffer.  P is at most 50, so
+   // this stays cheap no matter how long the repair is.
    Matrix X(P, P);
    Vector b(P);
 
@@ -154,49 +210,123 @@ void InterpolateAudio(float *buffer, const size_t len,
    // This vector now contains the autoregression coefficients
    const Vector &a = Xinv * b;
 
-   // Create a matrix (a "Toeplitz" matrix, as it turns out)
-   // which encodes the autoregressive relationship between
-   // elements of the sequence.
-   Matrix A(N-P, N);
-   for(size_t row=0; row<N-P; row++) {
-      for(size_t col=0; col<P; col++)
-         A[row][row+col] = -a[col];
-      A[row][row+P] = 1;
+   if (firstBad < P || len - (firstBad + numBad) < P) {
+      // A bad sample lies within P samples of an end of the buffer, so
+      // the normal matrix below would lose its Toeplitz structure at
+      // the edge.  Solve the problem densely, as this function always
+      // used to; it is O(numBad^3)-ish, so keep it to sizes the old
+      // Repair limit allowed.  Bigger gaps jammed against the very end
+      // of the audio have too little context to extrapolate anyway.
+      if (numBad > 256) {
+         LinearInterpolateAudio(buffer, len, firstBad, numBad);
+         return;
+      }
+
+      // Create a matrix (a "Toeplitz" matrix, as it turns out)
+      // which encodes the autoregressive relationship between
+      // elements of the sequence.
+      Matrix A(N-P, N);
+      for(size_t row=0; row<N-P; row++) {
+         for(size_t col=0; col<P; col++)
+            A[row][row+col] = -a[col];
+         A[row][row+P] = 1;
+      }
+
+      // Split both the Toeplitz matrix and the signal into
+      // two pieces.  Note that this code could be made to
+      // work even in the case where the "bad" samples are
+      // not contiguous, but currently it assumes they are.
+      //   "u" is for unknown (bad)
+      //   "k" is for known (good)
+      Matrix Au = MatrixSubset(A, 0, N-P, firstBad, numBad);
+      Matrix A_left = MatrixSubset(A, 0, N-P, 0, firstBad);
+      Matrix A_right = MatrixSubset(A, 0, N-P,
+                                    firstBad+numBad, N-(firstBad+numBad));
+      Matrix Ak = MatrixConcatenateCols(A_left, A_right);
+
+      const Vector &s_left = VectorSubset(s, 0, firstBad);
+      const Vector &s_right = VectorSubset(s, firstBad+numBad,
+                                    N-(firstBad+numBad));
+      const Vector &sk = VectorConcatenate(s_left, s_right);
+
+      // Do some linear algebra to find the best possible
+      // values that fill in the "bad" area
+      Matrix AuT = TransposeMatrix(Au);
+      Matrix X1 = MatrixMultiply(AuT, Au);
+      Matrix X2(X1.Rows(), X1.Cols());
+      if (!InvertMatrix(X1, X2)) {
+         // The matrix is singular!  Fall back on linear...
+         LinearInterpolateAudio(buffer, len, firstBad, numBad);
+         return;
+      }
+      Matrix X2b = X2 * -1.0;
+      Matrix X3 = MatrixMultiply(X2b, AuT);
+      Matrix X4 = MatrixMultiply(X3, Ak);
+      // This vector contains our best guess as to the
+      // unknown values
+      const Vector &su = X4 * sk;
+
+      // Put the results into the return buffer
+      for(size_t i=0; i<numBad; i++)
+         buffer[firstBad+i] = (float)su[i];
+
+      return;
    }
 
-   // Split both the Toeplitz matrix and the signal into
-   // two pieces.  Note that this code could be made to
-   // work even in the case where the "bad" samples are
-   // not contiguous, but currently it assumes they are.
-   //   "u" is for unknown (bad)
-   //   "k" is for known (good)
-   Matrix Au = MatrixSubset(A, 0, N-P, firstBad, numBad);
-   Matrix A_left = MatrixSubset(A, 0, N-P, 0, firstBad);
-   Matrix A_right = MatrixSubset(A, 0, N-P,
-                                 firstBad+numBad, N-(firstBad+numBad));
-   Matrix Ak = MatrixConcatenateCols(A_left, A_right);
-
-   const Vector &s_left = VectorSubset(s, 0, firstBad);
-   const Vector &s_right = VectorSubset(s, firstBad+numBad,
-                                 N-(firstBad+numBad));
-   const Vector &sk = VectorConcatenate(s_left, s_right);
-
-   // Do some linear algebra to find the best possible
-   // values that fill in the "bad" area
-   Matrix AuT = TransposeMatrix(Au);
-   Matrix X1 = MatrixMultiply(AuT, Au);
-   Matrix X2(X1.Rows(), X1.Cols());
-   if (!InvertMatrix(X1, X2)) {
-      // The matrix is singular!  Fall back on linear...
+   // Both margins cover the model order, so no row of the
+   // autoregressive relationship is truncated at an edge.  The
+   // least-squares problem for the bad samples then has normal
+   // equations that are exactly symmetric Toeplitz -- the entries are
+   // the autocorrelation g of the AR polynomial c, banded to width P --
+   // and Levinson recursion solves them without forming any matrix.
+   Doubles c{ P + 1 };
+   for (size_t col = 0; col < P; col++)
+      c[col] = -a[col];
+   c[P] = 1.0;
+
+   Doubles g{ P + 1 };
+   for (size_t k = 0; k <= P; k++) {
+      double sum = 0.0;
+      for (size_t j = 0; j + k <= P; j++)
+         sum += c[j] * c[j + k];
+      g[k] = sum;
+   }
+
+   // Residuals of the rows involving bad samples, with the bad samples
+   // themselves taken as zero
+   const auto nRows = numBad + P;
+   const size_t rowBase = firstBad - P;
+   Doubles f{ nRows };
+   for (size_t j = 0; j < nRows; j++) {
+      const size_t row = rowBase + j;
+      double sum = 0.0;
+      for (size_t t = 0; t <= P; t++) {
+         const size_t idx = row + t;
+         if (idx < firstBad || idx >= firstBad + numBad)
+            sum += c[t] * s[idx];
+      }
+      f[j] = sum;
+   }
+
+   Doubles rhs{ numBad };
+   for (size_t u = 0; u < numBad; u++) {
+      double sum = 0.0;
+      for (size_t d = 0; d <= P; d++)
+         sum += c[d] * f[u + P - d];
+      rhs[u] = -sum;
+   }
+
+   Doubles columnBig{ numBad, true };
+   for (size_t k = 0; k <= P && k < numBad; k++)
+      columnBig[k] = g[k];
+
+   // This vector will contain our best guess as to the unknown values
+   Doubles su{ numBad };
+   if (!SolveToeplitz(columnBig.get(), rhs.get(), su.get(), numBad)) {
+      // The system is singular!  Fall back on linear...
       LinearInterpolateAudio(buffer, len, firstBad, numBad);
       return;
    }
-   Matrix X2b = X2 * -1.0;
-   Matrix X3 = MatrixMultiply(X2b, AuT);
-   Matrix X4 = MatrixMultiply(X3, Ak);
-   // This vector contains our best guess as to the
-   // unknown values
-   const Vector &su = X4 * sk;
 
    // Put the results into the return buffer
    for(size_t i=0; i<numBad; i++)
@@ -90,7 +90,12 @@ void LabelTrack::SetLabel( size_t iLabel, const LabelStruct &newLabel )
       wxASSERT( false );
       mLabels.resize( iLabel + 1 );
    }
+   // A changed title makes the cached text width stale, even though the
+   // NEW label may carry a width copied from the old one
+   const bool titleChanged = ( newLabel.title != mLabels[ iLabel ].title );
    mLabels[ iLabel ] = newLabel;
+   if ( titleChanged )
+      mLabels[ iLabel ].widthVersion = 0;
 }
 
 LabelTrack::~LabelTrack()
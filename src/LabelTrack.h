@@ -71,6 +71,8 @@ public:
    SelectedRegion selectedRegion;
    wxString title; /// Text of the label.
    mutable int width{}; /// width of the text in pixels.
+   mutable int widthVersion{ 0 }; /// font version for which width is valid;
+                                  /// 0 means not yet measured
 
 // Working storage for on-screen layout.
    mutable int x{};     /// Pixel position of left hand glyph
@@ -26,6 +26,9 @@
 
 #include <math.h>
 
+#include <atomic>
+#include <thread>
+
 #include <wx/textctrl.h>
 #include <wx/progdlg.h>
 #include <wx/timer.h>
@@ -151,6 +154,8 @@ void MixAndRender(TrackList *tracks, TrackFactory *trackFactory,
       Mixer::WarpOptions(timeTrack ? timeTrack->GetEnvelope() : nullptr),
       startTime, endTime, mono ? 1 : 2, maxBlockLen, false,
       rate, format);
+   // Offline, so let the mixer use all cores
+   mixer.SetNumWorkers( std::thread::hardware_concurrency() );
 
    ::wxSafeYield();
 
@@ -205,6 +210,96 @@ void MixAndRender(TrackList *tracks, TrackFactory *trackFactory,
    }
 }
 
+void MixAndRenderTrackGroup(const WaveTrack *leader, TrackFactory *trackFactory,
+                  double rate, sampleFormat format,
+                  WaveTrack::Holder &uLeft, WaveTrack::Holder &uRight)
+{
+   uLeft.reset(), uRight.reset();
+
+   const auto channels = TrackList::Channels(leader);
+   const bool mono = (channels.size() == 1);
+
+   WaveTrackConstArray waveArray;
+   double mixStartTime = leader->GetStartTime();
+   double mixEndTime = leader->GetEndTime();
+   for (auto wt : channels) {
+      waveArray.push_back( wt->SharedPointer< const WaveTrack >() );
+      if (wt->GetStartTime() < mixStartTime)
+         mixStartTime = wt->GetStartTime();
+      if (wt->GetEndTime() > mixEndTime)
+         mixEndTime = wt->GetEndTime();
+   }
+
+   if (mixStartTime >= mixEndTime)
+      // Empty group; nothing to render
+      return;
+
+   auto mixLeft = trackFactory->NewWaveTrack(format, rate);
+   mixLeft->SetName(leader->GetName());
+   mixLeft->SetOffset(mixStartTime);
+
+   decltype(mixLeft) mixRight{};
+   if ( !mono ) {
+      mixRight = trackFactory->NewWaveTrack(format, rate);
+      mixRight->SetName((*channels.begin().advance(1))->GetName());
+      mixRight->SetOffset(mixStartTime);
+   }
+
+   auto maxBlockLen = mixLeft->GetIdealBlockSize();
+
+   Mixer mixer(waveArray,
+      // Throw to abort the render if read fails:
+      true,
+      // Deliberately no time track warp; see the comment in Mix.h
+      Mixer::WarpOptions( nullptr ),
+      mixStartTime, mixEndTime, mono ? 1 : 2, maxBlockLen, false,
+      rate, format);
+   // Gain and pan stay live on the original track
+   mixer.ApplyTrackGains(false);
+   // Offline, so let the mixer use all cores
+   mixer.SetNumWorkers( std::thread::hardware_concurrency() );
+
+   ::wxSafeYield();
+
+   auto updateResult = ProgressResult::Success;
+   {
+      ProgressDialog progress(_("Freeze"),
+         _("Rendering track"));
+
+      while (updateResult == ProgressResult::Success) {
+         auto blockLen = mixer.Process(maxBlockLen);
+
+         if (blockLen == 0)
+            break;
+
+         if (mono) {
+            samplePtr buffer = mixer.GetBuffer();
+            mixLeft->Append(buffer, format, blockLen);
+         }
+         else {
+            samplePtr buffer;
+            buffer = mixer.GetBuffer(0);
+            mixLeft->Append(buffer, format, blockLen);
+            buffer = mixer.GetBuffer(1);
+            mixRight->Append(buffer, format, blockLen);
+         }
+
+         updateResult = progress.Update(
+            mixer.MixGetCurrentTime() - mixStartTime,
+            mixEndTime - mixStartTime);
+      }
+   }
+
+   mixLeft->Flush();
+   if (!mono)
+      mixRight->Flush();
+   if (updateResult == ProgressResult::Cancelled ||
+       updateResult == ProgressResult::Failed)
+      return;
+   else
+      uLeft = mixLeft, uRight = mixRight;
+}
+
 Mixer::WarpOptions::WarpOptions(double min, double max)
    : minSpeed(min), maxSpeed(max)
 {
@@ -256,6 +351,10 @@ Mixer::Mixer(const WaveTrackConstArray &inputTracks,
       mSamplePos[i] = inputTracks[i]->TimeToLongSamples(startTime);
    }
    mEnvelope = warpOptions.envelope;
+   if (mEnvelope)
+      // Mixers are constructed on the main thread; build the warp memo
+      // table now, before buffer-filling workers start querying it
+      mEnvelope->PrepareInverseIntegralTable();
    mT0 = startTime;
    mT1 = stopTime;
    mTime = startTime;
@@ -337,8 +436,18 @@ Mixer::~Mixer()
 
 void Mixer::MakeResamplers()
 {
-   for (size_t i = 0; i < mNumInputTracks; i++)
-      mResample[i] = std::make_unique<Resample>(mHighQuality, mMinFactor[i], mMaxFactor[i]);
+   // Building a Resample sets up libsoxr filter tables, which is not cheap
+   // at the best-quality settings, and this runs again on every Restart()
+   // and skipping Reposition().  Only the tracks that really resample get
+   // an instance -- the test here matches the one in ProcessTrack() -- so
+   // the common session with all tracks at the project rate builds nothing.
+   for (size_t i = 0; i < mNumInputTracks; i++) {
+      if (mbVariableRates || mInputTrack[i].GetTrack()->GetRate() != mRate)
+         mResample[i] = std::make_unique<Resample>(
+            mHighQuality, mMinFactor[i], mMaxFactor[i]);
+      else
+         mResample[i].reset();
+   }
 }
 
 void Mixer::ApplyTrackGains(bool apply)
@@ -353,31 +462,131 @@ void Mixer::Clear()
    }
 }
 
+// Vectorized kernels for the hot inner loops of mixdown.  Which
+// instruction set is used follows from the compiler's target flags;
+// everything falls back to the portable loops below on other targets.
+#if defined(__AVX__)
+   #include <immintrin.h>
+   #define MIX_BUFFERS_VECTOR_SSE 1
+#elif defined(__SSE2__) || defined(_M_X64) || \
+   (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+   #include <emmintrin.h>
+   #define MIX_BUFFERS_VECTOR_SSE 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+   #include <arm_neon.h>
+   #define MIX_BUFFERS_VECTOR_NEON 1
+#endif
+
+namespace {
+
+// dest[j] += src[j] * gain
+inline void MixAccumulate(const float *src, float *dest, float gain, int len)
+{
+   int j = 0;
+#if defined(__AVX__)
+   const __m256 vGain = _mm256_set1_ps(gain);
+   for (; j + 8 <= len; j += 8)
+      _mm256_storeu_ps(dest + j, _mm256_add_ps(_mm256_loadu_ps(dest + j),
+         _mm256_mul_ps(_mm256_loadu_ps(src + j), vGain)));
+#elif defined(MIX_BUFFERS_VECTOR_SSE)
+   const __m128 vGain = _mm_set1_ps(gain);
+   for (; j + 4 <= len; j += 4)
+      _mm_storeu_ps(dest + j, _mm_add_ps(_mm_loadu_ps(dest + j),
+         _mm_mul_ps(_mm_loadu_ps(src + j), vGain)));
+#elif defined(MIX_BUFFERS_VECTOR_NEON)
+   const float32x4_t vGain = vdupq_n_f32(gain);
+   for (; j + 4 <= len; j += 4)
+      vst1q_f32(dest + j,
+         vmlaq_f32(vld1q_f32(dest + j), vld1q_f32(src + j), vGain));
+#endif
+   for (; j < len; ++j)
+      dest[j] += src[j] * gain;
+}
+
+// dest[j] += src[j], the common unity-gain case
+inline void AddAccumulate(const float *src, float *dest, int len)
+{
+   int j = 0;
+#if defined(__AVX__)
+   for (; j + 8 <= len; j += 8)
+      _mm256_storeu_ps(dest + j, _mm256_add_ps(_mm256_loadu_ps(dest + j),
+         _mm256_loadu_ps(src + j)));
+#elif defined(MIX_BUFFERS_VECTOR_SSE)
+   for (; j + 4 <= len; j += 4)
+      _mm_storeu_ps(dest + j,
+         _mm_add_ps(_mm_loadu_ps(dest + j), _mm_loadu_ps(src + j)));
+#elif defined(MIX_BUFFERS_VECTOR_NEON)
+   for (; j + 4 <= len; j += 4)
+      vst1q_f32(dest + j, vaddq_f32(vld1q_f32(dest + j), vld1q_f32(src + j)));
+#endif
+   for (; j < len; ++j)
+      dest[j] += src[j];
+}
+
+// dest[2 * j] += src[j] * gain -- one channel of the interleaved stereo
+// output that playback uses.  The zero lanes leave the other channel alone.
+inline void MixAccumulateStereo(
+   const float *src, float *dest, float gain, int len)
+{
+   int j = 0;
+#if defined(MIX_BUFFERS_VECTOR_SSE)
+   const __m128 vGain = _mm_set1_ps(gain);
+   const __m128 vZero = _mm_setzero_ps();
+   for (; j + 4 <= len; j += 4) {
+      const __m128 scaled = _mm_mul_ps(_mm_loadu_ps(src + j), vGain);
+      float *lo = dest + 2 * j;
+      _mm_storeu_ps(lo, _mm_add_ps(_mm_loadu_ps(lo),
+         _mm_unpacklo_ps(scaled, vZero)));
+      _mm_storeu_ps(lo + 4, _mm_add_ps(_mm_loadu_ps(lo + 4),
+         _mm_unpackhi_ps(scaled, vZero)));
+   }
+#elif defined(MIX_BUFFERS_VECTOR_NEON)
+   const float32x4_t vGain = vdupq_n_f32(gain);
+   const float32x4_t vZero = vdupq_n_f32(0.0f);
+   for (; j + 4 <= len; j += 4) {
+      const float32x4_t scaled = vmulq_f32(vld1q_f32(src + j), vGain);
+      const float32x4x2_t zipped = vzipq_f32(scaled, vZero);
+      float *lo = dest + 2 * j;
+      vst1q_f32(lo, vaddq_f32(vld1q_f32(lo), zipped.val[0]));
+      vst1q_f32(lo + 4, vaddq_f32(vld1q_f32(lo + 4), zipped.val[1]));
+   }
+#endif
+   for (; j < len; ++j)
+      dest[2 * j] += src[j] * gain;
+}
+
+}
+
 void MixBuffers(unsigned numChannels, int *channelFlags, float *gains,
                 samplePtr src, SampleBuffer *dests,
                 int len, bool interleaved)
 {
+   const float *temp = (const float *)src;
    for (unsigned int c = 0; c < numChannels; c++) {
       if (!channelFlags[c])
          continue;
 
-      samplePtr destPtr;
-      unsigned skip;
-
-      if (interleaved) {
-         destPtr = dests[0].ptr() + c*SAMPLE_SIZE(floatSample);
-         skip = numChannels;
-      } else {
-         destPtr = dests[c].ptr();
-         skip = 1;
+      const float gain = gains[c];
+      if (!interleaved) {
+         // Contiguous destination: plain gain-multiply-accumulate, with a
+         // faster path when the gain is unity
+         float *dest = (float *)dests[c].ptr();
+         if (gain == 1.0f)
+            AddAccumulate(temp, dest, len);
+         else
+            MixAccumulate(temp, dest, gain, len);
       }
-
-      float gain = gains[c];
-      float *dest = (float *)destPtr;
-      float *temp = (float *)src;
-      for (int j = 0; j < len; j++) {
-         *dest += temp[j] * gain;   // the actual mixing process
-         dest += skip;
+      else if (numChannels == 2) {
+         // Stereo interleaved, the playback case
+         float *dest = (float *)dests[0].ptr() + c;
+         MixAccumulateStereo(temp, dest, gain, len);
+      }
+      else {
+         float *dest = (float *)dests[0].ptr() + c;
+         for (int j = 0; j < len; j++) {
+            *dest += temp[j] * gain;   // the actual mixing process
+            dest += numChannels;
+         }
       }
    }
 }
@@ -397,7 +606,10 @@ namespace {
     */
 double ComputeWarpFactor(const Envelope &env, double t0, double t1)
 {
-   return env.AverageOfInverse(t0, t1);
+   // Called once per mixing chunk of every track during varispeed
+   // playback, so use the envelope's precomputed cumulative table
+   // rather than integrating over the points again each time
+   return env.IntegralOfInverseCached(t0, t1) / (t1 - t0);
 }
 
 }
@@ -405,7 +617,9 @@ double ComputeWarpFactor(const Envelope &env, double t0, double t1)
 size_t Mixer::MixVariableRates(int *channelFlags, WaveTrackCache &cache,
                                     sampleCount *pos, float *queue,
                                     int *queueStart, int *queueLen,
-                                    Resample * pResample)
+                                    Resample * pResample,
+                                    float *floatBuffer, double *envValues,
+                                    float *gains, SampleBuffer *temp)
 {
    const WaveTrack *const track = cache.GetTrack().get();
    const double trackRate = track->GetRate();
@@ -458,7 +672,7 @@ size_t Mixer::MixVariableRates(int *channelFlags, WaveTrackCache &cache,
                else
                   memset(&queue[*queueLen], 0, sizeof(float) * getLen);
 
-               track->GetEnvelopeValues(mEnvValues.get(),
+               track->GetEnvelopeValues(envValues,
                                         getLen,
                                         (*pos - (getLen- 1)).as_double() / trackRate);
                *pos -= getLen;
@@ -470,7 +684,7 @@ size_t Mixer::MixVariableRates(int *channelFlags, WaveTrackCache &cache,
                else
                   memset(&queue[*queueLen], 0, sizeof(float) * getLen);
 
-               track->GetEnvelopeValues(mEnvValues.get(),
+               track->GetEnvelopeValues(envValues,
                                         getLen,
                                         (*pos).as_double() / trackRate);
 
@@ -478,7 +692,7 @@ size_t Mixer::MixVariableRates(int *channelFlags, WaveTrackCache &cache,
             }
 
             for (decltype(getLen) i = 0; i < getLen; i++) {
-               queue[(*queueLen) + i] *= mEnvValues[i];
+               queue[(*queueLen) + i] *= envValues[i];
             }
 
             if (backwards)
@@ -515,7 +729,7 @@ size_t Mixer::MixVariableRates(int *channelFlags, WaveTrackCache &cache,
                                       &queue[*queueStart],
                                       thisProcessLen,
                                       last,
-                                      &mFloatBuffer[out],
+                                      &floatBuffer[out],
                                       mMaxOut - out);
 
       const auto input_used = results.first;
@@ -531,18 +745,18 @@ size_t Mixer::MixVariableRates(int *channelFlags, WaveTrackCache &cache,
 
    for (size_t c = 0; c < mNumChannels; c++) {
       if (mApplyTrackGains) {
-         mGains[c] = track->GetChannelGain(c);
+         gains[c] = track->GetChannelGain(c);
       }
       else {
-         mGains[c] = 1.0;
+         gains[c] = 1.0;
       }
    }
 
    MixBuffers(mNumChannels,
               channelFlags,
-              mGains.get(),
-              (samplePtr)mFloatBuffer.get(),
-              mTemp.get(),
+              gains,
+              (samplePtr)floatBuffer,
+              temp,
               out,
               mInterleaved);
 
@@ -550,7 +764,9 @@ size_t Mixer::MixVariableRates(int *channelFlags, WaveTrackCache &cache,
 }
 
 size_t Mixer::MixSameRate(int *channelFlags, WaveTrackCache &cache,
-                               sampleCount *pos)
+                               sampleCount *pos,
+                               float *floatBuffer, double *envValues,
+                               float *gains, SampleBuffer *temp)
 {
    const WaveTrack *const track = cache.GetTrack().get();
    const double t = ( *pos ).as_double() / track->GetRate();
@@ -576,41 +792,122 @@ size_t Mixer::MixSameRate(int *channelFlags, WaveTrackCache &cache,
    if (backwards) {
       auto results = cache.Get(floatSample, *pos - (slen - 1), slen, mMayThrow);
       if (results)
-         memcpy(mFloatBuffer.get(), results, sizeof(float) * slen);
+         memcpy(floatBuffer, results, sizeof(float) * slen);
       else
-         memset(mFloatBuffer.get(), 0, sizeof(float) * slen);
-      track->GetEnvelopeValues(mEnvValues.get(), slen, t - (slen - 1) / mRate);
+         memset(floatBuffer, 0, sizeof(float) * slen);
+      track->GetEnvelopeValues(envValues, slen, t - (slen - 1) / mRate);
       for(decltype(slen) i = 0; i < slen; i++)
-         mFloatBuffer[i] *= mEnvValues[i]; // Track gain control will go here?
-      ReverseSamples((samplePtr)mFloatBuffer.get(), floatSample, 0, slen);
+         floatBuffer[i] *= envValues[i]; // Track gain control will go here?
+      ReverseSamples((samplePtr)floatBuffer, floatSample, 0, slen);
 
       *pos -= slen;
    }
    else {
       auto results = cache.Get(floatSample, *pos, slen, mMayThrow);
       if (results)
-         memcpy(mFloatBuffer.get(), results, sizeof(float) * slen);
+         memcpy(floatBuffer, results, sizeof(float) * slen);
       else
-         memset(mFloatBuffer.get(), 0, sizeof(float) * slen);
-      track->GetEnvelopeValues(mEnvValues.get(), slen, t);
+         memset(floatBuffer, 0, sizeof(float) * slen);
+      track->GetEnvelopeValues(envValues, slen, t);
       for(decltype(slen) i = 0; i < slen; i++)
-         mFloatBuffer[i] *= mEnvValues[i]; // Track gain control will go here?
+         floatBuffer[i] *= envValues[i]; // Track gain control will go here?
 
       *pos += slen;
    }
 
    for(size_t c=0; c<mNumChannels; c++)
       if (mApplyTrackGains)
-         mGains[c] = track->GetChannelGain(c);
+         gains[c] = track->GetChannelGain(c);
       else
-         mGains[c] = 1.0;
+         gains[c] = 1.0;
 
-   MixBuffers(mNumChannels, channelFlags, mGains.get(),
-              (samplePtr)mFloatBuffer.get(), mTemp.get(), slen, mInterleaved);
+   MixBuffers(mNumChannels, channelFlags, gains,
+              (samplePtr)floatBuffer, temp, slen, mInterleaved);
 
    return slen;
 }
 
+// One worker's private scratch space and accumulation buffers, sized like
+// the Mixer's own
+struct Mixer::Scratch
+{
+   explicit Scratch( const Mixer &mixer )
+      : floatBuffer{ mixer.mInterleavedBufferSize }
+      , envValues{ std::max( mixer.mQueueMaxLen,
+           mixer.mInterleavedBufferSize ) }
+      , gains{ mixer.mNumChannels }
+      , numBuffers{ mixer.mNumBuffers }
+      , bufferSize{ mixer.mInterleavedBufferSize }
+   {
+      temp.reinit( numBuffers );
+      for (unsigned int c = 0; c < numBuffers; c++)
+         temp[c].Allocate( bufferSize, floatSample );
+   }
+
+   void Clear()
+   {
+      for (unsigned int c = 0; c < numBuffers; c++)
+         memset( temp[c].ptr(), 0, bufferSize * SAMPLE_SIZE(floatSample) );
+   }
+
+   Floats floatBuffer;
+   Doubles envValues;
+   Floats gains;
+   ArrayOf<SampleBuffer> temp;
+   unsigned numBuffers;
+   size_t bufferSize;
+};
+
+void Mixer::SetNumWorkers(unsigned numWorkers)
+{
+   numWorkers = std::max( 1u, numWorkers );
+   mWorkerScratch.clear();
+   if (numWorkers > 1)
+      for (unsigned w = 0; w < numWorkers; ++w)
+         mWorkerScratch.push_back( std::make_unique<Scratch>( *this ) );
+   mNumWorkers = numWorkers;
+}
+
+size_t Mixer::ProcessTrack(size_t i, int *channelFlags, float *floatBuffer,
+   double *envValues, float *gains, SampleBuffer *temp)
+{
+   const WaveTrack *const track = mInputTrack[i].GetTrack().get();
+   for(size_t j=0; j<mNumChannels; j++)
+      channelFlags[j] = 0;
+
+   if( mMixerSpec ) {
+      //ignore left and right when downmixing is not required
+      for(size_t j = 0; j < mNumChannels; j++ )
+         channelFlags[ j ] = mMixerSpec->mMap[ i ][ j ] ? 1 : 0;
+   }
+   else {
+      switch(track->GetChannel()) {
+      case Track::MonoChannel:
+      default:
+         for(size_t j=0; j<mNumChannels; j++)
+            channelFlags[j] = 1;
+         break;
+      case Track::LeftChannel:
+         channelFlags[0] = 1;
+         break;
+      case Track::RightChannel:
+         if (mNumChannels >= 2)
+            channelFlags[1] = 1;
+         else
+            channelFlags[0] = 1;
+         break;
+      }
+   }
+   if (mbVariableRates || track->GetRate() != mRate)
+      return MixVariableRates(channelFlags, mInputTrack[i],
+         &mSamplePos[i], mSampleQueue[i].get(),
+         &mQueueStart[i], &mQueueLen[i], mResample[i].get(),
+         floatBuffer, envValues, gains, temp);
+   else
+      return MixSameRate(channelFlags, mInputTrack[i], &mSamplePos[i],
+         floatBuffer, envValues, gains, temp);
+}
+
 size_t Mixer::Process(size_t maxToProcess)
 {
    // MB: this is wrong! mT represented warped time, and mTime is too inaccurate to use
@@ -619,48 +916,54 @@ size_t Mixer::Process(size_t maxToProcess)
    //   return 0;
 
    decltype(Process(0)) maxOut = 0;
-   ArrayOf<int> channelFlags{ mNumChannels };
 
    mMaxOut = maxToProcess;
 
    Clear();
-   for(size_t i=0; i<mNumInputTracks; i++) {
-      const WaveTrack *const track = mInputTrack[i].GetTrack().get();
-      for(size_t j=0; j<mNumChannels; j++)
-         channelFlags[j] = 0;
-
-      if( mMixerSpec ) {
-         //ignore left and right when downmixing is not required
-         for(size_t j = 0; j < mNumChannels; j++ )
-            channelFlags[ j ] = mMixerSpec->mMap[ i ][ j ] ? 1 : 0;
-      }
-      else {
-         switch(track->GetChannel()) {
-         case Track::MonoChannel:
-         default:
-            for(size_t j=0; j<mNumChannels; j++)
-               channelFlags[j] = 1;
-            break;
-         case Track::LeftChannel:
-            channelFlags[0] = 1;
-            break;
-         case Track::RightChannel:
-            if (mNumChannels >= 2)
-               channelFlags[1] = 1;
-            else
-               channelFlags[0] = 1;
-            break;
-         }
+   const auto numWorkers =
+      std::min<size_t>(std::max(1u, mNumWorkers), mNumInputTracks);
+   if (numWorkers > 1) {
+      // Offline mixing:  workers steal the next unprocessed track from a
+      // shared counter and mix it into their own accumulation buffers,
+      // which are afterwards reduced into mTemp
+      std::atomic<size_t> nextTrack{ 0 };
+      std::vector<size_t> outs( numWorkers, 0 );
+      const auto work = [&]( size_t w ){
+         auto &scratch = *mWorkerScratch[w];
+         scratch.Clear();
+         ArrayOf<int> channelFlags{ mNumChannels };
+         for ( auto i = nextTrack.fetch_add( 1 ); i < mNumInputTracks;
+               i = nextTrack.fetch_add( 1 ) )
+            outs[w] = std::max( outs[w],
+               ProcessTrack( i, channelFlags.get(),
+                  scratch.floatBuffer.get(), scratch.envValues.get(),
+                  scratch.gains.get(), scratch.temp.get() ) );
+      };
+      std::vector<std::thread> threads;
+      for (size_t w = 1; w < numWorkers; ++w)
+         threads.emplace_back( work, w );
+      work( 0 );
+      for (auto &thread : threads)
+         thread.join();
+
+      for (size_t w = 0; w < numWorkers; ++w) {
+         maxOut = std::max( maxOut, outs[w] );
+         for (unsigned int c = 0; c < mNumBuffers; c++)
+            AddAccumulate( (const float *)mWorkerScratch[w]->temp[c].ptr(),
+               (float *)mTemp[c].ptr(),
+               mInterleaved ? outs[w] * mNumChannels : outs[w] );
       }
-      if (mbVariableRates || track->GetRate() != mRate)
-         maxOut = std::max(maxOut,
-            MixVariableRates(channelFlags.get(), mInputTrack[i],
-               &mSamplePos[i], mSampleQueue[i].get(),
-               &mQueueStart[i], &mQueueLen[i], mResample[i].get()));
-      else
-         maxOut = std::max(maxOut,
-            MixSameRate(channelFlags.get(), mInputTrack[i], &mSamplePos[i]));
+   }
+   else {
+      ArrayOf<int> channelFlags{ mNumChannels };
+      for(size_t i=0; i<mNumInputTracks; i++)
+         maxOut = std::max( maxOut,
+            ProcessTrack( i, channelFlags.get(), mFloatBuffer.get(),
+               mEnvValues.get(), mGains.get(), mTemp.get() ) );
+   }
 
+   for(size_t i=0; i<mNumInputTracks; i++) {
+      const WaveTrack *const track = mInputTrack[i].GetTrack().get();
       double t = mSamplePos[i].as_double() / (double)track->GetRate();
       if (mT0 > mT1)
          // backwards (as possibly in scrubbing)
@@ -50,6 +50,19 @@ void MixAndRender(TrackList * tracks, TrackFactory *factory,
                   std::shared_ptr<WaveTrack> &uLeft,
                   std::shared_ptr<WaveTrack> &uRight);
 
+/** @brief Renders one channel group (a mono track or a linked stereo pair)
+ * through its clips and per-clip envelopes into new tracks.
+ *
+ * Unlike MixAndRender, gain, pan, mute and solo are NOT baked into the
+ * result, and no time track warping is applied; the output is the track's
+ * own audible content only, so that those controls can still be varied
+ * live against the rendered copy.  Used by track freezing.
+ */
+void MixAndRenderTrackGroup(const WaveTrack *leader, TrackFactory *factory,
+                  double rate, sampleFormat format,
+                  std::shared_ptr<WaveTrack> &uLeft,
+                  std::shared_ptr<WaveTrack> &uRight);
+
 void MixBuffers(unsigned numChannels, int *channelFlags, float *gains,
                 samplePtr src,
                 samplePtr *dests, int len, bool interleaved);
@@ -124,6 +137,12 @@ class AUDACITY_DLL_API Mixer {
    /// more samples that must be processed.
    size_t Process(size_t maxSamples);
 
+   /// Use up to the given number of worker threads inside Process(), each
+   /// mixing a share of the input tracks into private accumulation buffers
+   /// that are then reduced.  Meant for offline mixing (Mix and Render,
+   /// export); the realtime path keeps the default of one.
+   void SetNumWorkers(unsigned numWorkers);
+
    /// Restart processing at beginning of buffer next time
    /// Process() is called.
    void Restart();
@@ -149,12 +168,22 @@ class AUDACITY_DLL_API Mixer {
 
    void Clear();
    size_t MixSameRate(int *channelFlags, WaveTrackCache &cache,
-                           sampleCount *pos);
+                           sampleCount *pos,
+                           float *floatBuffer, double *envValues,
+                           float *gains, SampleBuffer *temp);
 
    size_t MixVariableRates(int *channelFlags, WaveTrackCache &cache,
                                 sampleCount *pos, float *queue,
                                 int *queueStart, int *queueLen,
-                                Resample * pResample);
+                                Resample * pResample,
+                                float *floatBuffer, double *envValues,
+                                float *gains, SampleBuffer *temp);
+
+   // Mix one input track into the given accumulation buffers, using the
+   // given scratch space
+   size_t ProcessTrack(size_t i, int *channelFlags, float *floatBuffer,
+                           double *envValues, float *gains,
+                           SampleBuffer *temp);
 
    void MakeResamplers();
 
@@ -195,6 +224,11 @@ class AUDACITY_DLL_API Mixer {
    bool             mHighQuality;
    std::vector<double> mMinFactor, mMaxFactor;
 
+   // Parallel processing of input tracks, for offline mixing only
+   struct Scratch;
+   std::vector<std::unique_ptr<Scratch>> mWorkerScratch;
+   unsigned         mNumWorkers{ 1 };
+
    bool             mMayThrow;
 };
 
@@ -504,7 +504,8 @@ void MixerTrackCluster::UpdateForStateChange()
 #endif
 }
 
-void MixerTrackCluster::UpdateMeter(const double t0, const double t1)
+void MixerTrackCluster::UpdateMeter(const double t0, const double t1,
+   std::vector<float> &readScratch, std::vector<float> &meterScratch)
 {
    // NoteTracks do not (currently) register on meters. It would probably be
    // a good idea to display 16 channel "active" lights rather than a meter
@@ -603,56 +604,68 @@ void MixerTrackCluster::UpdateMeter(const double t0, const double t1)
    // in about 1/20 second (ticks of TrackPanel timer), so this won't overflow
    auto nFrames = scnFrames.as_size_t();
 
-   Floats tempFloatsArray{ nFrames };
-   decltype(tempFloatsArray) meterFloatsArray;
+   // The scratch buffers belong to the whole MixerBoard and only grow, so
+   // repeated ticks cost no allocations at all once every strip has been
+   // visited once
+   if (readScratch.size() < nFrames)
+      readScratch.resize(nFrames);
+   if (meterScratch.size() < 2 * nFrames)
+      meterScratch.resize(2 * nFrames);
+
    // Don't throw on read error in this drawing update routine
-   bool bSuccess = pTrack->Get((samplePtr)tempFloatsArray.get(),
+   bool bSuccess = pTrack->Get((samplePtr)readScratch.data(),
       floatSample, startSample, nFrames, fillZero, false);
+
+   //const bool bWantPostFadeValues = true; //v Turn this into a checkbox on MixerBoard? For now, always true.
+   //if (bSuccess && bWantPostFadeValues)
    if (bSuccess)
    {
       // We always pass a stereo sample array to the meter, as it shows 2 channels.
       // Mono shows same in both meters.
       // Since we're not mixing, need to duplicate same signal for "right" channel in mono case.
-      meterFloatsArray = Floats{ 2 * nFrames };
-
-      // Interleave for stereo. Left/mono first.
+      //vvv Need to apply envelope, too? See Mixer::MixSameRate.
+      // Interleave for stereo, apply the channel gain and clip to the
+      // [-1.0, 1.0] range, all in one pass over the samples.
+      // Left/mono first.
+      float gain = pTrack->GetChannelGain(0);
       for (unsigned int index = 0; index < nFrames; index++)
-         meterFloatsArray[2 * index] = tempFloatsArray[index];
+      {
+         float sample = readScratch[index] * gain;
+         if (sample < -1.0)
+            sample = -1.0;
+         else if (sample > 1.0)
+            sample = 1.0;
+         meterScratch[2 * index] = sample;
+      }
 
       if (GetRight())
          // Again, don't throw
-         bSuccess = GetRight()->Get((samplePtr)tempFloatsArray.get(),
+         bSuccess = GetRight()->Get((samplePtr)readScratch.data(),
             floatSample, startSample, nFrames, fillZero, false);
 
       if (bSuccess)
-         // Interleave right channel, or duplicate same signal for "right" channel in mono case.
+      {
+         // Right channel, or the same signal again in the mono case.
+         if (GetRight())
+            gain = GetRight()->GetChannelGain(1);
+         else
+            gain = pTrack->GetChannelGain(1);
          for (unsigned int index = 0; index < nFrames; index++)
-            meterFloatsArray[(2 * index) + 1] = tempFloatsArray[index];
+         {
+            float sample = readScratch[index] * gain;
+            if (sample < -1.0)
+               sample = -1.0;
+            else if (sample > 1.0)
+               sample = 1.0;
+            meterScratch[(2 * index) + 1] = sample;
+         }
+      }
    }
 
-   //const bool bWantPostFadeValues = true; //v Turn this into a checkbox on MixerBoard? For now, always true.
-   //if (bSuccess && bWantPostFadeValues)
    if (bSuccess)
    {
-      //vvv Need to apply envelope, too? See Mixer::MixSameRate.
-      float gain = pTrack->GetChannelGain(0);
-      for (unsigned int index = 0; index < nFrames; index++)
-         meterFloatsArray[2 * index] *= gain;
-      if (GetRight())
-         gain = GetRight()->GetChannelGain(1);
-      else
-         gain = pTrack->GetChannelGain(1);
-      for (unsigned int index = 0; index < nFrames; index++)
-         meterFloatsArray[(2 * index) + 1] *= gain;
-      // Clip to [-1.0, 1.0] range.
-      for (unsigned int index = 0; index < 2 * nFrames; index++)
-         if (meterFloatsArray[index] < -1.0)
-            meterFloatsArray[index] = -1.0;
-         else if (meterFloatsArray[index] > 1.0)
-            meterFloatsArray[index] = 1.0;
-
       if (mMeter)
-         mMeter->UpdateDisplay(2, nFrames, meterFloatsArray.get());
+         mMeter->UpdateDisplay(2, nFrames, meterScratch.data());
    }
    else
       this->ResetMeter(false);
@@ -1163,7 +1176,8 @@ void MixerBoard::UpdateMeters(const double t1, const bool bLoopedPlay)
    }
 
    for (unsigned int i = 0; i < mMixerTrackClusters.size(); i++)
-      mMixerTrackClusters[i]->UpdateMeter(mPrevT1, t1);
+      mMixerTrackClusters[i]->UpdateMeter(mPrevT1, t1,
+         mMeterReadScratch, mMeterInterleavedScratch);
 
    mPrevT1 = t1;
 }
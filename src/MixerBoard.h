@@ -14,6 +14,8 @@
 #ifndef __AUDACITY_MIXER_BOARD__
 #define __AUDACITY_MIXER_BOARD__
 
+#include <vector>
+
 #include <wx/frame.h> // to inherit
 #include <wx/scrolwin.h> // to inherit
 
@@ -101,7 +103,8 @@ public:
    void ResetMeter(const bool bResetClipping);
 
    void UpdateForStateChange();
-   void UpdateMeter(const double t0, const double t1);
+   void UpdateMeter(const double t0, const double t1,
+      std::vector<float> &readScratch, std::vector<float> &meterScratch);
 
 private:
    wxColour GetTrackColor();
@@ -257,6 +260,12 @@ private:
    TrackList*                 mTracks;
    bool                       mUpToDate{ false };
 
+   // Scratch buffers for meter updates, shared by all the clusters so that
+   // one timer tick costs at most one pair of allocations, however many
+   // strips are shown.
+   std::vector<float>         mMeterReadScratch;
+   std::vector<float>         mMeterInterleavedScratch;
+
 public:
    DECLARE_EVENT_TABLE()
 };
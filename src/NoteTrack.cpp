@@ -26,6 +26,7 @@
 #include <wx/intl.h>
 
 #if defined(USE_MIDI)
+#include <algorithm>
 #include <sstream>
 
 #define ROUND(x) ((int) ((x) + 0.5))
@@ -160,6 +161,57 @@ Alg_seq &NoteTrack::GetSeq() const
    return *mSeq;
 }
 
+void NoteIndex::Rebuild(Alg_seq &seq)
+{
+   mEntries.clear();
+   mMaxDur = 0.0;
+
+   Alg_iterator iterator(&seq, false);
+   iterator.begin();
+   Alg_event_ptr evt;
+   while (0 != (evt = iterator.next())) {
+      if (evt->get_type() == 'n') {
+         Alg_note_ptr note = (Alg_note_ptr) evt;
+         const double dur = note->dur;
+         mEntries.push_back(Entry{ note->time, note->time + dur, note });
+         mMaxDur = std::max(mMaxDur, dur);
+      }
+   }
+   iterator.end();
+
+   // The iterator merges the sorted tracks of the sequence, so entries
+   // arrive already in time order; sorting anyway costs little then and
+   // guards against any out-of-order events
+   std::sort(mEntries.begin(), mEntries.end(),
+      [](const Entry &a, const Entry &b) { return a.time < b.time; });
+
+   mValid = true;
+}
+
+auto NoteIndex::FindRange(double t0, double t1) const
+   -> std::pair<const Entry *, const Entry *>
+{
+   const Entry *const begin = mEntries.data();
+   const Entry *const end = begin + mEntries.size();
+   // No note starting earlier than t0 - mMaxDur can still sound at t0
+   const auto first = std::lower_bound(begin, end, t0 - mMaxDur,
+      [](const Entry &e, double t) { return e.time < t; });
+   const auto last = std::lower_bound(first, end, t1,
+      [](const Entry &e, double t) { return e.time < t; });
+   return { first, last };
+}
+
+const NoteIndex &NoteTrack::GetNoteIndex() const
+{
+   if (!mNoteIndex.IsValid()) {
+      // Index times are seconds, as drawing wants them
+      auto &seq = GetSeq();
+      seq.convert_to_seconds();
+      mNoteIndex.Rebuild(seq);
+   }
+   return mNoteIndex;
+}
+
 Track::Holder NoteTrack::Clone() const
 {
    auto duplicate = std::make_shared<NoteTrack>(mDirManager);
@@ -220,6 +272,7 @@ void NoteTrack::WarpAndTransposeNotes(double t0, double t1,
                                       const TimeWarper &warper,
                                       double semitones)
 {
+   mNoteIndex.Invalidate();
    double offset = this->GetOffset(); // track is shifted this amount
    auto &seq = GetSeq();
    seq.convert_to_seconds(); // make sure time units are right
@@ -381,6 +434,7 @@ bool NoteTrack::LabelClick(const wxRect &rect, int mx, int my, bool right)
 
 void NoteTrack::SetSequence(std::unique_ptr<Alg_seq> &&seq)
 {
+   mNoteIndex.Invalidate();
    mSeq = std::move(seq);
 }
 
@@ -457,6 +511,7 @@ Track::Holder NoteTrack::Cut(double t0, double t1)
 
    newTrack->Init(*this);
 
+   mNoteIndex.Invalidate();
    auto &seq = GetSeq();
    seq.convert_to_seconds();
    newTrack->mSeq.reset(seq.cut(t0 - GetOffset(), len, false));
@@ -500,6 +555,7 @@ bool NoteTrack::Trim(double t0, double t1)
 {
    if (t1 < t0)
       return false;
+   mNoteIndex.Invalidate();
    auto &seq = GetSeq();
    //auto delta = -(
       //( GetEndTime() - std::min( GetEndTime(), t1 ) ) +
@@ -527,6 +583,7 @@ void NoteTrack::Clear(double t0, double t1)
 
    double len = t1-t0;
 
+   mNoteIndex.Invalidate();
    auto &seq = GetSeq();
 
    auto offset = GetOffset();
@@ -574,6 +631,7 @@ void NoteTrack::Paste(double t, const Track *src)
          InsertSilence(t, myOffset - t);
       }
 
+      mNoteIndex.Invalidate();
       double delta = 0.0;
       auto &seq = GetSeq();
       auto offset = other->GetOffset();
@@ -610,6 +668,7 @@ void NoteTrack::Silence(double t0, double t1)
 
    auto len = t1 - t0;
 
+   mNoteIndex.Invalidate();
    auto &seq = GetSeq();
    seq.convert_to_seconds();
    // XXX: do we want to set the all param?
@@ -623,6 +682,7 @@ void NoteTrack::InsertSilence(double t, double len)
    if (len < 0)
       THROW_INCONSISTENCY_EXCEPTION;
 
+   mNoteIndex.Invalidate();
    auto &seq = GetSeq();
    seq.convert_to_seconds();
    seq.insert_silence(t - GetOffset(), len);
@@ -643,6 +703,7 @@ void NoteTrack::SetVelocity(float velocity)
 // NOT the function that handles horizontal dragging.
 bool NoteTrack::Shift(double t) // t is always seconds
 {
+   mNoteIndex.Invalidate();
    if (t > 0) {
       auto &seq = GetSeq();
       // insert an even number of measures
@@ -694,6 +755,7 @@ void NoteTrack::AddToDuration( double delta )
 bool NoteTrack::StretchRegion
    ( QuantizedTimeAndBeat t0, QuantizedTimeAndBeat t1, double newDur )
 {
+   mNoteIndex.Invalidate();
    auto &seq = GetSeq();
    bool result = seq.stretch_region( t0.second, t1.second, newDur );
    if (result) {
@@ -900,6 +962,7 @@ bool NoteTrack::HandleXMLTag(const wxChar *tag, const wxChar **attrs)
          else if (!wxStrcmp(attr, wxT("data"))) {
              std::string s(strValue.mb_str(wxConvUTF8));
              std::istringstream data(s);
+             mNoteIndex.Invalidate();
              mSeq = std::make_unique<Alg_seq>(data, false);
          }
       } // while
@@ -16,6 +16,7 @@
 #include "Experimental.h"
 
 #include <utility>
+#include <vector>
 #include "Track.h"
 #include "effects/TimeWarper.h"
 
@@ -64,6 +65,43 @@ using QuantizedTimeAndBeat = std::pair< double, double >;
 
 class StretchHandle;
 
+/// Time-sorted index over the notes of the sequence, so that drawing can
+/// binary-search for the visible range instead of scanning every event
+class AUDACITY_DLL_API NoteIndex {
+public:
+   struct Entry {
+      double time;       // note start in seconds, without the track offset
+      double endTime;    // start plus duration
+      Alg_note_ptr note; // points into the sequence
+   };
+
+   bool IsValid() const { return mValid; }
+
+   // Entries point into the sequence, so this must be called before any
+   // edit that may delete or reorder events
+   void Invalidate()
+   {
+      mValid = false;
+      mEntries.clear();
+      mMaxDur = 0.0;
+   }
+
+   // (Re)build from a sequence already converted to seconds
+   void Rebuild(Alg_seq &seq);
+
+   // Entries, in time order, whose notes may sound in times [t0, t1)
+   // (without the track offset); a returned note may still end before
+   // t0, so callers test endTime, but no note outside the range can
+   // intersect.
+   std::pair<const Entry *, const Entry *>
+      FindRange(double t0, double t1) const;
+
+private:
+   std::vector<Entry> mEntries;
+   double mMaxDur{ 0.0 };
+   bool mValid{ false };
+};
+
 class AUDACITY_DLL_API NoteTrack final
    : public NoteTrackBase
 {
@@ -83,6 +121,9 @@ public:
 
    Alg_seq &GetSeq() const;
 
+   // Fetch the note index, rebuilding it from the sequence if stale
+   const NoteIndex &GetNoteIndex() const;
+
    void WarpAndTransposeNotes(double t0, double t1,
                               const TimeWarper &warper, double semitones);
 
@@ -202,6 +243,9 @@ public:
    mutable std::unique_ptr<char[]> mSerializationBuffer;
    mutable long mSerializationLength;
 
+   // Rebuilt on demand in the logically const GetNoteIndex()
+   mutable NoteIndex mNoteIndex;
+
 #ifdef EXPERIMENTAL_MIDI_OUT
    float mVelocity; // velocity offset
 #endif
@@ -24,6 +24,7 @@ for shared and private configs - which need to move out.
 #include "Experimental.h"
 
 #include <algorithm>
+#include <cstring>
 
 #include <wx/setup.h> // for wxUSE_* macros
 #include <wx/defs.h>
@@ -31,10 +32,13 @@ for shared and private configs - which need to move out.
 #include <wx/dir.h>
 #include <wx/dynlib.h>
 #include <wx/filename.h>
+#include <wx/ffile.h>
 #include <wx/listctrl.h>
 #include <wx/log.h>
+#include <wx/mstream.h>
 #include <wx/radiobut.h>
 #include <wx/string.h>
+#include <wx/timer.h>
 #include <wx/tokenzr.h>
 #include <wx/wfstream.h>
 #include <wx/utils.h>
@@ -1587,7 +1591,7 @@ bool PluginManager::RemoveSharedConfigSubgroup(const PluginID & ID, const Regist
    bool result = GetSettings()->DeleteGroup(SharedGroup(ID, group));
    if (result)
    {
-      GetSettings()->Flush();
+      ScheduleSettingsFlush();
    }
 
    return result;
@@ -1598,7 +1602,7 @@ bool PluginManager::RemoveSharedConfig(const PluginID & ID, const RegistryPath &
    bool result = GetSettings()->DeleteEntry(SharedKey(ID, group, key));
    if (result)
    {
-      GetSettings()->Flush();
+      ScheduleSettingsFlush();
    }
 
    return result;
@@ -1669,7 +1673,7 @@ bool PluginManager::RemovePrivateConfigSubgroup(const PluginID & ID, const Regis
    bool result = GetSettings()->DeleteGroup(PrivateGroup(ID, group));
    if (result)
    {
-      GetSettings()->Flush();
+      ScheduleSettingsFlush();
    }
 
    return result;
@@ -1680,7 +1684,7 @@ bool PluginManager::RemovePrivateConfig(const PluginID & ID, const RegistryPath
    bool result = GetSettings()->DeleteEntry(PrivateKey(ID, group, key));
    if (result)
    {
-      GetSettings()->Flush();
+      ScheduleSettingsFlush();
    }
 
    return result;
@@ -1699,6 +1703,17 @@ std::unique_ptr<PluginManager> PluginManager::mInstance{};
 // Creation/Destruction
 // ----------------------------------------------------------------------------
 
+// One-shot timer that lets a burst of settings writes settle before the
+// settings file is rewritten once
+class PluginManager::SettingsFlushTimer final : public wxTimer
+{
+public:
+   void Notify() override
+   {
+      Get().FlushSettings();
+   }
+};
+
 PluginManager::PluginManager()
 {
    mSettings = NULL;
@@ -1750,6 +1765,9 @@ void PluginManager::Initialize()
 
 void PluginManager::Terminate()
 {
+   // Write out any settings changes still waiting on the flush timer
+   FlushSettings();
+
    // Get rid of all non-module plugins first
    PluginMap::iterator iter = mPlugins.begin();
    while (iter != mPlugins.end())
@@ -2232,11 +2250,11 @@ void PluginManager::LoadGroup(wxFileConfig *pRegistry, PluginType type)
 
 void PluginManager::Save()
 {
-   // Create/Open the registry
-   wxFileConfig registry(wxEmptyString, wxEmptyString, FileNames::PluginRegistry());
-
-   // Clear it out
-   registry.DeleteAll();
+   // Build the registry in memory, rather than on top of the existing
+   // file, which would parse that whole file a second time just to be
+   // cleared out
+   wxMemoryInputStream empty("", 0);
+   wxFileConfig registry(empty);
 
    // Write the version string
    registry.Write(REGVERKEY, REGVERCUR);
@@ -2255,8 +2273,35 @@ void PluginManager::Save()
    // And now the providers
    SaveGroup(&registry, PluginTypeModule);
 
-   // Just to be safe
-   registry.Flush();
+   // Serialize, and rewrite the file only when its contents would
+   // change, so that the refresh at every launch costs no disk write
+   // while the plugin set is stable.  Flush() serializes through
+   // Save(), so the bytes compare equal with what it would have made.
+   wxMemoryOutputStream os;
+   registry.Save(os);
+
+   const size_t len = os.GetSize();
+   wxCharBuffer buf(len);
+   os.CopyTo(buf.data(), len);
+
+   {
+      wxFFile existing(FileNames::PluginRegistry(), wxT("rb"));
+      if (existing.IsOpened() && (size_t) existing.Length() == len)
+      {
+         wxCharBuffer old(len);
+         if (existing.Read(old.data(), len) == len &&
+             memcmp(old.data(), buf.data(), len) == 0)
+         {
+            return;
+         }
+      }
+   }
+
+   wxFFile file(FileNames::PluginRegistry(), wxT("wb"));
+   if (file.IsOpened())
+   {
+      file.Write(buf.data(), len);
+   }
 }
 
 void PluginManager::SaveGroup(wxFileConfig *pRegistry, PluginType type)
@@ -2753,6 +2798,36 @@ wxFileConfig *PluginManager::GetSettings()
    return mSettings.get();
 }
 
+void PluginManager::ScheduleSettingsFlush()
+{
+   // The change is already visible to readers in wxFileConfig's memory
+   // image; flushing here would rewrite the whole file per written
+   // value, which realtime effect controls turn into bursts of full
+   // rewrites.  Restarting the timer on every write lets a burst settle
+   // before the file is rewritten once.  wxFileConfig::Flush writes a
+   // temporary file and renames it, so a crash while a flush is pending
+   // just loses the last second of knob movements, not the file.
+   if (!mSettingsFlushTimer)
+   {
+      mSettingsFlushTimer = std::make_unique<SettingsFlushTimer>();
+   }
+
+   mSettingsFlushTimer->Start(1000, wxTIMER_ONE_SHOT);
+}
+
+void PluginManager::FlushSettings()
+{
+   if (mSettingsFlushTimer)
+   {
+      mSettingsFlushTimer->Stop();
+   }
+
+   if (mSettings)
+   {
+      mSettings->Flush();
+   }
+}
+
 bool PluginManager::HasGroup(const RegistryPath & group)
 {
    wxFileConfig *settings = GetSettings();
@@ -2873,7 +2948,7 @@ bool PluginManager::SetConfig(const RegistryPath & key, const wxString & value)
       result = GetSettings()->Write(key, wxval);
       if (result)
       {
-         result = GetSettings()->Flush();
+         ScheduleSettingsFlush();
       }
    }
 
@@ -2889,7 +2964,7 @@ bool PluginManager::SetConfig(const RegistryPath & key, const int & value)
       result = GetSettings()->Write(key, value);
       if (result)
       {
-         result = GetSettings()->Flush();
+         ScheduleSettingsFlush();
       }
    }
 
@@ -2905,7 +2980,7 @@ bool PluginManager::SetConfig(const RegistryPath & key, const bool & value)
       result = GetSettings()->Write(key, value);
       if (result)
       {
-         result = GetSettings()->Flush();
+         ScheduleSettingsFlush();
       }
    }
 
@@ -2921,7 +2996,7 @@ bool PluginManager::SetConfig(const RegistryPath & key, const float & value)
       result = GetSettings()->Write(key, value);
       if (result)
       {
-         result = GetSettings()->Flush();
+         ScheduleSettingsFlush();
       }
    }
 
@@ -2937,7 +3012,7 @@ bool PluginManager::SetConfig(const RegistryPath & key, const double & value)
       result = GetSettings()->Write(key, value);
       if (result)
       {
-         result = GetSettings()->Flush();
+         ScheduleSettingsFlush();
       }
    }
 
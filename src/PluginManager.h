@@ -22,6 +22,7 @@
 #include "audacity/PluginInterface.h"
 
 class wxArrayString;
+class wxTimer;
 
 ///////////////////////////////////////////////////////////////////////////////
 //
@@ -277,6 +278,13 @@ private:
 
    wxFileConfig *GetSettings();
 
+   // Settings changes are coalesced:  the Set*Config and Remove*Config
+   // functions mutate the in-memory store and (re)start a short one-shot
+   // timer, and the file is rewritten once when the timer fires or at
+   // termination, so no full-file rewrite happens per written value.
+   void ScheduleSettingsFlush();
+   void FlushSettings();
+
    bool HasGroup(const RegistryPath & group);
    bool GetSubgroups(const RegistryPath & group, RegistryPaths & subgroups);
 
@@ -313,6 +321,9 @@ private:
    void SetDirty(bool dirty = true);
    std::unique_ptr<wxFileConfig> mSettings;
 
+   class SettingsFlushTimer;
+   std::unique_ptr<SettingsFlushTimer> mSettingsFlushTimer;
+
    bool mDirty;
    int mCurrentIndex;
 
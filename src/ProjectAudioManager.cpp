@@ -32,6 +32,7 @@ Paul Licameli split from ProjectManager.cpp
 #include "TrackPanelAx.h"
 #include "ViewInfo.h"
 #include "WaveTrack.h"
+#include "ondemand/ODManager.h"
 #include "toolbars/ToolManager.h"
 #include "prefs/TracksPrefs.h"
 #include "tracks/ui/Scrubbing.h"
@@ -240,6 +241,14 @@ int ProjectAudioManager::PlayPlayRegion(const SelectedRegion &selectedRegion,
       if (token != 0) {
          success = true;
          ProjectAudioIO::Get( *p ).SetAudioIOToken(token);
+
+         // Aim any on-demand decoding at the point where playback begins,
+         // so that play over a partially decoded file need not wait for
+         // the file-order decode to reach it
+         if (ODManager::IsInstanceCreated()) {
+            for (auto wt : tracks.Any< WaveTrack >())
+               ODManager::Instance()->DemandTrackUpdate(wt, t0);
+         }
 #if defined(EXPERIMENTAL_SEEK_BEHIND_CURSOR)
          //AC: If init_seek was set, now's the time to make it happen.
          gAudioIO->SeekStream(init_seek);
@@ -988,11 +997,32 @@ TransportTracks ProjectAudioManager::GetAllPlaybackTracks(
 {
    TransportTracks result;
    {
-      auto range = trackList.Any< WaveTrack >()
+      auto range = trackList.Leaders< WaveTrack >()
          + (selectedOnly ? &Track::IsSelected : &Track::Any );
-      for (auto pTrack: range)
-         result.playbackTracks.push_back(
-            pTrack->SharedPointer< WaveTrack >() );
+      for (auto pTrack: range) {
+         // A frozen group plays its cached render instead of its live
+         // channels.  Mute, solo, gain and pan are not baked into the
+         // render; carry the live settings over at playback start.
+         if (auto render = pTrack->GetFrozenRender()) {
+            const auto channels = TrackList::Channels(pTrack);
+            auto pLive = channels.begin();
+            for (auto pSub : render->Any< WaveTrack >()) {
+               if (pLive == channels.end())
+                  break;
+               pSub->SetMute((*pLive)->GetMute());
+               pSub->SetSolo((*pLive)->GetSolo());
+               pSub->SetGain((*pLive)->GetGain());
+               pSub->SetPan((*pLive)->GetPan());
+               result.playbackTracks.push_back(
+                  pSub->SharedPointer< WaveTrack >() );
+               ++pLive;
+            }
+         }
+         else
+            for (auto pChannel : TrackList::Channels(pTrack))
+               result.playbackTracks.push_back(
+                  pChannel->SharedPointer< WaveTrack >() );
+      }
    }
 #ifdef EXPERIMENTAL_MIDI_OUT
    if (useMidi) {
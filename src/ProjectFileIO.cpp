@@ -14,12 +14,14 @@ Paul Licameli split from AudacityProject.cpp
 
 #include "AutoRecovery.h"
 #include "DirManager.h"
+#include "Envelope.h"
 #include "FileNames.h"
 #include "Project.h"
 #include "ProjectFileIORegistry.h"
 #include "ProjectSettings.h"
 #include "Tags.h"
 #include "ViewInfo.h"
+#include "WaveClip.h"
 #include "WaveTrack.h"
 #include "widgets/AudacityMessageBox.h"
 #include "widgets/NumericTextCtrl.h"
@@ -561,12 +563,164 @@ private:
    T mValExit;
 };
 
+namespace {
+
+// 64-bit FNV-1a, for cheap change detection between auto saves
+
+inline void HashBytes(unsigned long long &hash, const void *data, size_t len)
+{
+   auto bytes = (const unsigned char *)data;
+   for (size_t ii = 0; ii < len; ++ii) {
+      hash ^= bytes[ii];
+      hash *= 1099511628211ULL;
+   }
+}
+
+inline void HashNumber(unsigned long long &hash, double value)
+{
+   HashBytes(hash, &value, sizeof(value));
+}
+
+inline void HashNumber(unsigned long long &hash, long long value)
+{
+   HashBytes(hash, &value, sizeof(value));
+}
+
+void HashString(unsigned long long &hash, const wxString &value)
+{
+   HashBytes(hash, value.wx_str(), value.length() * sizeof(wxChar));
+}
+
+void HashClip(unsigned long long &hash, const WaveClip &clip)
+{
+   // The dirty counter is bumped by every operation that edits the
+   // clip's samples, which is also what invalidates the wave display
+   HashNumber(hash, (long long)clip.GetDirty());
+   HashNumber(hash, clip.GetOffset());
+   HashNumber(hash, clip.GetNumSamples().as_long_long());
+   HashNumber(hash, (long long)clip.GetColourIndex());
+
+   const auto &env = *clip.GetEnvelope();
+   const auto points = env.GetNumberOfPoints();
+   HashNumber(hash, (long long)points);
+   for (size_t ii = 0; ii < points; ++ii) {
+      HashNumber(hash, env[ii].GetT());
+      HashNumber(hash, env[ii].GetVal());
+   }
+
+   for (const auto &cutline : clip.GetCutLines())
+      HashClip(hash, *cutline);
+}
+
+// A fingerprint covering the project data WaveTrack::WriteXML writes,
+// computed from accessors without serializing anything.  Display
+// geometry (track height and the like) is not covered; it refreshes
+// with the next full snapshot.
+unsigned long long WaveTrackFingerprint(const WaveTrack &track)
+{
+   unsigned long long hash = 14695981039346656037ULL;
+
+   HashString(hash, track.GetName());
+   HashNumber(hash, (long long)track.GetChannel());
+   HashNumber(hash, (long long)track.GetLinked());
+   HashNumber(hash, (long long)track.GetSelected());
+   HashNumber(hash, (long long)track.GetMute());
+   HashNumber(hash, (long long)track.GetSolo());
+   HashNumber(hash, track.GetRate());
+   HashNumber(hash, (double)track.GetGain());
+   HashNumber(hash, (double)track.GetPan());
+   HashNumber(hash, (long long)track.GetWaveColorIndex());
+
+   for (const auto &clip : track.GetClips())
+      HashClip(hash, *clip);
+
+   return hash;
+}
+
+// A fingerprint of everything else: non-wave tracks are cheap enough to
+// just serialize, and the placeholders keep the interleaving of wave
+// and other tracks part of the fingerprint
+unsigned long long OtherTracksFingerprint(AudacityProject &project)
+{
+   unsigned long long hash = 14695981039346656037ULL;
+
+   for (auto t : TrackList::Get( project ).Any()) {
+      if (track_cast<const WaveTrack*>(t))
+         HashNumber(hash, (long long)1);
+      else {
+         XMLStringWriter writer;
+         t->WriteXML(writer);
+         HashString(hash, writer);
+      }
+   }
+
+   return hash;
+}
+
+// Bound the journal so that the auto-save file cannot grow without
+// limit across a long session of small edits
+const int kMaxAutoSaveDeltas = 30;
+
+}
+
 void ProjectFileIO::AutoSave()
 {
    auto &project = mProject;
    auto &window = GetProjectFrame( project );
+   auto &tracks = TrackList::Get( project );
    //    SonifyBeginAutoSave(); // part of RBD's r10680 stuff now backed out
 
+   // Fingerprint the current state; when an auto-save file already
+   // exists and the set of tracks is unchanged, only the tracks whose
+   // fingerprints moved need to be written
+   std::vector<unsigned long long> fingerprints;
+   for (auto t : tracks.Any< const WaveTrack >())
+      fingerprints.push_back(WaveTrackFingerprint(*t));
+   const auto otherFingerprint = OtherTracksFingerprint(project);
+
+   if (!mAutoSaveFileName.empty() &&
+       mAutoSaveDeltas < kMaxAutoSaveDeltas &&
+       otherFingerprint == mAutoSaveOtherFingerprint &&
+       fingerprints.size() == mAutoSaveFingerprints.size())
+   {
+      if (fingerprints == mAutoSaveFingerprints)
+         // Nothing the auto save covers has changed
+         return;
+
+      // Append deltas for the changed tracks to the journal; recovery
+      // replays them over the base snapshot in order
+      bool success = GuardedCall< bool >( [&]
+      {
+         VarSetter<bool> setter(&mAutoSaving, true, false);
+
+         AutoSaveFile buffer;
+         int ident = 0;
+         for (auto t : tracks.Any< WaveTrack >()) {
+            const auto index = ident++;
+            if (fingerprints[index] == mAutoSaveFingerprints[index])
+               continue;
+            // Keep idents positional, as the full snapshot assigns them
+            t->SetAutoSaveIdent(index + 1);
+            buffer.StartTag(wxT("trackdelta"));
+            buffer.WriteAttr(wxT("ident"), index + 1);
+            t->WriteXML(buffer);
+            buffer.EndTag(wxT("trackdelta"));
+         }
+
+         wxFFile file{ mAutoSaveFileName, wxT("ab") };
+         if (!file.IsOpened())
+            return false;
+         return buffer.Append(file);
+      } );
+
+      if (success) {
+         mAutoSaveFingerprints.swap(fingerprints);
+         ++mAutoSaveDeltas;
+         return;
+      }
+      // Else fall through and write a full snapshot
+   }
+
    // To minimize the possibility of race conditions, we first write to a
    // file with the extension ".tmp", then rename the file to .autosave
    wxString projName;
@@ -614,6 +768,12 @@ void ProjectFileIO::AutoSave()
    }
 
    mAutoSaveFileName += fn + wxT(".autosave");
+
+   // The snapshot just written is the new base for deltas
+   mAutoSaveFingerprints.swap(fingerprints);
+   mAutoSaveOtherFingerprint = otherFingerprint;
+   mAutoSaveDeltas = 0;
+
    // no-op cruft that's not #ifdefed for NoteTrack
    // See above for further comments.
    //   SonifyEndAutoSave();
@@ -11,6 +11,8 @@ Paul Licameli split from AudacityProject.h
 #ifndef __AUDACITY_PROJECT_FILE_IO__
 #define __AUDACITY_PROJECT_FILE_IO__
 
+#include <vector>
+
 #include "ClientData.h" // to inherit
 #include "Prefs.h" // to inherit
 #include "xml/XMLTagHandler.h" // to inherit
@@ -75,6 +77,16 @@ private:
    // Last auto-save file name and path (empty if none)
    FilePath mAutoSaveFileName;
 
+   // Incremental auto save: content fingerprints of each wave track as
+   // of the last write, indexed by autosave ident - 1
+   std::vector<unsigned long long> mAutoSaveFingerprints;
+
+   // Fingerprint of everything else the auto save covers
+   unsigned long long mAutoSaveOtherFingerprint{ 0 };
+
+   // Number of track deltas appended since the last full snapshot
+   int mAutoSaveDeltas{ 0 };
+
    // Are we currently auto-saving or not?
    bool mAutoSaving{ false };
 
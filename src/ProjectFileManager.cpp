@@ -51,6 +51,7 @@ Paul Licameli split from AudacityProject.cpp
 #include "commands/CommandContext.h"
 #include "ondemand/ODComputeSummaryTask.h"
 #include "ondemand/ODDecodeFlacTask.h"
+#include "ondemand/ODDecodeMP3Task.h"
 #include "ondemand/ODManager.h"
 #include "ondemand/ODTask.h"
 #include "toolbars/SelectionBar.h"
@@ -97,10 +98,18 @@ auto ProjectFileManager::ReadProjectFile( const FilePath &fileName )
    projectFileIO.SetProjectTitle();
 
    const wxString autoSaveExt = wxT("autosave");
+   wxString recoveryXML;
+   bool parseRecoveryXML = false;
    if ( wxFileNameWrapper{ fileName }.GetExt() == autoSaveExt )
    {
       AutoSaveFile asf;
-      if (!asf.Decode(fileName))
+      // Prefer decoding the file in memory and parsing that; the cost of
+      // rewriting the whole document on disk and reading it back is
+      // saved, and the recovery file survives unaltered for a retry.
+      // Files not in the encoded format fall back to the rewrite.
+      if (asf.DecodeString(fileName, recoveryXML))
+         parseRecoveryXML = true;
+      else if (!asf.Decode(fileName))
       {
          auto message = AutoSaveFile::FailureMessage( fileName );
          AudacityMessageBox(
@@ -143,7 +152,9 @@ auto ProjectFileManager::ReadProjectFile( const FilePath &fileName )
    } );
 #endif
 
-   bool bParseSuccess = xmlFile.Parse(&projectFileIO, fileName);
+   bool bParseSuccess = parseRecoveryXML
+      ? xmlFile.ParseString(&projectFileIO, recoveryXML)
+      : xmlFile.Parse(&projectFileIO, fileName);
    
    bool err = false;
 
@@ -229,6 +240,13 @@ void ProjectFileManager::EnqueueODTasks()
                createdODTasks = createdODTasks | ODTask::eODFLAC;
             }
             else
+#endif
+#ifdef EXPERIMENTAL_OD_MP3
+            if(!(createdODTasks&ODTask::eODMP3) && (odFlags & ODTask::eODMP3)) {
+               newTask = std::make_unique<ODDecodeMP3Task>();
+               createdODTasks = createdODTasks | ODTask::eODMP3;
+            }
+            else
 #endif
             if(!(createdODTasks&ODTask::eODPCMSummary) && (odFlags & ODTask::eODPCMSummary)) {
                newTask = std::make_unique<ODComputeSummaryTask>();
@@ -259,6 +277,23 @@ bool ProjectFileManager::Save()
    if (bPromptingRequired)
       return SaveAs();
 
+   // If nothing changed since the last full save, then the .aup on disk
+   // already describes this state exactly -- it is the manifest of the
+   // block files -- and rewriting it would only repeat the serialization
+   // of every block of every track.  UnsavedChanges() is conservative:
+   // edits, settings changes, and completing on-demand computation all
+   // make it true again.
+   if (mLastSavedTracks &&
+       !UndoManager::Get( mProject ).UnsavedChanges() &&
+       !ProjectFileIO::Get( mProject ).IsRecovered() &&
+       wxFileExists( mProject.GetFileName() ))
+   {
+      // Any auto-saved version is describing this same state, and a real
+      // save would have deleted it
+      ProjectFileIO::Get( mProject ).DeleteCurrentAutoSaveFile();
+      return true;
+   }
+
    return DoSave(false, false);
 }
 
@@ -425,6 +460,19 @@ bool ProjectFileManager::DoSave (const bool fromSaveAs,
          return false;
    }
 
+   if (!fromSaveAs) {
+      // Blocks pasted from other open projects are shared by reference;
+      // the .aup about to be written must refer only to files this
+      // project owns, so copy their data in first.  (Save As instead
+      // materializes everything through ProjectSetter, below.)
+      success = GuardedCall< bool >( [&] {
+            dirManager.MaterializeForeignBlocks();
+            return true;
+         }, MakeSimpleGuard(false) );
+      if (!success)
+         return false;
+   }
+
    // Write the .aup now, before DirManager::SetProject,
    // because it's easier to clean up the effects of successful write of .aup
    // followed by failed SetProject, than the other way about.
@@ -1103,6 +1151,21 @@ ProjectFileManager::sRecoveryFactory{
    wxT("recordingrecovery"), RecordingRecoveryFactory
 };
 
+XMLTagHandler *
+ProjectFileManager::TrackDeltaRecoveryFactory( AudacityProject &project ) {
+   auto &projectFileManager = Get( project );
+   auto &ptr = projectFileManager.mTrackDeltaRecoveryHandler;
+   if (!ptr)
+      ptr =
+         std::make_unique<TrackDeltaRecoveryHandler>( &project );
+   return ptr.get();
+}
+
+ProjectFileIORegistry::Entry
+ProjectFileManager::sTrackDeltaFactory{
+   wxT("trackdelta"), TrackDeltaRecoveryFactory
+};
+
 // XML handler for <import> tag
 class ImportXMLTagHandler final : public XMLTagHandler
 {
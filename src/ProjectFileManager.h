@@ -22,6 +22,7 @@ class wxFileName;
 class AudacityProject;
 class ImportXMLTagHandler;
 class RecordingRecoveryHandler;
+class TrackDeltaRecoveryHandler;
 class Track;
 class TrackList;
 class WaveTrack;
@@ -123,6 +124,8 @@ private:
    // Declared in this class so that they can have access to private members
    static XMLTagHandler *RecordingRecoveryFactory( AudacityProject &project );
    static ProjectFileIORegistry::Entry sRecoveryFactory;
+   static XMLTagHandler *TrackDeltaRecoveryFactory( AudacityProject &project );
+   static ProjectFileIORegistry::Entry sTrackDeltaFactory;
    static XMLTagHandler *ImportHandlerFactory( AudacityProject &project );
    static ProjectFileIORegistry::Entry sImportHandlerFactory;
 
@@ -132,6 +135,8 @@ private:
    
    // The handler that handles recovery of <recordingrecovery> tags
    std::unique_ptr<RecordingRecoveryHandler> mRecordingRecoveryHandler;
+
+   std::unique_ptr<TrackDeltaRecoveryHandler> mTrackDeltaRecoveryHandler;
    
    std::unique_ptr<ImportXMLTagHandler> mImportXMLTagHandler;
    
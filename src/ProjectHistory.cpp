@@ -123,9 +123,9 @@ void ProjectHistory::ModifyState(bool bWantsAutoSave)
       projectFileIO.AutoSave();
 }
 
-// LL:  Is there a memory leak here as "l" and "t" are not deleted???
-// Vaughan, 2010-08-29: No, as "l" is a TrackList* of an Undo stack state.
-//    Need to keep it and its tracks "t" available for Undo/Redo/SetStateTo.
+// The tracks of the state are duplicated into the project, never moved;
+// the snapshot must stay intact (and shareable with its neighbor states)
+// for later Undo/Redo/SetStateTo.
 void ProjectHistory::PopState(const UndoState &state)
 {
    auto &project = mProject;
@@ -138,13 +138,11 @@ void ProjectHistory::PopState(const UndoState &state)
    // Restore tags
    Tags::Set( project, state.tags );
 
-   TrackList *const tracks = state.tracks.get();
-
    dstTracks.Clear();
    bool odUsed = false;
    std::unique_ptr<ODComputeSummaryTask> computeTask;
 
-   for (auto t : tracks->Any())
+   for (auto &t : state.tracks)
    {
       auto copyTrack = dstTracks.Add(t->Duplicate());
 
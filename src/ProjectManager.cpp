@@ -38,6 +38,7 @@ Paul Licameli split from AudacityProject.cpp
 #include "UndoManager.h"
 #include "WaveTrack.h"
 #include "wxFileNameWrapper.h"
+#include "effects/TrackIOQueue.h"
 #include "import/ImportMIDI.h"
 #include "ondemand/ODManager.h"
 #include "prefs/QualityPrefs.h"
@@ -51,6 +52,7 @@ Paul Licameli split from AudacityProject.cpp
 #include "widgets/WindowAccessible.h"
 
 #include <wx/dataobj.h>
+#include <wx/ffile.h>
 #include <wx/dnd.h>
 #include <wx/scrolbar.h>
 #include <wx/sizer.h>
@@ -331,7 +333,27 @@ public:
             ProjectWindow::Get( *mProject ).HandleResize(); // Adjust scrollers for NEW track sizes.
          } );
 
-         for (const auto &name : sortednames) {
+         // While one file imports, a worker reads the following one through,
+         // so the import finds it in the system cache; with a whole folder
+         // dropped at once the disk stays busy alongside the decoding.
+         TrackIOQueue prefetchQueue;
+         auto Prefetch = [&prefetchQueue](const wxString &fileName){
+            prefetchQueue.Post([fileName]{
+               wxFFile file(fileName, wxT("rb"));
+               if (!file.IsOpened())
+                  return;
+               char buffer[65536];
+               while (!file.Eof() && file.Read(buffer, sizeof(buffer)) > 0)
+                  ;
+            });
+         };
+         if (sortednames.size() > 1)
+            Prefetch(sortednames[1]);
+
+         for (size_t ff = 0; ff < sortednames.size(); ff++) {
+            const auto &name = sortednames[ff];
+            if (ff + 2 < sortednames.size())
+               Prefetch(sortednames[ff + 2]);
 #ifdef USE_MIDI
             if (FileNames::IsMidi(name))
                DoImportMIDI( *mProject, name );
@@ -23,6 +23,7 @@ Paul Licameli split from AudacityProject.cpp
 #include "ViewInfo.h"
 #include "WaveClip.h"
 #include "WaveTrack.h"
+#include "ondemand/ODManager.h"
 #include "prefs/ThemePrefs.h"
 #include "prefs/TracksPrefs.h"
 #include "toolbars/ToolManager.h"
@@ -31,6 +32,9 @@ Paul Licameli split from AudacityProject.cpp
 #include "widgets/wxPanelWrapper.h"
 #include "widgets/WindowAccessible.h"
 
+#include <atomic>
+#include <thread>
+
 #include <wx/display.h>
 #include <wx/scrolbar.h>
 #include <wx/sizer.h>
@@ -351,6 +355,72 @@ END_EVENT_TABLE()
 // Common mouse wheel handling in track panel cells, moved here to avoid
 // compilation dependencies on Track, TrackPanel, and Scrubbing at low levels
 // which made cycles
+// During a continuing wheel gesture, computes wave displays for the
+// geometry the next step is about to request, on a background thread, so
+// that step paints from warm caches.  The clips' retained cache strips
+// (see WaveClip::GetWaveDisplay) keep the speculative columns until the
+// real request arrives; per-clip locking makes the concurrent computation
+// safe, as in the paint-time prefetch in TrackPanel::DrawTracks.
+class GesturePrefetcher
+{
+public:
+   // Warm caches for the view that would result from repeating the step
+   // just performed: zooming again by zoomFactor about anchorTime, or
+   // scrolling again by timeShift seconds
+   void Predict( AudacityProject &project,
+      double zoomFactor, double anchorTime, double timeShift )
+   {
+      if ( mBusy.exchange( true ) )
+         // One speculative pass at a time; the gesture will prompt
+         // another prediction soon enough
+         return;
+
+      auto &viewInfo = ViewInfo::Get( project );
+      const double pps = viewInfo.GetZoom() * zoomFactor;
+      const double h = timeShift +
+         anchorTime - (anchorTime - viewInfo.h) / zoomFactor;
+      const double duration =
+         (viewInfo.GetScreenEndTime() - viewInfo.h) / zoomFactor;
+
+      // Snapshot the clips; shared pointers keep them alive should the
+      // gesture outlast an edit that removes them
+      WaveClipHolders clips;
+      for ( auto wt : TrackList::Get( project ).Any< WaveTrack >() )
+         for ( const auto &clip : wt->GetClips() )
+            clips.push_back( clip );
+
+      std::thread( [this, clips = std::move( clips ), h, pps, duration]{
+         for ( const auto &clip : clips ) {
+            const double t0 = std::max( h, clip->GetStartTime() );
+            const double t1 = std::min( h + duration, clip->GetEndTime() );
+            if ( t1 <= t0 )
+               continue;
+            const double rate = clip->GetRate();
+            if ( pps > 0.5 * rate )
+               // Individual-sample zoom; the drawing pass will read the
+               // sequence directly and not consult the cache
+               continue;
+            const int width = std::max( 1, (int)floor( (t1 - t0) * pps ) );
+            WaveDisplay display( width );
+            bool isLoadingOD = false;
+            try {
+               clip->GetWaveDisplay( display,
+                  t0 - clip->GetOffset(), pps, isLoadingOD );
+            }
+            catch ( ... ) {
+               // Speculative work; if the failure still matters the
+               // drawing pass will meet it with the usual handling
+               break;
+            }
+         }
+         mBusy.store( false );
+      } ).detach();
+   }
+
+private:
+   std::atomic<bool> mBusy{ false };
+};
+
 static struct MouseWheelHandler {
 
 MouseWheelHandler()
@@ -360,6 +430,7 @@ MouseWheelHandler()
 
 // Need a bit of memory from one call to the next
 mutable double mVertScrollRemainder = 0.0;
+mutable GesturePrefetcher mPrefetcher;
 
 unsigned operator()
    ( const TrackPanelMouseEvent &evt, AudacityProject *pProject ) const
@@ -389,6 +460,10 @@ unsigned operator()
       window.TP_ScrollWindow(
          viewInfo.OffsetTimeByPixels(
             viewInfo.PositionToTime(0), 50.0 * -steps));
+
+      // Guess that the gesture continues with the same step
+      mPrefetcher.Predict( *pProject, 1.0, 0.0,
+         50.0 * -steps / viewInfo.GetZoom() );
    }
    else if (event.CmdDown())
    {
@@ -464,6 +539,9 @@ unsigned operator()
       if( viewInfo.h > audioEndTime )
          viewInfo.h += audioEndTime - viewInfo.PositionToTime( xTrackEnd );
 
+      // Guess that the gesture continues zooming by the same factor
+      // about the same point
+      mPrefetcher.Predict( *pProject, pow(2.0, steps), center_h, 0.0 );
 
       result |= FixScrollbars;
    }
@@ -484,6 +562,10 @@ unsigned operator()
          auto didSomething = window.TP_ScrollUpDown((int)-lines);
          if (!didSomething)
             result |= Cancelled;
+         else
+            // Warm the caches of tracks scrolled into view; the
+            // geometry does not change, only which clips are visible
+            mPrefetcher.Predict( *pProject, 1.0, 0.0, 0.0 );
       }
    }
 
@@ -1395,6 +1477,15 @@ void ProjectWindow::DoScroll()
    //SetActiveProject(this);
 
    if (!mAutoScrolling) {
+      // A scroll by the user re-aims any on-demand decoding at the NEW
+      // viewport, so that what is on screen becomes available first.
+      // Autoscroll is excluded; during playback the play position sets
+      // the demand instead.
+      if (ODManager::IsInstanceCreated()) {
+         for (auto wt : TrackList::Get( project ).Any< WaveTrack >())
+            ODManager::Instance()->DemandTrackUpdate(wt, viewInfo.h);
+      }
+
       trackPanel.Refresh(false);
    }
 }
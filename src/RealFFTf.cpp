@@ -52,6 +52,29 @@
 #include "RealFFTf48x.h"
 #endif
 
+// The butterfly kernels below run for every FFT in the program --
+// effects, analysis, and spectrogram drawing all come through here.
+// Use the vector unit where the compiler is already targeting one, and
+// on x86 also compile an AVX2/FMA variant where the compiler can
+// target it per-function, chosen at run time.
+#if defined(__AVX__) || defined(__SSE2__) || defined(_M_X64) || \
+   (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define REALFFT_VECTOR_SSE
+#include <emmintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define REALFFT_VECTOR_AVX
+#define REALFFT_TARGET_AVX __attribute__((target("avx2,fma")))
+#include <immintrin.h>
+#elif defined(__AVX2__) && defined(__FMA__)
+#define REALFFT_VECTOR_AVX
+#define REALFFT_TARGET_AVX
+#include <immintrin.h>
+#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define REALFFT_VECTOR_NEON
+#include <arm_neon.h>
+#endif
+
 #ifndef M_PI
 #define	M_PI		3.14159265358979323846  /* pi */
 #endif
@@ -101,37 +124,28 @@ HFFT InitializeFFT(size_t fftlen)
    return h;
 }
 
-enum : size_t { MAX_HFFT = 10 };
-
-// Maintain a pool:
-static std::vector< std::unique_ptr<FFTParam> > hFFTArray(MAX_HFFT);
+// Maintain a pool, shared by all spectral consumers -- effects, Plot
+// Spectrum, and the spectrogram threads.  Only a handful of power-of-two
+// lengths are ever in use, so entries are retained for the life of the
+// program; the tables are immutable once computed, and so are shared
+// read-only without copies.
+static std::vector< std::unique_ptr<FFTParam> > hFFTArray;
 wxCriticalSection getFFTMutex;
 
 /* Get a handle to the FFT tables of the desired length */
 /* This version keeps common tables rather than allocating a NEW table every time */
 HFFT GetFFT(size_t fftlen)
 {
-   // To do:  smarter policy about when to retain in the pool and when to
-   // allocate a unique instance.
-
    wxCriticalSectionLocker locker{ getFFTMutex };
-   
-   size_t h = 0;
+
    auto n = fftlen/2;
-   auto size = hFFTArray.size();
-   for(;
-       (h < size) && hFFTArray[h] && (n != hFFTArray[h]->Points);
-       h++)
-      ;
-   if(h < size) {
-      if(hFFTArray[h] == NULL) {
-         hFFTArray[h].reset( InitializeFFT(fftlen).release() );
-      }
-      return HFFT{ hFFTArray[h].get() };
-   } else {
-      // All buffers used, so fall back to allocating a NEW set of tables
-      return InitializeFFT(fftlen);
-   }
+   for (auto &pParam : hFFTArray)
+      if (n == pParam->Points)
+         return HFFT{ pParam.get() };
+
+   hFFTArray.push_back(
+      std::unique_ptr<FFTParam>{ InitializeFFT(fftlen).release() } );
+   return HFFT{ hFFTArray.back().get() };
 }
 
 /* Release a previously requested handle to the FFT tables */
@@ -148,6 +162,172 @@ void FFTDeleter::operator() (FFTParam *hFFT) const
       delete hFFT;
 }
 
+/*
+* Butterfly kernels.  Within one group all butterflies share a twiddle
+* factor, and with the (real, imaginary) interleaving both outputs can
+* be written as A -+ t where t.real = Br*cos + Bi*sin and
+* t.imag = Bi*cos - Br*sin (forward), respectively
+* t.real = Br*cos - Bi*sin and t.imag = Bi*cos + Br*sin with a final
+* halving (inverse).  That form vectorizes with a within-pair swap and
+* a sign-alternated sine vector, several butterflies per step.
+*/
+
+#ifdef REALFFT_VECTOR_AVX
+static bool HaveAVX()
+{
+#if defined(__GNUC__) || defined(__clang__)
+   static const bool result =
+      __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+   return result;
+#else
+   // Only reached when the whole build targets AVX2 anyway
+   return true;
+#endif
+}
+
+REALFFT_TARGET_AVX
+static void ForwardButterfliesAVX(fft_type *A, fft_type *B,
+   size_t count, fft_type sin, fft_type cos)
+{
+   size_t ii = 0;
+   const __m256 vcos = _mm256_set1_ps(cos);
+   const __m256 vsin = _mm256_setr_ps(
+      sin, -sin, sin, -sin, sin, -sin, sin, -sin);
+   for (; ii + 4 <= count; ii += 4) {
+      const __m256 a = _mm256_loadu_ps(A + 2 * ii);
+      const __m256 b = _mm256_loadu_ps(B + 2 * ii);
+      const __m256 t = _mm256_fmadd_ps(b, vcos,
+         _mm256_mul_ps(_mm256_permute_ps(b, 0xB1), vsin));
+      _mm256_storeu_ps(A + 2 * ii, _mm256_sub_ps(a, t));
+      _mm256_storeu_ps(B + 2 * ii, _mm256_add_ps(a, t));
+   }
+   for (; ii < count; ++ii) {
+      const fft_type v1 = B[2*ii] * cos + B[2*ii+1] * sin;
+      const fft_type v2 = B[2*ii] * sin - B[2*ii+1] * cos;
+      const fft_type ar = A[2*ii], ai = A[2*ii+1];
+      B[2*ii]   = ar + v1;
+      A[2*ii]   = ar - v1;
+      B[2*ii+1] = ai - v2;
+      A[2*ii+1] = ai + v2;
+   }
+}
+
+REALFFT_TARGET_AVX
+static void InverseButterfliesAVX(fft_type *A, fft_type *B,
+   size_t count, fft_type sin, fft_type cos)
+{
+   size_t ii = 0;
+   const __m256 vcos = _mm256_set1_ps(cos);
+   const __m256 vsin = _mm256_setr_ps(
+      -sin, sin, -sin, sin, -sin, sin, -sin, sin);
+   const __m256 vhalf = _mm256_set1_ps(0.5f);
+   for (; ii + 4 <= count; ii += 4) {
+      const __m256 a = _mm256_loadu_ps(A + 2 * ii);
+      const __m256 b = _mm256_loadu_ps(B + 2 * ii);
+      const __m256 t = _mm256_fmadd_ps(b, vcos,
+         _mm256_mul_ps(_mm256_permute_ps(b, 0xB1), vsin));
+      _mm256_storeu_ps(A + 2 * ii,
+         _mm256_mul_ps(_mm256_sub_ps(a, t), vhalf));
+      _mm256_storeu_ps(B + 2 * ii,
+         _mm256_mul_ps(_mm256_add_ps(a, t), vhalf));
+   }
+   for (; ii < count; ++ii) {
+      const fft_type v1 = B[2*ii] * cos - B[2*ii+1] * sin;
+      const fft_type v2 = B[2*ii] * sin + B[2*ii+1] * cos;
+      const fft_type ar = A[2*ii], ai = A[2*ii+1];
+      B[2*ii]   = (ar + v1) * (fft_type)0.5;
+      A[2*ii]   = (ar - v1) * (fft_type)0.5;
+      B[2*ii+1] = (ai + v2) * (fft_type)0.5;
+      A[2*ii+1] = (ai - v2) * (fft_type)0.5;
+   }
+}
+#endif
+
+static void ForwardButterflies(fft_type *A, fft_type *B,
+   size_t count, fft_type sin, fft_type cos)
+{
+#ifdef REALFFT_VECTOR_AVX
+   if (count >= 4 && HaveAVX())
+      return ForwardButterfliesAVX(A, B, count, sin, cos);
+#endif
+   size_t ii = 0;
+#ifdef REALFFT_VECTOR_SSE
+   const __m128 vcos = _mm_set1_ps(cos);
+   const __m128 vsin = _mm_setr_ps(sin, -sin, sin, -sin);
+   for (; ii + 2 <= count; ii += 2) {
+      const __m128 a = _mm_loadu_ps(A + 2 * ii);
+      const __m128 b = _mm_loadu_ps(B + 2 * ii);
+      const __m128 t = _mm_add_ps(_mm_mul_ps(b, vcos),
+         _mm_mul_ps(_mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 3, 0, 1)), vsin));
+      _mm_storeu_ps(A + 2 * ii, _mm_sub_ps(a, t));
+      _mm_storeu_ps(B + 2 * ii, _mm_add_ps(a, t));
+   }
+#elif defined(REALFFT_VECTOR_NEON)
+   const float sines[4] = { sin, -sin, sin, -sin };
+   const float32x4_t vsin = vld1q_f32(sines);
+   for (; ii + 2 <= count; ii += 2) {
+      const float32x4_t a = vld1q_f32(A + 2 * ii);
+      const float32x4_t b = vld1q_f32(B + 2 * ii);
+      const float32x4_t t =
+         vmlaq_f32(vmulq_n_f32(b, cos), vrev64q_f32(b), vsin);
+      vst1q_f32(A + 2 * ii, vsubq_f32(a, t));
+      vst1q_f32(B + 2 * ii, vaddq_f32(a, t));
+   }
+#endif
+   for (; ii < count; ++ii) {
+      const fft_type v1 = B[2*ii] * cos + B[2*ii+1] * sin;
+      const fft_type v2 = B[2*ii] * sin - B[2*ii+1] * cos;
+      const fft_type ar = A[2*ii], ai = A[2*ii+1];
+      B[2*ii]   = ar + v1;
+      A[2*ii]   = ar - v1;
+      B[2*ii+1] = ai - v2;
+      A[2*ii+1] = ai + v2;
+   }
+}
+
+static void InverseButterflies(fft_type *A, fft_type *B,
+   size_t count, fft_type sin, fft_type cos)
+{
+#ifdef REALFFT_VECTOR_AVX
+   if (count >= 4 && HaveAVX())
+      return InverseButterfliesAVX(A, B, count, sin, cos);
+#endif
+   size_t ii = 0;
+#ifdef REALFFT_VECTOR_SSE
+   const __m128 vcos = _mm_set1_ps(cos);
+   const __m128 vsin = _mm_setr_ps(-sin, sin, -sin, sin);
+   const __m128 vhalf = _mm_set1_ps(0.5f);
+   for (; ii + 2 <= count; ii += 2) {
+      const __m128 a = _mm_loadu_ps(A + 2 * ii);
+      const __m128 b = _mm_loadu_ps(B + 2 * ii);
+      const __m128 t = _mm_add_ps(_mm_mul_ps(b, vcos),
+         _mm_mul_ps(_mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 3, 0, 1)), vsin));
+      _mm_storeu_ps(A + 2 * ii, _mm_mul_ps(_mm_sub_ps(a, t), vhalf));
+      _mm_storeu_ps(B + 2 * ii, _mm_mul_ps(_mm_add_ps(a, t), vhalf));
+   }
+#elif defined(REALFFT_VECTOR_NEON)
+   const float sines[4] = { -sin, sin, -sin, sin };
+   const float32x4_t vsin = vld1q_f32(sines);
+   for (; ii + 2 <= count; ii += 2) {
+      const float32x4_t a = vld1q_f32(A + 2 * ii);
+      const float32x4_t b = vld1q_f32(B + 2 * ii);
+      const float32x4_t t =
+         vmlaq_f32(vmulq_n_f32(b, cos), vrev64q_f32(b), vsin);
+      vst1q_f32(A + 2 * ii, vmulq_n_f32(vsubq_f32(a, t), 0.5f));
+      vst1q_f32(B + 2 * ii, vmulq_n_f32(vaddq_f32(a, t), 0.5f));
+   }
+#endif
+   for (; ii < count; ++ii) {
+      const fft_type v1 = B[2*ii] * cos - B[2*ii+1] * sin;
+      const fft_type v2 = B[2*ii] * sin + B[2*ii+1] * cos;
+      const fft_type ar = A[2*ii], ai = A[2*ii+1];
+      B[2*ii]   = (ar + v1) * (fft_type)0.5;
+      A[2*ii]   = (ar - v1) * (fft_type)0.5;
+      B[2*ii+1] = (ai + v2) * (fft_type)0.5;
+      A[2*ii+1] = (ai - v2) * (fft_type)0.5;
+   }
+}
+
 /*
 *  Forward FFT routine.  Must call GetFFT(fftlen) first!
 *
@@ -170,7 +350,7 @@ void RealFFTf(fft_type *buffer, const FFTParam *h)
 {
    fft_type *A,*B;
    const fft_type *sptr;
-   const fft_type *endptr1,*endptr2;
+   const fft_type *endptr1;
    const int *br1,*br2;
    fft_type HRplus,HRminus,HIplus,HIminus;
    fft_type v1,v2,sin,cos;
@@ -197,18 +377,9 @@ void RealFFTf(fft_type *buffer, const FFTParam *h)
       {
          sin = *sptr;
          cos = *(sptr+1);
-         endptr2 = B;
-         while(A < endptr2)
-         {
-            v1 = *B * cos + *(B + 1) * sin;
-            v2 = *B * sin - *(B + 1) * cos;
-            *B = (*A + v1);
-            *(A++) = *(B++) - 2 * v1;
-            *B = (*A - v2);
-            *(A++) = *(B++) + 2 * v2;
-         }
-         A = B;
-         B += ButterfliesPerGroup * 2;
+         ForwardButterflies(A, B, ButterfliesPerGroup, sin, cos);
+         A += ButterfliesPerGroup * 4;
+         B = A + ButterfliesPerGroup * 2;
          sptr += 2;
       }
       ButterfliesPerGroup >>= 1;
@@ -272,7 +443,7 @@ void InverseRealFFTf(fft_type *buffer, const FFTParam *h)
 {
    fft_type *A,*B;
    const fft_type *sptr;
-   const fft_type *endptr1,*endptr2;
+   const fft_type *endptr1;
    const int *br1;
    fft_type HRplus,HRminus,HIplus,HIminus;
    fft_type v1,v2,sin,cos;
@@ -334,18 +505,9 @@ void InverseRealFFTf(fft_type *buffer, const FFTParam *h)
       {
          sin = *(sptr++);
          cos = *(sptr++);
-         endptr2 = B;
-         while(A < endptr2)
-         {
-            v1 = *B * cos - *(B + 1) * sin;
-            v2 = *B * sin + *(B + 1) * cos;
-            *B = (*A + v1) * (fft_type)0.5;
-            *(A++) = *(B++) - v1;
-            *B = (*A + v2) * (fft_type)0.5;
-            *(A++) = *(B++) - v2;
-         }
-         A = B;
-         B += ButterfliesPerGroup * 2;
+         InverseButterflies(A, B, ButterfliesPerGroup, sin, cos);
+         A += ButterfliesPerGroup * 4;
+         B = A + ButterfliesPerGroup * 2;
       }
       ButterfliesPerGroup >>= 1;
    }
@@ -29,11 +29,20 @@
 
 RingBuffer::RingBuffer(sampleFormat format, size_t size)
    : mFormat{ format }
-   , mBufferSize{ std::max<size_t>(size, 64) }
+   , mBufferSize{ RoundUpPowerOfTwo( std::max<size_t>(size, 64) ) }
+   , mMask{ mBufferSize - 1 }
    , mBuffer{ mBufferSize, mFormat }
 {
 }
 
+size_t RingBuffer::RoundUpPowerOfTwo( size_t size )
+{
+   size_t result = 1;
+   while ( result < size )
+      result <<= 1;
+   return result;
+}
+
 RingBuffer::~RingBuffer()
 {
 }
@@ -43,7 +52,7 @@ RingBuffer::~RingBuffer()
 
 size_t RingBuffer::Filled( size_t start, size_t end )
 {
-   return (end + mBufferSize - start) % mBufferSize;
+   return (end - start) & mMask;
 }
 
 size_t RingBuffer::Free( size_t start, size_t end )
@@ -88,7 +97,7 @@ size_t RingBuffer::Put(samplePtr buffer, sampleFormat format,
                   block);
 
       src += block * SAMPLE_SIZE(format);
-      pos = (pos + block) % mBufferSize;
+      pos = (pos + block) & mMask;
       samplesToCopy -= block;
       copied += block;
    }
@@ -96,7 +105,7 @@ size_t RingBuffer::Put(samplePtr buffer, sampleFormat format,
    while ( padding ) {
       const auto block = std::min( padding, mBufferSize - pos );
       ClearSamples( mBuffer.ptr(), mFormat, pos, block );
-      pos = (pos + block) % mBufferSize;
+      pos = (pos + block) & mMask;
       padding -= block;
       copied += block;
    }
@@ -121,7 +130,7 @@ size_t RingBuffer::Clear(sampleFormat format, size_t samplesToClear)
 
       ClearSamples(mBuffer.ptr(), format, pos, block);
 
-      pos = (pos + block) % mBufferSize;
+      pos = (pos + block) & mMask;
       samplesToClear -= block;
       cleared += block;
    }
@@ -170,7 +179,7 @@ size_t RingBuffer::Get(samplePtr buffer, sampleFormat format,
                   block);
 
       dest += block * SAMPLE_SIZE(format);
-      start = (start + block) % mBufferSize;
+      start = (start + block) & mMask;
       samplesToCopy -= block;
       copied += block;
    }
@@ -189,7 +198,7 @@ size_t RingBuffer::Discard(size_t samplesToDiscard)
    samplesToDiscard = std::min( samplesToDiscard, Filled( start, end ) );
 
    // Communicate to writer that we have skipped some data, and that's all
-   mStart.store((start + samplesToDiscard) % mBufferSize,
+   mStart.store((start + samplesToDiscard) & mMask,
                 std::memory_order_relaxed);
 
    return samplesToDiscard;
@@ -41,6 +41,10 @@ class RingBuffer {
    size_t Filled( size_t start, size_t end );
    size_t Free( size_t start, size_t end );
 
+   // Least power of two no less than size, so that wrapping of indices
+   // can use masking rather than the more expensive modulo
+   static size_t RoundUpPowerOfTwo( size_t size );
+
    enum : size_t { CacheLine = 64 };
    /*
     // We will do this in C++17 instead:
@@ -52,7 +56,9 @@ class RingBuffer {
    alignas(CacheLine) std::atomic<size_t> mStart { 0 };
    alignas(CacheLine) std::atomic<size_t> mEnd{ 0 };
 
+   // Always a power of two, so (index & mMask) wraps an index
    const size_t  mBufferSize;
+   const size_t  mMask;
 
    sampleFormat  mFormat;
    SampleBuffer  mBuffer;
@@ -43,6 +43,7 @@
 #include <string.h>
 
 #include "Prefs.h"
+#include "Diags.h"
 #include "Dither.h"
 #include "Internat.h"
 
@@ -57,6 +58,120 @@ void InitDitherers()
    gHighQualityDither = Dither::BestDitherChoice();
 }
 
+//
+// The SampleBuffer pool
+//
+
+namespace {
+
+// Power-of-two size classes from 256 bytes to 1 MB; smaller requests
+// round up, larger ones go straight to the heap
+const size_t kMinPoolBlock = 256;
+const size_t kNumPoolClasses = 13;   // kMinPoolBlock << 12 == 1 MB
+const size_t kMaxPoolBlock = kMinPoolBlock << (kNumPoolClasses - 1);
+
+// Surplus a thread may keep before Free() returns blocks to the heap;
+// this is the high-water trim
+const size_t kMaxPooledBytesPerThread = 8 * 1024 * 1024;
+
+// Precedes every block; the alignment keeps the sample data as aligned
+// as malloc left it
+struct alignas(16) PoolBlockHeader {
+   size_t sizeClass;   // index, or (size_t)-1 when unpooled
+};
+
+// Idle blocks parked in the per-thread caches
+DiagMemTag sSampleBufferPoolMemory{ wxT("SampleBuffer pool (idle)") };
+
+size_t ClassBlockSize(size_t sizeClass)
+{
+   return kMinPoolBlock << sizeClass;
+}
+
+size_t ClassForBytes(size_t bytes)
+{
+   size_t sizeClass = 0;
+   while (ClassBlockSize(sizeClass) < bytes)
+      ++sizeClass;
+   return sizeClass;
+}
+
+// Free lists thread themselves through the idle blocks' payloads.  A
+// block may be freed by a thread other than its allocator; it simply
+// joins that thread's cache.
+struct SampleBufferPool {
+   void *freeList[kNumPoolClasses] {};
+   size_t cachedBytes { 0 };
+
+   ~SampleBufferPool()
+   {
+      for (size_t ii = 0; ii < kNumPoolClasses; ++ii) {
+         void *p = freeList[ii];
+         while (p) {
+            void *next = *(void**)p;
+            free((char*)p - sizeof(PoolBlockHeader));
+            p = next;
+         }
+      }
+      if (cachedBytes > 0)
+         sSampleBufferPoolMemory.Adjust( -(long long)cachedBytes );
+   }
+};
+
+thread_local SampleBufferPool sPool;
+
+}
+
+samplePtr SampleBufferAlloc(size_t bytes)
+{
+   if (bytes > kMaxPoolBlock) {
+      const auto header =
+         (PoolBlockHeader*)malloc(sizeof(PoolBlockHeader) + bytes);
+      header->sizeClass = (size_t)-1;
+      return (samplePtr)(header + 1);
+   }
+
+   const auto sizeClass = ClassForBytes(bytes);
+   auto &pool = sPool;
+   if (void *p = pool.freeList[sizeClass]) {
+      pool.freeList[sizeClass] = *(void**)p;
+      pool.cachedBytes -= ClassBlockSize(sizeClass);
+      sSampleBufferPoolMemory.Adjust( -(long long)ClassBlockSize(sizeClass) );
+      return (samplePtr)p;
+   }
+
+   const auto header = (PoolBlockHeader*)
+      malloc(sizeof(PoolBlockHeader) + ClassBlockSize(sizeClass));
+   header->sizeClass = sizeClass;
+   return (samplePtr)(header + 1);
+}
+
+void SampleBufferFree(samplePtr ptr)
+{
+   if (!ptr)
+      return;
+
+   const auto header = (PoolBlockHeader*)ptr - 1;
+   const auto sizeClass = header->sizeClass;
+   if (sizeClass == (size_t)-1) {
+      free(header);
+      return;
+   }
+
+   auto &pool = sPool;
+   const auto blockSize = ClassBlockSize(sizeClass);
+   if (pool.cachedBytes + blockSize > kMaxPooledBytesPerThread) {
+      // Over the budget; give it back to the heap
+      free(header);
+      return;
+   }
+
+   *(void**)ptr = pool.freeList[sizeClass];
+   pool.freeList[sizeClass] = ptr;
+   pool.cachedBytes += blockSize;
+   sSampleBufferPoolMemory.Adjust( (long long)blockSize );
+}
+
 const wxChar *GetSampleFormatStr(sampleFormat format)
 {
    switch(format) {
@@ -50,6 +50,14 @@ const wxChar *GetSampleFormatStr(sampleFormat format);
 // Allocating/Freeing Samples
 //
 
+// Pooled allocation behind SampleBuffer.  Blocks of the common sizes
+// are recycled on per-thread free lists instead of going back to the
+// heap, so steady-state processing -- Mixer construction, effect
+// passes, display requests -- stops allocating once warm.  Each thread
+// holds its surplus to a byte budget, and frees the rest at exit.
+samplePtr SampleBufferAlloc(size_t bytes);
+void SampleBufferFree(samplePtr ptr);
+
 class SampleBuffer {
 
 public:
@@ -57,7 +65,7 @@ public:
       : mPtr(0)
    {}
    SampleBuffer(size_t count, sampleFormat format)
-      : mPtr((samplePtr)malloc(count * SAMPLE_SIZE(format)))
+      : mPtr(SampleBufferAlloc(count * SAMPLE_SIZE(format)))
    {}
    ~SampleBuffer()
    {
@@ -68,14 +76,14 @@ public:
    SampleBuffer &Allocate(size_t count, sampleFormat format)
    {
       Free();
-      mPtr = (samplePtr)malloc(count * SAMPLE_SIZE(format));
+      mPtr = SampleBufferAlloc(count * SAMPLE_SIZE(format));
       return *this;
    }
 
 
    void Free()
    {
-      free(mPtr);
+      SampleBufferFree(mPtr);
       mPtr = 0;
    }
 
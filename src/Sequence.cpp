@@ -32,22 +32,28 @@
 #include "Sequence.h"
 
 #include <algorithm>
+#include <atomic>
 #include <float.h>
 #include <math.h>
+#include <thread>
 
 #include <wx/intl.h>
 #include <wx/filefn.h>
 #include <wx/ffile.h>
 #include <wx/log.h>
+#include <wx/utils.h>
 
 #include "DirManager.h"
 
+#include "blockfile/CompressedBlockFile.h"
 #include "blockfile/SilentBlockFile.h"
 #include "blockfile/SimpleBlockFile.h"
 
 #include "InconsistencyException.h"
+#include "UserException.h"
 
 #include "widgets/AudacityMessageBox.h"
+#include "widgets/ProgressDialog.h"
 
 size_t Sequence::sMaxDiskBlockSize = 1048576;
 
@@ -151,7 +157,8 @@ namespace {
    }
 }
 
-bool Sequence::ConvertToSampleFormat(sampleFormat format)
+bool Sequence::ConvertToSampleFormat(sampleFormat format,
+   ProgressDialog *progress)
 // STRONG-GUARANTEE
 {
    if (format == mSampleFormat)
@@ -182,21 +189,34 @@ bool Sequence::ConvertToSampleFormat(sampleFormat format)
       }
    } );
 
-   BlockArray newBlockArray;
+   const size_t nn = mBlock.size();
+
+   BlockArray newBlockArray{ ScratchBlockArray() };
    // Use the ratio of old to NEW mMaxSamples to make a reasonable guess
    // at allocation.
    newBlockArray.reserve
-      (1 + mBlock.size() * ((float)oldMaxSamples / (float)mMaxSamples));
-
-   {
+      (1 + nn * ((float)oldMaxSamples / (float)mMaxSamples));
+
+   // Each worker converts a contiguous range of blocks into its own
+   // array; block file creation is thread-safe (see
+   // DirManager::NewBlockFile) and block starts are absolute, so the
+   // partial arrays concatenate in order afterwards.  Nothing is
+   // published until every worker succeeds, preserving the strong
+   // guarantee; a cancelled or failed conversion just drops the partial
+   // arrays, dereferencing their NEW block files.
+   std::atomic<size_t> blocksDone{ 0 };
+   std::atomic<bool> cancelled{ false };
+
+   auto convertRange =
+   [&](size_t from, size_t to, BlockArray &list) {
       size_t oldSize = oldMaxSamples;
       SampleBuffer bufferOld(oldSize, oldFormat);
       size_t newSize = oldMaxSamples;
       SampleBuffer bufferNew(newSize, format);
 
-      for (size_t i = 0, nn = mBlock.size(); i < nn; i++)
+      for (size_t i = from; i < to && !cancelled.load(); i++)
       {
-         SeqBlock &oldSeqBlock = mBlock[i];
+         const SeqBlock &oldSeqBlock = mBlock[i];
          const auto &oldBlockFile = oldSeqBlock.f;
          const auto len = oldBlockFile->GetLength();
          ensureSampleBufferSize(bufferOld, oldFormat, oldSize, len);
@@ -217,8 +237,58 @@ bool Sequence::ConvertToSampleFormat(sampleFormat format)
          // Using Blockify will handle the cases where len > the NEW mMaxSamples. Previous code did not.
          const auto blockstart = oldSeqBlock.start;
          Blockify(*mDirManager, mMaxSamples, mSampleFormat,
-                  newBlockArray, blockstart, bufferNew.ptr(), len);
+                  list, blockstart, bufferNew.ptr(), len);
+
+         ++blocksDone;
       }
+   };
+
+   {
+      // Conversion of a block is mostly disk work; more threads than
+      // this pay off only for long sequences
+      const unsigned nThreads = std::min<unsigned>(
+         std::max(1u, std::thread::hardware_concurrency()),
+         1 + nn / 16 );
+
+      std::vector<BlockArray> partials(nThreads);
+      std::vector<std::exception_ptr> errors(nThreads);
+      std::vector<std::thread> threads;
+      const size_t chunk = (nn + nThreads - 1) / nThreads;
+      for (unsigned w = 0; w < nThreads; ++w)
+         threads.emplace_back([&, w]{
+            try {
+               convertRange(w * chunk, std::min(nn, (w + 1) * chunk),
+                  partials[w]);
+            }
+            catch (...) {
+               errors[w] = std::current_exception();
+               cancelled.store(true);
+            }
+         });
+
+      // Report progress on this thread while the workers convert; the
+      // user may cancel here
+      while (blocksDone.load() < nn && !cancelled.load()) {
+         if (progress) {
+            auto updateResult = progress->Update(
+               (long long)blocksDone.load(), (long long)nn);
+            if (updateResult != ProgressResult::Success)
+               cancelled.store(true);
+         }
+         wxMilliSleep(50);
+      }
+      for (auto &thread : threads)
+         thread.join();
+
+      for (unsigned w = 0; w < nThreads; ++w)
+         if (errors[w])
+            std::rethrow_exception(errors[w]);
+      if (cancelled.load())
+         throw UserException{};
+
+      for (auto &partial : partials)
+         newBlockArray.insert(
+            newBlockArray.end(), partial.begin(), partial.end() );
    }
 
    // Invalidate all the old, non-aliased block files.
@@ -234,6 +304,344 @@ bool Sequence::ConvertToSampleFormat(sampleFormat format)
    return true;
 }
 
+namespace {
+
+struct BlockStats { float min; float max; double sumsq; sampleCount length; };
+
+// Minimum count of whole blocks in a walk before threads pay off
+const unsigned parallelBlockWalkThreshold = 16384;
+
+// Accumulate min, max, and sum of squares of the whole blocks in
+// [block0, block1), from the per-block statistics held in memory.  Long
+// walks, as over a multi-hour track, are split across threads.
+BlockStats WalkBlockStats(const BlockArray &blocks,
+   unsigned block0, unsigned block1, bool mayThrow)
+{
+   auto walk = [&blocks, mayThrow](unsigned from, unsigned to) {
+      BlockStats result{ FLT_MAX, -FLT_MAX, 0.0, 0 };
+      for (unsigned b = from; b < to; ++b) {
+         const auto &theFile = blocks[b].f;
+         auto results = theFile->GetMinMaxRMS(mayThrow);
+
+         if (results.min < result.min)
+            result.min = results.min;
+         if (results.max > result.max)
+            result.max = results.max;
+         const auto fileLen = theFile->GetLength();
+         result.sumsq += (double)results.RMS * results.RMS * fileLen;
+         result.length += fileLen;
+      }
+      return result;
+   };
+
+   if (block1 <= block0)
+      return { FLT_MAX, -FLT_MAX, 0.0, 0 };
+
+   const unsigned nBlocks = block1 - block0;
+   const unsigned nThreads = std::min<unsigned>(
+      std::max(1u, std::thread::hardware_concurrency()),
+      nBlocks / (parallelBlockWalkThreshold / 4) );
+   if (nBlocks < parallelBlockWalkThreshold || nThreads < 2)
+      return walk(block0, block1);
+
+   std::vector<BlockStats> partials(nThreads);
+   std::vector<std::thread> threads;
+   const unsigned chunk = (nBlocks + nThreads - 1) / nThreads;
+   for (unsigned w = 1; w < nThreads; ++w)
+      threads.emplace_back([&, w]{
+         partials[w] = walk(block0 + w * chunk,
+            std::min(block1, block0 + (w + 1) * chunk));
+      });
+   partials[0] = walk(block0, block0 + chunk);
+   for (auto &thread : threads)
+      thread.join();
+
+   auto result = partials[0];
+   for (unsigned w = 1; w < nThreads; ++w) {
+      if (partials[w].min < result.min)
+         result.min = partials[w].min;
+      if (partials[w].max > result.max)
+         result.max = partials[w].max;
+      result.sumsq += partials[w].sumsq;
+      result.length += partials[w].length;
+   }
+   return result;
+}
+
+// Number of whole blocks combined into each cached third-level summary
+// group; on the order of sixteen million frames at the default block sizes
+const size_t blockGroupSize = 64;
+
+// Samples per node at the base level of the summary pyramid, matching
+// the block files' own summary frame size
+const size_t pyramidBaseSamples = 256;
+
+}
+
+auto Sequence::ComputeGroupStats(size_t group) const -> BlockGroupStats
+{
+   BlockGroupStats result{ FLT_MAX, -FLT_MAX, 0.0, 0, true };
+   const size_t b0 = group * blockGroupSize;
+   const size_t b1 = std::min(mBlock.size(), b0 + blockGroupSize);
+   for (size_t b = b0; b < b1; ++b) {
+      const auto &theFile = mBlock[b].f;
+      if (!theFile->IsSummaryAvailable()) {
+         // An on-demand block whose statistics may still change; walk
+         // this group per query until the summary is computed
+         result.cached = false;
+         return result;
+      }
+      auto results = theFile->GetMinMaxRMS(false);
+      if (results.min < result.min)
+         result.min = results.min;
+      if (results.max > result.max)
+         result.max = results.max;
+      const auto fileLen = theFile->GetLength();
+      result.sumsq += (double)results.RMS * results.RMS * fileLen;
+      result.length += fileLen;
+   }
+   return result;
+}
+
+void Sequence::RebuildGroupStats() const
+{
+   // Cache only complete groups; the trailing partial group is cheap to
+   // walk and is where appends land
+   const size_t nGroups = mBlock.size() / blockGroupSize;
+   mGroupStats.clear();
+   mGroupStats.reserve(nGroups);
+   for (size_t group = 0; group < nGroups; ++group)
+      mGroupStats.push_back(ComputeGroupStats(group));
+   mGroupStatsValid = true;
+}
+
+void Sequence::UpdateGroupStatsForAppend(size_t unchangedBlocks)
+{
+   if (!mGroupStatsValid)
+      return;
+
+   // Drop any group the append reached into, then extend with the
+   // groups the new blocks completed
+   const size_t firstDirtyGroup = unchangedBlocks / blockGroupSize;
+   if (mGroupStats.size() > firstDirtyGroup)
+      mGroupStats.resize(firstDirtyGroup);
+   const size_t nGroups = mBlock.size() / blockGroupSize;
+   for (size_t group = mGroupStats.size(); group < nGroups; ++group)
+      mGroupStats.push_back(ComputeGroupStats(group));
+}
+
+auto Sequence::GatherBlockStats
+   (size_t block0, size_t block1, bool mayThrow) const -> BlockGroupStats
+{
+   BlockGroupStats result{ FLT_MAX, -FLT_MAX, 0.0, 0, true };
+   auto fold = [&result](const BlockStats &stats) {
+      if (stats.min < result.min)
+         result.min = stats.min;
+      if (stats.max > result.max)
+         result.max = stats.max;
+      result.sumsq += stats.sumsq;
+      result.length += stats.length;
+   };
+
+   if (block1 <= block0)
+      return result;
+
+   // Short walks don't repay consulting the cache
+   if (block1 - block0 < 2 * blockGroupSize) {
+      fold(WalkBlockStats(mBlock, block0, block1, mayThrow));
+      return result;
+   }
+
+   if (!mGroupStatsValid)
+      RebuildGroupStats();
+
+   const size_t firstGroup = (block0 + blockGroupSize - 1) / blockGroupSize;
+   const size_t lastGroup = std::min(mGroupStats.size(),
+      block1 / blockGroupSize);
+
+   // The cache may cover fewer groups than the range when blocks were
+   // appended without extending it
+   if (lastGroup <= firstGroup) {
+      fold(WalkBlockStats(mBlock, block0, block1, mayThrow));
+      return result;
+   }
+
+   fold(WalkBlockStats(mBlock, block0, firstGroup * blockGroupSize, mayThrow));
+   for (size_t group = firstGroup; group < lastGroup; ++group) {
+      const auto &stats = mGroupStats[group];
+      if (stats.cached) {
+         if (stats.min < result.min)
+            result.min = stats.min;
+         if (stats.max > result.max)
+            result.max = stats.max;
+         result.sumsq += stats.sumsq;
+         result.length += stats.length;
+      }
+      else
+         fold(WalkBlockStats(mBlock, group * blockGroupSize,
+            (group + 1) * blockGroupSize, mayThrow));
+   }
+   fold(WalkBlockStats(mBlock, lastGroup * blockGroupSize, block1, mayThrow));
+
+   return result;
+}
+
+bool Sequence::UpdateSummaryPyramid() const
+{
+   if (!mPyramid.empty())
+      return true;
+   for (const auto &seqBlock : mBlock)
+      if (!seqBlock.f->IsSummaryAvailable())
+         // Some on-demand block is still loading; retry on a later query
+         return false;
+   return RebuildSummaryPyramidFrom(0);
+}
+
+bool Sequence::RebuildSummaryPyramidFrom(size_t firstChangedBlock) const
+{
+   const auto nNodes =
+      ((mNumSamples + (pyramidBaseSamples - 1)) / pyramidBaseSamples)
+         .as_size_t();
+
+   if (mPyramid.empty())
+      mPyramid.resize(1);
+   auto &base = mPyramid[0];
+   const size_t firstNode = firstChangedBlock < mBlock.size()
+      ? (mBlock[firstChangedBlock].start / pyramidBaseSamples).as_size_t()
+      : nNodes;
+   base.resize(nNodes);
+   for (size_t node = firstNode; node < nNodes; ++node)
+      base[node] = { FLT_MAX, -FLT_MAX, 0.0f };
+
+   // Fold each block's summary frames into the grid nodes they overlap.
+   // Blocks need not start on grid boundaries, so a frame straddling two
+   // nodes widens the min and max of both, and apportions its energy
+   Floats temp{ 3 * ((mMaxSamples + pyramidBaseSamples - 1) /
+      pyramidBaseSamples) };
+   for (size_t b = firstChangedBlock; b < mBlock.size(); ++b) {
+      const SeqBlock &seqBlock = mBlock[b];
+      const auto &theFile = seqBlock.f;
+      if (!theFile->IsSummaryAvailable()) {
+         mPyramid.clear();
+         return false;
+      }
+      const auto blockLen = theFile->GetLength();
+      const size_t frames =
+         (blockLen + pyramidBaseSamples - 1) / pyramidBaseSamples;
+      // This function fills with zeroes if the read fails
+      theFile->Read256(temp.get(), 0, frames);
+      for (size_t frame = 0; frame < frames; ++frame) {
+         const float *const pv = temp.get() + 3 * frame;
+         const auto s0 = seqBlock.start + frame * pyramidBaseSamples;
+         const auto s1 = std::min(
+            seqBlock.start + blockLen, s0 + pyramidBaseSamples);
+         const size_t node0 = (s0 / pyramidBaseSamples).as_size_t();
+         const size_t node1 = ((s1 - 1) / pyramidBaseSamples).as_size_t();
+         for (size_t node = node0; node <= node1 && node < nNodes; ++node) {
+            auto &entry = base[node];
+            if (pv[0] < entry.min)
+               entry.min = pv[0];
+            if (pv[1] > entry.max)
+               entry.max = pv[1];
+            const auto overlap =
+               std::min(s1, sampleCount((node + 1) * pyramidBaseSamples)) -
+               std::max(s0, sampleCount(node * pyramidBaseSamples));
+            entry.sumsq += pv[2] * pv[2] * overlap.as_double();
+         }
+      }
+   }
+   for (size_t node = firstNode; node < nNodes; ++node) {
+      auto &entry = base[node];
+      if (entry.min > entry.max)
+         entry.min = entry.max = 0.0f;
+   }
+
+   // Refold the coarser levels above the changed region
+   size_t level = 1;
+   for (; mPyramid[level - 1].size() > 1; ++level) {
+      const auto &finer = mPyramid[level - 1];
+      if (mPyramid.size() <= level)
+         mPyramid.resize(level + 1);
+      auto &coarser = mPyramid[level];
+      const size_t nCoarse = (finer.size() + 1) / 2;
+      coarser.resize(nCoarse);
+      for (size_t node = firstNode >> level; node < nCoarse; ++node) {
+         auto &entry = coarser[node];
+         entry = finer[2 * node];
+         if (2 * node + 1 < finer.size()) {
+            const auto &other = finer[2 * node + 1];
+            if (other.min < entry.min)
+               entry.min = other.min;
+            if (other.max > entry.max)
+               entry.max = other.max;
+            entry.sumsq += other.sumsq;
+         }
+      }
+   }
+   mPyramid.resize(level);
+
+   return true;
+}
+
+bool Sequence::GetPyramidDisplay(float *min, float *max, float *rms, int* bl,
+   size_t len, const sampleCount *where) const
+{
+   // Find the narrowest column; fisheye queries make them non-uniform
+   auto narrowest = mNumSamples;
+   for (decltype(len) pixel = 0; pixel < len; ++pixel) {
+      const auto width = where[pixel + 1] - where[pixel];
+      if (width < narrowest)
+         narrowest = width;
+   }
+   // Resolve from the pyramid only when the level that fits still gives
+   // at least two nodes per column; closer zooms read sample data or
+   // per-block summaries as before
+   if (narrowest < sampleCount(2 * pyramidBaseSamples))
+      return false;
+
+   if (!UpdateSummaryPyramid())
+      return false;
+
+   size_t level = 0;
+   while (level + 1 < mPyramid.size() &&
+      sampleCount(2 * (pyramidBaseSamples << (level + 1))) <= narrowest)
+      ++level;
+   const auto &nodes = mPyramid[level];
+   const size_t span = pyramidBaseSamples << level;
+   if (nodes.empty())
+      return false;
+
+   for (decltype(len) pixel = 0; pixel < len; ++pixel) {
+      const auto s0 = std::min(mNumSamples - 1,
+         std::max(sampleCount(0), where[pixel]));
+      const auto s1 = std::min(mNumSamples, std::max(s0 + 1,
+         where[pixel + 1]));
+      const size_t node0 = (s0 / span).as_size_t();
+      const size_t node1 =
+         std::min(nodes.size() - 1, ((s1 - 1) / span).as_size_t());
+
+      PyramidNode folded = nodes[node0];
+      for (size_t node = node0 + 1; node <= node1; ++node) {
+         const auto &entry = nodes[node];
+         if (entry.min < folded.min)
+            folded.min = entry.min;
+         if (entry.max > folded.max)
+            folded.max = entry.max;
+         folded.sumsq += entry.sumsq;
+      }
+      const auto covered =
+         std::min(mNumSamples, sampleCount((node1 + 1) * span)) -
+         sampleCount(node0 * span);
+      min[pixel] = folded.min;
+      max[pixel] = folded.max;
+      rms[pixel] = (float)sqrt(folded.sumsq / covered.as_double());
+      // All summaries were available, so no column is still loading;
+      // only the sign of this is consulted
+      bl[pixel] = 1;
+   }
+   return true;
+}
+
 std::pair<float, float> Sequence::GetMinMax(
    sampleCount start, sampleCount len, bool mayThrow) const
 {
@@ -257,9 +665,8 @@ std::pair<float, float> Sequence::GetMinMax(
    // this is very fast because we have the min/max of every entire block
    // already in memory.
 
-   for (unsigned b = block0 + 1; b < block1; ++b) {
-      auto results = mBlock[b].f->GetMinMaxRMS(mayThrow);
-
+   {
+      const auto results = GatherBlockStats(block0 + 1, block1, mayThrow);
       if (results.min < min)
          min = results.min;
       if (results.max > max)
@@ -316,6 +723,51 @@ std::pair<float, float> Sequence::GetMinMax(
    return { min, max };
 }
 
+// Add to sumsq the sum of squares over a partial block, preferring the
+// stored 256-sample summaries and reading raw samples only for the frames
+// cut by the edges of the range
+static void PartialBlockSumsq( const SeqBlock &theBlock,
+   size_t s0, size_t l0, bool mayThrow, double &sumsq )
+{
+   const auto &theFile = theBlock.f;
+
+   // The frames lying wholly inside [s0, s0 + l0); a frame cut short by the
+   // end of the block does not count as whole and is left to the raw tail
+   const size_t g0 = (s0 + 255) / 256;
+   const size_t g1 = (s0 + l0) / 256;
+
+   if (g1 > g0) {
+      const auto nGroups = g1 - g0;
+      Floats buffer{ nGroups * 3 };
+      if (theFile->Read256(buffer.get(), g0, nGroups)) {
+         for (size_t g = 0; g < nGroups; ++g) {
+            const double rms = buffer[3 * g + 2];
+            sumsq += rms * rms * 256;
+         }
+
+         // Refine the partial frames at the edges from raw samples
+         const size_t head = g0 * 256 - s0;
+         if (head > 0) {
+            const auto results = theFile->GetMinMaxRMS(s0, head, mayThrow);
+            sumsq += results.RMS * results.RMS * head;
+         }
+         const size_t tail = s0 + l0 - g1 * 256;
+         if (tail > 0) {
+            const auto results =
+               theFile->GetMinMaxRMS(g1 * 256, tail, mayThrow);
+            sumsq += results.RMS * results.RMS * tail;
+         }
+
+         return;
+      }
+      // Summary not available, such as for a block still loading on
+      // demand; fall through to the raw computation
+   }
+
+   const auto results = theFile->GetMinMaxRMS(s0, l0, mayThrow);
+   sumsq += results.RMS * results.RMS * l0;
+}
+
 float Sequence::GetRMS(sampleCount start, sampleCount len, bool mayThrow) const
 {
    // len is the number of samples that we want the rms of.
@@ -332,15 +784,10 @@ float Sequence::GetRMS(sampleCount start, sampleCount len, bool mayThrow) const
    // First calculate the rms of the blocks in the middle of this region;
    // this is very fast because we have the rms of every entire block
    // already in memory.
-   for (unsigned b = block0 + 1; b < block1; b++) {
-      const SeqBlock &theBlock = mBlock[b];
-      const auto &theFile = theBlock.f;
-      auto results = theFile->GetMinMaxRMS(mayThrow);
-
-      const auto fileLen = theFile->GetLength();
-      const auto blockRMS = results.RMS;
-      sumsq += blockRMS * blockRMS * fileLen;
-      length += fileLen;
+   {
+      const auto results = GatherBlockStats(block0 + 1, block1, mayThrow);
+      sumsq += results.sumsq;
+      length += results.length;
    }
 
    // Now we take the first and last blocks into account, noting that the
@@ -357,23 +804,18 @@ float Sequence::GetRMS(sampleCount start, sampleCount len, bool mayThrow) const
       wxASSERT(maxl0 <= mMaxSamples); // Vaughan, 2011-10-19
       const auto l0 = limitSampleBufferSize( maxl0, len );
 
-      auto results = theFile->GetMinMaxRMS(s0, l0, mayThrow);
-      const auto partialRMS = results.RMS;
-      sumsq += partialRMS * partialRMS * l0;
+      PartialBlockSumsq(theBlock, s0, l0, mayThrow, sumsq);
       length += l0;
    }
 
    if (block1 > block0) {
       const SeqBlock &theBlock = mBlock[block1];
-      const auto &theFile = theBlock.f;
 
       // start + len - 1 lies within theBlock
       const auto l0 = ( start + len - theBlock.start ).as_size_t();
       wxASSERT(l0 <= mMaxSamples); // PRL: I think Vaughan missed this
 
-      auto results = theFile->GetMinMaxRMS(0, l0, mayThrow);
-      const auto partialRMS = results.RMS;
-      sumsq += partialRMS * partialRMS * l0;
+      PartialBlockSumsq(theBlock, 0, l0, mayThrow, sumsq);
       length += l0;
    }
 
@@ -383,6 +825,52 @@ float Sequence::GetRMS(sampleCount start, sampleCount len, bool mayThrow) const
    return sqrt(sumsq / length.as_double() );
 }
 
+bool Sequence::GetSummaries256(sampleCount start, sampleCount len,
+   std::vector<SummaryFrame> &results) const
+{
+   if (len == 0 || mBlock.size() == 0)
+      return true;
+
+   unsigned int block0 = FindBlock(start);
+   unsigned int block1 = FindBlock(start + len - 1);
+
+   const auto originalSize = results.size();
+
+   for (unsigned int b = block0; b <= block1; ++b) {
+      const SeqBlock &theBlock = mBlock[b];
+      const auto &theFile = theBlock.f;
+      const auto fileLen = theFile->GetLength();
+
+      // The range of summary groups of this block that the query overlaps
+      size_t g0 = 0;
+      auto g1 = (fileLen + 255) / 256;
+      if (b == block0)
+         g0 = ( start - theBlock.start ).as_size_t() / 256;
+      if (b == block1)
+         g1 = std::min( g1,
+            ( start + len - 1 - theBlock.start ).as_size_t() / 256 + 1 );
+      const auto nGroups = g1 - g0;
+
+      Floats buffer{ nGroups * 3 };
+      if (!theFile->Read256(buffer.get(), g0, nGroups)) {
+         // Summary not available, such as for a block still loading
+         // on demand
+         results.resize(originalSize);
+         return false;
+      }
+
+      for (size_t g = 0; g < nGroups; ++g) {
+         const auto first = theBlock.start + (g0 + g) * 256;
+         const auto last =
+            std::min( first + 256, theBlock.start + fileLen );
+         results.push_back( { first, ( last - first ).as_size_t(),
+            buffer[3 * g], buffer[3 * g + 1] } );
+      }
+   }
+
+   return true;
+}
+
 std::unique_ptr<Sequence> Sequence::Copy(sampleCount s0, sampleCount s1) const
 {
    auto dest = std::make_unique<Sequence>(mDirManager, mSampleFormat);
@@ -458,15 +946,61 @@ namespace {
       return numSamples > wxLL(9223372036854775807);
    }
 
+   bool IsAllZero( samplePtr sampleData, size_t sampleLen,
+                   sampleFormat format )
+   {
+      // All three sample formats represent digital silence as zero bytes.
+      // (A negative float zero is not detected, but recording and import
+      // produce only positive zeros.)
+      const size_t nBytes = sampleLen * SAMPLE_SIZE(format);
+      const char *bytes = sampleData;
+      size_t ii = 0;
+      // Word-sized stride for the bulk of the scan
+      for (; ii + sizeof(size_t) <= nBytes; ii += sizeof(size_t)) {
+         size_t word;
+         memcpy(&word, bytes + ii, sizeof(word));
+         if (word != 0)
+            return false;
+      }
+      for (; ii < nBytes; ++ii)
+         if (bytes[ii] != 0)
+            return false;
+      return true;
+   }
+
    BlockFilePtr NewSimpleBlockFile( DirManager &dm,
                                     samplePtr sampleData, size_t sampleLen,
                                     sampleFormat format,
                                     bool allowDeferredWrite = false)
    {
-      return dm.NewBlockFile( [&]( wxFileNameWrapper filePath ) {
+      // Digital silence -- unused channels of multichannel recordings,
+      // gaps in conformed imports -- needs no data file at all, and
+      // reads back for free
+      if (IsAllZero(sampleData, sampleLen, format))
+         return make_blockfile<SilentBlockFile>(sampleLen);
+
+      // Blocks are immutable once created, so a block with identical
+      // contents can simply be shared by reference instead of writing
+      // another copy of the same samples to disk
+      const auto contentHash =
+         BlockFile::ContentHash(sampleData, sampleLen, format);
+      if (auto existing = dm.FindIdenticalBlockFile(contentHash, sampleLen))
+         return existing;
+
+      auto result = dm.NewBlockFile(
+            [&]( wxFileNameWrapper filePath ) -> BlockFilePtr {
+#ifdef USE_LIBFLAC
+         // FLAC is lossless only for integer samples
+         if (format != floatSample &&
+             CompressedBlockFile::GetCompressNewBlocks())
+            return make_blockfile<CompressedBlockFile>(
+               std::move(filePath), sampleData, sampleLen, format);
+#endif
          return make_blockfile<SimpleBlockFile>(
             std::move(filePath), sampleData, sampleLen, format, allowDeferredWrite);
       } );
+      dm.RegisterContentHash(contentHash, result);
+      return result;
    }
 }
 
@@ -519,7 +1053,9 @@ void Sequence::Paste(sampleCount s, const Sequence *src)
       // minimum size
 
       // Build and swap a copy so there is a strong exception safety guarantee
-      BlockArray newBlock{ mBlock };
+      BlockArray newBlock{ ScratchBlockArray() };
+      newBlock.reserve(numBlocks + srcNumBlocks);
+      newBlock.insert(newBlock.end(), mBlock.begin(), mBlock.end());
       sampleCount samples = mNumSamples;
       for (unsigned int i = 0; i < srcNumBlocks; i++)
          // AppendBlock may throw for limited disk space, if pasting from
@@ -585,7 +1121,7 @@ void Sequence::Paste(sampleCount s, const Sequence *src)
    // it's simplest to just lump all the data together
    // into one big block along with the split block,
    // then resplit it all
-   BlockArray newBlock;
+   BlockArray newBlock{ ScratchBlockArray() };
    newBlock.reserve(numBlocks + srcNumBlocks + 2);
    newBlock.insert(newBlock.end(), mBlock.begin(), mBlock.begin() + b);
 
@@ -1087,6 +1623,71 @@ int Sequence::FindBlock(sampleCount pos) const
 }
 
 //static
+SequenceFloatView::SequenceFloatView(
+   const float *data, size_t length, BlockFilePtr pFile)
+   : mData{ data }, mLength{ length }, mFile{ std::move( pFile ) }
+{
+}
+
+SequenceFloatView::SequenceFloatView(SequenceFloatView &&other)
+   : mData{ other.mData }
+   , mLength{ other.mLength }
+   , mFile{ std::move( other.mFile ) }
+{
+   other.mData = nullptr;
+   other.mLength = 0;
+}
+
+SequenceFloatView &SequenceFloatView::operator=(SequenceFloatView &&other)
+{
+   if (this != &other) {
+      Release();
+      mData = other.mData;
+      mLength = other.mLength;
+      mFile = std::move( other.mFile );
+      other.mData = nullptr;
+      other.mLength = 0;
+   }
+   return *this;
+}
+
+SequenceFloatView::~SequenceFloatView()
+{
+   Release();
+}
+
+void SequenceFloatView::Release()
+{
+   if (mFile)
+      mFile->UnlockRead();
+   mFile.reset();
+   mData = nullptr;
+   mLength = 0;
+}
+
+SequenceFloatView Sequence::GetFloatView(sampleCount start, size_t len) const
+{
+   if (mSampleFormat != floatSample || len == 0 ||
+       start < 0 || start + len > mNumSamples)
+      return {};
+   const SeqBlock &block = mBlock[ FindBlock(start) ];
+   // start is in block
+   const auto bstart = ( start - block.start ).as_size_t();
+   if (bstart + len > block.f->GetLength())
+      // Spans a block boundary; the caller must fall back to Get()
+      return {};
+   // Hold the read lock while asking whether the data is resident, so a
+   // concurrent fill or eviction cannot invalidate the answer
+   block.f->LockRead();
+   const auto data = block.f->GetCachedFloats();
+   if (!data) {
+      block.f->UnlockRead();
+      return {};
+   }
+   // The view adopts the lock taken above
+   return { data + bstart, len, block.f };
+}
+
 bool Sequence::Read(samplePtr buffer, sampleFormat format,
                     const SeqBlock &b, size_t blockRelativeStart, size_t len,
                     bool mayThrow)
@@ -1168,7 +1769,8 @@ void Sequence::SetSamples(samplePtr buffer, sampleFormat format,
    }
 
    int b = FindBlock(start);
-   BlockArray newBlock;
+   BlockArray newBlock{ ScratchBlockArray() };
+   newBlock.reserve(mBlock.size() + 1);
    std::copy( mBlock.begin(), mBlock.begin() + b, std::back_inserter(newBlock) );
 
    while (len > 0
@@ -1314,6 +1916,12 @@ bool Sequence::GetWaveDisplay(float *min, float *max, float *rms, int* bl,
    // ... unless the mNumSamples ceiling applies, and then there are other defenses
    const auto s1 =
       std::min(mNumSamples, std::max(1 + where[len - 1], where[len]));
+
+   // When zoomed out far enough, resolve every column from the summary
+   // pyramid in memory, with no summary file reads at all
+   if (GetPyramidDisplay(min, max, rms, bl, len, where))
+      return true;
+
    Floats temp{ mMaxSamples };
 
    decltype(len) pixel = 0;
@@ -1533,7 +2141,7 @@ void Sequence::Append(samplePtr buffer, sampleFormat format,
    if (Overflows(mNumSamples.as_double() + ((double)len)))
       THROW_INCONSISTENCY_EXCEPTION;
 
-   BlockArray newBlock;
+   BlockArray newBlock{ ScratchBlockArray() };
    sampleCount newNumSamples = mNumSamples;
 
    // If the last block is not full, we need to add samples to it
@@ -1618,6 +2226,48 @@ void Sequence::Append(samplePtr buffer, sampleFormat format,
 #endif
 }
 
+void Sequence::CoalesceTrailingBlocks()
+// STRONG-GUARANTEE
+{
+   const size_t numBlocks = mBlock.size();
+   if (numBlocks < 2)
+      return;
+
+   // Find the longest run of trailing blocks, each smaller than the
+   // minimum, that fit together within one block
+   size_t first = numBlocks;
+   size_t total = 0;
+   while (first > 0) {
+      const auto len = mBlock[first - 1].f->GetLength();
+      if (len >= mMinSamples || total + len > mMaxSamples)
+         break;
+      total += len;
+      --first;
+   }
+   if (numBlocks - first < 2)
+      return;
+
+   SampleBuffer buffer(total, mSampleFormat);
+   size_t pos = 0;
+   for (size_t i = first; i < numBlocks; ++i) {
+      const SeqBlock &block = mBlock[i];
+      const auto len = block.f->GetLength();
+      Read(buffer.ptr() + pos * SAMPLE_SIZE(mSampleFormat), mSampleFormat,
+           block, 0, len, true);
+      pos += len;
+   }
+
+   BlockArray newBlocks{ ScratchBlockArray() };
+   newBlocks.reserve(first + 1);
+   newBlocks.insert(newBlocks.end(), mBlock.begin(), mBlock.begin() + first);
+   newBlocks.push_back(SeqBlock(
+      NewSimpleBlockFile(*mDirManager, buffer.ptr(), total, mSampleFormat),
+      mBlock[first].start));
+
+   CommitChangesIfConsistent
+      (newBlocks, mNumSamples, wxT("CoalesceTrailingBlocks"));
+}
+
 void Sequence::Blockify
    (DirManager &mDirManager, size_t mMaxSamples, sampleFormat mSampleFormat,
     BlockArray &list, sampleCount start, samplePtr buffer, size_t len)
@@ -1718,7 +2368,7 @@ void Sequence::Delete(sampleCount start, sampleCount len)
    }
 
    // Create a NEW array of blocks
-   BlockArray newBlock;
+   BlockArray newBlock{ ScratchBlockArray() };
    newBlock.reserve(numBlocks - (b1 - b0) + 2);
 
    // Copy the blocks before the deletion point over to
@@ -1827,6 +2477,25 @@ void Sequence::ConsistencyCheck(const wxChar *whereStr, bool mayThrow) const
    ConsistencyCheck(mBlock, mMaxSamples, 0, mNumSamples, whereStr, mayThrow);
 }
 
+namespace {
+   // Above this many unchecked blocks the exhaustive walk makes every
+   // edit take seconds on big projects; switch to the sampled strategy.
+   const size_t kExhaustiveCheckLimit = 10000;
+
+   // Blocks verified exactly at the sequence ends and around the edited
+   // neighborhood when sampling.
+   const size_t kCheckNeighborhood = 100;
+
+   // Randomly sampled block joints checked besides the neighborhoods.
+   const size_t kCheckSampleCount = 1000;
+
+   // Every so many sampled checks, walk everything anyway, so a
+   // corruption that sampling missed still surfaces soon after.
+   const unsigned kExhaustiveCheckPeriod = 50;
+
+   unsigned sConsistencyCheckCount = 0;
+}
+
 void Sequence::ConsistencyCheck
    (const BlockArray &mBlock, size_t maxSamples, size_t from,
     sampleCount mNumSamples, const wxChar *whereStr,
@@ -1837,29 +2506,67 @@ void Sequence::ConsistencyCheck
    // gives a little more discrimination
    InconsistencyException ex;
 
-   unsigned int numBlocks = mBlock.size();
-
-   unsigned int i;
-   sampleCount pos = from < numBlocks ? mBlock[from].start : mNumSamples;
-   if ( from == 0 && pos != 0 )
-      ex = CONSTRUCT_INCONSISTENCY_EXCEPTION, bError = true;
-
-   for (i = from; !bError && i < numBlocks; i++) {
-      const SeqBlock &seqBlock = mBlock[i];
-      if (pos != seqBlock.start)
-         ex = CONSTRUCT_INCONSISTENCY_EXCEPTION, bError = true;
+   const size_t numBlocks = mBlock.size();
 
-      if ( seqBlock.f ) {
+   // Checks that the blocks in [lo, hi) have sane lengths and abut their
+   // right-hand neighbors.  Together with the endpoint checks below, a
+   // pass over [from, numBlocks) is equivalent to the old running-position
+   // walk; but joints can also be checked piecemeal.
+   auto checkRange = [&]( size_t lo, size_t hi )
+   {
+      for (size_t i = lo; !bError && i < hi && i < numBlocks; i++) {
+         const SeqBlock &seqBlock = mBlock[i];
+         if ( !seqBlock.f ) {
+            ex = CONSTRUCT_INCONSISTENCY_EXCEPTION, bError = true;
+            break;
+         }
          const auto length = seqBlock.f->GetLength();
          if (length > maxSamples)
             ex = CONSTRUCT_INCONSISTENCY_EXCEPTION, bError = true;
-         pos += length;
+         else if (i + 1 < numBlocks &&
+                  mBlock[i + 1].start != seqBlock.start + length)
+            ex = CONSTRUCT_INCONSISTENCY_EXCEPTION, bError = true;
       }
-      else
+   };
+
+   // The endpoints must always line up exactly.
+   if (numBlocks == 0) {
+      if ( from == 0 && mNumSamples != 0 )
+         ex = CONSTRUCT_INCONSISTENCY_EXCEPTION, bError = true;
+   }
+   else {
+      if ( from == 0 && mBlock[0].start != 0 )
+         ex = CONSTRUCT_INCONSISTENCY_EXCEPTION, bError = true;
+      const SeqBlock &last = mBlock.back();
+      if ( !bError && last.f &&
+           last.start + last.f->GetLength() != mNumSamples )
          ex = CONSTRUCT_INCONSISTENCY_EXCEPTION, bError = true;
    }
-   if ( !bError && pos != mNumSamples )
-      ex = CONSTRUCT_INCONSISTENCY_EXCEPTION, bError = true;
+
+   if ( !bError ) {
+      const size_t unchecked = numBlocks > from ? numBlocks - from : 0;
+      if (unchecked <= kExhaustiveCheckLimit ||
+          (++sConsistencyCheckCount % kExhaustiveCheckPeriod) == 0)
+         checkRange( from, numBlocks );
+      else {
+         // Verify the edited neighborhood and the sequence ends exactly
+         const size_t lo =
+            from > kCheckNeighborhood ? from - kCheckNeighborhood : 0;
+         checkRange( lo, from + kCheckNeighborhood );
+         checkRange( 0, kCheckNeighborhood );
+         checkRange( numBlocks - kCheckNeighborhood, numBlocks );
+
+         // and sample random joints from the rest.  A local generator
+         // keeps this off the global rand() stream.
+         wxUint64 seed =
+            (wxUint64)numBlocks * 2654435761u + sConsistencyCheckCount;
+         for (size_t n = 0; !bError && n < kCheckSampleCount; n++) {
+            seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+            const size_t i = (size_t)((seed >> 33) % numBlocks);
+            checkRange( i, i + 1 );
+         }
+      }
+   }
 
    if ( bError )
    {
@@ -1879,6 +2586,20 @@ void Sequence::ConsistencyCheck
    }
 }
 
+BlockArray Sequence::ScratchBlockArray()
+{
+   BlockArray result;
+   result.swap(mScratchBlock);
+   return result;
+}
+
+void Sequence::RecycleBlockArray(BlockArray &&blocks)
+{
+   blocks.clear();
+   if (blocks.capacity() > mScratchBlock.capacity())
+      mScratchBlock = std::move(blocks);
+}
+
 void Sequence::CommitChangesIfConsistent
    (BlockArray &newBlock, sampleCount numSamples, const wxChar *whereStr)
 {
@@ -1889,6 +2610,10 @@ void Sequence::CommitChangesIfConsistent
 
    mBlock.swap(newBlock);
    mNumSamples = numSamples;
+   mGroupStats.clear();
+   mGroupStatsValid = false;
+   mPyramid.clear();
+   RecycleBlockArray(std::move(newBlock));
 }
 
 void Sequence::AppendBlocksIfConsistent
@@ -1932,6 +2657,12 @@ void Sequence::AppendBlocksIfConsistent
 
    mNumSamples = numSamples;
    consistent = true;
+   UpdateGroupStatsForAppend(prevSize);
+   // Extend the pyramid over just the appended blocks; build it lazily
+   // on the next display query if it was not built yet
+   if (!mPyramid.empty())
+      RebuildSummaryPyramidFrom(std::min(prevSize, mBlock.size()));
+   RecycleBlockArray(std::move(additionalBlocks));
 }
 
 void Sequence::DebugPrintf
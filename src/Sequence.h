@@ -20,11 +20,20 @@
 #include "audacity/Types.h"
 
 class BlockFile;
+class ProgressDialog;
 using BlockFilePtr = std::shared_ptr<BlockFile>;
 
 class DirManager;
 class wxFileNameWrapper;
 
+// One frame of the min/max summary, bounding a group of at most 256
+// samples
+struct SummaryFrame {
+   sampleCount start; // position of the first covered sample
+   size_t len;        // number of covered samples, at most 256
+   float min, max;
+};
+
 // This is an internal data structure!  For advanced use only.
 class SeqBlock {
  public:
@@ -49,6 +58,35 @@ class SeqBlock {
 class BlockArray : public std::vector<SeqBlock> {};
 using BlockPtrArray = std::vector<SeqBlock*>; // non-owning pointers
 
+/// \brief A borrowed, read-only view of float samples resident in a single
+/// block file's memory.
+///
+/// The view holds the block's read lock (taken by Sequence::GetFloatView)
+/// and a shared reference, which the destructor releases; the data pointer
+/// stays valid for the lifetime of the view, provided the sequence is not
+/// edited meanwhile.
+class AUDACITY_DLL_API SequenceFloatView {
+public:
+   SequenceFloatView() = default;
+   SequenceFloatView(const float *data, size_t length, BlockFilePtr pFile);
+   SequenceFloatView(SequenceFloatView &&other);
+   SequenceFloatView &operator=(SequenceFloatView &&other);
+   SequenceFloatView(const SequenceFloatView&) = delete;
+   SequenceFloatView &operator=(const SequenceFloatView&) = delete;
+   ~SequenceFloatView();
+
+   const float *Data() const { return mData; }
+   size_t Length() const { return mLength; }
+   explicit operator bool() const { return mData != nullptr; }
+
+private:
+   void Release();
+
+   const float *mData{ nullptr };
+   size_t mLength{ 0 };
+   BlockFilePtr mFile;
+};
+
 class PROFILE_DLL_API Sequence final : public XMLTagHandler{
  public:
 
@@ -85,6 +123,12 @@ class PROFILE_DLL_API Sequence final : public XMLTagHandler{
    bool Get(samplePtr buffer, sampleFormat format,
             sampleCount start, size_t len, bool mayThrow) const;
 
+   /// Try to read samples in place, without copy or conversion.  Returns an
+   /// empty view when the range spans block boundaries, when the sequence
+   /// is not float format, or when the block's data is not resident in
+   /// memory; callers then fall back to Get().
+   SequenceFloatView GetFloatView(sampleCount start, size_t len) const;
+
    // Note that len is not size_t, because nullptr may be passed for buffer, in
    // which case, silence is inserted, possibly a large amount.
    void SetSamples(samplePtr buffer, sampleFormat format,
@@ -123,6 +167,11 @@ class PROFILE_DLL_API Sequence final : public XMLTagHandler{
    // loaded from an XML file via DirManager::HandleXMLTag
    void AppendBlockFile(const BlockFilePtr &blockFile);
 
+   /// Merge a trailing run of sub-minimum blocks, as left by repeated
+   /// small appends, into one block, keeping the block count and the
+   /// on-disk file count low.  Called after the append buffer flushes.
+   void CoalesceTrailingBlocks();
+
    void SetSilence(sampleCount s0, sampleCount len);
    void InsertSilence(sampleCount s0, sampleCount len);
 
@@ -159,7 +208,8 @@ class PROFILE_DLL_API Sequence final : public XMLTagHandler{
    sampleFormat GetSampleFormat() const;
 
    // Return true iff there is a change
-   bool ConvertToSampleFormat(sampleFormat format);
+   bool ConvertToSampleFormat(sampleFormat format,
+                              ProgressDialog *progress = NULL);
 
    //
    // Retrieving summary info
@@ -169,6 +219,15 @@ class PROFILE_DLL_API Sequence final : public XMLTagHandler{
       sampleCount start, sampleCount len, bool mayThrow) const;
    float GetRMS(sampleCount start, sampleCount len, bool mayThrow) const;
 
+   // Append to results one frame for each summary group of the blocks
+   // overlapping the range.  Group boundaries follow the underlying
+   // blocks, so the first and last frames may extend beyond the range;
+   // min and max always bound every sample a frame covers.  Returns
+   // false, appending nothing, if any summary is unavailable, and the
+   // caller must then read samples instead.
+   bool GetSummaries256(sampleCount start, sampleCount len,
+      std::vector<SummaryFrame> &results) const;
+
    //
    // Getting block size and alignment information
    //
@@ -236,12 +295,73 @@ class PROFILE_DLL_API Sequence final : public XMLTagHandler{
    ///To block the Delete() method against the ODCalcSummaryTask::Update() method
    ODLock   mDeleteUpdateMutex;
 
+   // A third level of summary above the block files' own 256-frame and
+   // 64K-frame levels: the combined min, max, and sum of squares of each
+   // fixed-size run of whole blocks.  Rebuilt lazily from the per-block
+   // statistics held in memory, extended cheaply on append, and discarded
+   // by any other commit of block changes, so that min/max/RMS queries
+   // over wide ranges need not visit every block.
+   struct BlockGroupStats {
+      float min;
+      float max;
+      double sumsq;
+      sampleCount length;
+      bool cached; // false while some block's summary is not yet computed
+   };
+   mutable std::vector<BlockGroupStats> mGroupStats;
+   mutable bool mGroupStatsValid{ false };
+
+   // A power-of-two reduction of the blocks' 256-sample summary frames,
+   // on a uniform grid from the start of the sequence; level ll holds
+   // the min, max, and mean square of each run of (256 << ll) samples.
+   // Once built it resolves zoomed-out display queries at any zoom from
+   // memory, instead of rereading summary files whenever the zoom
+   // changes.  Extended from the first changed block on append,
+   // discarded by any other commit of block changes.  Costs about a
+   // quarter percent of the audio data in memory.
+   struct PyramidNode {
+      float min;
+      float max;
+      float sumsq; // mean of squares times the samples covered
+   };
+   mutable std::vector<std::vector<PyramidNode>> mPyramid;
+
+   // Retained storage for rebuilt block arrays, recycled by the commit
+   // functions, so that structural edits on long sequences do not
+   // reallocate the array in the steady state
+   BlockArray mScratchBlock;
+
    //
    // Private methods
    //
 
    int FindBlock(sampleCount pos) const;
 
+   // Obtain an empty block array, reusing retained storage when there
+   // is any; the commit functions bring the storage back
+   BlockArray ScratchBlockArray();
+   void RecycleBlockArray(BlockArray &&blocks);
+
+   BlockGroupStats ComputeGroupStats(size_t group) const;
+   void RebuildGroupStats() const;
+   void UpdateGroupStatsForAppend(size_t unchangedBlocks);
+
+   // Accumulate min, max, and sum of squares of the whole blocks in
+   // [block0, block1), consulting the cached group statistics for
+   // interior runs of whole groups
+   BlockGroupStats GatherBlockStats
+      (size_t block0, size_t block1, bool mayThrow) const;
+
+   // Build the summary pyramid if it is absent; false if some block's
+   // summary is not yet computed
+   bool UpdateSummaryPyramid() const;
+   // Recompute pyramid nodes from the start of the given block onward
+   bool RebuildSummaryPyramidFrom(size_t firstChangedBlock) const;
+   // Try to resolve a display query entirely from the pyramid; false
+   // if the zoom is too close or the pyramid cannot be built yet
+   bool GetPyramidDisplay(float *min, float *max, float *rms, int* bl,
+      size_t len, const sampleCount *where) const;
+
    static void AppendBlock
       (DirManager &dirManager,
        BlockArray &blocks, sampleCount &numSamples, const SeqBlock &b);
@@ -276,6 +396,9 @@ public:
       (const BlockArray &block, sampleCount numSamples, wxString *dest);
 
 private:
+   // Above a block-count threshold, checks only the edited neighborhood
+   // and a random sample of block joints, with a periodic full walk, so
+   // editing stays interactive on very large sequences.
    static void ConsistencyCheck
       (const BlockArray &block, size_t maxSamples, size_t from,
        sampleCount numSamples, const wxChar *whereStr,
@@ -18,6 +18,7 @@
 #include "ProjectSettings.h"
 #include "LabelTrack.h"
 #include "NoteTrack.h"
+#include "UndoManager.h"
 #include "WaveClip.h"
 #include "ViewInfo.h"
 #include "WaveTrack.h"
@@ -102,6 +103,18 @@ void SnapManager::Reinit()
       mConverter.SetFormatName(mFormat);
    }
 
+   // Managers that exclude nothing all compute the same array of points, so
+   // they can share one, cached on the project until its next completed
+   // edit.  SelectHandle makes such a manager on every mouse motion over
+   // the panel, and the rescan of all clips and labels is the costly part.
+   auto pCache = ( mClipExclusions || mTrackExclusions )
+      ? nullptr : &SnapPointCache::Get( *mProject );
+   if (pCache &&
+       pCache->Fetch(mSnapTo, mRate, mFormat, mNoTimeSnap, mSnapPoints))
+   {
+      return;
+   }
+
    // Add a SnapPoint at t=0
    mSnapPoints.push_back(SnapPoint{});
 
@@ -160,6 +173,11 @@ void SnapManager::Reinit()
 
    // Sort all by time
    std::sort(mSnapPoints.begin(), mSnapPoints.end());
+
+   if (pCache)
+   {
+      pCache->Store(mSnapTo, mRate, mFormat, mNoTimeSnap, mSnapPoints);
+   }
 }
 
 // Adds to mSnapPoints, filtering by TimeConverter
@@ -360,6 +378,72 @@ SnapResults SnapManager::Snap
    return results;
 }
 
+static AudacityProject::AttachedObjects::RegisteredFactory sSnapPointCacheKey {
+   []( AudacityProject &project ) {
+      return std::make_shared< SnapPointCache >( project );
+   }
+};
+
+SnapPointCache &SnapPointCache::Get( AudacityProject &project )
+{
+   return project.AttachedObjects::Get< SnapPointCache >( sSnapPointCacheKey );
+}
+
+SnapPointCache::SnapPointCache( AudacityProject &project )
+   : mProject{ project }
+{
+   // Any completed edit of the project may have moved the snap candidates.
+   // Edits still in progress don't invalidate, but a SnapManager in use
+   // during a drag never rescans anyway.
+   project.Bind( EVT_UNDO_PUSHED, &SnapPointCache::OnProjectChange, this );
+   project.Bind( EVT_UNDO_MODIFIED, &SnapPointCache::OnProjectChange, this );
+   project.Bind( EVT_UNDO_OR_REDO, &SnapPointCache::OnProjectChange, this );
+   project.Bind( EVT_UNDO_RESET, &SnapPointCache::OnProjectChange, this );
+}
+
+SnapPointCache::~SnapPointCache()
+{
+   mProject.Unbind( EVT_UNDO_PUSHED, &SnapPointCache::OnProjectChange, this );
+   mProject.Unbind( EVT_UNDO_MODIFIED, &SnapPointCache::OnProjectChange, this );
+   mProject.Unbind( EVT_UNDO_OR_REDO, &SnapPointCache::OnProjectChange, this );
+   mProject.Unbind( EVT_UNDO_RESET, &SnapPointCache::OnProjectChange, this );
+}
+
+void SnapPointCache::OnProjectChange( wxCommandEvent &evt )
+{
+   evt.Skip();
+   mValid = false;
+   // Don't keep stale points alive
+   mSnapPoints.clear();
+}
+
+bool SnapPointCache::Fetch( int snapTo, double rate,
+   const NumericFormatSymbol &format, bool noTimeSnap,
+   SnapPointArray &points ) const
+{
+   if (!mValid ||
+       snapTo != mSnapTo || rate != mRate || noTimeSnap != mNoTimeSnap ||
+       !(format == mFormat))
+   {
+      return false;
+   }
+
+   points = mSnapPoints;
+   return true;
+}
+
+void SnapPointCache::Store( int snapTo, double rate,
+   const NumericFormatSymbol &format, bool noTimeSnap,
+   const SnapPointArray &points )
+{
+   mSnapTo = snapTo;
+   mRate = rate;
+   mFormat = format;
+   mNoTimeSnap = noTimeSnap;
+   mSnapPoints = points;
+   mValid = true;
+}
+
 /* static */ wxArrayStringEx SnapManager::GetSnapLabels()
 {
    return wxArrayStringEx{
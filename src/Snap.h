@@ -17,6 +17,8 @@
 
 #include <vector>
 #include <wx/defs.h>
+#include <wx/event.h> // to inherit
+#include "ClientData.h" // to inherit
 #include "widgets/NumericTextCtrl.h" // member variable
 
 class AudacityProject;
@@ -110,7 +112,7 @@ private:
 
 private:
 
-   const AudacityProject *mProject;
+   AudacityProject *mProject;
    const TrackList *mTracks;
    const TrackClipArray *mClipExclusions;
    const TrackArray *mTrackExclusions;
@@ -130,4 +132,39 @@ private:
    NumericFormatSymbol mFormat;
 };
 
+///\brief Caches the sorted array of candidate snap points of a project, so
+/// that the SnapManagers constructed repeatedly during mouse motion need not
+/// rescan every track, clip and label each time
+class SnapPointCache final
+   : public wxEvtHandler
+   , public ClientData::Base
+{
+public:
+   static SnapPointCache &Get( AudacityProject &project );
+
+   explicit SnapPointCache( AudacityProject &project );
+   ~SnapPointCache() override;
+
+   // Copy out the cached points, if they are still valid and were computed
+   // for the same grid-snapping settings; else return false
+   bool Fetch( int snapTo, double rate, const NumericFormatSymbol &format,
+      bool noTimeSnap, SnapPointArray &points ) const;
+
+   // Remember points just computed for the given settings
+   void Store( int snapTo, double rate, const NumericFormatSymbol &format,
+      bool noTimeSnap, const SnapPointArray &points );
+
+private:
+   void OnProjectChange( wxCommandEvent &evt );
+
+   AudacityProject &mProject;
+
+   SnapPointArray mSnapPoints;
+   int mSnapTo{ 0 };
+   double mRate{ 0.0 };
+   NumericFormatSymbol mFormat;
+   bool mNoTimeSnap{ false };
+   bool mValid{ false };
+};
+
 #endif
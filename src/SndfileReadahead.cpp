@@ -0,0 +1,231 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  SndfileReadahead.cpp
+
+*******************************************************************//*!
+
+\class ReadaheadFile
+\brief Serves libsndfile reads from big aligned chunks of the file.
+
+\class SndfileReadCache
+\brief Keeps aliased files open between block reads and prefetches
+ahead of them.
+
+*//*******************************************************************/
+
+#include "Audacity.h"
+#include "SndfileReadahead.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+ReadaheadFile::ReadaheadFile(const wxString &path)
+{
+   if (wxFile::Exists(path) && mFile.Open(path))
+      mLength = mFile.Length();
+}
+
+SNDFILE *ReadaheadFile::OpenSNDFILE(SF_INFO &info)
+{
+   if (!IsOpened())
+      return NULL;
+
+   static SF_VIRTUAL_IO sVirtualIO {
+      vfGetFilelen, vfSeek, vfRead, vfWrite, vfTell
+   };
+
+   mPos = 0;
+   return SFCall<SNDFILE*>(sf_open_virtual, &sVirtualIO, SFM_READ, &info, this);
+}
+
+void ReadaheadFile::Prefetch()
+{
+   const sf_count_t next =
+      mPos - (mPos % (sf_count_t)cChunkBytes) + cChunkBytes;
+
+   if (next < mLength)
+      FetchChunk(next);
+}
+
+auto ReadaheadFile::FetchChunk(sf_count_t pos) -> Chunk *
+{
+   if (pos < 0 || pos >= mLength)
+      return NULL;
+
+   for (auto &chunk : mChunks)
+      if (chunk.start >= 0 && pos >= chunk.start &&
+          pos < chunk.start + (sf_count_t)chunk.len)
+         return &chunk;
+
+   const sf_count_t start = pos - (pos % (sf_count_t)cChunkBytes);
+
+   // Replace the cached chunk farther from the requested position
+   Chunk *victim = &mChunks[0];
+   if (mChunks[1].start < 0)
+      victim = &mChunks[1];
+   else if (mChunks[0].start >= 0 &&
+            std::llabs(mChunks[0].start - start) <
+            std::llabs(mChunks[1].start - start))
+      victim = &mChunks[1];
+
+   if (!victim->data)
+      victim->data.reinit(cChunkBytes);
+   victim->start = -1;
+   victim->len = 0;
+
+   if (mFile.Seek(start) == wxInvalidOffset)
+      return NULL;
+
+   const auto toRead =
+      (size_t)std::min((sf_count_t)cChunkBytes, mLength - start);
+   const auto actual = mFile.Read(victim->data.get(), toRead);
+   if (actual <= 0)
+      return NULL;
+
+   victim->start = start;
+   victim->len = (size_t)actual;
+   return victim;
+}
+
+size_t ReadaheadFile::Read(void *ptr, size_t count)
+{
+   char *out = (char*)ptr;
+   size_t done = 0;
+
+   while (done < count && mPos < mLength) {
+      // Serve big requests straight from the file; copying them through
+      // the chunk cache would gain nothing
+      if (count - done >= cChunkBytes) {
+         if (mFile.Seek(mPos) == wxInvalidOffset)
+            break;
+         const auto actual = mFile.Read(out + done, count - done);
+         if (actual <= 0)
+            break;
+         done += actual;
+         mPos += actual;
+         break;
+      }
+
+      Chunk *chunk = FetchChunk(mPos);
+      if (!chunk)
+         break;
+
+      const auto within = (size_t)(mPos - chunk->start);
+      if (within >= chunk->len)
+         break;
+      const auto n = std::min(count - done, chunk->len - within);
+      memcpy(out + done, chunk->data.get() + within, n);
+      done += n;
+      mPos += n;
+   }
+
+   return done;
+}
+
+sf_count_t ReadaheadFile::vfGetFilelen(void *userData)
+{
+   return ((ReadaheadFile*)userData)->mLength;
+}
+
+sf_count_t ReadaheadFile::vfSeek(sf_count_t offset, int whence, void *userData)
+{
+   auto &file = *(ReadaheadFile*)userData;
+   sf_count_t pos;
+
+   switch (whence)
+   {
+      case SEEK_SET:
+         pos = offset;
+         break;
+      case SEEK_CUR:
+         pos = file.mPos + offset;
+         break;
+      case SEEK_END:
+         pos = file.mLength + offset;
+         break;
+      default:
+         return -1;
+   }
+
+   if (pos < 0)
+      return -1;
+
+   file.mPos = pos;
+   return pos;
+}
+
+sf_count_t ReadaheadFile::vfRead(void *ptr, sf_count_t count, void *userData)
+{
+   return ((ReadaheadFile*)userData)->Read(ptr, (size_t)count);
+}
+
+sf_count_t ReadaheadFile::vfWrite(
+   const void *WXUNUSED(ptr), sf_count_t WXUNUSED(count), void *WXUNUSED(userData))
+{
+   // Read-only
+   return 0;
+}
+
+sf_count_t ReadaheadFile::vfTell(void *userData)
+{
+   return ((ReadaheadFile*)userData)->mPos;
+}
+
+SndfileReadCache &SndfileReadCache::Get()
+{
+   static SndfileReadCache sCache;
+   return sCache;
+}
+
+std::shared_ptr<SndfileReadCache::Entry>
+SndfileReadCache::Open(const wxString &path)
+{
+   {
+      std::lock_guard<std::mutex> guard{ mMutex };
+      auto iter = mEntries.find(path);
+      if (iter != mEntries.end()) {
+         iter->second->mLastUse = ++mUses;
+         return iter->second;
+      }
+   }
+
+   // Open outside the cache lock; it may be slow on remote storage
+   auto entry = std::make_shared<Entry>(path);
+   if (!entry->mReader.IsOpened())
+      return {};
+   entry->mSndfile.reset(entry->mReader.OpenSNDFILE(entry->mInfo));
+   if (!entry->mSndfile)
+      return {};
+
+   std::lock_guard<std::mutex> guard{ mMutex };
+   auto &stored = mEntries[path];
+   if (stored)
+      // Another thread opened the same file meanwhile; use its entry
+      entry = stored;
+   else
+      stored = entry;
+   entry->mLastUse = ++mUses;
+
+   if (mEntries.size() > cMaxEntries) {
+      // Drop the least recently used handle; readers still holding it
+      // keep it alive until they finish
+      auto victim = mEntries.begin();
+      for (auto iter = mEntries.begin(); iter != mEntries.end(); ++iter)
+         if (iter->second->mLastUse < victim->second->mLastUse)
+            victim = iter;
+      mEntries.erase(victim);
+   }
+
+   return entry;
+}
+
+void SndfileReadCache::Prefetch(const std::shared_ptr<Entry> &entry)
+{
+   mQueue.Post([entry]{
+      std::lock_guard<std::mutex> guard{ entry->mMutex };
+      entry->mReader.Prefetch();
+   });
+}
@@ -0,0 +1,124 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  SndfileReadahead.h
+
+**********************************************************************/
+
+#ifndef __AUDACITY_SNDFILE_READAHEAD__
+#define __AUDACITY_SNDFILE_READAHEAD__
+
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include <wx/file.h> // member variable
+#include "sndfile.h"
+
+#include "FileFormats.h" // for SFFile
+#include "MemoryX.h"
+#include "effects/TrackIOQueue.h"
+
+/// \brief A file that a SNDFILE reads through a chunk cache, so that
+/// libsndfile's many small reads become few large ones.
+///
+/// Small synchronous reads are latency bound on network storage.  This
+/// object reads the underlying file in big aligned chunks, keeps the
+/// last two of them, and serves libsndfile's requests from there via
+/// sf_open_virtual().  Prefetch() loads the chunk following the last
+/// read, and can be called off the decoding thread to hide the next
+/// read's latency.  The object is not thread-safe by itself; callers
+/// that share one must serialize all use of it and of its SNDFILE.
+class ReadaheadFile
+{
+public:
+   explicit ReadaheadFile(const wxString &path);
+
+   bool IsOpened() const { return mFile.IsOpened(); }
+
+   ///Opens a SNDFILE that reads through this object's cache.  The
+   ///returned handle must not outlive this object.
+   SNDFILE *OpenSNDFILE(SF_INFO &info);
+
+   ///Loads the chunk following the one last read from, if any
+   void Prefetch();
+
+private:
+   static const size_t cChunkBytes = 1024 * 1024;
+
+   ///One cached aligned chunk of the file; start is -1 when empty
+   struct Chunk
+   {
+      ArrayOf<char> data;
+      sf_count_t start { -1 };
+      size_t len { 0 };
+   };
+
+   size_t Read(void *ptr, size_t count);
+   Chunk *FetchChunk(sf_count_t pos);
+
+   // Callbacks for sf_open_virtual(); userData is the ReadaheadFile
+   static sf_count_t vfGetFilelen(void *userData);
+   static sf_count_t vfSeek(sf_count_t offset, int whence, void *userData);
+   static sf_count_t vfRead(void *ptr, sf_count_t count, void *userData);
+   static sf_count_t vfWrite(const void *ptr, sf_count_t count, void *userData);
+   static sf_count_t vfTell(void *userData);
+
+   wxFile     mFile;
+   sf_count_t mLength { 0 };
+   sf_count_t mPos { 0 };
+   Chunk      mChunks[2];
+};
+
+/// \brief A shared cache of open readahead handles for aliased files,
+/// keyed by file name.
+///
+/// Alias block file reads used to open the aliased file, parse its
+/// header, seek and read one block, and close it again, paying several
+/// network round-trips per block on SMB/NFS.  The cache keeps a few
+/// handles open across reads and schedules a readahead of the next
+/// chunk after each use, so sequential playback and summary computation
+/// find their data already buffered.  Only files outside the project
+/// belong here; project block files must stay closable for deletion.
+class SndfileReadCache
+{
+public:
+   struct Entry
+   {
+      explicit Entry(const wxString &path)
+         : mReader{ path }
+      {
+         memset(&mInfo, 0, sizeof(mInfo));
+      }
+
+      ReadaheadFile mReader;
+      SFFile        mSndfile;
+      SF_INFO       mInfo;
+      ///Serializes all use of mSndfile and mReader
+      std::mutex    mMutex;
+      unsigned long long mLastUse { 0 };
+   };
+
+   static SndfileReadCache &Get();
+
+   ///Returns a cached open handle for the file, or null if it cannot be
+   ///opened.  Hold the entry's mutex around any use of its SNDFILE.
+   std::shared_ptr<Entry> Open(const wxString &path);
+
+   ///Schedules loading of the chunk after the entry's last read on the
+   ///I/O thread, so a following sequential read finds it cached
+   void Prefetch(const std::shared_ptr<Entry> &entry);
+
+private:
+   static const unsigned cMaxEntries = 4;
+
+   std::mutex mMutex;
+   std::map<wxString, std::shared_ptr<Entry>> mEntries;
+   unsigned long long mUses { 0 };
+   // Last member, so it drains its jobs before the entries go away
+   TrackIOQueue mQueue;
+};
+
+#endif
@@ -453,18 +453,10 @@ void ThemeBase::RegisterImage( int &iIndex, const wxImage &Image, const wxString
    wxASSERT( iIndex == -1 ); // Don't initialise same bitmap twice!
    mImages.push_back( Image );
 
-#ifdef __APPLE__
-   // On Mac, bitmaps with alpha don't work.
-   // So we convert to a mask and use that.
-   // It isn't quite as good, as alpha gives smoother edges.
-   //[Does not affect the large control buttons, as for those we do
-   // the blending ourselves anyway.]
-   wxImage TempImage( Image );
-   TempImage.ConvertAlphaToMask();
-   mBitmaps.push_back( wxBitmap( TempImage ) );
-#else
-   mBitmaps.push_back( wxBitmap( Image ) );
-#endif
+   // The wxBitmap is made lazily, in Bitmap(), on first use.  Most of
+   // these defaults are replaced from the image cache before anything
+   // draws, so converting here would do the whole set twice.
+   mBitmaps.push_back( wxBitmap{} );
 
    mBitmapNames.push_back( Name );
    mBitmapFlags.push_back( mFlow.mFlags );
@@ -1026,7 +1018,9 @@ bool ThemeBase::ReadImageCache( teThemeType type, bool bOkIfNotFound)
          wxRect R = mFlow.RectInner();
          //wxLogDebug( "[%i, %i, %i, %i, \"%s\"], ", R.x, R.y, R.width, R.height, mBitmapNames[i].c_str() );
          Image = GetSubImageWithAlpha( ImageCache, mFlow.RectInner() );
-         mBitmaps[i] = wxBitmap(Image);
+         // Invalidate any bitmap made from the old image; Bitmap()
+         // remakes it from this image when next asked
+         mBitmaps[i] = wxBitmap{};
       }
    }
    if( !ImageCache.HasAlpha() )
@@ -1226,6 +1220,25 @@ wxBitmap & ThemeBase::Bitmap( int iIndex )
 {
    wxASSERT( iIndex >= 0 );
    EnsureInitialised();
+
+   // Converted from the image on first use, so that loading a theme
+   // pays for converting only the images a session actually draws
+   if( !mBitmaps[iIndex].IsOk() )
+   {
+#ifdef __APPLE__
+      // On Mac, bitmaps with alpha don't work.
+      // So we convert to a mask and use that.
+      // It isn't quite as good, as alpha gives smoother edges.
+      //[Does not affect the large control buttons, as for those we do
+      // the blending ourselves anyway.]
+      wxImage TempImage( mImages[iIndex] );
+      TempImage.ConvertAlphaToMask();
+      mBitmaps[iIndex] = wxBitmap( TempImage );
+#else
+      mBitmaps[iIndex] = wxBitmap( mImages[iIndex] );
+#endif
+   }
+
    return mBitmaps[iIndex];
 }
 
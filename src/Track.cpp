@@ -125,6 +125,11 @@ Track::Holder Track::Duplicate() const
    return result;
 }
 
+bool Track::IsSameAs(const Track & WXUNUSED(other)) const
+{
+   return false;
+}
+
 Track::~Track()
 {
 }
@@ -670,13 +675,31 @@ void TrackList::Permute(const std::vector<TrackNodePointer> &permutation)
 
 Track *TrackList::FindById( TrackId id )
 {
-   // Linear search.  Tracks in a project are usually very few.
-   // Search only the non-pending tracks.
-   auto it = std::find_if( ListOfTracks::begin(), ListOfTracks::end(),
-      [=](const ListOfTracks::value_type &ptr){ return ptr->GetId() == id; } );
-   if (it == ListOfTracks::end())
+   // Commands and menu updates look tracks up repeatedly per operation,
+   // so a linear search of a list of hundreds of tracks adds up.  Use
+   // the lazy index instead; an entry is trusted only if the track it
+   // holds is alive, keeps the id, and still belongs to this list, and
+   // any miss rebuilds the index from the list.  Staleness after
+   // removals or reorderings is thus self-correcting, and no mutator
+   // needs to know about the index.
+   {
+      auto indexed = mIdIndex.find( id );
+      if ( indexed != mIdIndex.end() ) {
+         auto pTrack = indexed->second.lock();
+         if ( pTrack && pTrack->GetId() == id &&
+              pTrack->GetOwner().get() == this )
+            return pTrack.get();
+      }
+   }
+
+   mIdIndex.clear();
+   for ( auto &ptr : static_cast<ListOfTracks&>(*this) )
+      mIdIndex[ ptr->GetId() ] = ptr;
+
+   auto indexed = mIdIndex.find( id );
+   if ( indexed == mIdIndex.end() )
       return {};
-   return it->get();
+   return indexed->second.lock().get();
 }
 
 Track *TrackList::DoAddToHead(const std::shared_ptr<Track> &t)
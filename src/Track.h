@@ -18,6 +18,7 @@
 #include <vector>
 #include <list>
 #include <functional>
+#include <unordered_map>
 #include <wx/longlong.h>
 
 #include "ClientData.h"
@@ -172,6 +173,12 @@ public:
    bool operator <  (const TrackId &other) const
    { return mValue <  other.mValue; }
 
+   // Define this in case you want to key a std::unordered_map on TrackId
+   struct Hash {
+      size_t operator () (const TrackId &id) const
+      { return std::hash<long>{}( id.mValue ); }
+   };
+
 private:
    long mValue;
 };
@@ -324,6 +331,13 @@ private:
    // public nonvirtual duplication function that invokes Clone():
    virtual Holder Duplicate() const;
 
+   // Conservative deep comparison with another track, used by undo
+   // history to share the snapshots of tracks an action did not touch.
+   // True promises that duplicates of the two tracks would be
+   // interchangeable; false promises nothing, and costs the caller only
+   // an avoidable duplication.  The default trusts no track.
+   virtual bool IsSameAs(const Track &other) const;
+
    // Called when this track is merged to stereo with another, and should
    // take on some paramaters of its partner.
    virtual void Merge(const Track &orig);
@@ -1565,6 +1579,12 @@ private:
    ListOfTracks mPendingUpdates;
    // This is in correspondence with mPendingUpdates
    std::vector< Updater > mUpdaters;
+
+   // Lazy index for FindById.  Entries are verified against the track
+   // before use and the whole index is rebuilt on a miss, so it never
+   // needs invalidating when the list changes.
+   std::unordered_map< TrackId, std::weak_ptr<Track>, TrackId::Hash >
+      mIdIndex;
 };
 
 class AUDACITY_DLL_API TrackFactory final
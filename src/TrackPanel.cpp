@@ -87,6 +87,8 @@ is time to refresh some aspect of the screen.
 #include "../images/Cursors.h"
 
 #include <algorithm>
+#include <atomic>
+#include <thread>
 
 #include <wx/dcclient.h>
 
@@ -366,6 +368,7 @@ AudacityProject * TrackPanel::GetProject() const
 void TrackPanel::OnSize( wxSizeEvent &evt )
 {
    evt.Skip();
+   InvalidateCellLayout();
    const auto &size = evt.GetSize();
    mViewInfo->SetWidth( size.GetWidth() );
    mViewInfo->SetHeight( size.GetHeight() );
@@ -520,8 +523,20 @@ void TrackPanel::OnPaint(wxPaintEvent & /* event */)
          // Reset (should a mutex be used???)
          mRefreshBacking = false;
 
+         wxDC &backingDC = GetBackingDCForRepaint();
+
+         // When only some tracks reported damage, clip the redraw to
+         // their strips; the rest of the backing bitmap is still valid
+         // and the expensive drawing passes cull against the clip
+         const bool partial = !mDamageAll && !mDamageRect.IsEmpty();
+         if (partial)
+            backingDC.SetClippingRegion(mDamageRect);
+
          // Redraw the backing bitmap
-         DrawTracks(&GetBackingDCForRepaint());
+         DrawTracks(&backingDC);
+
+         if (partial)
+            backingDC.DestroyClippingRegion();
 
          // Copy it to the display
          DisplayBitmap(dc);
@@ -542,6 +557,10 @@ void TrackPanel::OnPaint(wxPaintEvent & /* event */)
       DrawOverlays(true, &dc);
    }
 
+   // All reported damage has been repainted
+   mDamageRect = wxRect();
+   mDamageAll = false;
+
 #if DEBUG_DRAW_TIMING
    sw.Pause();
    wxLogDebug(wxT("Total: %ld milliseconds"), sw.Time());
@@ -616,10 +635,16 @@ void TrackPanel::ProcessUIHandleResult
    if (refreshAll)
       panel->Refresh(false);
    else {
+      // A dragged handle may claim that only part of the cell's width
+      // changed, sparing recomputation of the waveform under the rest
+      wxRect damage;
+      if (auto pHandle = Target())
+         damage = pHandle->DamagedRect();
+      const wxRect *pDamage = damage.IsEmpty() ? nullptr : &damage;
       if (refreshResult & RefreshCell)
-         panel->RefreshTrack(pClickedTrack);
+         panel->RefreshTrack(pClickedTrack, true, pDamage);
       if (refreshResult & RefreshLatestCell)
-         panel->RefreshTrack(pLatestTrack);
+         panel->RefreshTrack(pLatestTrack, true, pDamage);
    }
 
    if (refreshResult & FixScrollbars)
@@ -704,6 +729,7 @@ void TrackPanel::OnTrackListResizing(TrackListEvent & e)
    // A deleted track can have a valid pointer but no owner, bug 2060
    if( t && t->HasOwner() )
       UpdateVRuler(t.get());
+   InvalidateCellLayout();
    e.Skip();
 }
 
@@ -722,6 +748,8 @@ void TrackPanel::OnTrackListDeletion(wxEvent & e)
 
    UpdateVRulerSize();
 
+   InvalidateCellLayout();
+
    e.Skip();
 }
 
@@ -778,7 +806,8 @@ double TrackPanel::GetMostRecentXPos()
       MostRecentXCoord(), mViewInfo->GetLabelWidth());
 }
 
-void TrackPanel::RefreshTrack(Track *trk, bool refreshbacking)
+void TrackPanel::RefreshTrack(Track *trk, bool refreshbacking,
+   const wxRect *pDamage)
 {
    if (!trk)
       return;
@@ -796,9 +825,24 @@ void TrackPanel::RefreshTrack(Track *trk, bool refreshbacking)
             GetRect().GetWidth() - kLeftInset - kRightInset - kShadowThickness,
             height);
 
+   if( pDamage ) {
+      // Trust only the horizontal extent of the claimed damage; the full
+      // height of the strip repaints, so linked channels stay consistent
+      const auto left = std::max( rect.x, pDamage->x );
+      const auto right = std::min(
+         rect.x + rect.width, pDamage->x + pDamage->width );
+      if ( left >= right )
+         return;
+      rect.x = left;
+      rect.width = right - left;
+   }
+
    if( refreshbacking )
    {
       mRefreshBacking = true;
+      // Note which strip of the backing bitmap is stale, so that OnPaint
+      // can redraw just that much of it
+      mDamageRect.Union( rect );
    }
 
    Refresh( false, &rect );
@@ -824,7 +868,15 @@ void TrackPanel::Refresh(bool eraseBackground /* = TRUE */,
    if( !rect || ( *rect == GetRect() ) )
    {
       mRefreshBacking = true;
+      mDamageAll = true;
+      // Scrolling, zooming and changes of the track list all pass this
+      // way; the subdivision into cells may have changed.  Partial
+      // refreshes repaint cells in place and deliberately keep the
+      // cached layout.
+      InvalidateCellLayout();
    }
+   // Call the wxWindow method directly, bypassing the base class override
+   // that would invalidate the cell layout on any refresh
    wxWindow::Refresh(eraseBackground, rect);
 
    CallAfter([this]{ CellularPanel::HandleCursorForPresentMouseState(); } );
@@ -844,9 +896,12 @@ void TrackPanel::OnAudioIO(wxCommandEvent & evt)
 /// actual contents of each track are drawn by the TrackArtist.
 void TrackPanel::DrawTracks(wxDC * dc)
 {
-   wxRegion region = GetUpdateRegion();
-
-   const wxRect clip = GetRect();
+   // A clipping region on the DC delimits the damage under repair; an
+   // unclipped DC means the whole panel is to be redrawn
+   wxRect clip;
+   dc->GetClippingBox(clip);
+   if (clip.IsEmpty())
+      clip = GetClientRect();
 
    const SelectedRegion &sr = mViewInfo->selectedRegion;
    mTrackArtist->pSelectedRegion = &sr;
@@ -878,6 +933,41 @@ void TrackPanel::DrawTracks(wxDC * dc)
    mTrackArtist->drawSliders = sliderFlag;
    mTrackArtist->hasSolo = hasSolo;
 
+   // Let all visible cells compute their expensive display data on worker
+   // threads before the serial passes below.  wxWidgets confines GDI
+   // calls to this thread, so it is the filling of the clip caches, not
+   // the rendering, that spreads over cores; with the caches warm the
+   // drawing passes are mostly copies and blits, and a full repaint
+   // scales with the slowest track rather than the sum of all of them.
+   {
+      struct Job { wxRect rect; TrackPanelCell *pCell; };
+      std::vector<Job> jobs;
+      VisitCells( [&]( const wxRect &rect, TrackPanelCell &cell ){
+         // Cells wholly outside the damage will not be drawn, so
+         // compute nothing for them either
+         if ( rect.Intersects( clip ) )
+            jobs.push_back( { rect, &cell } );
+      } );
+      const unsigned nThreads = std::min<unsigned>(
+         std::max( 1u, std::thread::hardware_concurrency() ), jobs.size() );
+      if (nThreads > 1) {
+         std::atomic<size_t> next{ 0 };
+         std::vector<std::thread> threads;
+         for (unsigned ii = 0; ii < nThreads; ++ii)
+            threads.emplace_back( [&]{
+               for ( size_t jj; ( jj = next++ ) < jobs.size(); ) {
+                  // An exception must not escape the worker; whatever
+                  // failed here will fail again in the drawing pass,
+                  // which has the usual handling for it
+                  try { jobs[jj].pCell->Prefetch( context, jobs[jj].rect ); }
+                  catch ( ... ) {}
+               }
+            } );
+         for (auto &thread : threads)
+            thread.join();
+      }
+   }
+
    this->CellularPanel::Draw( context, TrackArtist::NPasses );
 }
 
@@ -1388,6 +1478,11 @@ void TrackPanelDrawable::Draw(
 {
 }
 
+void TrackPanelDrawable::Prefetch(
+   TrackPanelDrawingContext &, const wxRect & )
+{
+}
+
 wxRect TrackPanelDrawable::DrawingArea(
    const wxRect &rect, const wxRect &, unsigned )
 {
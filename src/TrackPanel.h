@@ -111,7 +111,8 @@ class AUDACITY_DLL_API TrackPanel final
       (bool eraseBackground = true, const wxRect *rect = (const wxRect *) NULL)
       override;
 
-   void RefreshTrack(Track *trk, bool refreshbacking = true);
+   void RefreshTrack(Track *trk, bool refreshbacking = true,
+                     const wxRect *pDamage = nullptr);
 
    void HandlePageUpKey();
    void HandlePageDownKey();
@@ -203,6 +204,15 @@ protected:
 
    bool mRefreshBacking;
 
+   // The union of strips reported damaged by RefreshTrack since the last
+   // repaint.  When the backing bitmap must be redrawn and mDamageAll is
+   // false, OnPaint confines the expensive redraw to this rectangle; the
+   // rest of the backing is still valid.  We cannot rely on the native
+   // update region for this, since Windows clips it to the onscreen part
+   // of the window.
+   wxRect mDamageRect;
+   bool mDamageAll { true };
+
 #ifdef EXPERIMENTAL_SPECTRAL_EDITING
 
 protected:
@@ -29,6 +29,16 @@ public:
    virtual void Draw(
       TrackPanelDrawingContext &context, const wxRect &rect, unsigned iPass );
 
+   // May be called on a worker thread shortly before the drawing passes,
+   // with the same rectangle Draw will get, so that cells can compute and
+   // cache their expensive display data in parallel with other cells.
+   // Implementations must not touch GDI objects (including the context's
+   // dc) and must confine themselves to data that Draw reads back under
+   // the same locks.
+   // Default implementation does nothing.
+   virtual void Prefetch(
+      TrackPanelDrawingContext &context, const wxRect &rect );
+
    // For drawing purposes, a cell might require a bigger rectangle than for
    // hit-test purposes, spilling over into other parts of the partition of the
    // panel area.
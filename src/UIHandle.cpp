@@ -11,6 +11,8 @@ Paul Licameli
 #include "Audacity.h"
 #include "UIHandle.h"
 
+#include <wx/gdicmn.h>
+
 #include "RefreshCode.h"
 
 UIHandle::~UIHandle()
@@ -41,6 +43,11 @@ bool UIHandle::Escape()
    return false;
 }
 
+wxRect UIHandle::DamagedRect() const
+{
+   return {};
+}
+
 bool UIHandle::StopsOnKeystroke()
 {
    return false;
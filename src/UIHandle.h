@@ -100,6 +100,13 @@ public:
    // Cancelled in return flags has no effect.
    virtual Result Cancel(AudacityProject *pProject) = 0;
 
+   // A handle that requests RefreshCell may claim that it damaged only part
+   // of the cell's width, so that less of the waveform is recomputed and
+   // repainted during a drag.  Coordinates are those of the panel; only the
+   // horizontal extent is used.  Default returns an empty rectangle, meaning
+   // the whole cell.
+   virtual wxRect DamagedRect() const;
+
    // Whether to force Release (not Cancel!) of the drag when a
    // keystroke command is about to be dispatched.  Default is always false.
    // When default is false, any remembered pointers to tracks should be
@@ -35,21 +35,29 @@ UndoManager
 #include "NoteTrack.h"  // for Sonify* function declarations
 #include "Diags.h"
 #include "Tags.h"
+#include "tracks/ui/TrackView.h"
+#include "tracks/playabletrack/wavetrack/ui/WaveTrackView.h"
 
 
+#include <map>
 #include <unordered_set>
 
 wxDEFINE_EVENT(EVT_UNDO_PUSHED, wxCommandEvent);
 wxDEFINE_EVENT(EVT_UNDO_MODIFIED, wxCommandEvent);
 wxDEFINE_EVENT(EVT_UNDO_OR_REDO, wxCommandEvent);
 wxDEFINE_EVENT(EVT_UNDO_RESET, wxCommandEvent);
+wxDEFINE_EVENT(EVT_UNDO_SPACE_USAGE, wxCommandEvent);
 
 using ConstBlockFilePtr = const BlockFile*;
 using Set = std::unordered_set<ConstBlockFilePtr>;
 
+// Running tally of the block-file bytes held only by undo states, for
+// the memory section of the diagnostics report
+static DiagMemTag sUndoHistoryMemory{ wxT("UndoManager states") };
+
 struct UndoStackElem {
 
-   UndoStackElem(std::shared_ptr<TrackList> &&tracks_,
+   UndoStackElem(TrackSnapshot &&tracks_,
       const wxString &description_,
       const wxString &shortDescription_,
       const SelectedRegion &selectedRegion_,
@@ -91,77 +99,198 @@ UndoManager::UndoManager( AudacityProject &project )
 UndoManager::~UndoManager()
 {
    ClearStates();
+   if (mAccountedSpaceUsage > 0)
+      sUndoHistoryMemory.Adjust( -(long long)mAccountedSpaceUsage );
 }
 
 namespace {
    SpaceArray::value_type
-   CalculateUsage(const TrackList &tracks, Set *seen)
+   CalculateUsage(const WaveTrack &wt, Set *seen)
    {
       SpaceArray::value_type result = 0;
 
-      //TIMER_START( "CalculateSpaceUsage", space_calc );
-      for (auto wt : tracks.Any< const WaveTrack >())
+      // Scan all clips within current track
+      for(const auto &clip : wt.GetAllClips())
       {
-         // Scan all clips within current track
-         for(const auto &clip : wt->GetAllClips())
+         // Scan all blockfiles within current clip
+         auto blocks = clip->GetSequenceBlockArray();
+         for (const auto &block : *blocks)
          {
-            // Scan all blockfiles within current clip
-            auto blocks = clip->GetSequenceBlockArray();
-            for (const auto &block : *blocks)
+            const auto &file = block.f;
+
+            // Accumulate space used by the file if the file was not
+            // yet seen
+            if ( !seen || (seen->count( &*file ) == 0 ) )
             {
-               const auto &file = block.f;
-
-               // Accumulate space used by the file if the file was not
-               // yet seen
-               if ( !seen || (seen->count( &*file ) == 0 ) )
-               {
-                  unsigned long long usage{ file->GetSpaceUsage() };
-                  result += usage;
-               }
-
-               // Add file to current set
-               if (seen)
-                  seen->insert( &*file );
+               unsigned long long usage{ file->GetSpaceUsage() };
+               result += usage;
             }
+
+            // Add file to current set
+            if (seen)
+               seen->insert( &*file );
          }
       }
 
       return result;
    }
-}
 
-void UndoManager::CalculateSpaceUsage()
-{
-   space.clear();
-   space.resize(stack.size(), 0);
+   SpaceArray::value_type
+   CalculateUsage(const TrackList &tracks, Set *seen)
+   {
+      SpaceArray::value_type result = 0;
+
+      //TIMER_START( "CalculateSpaceUsage", space_calc );
+      for (auto wt : tracks.Any< const WaveTrack >())
+         result += CalculateUsage(*wt, seen);
+
+      return result;
+   }
+
+   SpaceArray::value_type
+   CalculateUsage(const TrackSnapshot &tracks, Set *seen)
+   {
+      SpaceArray::value_type result = 0;
 
-   Set seen;
+      for (const auto &pTrack : tracks)
+         if (auto wt = track_cast<const WaveTrack*>(pTrack.get()))
+            result += CalculateUsage(*wt, seen);
 
-   // After copies and pastes, a block file may be used in more than
-   // one place in one undo history state, and it may be used in more than
-   // one undo history state.  It might even be used in two states, but not
-   // in another state that is between them -- as when you have state A,
-   // then make a cut to get state B, but then paste it back into state C.
+      return result;
+   }
 
-   // So be sure to count each block file once only, in the last undo item that
-   // contains it.
+   // View state is copied into duplicates too (see Track::Duplicate),
+   // so a snapshot may be shared only when it also matches
+   bool SameViewState(const Track &a, const Track &b)
+   {
+      auto &va = TrackView::Get( a );
+      auto &vb = TrackView::Get( b );
+
+      if (va.GetMinimized() != vb.GetMinimized() ||
+          va.GetActualHeight() != vb.GetActualHeight())
+         return false;
+
+      const auto pa = dynamic_cast<const WaveTrackView*>(&va);
+      const auto pb = dynamic_cast<const WaveTrackView*>(&vb);
+      if ((pa == nullptr) != (pb == nullptr))
+         return false;
+      if (pa) {
+         auto &placementsA = pa->SavePlacements();
+         auto &placementsB = pb->SavePlacements();
+         if (placementsA.size() != placementsB.size())
+            return false;
+         for (size_t ii = 0, nn = placementsA.size(); ii < nn; ++ii)
+            if (placementsA[ii].index != placementsB[ii].index ||
+                placementsA[ii].fraction != placementsB[ii].fraction)
+               return false;
+      }
 
-   // Why the last and not the first? Because the user of the History dialog
-   // may DELETE undo states, oldest first.  To reclaim disk space you must
-   // DELETE all states containing the block file.  So the block file's
-   // contribution to space usage should be counted only in that latest state.
+      return true;
+   }
 
-   for (size_t nn = stack.size(); nn--;)
+   // Duplicate the tracks for a NEW saved state, sharing the previous
+   // state's duplicate of every track that compares unchanged
+   TrackSnapshot MakeSnapshot(const TrackList &l, const TrackSnapshot *prev)
    {
-      // Scan all tracks at current level
-      auto &tracks = *stack[nn]->state.tracks;
-      space[nn] = CalculateUsage(tracks, &seen);
+      std::map<TrackId, std::shared_ptr<const Track>> previous;
+      if (prev)
+         for (const auto &pTrack : *prev)
+            previous[pTrack->GetId()] = pTrack;
+
+      TrackSnapshot result;
+      for (auto t : l) {
+         if ( t->GetId() == TrackId{} )
+            // Don't copy a pending added track
+            continue;
+         auto found = previous.find(t->GetId());
+         if (found != previous.end() &&
+             t->IsSameAs(*found->second) &&
+             SameViewState(*t, *found->second))
+            result.push_back(found->second);
+         else
+            result.push_back(t->Duplicate());
+      }
+      return result;
    }
+}
 
+bool UndoManager::CalculateSpaceUsage()
+{
+   // The clipboard is one state's worth; refresh it right here
    mClipboardSpaceUsage = CalculateUsage(
       Clipboard::Get().GetTracks(), nullptr);
 
-   //TIMER_STOP( space_calc );
+   ODLocker locker{ &mSpaceMutex };
+
+   if (mSpaceValid)
+      return true;
+
+   // Keep the array sized to the stack; what it holds meanwhile is the
+   // previous figures, or zero for states that did not have any yet
+   space.resize(stack.size(), 0);
+
+   if (mSpaceJobRunning)
+      return false;
+   mSpaceJobRunning = true;
+
+   // Snapshots are immutable, so a worker may walk copies of the
+   // vectors while editing continues; a generation number tells whether
+   // the stack changed meanwhile and the results must be thrown away
+   auto generation = mSpaceGeneration;
+   std::vector<TrackSnapshot> snapshots;
+   snapshots.reserve(stack.size());
+   for (const auto &elem : stack)
+      snapshots.push_back(elem->state.tracks);
+
+   mSpaceQueue.Post([this, generation, snapshots = std::move(snapshots)]{
+      // After copies and pastes, a block file may be used in more than
+      // one place in one undo history state, and it may be used in more than
+      // one undo history state.  It might even be used in two states, but not
+      // in another state that is between them -- as when you have state A,
+      // then make a cut to get state B, but then paste it back into state C.
+
+      // So be sure to count each block file once only, in the last undo item that
+      // contains it.
+
+      // Why the last and not the first? Because the user of the History dialog
+      // may DELETE undo states, oldest first.  To reclaim disk space you must
+      // DELETE all states containing the block file.  So the block file's
+      // contribution to space usage should be counted only in that latest state.
+
+      SpaceArray result(snapshots.size(), 0);
+      Set seen;
+      for (size_t nn = snapshots.size(); nn--;)
+      {
+         // Scan all tracks at current level
+         result[nn] = CalculateUsage(snapshots[nn], &seen);
+      }
+
+      ODLocker locker{ &mSpaceMutex };
+      mSpaceJobRunning = false;
+      if (generation == mSpaceGeneration) {
+         space.swap(result);
+         mSpaceValid = true;
+
+         unsigned long long total = 0;
+         for (const auto bytes : space)
+            total += bytes;
+         sUndoHistoryMemory.Adjust(
+            (long long)total - (long long)mAccountedSpaceUsage );
+         mAccountedSpaceUsage = total;
+      }
+      // Announce even outdated results; the next refresh starts over
+      // wxWidgets will own the event object
+      mProject.QueueEvent( safenew wxCommandEvent{ EVT_UNDO_SPACE_USAGE } );
+   });
+
+   return false;
+}
+
+void UndoManager::InvalidateSpaceUsage()
+{
+   ODLocker locker{ &mSpaceMutex };
+   mSpaceValid = false;
+   ++mSpaceGeneration;
 }
 
 wxLongLong_t UndoManager::GetLongDescription(unsigned int n, wxString *desc,
@@ -200,6 +329,7 @@ void UndoManager::SetLongDescription(unsigned int n, const wxString &desc)
 void UndoManager::RemoveStateAt(int n)
 {
    stack.erase(stack.begin() + n);
+   InvalidateSpaceUsage();
 }
 
 
@@ -249,23 +379,17 @@ void UndoManager::ModifyState(const TrackList * l,
    }
 
    SonifyBeginModifyState();
-   // Delete current -- not necessary, but let's reclaim space early
-   stack[current]->state.tracks.reset();
-
-   // Duplicate
-   auto tracksCopy = TrackList::Create();
-   for (auto t : *l) {
-      if ( t->GetId() == TrackId{} )
-         // Don't copy a pending added track
-         continue;
-      tracksCopy->Add(t->Duplicate());
-   }
+
+   // Duplicate, sharing with the state about to be replaced the
+   // duplicates of any tracks that have not changed
+   auto tracksCopy = MakeSnapshot(*l, &stack[current]->state.tracks);
 
    // Replace
    stack[current]->state.tracks = std::move(tracksCopy);
    stack[current]->state.tags = tags;
 
    stack[current]->state.selectedRegion = selectedRegion;
+   InvalidateSpaceUsage();
    SonifyEndModifyState();
 
    // wxWidgets will own the event object
@@ -293,13 +417,8 @@ void UndoManager::PushState(const TrackList * l,
       return;
    }
 
-   auto tracksCopy = TrackList::Create();
-   for (auto t : *l) {
-      if ( t->GetId() == TrackId{} )
-         // Don't copy a pending added track
-         continue;
-      tracksCopy->Add(t->Duplicate());
-   }
+   auto tracksCopy = MakeSnapshot(*l,
+      current >= 0 ? &stack[current]->state.tracks : nullptr);
 
    mayConsolidate = true;
 
@@ -324,6 +443,8 @@ void UndoManager::PushState(const TrackList * l,
 
    lastAction = longDescription;
 
+   InvalidateSpaceUsage();
+
    // wxWidgets will own the event object
    mProject.QueueEvent( safenew wxCommandEvent{ EVT_UNDO_PUSHED } );
 }
@@ -7,9 +7,10 @@
   Dominic Mazzoni
 
   After each operation, call UndoManager's PushState, pass it
-  the entire track hierarchy.  The UndoManager makes a duplicate
-  of every single track using its Duplicate method, which should
-  increment reference counts.  If we were not at the top of
+  the entire track hierarchy.  The UndoManager duplicates the
+  tracks the action changed using their Duplicate method, and
+  shares the previous state's duplicates of the rest, so a state
+  costs in proportion to the change.  If we were not at the top of
   the stack when this is called, DELETE above first.
 
   If a minor change is made, for example changing the visual
@@ -51,6 +52,7 @@
 
 #include <vector>
 #include <wx/event.h> // to declare custom event types
+#include "effects/TrackIOQueue.h" // member variable
 #include "ondemand/ODTaskThread.h"
 #include "ClientData.h"
 #include "SelectedRegion.h"
@@ -72,20 +74,31 @@ wxDECLARE_EXPORTED_EVENT(AUDACITY_DLL_API, EVT_UNDO_OR_REDO, wxCommandEvent);
 // contents did not change other than the pointer to current state
 wxDECLARE_EXPORTED_EVENT(AUDACITY_DLL_API, EVT_UNDO_RESET, wxCommandEvent);
 
+// A background computation of space usage finished; the figures that
+// CalculateSpaceUsage refreshes may have changed
+wxDECLARE_EXPORTED_EVENT(AUDACITY_DLL_API, EVT_UNDO_SPACE_USAGE, wxCommandEvent);
+
 class AudacityProject;
 class Tags;
 class Track;
 class TrackList;
 
 struct UndoStackElem;
+
+// The tracks of one saved state.  These duplicates are immutable once
+// pushed, so neighboring states share the entries for tracks that the
+// intervening action did not touch, and pushing a state costs in
+// proportion to what changed.
+using TrackSnapshot = std::vector< std::shared_ptr<const Track> >;
+
 struct UndoState {
-   UndoState(std::shared_ptr<TrackList> &&tracks_,
+   UndoState(TrackSnapshot &&tracks_,
       const std::shared_ptr<Tags> &tags_,
       const SelectedRegion &selectedRegion_)
       : tracks(std::move(tracks_)), tags(tags_), selectedRegion(selectedRegion_)
    {}
 
-   std::shared_ptr<TrackList> tracks;
+   TrackSnapshot tracks;
    std::shared_ptr<Tags> tags;
    SelectedRegion selectedRegion; // by value
 };
@@ -162,7 +175,12 @@ class AUDACITY_DLL_API UndoManager final
    wxLongLong_t GetClipboardSpaceUsage() const
    { return mClipboardSpaceUsage; }
 
-   void CalculateSpaceUsage();
+   // Refreshes the per-state figures and the clipboard figure.  Returns
+   // true when the per-state figures are current.  Otherwise they are
+   // stale or zero, and a background computation has been started that
+   // announces completion with EVT_UNDO_SPACE_USAGE from the project;
+   // calling again then picks up the results.
+   bool CalculateSpaceUsage();
 
    // void Debug(); // currently unused
 
@@ -172,8 +190,10 @@ class AUDACITY_DLL_API UndoManager final
    void ResetODChangesFlag();
 
  private:
+   void InvalidateSpaceUsage();
+
    AudacityProject &mProject;
- 
+
    int current;
    int saved;
    UndoStack stack;
@@ -181,12 +201,24 @@ class AUDACITY_DLL_API UndoManager final
    wxString lastAction;
    bool mayConsolidate { false };
 
+   // These four are guarded by mSpaceMutex; a worker fills in space
    SpaceArray space;
+   bool mSpaceValid { false };
+   bool mSpaceJobRunning { false };
+   unsigned mSpaceGeneration { 0 };
+   mutable ODLock mSpaceMutex;
+
    unsigned long long mClipboardSpaceUsage {};
+   // What this manager last told the memory tally; also guarded by
+   // mSpaceMutex
+   unsigned long long mAccountedSpaceUsage {};
 
    bool mODChanges;
    mutable ODLock mODChangesMutex;//mODChanges is accessed from many threads.
 
+   // Runs the space computations; last member, so the worker stops
+   // before anything it reads is destroyed
+   TrackIOQueue mSpaceQueue;
 };
 
 #endif
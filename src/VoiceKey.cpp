@@ -103,6 +103,7 @@ sampleCount VoiceKey::OnForward (
 
       //Change the millisecond-based parameters into sample-based parameters
       double rate = t.GetRate();                                                     //Translates seconds to samples
+      WaveTrackCache cache{ t.SharedPointer<const WaveTrack>() }; //One pool of cached reads for all the window statistics
       size_t WindowSizeInt = (rate  * mWindowSize);               //Size of window to examine
       size_t SignalWindowSizeInt = (rate  * mSignalWindowSize);   //This much signal is necessary to trip key
 
@@ -125,7 +126,7 @@ sampleCount VoiceKey::OnForward (
          const auto blocksize = limitSampleBufferSize( WindowSizeInt, samplesleft);
 
          //Test whether we are above threshold (the number of stats)
-         if(AboveThreshold(t,i,blocksize))
+         if(AboveThreshold(cache,i,blocksize))
             {
                blockruns++;                   //Hit
             } else {
@@ -167,13 +168,13 @@ sampleCount VoiceKey::OnForward (
 
          //Get initial test statistic values.
          if(mUseEnergy)
-            erg = TestEnergy(t, lastsubthresholdsample, WindowSizeInt);
+            erg = TestEnergy(cache, lastsubthresholdsample, WindowSizeInt);
 
          if(mUseSignChangesLow || mUseSignChangesHigh)
-            sc  = TestSignChanges(t,lastsubthresholdsample, WindowSizeInt);
+            sc  = TestSignChanges(cache,lastsubthresholdsample, WindowSizeInt);
 
          if(mUseDirectionChangesLow || mUseDirectionChangesHigh)
-            dc  = TestDirectionChanges(t,lastsubthresholdsample,WindowSizeInt);
+            dc  = TestDirectionChanges(cache,lastsubthresholdsample,WindowSizeInt);
 
 
          //Now, go through the sound again, sample by sample.
@@ -251,6 +252,7 @@ sampleCount VoiceKey::OnBackward (
 
       //Change the millisecond-based parameters into sample-based parameters
       double rate = t.GetRate();                                                     //Translates seconds to samples
+      WaveTrackCache cache{ t.SharedPointer<const WaveTrack>() }; //One pool of cached reads for all the window statistics
       size_t WindowSizeInt = (rate  * mWindowSize);               //Size of window to examine
       //unsigned int SilentWindowSizeInt = (unsigned int)(rate  * mSilentWindowSize);   //This much signal is necessary to trip key
 
@@ -274,7 +276,7 @@ sampleCount VoiceKey::OnBackward (
 
 
          //Test whether we are above threshold
-         if(AboveThreshold(t,i,blocksize))
+         if(AboveThreshold(cache,i,blocksize))
             {
                blockruns++;                   //Hit
             }
@@ -322,11 +324,11 @@ sampleCount VoiceKey::OnBackward (
 
          //Get initial test statistic values.
          if(mUseEnergy)
-            erg = TestEnergy(t, lastsubthresholdsample, WindowSizeInt);
+            erg = TestEnergy(cache, lastsubthresholdsample, WindowSizeInt);
          if(mUseSignChangesLow || mUseSignChangesHigh)
-            sc  = TestSignChanges(t,lastsubthresholdsample, WindowSizeInt);
+            sc  = TestSignChanges(cache,lastsubthresholdsample, WindowSizeInt);
          if(mUseDirectionChangesLow || mUseDirectionChangesHigh)
-            dc  = TestDirectionChanges(t,lastsubthresholdsample,WindowSizeInt);
+            dc  = TestDirectionChanges(cache,lastsubthresholdsample,WindowSizeInt);
 
          //Now, go through the sound again, sample by sample.
          size_t i;
@@ -397,6 +399,7 @@ sampleCount VoiceKey::OffForward (
 
       //Change the millisecond-based parameters into sample-based parameters
       double rate = t.GetRate();                                                     //Translates seconds to samples
+      WaveTrackCache cache{ t.SharedPointer<const WaveTrack>() }; //One pool of cached reads for all the window statistics
       unsigned int WindowSizeInt = (unsigned int)(rate  * mWindowSize);               //Size of window to examine
       unsigned int SilentWindowSizeInt = (unsigned int)(rate  * mSilentWindowSize);   //This much signal is necessary to trip key
 
@@ -416,7 +419,7 @@ sampleCount VoiceKey::OffForward (
          //Set blocksize so that it is the right size
          const auto blocksize = limitSampleBufferSize( WindowSizeInt, samplesleft);
 
-         if(!AboveThreshold(t,i,blocksize))
+         if(!AboveThreshold(cache,i,blocksize))
             {
                blockruns++;                   //Hit
             }
@@ -458,11 +461,11 @@ sampleCount VoiceKey::OffForward (
 
          //Get initial test statistic values.
          if(mUseEnergy)
-            erg = TestEnergy(t, lastsubthresholdsample, WindowSizeInt);
+            erg = TestEnergy(cache, lastsubthresholdsample, WindowSizeInt);
          if(mUseSignChangesLow || mUseSignChangesHigh)
-            sc  = TestSignChanges(t,lastsubthresholdsample, WindowSizeInt);
+            sc  = TestSignChanges(cache,lastsubthresholdsample, WindowSizeInt);
          if(mUseDirectionChangesLow || mUseDirectionChangesHigh)
-            dc  = TestDirectionChanges(t,lastsubthresholdsample,WindowSizeInt);
+            dc  = TestDirectionChanges(cache,lastsubthresholdsample,WindowSizeInt);
 
          //Now, go through the sound again, sample by sample.
          size_t i;
@@ -533,6 +536,7 @@ sampleCount VoiceKey::OffBackward (
 
       //Change the millisecond-based parameters into sample-based parameters
       double rate = t.GetRate();                                                     //Translates seconds to samples
+      WaveTrackCache cache{ t.SharedPointer<const WaveTrack>() }; //One pool of cached reads for all the window statistics
       unsigned int WindowSizeInt = (unsigned int)(rate  * mWindowSize);               //Size of window to examine
       //unsigned int SilentWindowSizeInt = (unsigned int)(rate  * mSilentWindowSize);   //This much signal is necessary to trip key
 
@@ -552,7 +556,7 @@ sampleCount VoiceKey::OffBackward (
          //Set blocksize so that it is the right size
          const auto blocksize = limitSampleBufferSize( WindowSizeInt, samplesleft);
 
-         if(!AboveThreshold(t,i,blocksize))
+         if(!AboveThreshold(cache,i,blocksize))
             {
 
                blockruns++;                   //Hit
@@ -595,11 +599,11 @@ sampleCount VoiceKey::OffBackward (
          double  dc=0;
          //Get initial test statistic values.
          if(mUseEnergy)
-            erg = TestEnergy(t, lastsubthresholdsample, WindowSizeInt);
+            erg = TestEnergy(cache, lastsubthresholdsample, WindowSizeInt);
          if(mUseSignChangesLow || mUseSignChangesHigh)
-            sc  = TestSignChanges(t,lastsubthresholdsample, WindowSizeInt);
+            sc  = TestSignChanges(cache,lastsubthresholdsample, WindowSizeInt);
          if(mUseDirectionChangesLow || mUseDirectionChangesHigh)
-            dc  = TestDirectionChanges(t,lastsubthresholdsample,WindowSizeInt);
+            dc  = TestDirectionChanges(cache,lastsubthresholdsample,WindowSizeInt);
 
          //Now, go through the sound again, sample by sample.
          size_t i;
@@ -659,7 +663,7 @@ sampleCount VoiceKey::OffBackward (
 
 //This tests whether a specified block region is above or below threshold.
 bool VoiceKey::AboveThreshold(
-   const WaveTrack & t, sampleCount start, sampleCount len)
+   WaveTrackCache & cache, sampleCount start, sampleCount len)
 {
 
    double erg=0;
@@ -672,7 +676,7 @@ bool VoiceKey::AboveThreshold(
    if(mUseEnergy)
       {
          testThreshold++;
-         erg = TestEnergy(t, start,len);
+         erg = TestEnergy(cache, start,len);
          tests +=(int)(erg > mThresholdEnergy);
 #if 0
          std::cout << "Energy: " << erg << " " <<mThresholdEnergy << std::endl;
@@ -682,7 +686,7 @@ bool VoiceKey::AboveThreshold(
    if(mUseSignChangesLow)
       {
          testThreshold++;
-         sc  = TestSignChanges(t,start,len);
+         sc  = TestSignChanges(cache,start,len);
          tests += (int)(sc < mThresholdSignChangesLower);
 #if 0
          std::cout << "SignChanges: " << sc << " " <<mThresholdSignChangesLower<< " < " << mThresholdSignChangesUpper << std::endl;
@@ -692,7 +696,7 @@ bool VoiceKey::AboveThreshold(
    if(mUseSignChangesHigh)
       {
          testThreshold++;
-         sc  = TestSignChanges(t,start,len);
+         sc  = TestSignChanges(cache,start,len);
          tests += (int)(sc > mThresholdSignChangesUpper);
 #if 0
          std::cout << "SignChanges: " << sc << " " <<mThresholdSignChangesLower<< " < " << mThresholdSignChangesUpper << std::endl;
@@ -704,7 +708,7 @@ bool VoiceKey::AboveThreshold(
    if(mUseDirectionChangesLow)
       {
          testThreshold++;
-         dc  = TestDirectionChanges(t,start,len);
+         dc  = TestDirectionChanges(cache,start,len);
          tests += (int)(dc < mThresholdDirectionChangesLower);
 #if 0
          std::cout << "DirectionChanges: " << dc << " " <<mThresholdDirectionChangesLower<< " < " << mThresholdDirectionChangesUpper << std::endl;
@@ -713,7 +717,7 @@ bool VoiceKey::AboveThreshold(
    if(mUseDirectionChangesHigh)
       {
          testThreshold++;
-         dc  = TestDirectionChanges(t,start,len);
+         dc  = TestDirectionChanges(cache,start,len);
          tests += (int)(dc > mThresholdDirectionChangesUpper);
 #if 0
          std::cout << "DirectionChanges: " << dc << " " <<mThresholdDirectionChangesLower<< " < " << mThresholdDirectionChangesUpper << std::endl;
@@ -757,6 +761,7 @@ void VoiceKey::CalibrateNoise(const WaveTrack & t, sampleCount start, sampleCoun
    //Now, change the millisecond-based parameters into sample-based parameters
    //(This depends on WaveTrack t)
    double rate = t.GetRate();
+   WaveTrackCache cache{ t.SharedPointer<const WaveTrack>() };
    unsigned int WindowSizeInt = (unsigned int)(rate  * mWindowSize);
    //   unsigned int SignalWindowSizeInt = (unsigned int)(rate  * mSignalWindowSize);
 
@@ -767,13 +772,13 @@ void VoiceKey::CalibrateNoise(const WaveTrack & t, sampleCount start, sampleCoun
    //changed later.
 
    //   if(mUseEnergy)
-   erg = TestEnergy(t, start, WindowSizeInt);
+   erg = TestEnergy(cache, start, WindowSizeInt);
 
    //   if(mUseSignChanges)
-   sc = TestSignChanges(t,start, WindowSizeInt);
+   sc = TestSignChanges(cache,start, WindowSizeInt);
 
    //   if(mUseDirectionChanges)
-   dc = TestDirectionChanges(t,start,WindowSizeInt);
+   dc = TestDirectionChanges(cache,start,WindowSizeInt);
 
    sumerg =0.0;
    sumerg2 = 0.0;
@@ -796,16 +801,16 @@ void VoiceKey::CalibrateNoise(const WaveTrack & t, sampleCount start, sampleCoun
          samples++;          //Increment the number of samples we have
          const auto blocksize = limitSampleBufferSize( WindowSizeInt, samplesleft);
 
-         erg = TestEnergy(t, i, blocksize);
+         erg = TestEnergy(cache, i, blocksize);
          sumerg +=(double)erg;
          sumerg2 += pow((double)erg,2);
 
-         sc = TestSignChanges(t,i, blocksize);
+         sc = TestSignChanges(cache,i, blocksize);
          sumsc += (double)sc;
          sumsc2 += pow((double)sc,2);
 
 
-         dc = TestDirectionChanges(t,i,blocksize);
+         dc = TestDirectionChanges(cache,i,blocksize);
          sumdc += (double)dc;
          sumdc2 += pow((double)dc,2);
       }
@@ -847,22 +852,24 @@ void VoiceKey::SetKeyType(bool erg, bool scLow , bool scHigh,
 
 //This might continue over a number of blocks.
 double VoiceKey::TestEnergy (
-   const WaveTrack & t, sampleCount start, sampleCount len)
+   WaveTrackCache & cache, sampleCount start, sampleCount len)
 {
 
    double sum = 1;
    auto s = start;                                //Keep track of start
    auto originalLen = len;                        //Keep track of the length of block to process (its not the length of t)
-   const auto blockSize = limitSampleBufferSize(
-      t.GetMaxBlockSize(), len);               //Determine size of sampling buffer
-   Floats buffer{ blockSize };       //Get a sampling buffer
+   const auto &t = *cache.GetTrack();
 
    while(len > 0)
       {
          //Figure out how much to grab
          auto block = limitSampleBufferSize ( t.GetBestBlockSize(s), len );
 
-         t.Get((samplePtr)buffer.get(), floatSample, s,block);                      //grab the block;
+         //grab the block; the cache lends out block memory without a copy
+         const float *buffer =
+            (const float *)cache.Get(floatSample, s, block, true);
+         if (!buffer)
+            break;
 
          //Now, go through the block and calculate energy
          for(decltype(block) i = 0; i< block; i++)
@@ -888,24 +895,25 @@ void VoiceKey::TestEnergyUpdate (double & prevErg, int len, const float & drop,
 
 
 double VoiceKey::TestSignChanges(
-   const WaveTrack & t, sampleCount start, sampleCount len)
+   WaveTrackCache & cache, sampleCount start, sampleCount len)
 {
 
 
    auto s = start;                                //Keep track of start
    auto originalLen = len;                        //Keep track of the length of block to process (its not the length of t)
-   const auto blockSize = limitSampleBufferSize(
-      t.GetMaxBlockSize(), len);               //Determine size of sampling buffer
+   const auto &t = *cache.GetTrack();
    unsigned long signchanges = 1;
    int currentsign=0;
 
-   Floats buffer{ blockSize };       //Get a sampling buffer
-
    while(len > 0) {
       //Figure out how much to grab
       auto block = limitSampleBufferSize ( t.GetBestBlockSize(s), len );
 
-      t.Get((samplePtr)buffer.get(), floatSample, s, block);                      //grab the block;
+      //grab the block; the cache lends out block memory without a copy
+      const float *buffer =
+         (const float *)cache.Get(floatSample, s, block, true);
+      if (!buffer)
+         break;
 
       if  (len == originalLen)
          {
@@ -944,25 +952,26 @@ void VoiceKey::TestSignChangesUpdate(double & currentsignchanges, int len,
 
 
 double VoiceKey::TestDirectionChanges(
-   const WaveTrack & t, sampleCount start, sampleCount len)
+   WaveTrackCache & cache, sampleCount start, sampleCount len)
 {
 
 
    auto s = start;                                //Keep track of start
    auto originalLen = len;                        //Keep track of the length of block to process (its not the length of t)
-   const auto blockSize = limitSampleBufferSize(
-      t.GetMaxBlockSize(), len);               //Determine size of sampling buffer
+   const auto &t = *cache.GetTrack();
    unsigned long directionchanges = 1;
    float lastval=float(0);
    int lastdirection=1;
 
-   Floats buffer{ blockSize };       //Get a sampling buffer
-
    while(len > 0) {
       //Figure out how much to grab
       auto block = limitSampleBufferSize ( t.GetBestBlockSize(s), len );
 
-      t.Get((samplePtr)buffer.get(), floatSample, s, block);                      //grab the block;
+      //grab the block; the cache lends out block memory without a copy
+      const float *buffer =
+         (const float *)cache.Get(floatSample, s, block, true);
+      if (!buffer)
+         break;
 
       if  (len == originalLen) {
          //The first time through, set stuff up special.
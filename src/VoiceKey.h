@@ -19,6 +19,7 @@
 #include "audacity/Types.h"
 
 class WaveTrack;
+class WaveTrackCache;
 
 enum VoiceKeyTypes
   {
@@ -44,7 +45,7 @@ class VoiceKey {
    void AdjustThreshold(double t);
 
 
-   bool AboveThreshold(const WaveTrack & t, sampleCount start,sampleCount len);
+   bool AboveThreshold(WaveTrackCache & cache, sampleCount start,sampleCount len);
 
    void SetKeyType(bool erg, bool scLow, bool scHigh,
                    bool dcLow, bool dcHigh);
@@ -79,11 +80,14 @@ class VoiceKey {
    double mSilentWindowSize;           //Time in milliseconds of below-threshold windows required for silence
    double mSignalWindowSize;           //Time in milliseconds of above-threshold windows required for speech
 
-   double TestEnergy (const WaveTrack & t, sampleCount start,sampleCount len);
+   // The test statistics read repeatedly from small, mostly adjacent
+   // windows, so they take a WaveTrackCache that lends out block memory
+   // rather than fetching and copying each window from the track anew.
+   double TestEnergy (WaveTrackCache & cache, sampleCount start,sampleCount len);
    double TestSignChanges (
-      const WaveTrack & t, sampleCount start, sampleCount len);
+      WaveTrackCache & cache, sampleCount start, sampleCount len);
    double TestDirectionChanges(
-      const WaveTrack & t, sampleCount start, sampleCount len);
+      WaveTrackCache & cache, sampleCount start, sampleCount len);
 
    void TestEnergyUpdate (double & prevErg, int length, const float & drop, const float & add);
    void TestSignChangesUpdate(double & currentsignchanges,int length, const float & a1,
@@ -25,9 +25,12 @@
 
 #include <math.h>
 #include <functional>
+#include <thread>
 #include <vector>
 #include <wx/log.h>
 
+#include "AudacityException.h"
+#include "Diags.h"
 #include "Sequence.h"
 #include "Spectrum.h"
 #include "Prefs.h"
@@ -45,6 +48,11 @@
 #include <omp.h>
 #endif
 
+// Running tallies of what the display caches hold, for the memory
+// section of the diagnostics report
+static DiagMemTag sWaveCacheMemory{ wxT("WaveClip wave caches") };
+static DiagMemTag sSpecCacheMemory{ wxT("WaveClip spectrogram caches") };
+
 class WaveCache {
 public:
    WaveCache()
@@ -74,6 +82,8 @@ public:
       , bl(len)
       , numODPixels(0)
    {
+      if (len > 0)
+         sWaveCacheMemory.Adjust( (long long)MemoryUsage() );
 
       //find the number of OD pixels - the only way to do this is by recounting since we've lost some old cache.
       numODPixels = CountODPixels(0, len);
@@ -81,9 +91,17 @@ public:
 
    ~WaveCache()
    {
+      if (len > 0)
+         sWaveCacheMemory.Adjust( -(long long)MemoryUsage() );
       ClearInvalidRegions();
    }
 
+   size_t MemoryUsage() const
+   {
+      return (1 + len) * sizeof(sampleCount) +
+         len * (3 * sizeof(float) + sizeof(int));
+   }
+
    int          dirty;
    const size_t len { 0 }; // counts pixels, not samples
    const double start;
@@ -264,25 +282,86 @@ protected:
 
 };
 
-static void ComputeSpectrumUsingRealFFTf
-   (float * __restrict buffer, const FFTParam *hFFT,
-    const float * __restrict window, size_t len, float * __restrict out)
+namespace {
+
+// How many retired waveform strips a clip keeps for reuse; each zoom
+// level in play typically owns one or two
+const size_t kMaxRetainedCaches = 8;
+
+// And how many bytes they may hold together per clip, so very wide
+// windows cannot pile up unbounded strips
+const size_t kMaxRetainedCacheBytes = 16 * 1024 * 1024;
+
+// Minimum spectrogram columns per worker before threads pay off; each
+// column costs an FFT, so the threshold can be low
+const int minSpectrumColumnsPerThread = 32;
+
+// Adjacent spectrogram columns transformed together per batch; enough
+// that the plan's tables stay hot across the back-to-back transforms
+const size_t kSpectrumBatch = 16;
+
+}
+
+ClipDisplayCache::~ClipDisplayCache()
+{
+}
+
+///Keep a retired strip of computed columns for later reuse, dropping
+///strips made stale by edits and the least recently used beyond the
+///budget.  Caller holds mWaveCacheMutex.
+void WaveClip::RetainWaveCache(std::unique_ptr<WaveCache> cache) const
+{
+   if (!cache || cache->len == 0 || cache->dirty != mDirty)
+      return;
+   mRetainedCaches.push_back(std::move(cache));
+   if (mRetainedCaches.size() > kMaxRetainedCaches)
+      mRetainedCaches.erase(mRetainedCaches.begin());
+
+   // Also hold the strips to a byte budget, oldest out first
+   size_t bytes = 0;
+   for (const auto &pCache : mRetainedCaches)
+      bytes += pCache->MemoryUsage();
+   while (bytes > kMaxRetainedCacheBytes && mRetainedCaches.size() > 1) {
+      bytes -= mRetainedCaches.front()->MemoryUsage();
+      mRetainedCaches.erase(mRetainedCaches.begin());
+   }
+}
+
+///Find and extract a retained strip at the given zoom level, most
+///recently used first.  Caller holds mWaveCacheMutex.
+std::unique_ptr<WaveCache> WaveClip::FindRetainedWaveCache(
+   double tstep, size_t numPixels) const
+{
+   for (auto it = mRetainedCaches.end(); it != mRetainedCaches.begin();) {
+      --it;
+      auto &pCache = *it;
+      if (pCache->dirty != mDirty) {
+         // Stale since some edit; no use keeping it
+         it = mRetainedCaches.erase(it);
+         continue;
+      }
+      // Same tolerant comparison of zoom levels as in GetWaveDisplay
+      if (fabs(tstep - 1.0 / pCache->pps) * numPixels < (1.0 / mRate)) {
+         auto result = std::move(pCache);
+         mRetainedCaches.erase(it);
+         return result;
+      }
+   }
+   return {};
+}
+
+// Convert one transformed buffer to power in dB terms
+static void ConvertRealFFTfToDb
+   (const FFTParam *hFFT, const float * __restrict buffer,
+    float * __restrict out)
 {
-   size_t i;
-   if(len > hFFT->Points * 2)
-      len = hFFT->Points * 2;
-   for(i = 0; i < len; i++)
-      buffer[i] *= window[i];
-   for( ; i < (hFFT->Points * 2); i++)
-      buffer[i] = 0; // zero pad as needed
-   RealFFTf(buffer, hFFT);
    // Handle the (real-only) DC
    float power = buffer[0] * buffer[0];
    if(power <= 0)
       out[0] = -160.0;
    else
       out[0] = 10.0 * log10f(power);
-   for(i = 1; i < hFFT->Points; i++) {
+   for(size_t i = 1; i < hFFT->Points; i++) {
       const int index = hFFT->BitReversed[i];
       const float re = buffer[index], im = buffer[index + 1];
       power = re * re + im * im;
@@ -293,6 +372,21 @@ static void ComputeSpectrumUsingRealFFTf
    }
 }
 
+static void ComputeSpectrumUsingRealFFTf
+   (float * __restrict buffer, const FFTParam *hFFT,
+    const float * __restrict window, size_t len, float * __restrict out)
+{
+   size_t i;
+   if(len > hFFT->Points * 2)
+      len = hFFT->Points * 2;
+   for(i = 0; i < len; i++)
+      buffer[i] *= window[i];
+   for( ; i < (hFFT->Points * 2); i++)
+      buffer[i] = 0; // zero pad as needed
+   RealFFTf(buffer, hFFT);
+   ConvertRealFFTfToDb(hFFT, buffer, out);
+}
+
 WaveClip::WaveClip(const std::shared_ptr<DirManager> &projDirManager,
                    sampleFormat format, int rate, int colourIndex)
 {
@@ -398,6 +492,11 @@ bool WaveClip::GetSamples(samplePtr buffer, sampleFormat format,
    return mSequence->Get(buffer, format, start, len, mayThrow);
 }
 
+SequenceFloatView WaveClip::GetFloatView(sampleCount start, size_t len) const
+{
+   return mSequence->GetFloatView(start, len);
+}
+
 void WaveClip::SetSamples(samplePtr buffer, sampleFormat format,
                    sampleCount start, size_t len)
 // STRONG-GUARANTEE
@@ -474,6 +573,9 @@ void WaveClip::ClearWaveCache()
 {
    ODLocker locker(&mWaveCacheMutex);
    mWaveCache = std::make_unique<WaveCache>();
+   mRetainedCaches.clear();
+   if (mClipDisplayCache)
+      mClipDisplayCache->Invalidate();
 }
 
 ///Adds an invalid region to the wavecache so it redraws that portion only.
@@ -482,6 +584,12 @@ void WaveClip::AddInvalidRegion(sampleCount startSample, sampleCount endSample)
    ODLocker locker(&mWaveCacheMutex);
    if(mWaveCache!=NULL)
       mWaveCache->AddInvalidRegion(startSample,endSample);
+   for (auto &pCache : mRetainedCaches)
+      pCache->AddInvalidRegion(startSample, endSample);
+   // On-demand loading changes what a repaint must show, without
+   // advancing the dirty counter
+   if (mClipDisplayCache)
+      mClipDisplayCache->Invalidate();
 }
 
 namespace {
@@ -607,12 +715,23 @@ bool WaveClip::GetWaveDisplay(WaveDisplay &display, double t0,
          return true;
       }
 
+      DIAG_COUNT( "GetWaveDisplay cache miss", 1 );
+
       std::unique_ptr<WaveCache> oldCache(std::move(mWaveCache));
 
+      bool reusable = match;
+      if (!reusable) {
+         // The strip in hand is at another zoom level or stale; retire
+         // it and see whether a retained strip fits this zoom
+         RetainWaveCache(std::move(oldCache));
+         oldCache = FindRetainedWaveCache(tstep, numPixels);
+         reusable = oldCache != nullptr;
+      }
+
       int oldX0 = 0;
       double correction = 0.0;
       size_t copyBegin = 0, copyEnd = 0;
-      if (match) {
+      if (reusable) {
          findCorrection(oldCache->where, oldCache->len, numPixels,
             t0, mRate, samplesPerPixel,
             oldX0, correction);
@@ -625,7 +744,9 @@ bool WaveClip::GetWaveDisplay(WaveDisplay &display, double t0,
          ));
       }
       if (!(copyEnd > copyBegin))
-         oldCache.reset(0);
+         // No overlap with the new window, but still current at its
+         // zoom level; keep it for when the view comes back
+         RetainWaveCache(std::move(oldCache));
 
       mWaveCache = std::make_unique<WaveCache>(numPixels, pixelsPerSecond, mRate, t0, mDirty);
       min = &mWaveCache->min[0];
@@ -661,6 +782,8 @@ bool WaveClip::GetWaveDisplay(WaveDisplay &display, double t0,
          memcpy(&max[copyBegin], &oldCache->max[srcIdx], sizeFloats);
          memcpy(&rms[copyBegin], &oldCache->rms[srcIdx], sizeFloats);
          memcpy(&bl[copyBegin], &oldCache->bl[srcIdx], length * sizeof(int));
+
+         RetainWaveCache(std::move(oldCache));
       }
    }
 
@@ -1043,6 +1166,83 @@ bool SpecCache::CalculateOneSpectrum
    return result;
 }
 
+void SpecCache::CalculateSpectrumBatch
+   (const SpectrogramSettings &settings,
+    WaveTrackCache &waveTrackCache,
+    int begin, int end, const sampleCount numSamples,
+    double offset, double rate, double pixelsPerSecond,
+    int lowerBoundX, int upperBoundX,
+    const std::vector<float> &gainFactors,
+    float* __restrict workspace, float* __restrict out) const
+{
+   const size_t windowSizeSetting = settings.WindowSize();
+   const size_t zeroPaddingFactorSetting = settings.ZeroPaddingFactor();
+   const size_t padding = (windowSizeSetting * (zeroPaddingFactorSetting - 1)) / 2;
+   const size_t fftLen = windowSizeSetting * zeroPaddingFactorSetting;
+   const auto nBins = settings.NBins();
+   const float *const window = settings.window.get();
+   const auto hFFT = settings.hFFT.get();
+
+   wxASSERT(end - begin <= (int)kSpectrumBatch);
+   bool gathered[kSpectrumBatch];
+
+   // First pass: take each column's window of samples and multiply it
+   // into the contiguous workspace.  Columns whose windows reach past
+   // either end of the clip take the general single-column path, which
+   // knows how to pad; their slots double as its scratch.
+   for (int xx = begin; xx < end; ++xx) {
+      float *const slot = workspace + (xx - begin) * fftLen;
+      auto from = where[xx] - (windowSizeSetting >> 1);
+
+      const float *useBuffer = 0;
+      if (from >= 0 && from + windowSizeSetting <= numSamples)
+         useBuffer = (float*)(waveTrackCache.Get(
+            floatSample, sampleCount(
+               floor(0.5 + from.as_double() + offset * rate)
+            ),
+            windowSizeSetting,
+            // Don't throw in this drawing operation
+            false)
+         );
+
+      if (!useBuffer) {
+         gathered[xx - begin] = false;
+         CalculateOneSpectrum(
+            settings, waveTrackCache, xx, numSamples,
+            offset, rate, pixelsPerSecond,
+            lowerBoundX, upperBoundX,
+            gainFactors, slot, out);
+         continue;
+      }
+
+      gathered[xx - begin] = true;
+      if (padding) {
+         memset(slot, 0, padding * sizeof(float));
+         memset(slot + padding + windowSizeSetting, 0,
+            (fftLen - padding - windowSizeSetting) * sizeof(float));
+      }
+      for (size_t ii = 0; ii < windowSizeSetting; ++ii)
+         slot[padding + ii] = useBuffer[ii] * window[padding + ii];
+   }
+
+   // Second pass: transform the gathered columns back-to-back with the
+   // shared plan, whose tables then stay hot in cache
+   for (int xx = begin; xx < end; ++xx) {
+      if (!gathered[xx - begin])
+         continue;
+      float *const slot = workspace + (xx - begin) * fftLen;
+      RealFFTf(slot, hFFT);
+
+      float *const results = &out[nBins * xx];
+      ConvertRealFFTfToDb(hFFT, slot, results);
+      if (!gainFactors.empty()) {
+         // Apply a frequency-dependant gain factor
+         for (size_t ii = 0; ii < nBins; ++ii)
+            results[ii] += gainFactors[ii];
+      }
+   }
+}
+
 void SpecCache::Grow(size_t len_, const SpectrogramSettings& settings,
                        double pixelsPerSecond, double start_)
 {
@@ -1064,6 +1264,18 @@ void SpecCache::Grow(size_t len_, const SpectrogramSettings& settings,
    windowSize = settings.WindowSize();
    zeroPaddingFactor = settings.ZeroPaddingFactor();
    frequencyGain = settings.frequencyGain;
+
+   // Tell the memory tally what the vectors hold now
+   const size_t newBytes = freq.capacity() * sizeof(float) +
+      where.capacity() * sizeof(sampleCount);
+   sSpecCacheMemory.Adjust( (long long)newBytes - (long long)accountedBytes );
+   accountedBytes = newBytes;
+}
+
+SpecCache::~SpecCache()
+{
+   if (accountedBytes > 0)
+      sSpecCacheMemory.Adjust( -(long long)accountedBytes );
 }
 
 void SpecCache::Populate
@@ -1089,8 +1301,11 @@ void SpecCache::Populate
    const size_t fftLen = windowSizeSetting * zeroPaddingFactorSetting;
    const auto nBins = settings.NBins();
 
+   const bool plainFFT = !autocorrelation && !reassignment;
    const size_t bufferSize = fftLen;
-   const size_t scratchSize = reassignment ? 3 * bufferSize : bufferSize;
+   const size_t scratchSize = reassignment ? 3 * bufferSize :
+      // room for a whole batch of transforms in the common case
+      plainFFT ? kSpectrumBatch * fftLen : bufferSize;
    std::vector<float> scratch(scratchSize);
 
    std::vector<float> gainFactors;
@@ -1103,40 +1318,48 @@ void SpecCache::Populate
       const int lowerBoundX = jj == 0 ? 0 : copyEnd;
       const int upperBoundX = jj == 0 ? copyBegin : numPixels;
 
-#ifdef _OPENMP
-      // Storage for mutable per-thread data.
-      // private clause ensures one copy per thread
-      struct ThreadLocalStorage {
-         ThreadLocalStorage()  { }
-         ~ThreadLocalStorage() { }
-
-         void init(WaveTrackCache &waveTrackCache, size_t scratchSize) {
-            if (!cache) {
-               cache = std::make_unique<WaveTrackCache>(waveTrackCache.GetTrack());
-               scratch.resize(scratchSize);
-            }
-         }
-         std::unique_ptr<WaveTrackCache> cache;
-         std::vector<float> scratch;
-      } tls;
+      auto work = [&](int from, int to, WaveTrackCache &cache, float *buffer) {
+         if (plainFFT)
+            for (auto xx = from; xx < to; xx += kSpectrumBatch)
+               CalculateSpectrumBatch(
+                  settings, cache,
+                  xx, std::min<int>(to, xx + kSpectrumBatch), numSamples,
+                  offset, rate, pixelsPerSecond,
+                  lowerBoundX, upperBoundX,
+                  gainFactors, buffer, &freq[0]);
+         else
+            for (auto xx = from; xx < to; ++xx)
+               CalculateOneSpectrum(
+                  settings, cache, xx, numSamples,
+                  offset, rate, pixelsPerSecond,
+                  lowerBoundX, upperBoundX,
+                  gainFactors, buffer, &freq[0]);
+      };
 
-      #pragma omp parallel for private(tls)
-#endif
-      for (auto xx = lowerBoundX; xx < upperBoundX; ++xx)
-      {
-#ifdef _OPENMP
-         tls.init(waveTrackCache, scratchSize);
-         WaveTrackCache& cache = *tls.cache;
-         float* buffer = &tls.scratch[0];
-#else
-         WaveTrackCache& cache = waveTrackCache;
-         float* buffer = &scratch[0];
-#endif
-         CalculateOneSpectrum(
-            settings, cache, xx, numSamples,
-            offset, rate, pixelsPerSecond,
-            lowerBoundX, upperBoundX,
-            gainFactors, buffer, &freq[0]);
+      // Each column is an independent FFT writing its own bins, except
+      // under reassignment, which spreads energy into neighbouring
+      // columns and so must stay serial
+      const int nColumns = upperBoundX - lowerBoundX;
+      const unsigned nThreads = reassignment ? 1 : std::min<unsigned>(
+         std::max(1u, std::thread::hardware_concurrency()),
+         nColumns / minSpectrumColumnsPerThread );
+
+      if (nThreads < 2)
+         work(lowerBoundX, upperBoundX, waveTrackCache, &scratch[0]);
+      else {
+         // One sample cache and scratch buffer per worker
+         std::vector<std::thread> threads;
+         const int chunk = (nColumns + nThreads - 1) / nThreads;
+         for (unsigned w = 0; w < nThreads; ++w)
+            threads.emplace_back([&, w]{
+               WaveTrackCache cache{ waveTrackCache.GetTrack() };
+               std::vector<float> buffer(scratchSize);
+               const int from = lowerBoundX + w * chunk;
+               const int to = std::min(upperBoundX, from + chunk);
+               work(from, to, cache, &buffer[0]);
+            });
+         for (auto &thread : threads)
+            thread.join();
       }
 
       if (reassignment) {
@@ -1195,6 +1418,28 @@ void SpecCache::Populate
    }
 }
 
+unsigned SpecCache::AccumulateColumns
+   (sampleCount s0, sampleCount s1,
+    const std::vector<float> &gainFactors,
+    std::vector<double> &acc) const
+{
+   const auto nBins = acc.size();
+   unsigned nColumns = 0;
+   for (size_t xx = 0; xx < len; ++xx) {
+      if (where[xx] < s0 || where[xx] >= s1)
+         continue;
+      const float *const column = &freq[nBins * xx];
+      for (size_t ii = 0; ii < nBins; ++ii) {
+         const double dB = gainFactors.empty()
+            ? column[ii]
+            : column[ii] - gainFactors[ii];
+         acc[ii] += pow(10.0, dB / 10.0);
+      }
+      ++nColumns;
+   }
+   return nColumns;
+}
+
 bool WaveClip::GetSpectrogram(WaveTrackCache &waveTrackCache,
                               const float *& spectrogram,
                               const sampleCount *& where,
@@ -1306,6 +1551,41 @@ bool WaveClip::GetSpectrogram(WaveTrackCache &waveTrackCache,
    return true;
 }
 
+unsigned WaveClip::GetCachedSpectrum(const SpectrogramSettings &settings,
+   double t0, double t1, std::vector<double> &acc) const
+{
+   // Only the plain FFT algorithm stores per-column dB values that can
+   // be averaged here; reassignment and pitch columns mean other things
+   if (settings.algorithm != SpectrogramSettings::algSTFT)
+      return 0;
+
+   // The cache must have been computed from the current samples with the
+   // current transform parameters; the column spacing (pps) does not
+   // matter, since each column is exact at any spacing
+   if (!mSpecCache ||
+       mSpecCache->len == 0 ||
+       mSpecCache->dirty != mDirty ||
+       mSpecCache->algorithm != settings.algorithm ||
+       mSpecCache->windowType != settings.windowType ||
+       mSpecCache->windowSize != settings.WindowSize() ||
+       mSpecCache->zeroPaddingFactor != settings.ZeroPaddingFactor() ||
+       mSpecCache->frequencyGain != settings.frequencyGain)
+      return 0;
+
+   sampleCount s0, s1;
+   TimeToSamplesClip(t0, &s0);
+   TimeToSamplesClip(t1, &s1);
+   if (s1 <= s0)
+      return 0;
+
+   // Undo the display-only frequency gain that Populate added
+   std::vector<float> gainFactors;
+   ComputeSpectrogramGainFactors(
+      settings.GetFFTLength(), mRate, settings.frequencyGain, gainFactors);
+
+   return mSpecCache->AccumulateColumns(s0, s1, gainFactors, acc);
+}
+
 std::pair<float, float> WaveClip::GetMinMax(
    double t0, double t1, bool mayThrow) const
 {
@@ -1348,12 +1628,19 @@ float WaveClip::GetRMS(double t0, double t1, bool mayThrow) const
    return mSequence->GetRMS(s0, s1-s0, mayThrow);
 }
 
-void WaveClip::ConvertToSampleFormat(sampleFormat format)
+bool WaveClip::GetSummaries256(sampleCount start, size_t len,
+   std::vector<SummaryFrame> &results) const
+{
+   return mSequence->GetSummaries256(start, len, results);
+}
+
+void WaveClip::ConvertToSampleFormat(sampleFormat format,
+                                     ProgressDialog *progress)
 {
    // Note:  it is not necessary to do this recursively to cutlines.
    // They get converted as needed when they are expanded.
 
-   auto bChanged = mSequence->ConvertToSampleFormat(format);
+   auto bChanged = mSequence->ConvertToSampleFormat(format, progress);
    if (bChanged)
       MarkChanged();
 }
@@ -1431,6 +1718,20 @@ void WaveClip::Append(samplePtr buffer, sampleFormat format,
       if (len == 0)
          break;
 
+      if (mAppendBufferLen == 0 && len >= blockSize &&
+          format == seqFormat && stride == 1) {
+         // Whole blocks can go to the sequence straight from the caller's
+         // buffer, without staging through mAppendBuffer
+         // use STRONG-GUARANTEE
+         mSequence->Append(buffer, seqFormat, blockSize, blockFileLog);
+
+         // use NOFAIL-GUARANTEE for rest of this "if"
+         buffer += blockSize * SAMPLE_SIZE(format);
+         len -= blockSize;
+         blockSize = mSequence->GetIdealAppendLen();
+         continue;
+      }
+
       // use NOFAIL-GUARANTEE for rest of this "for"
       wxASSERT(mAppendBufferLen <= maxBlockSize);
       auto toCopy = std::min(len, maxBlockSize - mAppendBufferLen);
@@ -1483,6 +1784,10 @@ void WaveClip::Flush()
 
       mSequence->Append(mAppendBuffer.ptr(), mSequence->GetSampleFormat(),
          mAppendBufferLen);
+
+      // Tidy any run of small trailing blocks left by the flush; failing
+      // to do so is harmless, so don't let it fail the flush
+      GuardedCall( [&] { mSequence->CoalesceTrailingBlocks(); } );
    }
 
    //wxLogDebug(wxT("now sample count %lli"), (long long) mSequence->GetNumSamples());
@@ -1960,6 +2265,8 @@ void WaveClip::Resample(int rate, ProgressDialog *progress)
 
       // Invalidate wave display cache
       mWaveCache = std::make_unique<WaveCache>();
+      mRetainedCaches.clear();
+      mClipDisplayCache.reset();
       // Invalidate the spectrum display cache
       mSpecCache = std::make_unique<SpecCache>();
 
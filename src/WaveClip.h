@@ -22,6 +22,7 @@
 
 #include <wx/longlong.h>
 
+#include <atomic>
 #include <vector>
 
 class BlockArray;
@@ -31,7 +32,9 @@ class DirManager;
 class Envelope;
 class ProgressDialog;
 class Sequence;
+class SequenceFloatView;
 class SpectrogramSettings;
+struct SummaryFrame;
 class WaveCache;
 class WaveTrackCache;
 class wxFileNameWrapper;
@@ -50,9 +53,7 @@ public:
    {
    }
 
-   ~SpecCache()
-   {
-   }
+   ~SpecCache();
 
    bool Matches(int dirty_, double pixelsPerSecond,
       const SpectrogramSettings &settings, double rate) const;
@@ -68,6 +69,19 @@ public:
        float* __restrict scratch,
        float* __restrict out) const;
 
+   // Calculate a short run of adjacent columns together: windowed into
+   // one contiguous workspace, then transformed back-to-back with the
+   // shared plan.  Only for the plain FFT algorithm; the workspace must
+   // hold (end - begin) transforms.
+   void CalculateSpectrumBatch
+      (const SpectrogramSettings &settings,
+       WaveTrackCache &waveTrackCache,
+       int begin, int end, sampleCount numSamples,
+       double offset, double rate, double pixelsPerSecond,
+       int lowerBoundX, int upperBoundX,
+       const std::vector<float> &gainFactors,
+       float* __restrict workspace, float* __restrict out) const;
+
    // Grow the cache while preserving the (possibly now invalid!) contents
    void Grow(size_t len_, const SpectrogramSettings& settings,
                double pixelsPerSecond, double start_);
@@ -79,6 +93,17 @@ public:
        sampleCount numSamples,
        double offset, double rate, double pixelsPerSecond);
 
+   // Sum already-computed columns whose positions fall in the
+   // clip-relative sample range [s0, s1) into acc as linear power per
+   // bin; acc.size() must be the bin count the cache was computed with.
+   // gainFactors, when non-empty, are subtracted from the stored dB
+   // values first, undoing the display frequency gain.  Returns the
+   // number of columns summed; never computes new columns.
+   unsigned AccumulateColumns
+      (sampleCount s0, sampleCount s1,
+       const std::vector<float> &gainFactors,
+       std::vector<double> &acc) const;
+
    size_t       len { 0 }; // counts pixels, not samples
    int          algorithm;
    double       pps;
@@ -91,6 +116,7 @@ public:
    std::vector<sampleCount> where;
 
    int          dirty;
+   size_t       accountedBytes { 0 }; // what Grow() told the memory tally
 };
 
 class SpecPxCache {
@@ -98,6 +124,7 @@ public:
    SpecPxCache(size_t cacheLen)
       : len{ cacheLen }
       , values{ len }
+      , rawValues{ len }
    {
       valid = false;
       scaleType = 0;
@@ -107,6 +134,9 @@ public:
 
    size_t  len;
    Floats values;
+   // Same pixels before the gain/range normalization; lets the drawing
+   // code remap to colours cheaply when only those sliders move
+   Floats rawValues;
    bool         valid;
 
    int scaleType;
@@ -116,6 +146,22 @@ public:
    int maxFreq;
 };
 
+// Base class for renderings the drawing code attaches to a clip and
+// reuses across repaints; the concrete cache lives with the view code
+// (see WaveformView), the clip only owns and invalidates it
+class ClipDisplayCache {
+public:
+   virtual ~ClipDisplayCache();
+
+   // Callable from worker threads; only marks, frees nothing
+   void Invalidate() { mValid.store(false); }
+   bool IsValid() const { return mValid.load(); }
+   void Validate() { mValid.store(true); }
+
+private:
+   std::atomic<bool> mValid{ false };
+};
+
 class WaveClip;
 
 // Array of pointers that assume ownership
@@ -198,7 +244,8 @@ public:
 
    virtual ~WaveClip();
 
-   void ConvertToSampleFormat(sampleFormat format);
+   void ConvertToSampleFormat(sampleFormat format,
+                              ProgressDialog *progress = NULL);
 
    // Always gives non-negative answer, not more than sample sequence length
    // even if t0 really falls outside that range
@@ -234,6 +281,9 @@ public:
 
    bool GetSamples(samplePtr buffer, sampleFormat format,
                    sampleCount start, size_t len, bool mayThrow = true) const;
+   /// In-place read of float samples; empty view when not possible.  See
+   /// Sequence::GetFloatView.
+   SequenceFloatView GetFloatView(sampleCount start, size_t len) const;
    void SetSamples(samplePtr buffer, sampleFormat format,
                    sampleCount start, size_t len);
 
@@ -254,6 +304,10 @@ public:
    void MarkChanged() // NOFAIL-GUARANTEE
       { mDirty++; }
 
+   /** Counter that MarkChanged() increments; lets other caches of rendered
+    * audio detect that their contents are stale. */
+   int GetDirty() const { return mDirty; }
+
    /** Getting high-level data for screen display and clipping
     * calculations and Contrast */
    bool GetWaveDisplay(WaveDisplay &display,
@@ -263,10 +317,22 @@ public:
                        const sampleCount *& where,
                        size_t numPixels,
                        double t0, double pixelsPerSecond) const;
+   // Query the spectrogram display cache without computing anything new:
+   // average the cached columns lying in track times [t0, t1] into acc
+   // as linear power per bin (settings.NBins() values, display frequency
+   // gain removed).  Returns the number of columns used, 0 when the
+   // cache is stale for the settings or covers none of the range.
+   unsigned GetCachedSpectrum(const SpectrogramSettings &settings,
+      double t0, double t1, std::vector<double> &acc) const;
    std::pair<float, float> GetMinMax(
       double t0, double t1, bool mayThrow = true) const;
    float GetRMS(double t0, double t1, bool mayThrow = true) const;
 
+   // Fetch min/max summary frames for a range of the clip; start is
+   // relative to the clip.  See Sequence::GetSummaries256.
+   bool GetSummaries256(sampleCount start, size_t len,
+      std::vector<SummaryFrame> &results) const;
+
    // Set/clear/get rectangle that this WaveClip fills on screen. This is
    // called by TrackArtist while actually drawing the tracks and clips.
    void ClearDisplayRect() const;
@@ -365,7 +431,16 @@ public:
    // Cache of values to colour pixels of Spectrogram - used by TrackArtist
    mutable std::unique_ptr<SpecPxCache> mSpecPxCache;
 
+   // Cache of the rendered waveform image - used by WaveformView
+   mutable std::unique_ptr<ClipDisplayCache> mClipDisplayCache;
+
 protected:
+   // Management of the retained waveform strips; callers hold
+   // mWaveCacheMutex already
+   void RetainWaveCache(std::unique_ptr<WaveCache> cache) const;
+   std::unique_ptr<WaveCache> FindRetainedWaveCache(
+      double tstep, size_t numPixels) const;
+
    mutable wxRect mDisplayRect {};
 
    double mOffset { 0 };
@@ -377,6 +452,9 @@ protected:
    std::unique_ptr<Envelope> mEnvelope;
 
    mutable std::unique_ptr<WaveCache> mWaveCache;
+   // Recently retired waveform strips, most recently used last, kept
+   // for reuse when the view returns to their zoom level
+   mutable std::vector<std::unique_ptr<WaveCache>> mRetainedCaches;
    mutable ODLock       mWaveCacheMutex {};
    mutable std::unique_ptr<SpecCache> mSpecCache;
    SampleBuffer  mAppendBuffer {};
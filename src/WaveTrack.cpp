@@ -326,6 +326,98 @@ Track::Holder WaveTrack::Clone() const
    return std::make_shared<WaveTrack>( *this );
 }
 
+namespace {
+
+bool SameEnvelope(const Envelope &a, const Envelope &b)
+{
+   if (a.GetOffset() != b.GetOffset() ||
+       a.GetTrackLen() != b.GetTrackLen() ||
+       a.GetExponential() != b.GetExponential() ||
+       a.GetNumberOfPoints() != b.GetNumberOfPoints())
+      return false;
+
+   for (int ii = 0, nn = (int)a.GetNumberOfPoints(); ii < nn; ++ii)
+      if (a[ii].GetT() != b[ii].GetT() ||
+          a[ii].GetVal() != b[ii].GetVal())
+         return false;
+
+   return true;
+}
+
+bool SameClip(const WaveClip &a, const WaveClip &b)
+{
+   if (a.GetOffset() != b.GetOffset() ||
+       a.GetRate() != b.GetRate() ||
+       a.GetColourIndex() != b.GetColourIndex() ||
+       a.GetNumSamples() != b.GetNumSamples() ||
+       !SameEnvelope(*a.GetEnvelope(), *b.GetEnvelope()))
+      return false;
+
+   // Block files are immutable once written, so sequences that list the
+   // same files at the same positions carry the same samples
+   const auto pa = a.GetSequenceBlockArray(),
+              pb = b.GetSequenceBlockArray();
+   if (pa->size() != pb->size())
+      return false;
+   for (size_t ii = 0, nn = pa->size(); ii < nn; ++ii)
+      if ((*pa)[ii].start != (*pb)[ii].start ||
+          (*pa)[ii].f != (*pb)[ii].f)
+         return false;
+
+   auto &ca = a.GetCutLines(), &cb = b.GetCutLines();
+   if (ca.size() != cb.size())
+      return false;
+   for (size_t ii = 0, nn = ca.size(); ii < nn; ++ii)
+      if (!SameClip(*ca[ii], *cb[ii]))
+         return false;
+
+   return true;
+}
+
+}
+
+bool WaveTrack::IsSameAs(const Track &other) const
+{
+   const auto pOther = track_cast<const WaveTrack*>(&other);
+   if (!pOther)
+      return false;
+
+   // Everything Init copies
+   if (GetId() != pOther->GetId() ||
+       mName != pOther->mName ||
+       mDefaultName != pOther->mDefaultName ||
+       mSelected != pOther->mSelected ||
+       GetLinked() != pOther->GetLinked() ||
+       GetChannel() != pOther->GetChannel() ||
+       GetOffset() != pOther->GetOffset() ||
+       GetMute() != pOther->GetMute() ||
+       GetSolo() != pOther->GetSolo() ||
+       mFormat != pOther->mFormat ||
+       mWaveColorIndex != pOther->mWaveColorIndex ||
+       mRate != pOther->mRate ||
+       mGain != pOther->mGain ||
+       mPan != pOther->mPan ||
+       mDisplayMin != pOther->mDisplayMin ||
+       mDisplayMax != pOther->mDisplayMax ||
+       mSpectrumMin != pOther->mSpectrumMin ||
+       mSpectrumMax != pOther->mSpectrumMax)
+      return false;
+
+   // Per-track display settings have no cheap comparison; claim
+   // difference whenever either track carries its own
+   if (mpSpectrumSettings || pOther->mpSpectrumSettings ||
+       mpWaveformSettings || pOther->mpWaveformSettings)
+      return false;
+
+   if (mClips.size() != pOther->mClips.size())
+      return false;
+   for (size_t ii = 0, nn = mClips.size(); ii < nn; ++ii)
+      if (!SameClip(*mClips[ii], *pOther->mClips[ii]))
+         return false;
+
+   return true;
+}
+
 double WaveTrack::GetRate() const
 {
    return mRate;
@@ -411,12 +503,13 @@ void WaveTrack::SetWaveColorIndex(int colorIndex)
 }
 
 
-void WaveTrack::ConvertToSampleFormat(sampleFormat format)
+void WaveTrack::ConvertToSampleFormat(sampleFormat format,
+                                      ProgressDialog *progress)
 // WEAK-GUARANTEE
 // might complete on only some clips
 {
    for (const auto &clip : mClips)
-      clip->ConvertToSampleFormat(format);
+      clip->ConvertToSampleFormat(format, progress);
    mFormat = format;
 }
 
@@ -1489,8 +1582,17 @@ void WaveTrack::Append(samplePtr buffer, sampleFormat format,
                                         blockFileLog);
 }
 
-sampleCount WaveTrack::GetBlockStart(sampleCount s) const
+sampleCount WaveTrack::GetBlockStart(sampleCount s, WaveClipCursor *pCursor) const
 {
+   if (pCursor)
+   {
+      const auto pEntry = pCursor->Locate(s);
+      if (pEntry && s >= pEntry->start)
+         return pEntry->start +
+            pEntry->pClip->GetSequence()->GetBlockStart(s - pEntry->start);
+      return -1;
+   }
+
    for (const auto &clip : mClips)
    {
       const auto startSample = (sampleCount)floor(0.5 + clip->GetStartTime()*mRate);
@@ -1502,8 +1604,16 @@ sampleCount WaveTrack::GetBlockStart(sampleCount s) const
    return -1;
 }
 
-size_t WaveTrack::GetBestBlockSize(sampleCount s) const
+size_t WaveTrack::GetBestBlockSize(sampleCount s, WaveClipCursor *pCursor) const
 {
+   if (pCursor)
+   {
+      const auto pEntry = pCursor->Locate(s);
+      if (pEntry && s >= pEntry->start)
+         return pEntry->pClip->GetSequence()->GetBestBlockSize(s - pEntry->start);
+      return GetMaxBlockSize();
+   }
+
    auto bestBlockSize = GetMaxBlockSize();
 
    for (const auto &clip : mClips)
@@ -1545,6 +1655,42 @@ size_t WaveTrack::GetIdealBlockSize()
    return NewestOrNewClip()->GetSequence()->GetIdealBlockSize();
 }
 
+auto WaveTrack::MakeFreezeFingerprint() const -> FreezeFingerprint
+{
+   FreezeFingerprint fingerprint;
+   for (auto channel : TrackList::Channels(this)) {
+      for (const auto &clip : channel->GetClips())
+         fingerprint.sources.push_back( {
+            clip.get(), clip->GetDirty(), clip->GetOffset(),
+            clip->GetEnvelope()->GetVersion()
+         } );
+   }
+   return fingerprint;
+}
+
+void WaveTrack::SetFrozenRender(const std::shared_ptr<TrackList> &render)
+{
+   mFrozenRender = render;
+   mFreezeFingerprint = MakeFreezeFingerprint();
+}
+
+void WaveTrack::ClearFrozenRender()
+{
+   mFrozenRender.reset();
+   mFreezeFingerprint = {};
+}
+
+std::shared_ptr<TrackList> WaveTrack::GetFrozenRender() const
+{
+   if (mFrozenRender && !(MakeFreezeFingerprint() == mFreezeFingerprint)) {
+      // Sources changed since the render was made; it no longer speaks
+      // for the track
+      mFrozenRender.reset();
+      mFreezeFingerprint = {};
+   }
+   return mFrozenRender;
+}
+
 void WaveTrack::Flush()
 // NOFAIL-GUARANTEE that the rightmost clip will be in a flushed state.
 // PARTIAL-GUARANTEE in case of exceptions:
@@ -1820,6 +1966,26 @@ std::pair<float, float> WaveTrack::GetMinMax(
    return results;
 }
 
+bool WaveTrack::GetSummaries256(sampleCount start, size_t len,
+   std::vector<SummaryFrame> &results) const
+{
+   for (const auto &clip: mClips)
+   {
+      const auto clipStart = clip->GetStartSample();
+      if (start >= clipStart && start + len <= clip->GetEndSample())
+      {
+         const auto originalSize = results.size();
+         if (!clip->GetSummaries256(start - clipStart, len, results))
+            return false;
+         // Make the frame positions relative to the track
+         for (auto i = originalSize; i < results.size(); ++i)
+            results[i].start += clipStart;
+         return true;
+      }
+   }
+   return false;
+}
+
 float WaveTrack::GetRMS(double t0, double t1, bool mayThrow) const
 {
    if (t0 > t1) {
@@ -1856,7 +2022,8 @@ float WaveTrack::GetRMS(double t0, double t1, bool mayThrow) const
 
 bool WaveTrack::Get(samplePtr buffer, sampleFormat format,
                     sampleCount start, size_t len, fillFormat fill,
-                    bool mayThrow, sampleCount * pNumCopied) const
+                    bool mayThrow, sampleCount * pNumCopied,
+                    WaveClipCursor *pCursor) const
 {
    // Simple optimization: When this buffer is completely contained within one clip,
    // don't clear anything (because we won't have to). Otherwise, just clear
@@ -1864,7 +2031,15 @@ bool WaveTrack::Get(samplePtr buffer, sampleFormat format,
    bool doClear = true;
    bool result = true;
    sampleCount samplesCopied = 0;
-   for (const auto &clip: mClips)
+   const WaveClipCursor::Entry *pFirst = nullptr;
+   if (pCursor)
+   {
+      // Constant time for sequential reads; no walk over the clip list
+      pFirst = pCursor->Locate(start);
+      doClear = !(pFirst &&
+         start >= pFirst->start && start + len <= pFirst->end);
+   }
+   else for (const auto &clip: mClips)
    {
       if (start >= clip->GetStartSample() && start+len <= clip->GetEndSample())
       {
@@ -1891,11 +2066,9 @@ bool WaveTrack::Get(samplePtr buffer, sampleFormat format,
       }
    }
 
-   for (const auto &clip: mClips)
+   const auto copyFromClip = [&](const WaveClip *clip,
+      sampleCount clipStart, sampleCount clipEnd)
    {
-      auto clipStart = clip->GetStartSample();
-      auto clipEnd = clip->GetEndSample();
-
       if (clipEnd > start && clipStart < start+len)
       {
          // Clip sample region and Get/Put sample region overlap
@@ -1929,12 +2102,41 @@ bool WaveTrack::Get(samplePtr buffer, sampleFormat format,
          else
             samplesCopied += samplesToCopy;
       }
+   };
+
+   if (pCursor)
+   {
+      // Only the clips overlapping the window are visited
+      for (auto pEntry = pFirst;
+           pEntry && pEntry->start < start + len;
+           pEntry = pCursor->Next(pEntry))
+         copyFromClip(pEntry->pClip.get(), pEntry->start, pEntry->end);
    }
+   else for (const auto &clip: mClips)
+      copyFromClip(clip.get(), clip->GetStartSample(), clip->GetEndSample());
+
    if( pNumCopied )
       *pNumCopied = samplesCopied;
    return result;
 }
 
+SequenceFloatView WaveTrack::GetFloatView(sampleCount start, size_t len,
+   WaveClipCursor *pCursor) const
+{
+   if (pCursor)
+   {
+      const auto pEntry = pCursor->Locate(start);
+      if (pEntry && start >= pEntry->start && start + len <= pEntry->end)
+         return pEntry->pClip->GetFloatView( start - pEntry->start, len );
+      return {};
+   }
+   for (const auto &clip: mClips)
+      if (start >= clip->GetStartSample() &&
+          start + len <= clip->GetEndSample())
+         return clip->GetFloatView( start - clip->GetStartSample(), len );
+   return {};
+}
+
 void WaveTrack::Set(samplePtr buffer, sampleFormat format,
                     sampleCount start, size_t len)
 // WEAK-GUARANTEE
@@ -2497,6 +2699,52 @@ WaveTrackCache::~WaveTrackCache()
 {
 }
 
+void WaveClipCursor::SetTrack(const WaveTrack *pTrack)
+{
+   mEntries.clear();
+   mCurrent = 0;
+   if (pTrack) {
+      const auto &clips = pTrack->GetClips();
+      mEntries.reserve(clips.size());
+      for (const auto &clip : clips)
+         mEntries.push_back(
+            { clip->GetStartSample(), clip->GetEndSample(), clip });
+      std::sort( mEntries.begin(), mEntries.end(),
+         []( const Entry &a, const Entry &b ){ return a.start < b.start; } );
+   }
+}
+
+const WaveClipCursor::Entry *WaveClipCursor::Locate(sampleCount sample)
+{
+   const auto size = mEntries.size();
+
+   // Is the remembered clip still the answer, or the one after it?
+   // Those are the sequential cases; anything else is a seek.
+   const auto isFirstEnding = [&]( size_t i ){
+      return i < size && mEntries[i].end > sample &&
+         (i == 0 || mEntries[i - 1].end <= sample);
+   };
+   if (!isFirstEnding(mCurrent)) {
+      if (isFirstEnding(mCurrent + 1))
+         ++mCurrent;
+      else {
+         // Seek to the first clip ending after the sample.  Clips do not
+         // overlap, so the ends are in start order too.
+         const auto it = std::upper_bound(
+            mEntries.begin(), mEntries.end(), sample,
+            []( sampleCount s, const Entry &e ){ return s < e.end; } );
+         mCurrent = it - mEntries.begin();
+      }
+   }
+   return mCurrent < size ? &mEntries[mCurrent] : nullptr;
+}
+
+const WaveClipCursor::Entry *WaveClipCursor::Next(const Entry *pEntry) const
+{
+   const size_t i = pEntry - mEntries.data();
+   return i + 1 < mEntries.size() ? &mEntries[i + 1] : nullptr;
+}
+
 void WaveTrackCache::SetTrack(const std::shared_ptr<const WaveTrack> &pTrack)
 {
    if (mPTrack != pTrack) {
@@ -2514,6 +2762,12 @@ void WaveTrackCache::SetTrack(const std::shared_ptr<const WaveTrack> &pTrack)
       mPTrack = pTrack;
       mNValidBuffers = 0;
    }
+   mClipCursor.SetTrack( pTrack.get() );
+}
+
+const float *WaveTrackCache::Buffer::samples() const
+{
+   return pView ? pView->Data() : data.get();
 }
 
 constSamplePtr WaveTrackCache::Get(sampleFormat format,
@@ -2545,7 +2799,7 @@ constSamplePtr WaveTrackCache::Get(sampleFormat format,
       }
       else if (mNValidBuffers > 0 &&
          start < mBuffers[0].start &&
-         0 <= mPTrack->GetBlockStart(start)) {
+         0 <= mPTrack->GetBlockStart(start, &mClipCursor)) {
          // Request is not a total miss but starts before the cache,
          // and there is a clip to fetch from.
          // Not the access pattern for drawing spectrogram or playback,
@@ -2563,14 +2817,21 @@ constSamplePtr WaveTrackCache::Get(sampleFormat format,
 
       // Refill buffers as needed
       if (fillFirst) {
-         const auto start0 = mPTrack->GetBlockStart(start);
+         const auto start0 = mPTrack->GetBlockStart(start, &mClipCursor);
          if (start0 >= 0) {
-            const auto len0 = mPTrack->GetBestBlockSize(start0);
+            const auto len0 = mPTrack->GetBestBlockSize(start0, &mClipCursor);
             wxASSERT(len0 <= mBufferSize);
-            if (!mPTrack->Get(
-                  samplePtr(mBuffers[0].data.get()), floatSample, start0, len0,
-                  fillZero, mayThrow))
-               return 0;
+            if (auto view = mPTrack->GetFloatView(start0, len0, &mClipCursor))
+               // Borrow the block's resident memory instead of copying
+               mBuffers[0].pView =
+                  std::make_shared<SequenceFloatView>( std::move( view ) );
+            else {
+               mBuffers[0].pView.reset();
+               if (!mPTrack->Get(
+                     samplePtr(mBuffers[0].data.get()), floatSample, start0, len0,
+                     fillZero, mayThrow, nullptr, &mClipCursor))
+                  return 0;
+            }
             mBuffers[0].start = start0;
             mBuffers[0].len = len0;
             if (!fillSecond &&
@@ -2591,12 +2852,18 @@ constSamplePtr WaveTrackCache::Get(sampleFormat format,
          mNValidBuffers = 1;
          const auto end0 = mBuffers[0].end();
          if (end > end0) {
-            const auto start1 = mPTrack->GetBlockStart(end0);
+            const auto start1 = mPTrack->GetBlockStart(end0, &mClipCursor);
             if (start1 == end0) {
-               const auto len1 = mPTrack->GetBestBlockSize(start1);
+               const auto len1 = mPTrack->GetBestBlockSize(start1, &mClipCursor);
                wxASSERT(len1 <= mBufferSize);
-               if (!mPTrack->Get(samplePtr(mBuffers[1].data.get()), floatSample, start1, len1, fillZero, mayThrow))
-                  return 0;
+               if (auto view = mPTrack->GetFloatView(start1, len1, &mClipCursor))
+                  mBuffers[1].pView =
+                     std::make_shared<SequenceFloatView>( std::move( view ) );
+               else {
+                  mBuffers[1].pView.reset();
+                  if (!mPTrack->Get(samplePtr(mBuffers[1].data.get()), floatSample, start1, len1, fillZero, mayThrow, nullptr, &mClipCursor))
+                     return 0;
+               }
                mBuffers[1].start = start1;
                mBuffers[1].len = len1;
                mNValidBuffers = 2;
@@ -2621,7 +2888,7 @@ constSamplePtr WaveTrackCache::Get(sampleFormat format,
          // initLen is not more than len:
          auto sinitLen = initLen.as_size_t();
          if (!mPTrack->Get(mOverlapBuffer.ptr(), format, start, sinitLen,
-                           fillZero, mayThrow))
+                           fillZero, mayThrow, nullptr, &mClipCursor))
             return 0;
          wxASSERT( sinitLen <= remaining );
          remaining -= sinitLen;
@@ -2643,7 +2910,7 @@ constSamplePtr WaveTrackCache::Get(sampleFormat format,
             // All is contiguous already.  We can completely avoid copying
             // leni is nonnegative, therefore start falls within mBuffers[ii],
             // so starti is bounded between 0 and buffer length
-            return samplePtr(mBuffers[ii].data.get() + starti.as_size_t() );
+            return constSamplePtr(mBuffers[ii].samples() + starti.as_size_t() );
          }
          else if (leni > 0) {
             // leni is nonnegative, therefore start falls within mBuffers[ii]
@@ -2655,7 +2922,7 @@ constSamplePtr WaveTrackCache::Get(sampleFormat format,
             // leni is positive and not more than remaining
             const size_t size = sizeof(float) * leni.as_size_t();
             // starti is less than mBuffers[ii].len and nonnegative
-            memcpy(buffer, mBuffers[ii].data.get() + starti.as_size_t(), size);
+            memcpy(buffer, mBuffers[ii].samples() + starti.as_size_t(), size);
             wxASSERT( leni <= remaining );
             remaining -= leni.as_size_t();
             start += leni;
@@ -2670,7 +2937,8 @@ constSamplePtr WaveTrackCache::Get(sampleFormat format,
             mOverlapBuffer.Resize(len, format);
             buffer = mOverlapBuffer.ptr();
          }
-         if (!mPTrack->Get(buffer, format, start, remaining, fillZero, mayThrow))
+         if (!mPTrack->Get(buffer, format, start, remaining, fillZero, mayThrow,
+                           nullptr, &mClipCursor))
             return 0;
       }
 
@@ -2679,7 +2947,8 @@ constSamplePtr WaveTrackCache::Get(sampleFormat format,
 
    // Cache works only for float format.
    mOverlapBuffer.Resize(len, format);
-   if (mPTrack->Get(mOverlapBuffer.ptr(), format, start, len, fillZero, mayThrow))
+   if (mPTrack->Get(mOverlapBuffer.ptr(), format, start, len, fillZero, mayThrow,
+                    nullptr, &mClipCursor))
       return mOverlapBuffer.ptr();
    else
       return 0;
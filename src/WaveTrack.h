@@ -13,6 +13,8 @@
 
 #include "Track.h"
 
+class SequenceFloatView;
+
 #include <vector>
 #include <wx/longlong.h>
 
@@ -25,7 +27,9 @@ class WaveformSettings;
 class TimeWarper;
 
 class Sequence;
+struct SummaryFrame;
 class WaveClip;
+class WaveClipCursor;
 
 // Array of pointers that assume ownership
 using WaveClipHolder = std::shared_ptr< WaveClip >;
@@ -97,6 +101,8 @@ private:
    ChannelType GetChannel() const override;
    virtual void SetPanFromChannelType() override;
 
+   bool IsSameAs(const Track &other) const override;
+
    /** @brief Get the time at which the first clip in the track starts
     *
     * @return time in seconds, or zero if there are no clips in the track
@@ -141,7 +147,8 @@ private:
    void SetWaveColorIndex(int colorIndex);
 
    sampleFormat GetSampleFormat() const { return mFormat; }
-   void ConvertToSampleFormat(sampleFormat format);
+   void ConvertToSampleFormat(sampleFormat format,
+                              ProgressDialog *progress = NULL);
 
    const SpectrogramSettings &GetSpectrogramSettings() const;
    SpectrogramSettings &GetSpectrogramSettings();
@@ -235,9 +242,19 @@ private:
    /// same value for "start" in both calls to "Set" and "Get" it is
    /// guaranteed that the same samples are affected.
    ///
+   /// A non-null pCursor skips the linear walk over the clip list; see
+   /// WaveClipCursor.
    bool Get(samplePtr buffer, sampleFormat format,
                    sampleCount start, size_t len,
-                   fillFormat fill = fillZero, bool mayThrow = true, sampleCount * pNumCopied = nullptr) const;
+                   fillFormat fill = fillZero, bool mayThrow = true,
+                   sampleCount * pNumCopied = nullptr,
+                   WaveClipCursor *pCursor = nullptr) const;
+
+   /// In-place read of float samples, possible only when the range lies
+   /// within one clip and one resident block; empty view otherwise.  See
+   /// Sequence::GetFloatView.
+   SequenceFloatView GetFloatView(sampleCount start, size_t len,
+                   WaveClipCursor *pCursor = nullptr) const;
    void Set(samplePtr buffer, sampleFormat format,
                    sampleCount start, size_t len);
 
@@ -252,6 +269,14 @@ private:
    // May assume precondition: t0 <= t1
    float GetRMS(double t0, double t1, bool mayThrow = true) const;
 
+   // Fetch min/max summary frames for a range of the track, bounding
+   // sample values without reading them.  Returns false, appending
+   // nothing, if the range is not entirely within one clip or a summary
+   // is unavailable; the caller must then read samples instead.  See
+   // Sequence::GetSummaries256.
+   bool GetSummaries256(sampleCount start, size_t len,
+      std::vector<SummaryFrame> &results) const;
+
    //
    // MM: We now have more than one sequence and envelope per track, so
    // instead of GetSequence() and GetEnvelope() we have the following
@@ -271,13 +296,31 @@ private:
    //
 
    // This returns a possibly large or negative value
-   sampleCount GetBlockStart(sampleCount t) const;
+   sampleCount GetBlockStart(sampleCount t,
+      WaveClipCursor *pCursor = nullptr) const;
 
    // These return a nonnegative number of samples meant to size a memory buffer
-   size_t GetBestBlockSize(sampleCount t) const;
+   size_t GetBestBlockSize(sampleCount t,
+      WaveClipCursor *pCursor = nullptr) const;
    size_t GetMaxBlockSize() const;
    size_t GetIdealBlockSize();
 
+   //
+   // Track freezing: a cached render of this channel group's audible
+   // content (clips and per-clip envelopes), substituted for the live
+   // channels at playback time.  All calls go to the leader of the group.
+   // See MixAndRenderTrackGroup in Mix.cpp.
+   //
+
+   // Install a render for the group led by this track, remembering a
+   // fingerprint of the source clips so that staleness can be detected
+   void SetFrozenRender(const std::shared_ptr<TrackList> &render);
+   void ClearFrozenRender();
+   bool IsFrozen() const { return mFrozenRender != nullptr; }
+   // Return the render if its sources are unchanged since SetFrozenRender,
+   // else drop it and return null
+   std::shared_ptr<TrackList> GetFrozenRender() const;
+
    //
    // XMLTagHandler callback methods for loading and saving
    //
@@ -585,6 +628,66 @@ private:
 
    std::unique_ptr<SpectrogramSettings> mpSpectrumSettings;
    std::unique_ptr<WaveformSettings> mpWaveformSettings;
+
+   // Identifies the clip contents a frozen render was computed from,
+   // over all channels of the group
+   struct FreezeFingerprint {
+      struct Source {
+         const WaveClip *pClip;
+         int dirty;
+         double offset;
+         size_t envVersion;
+
+         bool operator == (const Source &other) const
+         {
+            return pClip == other.pClip && dirty == other.dirty &&
+               offset == other.offset && envVersion == other.envVersion;
+         }
+      };
+      std::vector<Source> sources;
+
+      bool operator == (const FreezeFingerprint &other) const
+      { return sources == other.sources; }
+   };
+   FreezeFingerprint MakeFreezeFingerprint() const;
+
+   // Mutable so that the logically const GetFrozenRender can drop a
+   // render found to be stale
+   mutable std::shared_ptr<TrackList> mFrozenRender;
+   mutable FreezeFingerprint mFreezeFingerprint;
+};
+
+// Remembers the clip found by the last lookup, so that sequential reads
+// through a clip-heavy track advance in constant time instead of
+// searching the whole clip list for every chunk; a seek falls back to
+// binary search over a snapshot of the clips sorted by start sample.
+// Like WaveTrackCache, it is meant to be short-lived: the track's clips
+// must not change while the cursor is in use.
+class WaveClipCursor {
+public:
+   struct Entry {
+      sampleCount start;
+      sampleCount end;
+      // Shared, so an entry cannot dangle even if the track sheds the clip
+      std::shared_ptr<const WaveClip> pClip;
+   };
+
+   WaveClipCursor() {}
+   explicit WaveClipCursor(const WaveTrack &track) { SetTrack(&track); }
+
+   // Rebuilds the sorted index; pass null to empty the cursor
+   void SetTrack(const WaveTrack *pTrack);
+
+   // Returns the first clip (in time order) ending after the sample --
+   // the one containing it, or else the next one -- or null if none
+   const Entry *Locate(sampleCount sample);
+
+   // The clip following the given one in time order, or null
+   const Entry *Next(const Entry *pEntry) const;
+
+private:
+   std::vector<Entry> mEntries;
+   size_t mCurrent { 0 };
 };
 
 // This is meant to be a short-lived object, during whose lifetime,
@@ -624,16 +727,23 @@ private:
 
    struct Buffer {
       Floats data;
+      // When non-null, the buffer borrows block memory instead of owning a
+      // copy in data
+      std::shared_ptr<SequenceFloatView> pView;
       sampleCount start;
       sampleCount len;
 
       Buffer() : start(0), len(0) {}
-      void Free() { data.reset(); start = 0; len = 0; }
+      void Free() { data.reset(); pView.reset(); start = 0; len = 0; }
       sampleCount end() const { return start + len; }
 
+      // The samples, whether owned or borrowed
+      const float *samples() const;
+
       void swap ( Buffer &other )
       {
          data .swap ( other.data );
+         pView .swap ( other.pView );
          std::swap( start, other.start );
          std::swap( len, other.len );
       }
@@ -644,6 +754,8 @@ private:
    Buffer mBuffers[2];
    GrowableSampleBuffer mOverlapBuffer;
    int mNValidBuffers;
+   // Spares the track's clip-list walk on every fill
+   WaveClipCursor mClipCursor;
 };
 
 #endif // __AUDACITY_WAVETRACK__
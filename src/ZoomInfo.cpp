@@ -37,40 +37,6 @@ void ZoomInfo::UpdatePrefs()
    dBr = gPrefs->Read(ENV_DB_KEY, ENV_DB_RANGE);
 }
 
-/// Converts a position (mouse X coordinate) to
-/// project time, in seconds.  Needs the left edge of
-/// the track as an additional parameter.
-double ZoomInfo::PositionToTime(wxInt64 position,
-   wxInt64 origin
-   , bool // ignoreFisheye
-) const
-{
-   return h + (position - origin) / zoom;
-}
-
-
-/// STM: Converts a project time to screen x position.
-wxInt64 ZoomInfo::TimeToPosition(double projectTime,
-   wxInt64 origin
-   , bool // ignoreFisheye
-) const
-{
-   double t = 0.5 + zoom * (projectTime - h) + origin ;
-   if( t < wxINT64_MIN )
-      return wxINT64_MIN;
-   if( t > wxINT64_MAX )
-      return wxINT64_MAX;
-   t = floor( t );
-   return t;
-}
-
-// This always ignores the fisheye.  Use with caution!
-// You should prefer to call TimeToPosition twice, for endpoints, and take the difference!
-double ZoomInfo::TimeRangeToPixelWidth(double timeRange) const
-{
-   return timeRange * zoom;
-}
-
 bool ZoomInfo::ZoomInAvailable() const
 {
    return zoom < gMaxZoom;
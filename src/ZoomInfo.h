@@ -11,6 +11,8 @@
 #ifndef __AUDACITY_ZOOM_INFO__
 #define __AUDACITY_ZOOM_INFO__
 
+#include <cmath>
+
 #include "ClientData.h" // to inherit
 #include "Prefs.h" // to inherit
 
@@ -65,14 +67,21 @@ protected:
 public:
    float dBr;                   // decibel scale range
 
+   // These converters are called per pixel column, per track, per
+   // paint, so they are defined inline; a drawing loop then keeps h and
+   // zoom in registers instead of paying a function call per pixel.
+
    // do NOT use this once to convert a pixel width to a duration!
    // Instead, call twice to convert start and end times,
    // and take the difference.
    // origin specifies the pixel corresponding to time h
    double PositionToTime(wxInt64 position,
       wxInt64 origin = 0
-      , bool ignoreFisheye = false
-   ) const;
+      , bool /* ignoreFisheye */ = false
+   ) const
+   {
+      return h + (position - origin) / zoom;
+   }
 
    // do NOT use this once to convert a duration to a pixel width!
    // Instead, call twice to convert start and end positions,
@@ -80,12 +89,24 @@ public:
    // origin specifies the pixel corresponding to time h
    wxInt64 TimeToPosition(double time,
       wxInt64 origin = 0
-      , bool ignoreFisheye = false
-   ) const;
+      , bool /* ignoreFisheye */ = false
+   ) const
+   {
+      double t = 0.5 + zoom * (time - h) + origin ;
+      if( t < wxINT64_MIN )
+         return wxINT64_MIN;
+      if( t > wxINT64_MAX )
+         return wxINT64_MAX;
+      t = floor( t );
+      return t;
+   }
 
    // This always ignores the fisheye.  Use with caution!
    // You should prefer to call TimeToPosition twice, for endpoints, and take the difference!
-   double TimeRangeToPixelWidth(double timeRange) const;
+   double TimeRangeToPixelWidth(double timeRange) const
+   {
+      return timeRange * zoom;
+   }
 
    double OffsetTimeByPixels(double time, wxInt64 offset, bool ignoreFisheye = false) const
    {
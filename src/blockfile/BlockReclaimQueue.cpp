@@ -0,0 +1,159 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  BlockReclaimQueue.cpp
+
+*******************************************************************//**
+
+\class BlockReclaimQueue
+\brief Journaled queue of block file removals drained by a background
+thread.
+
+When an undo state expires, every block file it alone referenced is
+destroyed, and formerly each destructor unlinked its file on the spot;
+discarding the history of a two-hour recording froze the interface for
+the duration of tens of thousands of unlinks.  Now a destructor only
+appends the path to a journal file and to an in-memory queue, and a
+worker thread removes the files in batches.  The journal is truncated
+whenever the queue runs dry, so at any moment it lists exactly the
+removals not yet known to be complete; a session that ends early
+leaves them behind for ReplayLeftoverJournal() in the next one.
+
+*//*******************************************************************/
+
+#include "../Audacity.h"
+#include "BlockReclaimQueue.h"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include <wx/filefn.h>
+#include <wx/textfile.h>
+
+#include "../FileNames.h"
+
+namespace {
+
+// Files removed per trip through the lock; large enough that the
+// worker spends its time in the file system, not the queue
+const size_t kReclaimBatch = 256;
+
+}
+
+BlockReclaimQueue &BlockReclaimQueue::Get()
+{
+   static BlockReclaimQueue instance;
+   return instance;
+}
+
+wxString BlockReclaimQueue::JournalPath()
+{
+   return FileNames::DataDir() + wxFILE_SEP_PATH + wxT("pending-deletes.txt");
+}
+
+void BlockReclaimQueue::StartWorker()
+{
+   // Caller holds mMutex
+   if (mStarted)
+      return;
+   mStarted = true;
+   std::thread{ [this]{ WorkerLoop(); } }.detach();
+}
+
+void BlockReclaimQueue::Replay()
+{
+   // Caller holds mMutex
+   if (mReplayed)
+      return;
+   mReplayed = true;
+
+   wxTextFile journal{ JournalPath() };
+   if (!journal.Exists() || !journal.Open())
+      return;
+
+   for (size_t ii = 0, nn = journal.GetLineCount(); ii < nn; ++ii) {
+      const wxString line = journal.GetLine(ii);
+      // A line may name a file the crashed session already removed
+      if (!line.empty() && wxFileExists(line))
+         mQueue.push_back(line);
+   }
+   journal.Close();
+
+   if (!mQueue.empty()) {
+      StartWorker();
+      mNotEmpty.notify_one();
+   }
+}
+
+void BlockReclaimQueue::AppendToJournal(const wxString &path)
+{
+   // Caller holds mMutex.  The journal stays open across calls; one
+   // buffered append and flush per file is far cheaper than an unlink.
+   if (!mJournal.IsOpened())
+      mJournal.Open(JournalPath(), wxT("ab"));
+   if (mJournal.IsOpened()) {
+      mJournal.Write(path + wxT("\n"));
+      mJournal.Flush();
+   }
+}
+
+void BlockReclaimQueue::TruncateJournal()
+{
+   // Caller holds mMutex, and the queue is empty: every journaled
+   // removal has happened
+   if (mJournal.IsOpened())
+      mJournal.Close();
+   wxFFile empty{ JournalPath(), wxT("wb") };
+}
+
+void BlockReclaimQueue::ReplayLeftoverJournal()
+{
+   std::lock_guard<std::mutex> guard{ mMutex };
+   Replay();
+}
+
+void BlockReclaimQueue::Delete(const wxString &path)
+{
+   std::lock_guard<std::mutex> guard{ mMutex };
+   Replay();
+   StartWorker();
+   AppendToJournal(path);
+   mQueue.push_back(path);
+   mNotEmpty.notify_one();
+}
+
+void BlockReclaimQueue::Drain()
+{
+   std::unique_lock<std::mutex> lock{ mMutex };
+   mChanged.wait(lock, [this]{ return mQueue.empty() && mBusy == 0; });
+}
+
+void BlockReclaimQueue::WorkerLoop()
+{
+   for (;;) {
+      std::vector<wxString> batch;
+      {
+         std::unique_lock<std::mutex> lock{ mMutex };
+         mNotEmpty.wait(lock, [this]{ return !mQueue.empty(); });
+         const auto count = std::min(mQueue.size(), kReclaimBatch);
+         batch.assign(mQueue.begin(), mQueue.begin() + count);
+         mQueue.erase(mQueue.begin(), mQueue.begin() + count);
+         mBusy = batch.size();
+      }
+
+      for (const auto &path : batch)
+         if (wxFileExists(path))
+            // PRL: what should be done if this fails?
+            ::wxRemoveFile(path);
+
+      {
+         std::lock_guard<std::mutex> guard{ mMutex };
+         mBusy = 0;
+         if (mQueue.empty())
+            TruncateJournal();
+         mChanged.notify_all();
+      }
+   }
+}
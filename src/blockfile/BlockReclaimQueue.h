@@ -0,0 +1,67 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  BlockReclaimQueue.h
+
+**********************************************************************/
+
+#ifndef __AUDACITY_BLOCK_RECLAIM_QUEUE__
+#define __AUDACITY_BLOCK_RECLAIM_QUEUE__
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+#include <wx/ffile.h> // member variable
+#include <wx/string.h> // member variable
+
+/// \brief Journaled, batched removal of orphaned block files.
+///
+/// Destroying the undo history of a long recording used to unlink tens
+/// of thousands of .au files one at a time on the main thread.
+/// Instead, doomed paths are appended to a small on-disk journal and
+/// the files are removed in batches by a background thread; Delete()
+/// returns as soon as the path is journaled.  The journal makes the
+/// deletions crash-safe: entries left behind by an interrupted session
+/// are replayed when the next session starts.
+class BlockReclaimQueue {
+public:
+   static BlockReclaimQueue &Get();
+
+   /// Queue one file for removal; returns once the path is journaled
+   void Delete(const wxString &path);
+
+   /// Remove any files a previous session journaled but did not get to
+   /// delete.  Call early, before this session creates block files, so
+   /// a replayed entry cannot name a freshly assigned file.
+   void ReplayLeftoverJournal();
+
+   /// Wait until every queued removal has happened; call before
+   /// project directories are moved or copied wholesale
+   void Drain();
+
+private:
+   BlockReclaimQueue() = default;
+
+   // These require mMutex to be held already
+   void StartWorker();
+   void Replay();
+   void AppendToJournal(const wxString &path);
+   void TruncateJournal();
+
+   void WorkerLoop();
+
+   static wxString JournalPath();
+
+   std::mutex mMutex;
+   std::condition_variable mNotEmpty;  // the worker waits here
+   std::condition_variable mChanged;   // Drain waits here
+   std::deque<wxString> mQueue;
+   wxFFile mJournal;
+   size_t mBusy{ 0 };
+   bool mStarted{ false };
+   bool mReplayed{ false };
+};
+
+#endif
@@ -0,0 +1,132 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  BlockWriteQueue.cpp
+
+*******************************************************************//**
+
+\class BlockWriteQueue
+\brief Bounded queue of block file writes flushed by I/O threads.
+
+Newly appended blocks enter the queue with their sample and summary
+data; worker threads format and write the .au files while recording
+proceeds.  The block files keep a reference to their queued data and
+serve reads from it until the write lands, so nothing observes the
+window between block creation and the write.  When more than a fixed
+budget of bytes is waiting, Enqueue blocks the producer until the disk
+catches up.
+
+*//*******************************************************************/
+
+#include "../Audacity.h"
+#include "BlockWriteQueue.h"
+
+#include <algorithm>
+#include <thread>
+
+#include "SimpleBlockFile.h"
+
+namespace {
+
+// Enough to absorb several seconds of stalled disk at high recording
+// rates before backpressure reaches the producer
+const size_t kMaxPendingBytes = 64 * 1024 * 1024;
+
+// Two writers overlap one file's fsync latency with another's copy
+const unsigned kNumWorkers = 2;
+
+}
+
+BlockWriteQueue &BlockWriteQueue::Get()
+{
+   static BlockWriteQueue instance;
+   return instance;
+}
+
+size_t BlockWriteQueue::Bytes(const QueuedBlockWrite &write)
+{
+   return write.sampleLen * SAMPLE_SIZE(write.format) + write.summaryBytes;
+}
+
+void BlockWriteQueue::StartWorkers()
+{
+   // Caller holds mMutex
+   if (mStarted)
+      return;
+   mStarted = true;
+   for (unsigned i = 0; i < kNumWorkers; ++i)
+      std::thread{ [this]{ WorkerLoop(); } }.detach();
+}
+
+void BlockWriteQueue::Enqueue(const std::shared_ptr<QueuedBlockWrite> &write)
+{
+   std::unique_lock<std::mutex> lock{ mMutex };
+   StartWorkers();
+   mChanged.wait(lock, [this]{ return mPendingBytes < kMaxPendingBytes; });
+   mPendingBytes += Bytes(*write);
+   mQueue.push_back(write);
+   mNotEmpty.notify_one();
+}
+
+void BlockWriteQueue::Finish(const wxString &path, bool discard)
+{
+   std::unique_lock<std::mutex> lock{ mMutex };
+
+   if (discard) {
+      auto end = std::remove_if(mQueue.begin(), mQueue.end(),
+         [&](const std::shared_ptr<QueuedBlockWrite> &write)
+            { return write->path == path; });
+      for (auto iter = end; iter != mQueue.end(); ++iter)
+         mPendingBytes -= Bytes(**iter);
+      mQueue.erase(end, mQueue.end());
+      mChanged.notify_all();
+   }
+
+   auto pending = [&]{
+      for (const auto &write : mQueue)
+         if (write->path == path)
+            return true;
+      for (const auto &write : mBusy)
+         if (write->path == path)
+            return true;
+      return false;
+   };
+   mChanged.wait(lock, [&]{ return !pending(); });
+}
+
+void BlockWriteQueue::Drain()
+{
+   std::unique_lock<std::mutex> lock{ mMutex };
+   mChanged.wait(lock, [this]{ return mQueue.empty() && mBusy.empty(); });
+}
+
+void BlockWriteQueue::WorkerLoop()
+{
+   for (;;) {
+      std::shared_ptr<QueuedBlockWrite> write;
+      {
+         std::unique_lock<std::mutex> lock{ mMutex };
+         mNotEmpty.wait(lock, [this]{ return !mQueue.empty(); });
+         write = mQueue.front();
+         mQueue.pop_front();
+         mBusy.push_back(write);
+      }
+
+      const bool success = SimpleBlockFile::WriteAuFile(
+         write->path, write->format,
+         samplePtr(write->sampleData.get()), write->sampleLen,
+         write->summaryData.get(), write->summaryBytes);
+
+      {
+         std::unique_lock<std::mutex> lock{ mMutex };
+         mBusy.erase(std::find(mBusy.begin(), mBusy.end(), write));
+         mPendingBytes -= Bytes(*write);
+         // On failure, written stays false and the block keeps serving
+         // reads from the queued buffers, as the write cache would
+         if (success)
+            write->written.store(true);
+         mChanged.notify_all();
+      }
+   }
+}
@@ -0,0 +1,79 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  BlockWriteQueue.h
+
+**********************************************************************/
+
+#ifndef __AUDACITY_BLOCK_WRITE_QUEUE__
+#define __AUDACITY_BLOCK_WRITE_QUEUE__
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <wx/string.h> // member variable
+
+#include "../SampleFormat.h"
+
+/// One block's data awaiting its disk write.  The owning block file
+/// serves reads from these buffers until written becomes true.
+struct QueuedBlockWrite {
+   wxString path;
+   sampleFormat format;
+   ArrayOf<char> sampleData;
+   size_t sampleLen{ 0 };
+   ArrayOf<char> summaryData;
+   size_t summaryBytes{ 0 };
+   std::atomic<bool> written{ false };
+};
+
+/// \brief A write-behind stage for newly created block files.
+///
+/// Sequence::Append during recording used to block on the synchronous
+/// write of each finished block, so a slow disk or a virus scanner
+/// stall backed up into the capture drain.  Instead, finished blocks
+/// are queued here and written by a dedicated I/O thread, while reads
+/// are served from the queued buffers.  The total bytes pending are
+/// bounded; a producer that outruns the disk blocks in Enqueue, which
+/// is the backpressure that keeps memory use finite.
+class BlockWriteQueue {
+public:
+   static BlockWriteQueue &Get();
+
+   /// Queue a write.  May block while more than the budget of bytes is
+   /// pending.
+   void Enqueue(const std::shared_ptr<QueuedBlockWrite> &write);
+
+   /// Wait until any pending write of the given path lands.  With
+   /// discard, a write not yet begun is dropped instead, for blocks
+   /// destroyed without ever being saved.
+   void Finish(const wxString &path, bool discard);
+
+   /// Wait for every pending write; call before project files are
+   /// moved or copied wholesale.
+   void Drain();
+
+private:
+   BlockWriteQueue() = default;
+
+   void StartWorkers();
+   void WorkerLoop();
+
+   static size_t Bytes(const QueuedBlockWrite &write);
+
+   std::mutex mMutex;
+   std::condition_variable mNotEmpty;  // workers wait here
+   std::condition_variable mChanged;   // producers and finishers wait here
+   std::deque<std::shared_ptr<QueuedBlockWrite>> mQueue;
+   // Entries a worker is writing right now
+   std::vector<std::shared_ptr<QueuedBlockWrite>> mBusy;
+   size_t mPendingBytes{ 0 };
+   bool mStarted{ false };
+};
+
+#endif
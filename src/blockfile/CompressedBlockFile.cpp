@@ -0,0 +1,531 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  CompressedBlockFile.cpp
+
+*******************************************************************//**
+
+\class CompressedBlockFile
+\brief A BlockFile that stores its samples FLAC-compressed.
+
+The file layout matches SimpleBlockFile's except for the magic number
+and the data section: a native-endian header, the summary data, then a
+raw mono FLAC stream instead of PCM.  FLAC is lossless for integer
+samples, so only int16 and int24 blocks are stored this way.  Reads
+decode the whole block once and keep the decoded samples in a small
+least-recently-used cache shared by all compressed blocks, so the
+usual sequential access pattern of Sequence::Get costs one decode per
+block rather than one per fetch.
+
+*//*******************************************************************/
+
+#include "../Audacity.h" // for USE_* macros
+#include "CompressedBlockFile.h"
+
+#ifdef USE_LIBFLAC
+
+#include <algorithm>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include <wx/ffile.h>
+#include <wx/log.h>
+
+#include "FLAC++/decoder.h"
+#include "FLAC++/encoder.h"
+
+#include "SimpleBlockFile.h" // for auHeader and the AU encoding codes
+#include "../DirManager.h"
+#include "../FileException.h"
+#include "../Prefs.h"
+#include "../xml/XMLTagHandler.h"
+#include "../xml/XMLWriter.h"
+
+// Native-endian magic distinguishing our compressed container from the
+// .au files of SimpleBlockFile; the rest of the header is an auHeader
+#define COMPRESSED_MAGIC 0x2e666c63
+
+/// The decoded samples of one block, as read back from disk
+struct DecodedBlock {
+   sampleFormat format;
+   size_t len{ 0 };
+   ArrayOf<char> data;
+};
+
+namespace {
+
+// At the default maximum block size this bounds the cache at a few
+// dozen megabytes; enough that scrolling over a screenful of blocks
+// does not re-decode
+const size_t kMaxDecodedBlocks = 16;
+
+std::mutex sDecodedMutex;
+// Least recently used keys at the front
+std::list<const void*> sDecodedLru;
+std::map<const void*, std::shared_ptr<DecodedBlock>> sDecodedBlocks;
+
+std::shared_ptr<DecodedBlock> LookupDecoded(const void *key)
+{
+   std::lock_guard<std::mutex> guard{ sDecodedMutex };
+   auto iter = sDecodedBlocks.find(key);
+   if (iter == sDecodedBlocks.end())
+      return {};
+   // Freshen
+   sDecodedLru.remove(key);
+   sDecodedLru.push_back(key);
+   return iter->second;
+}
+
+void StoreDecoded(const void *key, const std::shared_ptr<DecodedBlock> &block)
+{
+   std::lock_guard<std::mutex> guard{ sDecodedMutex };
+   sDecodedBlocks[key] = block;
+   sDecodedLru.remove(key);
+   sDecodedLru.push_back(key);
+   while (sDecodedBlocks.size() > kMaxDecodedBlocks) {
+      sDecodedBlocks.erase(sDecodedLru.front());
+      sDecodedLru.pop_front();
+   }
+}
+
+void ForgetDecoded(const void *key)
+{
+   std::lock_guard<std::mutex> guard{ sDecodedMutex };
+   sDecodedBlocks.erase(key);
+   sDecodedLru.remove(key);
+}
+
+/// Encodes one block's samples, appending the FLAC stream to the
+/// already positioned file
+class BlockStreamEncoder final : public FLAC::Encoder::Stream {
+public:
+   explicit BlockStreamEncoder(wxFFile &file) : mFile{ file } {}
+
+protected:
+   FLAC__StreamEncoderWriteStatus write_callback(
+      const FLAC__byte buffer[], size_t bytes,
+      unsigned WXUNUSED(samples), unsigned WXUNUSED(currentFrame)) override
+   {
+      return mFile.Write(buffer, bytes) == bytes
+         ? FLAC__STREAM_ENCODER_WRITE_STATUS_OK
+         : FLAC__STREAM_ENCODER_WRITE_STATUS_FATAL_ERROR;
+   }
+
+private:
+   wxFFile &mFile;
+};
+
+/// Decodes one block's FLAC stream, narrowing into the destination
+/// block's sample format
+class BlockStreamDecoder final : public FLAC::Decoder::Stream {
+public:
+   BlockStreamDecoder(wxFFile &file, DecodedBlock &block)
+      : mFile{ file }, mBlock{ block } {}
+
+   bool Failed() const { return mFailed; }
+   size_t SamplesDecoded() const { return mPos; }
+
+protected:
+   FLAC__StreamDecoderReadStatus read_callback(
+      FLAC__byte buffer[], size_t *bytes) override
+   {
+      if (mFile.Eof()) {
+         *bytes = 0;
+         return FLAC__STREAM_DECODER_READ_STATUS_END_OF_STREAM;
+      }
+      auto read = mFile.Read(buffer, *bytes);
+      if (mFile.Error()) {
+         *bytes = 0;
+         return FLAC__STREAM_DECODER_READ_STATUS_ABORT;
+      }
+      *bytes = read;
+      return read ? FLAC__STREAM_DECODER_READ_STATUS_CONTINUE
+                  : FLAC__STREAM_DECODER_READ_STATUS_END_OF_STREAM;
+   }
+
+   FLAC__StreamDecoderWriteStatus write_callback(const FLAC__Frame *frame,
+      const FLAC__int32 * const buffer[]) override
+   {
+      const auto count =
+         std::min<size_t>(frame->header.blocksize, mBlock.len - mPos);
+      if (mBlock.format == int16Sample) {
+         auto out = (short *)mBlock.data.get() + mPos;
+         for (size_t ii = 0; ii < count; ++ii)
+            out[ii] = (short)buffer[0][ii];
+      }
+      else {
+         // 24 bit samples are padded to 32 bits in memory
+         auto out = (int *)mBlock.data.get() + mPos;
+         for (size_t ii = 0; ii < count; ++ii)
+            out[ii] = buffer[0][ii];
+      }
+      mPos += count;
+      return FLAC__STREAM_DECODER_WRITE_STATUS_CONTINUE;
+   }
+
+   void error_callback(FLAC__StreamDecoderErrorStatus) override
+   {
+      mFailed = true;
+   }
+
+private:
+   wxFFile &mFile;
+   DecodedBlock &mBlock;
+   size_t mPos{ 0 };
+   bool mFailed{ false };
+};
+
+}
+
+/// Constructs a CompressedBlockFile based on sample data and writes
+/// it to disk.
+///
+/// @param baseFileName The filename to use, but without an extension.
+///                     This constructor will add the appropriate
+///                     extension (.au in this case).
+/// @param sampleData   The sample data to be written to this block.
+/// @param sampleLen    The number of samples to be written to this block.
+/// @param format       The format of the given samples; must be an
+///                     integer format, since FLAC is lossless only then.
+CompressedBlockFile::CompressedBlockFile(wxFileNameWrapper &&baseFileName,
+                                         samplePtr sampleData,
+                                         size_t sampleLen,
+                                         sampleFormat format):
+   BlockFile {
+      (baseFileName.SetExt(wxT("au")), std::move(baseFileName)),
+      sampleLen
+   }
+{
+   wxASSERT(format != floatSample);
+   mFormat = format;
+
+   ArrayOf<char> cleanup;
+   void *summaryData = CalcSummary(sampleData, sampleLen, format, cleanup);
+
+   if (!WriteCompressedBlockFile(sampleData, sampleLen, format, summaryData))
+      throw FileException{
+         FileException::Cause::Write, GetFileName().name };
+}
+
+/// Construct a CompressedBlockFile memory structure that will point to
+/// an existing block file.  This file must exist and be a valid block
+/// file.
+///
+/// @param existingFile The disk file this CompressedBlockFile should use.
+CompressedBlockFile::CompressedBlockFile(wxFileNameWrapper &&existingFile,
+                                         size_t len,
+                                         float min, float max, float rms):
+   BlockFile{ std::move(existingFile), len }
+{
+   // The format is found from the header when the block is first decoded
+   mFormat = (sampleFormat) 0;
+
+   mMin = min;
+   mMax = max;
+   mRMS = rms;
+}
+
+CompressedBlockFile::~CompressedBlockFile()
+{
+   ForgetDecoded(this);
+}
+
+bool CompressedBlockFile::WriteCompressedBlockFile(samplePtr sampleData,
+                                                   size_t sampleLen,
+                                                   sampleFormat format,
+                                                   void *summaryData)
+{
+   wxFFile file(mFileName.GetFullPath(), wxT("wb"));
+   if( !file.IsOpened() ){
+      // Can't do anything else.
+      return false;
+   }
+
+   // Same layout as SimpleBlockFile's header, but with our own magic,
+   // so that nothing mistakes the compressed data section for PCM
+   auHeader header;
+   header.magic = COMPRESSED_MAGIC;
+   header.dataOffset = sizeof(auHeader) + mSummaryInfo.totalSummaryBytes;
+
+   // dataSize is optional, and we opt out
+   header.dataSize = 0xffffffff;
+   header.encoding = (format == int16Sample)
+      ? AU_SAMPLE_FORMAT_16 : AU_SAMPLE_FORMAT_24;
+   header.sampleRate = 44100;
+
+   // BlockFiles are always mono
+   header.channels = 1;
+
+   if (file.Write(&header, sizeof(header)) != sizeof(header))
+      return false;
+
+   if (file.Write(summaryData, mSummaryInfo.totalSummaryBytes) !=
+       mSummaryInfo.totalSummaryBytes)
+      return false;
+
+   // Widen to the 32-bit samples FLAC encodes from; 24 bit samples are
+   // already padded to 32 bits in memory
+   ArrayOf<FLAC__int32> widened{ sampleLen };
+   if (format == int16Sample) {
+      const short *in = (const short *)sampleData;
+      for (size_t ii = 0; ii < sampleLen; ++ii)
+         widened[ii] = in[ii];
+   }
+   else {
+      const int *in = (const int *)sampleData;
+      for (size_t ii = 0; ii < sampleLen; ++ii)
+         widened[ii] = in[ii];
+   }
+
+   BlockStreamEncoder encoder{ file };
+   encoder.set_channels(1);
+   encoder.set_sample_rate(44100);
+   encoder.set_bits_per_sample(format == int16Sample ? 16 : 24);
+   // A fast level; blocks are encoded on the editing path, and the
+   // bulk of the ratio comes from prediction, not from deep search
+   encoder.set_compression_level(2);
+
+   if (encoder.init() != FLAC__STREAM_ENCODER_INIT_STATUS_OK)
+      return false;
+
+   const FLAC__int32 *channel = widened.get();
+   bool success = encoder.process(&channel, sampleLen);
+   success = encoder.finish() && success;
+
+   return success;
+}
+
+/// Decode the whole block, or fetch it already decoded from the cache.
+/// Returns null on any failure.
+std::shared_ptr<DecodedBlock> CompressedBlockFile::GetDecodedBlock() const
+{
+   if (auto found = LookupDecoded(this))
+      return found;
+
+   wxFFile file(mFileName.GetFullPath(), wxT("rb"));
+   {
+      Maybe<wxLogNull> silence{};
+      if (mSilentLog)
+         silence.create();
+      if (!file.IsOpened())
+         return {};
+   }
+
+   auHeader header;
+   if (file.Read(&header, sizeof(header)) != sizeof(header) ||
+       header.magic != COMPRESSED_MAGIC)
+      return {};
+
+   auto block = std::make_shared<DecodedBlock>();
+   switch (header.encoding) {
+      case AU_SAMPLE_FORMAT_16:
+         block->format = int16Sample;
+         break;
+      case AU_SAMPLE_FORMAT_24:
+         block->format = int24Sample;
+         break;
+      default:
+         return {};
+   }
+   mFormat = block->format;
+   block->len = mLen;
+   block->data.reinit(mLen * SAMPLE_SIZE(block->format));
+
+   if (!file.Seek(header.dataOffset))
+      return {};
+
+   BlockStreamDecoder decoder{ file, *block };
+   if (decoder.init() != FLAC__STREAM_DECODER_INIT_STATUS_OK)
+      return {};
+   decoder.process_until_end_of_stream();
+   decoder.finish();
+   if (decoder.Failed() || decoder.SamplesDecoded() != mLen)
+      return {};
+
+   StoreDecoded(this, block);
+   return block;
+}
+
+/// Read the summary section of the disk file.
+///
+/// @param *data The buffer to write the data to.  It must be at least
+/// mSummaryinfo.totalSummaryBytes long.
+bool CompressedBlockFile::ReadSummary(ArrayOf<char> &data)
+{
+   data.reinit( mSummaryInfo.totalSummaryBytes );
+
+   wxFFile file(mFileName.GetFullPath(), wxT("rb"));
+
+   {
+      Maybe<wxLogNull> silence{};
+      if (mSilentLog)
+         silence.create();
+      if (!file.IsOpened()){
+         memset(data.get(), 0, mSummaryInfo.totalSummaryBytes);
+         mSilentLog = TRUE;
+         return false;
+      }
+   }
+   mSilentLog = FALSE;
+
+   // The offset is just past the header
+   if( !file.Seek(sizeof(auHeader)) ||
+       file.Read(data.get(), mSummaryInfo.totalSummaryBytes) !=
+          mSummaryInfo.totalSummaryBytes ) {
+      memset(data.get(), 0, mSummaryInfo.totalSummaryBytes);
+      return false;
+   }
+
+   FixSummary(data.get());
+
+   return true;
+}
+
+/// Read the data section of the disk file.  The whole block is decoded
+/// (or found already decoded in the cache) and the requested range is
+/// copied out.
+///
+/// @param data   The buffer to read the sample data into.
+/// @param format The format to convert the data into
+/// @param start  The offset within the block to begin reading
+/// @param len    The number of samples to read
+size_t CompressedBlockFile::ReadData(samplePtr data, sampleFormat format,
+                                     size_t start, size_t len,
+                                     bool mayThrow) const
+{
+   auto decoded = GetDecodedBlock();
+   if (!decoded) {
+      if (mayThrow)
+         throw FileException{ FileException::Cause::Read, mFileName };
+      ClearSamples(data, format, 0, len);
+      mSilentLog = TRUE;
+      return 0;
+   }
+   mSilentLog = FALSE;
+
+   auto avail = (start < decoded->len)
+      ? std::min(len, decoded->len - start) : 0;
+   CopySamples(
+      samplePtr(decoded->data.get() + start * SAMPLE_SIZE(decoded->format)),
+      decoded->format, data, format, avail);
+
+   if (avail < len) {
+      if (mayThrow)
+         throw FileException{ FileException::Cause::Read, mFileName };
+      ClearSamples(data, format, avail, len - avail);
+   }
+
+   return avail;
+}
+
+void CompressedBlockFile::SaveXML(XMLWriter &xmlFile)
+// may throw
+{
+   xmlFile.StartTag(wxT("compressedblockfile"));
+
+   xmlFile.WriteAttr(wxT("filename"), mFileName.GetFullName());
+   xmlFile.WriteAttr(wxT("len"), mLen);
+   xmlFile.WriteAttr(wxT("min"), mMin);
+   xmlFile.WriteAttr(wxT("max"), mMax);
+   xmlFile.WriteAttr(wxT("rms"), mRMS);
+
+   xmlFile.EndTag(wxT("compressedblockfile"));
+}
+
+// BuildFromXML methods should always return a BlockFile, not NULL,
+// even if the result is flawed (e.g., refers to nonexistent file),
+// as testing will be done in ProjectFSCK().
+/// static
+BlockFilePtr CompressedBlockFile::BuildFromXML(DirManager &dm, const wxChar **attrs)
+{
+   wxFileNameWrapper fileName;
+   float min = 0.0f, max = 0.0f, rms = 0.0f;
+   size_t len = 0;
+   double dblValue;
+   long nValue;
+
+   while(*attrs)
+   {
+      const wxChar *attr =  *attrs++;
+      const wxChar *value = *attrs++;
+      if (!value)
+         break;
+
+      const wxString strValue = value;
+      if (!wxStricmp(attr, wxT("filename")) &&
+            // Can't use XMLValueChecker::IsGoodFileName here, but do part of its test.
+            XMLValueChecker::IsGoodFileString(strValue) &&
+            (strValue.length() + 1 + dm.GetProjectDataDir().length() <= PLATFORM_MAX_PATH))
+      {
+         if (!dm.AssignFile(fileName, strValue, false))
+            // Make sure fileName is back to uninitialized state so we can detect problem later.
+            fileName.Clear();
+      }
+      else if (!wxStrcmp(attr, wxT("len")) &&
+               XMLValueChecker::IsGoodInt(strValue) && strValue.ToLong(&nValue) &&
+               nValue > 0)
+         len = nValue;
+      else if (XMLValueChecker::IsGoodString(strValue) && Internat::CompatibleToDouble(strValue, &dblValue))
+      {  // double parameters
+         if (!wxStricmp(attr, wxT("min")))
+            min = dblValue;
+         else if (!wxStricmp(attr, wxT("max")))
+            max = dblValue;
+         else if (!wxStricmp(attr, wxT("rms")) && (dblValue >= 0.0))
+            rms = dblValue;
+      }
+   }
+
+   return make_blockfile<CompressedBlockFile>
+      (std::move(fileName), len, min, max, rms);
+}
+
+/// Create a copy of this BlockFile, but using a different disk file.
+///
+/// @param newFileName The name of the NEW file to use.
+BlockFilePtr CompressedBlockFile::Copy(wxFileNameWrapper &&newFileName)
+{
+   auto newBlockFile = make_blockfile<CompressedBlockFile>
+      (std::move(newFileName), mLen, mMin, mMax, mRMS);
+
+   return newBlockFile;
+}
+
+auto CompressedBlockFile::GetSpaceUsage() const -> DiskByteCount
+{
+   wxFFile file(mFileName.GetFullPath(), wxT("rb"));
+   if (!file.IsOpened())
+      return 0;
+
+   return (DiskByteCount) file.Length();
+}
+
+void CompressedBlockFile::Recover()
+{
+   // Write a block of compressed silence, as SimpleBlockFile writes
+   // a block of PCM silence
+   ArrayOf<char> summary{ mSummaryInfo.totalSummaryBytes, true };
+   ArrayOf<char> samples{ mLen * SAMPLE_SIZE(int16Sample), true };
+
+   ForgetDecoded(this);
+   WriteCompressedBlockFile(samples.get(), mLen, int16Sample, summary.get());
+}
+
+bool CompressedBlockFile::GetCompressNewBlocks()
+{
+   bool compress = false;
+   gPrefs->Read(wxT("/Directories/CompressBlockFiles"), &compress);
+   return compress;
+}
+
+static DirManager::RegisteredBlockFileDeserializer sRegistration {
+   "compressedblockfile",
+   []( DirManager &dm, const wxChar **attrs ){
+      return CompressedBlockFile::BuildFromXML( dm, attrs );
+   }
+};
+
+#endif // USE_LIBFLAC
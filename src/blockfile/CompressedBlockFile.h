@@ -0,0 +1,77 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  CompressedBlockFile.h
+
+**********************************************************************/
+
+#ifndef __AUDACITY_COMPRESSED_BLOCKFILE__
+#define __AUDACITY_COMPRESSED_BLOCKFILE__
+
+#include "../Audacity.h" // for USE_* macros
+
+#ifdef USE_LIBFLAC
+
+#include "../BlockFile.h"
+
+class DirManager;
+struct DecodedBlock;
+
+/// A block file whose sample data is stored FLAC-compressed.
+///
+/// The disk layout is our own container, not a playable FLAC file: a
+/// fixed header, then the usual summary data, then the raw FLAC stream
+/// of the block's mono samples.  Compression is lossless, so only
+/// integer formats are stored this way; float blocks stay in
+/// SimpleBlockFile.  Reads decode the whole block once and keep the
+/// decoded samples in a small shared cache, so sequential access
+/// through Sequence::Get decodes each block one time.
+class CompressedBlockFile final : public BlockFile {
+ public:
+
+   // Constructor / Destructor
+
+   /// Create a disk file and write summary and compressed data to it
+   CompressedBlockFile(wxFileNameWrapper &&baseFileName,
+                       samplePtr sampleData, size_t sampleLen,
+                       sampleFormat format);
+   /// Create the memory structure to refer to the given block file
+   CompressedBlockFile(wxFileNameWrapper &&existingFile, size_t len,
+                       float min, float max, float rms);
+
+   virtual ~CompressedBlockFile();
+
+   // Reading
+
+   /// Read the summary section of the disk file
+   bool ReadSummary(ArrayOf<char> &data) override;
+   /// Read the data section of the disk file
+   size_t ReadData(samplePtr data, sampleFormat format,
+                        size_t start, size_t len, bool mayThrow) const override;
+
+   /// Create a NEW block file identical to this one
+   BlockFilePtr Copy(wxFileNameWrapper &&newFileName) override;
+   /// Write an XML representation of this file
+   void SaveXML(XMLWriter &xmlFile) override;
+
+   DiskByteCount GetSpaceUsage() const override;
+   void Recover() override;
+
+   static BlockFilePtr BuildFromXML(DirManager &dm, const wxChar **attrs);
+
+   /// True when the preference to compress new block files is on
+   static bool GetCompressNewBlocks();
+
+ private:
+
+   bool WriteCompressedBlockFile(samplePtr sampleData, size_t sampleLen,
+                                 sampleFormat format, void *summaryData);
+   std::shared_ptr<DecodedBlock> GetDecodedBlock() const;
+
+   mutable sampleFormat mFormat; // may be found lazily
+};
+
+#endif // USE_LIBFLAC
+
+#endif
@@ -0,0 +1,232 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  MappedBlockPool.cpp
+
+*******************************************************************//**
+
+\class MappedBlockPool
+\brief A bounded pool of memory-mapped block files with LRU unmapping.
+
+Mapping a block file once and serving all later reads from the mapping
+turns the per-read open/seek/read/close sequence of buffered I/O into
+plain memory accesses that the kernel satisfies from the page cache.
+The pool keeps the number of simultaneous mappings bounded so that
+projects with hundreds of thousands of blocks do not exhaust address
+space or file descriptors; eviction is least-recently-used, and files
+pinned by an outstanding Mapping are skipped until unpinned.
+
+*//*******************************************************************/
+
+#include "../Audacity.h"
+#include "MappedBlockPool.h"
+
+#ifdef __WXMSW__
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// At the default 1 MB maximum block size this is at most 256 MB of
+// mapped address space, none of it necessarily resident.
+const size_t kMaxMappedFiles = 256;
+
+}
+
+/// One mapped file.  Lives in the pool's table until forgotten or
+/// evicted; lives on, detached, while pins remain.
+struct MappedBlockEntry {
+   const char *address{ nullptr };
+   size_t length{ 0 };
+   unsigned pins{ 0 };
+   // True when removed from the pool's table but still pinned
+   bool detached{ false };
+   std::list<wxString>::iterator lruPosition;
+};
+
+namespace {
+
+MappedBlockEntry *MapWholeFile(const wxString &path)
+{
+#ifdef __WXMSW__
+   HANDLE file = CreateFileW(path.wc_str(), GENERIC_READ,
+      FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+      NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+   if (file == INVALID_HANDLE_VALUE)
+      return nullptr;
+
+   LARGE_INTEGER size;
+   if (!GetFileSizeEx(file, &size) || size.QuadPart <= 0 ||
+       (ULONGLONG)size.QuadPart > (ULONGLONG)(size_t)-1) {
+      CloseHandle(file);
+      return nullptr;
+   }
+
+   HANDLE section = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+   CloseHandle(file);
+   if (!section)
+      return nullptr;
+
+   void *address = MapViewOfFile(section, FILE_MAP_READ, 0, 0, 0);
+   // The view keeps the section alive
+   CloseHandle(section);
+   if (!address)
+      return nullptr;
+
+   auto entry = new MappedBlockEntry;
+   entry->address = static_cast<const char*>(address);
+   entry->length = (size_t)size.QuadPart;
+   return entry;
+#else
+   int fd = open(path.mb_str(), O_RDONLY);
+   if (fd < 0)
+      return nullptr;
+
+   struct stat status;
+   if (fstat(fd, &status) != 0 || status.st_size <= 0) {
+      close(fd);
+      return nullptr;
+   }
+
+   void *address =
+      mmap(nullptr, status.st_size, PROT_READ, MAP_SHARED, fd, 0);
+   // The mapping keeps the file referenced
+   close(fd);
+   if (address == MAP_FAILED)
+      return nullptr;
+
+   auto entry = new MappedBlockEntry;
+   entry->address = static_cast<const char*>(address);
+   entry->length = (size_t)status.st_size;
+   return entry;
+#endif
+}
+
+void UnmapWholeFile(MappedBlockEntry *entry)
+{
+#ifdef __WXMSW__
+   UnmapViewOfFile((void*)entry->address);
+#else
+   munmap((void*)entry->address, entry->length);
+#endif
+   delete entry;
+}
+
+}
+
+MappedBlockPool::Mapping::Mapping(Mapping &&other)
+   : mEntry{ other.mEntry }
+{
+   other.mEntry = nullptr;
+}
+
+auto MappedBlockPool::Mapping::operator=(Mapping &&other) -> Mapping &
+{
+   if (this != &other) {
+      Release();
+      mEntry = other.mEntry;
+      other.mEntry = nullptr;
+   }
+   return *this;
+}
+
+MappedBlockPool::Mapping::~Mapping()
+{
+   Release();
+}
+
+const char *MappedBlockPool::Mapping::Data() const
+{
+   return mEntry ? mEntry->address : nullptr;
+}
+
+size_t MappedBlockPool::Mapping::Length() const
+{
+   return mEntry ? mEntry->length : 0;
+}
+
+void MappedBlockPool::Mapping::Release()
+{
+   if (!mEntry)
+      return;
+   auto &pool = MappedBlockPool::Get();
+   std::lock_guard<std::mutex> guard{ pool.mMutex };
+   if (--mEntry->pins == 0 && mEntry->detached)
+      UnmapWholeFile(mEntry);
+   mEntry = nullptr;
+}
+
+MappedBlockPool &MappedBlockPool::Get()
+{
+   static MappedBlockPool instance;
+   return instance;
+}
+
+auto MappedBlockPool::Map(const wxString &path) -> Mapping
+{
+   std::lock_guard<std::mutex> guard{ mMutex };
+
+   auto iter = mEntries.find(path);
+   if (iter == mEntries.end()) {
+      auto entry = MapWholeFile(path);
+      if (!entry)
+         return {};
+      mLru.push_back(path);
+      entry->lruPosition = --mLru.end();
+      iter = mEntries.emplace(path,
+         std::unique_ptr<MappedBlockEntry>{ entry }).first;
+      Evict();
+   }
+   else
+      // Freshen
+      mLru.splice(mLru.end(), mLru, iter->second->lruPosition);
+
+   ++iter->second->pins;
+   return Mapping{ iter->second.get() };
+}
+
+void MappedBlockPool::Forget(const wxString &path)
+{
+   std::lock_guard<std::mutex> guard{ mMutex };
+   auto iter = mEntries.find(path);
+   if (iter != mEntries.end()) {
+      DestroyEntry(iter->second.release());
+      mEntries.erase(iter);
+   }
+}
+
+void MappedBlockPool::ForgetAll()
+{
+   std::lock_guard<std::mutex> guard{ mMutex };
+   for (auto &pair : mEntries)
+      DestroyEntry(pair.second.release());
+   mEntries.clear();
+}
+
+void MappedBlockPool::Evict()
+{
+   auto iter = mLru.begin();
+   while (mEntries.size() > kMaxMappedFiles && iter != mLru.end()) {
+      auto found = mEntries.find(*iter);
+      ++iter;
+      if (found != mEntries.end() && found->second->pins == 0) {
+         DestroyEntry(found->second.release());
+         mEntries.erase(found);
+      }
+   }
+}
+
+void MappedBlockPool::DestroyEntry(MappedBlockEntry *entry)
+{
+   mLru.erase(entry->lruPosition);
+   if (entry->pins == 0)
+      UnmapWholeFile(entry);
+   else
+      entry->detached = true;
+}
@@ -0,0 +1,83 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  MappedBlockPool.h
+
+**********************************************************************/
+
+#ifndef __AUDACITY_MAPPED_BLOCK_POOL__
+#define __AUDACITY_MAPPED_BLOCK_POOL__
+
+#include <cstddef>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include <wx/string.h> // member variable
+
+/// \brief A bounded, process-wide pool of memory-mapped block files.
+///
+/// Repeated reads of the same .au file during scrolling, effects and
+/// export become page-cache hits, with no read syscall or kernel copy
+/// per access.  The pool maps whole files on demand and keeps at most
+/// a fixed number of files mapped, unmapping the least recently used
+/// when the limit is exceeded.  A file pinned by an outstanding Mapping
+/// is never unmapped until the last pin is released.
+class MappedBlockPool {
+public:
+   /// A pinned view of one whole mapped file.  Movable, not copyable;
+   /// the destructor releases the pin.
+   class Mapping {
+   public:
+      Mapping() = default;
+      Mapping(Mapping &&other);
+      Mapping &operator=(Mapping &&other);
+      Mapping(const Mapping&) = delete;
+      Mapping &operator=(const Mapping&) = delete;
+      ~Mapping();
+
+      const char *Data() const;
+      size_t Length() const;
+      explicit operator bool() const { return mEntry != nullptr; }
+
+   private:
+      friend class MappedBlockPool;
+      explicit Mapping(struct MappedBlockEntry *entry) : mEntry{ entry } {}
+
+      void Release();
+
+      struct MappedBlockEntry *mEntry{ nullptr };
+   };
+
+   static MappedBlockPool &Get();
+
+   /// Map the whole file at the given path, or reuse and re-pin an
+   /// existing mapping.  Returns an empty Mapping on failure, and the
+   /// caller falls back to ordinary buffered reads.
+   Mapping Map(const wxString &path);
+
+   /// Drop any mapping of the given path.  Call before the file is
+   /// removed, renamed, or rewritten.  If the mapping is still pinned,
+   /// it is detached from the pool and unmapped when the last pin
+   /// goes away.
+   void Forget(const wxString &path);
+
+   /// As Forget, for every mapping in the pool.
+   void ForgetAll();
+
+private:
+   MappedBlockPool() = default;
+
+   // Caller holds mMutex for all of these
+   void Evict();
+   void DestroyEntry(MappedBlockEntry *entry);
+
+   std::mutex mMutex;
+   // Least recently used paths at the front
+   std::list<wxString> mLru;
+   std::map<wxString, std::unique_ptr<MappedBlockEntry>> mEntries;
+};
+
+#endif
@@ -66,13 +66,18 @@ to get its definition, rather than rolling our own.
 #include <wx/utils.h>
 #include <wx/log.h>
 
+#include "../Diags.h"
 #include "../DirManager.h"
 #include "../Prefs.h"
+#include "MappedBlockPool.h"
 
 #include "../FileFormats.h"
 
 #include "sndfile.h"
 
+// Running tally of what the block caches hold, for the memory section
+// of the diagnostics report
+static DiagMemTag sBlockCacheMemory{ wxT("SimpleBlockFile caches") };
 
 static wxUint32 SwapUintEndianess(wxUint32 in)
 {
@@ -86,6 +91,39 @@ static wxUint32 SwapUintEndianess(wxUint32 in)
   return out;
 }
 
+/// Interpret the header of a mapped .au file.  Succeeds only for files
+/// this program wrote on a machine of the same byte order, holding a
+/// sample format whose bytes on disk match the format in memory, so
+/// that samples may be served straight from the mapping.
+static bool ParseNativeAuHeader(const char *data, size_t length,
+                                sampleFormat &format, size_t &dataOffset)
+{
+   if (!data || length < sizeof(auHeader))
+      return false;
+
+   auHeader header;
+   memcpy(&header, data, sizeof(header));
+
+   // Written native-endian; a swapped magic means a foreign file
+   if (header.magic != 0x2e736e64)
+      return false;
+
+   switch (header.encoding) {
+      case AU_SAMPLE_FORMAT_16:
+         format = int16Sample;
+         break;
+      case AU_SAMPLE_FORMAT_FLOAT:
+         format = floatSample;
+         break;
+      default:
+         // 24 bit data are packed on disk, padded in memory
+         return false;
+   }
+
+   dataOffset = header.dataOffset;
+   return dataOffset >= sizeof(auHeader) && dataOffset <= length;
+}
+
 /// Constructs a SimpleBlockFile based on sample data and writes
 /// it to disk.
 ///
@@ -112,13 +150,37 @@ SimpleBlockFile::SimpleBlockFile(wxFileNameWrapper &&baseFileName,
 
    bool useCache = GetCache() && (!bypassCache);
 
-   if (!(allowDeferredWrite && useCache) && !bypassCache)
+   if (bypassCache)
    {
       bool bSuccess = WriteSimpleBlockFile(sampleData, sampleLen, format, NULL);
       if (!bSuccess)
          throw FileException{
             FileException::Cause::Write, GetFileName().name };
    }
+   else if (!(allowDeferredWrite && useCache))
+   {
+      // Write behind: compute the summary now (it also sets min, max and
+      // rms), copy the data aside, and let the queue land it on disk, so
+      // the recording-side append never blocks on the write
+      ArrayOf<char> cleanup;
+      void *summaryData = /*BlockFile::*/CalcSummary(sampleData, sampleLen,
+                                                format, cleanup);
+
+      auto write = std::make_shared<QueuedBlockWrite>();
+      write->path = mFileName.GetFullPath();
+      write->format = format;
+      const auto sampleDataSize = sampleLen * SAMPLE_SIZE(format);
+      write->sampleData.reinit(sampleDataSize);
+      memcpy(write->sampleData.get(), sampleData, sampleDataSize);
+      write->sampleLen = sampleLen;
+      write->summaryData.reinit(mSummaryInfo.totalSummaryBytes);
+      memcpy(write->summaryData.get(), summaryData,
+             mSummaryInfo.totalSummaryBytes);
+      write->summaryBytes = mSummaryInfo.totalSummaryBytes;
+
+      mPendingWrite = write;
+      BlockWriteQueue::Get().Enqueue(write);
+   }
 
    if (useCache) {
       //wxLogDebug("SimpleBlockFile::SimpleBlockFile(): Caching block file data.");
@@ -134,6 +196,7 @@ SimpleBlockFile::SimpleBlockFile(wxFileNameWrapper &&baseFileName,
       mCache.summaryData.reinit(mSummaryInfo.totalSummaryBytes);
       memcpy(mCache.summaryData.get(), summaryData,
              mSummaryInfo.totalSummaryBytes);
+      sBlockCacheMemory.Adjust( (long long)CacheByteCount() );
     }
 }
 
@@ -157,6 +220,12 @@ SimpleBlockFile::SimpleBlockFile(wxFileNameWrapper &&existingFile, size_t len,
 
 SimpleBlockFile::~SimpleBlockFile()
 {
+   if (mCache.active)
+      sBlockCacheMemory.Adjust( -(long long)CacheByteCount() );
+   if (mPendingWrite)
+      // A block never saved needs no file; otherwise wait for the write
+      BlockWriteQueue::Get().Finish(mFileName.GetFullPath(), !IsLocked());
+   MappedBlockPool::Get().Forget(mFileName.GetFullPath());
 }
 
 bool SimpleBlockFile::WriteSimpleBlockFile(
@@ -165,7 +234,27 @@ bool SimpleBlockFile::WriteSimpleBlockFile(
     sampleFormat format,
     void* summaryData)
 {
-   wxFFile file(mFileName.GetFullPath(), wxT("wb"));
+   DIAG_SCOPE( "Block file write" );
+
+   // Write the file
+   ArrayOf<char> cleanup;
+   if (!summaryData)
+      summaryData = /*BlockFile::*/CalcSummary(sampleData, sampleLen, format, cleanup);
+      //mchinen:allowing virtual override of calc summary for ODDecodeBlockFile.
+      // PRL: cleanup fixes a possible memory leak!
+
+   return WriteAuFile(mFileName.GetFullPath(), format, sampleData, sampleLen,
+      summaryData, mSummaryInfo.totalSummaryBytes);
+}
+
+bool SimpleBlockFile::WriteAuFile(const wxString &path, sampleFormat format,
+                                  samplePtr sampleData, size_t sampleLen,
+                                  const void *summaryData, size_t summaryBytes)
+{
+   // A stale mapping must not outlive the old contents
+   MappedBlockPool::Get().Forget(path);
+
+   wxFFile file(path, wxT("wb"));
    if( !file.IsOpened() ){
       // Can't do anything else.
       return false;
@@ -182,7 +271,7 @@ bool SimpleBlockFile::WriteSimpleBlockFile(
 
    // We store the summary data at the end of the header, so the data
    // offset is the length of the summary data plus the length of the header
-   header.dataOffset = sizeof(auHeader) + mSummaryInfo.totalSummaryBytes;
+   header.dataOffset = sizeof(auHeader) + summaryBytes;
 
    // dataSize is optional, and we opt out
    header.dataSize = 0xffffffff;
@@ -207,13 +296,6 @@ bool SimpleBlockFile::WriteSimpleBlockFile(
    // BlockFiles are always mono
    header.channels = 1;
 
-   // Write the file
-   ArrayOf<char> cleanup;
-   if (!summaryData)
-      summaryData = /*BlockFile::*/CalcSummary(sampleData, sampleLen, format, cleanup);
-      //mchinen:allowing virtual override of calc summary for ODDecodeBlockFile.
-      // PRL: cleanup fixes a possible memory leak!
-
    size_t nBytesToWrite = sizeof(header);
    size_t nBytesWritten = file.Write(&header, nBytesToWrite);
    if (nBytesWritten != nBytesToWrite)
@@ -222,7 +304,7 @@ bool SimpleBlockFile::WriteSimpleBlockFile(
       return false;
    }
 
-   nBytesToWrite = mSummaryInfo.totalSummaryBytes;
+   nBytesToWrite = summaryBytes;
    nBytesWritten = file.Write(summaryData, nBytesToWrite);
    if (nBytesWritten != nBytesToWrite)
    {
@@ -333,6 +415,7 @@ void SimpleBlockFile::FillCache()
    // Cache is active but already on disk
    mCache.active = true;
    mCache.needWrite = false;
+   sBlockCacheMemory.Adjust( (long long)CacheByteCount() );
 
    //wxLogDebug("SimpleBlockFile::FillCache(): Succesfully read simple block file into cache.");
 }
@@ -351,6 +434,19 @@ bool SimpleBlockFile::ReadSummary(ArrayOf<char> &data)
    }
    else
    {
+      std::shared_ptr<QueuedBlockWrite> pending;
+      {
+         ODLocker locker{ &mMapMutex };
+         if (mPendingWrite && mPendingWrite->written.load())
+            mPendingWrite.reset();
+         pending = mPendingWrite;
+      }
+      if (pending) {
+         memcpy(data.get(), pending->summaryData.get(),
+                mSummaryInfo.totalSummaryBytes);
+         return true;
+      }
+
       //wxLogDebug("SimpleBlockFile::ReadSummary(): Reading summary from disk.");
 
       wxFFile file(mFileName.GetFullPath(), wxT("rb"));
@@ -390,9 +486,62 @@ bool SimpleBlockFile::ReadSummary(ArrayOf<char> &data)
 /// @param format The format the data will be stored in
 /// @param start  The offset in this block file
 /// @param len    The number of samples to read
+const float *SimpleBlockFile::GetCachedFloats() const
+{
+   if (mCache.active && mCache.format == floatSample)
+      return reinterpret_cast<const float *>( mCache.sampleData.get() );
+
+   // Queued, not yet written float data, pinned by LockRead as the
+   // mapping below is
+   if (mReadLockedWrite && mReadLockedWrite->format == floatSample)
+      return reinterpret_cast<const float *>(
+         mReadLockedWrite->sampleData.get() );
+
+   // The mapping, when present, is pinned by LockRead, which callers of
+   // this function hold for the lifetime of their view
+   if (mMapping) {
+      sampleFormat storedFormat;
+      size_t dataOffset;
+      if (ParseNativeAuHeader(mMapping.Data(), mMapping.Length(),
+             storedFormat, dataOffset) &&
+          storedFormat == floatSample &&
+          (mMapping.Length() - dataOffset) / SAMPLE_SIZE(floatSample) >= mLen)
+         return reinterpret_cast<const float *>(
+            mMapping.Data() + dataOffset );
+   }
+
+   return nullptr;
+}
+
+/// Pin a mapping of the disk file, so that views of its samples stay
+/// valid until the matching UnlockRead
+void SimpleBlockFile::LockRead() const
+{
+   ODLocker locker{ &mMapMutex };
+   if (mMapPins++ == 0 && !mCache.active) {
+      if (mPendingWrite && mPendingWrite->written.load())
+         mPendingWrite.reset();
+      // Pin the queued data, or else a mapping of the written file
+      mReadLockedWrite = mPendingWrite;
+      if (!mReadLockedWrite)
+         mMapping = MappedBlockPool::Get().Map(mFileName.GetFullPath());
+   }
+}
+
+void SimpleBlockFile::UnlockRead() const
+{
+   ODLocker locker{ &mMapMutex };
+   if (--mMapPins == 0) {
+      mMapping = {};
+      mReadLockedWrite.reset();
+   }
+}
+
 size_t SimpleBlockFile::ReadData(samplePtr data, sampleFormat format,
                         size_t start, size_t len, bool mayThrow) const
 {
+   DIAG_SCOPE( "Block file read" );
+
    if (mCache.active)
    {
       //wxLogDebug("SimpleBlockFile::ReadData(): Data are already in cache.");
@@ -413,8 +562,60 @@ size_t SimpleBlockFile::ReadData(samplePtr data, sampleFormat format,
       return framesRead;
    }
    else
+   {
+      std::shared_ptr<QueuedBlockWrite> pending;
+      {
+         ODLocker locker{ &mMapMutex };
+         if (mPendingWrite && mPendingWrite->written.load())
+            // The write landed; release the memory and use the file
+            mPendingWrite.reset();
+         pending = mPendingWrite;
+      }
+      if (pending)
+      {
+         auto framesRead = std::min(len, std::max(start, mLen) - start);
+         CopySamples(
+            (samplePtr)(pending->sampleData.get() +
+               start * SAMPLE_SIZE(pending->format)),
+            pending->format, data, format, framesRead);
+
+         if ( framesRead < len ) {
+            if (mayThrow)
+               throw FileException{ FileException::Cause::Read, mFileName };
+            ClearSamples(data, format, framesRead, len - framesRead);
+         }
+
+         return framesRead;
+      }
+
+      if (auto mapping = MappedBlockPool::Get().Map(mFileName.GetFullPath()))
+      {
+         sampleFormat storedFormat;
+         size_t dataOffset;
+         if (ParseNativeAuHeader(mapping.Data(), mapping.Length(),
+                storedFormat, dataOffset))
+         {
+            auto avail = std::min<size_t>( mLen,
+               (mapping.Length() - dataOffset) / SAMPLE_SIZE(storedFormat) );
+            auto framesRead = std::min(len, std::max(start, avail) - start);
+            CopySamples(
+               (samplePtr)(mapping.Data() + dataOffset +
+                  start * SAMPLE_SIZE(storedFormat)),
+               storedFormat, data, format, framesRead);
+
+            if ( framesRead < len ) {
+               if (mayThrow)
+                  throw FileException{ FileException::Cause::Read, mFileName };
+               ClearSamples(data, format, framesRead, len - framesRead);
+            }
+
+            return framesRead;
+         }
+      }
+
       return CommonReadData( mayThrow,
          mFileName, mSilentLog, nullptr, 0, 0, data, format, start, len);
+   }
 }
 
 void SimpleBlockFile::SaveXML(XMLWriter &xmlFile)
@@ -549,6 +750,15 @@ auto SimpleBlockFile::GetSpaceUsage() const -> DiskByteCount
 }
 
 void SimpleBlockFile::Recover(){
+   if (mPendingWrite) {
+      // A queued write may still hold the real data; let it land
+      BlockWriteQueue::Get().Finish(mFileName.GetFullPath(), false);
+      const bool written = mPendingWrite->written.load();
+      mPendingWrite.reset();
+      if (written)
+         return;
+   }
+
    wxFFile file(mFileName.GetFullPath(), wxT("wb"));
 
    if( !file.IsOpened() ){
@@ -12,6 +12,9 @@
 #define __AUDACITY_SIMPLE_BLOCKFILE__
 
 #include "../BlockFile.h"
+#include "../ondemand/ODTaskThread.h"
+#include "BlockWriteQueue.h"
+#include "MappedBlockPool.h"
 
 class DirManager;
 
@@ -80,19 +83,48 @@ class PROFILE_DLL_API SimpleBlockFile /* not final */ : public BlockFile {
 
    bool GetNeedFillCache() override { return !mCache.active; }
 
+   const float *GetCachedFloats() const override;
+
+   /// Pin a memory mapping of the disk file while readers hold views
+   void LockRead() const override;
+   void UnlockRead() const override;
+
    void FillCache() /* noexcept */ override;
 
+   ///Format and write a whole .au file; shared by the synchronous path
+   ///and the write-behind queue's worker threads.
+   static bool WriteAuFile(const wxString &path, sampleFormat format,
+                           samplePtr sampleData, size_t sampleLen,
+                           const void *summaryData, size_t summaryBytes);
+
  protected:
 
    bool WriteSimpleBlockFile(samplePtr sampleData, size_t sampleLen,
                              sampleFormat format, void* summaryData);
    static bool GetCache();
    void ReadIntoCache();
+   /// What the active cache holds, for the memory tally
+   size_t CacheByteCount() const
+   { return mLen * SAMPLE_SIZE(mCache.format) +
+        mSummaryInfo.totalSummaryBytes; }
 
    SimpleBlockFileCache mCache;
 
  private:
    mutable sampleFormat mFormat; // may be found lazily
+
+   // Mapping of the whole .au file, held while read-locked
+   mutable MappedBlockPool::Mapping mMapping;
+   mutable int mMapPins{ 0 };
+   // Guards the mapping and the pending write references
+   mutable ODLock mMapMutex;
+
+   // Data awaiting the write-behind queue; reads are served from here
+   // until the write lands
+   mutable std::shared_ptr<QueuedBlockWrite> mPendingWrite;
+   // Extra reference held while read-locked, so borrowed views stay
+   // valid even if the write lands meanwhile
+   mutable std::shared_ptr<QueuedBlockWrite> mReadLockedWrite;
 };
 
 #endif
@@ -36,6 +36,13 @@ CommandBuilder::CommandBuilder(const wxString &cmdString)
    BuildCommand(cmdString);
 }
 
+CommandBuilder::CommandBuilder(const wxString &cmdString, long asyncId)
+   : mValid(false)
+{
+   mAsyncId = asyncId;
+   BuildCommand(cmdString);
+}
+
 CommandBuilder::CommandBuilder(const wxString &cmdName, const wxString &params)
    : mValid(false)
 {
@@ -82,11 +89,15 @@ void CommandBuilder::BuildCommand(const wxString &cmdName,
 {
    // Stage 1: create a Command object of the right type
 
-   auto scriptOutput = std::make_shared< ResponseQueueTarget >();
+   std::shared_ptr< CommandMessageTarget > scriptOutput;
+   if (mAsyncId >= 0)
+      scriptOutput = std::make_shared< AsyncResponseTarget >(mAsyncId);
+   else
+      scriptOutput = std::make_shared< ResponseQueueTarget >();
    auto output
       = std::make_unique<CommandOutputTargets>(std::make_unique<NullProgressTarget>(),
-                                scriptOutput,
-                                scriptOutput);
+                                std::shared_ptr< CommandMessageTarget >{ scriptOutput },
+                                std::shared_ptr< CommandMessageTarget >{ scriptOutput });
 
 #ifdef OLD_BATCH_SYSTEM
    OldStyleCommandType *factory = CommandDirectory::Get()->LookUp(cmdName);
@@ -191,8 +202,11 @@ void CommandBuilder::BuildCommand(const wxString &cmdStringArg)
    int splitAt = cmdString.Find(wxT(':'));
    if (splitAt < 0 && cmdString.Find(wxT(' ')) >= 0) {
       mError = wxT("Command is missing ':'");
-      ResponseQueueTarget::sResponseQueue().AddResponse(
-         Response{wxT("\n")});
+      // An asynchronous caller gets the error in the immediate reply and
+      // never waits on the response queue
+      if (mAsyncId < 0)
+         ResponseQueueTarget::sResponseQueue().AddResponse(
+            Response{wxT("\n")});
       mValid = false;
       return;
    }
@@ -31,6 +31,9 @@ class CommandBuilder
       bool mValid;
       OldStyleCommandPointer mCommand;
       wxString mError;
+      // When not negative, responses do not go to the script response
+      // queue but to the binary channel, tagged with this ID
+      long mAsyncId{ -1 };
 
       void Failure(const wxString &msg = {});
       void Success(const OldStyleCommandPointer &cmd);
@@ -38,6 +41,7 @@ class CommandBuilder
       void BuildCommand(const wxString &cmdString);
    public:
       CommandBuilder(const wxString &cmdString);
+      CommandBuilder(const wxString &cmdString, long asyncId);
       CommandBuilder(const wxString &cmdName,
                      const wxString &cmdParams);
       ~CommandBuilder();
@@ -24,6 +24,7 @@ capture the more lengthy output from some commands.
 #include "../Audacity.h"
 #include "CommandTargets.h"
 
+#include "ScriptCommandRelay.h"
 #include <wx/app.h>
 #include <wx/statusbr.h>
 #include <wx/string.h>
@@ -464,3 +465,15 @@ ResponseQueue &ResponseQueueTarget::sResponseQueue()
    static ResponseQueue queue;
    return queue;
 }
+
+AsyncResponseTarget::~AsyncResponseTarget()
+{
+   if( mBuffer.StartsWith("\n" ) )
+      mBuffer = mBuffer.Mid( 1 );
+   // The correlation ID comes first, on a line of its own, then whatever
+   // the command wrote
+   wxString tagged = wxString::Format( wxT("%ld\n"), mId ) + mBuffer;
+   const wxScopedCharBuffer utf8 = tagged.utf8_str();
+   ScriptCommandRelay::SendBinaryFrame(
+      ScriptCommandRelay::BinaryFrameAsyncResponse, utf8.data(), utf8.length() );
+}
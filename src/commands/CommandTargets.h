@@ -226,6 +226,7 @@ class ResponseQueueTarget final : public CommandMessageTarget
 {
 private:
    wxString mBuffer;
+   bool mLeading{ true };
 public:
    static ResponseQueue &sResponseQueue();
 
@@ -234,7 +235,7 @@ public:
    { }
    virtual ~ResponseQueueTarget()
    {
-      if( mBuffer.StartsWith("\n" ) )
+      if( mLeading && mBuffer.StartsWith("\n" ) )
          mBuffer = mBuffer.Mid( 1 );
       sResponseQueue().AddResponse( mBuffer  );
       sResponseQueue().AddResponse(wxString(wxT("\n")));
@@ -242,9 +243,40 @@ public:
    void Update(const wxString &message) override
    {
       mBuffer += message;
-#if 0
-         mResponseQueue.AddResponse(message);
-#endif
+      if( mLeading && mBuffer.StartsWith("\n") )
+         mBuffer = mBuffer.Mid( 1 );
+      if( !mBuffer.empty() )
+         mLeading = false;
+      // Stream complete lines to the script thread once the buffer grows
+      // past a bound, so that a big result is consumed while it is still
+      // being produced, instead of accumulating here in full.  The waiting
+      // script thread re-appends the newline that the split consumes.
+      if( mBuffer.length() > 4096 ){
+         const auto split = mBuffer.rfind( wxT('\n') );
+         if( split != wxString::npos ){
+            sResponseQueue().AddResponse( mBuffer.Left( split ) );
+            mBuffer = mBuffer.Mid( split + 1 );
+         }
+      }
+   }
+};
+
+/// Buffers messages from an asynchronously executed command and delivers
+/// them when the command finishes, as one frame on the binary scripting
+/// channel, tagged with the caller's correlation ID
+class AsyncResponseTarget final : public CommandMessageTarget
+{
+private:
+   long mId;
+   wxString mBuffer;
+public:
+   explicit AsyncResponseTarget(long id)
+      : mId(id), mBuffer( wxEmptyString )
+   { }
+   virtual ~AsyncResponseTarget();
+   void Update(const wxString &message) override
+   {
+      mBuffer += message;
    }
 };
 
@@ -23,6 +23,7 @@ threshold of difference in two selected tracks
 
 #include "../ViewInfo.h"
 #include "../WaveTrack.h"
+#include "../Sequence.h"
 
 
 #include <float.h>
@@ -126,20 +127,84 @@ bool CompareAudioCommand::Apply(const CommandContext & context)
    auto s1 = mTrack0->TimeToLongSamples(mT1);
    auto position = s0;
    auto length = s1 - s0;
+   std::vector<SummaryFrame> frames0;
+   std::vector<SummaryFrame> frames1;
    while (position < s1)
    {
-      // Get a block of data into the buffers
       auto block = limitSampleBufferSize(
          mTrack0->GetBestBlockSize(position), s1 - position
       );
-      mTrack0->Get((samplePtr)buff0.get(), floatSample, position, block);
-      mTrack1->Get((samplePtr)buff1.get(), floatSample, position, block);
 
-      for (decltype(block) buffPos = 0; buffPos < block; ++buffPos)
+      // Summary pruning:  the min/max summaries of the two tracks bound
+      // every possible difference within a frame.  A frame whose largest
+      // possible difference stays within the threshold counts no errors,
+      // and one whose smallest possible difference already exceeds it
+      // counts all of its samples; only the frames that may straddle the
+      // threshold have their samples read and compared.
+      frames0.clear();
+      frames1.clear();
+      if (mTrack0->GetSummaries256(position, block, frames0) &&
+          mTrack1->GetSummaries256(position, block, frames1))
       {
-         if (CompareSample(buff0[buffPos], buff1[buffPos]) > errorThreshold)
+         size_t j = 0;
+         for (const auto &frame : frames0)
          {
-            ++errorCount;
+            // The first and last frames may extend beyond the chunk
+            const auto lo = std::max(frame.start, position);
+            const auto hi =
+               std::min(frame.start + frame.len, position + block);
+            const auto count = (hi - lo).as_size_t();
+
+            // Merge the second track's bounds over this frame's span;
+            // its frame boundaries need not line up with the first's
+            while (j + 1 < frames1.size() &&
+                   frames1[j].start + frames1[j].len <= lo)
+               ++j;
+            float min1 = frames1[j].min;
+            float max1 = frames1[j].max;
+            for (auto k = j + 1;
+                 k < frames1.size() && frames1[k].start < hi; ++k)
+            {
+               min1 = std::min(min1, frames1[k].min);
+               max1 = std::max(max1, frames1[k].max);
+            }
+
+            const double maxDiff =
+               std::max((double)frame.max - min1, (double)max1 - frame.min);
+            const double minDiff = std::max(
+               std::max((double)frame.min - max1, (double)min1 - frame.max),
+               0.0);
+            if (maxDiff <= errorThreshold)
+               ; // no sample of this frame can exceed the threshold
+            else if (minDiff > errorThreshold)
+               errorCount += count; // every sample of this frame exceeds it
+            else
+            {
+               mTrack0->Get((samplePtr)buff0.get(), floatSample, lo, count);
+               mTrack1->Get((samplePtr)buff1.get(), floatSample, lo, count);
+               for (decltype(count) buffPos = 0; buffPos < count; ++buffPos)
+               {
+                  if (CompareSample(buff0[buffPos], buff1[buffPos]) > errorThreshold)
+                  {
+                     ++errorCount;
+                  }
+               }
+            }
+         }
+      }
+      else
+      {
+         // No summaries for this range; get a block of data into the
+         // buffers and compare sample by sample as before
+         mTrack0->Get((samplePtr)buff0.get(), floatSample, position, block);
+         mTrack1->Get((samplePtr)buff1.get(), floatSample, position, block);
+
+         for (decltype(block) buffPos = 0; buffPos < block; ++buffPos)
+         {
+            if (CompareSample(buff0[buffPos], buff1[buffPos]) > errorThreshold)
+            {
+               ++errorCount;
+            }
          }
       }
 
@@ -35,9 +35,12 @@ This class now lists
 #include "../WaveTrack.h"
 #include "../LabelTrack.h"
 #include "../Envelope.h"
+#include "../ondemand/ODManager.h"
+#include "../ondemand/ODWaveTrackTaskQueue.h"
 #include "CommandContext.h"
 
 #include "SelectCommand.h"
+#include "ScriptCommandRelay.h"
 #include "../ShuttleGui.h"
 #include "CommandContext.h"
 
@@ -60,6 +63,7 @@ enum {
    kEnvelopes,
    kLabels,
    kBoxes,
+   kSamples,
    nTypes
 };
 
@@ -74,6 +78,7 @@ static const EnumValueSymbol kTypes[nTypes] =
    { XO("Envelopes") },
    { XO("Labels") },
    { XO("Boxes") },
+   { XO("Samples") },
 };
 
 enum {
@@ -154,6 +159,7 @@ bool GetInfoCommand::ApplyInner(const CommandContext &context)
       case kEnvelopes    : return SendEnvelopes( context );
       case kLabels       : return SendLabels( context );
       case kBoxes        : return SendBoxes( context );
+      case kSamples      : return SendSamples( context );
       default:
          context.Status( "Command options not recognised" );
    }
@@ -512,6 +518,18 @@ bool GetInfoCommand::SendTracks(const CommandContext & context)
          context.AddBool( t->GetMute(), "mute");
          context.AddItem( vzmin, "VZoomMin");
          context.AddItem( vzmax, "VZoomMax");
+         // Progress of any pending on-demand work, so a script can tell
+         // a slow load (low blocks/sec) from a stalled one (large age).
+         ODQueueStats stats;
+         if( ODManager::IsInstanceCreated() &&
+             ODManager::Instance()->GetQueueStatsForWaveTrack( t, stats ) ) {
+            context.AddItem( stats.numTasks, "od_tasks");
+            context.AddBool( stats.frontRunning, "od_running");
+            context.AddItem( stats.frontPercentComplete, "od_percent");
+            context.AddItem( stats.unitsCompleted, "od_blocks_done");
+            context.AddItem( stats.unitsPerSecond, "od_blocks_per_sec");
+            context.AddItem( stats.secondsSinceWork, "od_age_sec");
+         }
       },
 #if defined(USE_MIDI)
       [&](const NoteTrack *) {
@@ -553,6 +571,60 @@ bool GetInfoCommand::SendClips(const CommandContext &context)
    return true;
 }
 
+bool GetInfoCommand::SendSamples(const CommandContext &context)
+{
+   // Raw audio is impractical to send as formatted text.  Each selected
+   // channel's samples in the selected time range go out on the binary
+   // scripting channel as one frame of 32 bit floats, and the status
+   // response describes the frames the client should expect.
+   if( !ScriptCommandRelay::IsBinaryChannelOpen() ){
+      context.Error(wxT("Samples need the binary channel.  Send 'Binary: On' first."));
+      return false;
+   }
+
+   auto &selectedRegion = ViewInfo::Get( context.project ).selectedRegion;
+   double t0 = selectedRegion.t0();
+   double t1 = selectedRegion.t1();
+   if( t0 >= t1 ){
+      context.Error(wxT("There is no selection!"));
+      return false;
+   }
+
+   auto &tracks = TrackList::Get( context.project );
+   int i=0;
+   context.StartArray();
+   for (auto waveTrack : tracks.Selected< const WaveTrack >()) {
+      const auto s0 = waveTrack->TimeToLongSamples(t0);
+      const auto s1 = waveTrack->TimeToLongSamples(t1);
+      const auto length = s1 - s0;
+      context.StartStruct();
+      context.AddItem( (double)i, "channel" );
+      context.AddItem( waveTrack->GetRate(), "rate" );
+      context.AddItem( s0.as_double(), "start" );
+      context.AddItem( length.as_double(), "samples" );
+      context.EndStruct();
+
+      // The payload is streamed block by block, straight from the track
+      // reading buffer, so the selection need not fit in memory.
+      ScriptCommandRelay::BeginBinaryFrame(
+         ScriptCommandRelay::BinaryFrameAudio,
+         length.as_long_long() * sizeof(float) );
+      Floats buffer{ waveTrack->GetMaxBlockSize() };
+      auto position = s0;
+      while (position < s1) {
+         auto block = limitSampleBufferSize(
+            waveTrack->GetBestBlockSize(position), s1 - position );
+         waveTrack->Get( (samplePtr)buffer.get(), floatSample, position, block );
+         ScriptCommandRelay::SendBinaryData( buffer.get(), block * sizeof(float) );
+         position += block;
+      }
+      i++;
+   }
+   context.EndArray();
+
+   return true;
+}
+
 bool GetInfoCommand::SendEnvelopes(const CommandContext &context)
 {
    auto &tracks = TrackList::Get( context.project );
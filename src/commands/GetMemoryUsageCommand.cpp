@@ -0,0 +1,36 @@
+/**********************************************************************
+
+   Audacity - A Digital Audio Editor
+   Copyright 1999-2018 Audacity Team
+   License: wxwidgets
+
+   James Crook
+
+******************************************************************//**
+
+\file GetMemoryUsageCommand.cpp
+\brief Definitions for GetMemoryUsageCommand class.
+
+*//*******************************************************************/
+
+#include "../Audacity.h"
+#include "GetMemoryUsageCommand.h"
+
+#include "../Diags.h"
+#include "CommandContext.h"
+
+bool GetMemoryUsageCommand::Apply(const CommandContext &context)
+{
+   context.StartArray();
+   Diags::VisitMemory(
+      [&]( const wchar_t *tag, long long bytes, long long peakBytes ){
+         context.StartStruct();
+         context.AddItem( wxString{ tag }, "tag" );
+         context.AddItem( (double)bytes, "bytes" );
+         context.AddItem( (double)peakBytes, "peak_bytes" );
+         context.EndStruct();
+      } );
+   context.EndArray();
+
+   return true;
+}
@@ -0,0 +1,42 @@
+/**********************************************************************
+
+   Audacity - A Digital Audio Editor
+   Copyright 1999-2018 Audacity Team
+   License: wxwidgets
+
+   James Crook
+
+******************************************************************//**
+
+\file GetMemoryUsageCommand.h
+\brief Contains declaration of GetMemoryUsageCommand class.
+
+\class GetMemoryUsageCommand
+\brief Command which reports the per-subsystem memory tallies -- wave
+and spectrogram display caches, block write caches, undo history -- so
+a bloated session can be attributed from a script.
+
+*//*******************************************************************/
+
+#ifndef __GET_MEMORY_USAGE_COMMAND__
+#define __GET_MEMORY_USAGE_COMMAND__
+
+#include "Command.h"
+#include "CommandType.h"
+
+#define GET_MEMORY_USAGE_PLUGIN_SYMBOL \
+   ComponentInterfaceSymbol{ XO("Get Memory Usage") }
+
+class GetMemoryUsageCommand : public AudacityCommand
+{
+public:
+   // ComponentInterface overrides
+   ComponentInterfaceSymbol GetSymbol() override {return GET_MEMORY_USAGE_PLUGIN_SYMBOL;};
+   wxString GetDescription() override {return _("Gets per-subsystem memory tallies in JSON format.");};
+
+   // AudacityCommand overrides
+   wxString ManualPage() override {return wxT("Extra_Menu:_Scriptables_II#get_memory_usage");};
+   bool Apply(const CommandContext &context) override;
+};
+
+#endif /* End of include guard: __GET_MEMORY_USAGE_COMMAND__ */
@@ -0,0 +1,41 @@
+/**********************************************************************
+
+   Audacity - A Digital Audio Editor
+   Copyright 1999-2018 Audacity Team
+   License: wxwidgets
+
+   James Crook
+
+******************************************************************//**
+
+\file GetTelemetryCommand.cpp
+\brief Definitions for GetTelemetryCommand class.
+
+*//*******************************************************************/
+
+#include "../Audacity.h"
+#include "GetTelemetryCommand.h"
+
+#include "../AudioIO.h"
+#include "CommandContext.h"
+
+bool GetTelemetryCommand::Apply(const CommandContext &context)
+{
+   auto gAudioIO = AudioIO::Get();
+   const auto telemetry = gAudioIO->GetTelemetry();
+
+   // The counters describe the running stream, or else the last one
+   context.StartStruct();
+   context.AddItem( telemetry.streamSeconds, "stream_seconds" );
+   context.AddItem( telemetry.latencyMs, "latency_ms" );
+   context.AddItem( (double)telemetry.xruns, "xruns" );
+   context.AddItem( (double)telemetry.playbackLowWaterFrames,
+      "playback_low_water_frames" );
+   context.AddItem( (double)telemetry.fillDeadlineMisses,
+      "fill_deadline_misses" );
+   context.AddItem( telemetry.maxFillMs, "max_fill_ms" );
+   context.AddItem( telemetry.worstFillTrackIoMs, "worst_fill_io_ms" );
+   context.EndStruct();
+
+   return true;
+}
@@ -0,0 +1,43 @@
+/**********************************************************************
+
+   Audacity - A Digital Audio Editor
+   Copyright 1999-2018 Audacity Team
+   License: wxwidgets
+
+   James Crook
+
+******************************************************************//**
+
+\file GetTelemetryCommand.h
+\brief Contains declaration of GetTelemetryCommand class.
+
+\class GetTelemetryCommand
+\brief Command which reports the audio stream health counters -- xruns,
+buffer low-water mark, fill deadline misses and worst-case fill timing
+-- so a glitchy machine can be diagnosed from a script instead of by
+ear.
+
+*//*******************************************************************/
+
+#ifndef __GET_TELEMETRY_COMMAND__
+#define __GET_TELEMETRY_COMMAND__
+
+#include "Command.h"
+#include "CommandType.h"
+
+#define GET_TELEMETRY_PLUGIN_SYMBOL \
+   ComponentInterfaceSymbol{ XO("Get Telemetry") }
+
+class GetTelemetryCommand : public AudacityCommand
+{
+public:
+   // ComponentInterface overrides
+   ComponentInterfaceSymbol GetSymbol() override {return GET_TELEMETRY_PLUGIN_SYMBOL;};
+   wxString GetDescription() override {return _("Gets audio stream health counters in JSON format.");};
+
+   // AudacityCommand overrides
+   wxString ManualPage() override {return wxT("Extra_Menu:_Scriptables_II#get_telemetry");};
+   bool Apply(const CommandContext &context) override;
+};
+
+#endif /* End of include guard: __GET_TELEMETRY_COMMAND__ */
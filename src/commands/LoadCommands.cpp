@@ -26,6 +26,8 @@ modelled on BuiltinEffectsModule
 #include "../commands/SelectCommand.h"
 #include "../commands/PreferenceCommands.h"
 #include "../commands/GetInfoCommand.h"
+#include "../commands/GetMemoryUsageCommand.h"
+#include "../commands/GetTelemetryCommand.h"
 #include "../commands/HelpCommand.h"
 #include "../commands/ImportExportCommands.h"
 #include "../commands/OpenSaveCommands.h"
@@ -34,6 +36,7 @@ modelled on BuiltinEffectsModule
 #include "../commands/SetClipCommand.h"
 #include "../commands/SetProjectCommand.h"
 #include "../commands/DragCommand.h"
+#include "../Benchmark.h"
 
 //
 // Define the list of COMMANDs that will be autoregistered and how to instantiate each
@@ -59,11 +62,15 @@ modelled on BuiltinEffectsModule
    COMMAND( GET_PREFERENCE,      GetPreferenceCommand, () )    \
    COMMAND( SET_PREFERENCE,      SetPreferenceCommand, () )    \
    COMMAND( GET_INFO,            GetInfoCommand, () )          \
+   COMMAND( GET_MEMORY_USAGE,    GetMemoryUsageCommand, () )   \
+   COMMAND( GET_TELEMETRY,       GetTelemetryCommand, () )     \
    COMMAND( HELP,                HelpCommand, () )             \
    COMMAND( IMPORT,              ImportCommand, () )           \
    COMMAND( EXPORT,              ExportCommand, () )           \
    COMMAND( OPEN_PROJECT,        OpenProjectCommand, () )      \
    COMMAND( SAVE_PROJECT,        SaveProjectCommand, () )      \
+   COMMAND( BENCHMARK_SUITE,     BenchmarkCommand, () )        \
+   COMMAND( RENDER_BENCHMARK,    RenderBenchmarkCommand, () )  \
 
    // GET_TRACK_INFO subsumed by GET_INFO
    //COMMAND( GET_TRACK_INFO,    GetTrackInfoCommand, () )   
@@ -28,6 +28,18 @@ code out of ModuleManager.
 #include <wx/window.h>
 #include <wx/string.h>
 
+#include <mutex>
+
+#if defined(WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <stdio.h>
+#include <unistd.h>
+#endif
+
 // Declare static class members
 CommandHandler *ScriptCommandRelay::sCmdHandler;
 tpRegScriptServerFunc ScriptCommandRelay::sScriptFn;
@@ -69,6 +81,55 @@ void ScriptCommandRelay::PostCommand(
 /// the GUI at a time causes problems with wxwidgets.
 int ExecCommand(wxString *pIn, wxString *pOut)
 {
+   // Asynchronous execution: "Async: <id> <command>" queues the command and
+   // returns at once, instead of holding this thread until the command has
+   // run.  The response arrives later as a frame on the binary channel,
+   // tagged with the caller's correlation ID, so a controller can keep many
+   // commands in flight rather than paying a full round trip for each.
+   if (pIn->StartsWith(wxT("Async:")))
+   {
+      wxString rest = pIn->Mid(6);
+      rest.Trim(true).Trim(false);
+      long id = -1;
+      wxString idText = rest.BeforeFirst(wxT(' '));
+      wxString command = rest.AfterFirst(wxT(' '));
+      if (!ScriptCommandRelay::IsBinaryChannelOpen())
+         *pOut = wxT("Async responses need the binary channel.  Send 'Binary: On' first.\n");
+      else if (!idText.ToLong(&id) || id < 0 || command.empty())
+         *pOut = wxT("Syntax error!\nExpected 'Async: <id> <command>'\n");
+      else
+      {
+         CommandBuilder builder(command, id);
+         if (builder.WasValid())
+         {
+            OldStyleCommandPointer cmd = builder.GetCommand();
+            ScriptCommandRelay::PostCommand(wxTheApp->GetTopWindow(), cmd);
+            *pOut = wxString::Format(wxT("Queued: %ld\n"), id);
+         }
+         else
+            *pOut = wxT("Syntax error!\n") + builder.GetErrorMessage() + wxT("\n");
+      }
+      return 0;
+   }
+
+   // The binary sidecar channel is negotiated here on the text pipe, rather
+   // than being routed to the command system.  See the comments further down.
+   if (pIn->StartsWith(wxT("Binary:")))
+   {
+      wxString args = pIn->Mid(7);
+      args.Trim(true).Trim(false);
+      if (args == wxT("On"))
+         ScriptCommandRelay::OpenBinaryChannel(*pOut);
+      else if (args == wxT("Off"))
+      {
+         ScriptCommandRelay::CloseBinaryChannel();
+         *pOut = wxT("Binary: Off\n");
+      }
+      else
+         *pOut = wxT("Syntax error!\nExpected 'Binary: On' or 'Binary: Off'\n");
+      return 0;
+   }
+
    {
       CommandBuilder builder(*pIn);
       if (builder.WasValid())
@@ -95,6 +156,18 @@ int ExecCommand(wxString *pIn, wxString *pOut)
       msg = ScriptCommandRelay::ReceiveResponse().GetMessage();
    }
 
+   // A long response goes faster as one length-prefixed frame than as
+   // thousands of little text lines, each formatted and parsed; the client
+   // asked for that by switching binary mode on.
+   if (pOut->Length() > 4096 && ScriptCommandRelay::IsBinaryChannelOpen())
+   {
+      const wxScopedCharBuffer utf8 = pOut->utf8_str();
+      if (ScriptCommandRelay::SendBinaryFrame(
+            ScriptCommandRelay::BinaryFrameText, utf8.data(), utf8.length()))
+         *pOut = wxString::Format(wxT("Binary: %llu bytes\n"),
+            (unsigned long long) utf8.length());
+   }
+
    return 0;
 }
 
@@ -166,3 +239,181 @@ Response ScriptCommandRelay::ReceiveResponse()
 {
    return ResponseQueueTarget::sResponseQueue().WaitAndGetResponse();
 }
+
+// The binary sidecar channel.
+//
+// The pipe served by mod-script-pipe is line-oriented text, which is a poor
+// fit for audio data and for very long GetInfo results.  A script that wants
+// those in bulk sends "Binary: On" over the text pipe; we then create a
+// second, one-way pipe and report its name in the text response.  Everything
+// on that pipe is a frame: a fixed little-endian header of magic, type and
+// payload length, then the payload - raw 32 bit floats for audio, UTF-8 text
+// (usually JSON) for structures.
+//
+// Frames may be written while a command is still executing, before its text
+// response arrives, and a frame can be bigger than the operating system's
+// pipe buffer.  The client must therefore drain this pipe on its own thread
+// whenever binary mode is on, rather than only after reading the text
+// response.  Commands are serviced one at a time, so frames from different
+// commands never interleave.
+
+namespace {
+
+std::mutex sBinaryMutex;
+bool sBinaryRequested = false;
+bool sBinaryConnected = false;
+
+#if defined(WIN32)
+HANDLE sBinaryPipe = INVALID_HANDLE_VALUE;
+const wxChar binaryPipeName[] = wxT("\\\\.\\pipe\\FromSrvBinaryPipe");
+#else
+FILE *sBinaryPipe = NULL;
+wxString sBinaryPipePath;
+#endif
+
+const unsigned int binaryFrameMagic = 0x42445541; // "AUDB" on the wire
+
+struct BinaryFrameHeader {
+   unsigned int magic;
+   unsigned int type;
+   unsigned long long length; // payload size in bytes
+};
+
+// Attach to the client, which learned the pipe's name from the "Binary: On"
+// response and should have opened its reading end by now.  Blocks until it
+// does.  Called with the mutex held.
+bool ConnectBinaryPipe()
+{
+   if (sBinaryConnected)
+      return true;
+#if defined(WIN32)
+   if (!ConnectNamedPipe(sBinaryPipe, NULL) &&
+       GetLastError() != ERROR_PIPE_CONNECTED)
+      return false;
+#else
+   sBinaryPipe = fopen(sBinaryPipePath.mb_str(), "wb");
+   if (sBinaryPipe == NULL)
+      return false;
+#endif
+   sBinaryConnected = true;
+   return true;
+}
+
+// Write raw bytes to the connected pipe.  Called with the mutex held.
+bool WriteBinaryPipe(const void *data, size_t len)
+{
+#if defined(WIN32)
+   const char *p = static_cast<const char*>(data);
+   while (len > 0)
+   {
+      DWORD written;
+      if (!WriteFile(sBinaryPipe, p, (DWORD)len, &written, NULL))
+         return false;
+      p += written;
+      len -= written;
+   }
+   return true;
+#else
+   return fwrite(data, 1, len, sBinaryPipe) == len;
+#endif
+}
+
+} // end of anonymous namespace
+
+/// Creates the binary pipe and reports its name in the text response.  The
+/// client is not connected yet; that happens when the first frame is sent.
+bool ScriptCommandRelay::OpenBinaryChannel( wxString &reply )
+{
+   std::lock_guard<std::mutex> guard{ sBinaryMutex };
+   if (!sBinaryRequested)
+   {
+#if defined(WIN32)
+      sBinaryPipe = CreateNamedPipe(
+         binaryPipeName,
+         PIPE_ACCESS_OUTBOUND,
+         PIPE_TYPE_BYTE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS,
+         1,     // one instance
+         65536, // out buffer
+         0,     // in buffer
+         50,
+         NULL);
+      if (sBinaryPipe == INVALID_HANDLE_VALUE)
+      {
+         reply = wxT("Binary: Failed\n");
+         return false;
+      }
+#else
+      sBinaryPipePath = wxString::Format(
+         wxT("/tmp/audacity_script_pipe.binary.%d"), getuid());
+      unlink(sBinaryPipePath.mb_str());
+      if (mkfifo(sBinaryPipePath.mb_str(), S_IRWXU) < 0)
+      {
+         reply = wxT("Binary: Failed\n");
+         return false;
+      }
+#endif
+      sBinaryRequested = true;
+   }
+#if defined(WIN32)
+   reply = wxString::Format(wxT("Binary: %s\n"), binaryPipeName);
+#else
+   reply = wxString::Format(wxT("Binary: %s\n"), sBinaryPipePath);
+#endif
+   return true;
+}
+
+void ScriptCommandRelay::CloseBinaryChannel()
+{
+   std::lock_guard<std::mutex> guard{ sBinaryMutex };
+   if (!sBinaryRequested)
+      return;
+#if defined(WIN32)
+   if (sBinaryConnected)
+      DisconnectNamedPipe(sBinaryPipe);
+   CloseHandle(sBinaryPipe);
+   sBinaryPipe = INVALID_HANDLE_VALUE;
+#else
+   if (sBinaryPipe != NULL)
+      fclose(sBinaryPipe);
+   sBinaryPipe = NULL;
+   unlink(sBinaryPipePath.mb_str());
+#endif
+   sBinaryRequested = false;
+   sBinaryConnected = false;
+}
+
+bool ScriptCommandRelay::IsBinaryChannelOpen()
+{
+   std::lock_guard<std::mutex> guard{ sBinaryMutex };
+   return sBinaryRequested;
+}
+
+/// Sends one complete frame: header, then payload.
+bool ScriptCommandRelay::SendBinaryFrame(
+   unsigned type, const void *data, size_t len )
+{
+   return BeginBinaryFrame(type, len) && SendBinaryData(data, len);
+}
+
+/// Sends just the header of a frame whose payload will follow in pieces.
+bool ScriptCommandRelay::BeginBinaryFrame(
+   unsigned type, unsigned long long len )
+{
+   std::lock_guard<std::mutex> guard{ sBinaryMutex };
+   if (!sBinaryRequested || !ConnectBinaryPipe())
+      return false;
+   BinaryFrameHeader header{ binaryFrameMagic, type, len };
+   return WriteBinaryPipe(&header, sizeof(header));
+}
+
+/// Sends part of the payload of the frame begun by BeginBinaryFrame.
+bool ScriptCommandRelay::SendBinaryData( const void *data, size_t len )
+{
+   std::lock_guard<std::mutex> guard{ sBinaryMutex };
+   if (!sBinaryConnected || !WriteBinaryPipe(data, len))
+      return false;
+#if !defined(WIN32)
+   fflush(sBinaryPipe);
+#endif
+   return true;
+}
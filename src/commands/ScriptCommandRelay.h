@@ -43,6 +43,14 @@ class ScriptCommandRelay
 
    public:
 
+      // Types of the length-prefixed frames sent on the binary sidecar
+      // channel.  The text pipe stays line oriented; bulk results go here.
+      enum {
+         BinaryFrameText  = 1, // UTF-8 text, typically JSON
+         BinaryFrameAudio = 2, // raw 32 bit float samples
+         BinaryFrameAsyncResponse = 3, // correlation ID line, then text
+      };
+
       static void SetRegScriptServerFunc(tpRegScriptServerFunc scriptFn);
       static void SetCommandHandler(CommandHandler &ch);
 
@@ -50,6 +58,17 @@ class ScriptCommandRelay
       static void PostCommand(
          wxWindow *pWindow, const OldStyleCommandPointer &cmd);
       static Response ReceiveResponse();
+
+      // The binary sidecar channel, negotiated over the text pipe by the
+      // lines "Binary: On" and "Binary: Off".
+      static bool OpenBinaryChannel( wxString &reply );
+      static void CloseBinaryChannel();
+      static bool IsBinaryChannelOpen();
+      static bool SendBinaryFrame( unsigned type, const void *data, size_t len );
+      // For frames too big to assemble in memory: send the header, then
+      // stream pieces adding up to exactly len bytes.
+      static bool BeginBinaryFrame( unsigned type, unsigned long long len );
+      static bool SendBinaryData( const void *data, size_t len );
 };
 
 #endif /* End of include guard: __SCRIPT_COMMAND_RELAY__ */
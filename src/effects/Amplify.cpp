@@ -178,6 +178,19 @@ bool EffectAmplify::LoadFactoryDefaults()
 
 // Effect implementation
 
+bool EffectAmplify::SupportsConcurrentTracks()
+{
+   // ProcessBlock only reads mRatio, so tracks may be processed in parallel
+   return true;
+}
+
+bool EffectAmplify::SupportsChannelInterleaving()
+{
+   // Scaling each sample independently, with no latency, so a stereo pair
+   // may be processed as one interleaved stream
+   return true;
+}
+
 bool EffectAmplify::Init()
 {
    mPeak = 0.0;
@@ -52,6 +52,8 @@ public:
 
    // Effect implementation
 
+   bool SupportsConcurrentTracks() override;
+   bool SupportsChannelInterleaving() override;
    bool Init() override;
    void Preview(bool dryOnly) override;
    void PopulateOrExchange(ShuttleGui & S) override;
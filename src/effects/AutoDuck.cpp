@@ -21,6 +21,9 @@
 
 #include <math.h>
 #include <float.h>
+#include <string.h>
+
+#include <algorithm>
 
 #include <wx/dcclient.h>
 #include <wx/dcmemory.h>
@@ -29,6 +32,7 @@
 #include "../AColor.h"
 #include "../AllThemeResources.h"
 #include "../Prefs.h"
+#include "../Sequence.h"
 #include "../Shuttle.h"
 #include "../ShuttleGui.h"
 #include "../widgets/valnum.h"
@@ -305,20 +309,30 @@ bool EffectAutoDuck::Process()
       double duckRegionStart = 0;
       sampleCount curSamplesPause = 0;
 
-      auto pos = start;
-
-      while (pos < end)
+      // The block summaries of the control track bound the windowed sum of
+      // squares:  a summary frame whose peak, squared and multiplied by the
+      // window size, stays at or below the threshold cannot contain an
+      // exceeding sample, provided the window does not reach back into
+      // louder samples.  Such frames are classified from the summaries
+      // alone, and samples are read only around the frames that may cross
+      // the threshold, where the RMS window is refilled so that region
+      // boundaries stay sample-exact.
+      std::vector<SummaryFrame> frames;
+      // Number of known-quiet samples ending just before the next sample to
+      // be classified; the samples before the selection count as silence,
+      // like the zero-initialized window
+      auto quietRun = sampleCount( kRMSWindowSize );
+      bool windowValid = true;
+
+      // The serial scan over one span of fetched samples, starting at the
+      // given position in the track
+      auto scanSamples = [&](sampleCount first, size_t count)
       {
-         const auto len = limitSampleBufferSize( kBufSize, end - pos );
-         
-         mControlTrack->Get((samplePtr)buf.get(), floatSample, pos, len);
-
-         for (auto i = pos; i < pos + len; i++)
+         for (size_t j = 0; j < count; j++)
          {
+            auto i = first + j;
             rmsSum -= rmsWindow[rmsPos];
-            // i - pos is bounded by len:
-            auto index = ( i - pos ).as_size_t();
-            rmsWindow[rmsPos] = buf[ index ] * buf[ index ];
+            rmsWindow[rmsPos] = buf[ j ] * buf[ j ];
             rmsSum += rmsWindow[rmsPos];
             rmsPos = (rmsPos + 1) % kRMSWindowSize;
 
@@ -360,6 +374,105 @@ bool EffectAutoDuck::Process()
                }
             }
          }
+      };
+
+      // Rebuild the RMS window from the samples preceding the given
+      // position, as if the scan had never been interrupted
+      auto refillWindow = [&](sampleCount at)
+      {
+         memset(rmsWindow.get(), 0, kRMSWindowSize * sizeof(float));
+         rmsSum = 0;
+         rmsPos = 0;
+         const auto history =
+            limitSampleBufferSize( kRMSWindowSize, at - start );
+         if (history > 0)
+         {
+            Floats prev{ kRMSWindowSize };
+            mControlTrack->Get(
+               (samplePtr)prev.get(), floatSample, at - history, history);
+            for (size_t j = 0; j < history; j++)
+            {
+               rmsWindow[rmsPos] = prev[ j ] * prev[ j ];
+               rmsSum += rmsWindow[rmsPos];
+               rmsPos = (rmsPos + 1) % kRMSWindowSize;
+            }
+         }
+         windowValid = true;
+      };
+
+      auto pos = start;
+
+      while (pos < end)
+      {
+         const auto len = limitSampleBufferSize( kBufSize, end - pos );
+
+         frames.clear();
+         if (mControlTrack->GetSummaries256(pos, len, frames))
+         {
+            for (const auto &frame : frames)
+            {
+               // The first and last frames may extend beyond the chunk
+               const auto lo = std::max(frame.start, pos);
+               const auto hi =
+                  std::min(frame.start + frame.len, pos + len);
+               if (hi <= lo)
+                  continue;
+               const auto count = ( hi - lo ).as_size_t();
+
+               const double peak =
+                  std::max(fabs(frame.min), fabs(frame.max));
+               const bool frameQuiet =
+                  peak * peak * kRMSWindowSize <= threshold;
+
+               if (frameQuiet && quietRun >= kRMSWindowSize)
+               {
+                  // No window over these samples can exceed the threshold;
+                  // account for them without reading them
+                  if (inDuckRegion)
+                  {
+                     if (curSamplesPause + count >= minSamplesPause)
+                     {
+                        // the pause becomes long enough during this frame;
+                        // the last exceeding sample preceded the pause
+                        double duckRegionEnd =
+                           mControlTrack->LongSamplesToTime(
+                              lo - curSamplesPause - 1);
+
+                        regions.push_back(AutoDuckRegion(
+                           duckRegionStart - mOuterFadeDownLen,
+                           duckRegionEnd + mOuterFadeUpLen));
+
+                        inDuckRegion = false;
+                     }
+                     else
+                        curSamplesPause += count;
+                  }
+                  windowValid = false;
+               }
+               else
+               {
+                  if (!windowValid)
+                     refillWindow(lo);
+                  mControlTrack->Get(
+                     (samplePtr)buf.get(), floatSample, lo, count);
+                  scanSamples(lo, count);
+               }
+
+               if (frameQuiet)
+                  quietRun += count;
+               else
+                  quietRun = 0;
+            }
+         }
+         else
+         {
+            // No usable summaries here; scan the samples as of old
+            if (!windowValid)
+               refillWindow(pos);
+            mControlTrack->Get((samplePtr)buf.get(), floatSample, pos, len);
+            scanSamples(pos, len);
+            quietRun = 0;
+         }
 
          pos += len;
 
@@ -137,7 +137,7 @@ bool EffectBassTreble::ProcessInitialize(sampleCount WXUNUSED(totalLen), Channel
 
 size_t EffectBassTreble::ProcessBlock(float **inBlock, float **outBlock, size_t blockLen)
 {
-   return InstanceProcess(mMaster, inBlock, outBlock, blockLen);
+   return InstanceProcess(CurrentSettings(), mMaster, inBlock, outBlock, blockLen);
 }
 
 bool EffectBassTreble::RealtimeInitialize()
@@ -146,6 +146,10 @@ bool EffectBassTreble::RealtimeInitialize()
 
    mSlaves.clear();
 
+   // Seed the mailbox so the audio thread starts from the current settings
+   mSettingsMessage.Initialize();
+   mSettingsMessage.Write(CurrentSettings());
+
    return true;
 }
 
@@ -172,7 +176,11 @@ size_t EffectBassTreble::RealtimeProcess(int group,
                                               float **outbuf,
                                               size_t numSamples)
 {
-   return InstanceProcess(mSlaves[group], inbuf, outbuf, numSamples);
+   // Adopt whatever the UI thread last published; reading the mailbox
+   // never blocks, so the stream need not be suspended while tweaking
+   const auto settings = mSettingsMessage.Read();
+
+   return InstanceProcess(settings, mSlaves[group], inbuf, outbuf, numSamples);
 }
 bool EffectBassTreble::DefineParams( ShuttleParams & S ){
    S.SHUTTLE_PARAM( mBass, Bass );
@@ -204,6 +212,8 @@ bool EffectBassTreble::SetAutomationParameters(CommandParameters & parms)
    mGain = Gain;
    mLink = Link;
 
+   mSettingsMessage.Write(CurrentSettings());
+
    return true;
 }
 
@@ -308,6 +318,11 @@ bool EffectBassTreble::TransferDataFromWindow()
 
 // EffectBassTreble implementation
 
+EffectBassTrebleSettings EffectBassTreble::CurrentSettings() const
+{
+   return { mBass, mTreble, mGain };
+}
+
 void EffectBassTreble::InstanceInit(EffectBassTrebleState & data, float sampleRate)
 {
    data.samplerate = sampleRate;
@@ -349,7 +364,8 @@ void EffectBassTreble::InstanceInit(EffectBassTrebleState & data, float sampleRa
 // EffectClientInterface implementation
 
 
-size_t EffectBassTreble::InstanceProcess(EffectBassTrebleState & data,
+size_t EffectBassTreble::InstanceProcess(const EffectBassTrebleSettings & settings,
+                                              EffectBassTrebleState & data,
                                               float **inBlock,
                                               float **outBlock,
                                               size_t blockLen)
@@ -358,20 +374,20 @@ size_t EffectBassTreble::InstanceProcess(EffectBassTrebleState & data,
    float *obuf = outBlock[0];
 
    // Set value to ensure correct rounding
-   double oldBass = DB_TO_LINEAR(mBass);
-   double oldTreble = DB_TO_LINEAR(mTreble);
+   double oldBass = DB_TO_LINEAR(settings.bass);
+   double oldTreble = DB_TO_LINEAR(settings.treble);
 
-   data.gain = DB_TO_LINEAR(mGain);
+   data.gain = DB_TO_LINEAR(settings.gain);
 
    // Compute coefficents of the low shelf biquand IIR filter
    if (data.bass != oldBass)
-      Coefficents(data.hzBass, data.slope, mBass, data.samplerate, kBass,
+      Coefficents(data.hzBass, data.slope, settings.bass, data.samplerate, kBass,
                   data.a0Bass, data.a1Bass, data.a2Bass,
                   data.b0Bass, data.b1Bass, data.b2Bass);
 
    // Compute coefficents of the high shelf biquand IIR filter
    if (data.treble != oldTreble)
-      Coefficents(data.hzTreble, data.slope, mTreble, data.samplerate, kTreble,
+      Coefficents(data.hzTreble, data.slope, settings.treble, data.samplerate, kTreble,
                   data.a0Treble, data.a1Treble, data.a2Treble,
                   data.b0Treble, data.b1Treble, data.b2Treble);
 
@@ -449,6 +465,7 @@ void EffectBassTreble::OnBassText(wxCommandEvent & WXUNUSED(evt))
 
    if (mLink) UpdateGain(oldBass, kBass);
    mBassS->SetValue((int) (mBass * SCL_Bass));
+   mSettingsMessage.Write(CurrentSettings());
 }
 
 void EffectBassTreble::OnTrebleText(wxCommandEvent & WXUNUSED(evt))
@@ -462,6 +479,7 @@ void EffectBassTreble::OnTrebleText(wxCommandEvent & WXUNUSED(evt))
 
    if (mLink) UpdateGain(oldTreble, kTreble);
    mTrebleS->SetValue((int) (mTreble * SCL_Treble));
+   mSettingsMessage.Write(CurrentSettings());
 }
 
 void EffectBassTreble::OnGainText(wxCommandEvent & WXUNUSED(evt))
@@ -472,6 +490,7 @@ void EffectBassTreble::OnGainText(wxCommandEvent & WXUNUSED(evt))
    }
 
    mGainS->SetValue((int) (mGain * SCL_Gain));
+   mSettingsMessage.Write(CurrentSettings());
 }
 
 void EffectBassTreble::OnBassSlider(wxCommandEvent & evt)
@@ -482,6 +501,7 @@ void EffectBassTreble::OnBassSlider(wxCommandEvent & evt)
 
    if (mLink) UpdateGain(oldBass, kBass);
    EnableApply(mUIParent->Validate());
+   mSettingsMessage.Write(CurrentSettings());
 }
 
 void EffectBassTreble::OnTrebleSlider(wxCommandEvent & evt)
@@ -492,6 +512,7 @@ void EffectBassTreble::OnTrebleSlider(wxCommandEvent & evt)
 
    if (mLink) UpdateGain(oldTreble, kTreble);
    EnableApply(mUIParent->Validate());
+   mSettingsMessage.Write(CurrentSettings());
 }
 
 void EffectBassTreble::OnGainSlider(wxCommandEvent & evt)
@@ -500,6 +521,7 @@ void EffectBassTreble::OnGainSlider(wxCommandEvent & evt)
    mGainT->GetValidator()->TransferToWindow();
 
    EnableApply(mUIParent->Validate());
+   mSettingsMessage.Write(CurrentSettings());
 }
 
 void EffectBassTreble::OnLinkCheckbox(wxCommandEvent& /*evt*/)
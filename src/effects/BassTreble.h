@@ -13,6 +13,7 @@
 #define __AUDACITY_EFFECT_BASS_TREBLE__
 
 #include "Effect.h"
+#include "../MessageBuffer.h"
 
 class wxSlider;
 class wxCheckBox;
@@ -21,6 +22,17 @@ class ShuttleGui;
 
 #define BASSTREBLE_PLUGIN_SYMBOL ComponentInterfaceSymbol{ XO("Bass and Treble") }
 
+// A complete snapshot of the user parameters.  The UI thread publishes one
+// through a MessageBuffer whenever a control changes and the audio thread
+// adopts the latest at each chunk boundary, so tweaking a control during
+// playback never suspends the stream.
+struct EffectBassTrebleSettings
+{
+   double bass{ 0.0 };
+   double treble{ 0.0 };
+   double gain{ 0.0 };
+};
+
 class EffectBassTrebleState
 {
 public:
@@ -82,7 +94,11 @@ private:
    // EffectBassTreble implementation
 
    void InstanceInit(EffectBassTrebleState & data, float sampleRate);
-   size_t InstanceProcess(EffectBassTrebleState & data, float **inBlock, float **outBlock, size_t blockLen);
+   size_t InstanceProcess(const EffectBassTrebleSettings & settings,
+      EffectBassTrebleState & data,
+      float **inBlock, float **outBlock, size_t blockLen);
+
+   EffectBassTrebleSettings CurrentSettings() const;
 
    void Coefficents(double hz, double slope, double gain, double samplerate, int type,
                     double& a0, double& a1, double& a2, double& b0, double& b1, double& b2);
@@ -103,6 +119,8 @@ private:
    EffectBassTrebleState mMaster;
    std::vector<EffectBassTrebleState> mSlaves;
 
+   MessageBuffer<EffectBassTrebleSettings> mSettingsMessage;
+
    double      mBass;
    double      mTreble;
    double      mGain;
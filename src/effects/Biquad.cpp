@@ -39,6 +39,81 @@ void Biquad::Process(int iNumSamples)
       *pfOut++ = ProcessOne(*pfIn++);
 }
 
+void Biquad::ProcessCascade(Biquad *pStages, size_t nStages,
+   const float *pfInBuf, float *pfOutBuf, size_t iNumSamples)
+{
+   enum { MaxStages = 16 };
+
+   if (nStages == 0 || nStages > MaxStages || iNumSamples < 2) {
+      for (size_t i = 0; i < iNumSamples; i++) {
+         float fValue = pfInBuf[i];
+         for (size_t iStage = 0; iStage < nStages; iStage++)
+            fValue = pStages[iStage].ProcessOne(fValue);
+         pfOutBuf[i] = fValue;
+      }
+      return;
+   }
+
+   // Hoist the coefficients and state into locals, so the compiler can
+   // keep them in registers across the sample loop (the struct members
+   // could otherwise alias the output buffer).  The transposed direct
+   // form II needs only two state updates per stage instead of the four
+   // history shifts of ProcessOne; its state variables follow from the
+   // stored history:
+   //    s2 = B2*x[n-1] - A2*y[n-1]
+   //    s1 = B1*x[n-1] + B2*x[n-2] - A1*y[n-1] - A2*y[n-2]
+   float fB0[MaxStages], fB1[MaxStages], fB2[MaxStages];
+   float fA1[MaxStages], fA2[MaxStages];
+   float fS1[MaxStages], fS2[MaxStages];
+   for (size_t iStage = 0; iStage < nStages; iStage++) {
+      const Biquad &stage = pStages[iStage];
+      fB0[iStage] = stage.fNumerCoeffs[B0];
+      fB1[iStage] = stage.fNumerCoeffs[B1];
+      fB2[iStage] = stage.fNumerCoeffs[B2];
+      fA1[iStage] = stage.fDenomCoeffs[A1];
+      fA2[iStage] = stage.fDenomCoeffs[A2];
+      fS2[iStage] = fB2[iStage] * stage.fPrevIn
+         - fA2[iStage] * stage.fPrevOut;
+      fS1[iStage] = fB1[iStage] * stage.fPrevIn
+         + fB2[iStage] * stage.fPrevPrevIn
+         - fA1[iStage] * stage.fPrevOut
+         - fA2[iStage] * stage.fPrevPrevOut;
+   }
+
+   const size_t iMainLen = iNumSamples - 2;
+   for (size_t i = 0; i < iMainLen; i++) {
+      float fValue = pfInBuf[i];
+      for (size_t iStage = 0; iStage < nStages; iStage++) {
+         const float fOut = fB0[iStage] * fValue + fS1[iStage];
+         fS1[iStage] = fB1[iStage] * fValue
+            - fA1[iStage] * fOut + fS2[iStage];
+         fS2[iStage] = fB2[iStage] * fValue - fA2[iStage] * fOut;
+         fValue = fOut;
+      }
+      pfOutBuf[i] = fValue;
+   }
+
+   // The final two samples additionally refresh each stage's stored
+   // history, so that the next block (or a ProcessOne call) continues
+   // exactly where this one left off
+   for (size_t i = iMainLen; i < iNumSamples; i++) {
+      float fValue = pfInBuf[i];
+      for (size_t iStage = 0; iStage < nStages; iStage++) {
+         Biquad &stage = pStages[iStage];
+         const float fOut = fB0[iStage] * fValue + fS1[iStage];
+         fS1[iStage] = fB1[iStage] * fValue
+            - fA1[iStage] * fOut + fS2[iStage];
+         fS2[iStage] = fB2[iStage] * fValue - fA2[iStage] * fOut;
+         stage.fPrevPrevIn = stage.fPrevIn;
+         stage.fPrevIn = fValue;
+         stage.fPrevPrevOut = stage.fPrevOut;
+         stage.fPrevOut = fOut;
+         fValue = fOut;
+      }
+      pfOutBuf[i] = fValue;
+   }
+}
+
 void ComplexDiv (float fNumerR, float fNumerI, float fDenomR, float fDenomI, float* pfQuotientR, float* pfQuotientI)
 {
    float fDenom = square(fDenomR) + square(fDenomI);
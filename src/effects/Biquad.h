@@ -12,6 +12,8 @@ Max Maisel
 #ifndef __BIQUAD_H__
 #define __BIQUAD_H__
 
+#include <cstddef>
+
 
 /// \brief Represents a biquad digital filter.
 struct Biquad
@@ -20,6 +22,13 @@ struct Biquad
    void Reset();
    void Process(int iNumSamples);
 
+   /// Pass a whole buffer through a cascade of filters in one sweep over
+   /// memory, rather than one full pass per stage.  The stored history of
+   /// each stage stays authoritative at block boundaries, so this mixes
+   /// freely with ProcessOne across calls.
+   static void ProcessCascade(Biquad *pStages, size_t nStages,
+      const float *pfInBuf, float *pfOutBuf, size_t iNumSamples);
+
    enum
    {
       /// Numerator coefficient indices
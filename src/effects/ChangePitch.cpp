@@ -201,7 +201,6 @@ bool EffectChangePitch::LoadFactoryDefaults()
 
 bool EffectChangePitch::Init()
 {
-   mSoundTouch.reset();
    return true;
 }
 
@@ -224,15 +223,16 @@ bool EffectChangePitch::Process()
       // ensure that m_dSemitonesChange is set.
       Calc_SemitonesChange_fromPercentChange();
 
-      mSoundTouch = std::make_unique<soundtouch::SoundTouch>();
+      auto semitonesChange = m_dSemitonesChange;
+      auto initer = [semitonesChange](soundtouch::SoundTouch &soundTouch)
+         { soundTouch.setPitchSemiTones((float)(semitonesChange)); };
       IdentityTimeWarper warper;
-      mSoundTouch->setPitchSemiTones((float)(m_dSemitonesChange));
 #ifdef USE_MIDI
       // Pitch shifting note tracks is currently only supported by SoundTouchEffect
       // and non-real-time-preview effects require an audio track selection.
       //
       // Note: m_dSemitonesChange is private to ChangePitch because it only
-      // needs to pass it along to mSoundTouch (above). I added mSemitones
+      // needs to pass it along to SoundTouch (above). I added mSemitones
       // to SoundTouchEffect (the super class) to convey this value
       // to process Note tracks. This approach minimizes changes to existing
       // code, but it would be cleaner to change all m_dSemitonesChange to
@@ -240,7 +240,7 @@ bool EffectChangePitch::Process()
       // eliminate the next line:
       mSemitones = m_dSemitonesChange;
 #endif
-      return EffectSoundTouch::ProcessWithTimeWarper(warper);
+      return EffectSoundTouch::ProcessWithTimeWarper(initer, warper);
    }
 }
 
@@ -184,8 +184,6 @@ bool EffectChangeTempo::Init()
    m_FromLength = mT1 - mT0;
    m_ToLength = (m_FromLength * 100.0) / (100.0 + m_PercentChange);
 
-   mSoundTouch.reset();
-
    return true;
 }
 
@@ -205,12 +203,13 @@ bool EffectChangeTempo::Process()
    else
 #endif
    {
-      mSoundTouch = std::make_unique<soundtouch::SoundTouch>();
-      mSoundTouch->setTempoChange(m_PercentChange);
+      auto percentChange = m_PercentChange;
+      auto initer = [percentChange](soundtouch::SoundTouch &soundTouch)
+         { soundTouch.setTempoChange(percentChange); };
       double mT1Dashed = mT0 + (mT1 - mT0)/(m_PercentChange/100.0 + 1.0);
       RegionTimeWarper warper{ mT0, mT1,
          std::make_unique<LinearTimeWarper>(mT0, mT0, mT1, mT1Dashed )  };
-      success = EffectSoundTouch::ProcessWithTimeWarper(warper);
+      success = EffectSoundTouch::ProcessWithTimeWarper(initer, warper);
    }
 
    if(success)
@@ -27,6 +27,12 @@
 #include "../Audacity.h"
 #include "ClickRemoval.h"
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <vector>
+
 #include <math.h>
 
 #include <wx/intl.h>
@@ -174,6 +180,14 @@ bool EffectClickRemoval::Process()
    bool bGoodResult = true;
    mbDidSomething = false;
 
+   // RemoveClicks() used to round the window separation up to a power of
+   // two on its first call and keep the result; round it here instead, so
+   // that every window, on whichever thread, sees the same value
+   size_t rounded = 1;
+   while ((int)rounded < sep)
+      rounded *= 2;
+   sep = rounded;
+
    int count = 0;
    for( auto track : mOutputTracks->Selected< WaveTrack >() ) {
       double trackStart = track->GetStartTime();
@@ -222,26 +236,91 @@ bool EffectClickRemoval::ProcessOne(int count, WaveTrack * track, sampleCount st
    bool bResult = true;
    decltype(len) s = 0;
    Floats buffer{ idealBlockLen };
-   Floats datawindow{ windowSize };
+
+   const unsigned nWorkers =
+      std::max(1u, std::thread::hardware_concurrency());
+
    while ((len - s) > windowSize / 2)
    {
       auto block = limitSampleBufferSize( idealBlockLen, len - s );
 
       track->Get((samplePtr) buffer.get(), floatSample, start + s, block);
 
+      // The windows of this block, each overlapping its neighbours by
+      // half a window
+      std::vector<decltype(block)> offsets;
       for (decltype(block) i = 0; i + windowSize / 2 < block; i += windowSize / 2)
-      {
-         auto wcopy = std::min( windowSize, block - i );
+         offsets.push_back(i);
 
-         for(decltype(wcopy) j = 0; j < wcopy; j++)
-            datawindow[j] = buffer[i+j];
-         for(auto j = wcopy; j < windowSize; j++)
-            datawindow[j] = 0;
+      if (nWorkers < 2 || offsets.size() < 2) {
+         Floats datawindow{ windowSize };
+         for (auto i : offsets)
+         {
+            auto wcopy = std::min( windowSize, block - i );
+
+            for(decltype(wcopy) j = 0; j < wcopy; j++)
+               datawindow[j] = buffer[i+j];
+            for(auto j = wcopy; j < windowSize; j++)
+               datawindow[j] = 0;
 
-         mbDidSomething |= RemoveClicks(windowSize, datawindow.get());
+            mbDidSomething |= RemoveClicks(windowSize, datawindow.get(), sep);
 
-         for(decltype(wcopy) j = 0; j < wcopy; j++)
-           buffer[i+j] = datawindow[j];
+            for(decltype(wcopy) j = 0; j < wcopy; j++)
+              buffer[i+j] = datawindow[j];
+         }
+      }
+      else {
+         // Each window reads its own copy of the block, so the windows
+         // can be processed on worker threads in any order; the results
+         // are then copied back in ascending order, as the serial loop
+         // overwrote the second half of each window with the first half
+         // of the next
+         std::vector<Floats> outputs(offsets.size());
+         for (auto &output : outputs)
+            output.reinit(windowSize);
+         ArrayOf<bool> results{ offsets.size(), true };
+
+         std::atomic<size_t> nextWindow{ 0 };
+         std::vector<std::exception_ptr> exceptions(nWorkers);
+         std::vector<std::thread> workers;
+         for (unsigned ii = 0; ii < nWorkers; ++ii) {
+            workers.emplace_back([&, ii]{
+               try {
+                  for (;;) {
+                     auto index = nextWindow++;
+                     if (index >= offsets.size())
+                        break;
+                     auto i = offsets[index];
+                     auto wcopy = std::min( windowSize, block - i );
+                     float *datawindow = outputs[index].get();
+
+                     for(decltype(wcopy) j = 0; j < wcopy; j++)
+                        datawindow[j] = buffer[i+j];
+                     for(auto j = wcopy; j < windowSize; j++)
+                        datawindow[j] = 0;
+
+                     results[index] =
+                        RemoveClicks(windowSize, datawindow, sep);
+                  }
+               }
+               catch (...) {
+                  exceptions[ii] = std::current_exception();
+               }
+            });
+         }
+         for (auto &worker : workers)
+            worker.join();
+         for (auto &pException : exceptions)
+            if (pException)
+               std::rethrow_exception(pException);
+
+         for (size_t index = 0; index < offsets.size(); ++index) {
+            auto i = offsets[index];
+            auto wcopy = std::min( windowSize, block - i );
+            mbDidSomething |= results[index];
+            for(decltype(wcopy) j = 0; j < wcopy; j++)
+               buffer[i+j] = outputs[index][j];
+         }
       }
 
       if (mbDidSomething) // RemoveClicks() actually did something.
@@ -259,7 +338,7 @@ bool EffectClickRemoval::ProcessOne(int count, WaveTrack * track, sampleCount st
    return bResult;
 }
 
-bool EffectClickRemoval::RemoveClicks(size_t len, float *buffer)
+bool EffectClickRemoval::RemoveClicks(size_t len, float *buffer, int sep) const
 {
    bool bResult = false; // This effect usually does nothing.
    size_t i;
@@ -299,12 +378,23 @@ bool EffectClickRemoval::RemoveClicks(size_t len, float *buffer)
    for(wrc=mClickWidth/4; wrc>=1; wrc /= 2) {
       ww = mClickWidth/wrc;
 
+      // Slide a running sum of b2 over the spike width instead of
+      // re-summing it at every sample; a repair writes into b2 inside
+      // the sum, so recompute it fresh after one
+      double msw_sum = 0;
+      bool freshen = true;
+
       for( i=0; i<len-sep; i++ ){
-         msw = 0;
-         for( j=0; (int)j<ww; j++) {
-            msw += b2[i+s2+j];
+         if (freshen) {
+            msw_sum = 0;
+            for( j=0; (int)j<ww; j++) {
+               msw_sum += b2[i+s2+j];
+            }
+            freshen = false;
          }
-         msw /= ww;
+         else
+            msw_sum += (double)b2[i+s2+ww-1] - b2[i+s2-1];
+         msw = msw_sum / ww;
 
          if(msw >= mThresholdLevel * ms_seq[i]/10) {
             if( left == 0 ) {
@@ -320,6 +410,7 @@ bool EffectClickRemoval::RemoveClicks(size_t len, float *buffer)
                   b2[j] = buffer[j]*buffer[j];
                }
                left=0;
+               freshen = true;
             } else if(left != 0) {
                left = 0;
             }
@@ -60,7 +60,7 @@ private:
    bool ProcessOne(int count, WaveTrack * track,
                    sampleCount start, sampleCount len);
 
-   bool RemoveClicks(size_t len, float *buffer);
+   bool RemoveClicks(size_t len, float *buffer, int sep) const;
 
    void OnWidthText(wxCommandEvent & evt);
    void OnThreshText(wxCommandEvent & evt);
@@ -350,6 +350,11 @@ bool EffectCompressor::NewTrackPass1()
 
    mLastLevel = mThreshold;
 
+   // Impossible envelope value, so the first call of DoCompression
+   // computes a fresh gain
+   mCachedEnv = -1.0;
+   mCachedGain = 0.0;
+
    mCircleSize = 100;
    mCircle.reinit( mCircleSize, true );
    mCirclePos = 0;
@@ -437,8 +442,10 @@ bool EffectCompressor::ProcessPass2(float *buffer, size_t len)
 {
    if (mMax != 0)
    {
+      // Multiply by the reciprocal, so that the loop vectorizes
+      const float invMax = 1.0 / mMax;
       for (size_t i = 0; i < len; i++)
-         buffer[i] /= mMax;
+         buffer[i] *= invMax;
    }
 
    return true;
@@ -583,14 +590,20 @@ void EffectCompressor::Follow(float *buffer, float *env, size_t len, float *prev
 
 float EffectCompressor::DoCompression(float value, double env)
 {
-   float out;
-   if(mUsePeak) {
-      // Peak values map 1.0 to 1.0 - 'upward' compression
-      out = value * pow(1.0/env, mCompression);
-   } else {
-      // With RMS-based compression don't change values below mThreshold - 'downward' compression
-      out = value * pow(mThreshold/env, mCompression);
+   // The envelope rides long plateaus at the threshold, so the pow()
+   // below -- by far the costliest part of this routine -- would keep
+   // recomputing the same gain; reuse the last result while the envelope
+   // holds still.
+   if(env != mCachedEnv) {
+      mCachedEnv = env;
+      if(mUsePeak)
+         // Peak values map 1.0 to 1.0 - 'upward' compression
+         mCachedGain = pow(1.0/env, mCompression);
+      else
+         // With RMS-based compression don't change values below mThreshold - 'downward' compression
+         mCachedGain = pow(mThreshold/env, mCompression);
    }
+   float out = value * mCachedGain;
 
    // Retain the maximum value for use in the normalization pass
    if(mMax < fabs(out))
@@ -95,6 +95,8 @@ private:
    int       mNoiseCounter;
    double    mGain;
    double    mLastLevel;
+   double    mCachedEnv;
+   double    mCachedGain;
    Floats mFollow1, mFollow2;
    size_t    mFollowLen;
 
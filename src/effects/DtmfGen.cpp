@@ -548,10 +548,24 @@ bool EffectDtmf::MakeDtmfTone(float *buffer, size_t len, float fs, wxChar tone,
 
    // now generate the wave: 'last' is used to avoid phase errors
    // when inside the inner for loop of the Process() function.
+   // Each sine advances by the two-term recurrence
+   //    sin(p + d) = 2 cos(d) sin(p) - sin(p - d),
+   // seeded from the library at the start of the buffer, so the loop
+   // makes no transcendental call per sample.
+   const double phaseA = A * last.as_double();
+   const double phaseB = B * last.as_double();
+   const double coeffA = 2.0 * cos(A);
+   const double coeffB = 2.0 * cos(B);
+   double a0 = sin(phaseA - A), a1 = sin(phaseA);
+   double b0 = sin(phaseB - B), b1 = sin(phaseB);
    for(decltype(len) i = 0; i < len; i++) {
-      buffer[i] = amplitude * 0.5 *
-         (sin( A * (i + last).as_double() ) +
-          sin( B * (i + last).as_double() ));
+      buffer[i] = amplitude * 0.5 * (a1 + b1);
+      const double a2 = coeffA * a1 - a0;
+      a0 = a1;
+      a1 = a2;
+      const double b2 = coeffB * b1 - b0;
+      b0 = b1;
+      b1 = b2;
    }
 
    // generate a fade-in of duration 1/250th of second
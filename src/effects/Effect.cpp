@@ -27,6 +27,17 @@ greater use in future.
 #include "../Experimental.h"
 
 #include <algorithm>
+#include <chrono>
+#include <exception>
+#include <thread>
+#include <vector>
+
+#if defined(__WXMAC__)
+#include <sys/types.h>
+#include <sys/sysctl.h>
+#elif !defined(__WXMSW__)
+#include <unistd.h>
+#endif
 
 #include <wx/bmpbuttn.h>
 #include <wx/checkbox.h>
@@ -39,6 +50,7 @@ greater use in future.
 #include <wx/settings.h>
 #include <wx/sizer.h>
 #include <wx/stockitem.h>
+#include <wx/stopwatch.h>
 #include <wx/string.h>
 #include <wx/tglbtn.h>
 #include <wx/timer.h>
@@ -49,6 +61,7 @@ greater use in future.
 
 #include "EffectManager.h"
 #include "RealtimeEffectManager.h"
+#include "TrackIOQueue.h"
 #include "../AudioIO.h"
 #include "../CommonCommandFlags.h"
 #include "../LabelTrack.h"
@@ -146,6 +159,7 @@ Effect::Effect()
    mNumTracks = 0;
    mNumGroups = 0;
    mProgress = NULL;
+   mProgressLastUpdate = 0;
 
    mUIParent = NULL;
    mUIDialog = NULL;
@@ -155,6 +169,7 @@ Effect::Effect()
 
    mBufferSize = 0;
    mBlockSize = 0;
+   mBlockSizeHint = 0;
    mNumChannels = 0;
 
    mUIDebug = false;
@@ -1178,6 +1193,9 @@ bool Effect::DoEffect(wxWindow *parent,
 
    mOutputTracks.reset();
 
+   // Track audio may have changed since the last invocation
+   mPreviewRenders.clear();
+
    mpSelectedRegion = &selectedRegion;
    mFactory = factory;
    mProjectRate = projectRate;
@@ -1267,15 +1285,25 @@ bool Effect::DoEffect(wxWindow *parent,
    bool skipFlag = CheckWhetherSkipEffect();
    if (skipFlag == false)
    {
-      auto name = GetTranslatedName();
-      ProgressDialog progress{
-         name,
-         wxString::Format(_("Applying %s..."), name),
-         pdlgHideStopButton
-      };
-      auto vr = valueRestorer( mProgress, &progress );
-
-      returnVal = Process();
+      if (mIsBatch)
+      {
+         // Macros and scripted runs never show the dialog, so don't pay
+         // for building and destroying one per effect; progress calls
+         // see a null mProgress and do nothing
+         returnVal = Process();
+      }
+      else
+      {
+         auto name = GetTranslatedName();
+         ProgressDialog progress{
+            name,
+            wxString::Format(_("Applying %s..."), name),
+            pdlgHideStopButton
+         };
+         auto vr = valueRestorer( mProgress, &progress );
+
+         returnVal = Process();
+      }
    }
 
    if (returnVal && (mT1 >= mT0 ))
@@ -1349,8 +1377,121 @@ bool Effect::Process()
    return bGoodResult;
 }
 
+namespace {
+
+// Runtime detection of the outermost data cache, in bytes, as an upper
+// bound on useful working sets.  Falls back to a typical size when the
+// platform will not say.
+size_t DataCacheSize()
+{
+   static const size_t size = []() -> size_t {
+#if defined(__WXMAC__)
+      for (const char *name : { "hw.l3cachesize", "hw.l2cachesize" }) {
+         int64_t bytes = 0;
+         size_t len = sizeof(bytes);
+         if (!sysctlbyname(name, &bytes, &len, nullptr, 0) && bytes > 0)
+            return bytes;
+      }
+#elif !defined(__WXMSW__)
+#if defined(_SC_LEVEL3_CACHE_SIZE)
+      for (int name : { _SC_LEVEL3_CACHE_SIZE, _SC_LEVEL2_CACHE_SIZE }) {
+         long bytes = sysconf(name);
+         if (bytes > 0)
+            return bytes;
+      }
+#endif
+#endif
+      return 2 * 1024 * 1024;
+   }();
+   return size;
+}
+
+// Samples the throughput of a few candidate block sizes, largest first,
+// over the opening of the first track, then locks in the fastest.  Sizes
+// descend by halving, so a switch during the trials never misaligns the
+// buffer bookkeeping in ProcessTrack.
+class BlockSizeTuner
+{
+public:
+   explicit BlockSizeTuner(size_t maxSize)
+   {
+      for (auto size = maxSize; size >= 512 && mCandidates.size() < 4;
+           size /= 2)
+         mCandidates.push_back(size);
+      // Process the same amount of audio at each size
+      mTrialSamples = 4 * maxSize;
+   }
+
+   bool Trying() const { return mIndex < mCandidates.size(); }
+
+   // The size to prefer for the next block
+   size_t Current() const
+   { return Trying() ? mCandidates[mIndex] : mBest; }
+
+   size_t Best() const { return mBest; }
+
+   // Account for one timed block; true when this ended the trials
+   bool Account(double seconds, size_t samples)
+   {
+      if (!Trying())
+         return false;
+
+      mSeconds += seconds;
+      mSamples += samples;
+      if (mSamples < mTrialSamples)
+         return false;
+
+      const double rate = mSamples / std::max(mSeconds, 1e-9);
+      if (rate > mBestRate) {
+         mBestRate = rate;
+         mBest = mCandidates[mIndex];
+      }
+
+      mSeconds = 0.0;
+      mSamples = 0;
+      ++mIndex;
+      return !Trying();
+   }
+
+private:
+   std::vector<size_t> mCandidates;
+   size_t mIndex{ 0 };
+   size_t mTrialSamples{ 0 };
+   size_t mSamples{ 0 };
+   double mSeconds{ 0.0 };
+   size_t mBest{ 0 };
+   double mBestRate{ 0.0 };
+};
+
+}
+
+size_t Effect::TuneBlockSize(size_t maxBlockSize)
+{
+   // A previously measured, or hand written, per-effect hint wins
+   mBlockSizeHint = 0;
+   GetPrivateConfig(GetCurrentSettingsGroup(), wxT("BlockSizeHint"),
+                    mBlockSizeHint, 0);
+   if (mBlockSizeHint > 0)
+      return SetBlockSize(
+         std::min<size_t>(maxBlockSize, mBlockSizeHint));
+
+   // Otherwise start from a size whose working set -- one pass over the
+   // input and output buffers -- still fits in the data cache; the trials
+   // in ProcessTrack may settle on something smaller yet
+   const auto bytesPerFrame =
+      std::max<size_t>(1, (mNumAudioIn + mNumAudioOut) * sizeof(float));
+   const auto limit = std::max<size_t>(512, DataCacheSize() / bytesPerFrame);
+   return SetBlockSize(std::min(maxBlockSize, limit));
+}
+
 bool Effect::ProcessPass()
 {
+   // Stateless effects may let independent tracks be processed on
+   // concurrent workers
+   if (GetType() == EffectTypeProcess && SupportsConcurrentTracks() &&
+       mNumTracks > 1 && std::thread::hardware_concurrency() > 1)
+      return ProcessPassParallel();
+
    bool bGoodResult = true;
    bool isGenerator = GetType() == EffectTypeGenerate;
 
@@ -1366,7 +1507,12 @@ bool Effect::ProcessPass()
    bool clear = false;
 
    const bool multichannel = mNumAudioIn > 1;
-   auto range = multichannel
+   // A mono-in, mono-out effect that declares channel independence can
+   // take a linked stereo pair through ProcessBlock as one interleaved
+   // buffer; iterate leaders then, so both channels arrive together.
+   const bool interleave = !multichannel && mNumAudioOut == 1 &&
+      GetType() == EffectTypeProcess && SupportsChannelInterleaving();
+   auto range = (multichannel || interleave)
       ? mOutputTracks->Leaders()
       : mOutputTracks->Any();
    range.VisitWhile( bGoodResult,
@@ -1408,7 +1554,7 @@ bool Effect::ProcessPass()
             ++ mNumChannels;
             map[mNumChannels] = ChannelNameEOL;
 
-            if (! multichannel)
+            if (! multichannel && ! interleave)
                break;
 
             if (mNumChannels == 2) {
@@ -1428,7 +1574,7 @@ bool Effect::ProcessPass()
 
          // Get the block size the client wants to use
          auto max = left->GetMaxBlockSize() * 2;
-         mBlockSize = SetBlockSize(max);
+         mBlockSize = TuneBlockSize(max);
 
          // Calculate the buffer size to be at least the max rounded up to the clients
          // selected block size.
@@ -1483,9 +1629,13 @@ bool Effect::ProcessPass()
          }
 
          // Go process the track(s)
-         bGoodResult = ProcessTrack(
-            count, map, left, right, leftStart, rightStart, len,
-            inBuffer, outBuffer, inBufPos, outBufPos);
+         if (interleave && right)
+            bGoodResult = ProcessTrackInterleaved(
+               count, left, right, leftStart, rightStart, len);
+         else
+            bGoodResult = ProcessTrack(
+               count, map, left, right, leftStart, rightStart, len,
+               inBuffer, outBuffer, inBufPos, outBufPos, mNumChannels);
          if (!bGoodResult)
             return;
 
@@ -1505,6 +1655,177 @@ bool Effect::ProcessPass()
    return bGoodResult;
 }
 
+bool Effect::ProcessPassParallel()
+{
+   bool bGoodResult = true;
+
+   // Gather the per-track work first; the visit stays on this thread,
+   // which also adjusts sync-locked tracks as the sequential pass does.
+   struct Spec {
+      WaveTrack *left{};
+      WaveTrack *right{};
+      sampleCount leftStart;
+      sampleCount rightStart;
+      sampleCount len;
+      ChannelName map[3];
+      unsigned numChannels{};
+      int count{};
+   };
+   std::vector<Spec> specs;
+
+   const bool multichannel = mNumAudioIn > 1;
+   auto range = multichannel
+      ? mOutputTracks->Leaders()
+      : mOutputTracks->Any();
+   range.VisitWhile( bGoodResult,
+      [&](WaveTrack *left, const Track::Fallthrough &fallthrough) {
+         if (!left->GetSelected())
+            return fallthrough();
+
+         Spec spec;
+         spec.left = left;
+         GetSamples(left, &spec.leftStart, &spec.len);
+         mSampleCnt = spec.len;
+
+         // Iterate either over one track which could be any channel,
+         // or if multichannel, then over all channels of left,
+         // which is a leader.
+         for (auto channel :
+              TrackList::Channels(left).StartingWith(left)) {
+            if (channel->GetChannel() == Track::LeftChannel)
+               spec.map[spec.numChannels] = ChannelNameFrontLeft;
+            else if (channel->GetChannel() == Track::RightChannel)
+               spec.map[spec.numChannels] = ChannelNameFrontRight;
+            else
+               spec.map[spec.numChannels] = ChannelNameMono;
+
+            ++ spec.numChannels;
+            spec.map[spec.numChannels] = ChannelNameEOL;
+
+            if (! multichannel)
+               break;
+
+            if (spec.numChannels == 2) {
+               // TODO: more-than-two-channels
+               spec.right = channel;
+               GetSamples(spec.right, &spec.rightStart, &spec.len);
+
+               // Ignore other channels
+               break;
+            }
+         }
+
+         spec.count = (int)specs.size();
+         specs.push_back(spec);
+      },
+      [&](Track *t) {
+         if (t->IsSyncLockSelected())
+            t->SyncLockAdjust(mT1, mT0 + mDuration);
+      }
+   );
+
+   if (!bGoodResult || specs.empty())
+      return bGoodResult;
+
+   // One block and buffer size serves every track.  An effect that opted
+   // in does not depend on the sample rate, so the client is told the
+   // first track's rate, once, before the workers start; the members set
+   // here are read-only while they run.
+   SetSampleRate(specs[0].left->GetRate());
+   size_t max = 0;
+   for (const auto &spec : specs)
+      max = std::max(max, spec.left->GetMaxBlockSize() * 2);
+   mBlockSize = TuneBlockSize(max);
+   mBufferSize = ((max + (mBlockSize - 1)) / mBlockSize) * mBlockSize;
+
+   const unsigned nWorkers = std::min<unsigned>(
+      (unsigned)specs.size(), std::thread::hardware_concurrency() );
+
+   // Workers steal the next unprocessed track and report through atomics;
+   // only this thread touches the progress dialog.
+   std::atomic<size_t> nextSpec{ 0 };
+   std::atomic<bool> cancel{ false };
+   std::atomic<bool> good{ true };
+   std::atomic<unsigned> busy{ nWorkers };
+   ArrayOf<std::atomic<double>> fractions{ specs.size(), true };
+   std::vector<std::exception_ptr> exceptions( nWorkers );
+
+   auto work = [&](unsigned ii) {
+      auto cleanup = finally( [&]{ --busy; } );
+      try {
+         // Per-worker buffers, prepared as for the sequential pass
+         FloatBuffers inBuffer{ mNumAudioIn, mBufferSize };
+         FloatBuffers outBuffer{ mNumAudioOut, mBufferSize + mBlockSize };
+         ArrayOf<float *> inBufPos{ mNumAudioIn };
+         ArrayOf<float *> outBufPos{ mNumAudioOut };
+         for (size_t i = 2; i < mNumAudioIn; i++)
+            for (size_t j = 0; j < mBufferSize; j++)
+               inBuffer[i][j] = 0.0;
+
+         bool clear = false;
+         for (;;) {
+            auto index = nextSpec++;
+            if (index >= specs.size() || cancel.load())
+               break;
+            auto &spec = specs[index];
+
+            for (size_t i = 0; i < mNumAudioIn; i++)
+               inBufPos[i] = inBuffer[i].get();
+            for (size_t i = 0; i < mNumAudioOut; i++)
+               outBufPos[i] = outBuffer[i].get();
+
+            // Clear the unused input buffer, dirtied again whenever a
+            // stereo pair has been through it
+            if (spec.right)
+               clear = false;
+            else if (!clear && mNumAudioIn > 1) {
+               for (size_t j = 0; j < mBufferSize; j++)
+                  inBuffer[1][j] = 0.0;
+               clear = true;
+            }
+
+            if (!ProcessTrack(spec.count, spec.map, spec.left, spec.right,
+                  spec.leftStart, spec.rightStart, spec.len,
+                  inBuffer, outBuffer, inBufPos, outBufPos,
+                  spec.numChannels, &fractions[index], &cancel)) {
+               good.store(false);
+               cancel.store(true);
+               break;
+            }
+            fractions[index].store(1.0);
+         }
+      }
+      catch (...) {
+         exceptions[ii] = std::current_exception();
+         cancel.store(true);
+      }
+   };
+
+   std::vector<std::thread> workers;
+   workers.reserve(nWorkers);
+   for (unsigned ii = 0; ii < nWorkers; ii++)
+      workers.emplace_back(work, ii);
+
+   // Poll aggregated progress until the workers drain the queue
+   while (busy.load()) {
+      wxMilliSleep(50);
+      double sum = 0;
+      for (size_t i = 0; i < specs.size(); i++)
+         sum += fractions[i].load();
+      if (TotalProgress(sum / specs.size()))
+         cancel.store(true);
+   }
+
+   for (auto &worker : workers)
+      worker.join();
+
+   for (auto &pException : exceptions)
+      if (pException)
+         std::rethrow_exception(pException);
+
+   return good.load() && !cancel.load();
+}
+
 bool Effect::ProcessTrack(int count,
                           ChannelNames map,
                           WaveTrack *left,
@@ -1515,7 +1836,10 @@ bool Effect::ProcessTrack(int count,
                           FloatBuffers &inBuffer,
                           FloatBuffers &outBuffer,
                           ArrayOf< float * > &inBufPos,
-                          ArrayOf< float *> &outBufPos)
+                          ArrayOf< float *> &outBufPos,
+                          unsigned numChannels,
+                          std::atomic<double> *pFraction,
+                          std::atomic<bool> *pCancel)
 {
    bool rc = true;
 
@@ -1561,13 +1885,24 @@ bool Effect::ProcessTrack(int count,
    decltype(mBufferSize) outputBufferCnt = 0;
    bool cleared = false;
 
-   auto chans = std::min<unsigned>(mNumAudioOut, mNumChannels);
+   auto chans = std::min<unsigned>(mNumAudioOut, numChannels);
 
    std::shared_ptr<WaveTrack> genLeft, genRight;
 
    decltype(len) genLength = 0;
    bool isGenerator = GetType() == EffectTypeGenerate;
    bool isProcessor = GetType() == EffectTypeProcess;
+
+   // Automatic block size tuning:  on the first track, when no persisted
+   // hint applies, try a few sizes and lock in the fastest.  Workers in
+   // the parallel path (pFraction given) share one negotiated size, so
+   // only the sequential path tunes.  Effective size changes only in ways
+   // that keep the buffer bookkeeping below aligned.
+   std::unique_ptr<BlockSizeTuner> tuner;
+   if (isProcessor && count == 0 && !pFraction &&
+       mBlockSizeHint == 0 && mBlockSize >= 1024)
+      tuner = std::make_unique<BlockSizeTuner>(mBlockSize);
+   auto curMaxBlock = mBlockSize;
    double genDur = 0;
    if (isGenerator)
    {
@@ -1590,6 +1925,39 @@ bool Effect::ProcessTrack(int count,
          genRight = mFactory->NewWaveTrack(right->GetSampleFormat(), right->GetRate());
    }
 
+   // Pipeline the track I/O on a worker thread:  while the plugin
+   // processes out of one pair of buffer sets, the worker fetches the
+   // next input set and stores the previously filled output set.  The
+   // tracks here are the private output copies of the project, so only
+   // the worker touches them until the pipeline is drained below.
+   FloatBuffers inBuffer2{ mNumAudioIn, mBufferSize };
+   FloatBuffers outBuffer2{ mNumAudioOut, mBufferSize + mBlockSize };
+   const auto inBufs = [&](unsigned set, size_t i) {
+      return set ? inBuffer2[i].get() : inBuffer[i].get();
+   };
+   const auto outBufs = [&](unsigned set, size_t i) {
+      return set ? outBuffer2[i].get() : outBuffer[i].get();
+   };
+
+   unsigned curInSet = 0, readSet = 0, curOutSet = 0;
+   auto readLeftPos = inLeftPos;
+   auto readRightPos = inRightPos;
+   TrackIOQueue::Ticket readTicket = 0;
+   TrackIOQueue::Ticket writeTickets[2] = { 0, 0 };
+   TrackIOQueue io;
+
+   // Prime the pipeline with the first fetch
+   auto pendingReadLen = limitSampleBufferSize( mBufferSize, inputRemaining );
+   if (pendingReadLen) {
+      const auto cnt = pendingReadLen;
+      const auto lpos = readLeftPos, rpos = readRightPos;
+      readTicket = io.Post([=]{
+         left->Get((samplePtr) inBufs(0, 0), floatSample, lpos, cnt);
+         if (right)
+            right->Get((samplePtr) inBufs(0, 1), floatSample, rpos, cnt);
+      });
+   }
+
    // Call the effect until we run out of input or delayed samples
    while (inputRemaining != 0 || delayRemaining != 0)
    {
@@ -1599,26 +1967,43 @@ bool Effect::ProcessTrack(int count,
          // Need to refill the input buffers
          if (inputBufferCnt == 0)
          {
-            // Calculate the number of samples to get
-            inputBufferCnt =
-               limitSampleBufferSize( mBufferSize, inputRemaining );
+            // Adopt the prefetched input set; rethrows if the fetch failed
+            inputBufferCnt = pendingReadLen;
+            io.Wait(readTicket);
+            curInSet = readSet;
 
-            // Fill the input buffers
-            left->Get((samplePtr) inBuffer[0].get(), floatSample, inLeftPos, inputBufferCnt);
-            if (right)
+            // Reset the input buffer positions
+            for (size_t i = 0; i < numChannels; i++)
             {
-               right->Get((samplePtr) inBuffer[1].get(), floatSample, inRightPos, inputBufferCnt);
+               inBufPos[i] = inBufs(curInSet, i);
             }
 
-            // Reset the input buffer positions
-            for (size_t i = 0; i < mNumChannels; i++)
-            {
-               inBufPos[i] = inBuffer[i].get();
+            // Start fetching the following set while the plugin works
+            const auto nextLen = limitSampleBufferSize(
+               mBufferSize, inputRemaining - inputBufferCnt );
+            if (nextLen) {
+               readSet = 1 - readSet;
+               readLeftPos += inputBufferCnt;
+               readRightPos += inputBufferCnt;
+               pendingReadLen = nextLen;
+               const auto set = readSet;
+               const auto cnt = nextLen;
+               const auto lpos = readLeftPos, rpos = readRightPos;
+               readTicket = io.Post([=]{
+                  left->Get((samplePtr) inBufs(set, 0), floatSample, lpos, cnt);
+                  if (right)
+                     right->Get((samplePtr) inBufs(set, 1), floatSample, rpos, cnt);
+               });
             }
+
+            // A freshly adopted buffer is aligned for any block size, so
+            // a larger size chosen by finished trials may start here
+            if (tuner && !tuner->Trying())
+               curMaxBlock = tuner->Best();
          }
 
          // Calculate the number of samples to process
-         curBlockSize = mBlockSize;
+         curBlockSize = curMaxBlock;
          if (curBlockSize > inputRemaining)
          {
             // We've reached the last block...set current block size to what's left
@@ -1628,8 +2013,8 @@ bool Effect::ProcessTrack(int count,
 
             // Clear the remainder of the buffers so that a full block can be passed
             // to the effect
-            auto cnt = mBlockSize - curBlockSize;
-            for (size_t i = 0; i < mNumChannels; i++)
+            auto cnt = curMaxBlock - curBlockSize;
+            for (size_t i = 0; i < numChannels; i++)
             {
                for (decltype(cnt) j = 0 ; j < cnt; j++)
                {
@@ -1658,14 +2043,14 @@ bool Effect::ProcessTrack(int count,
          if (!cleared)
          {
             // Reset the input buffer positions
-            for (size_t i = 0; i < mNumChannels; i++)
+            for (size_t i = 0; i < numChannels; i++)
             {
-               inBufPos[i] = inBuffer[i].get();
+               inBufPos[i] = inBufs(curInSet, i);
 
                // And clear
                for (size_t j = 0; j < mBlockSize; j++)
                {
-                  inBuffer[i][j] = 0.0;
+                  inBufPos[i][j] = 0.0;
                }
             }
             cleared = true;
@@ -1674,6 +2059,10 @@ bool Effect::ProcessTrack(int count,
 
       // Finally call the plugin to process the block
       decltype(curBlockSize) processed;
+      std::chrono::steady_clock::time_point blockStart;
+      const bool timing = tuner && tuner->Trying();
+      if (timing)
+         blockStart = std::chrono::steady_clock::now();
       try
       {
          processed = ProcessBlock(inBufPos.get(), outBufPos.get(), curBlockSize);
@@ -1695,10 +2084,26 @@ bool Effect::ProcessTrack(int count,
       wxASSERT(processed == curBlockSize);
       wxUnusedVar(processed);
 
+      if (timing)
+      {
+         const std::chrono::duration<double> blockTime =
+            std::chrono::steady_clock::now() - blockStart;
+         if (tuner->Account(blockTime.count(), curBlockSize))
+         {
+            // Trials just finished; remember the winner for next time
+            mBlockSizeHint = (int) tuner->Best();
+            SetPrivateConfig(GetCurrentSettingsGroup(),
+               wxT("BlockSizeHint"), mBlockSizeHint);
+         }
+         // Shrinking mid-buffer preserves alignment; growing waits for
+         // the adoption of a fresh buffer above
+         curMaxBlock = std::min(curMaxBlock, tuner->Current());
+      }
+
       // Bump to next input buffer position
       if (inputRemaining != 0)
       {
-         for (size_t i = 0; i < mNumChannels; i++)
+         for (size_t i = 0; i < numChannels; i++)
          {
             inBufPos[i] += curBlockSize;
          }
@@ -1760,35 +2165,47 @@ bool Effect::ProcessTrack(int count,
       // Output buffers have filled
       else
       {
+         // Hand the filled set to the worker to store
+         const auto set = curOutSet;
+         const auto cnt = outputBufferCnt;
+         const auto lpos = outLeftPos, rpos = outRightPos;
          if (isProcessor)
          {
-            // Write them out
-            left->Set((samplePtr) outBuffer[0].get(), floatSample, outLeftPos, outputBufferCnt);
-            if (right)
-            {
-               if (chans >= 2)
-               {
-                  right->Set((samplePtr) outBuffer[1].get(), floatSample, outRightPos, outputBufferCnt);
-               }
-               else
+            writeTickets[set] = io.Post([=]{
+               left->Set((samplePtr) outBufs(set, 0), floatSample, lpos, cnt);
+               if (right)
                {
-                  right->Set((samplePtr) outBuffer[0].get(), floatSample, outRightPos, outputBufferCnt);
+                  if (chans >= 2)
+                  {
+                     right->Set((samplePtr) outBufs(set, 1), floatSample, rpos, cnt);
+                  }
+                  else
+                  {
+                     right->Set((samplePtr) outBufs(set, 0), floatSample, rpos, cnt);
+                  }
                }
-            }
+            });
          }
          else if (isGenerator)
          {
-            genLeft->Append((samplePtr) outBuffer[0].get(), floatSample, outputBufferCnt);
-            if (genRight)
-            {
-               genRight->Append((samplePtr) outBuffer[1].get(), floatSample, outputBufferCnt);
-            }
+            writeTickets[set] = io.Post([=]{
+               genLeft->Append((samplePtr) outBufs(set, 0), floatSample, cnt);
+               if (genRight)
+               {
+                  genRight->Append((samplePtr) outBufs(set, 1), floatSample, cnt);
+               }
+            });
          }
 
+         // Carry on filling the other set, once any earlier store of it
+         // has finished with the memory
+         curOutSet = 1 - curOutSet;
+         io.Wait(writeTickets[curOutSet]);
+
          // Reset the output buffer positions
          for (size_t i = 0; i < chans; i++)
          {
-            outBufPos[i] = outBuffer[i].get();
+            outBufPos[i] = outBufs(curOutSet, i);
          }
 
          // Bump to the next track position
@@ -1797,7 +2214,20 @@ bool Effect::ProcessTrack(int count,
          outputBufferCnt = 0;
       }
 
-      if (mNumChannels > 1)
+      // On a worker thread, the dialog belongs to another thread; report
+      // through the shared atomics and poll for a stop request instead
+      if (pFraction)
+      {
+         pFraction->store(
+            (inLeftPos - leftStart).as_double() /
+            (isGenerator ? genLength : len).as_double());
+         if (pCancel->load())
+         {
+            rc = false;
+            break;
+         }
+      }
+      else if (numChannels > 1)
       {
          if (TrackGroupProgress(count,
                (inLeftPos - leftStart).as_double() /
@@ -1819,34 +2249,46 @@ bool Effect::ProcessTrack(int count,
       }
    }
 
-   // Put any remaining output
+   // Put any remaining output; posted to the worker so that it follows
+   // any store still in flight
    if (rc && outputBufferCnt)
    {
+      const auto set = curOutSet;
+      const auto cnt = outputBufferCnt;
+      const auto lpos = outLeftPos, rpos = outRightPos;
       if (isProcessor)
       {
-         left->Set((samplePtr) outBuffer[0].get(), floatSample, outLeftPos, outputBufferCnt);
-         if (right)
-         {
-            if (chans >= 2)
-            {
-               right->Set((samplePtr) outBuffer[1].get(), floatSample, outRightPos, outputBufferCnt);
-            }
-            else
+         io.Post([=]{
+            left->Set((samplePtr) outBufs(set, 0), floatSample, lpos, cnt);
+            if (right)
             {
-               right->Set((samplePtr) outBuffer[0].get(), floatSample, outRightPos, outputBufferCnt);
+               if (chans >= 2)
+               {
+                  right->Set((samplePtr) outBufs(set, 1), floatSample, rpos, cnt);
+               }
+               else
+               {
+                  right->Set((samplePtr) outBufs(set, 0), floatSample, rpos, cnt);
+               }
             }
-         }
+         });
       }
       else if (isGenerator)
       {
-         genLeft->Append((samplePtr) outBuffer[0].get(), floatSample, outputBufferCnt);
-         if (genRight)
-         {
-            genRight->Append((samplePtr) outBuffer[1].get(), floatSample, outputBufferCnt);
-         }
+         io.Post([=]{
+            genLeft->Append((samplePtr) outBufs(set, 0), floatSample, cnt);
+            if (genRight)
+            {
+               genRight->Append((samplePtr) outBufs(set, 1), floatSample, cnt);
+            }
+         });
       }
    }
 
+   // Drain the pipeline before this thread touches the tracks again;
+   // rethrows if any store failed
+   io.Finish();
+
    if (rc && isGenerator)
    {
       AudacityProject *p = GetActiveProject();
@@ -1886,6 +2328,115 @@ bool Effect::ProcessTrack(int count,
    return rc;
 }
 
+bool Effect::ProcessTrackInterleaved(int count,
+                                     WaveTrack *left,
+                                     WaveTrack *right,
+                                     sampleCount leftStart,
+                                     sampleCount rightStart,
+                                     sampleCount len)
+{
+   bool rc = true;
+
+   // The effect sees one mono stream in which the channel samples happen
+   // to alternate.  Correct only because the effect declared that each
+   // output sample depends on nothing but its own input sample.
+   ChannelName map[2] = { ChannelNameMono, ChannelNameEOL };
+
+   // Give the plugin a chance to initialize
+   if (!ProcessInitialize(len * 2, map))
+   {
+      return false;
+   }
+
+   { // Start scope for cleanup
+   auto cleanup = finally( [&] {
+      // Allow the plugin to cleanup
+      if (!ProcessFinalize())
+      {
+         // In case of non-exceptional flow of control, set rc
+         rc = false;
+      }
+   } );
+
+   // Latency cannot be shifted out of an interleaved stream without the
+   // channels bleeding into each other; the opt-in contract forbids it
+   wxASSERT(GetLatency() == 0);
+
+   // Half a block of frames per channel fills one interleaved block
+   const auto pairLen = mBlockSize / 2;
+
+   Floats leftBuffer{ pairLen };
+   Floats rightBuffer{ pairLen };
+   Floats interleaved{ mBlockSize };
+   Floats processedBuf{ mBlockSize };
+   float *inBufs[1] = { interleaved.get() };
+   float *outBufs[1] = { processedBuf.get() };
+
+   auto inLeftPos = leftStart;
+   auto inRightPos = rightStart;
+   auto inputRemaining = len;
+
+   while (inputRemaining != 0)
+   {
+      const auto blockLen = limitSampleBufferSize( pairLen, inputRemaining );
+
+      left->Get((samplePtr) leftBuffer.get(), floatSample, inLeftPos, blockLen);
+      right->Get((samplePtr) rightBuffer.get(), floatSample, inRightPos, blockLen);
+
+      for (size_t i = 0; i < blockLen; i++)
+      {
+         interleaved[2 * i] = leftBuffer[i];
+         interleaved[2 * i + 1] = rightBuffer[i];
+      }
+
+      // Finally call the plugin to process the block
+      decltype(mBlockSize) processed;
+      try
+      {
+         processed = ProcessBlock(inBufs, outBufs, 2 * blockLen);
+      }
+      catch( const AudacityException & WXUNUSED(e) )
+      {
+         // PRL: Bug 437:
+         // Pass this along to our application-level handler
+         throw;
+      }
+      catch(...)
+      {
+         // PRL:
+         // Exceptions for other reasons, maybe in third-party code...
+         // Continue treating them as we used to, but I wonder if these
+         // should now be treated the same way.
+         return false;
+      }
+      wxASSERT(processed == 2 * blockLen);
+      wxUnusedVar(processed);
+
+      for (size_t i = 0; i < blockLen; i++)
+      {
+         leftBuffer[i] = processedBuf[2 * i];
+         rightBuffer[i] = processedBuf[2 * i + 1];
+      }
+
+      left->Set((samplePtr) leftBuffer.get(), floatSample, inLeftPos, blockLen);
+      right->Set((samplePtr) rightBuffer.get(), floatSample, inRightPos, blockLen);
+
+      inLeftPos += blockLen;
+      inRightPos += blockLen;
+      inputRemaining -= blockLen;
+
+      if (TrackGroupProgress(count,
+            (inLeftPos - leftStart).as_double() / len.as_double()))
+      {
+         rc = false;
+         break;
+      }
+   }
+
+   } // End scope for cleanup
+   return rc;
+}
+
 void Effect::End()
 {
 }
@@ -1996,8 +2547,37 @@ void Effect::IncludeNotSelectedPreviewTracks(bool includeNotSelected)
    mPreviewWithNotSelected = includeNotSelected;
 }
 
+bool Effect::SkipProgressUpdate(double frac)
+{
+   if (!mProgress)
+      return false;
+
+   // Macros and scripted runs opt out of progress displays entirely;
+   // the enclosing command loop reports its own progress
+   if (mIsBatch)
+      return true;
+
+   // The final update always passes, so the dialog completes
+   if (frac >= 1.0)
+      return false;
+
+   // Let at most about 20 updates a second reach the dialog.  Each one
+   // repaints and may yield to the event loop, which for fast effects
+   // with small blocks can cost more than the processing itself.
+   // Clicks on Cancel and Stop are noticed only during a yield, so a
+   // skipped update cannot miss a fresh request.
+   auto now = wxGetUTCTimeMillis().GetValue();
+   if (now - mProgressLastUpdate < 50)
+      return true;
+
+   mProgressLastUpdate = now;
+   return false;
+}
+
 bool Effect::TotalProgress(double frac, const wxString &msg)
 {
+   if (SkipProgressUpdate(frac))
+      return false;
    auto updateResult = (mProgress ?
       mProgress->Update(frac, msg) :
       ProgressResult::Success);
@@ -2006,6 +2586,8 @@ bool Effect::TotalProgress(double frac, const wxString &msg)
 
 bool Effect::TrackProgress(int whichTrack, double frac, const wxString &msg)
 {
+   if (SkipProgressUpdate(frac))
+      return false;
    auto updateResult = (mProgress ?
       mProgress->Update(whichTrack + frac, (double) mNumTracks, msg) :
       ProgressResult::Success);
@@ -2014,6 +2596,8 @@ bool Effect::TrackProgress(int whichTrack, double frac, const wxString &msg)
 
 bool Effect::TrackGroupProgress(int whichGroup, double frac, const wxString &msg)
 {
+   if (SkipProgressUpdate(frac))
+      return false;
    auto updateResult = (mProgress ?
       mProgress->Update(whichGroup + frac, (double) mNumGroups, msg) :
       ProgressResult::Success);
@@ -2273,6 +2857,14 @@ double Effect::CalcPreviewInputLength(double previewLength)
    return previewLength;
 }
 
+wxString Effect::GetPreviewCacheKey()
+{
+   wxString parms;
+   if (!GetAutomationParameters(parms) || parms.empty())
+      return {};
+   return parms;
+}
+
 bool Effect::IsHidden()
 {
    return false;
@@ -2317,6 +2909,30 @@ void Effect::Preview(bool dryOnly)
    if (t1 <= mT0)
       return;
 
+   // A/B comparison of candidate settings replays a cached render of the
+   // same settings and selection, rather than rendering from scratch again
+   wxString renderKey = dryOnly ? wxString{} : GetPreviewCacheKey();
+   if (!renderKey.empty())
+      renderKey = wxString::Format(wxT("%.15g %.15g %d %s"),
+         mT0, t1, (int)mPreviewWithNotSelected, renderKey);
+
+   std::shared_ptr<TrackList> cachedRender;
+   double cachedT1 = 0.0;
+   if (!renderKey.empty()) {
+      for (auto it = mPreviewRenders.begin();
+           it != mPreviewRenders.end(); ++it) {
+         if (it->key == renderKey) {
+            auto entry = *it;
+            // Keep most recently used first
+            mPreviewRenders.erase(it);
+            mPreviewRenders.insert(mPreviewRenders.begin(), entry);
+            cachedRender = entry.tracks;
+            cachedT1 = entry.t1;
+            break;
+         }
+      }
+   }
+
    bool success = true;
 
    auto cleanup = finally( [&] {
@@ -2349,64 +2965,82 @@ void Effect::Preview(bool dryOnly)
       ReplaceProcessedTracks( false );
    } );
 
-   // Build NEW tracklist from rendering tracks
-   auto uTracks = TrackList::Create();
-   mTracks = uTracks.get();
-
-   // Linear Effect preview optimised by pre-mixing to one track.
-   // Generators need to generate per track.
-   if (mIsLinearEffect && !isGenerator) {
-      WaveTrack::Holder mixLeft, mixRight;
-      MixAndRender(saveTracks, mFactory, rate, floatSample, mT0, t1, mixLeft, mixRight);
-      if (!mixLeft)
-         return;
-
-      mixLeft->Offset(-mixLeft->GetStartTime());
-      mixLeft->SetSelected(true);
-      WaveTrackView::Get( *mixLeft )
-         .SetDisplay(WaveTrackViewConstants::NoDisplay);
-      auto pLeft = mTracks->Add( mixLeft );
-      Track *pRight{};
-      if (mixRight) {
-         mixRight->Offset(-mixRight->GetStartTime());
-         mixRight->SetSelected(true);
-         pRight = mTracks->Add( mixRight );
-      }
-      mTracks->GroupChannels(*pLeft, pRight ? 2 : 1);
+   std::shared_ptr<TrackList> uTracks;
+   if (cachedRender) {
+      // Replay the tracks rendered when these settings were last auditioned
+      mTracks = cachedRender.get();
+      mT0 = 0.0;
+      mT1 = cachedT1;
    }
    else {
-      for (auto src : saveTracks->Any< const WaveTrack >()) {
-         if (src->GetSelected() || mPreviewWithNotSelected) {
-            auto dest = src->Copy(mT0, t1);
-            dest->SetSelected(src->GetSelected());
-            WaveTrackView::Get( *static_cast<WaveTrack*>(dest.get()) )
-               .SetDisplay(WaveTrackViewConstants::NoDisplay);
-            mTracks->Add( dest );
+      // Build NEW tracklist from rendering tracks
+      uTracks = TrackList::Create();
+      mTracks = uTracks.get();
+
+      // Linear Effect preview optimised by pre-mixing to one track.
+      // Generators need to generate per track.
+      if (mIsLinearEffect && !isGenerator) {
+         WaveTrack::Holder mixLeft, mixRight;
+         MixAndRender(saveTracks, mFactory, rate, floatSample, mT0, t1, mixLeft, mixRight);
+         if (!mixLeft)
+            return;
+
+         mixLeft->Offset(-mixLeft->GetStartTime());
+         mixLeft->SetSelected(true);
+         WaveTrackView::Get( *mixLeft )
+            .SetDisplay(WaveTrackViewConstants::NoDisplay);
+         auto pLeft = mTracks->Add( mixLeft );
+         Track *pRight{};
+         if (mixRight) {
+            mixRight->Offset(-mixRight->GetStartTime());
+            mixRight->SetSelected(true);
+            pRight = mTracks->Add( mixRight );
+         }
+         mTracks->GroupChannels(*pLeft, pRight ? 2 : 1);
+      }
+      else {
+         for (auto src : saveTracks->Any< const WaveTrack >()) {
+            if (src->GetSelected() || mPreviewWithNotSelected) {
+               auto dest = src->Copy(mT0, t1);
+               dest->SetSelected(src->GetSelected());
+               WaveTrackView::Get( *static_cast<WaveTrack*>(dest.get()) )
+                  .SetDisplay(WaveTrackViewConstants::NoDisplay);
+               mTracks->Add( dest );
+            }
          }
       }
-   }
 
-   // NEW tracks start at time zero.
-   // Adjust mT0 and mT1 to be the times to process, and to
-   // play back in these tracks
-   mT1 -= mT0;
-   mT0 = 0.0;
+      // NEW tracks start at time zero.
+      // Adjust mT0 and mT1 to be the times to process, and to
+      // play back in these tracks
+      mT1 -= mT0;
+      mT0 = 0.0;
 
-   // Update track/group counts
-   CountWaveTracks();
+      // Update track/group counts
+      CountWaveTracks();
+
+      // Apply effect
+      if (!dryOnly) {
+         ProgressDialog progress{
+            GetTranslatedName(),
+            _("Preparing preview"),
+            pdlgHideCancelButton
+         }; // Have only "Stop" button.
+         auto vr = valueRestorer( mProgress, &progress );
 
-   // Apply effect
-   if (!dryOnly) {
-      ProgressDialog progress{
-         GetTranslatedName(),
-         _("Preparing preview"),
-         pdlgHideCancelButton
-      }; // Have only "Stop" button.
-      auto vr = valueRestorer( mProgress, &progress );
+         auto vr2 = valueRestorer( mIsPreview, true );
 
-      auto vr2 = valueRestorer( mIsPreview, true );
+         success = Process();
+      }
+   }
 
-      success = Process();
+   if (success && !renderKey.empty() && !cachedRender) {
+      // Remember the render for the next audition of the same settings
+      mPreviewRenders.insert(mPreviewRenders.begin(),
+         PreviewRender{ renderKey, uTracks, mT1 });
+      const size_t maxPreviewRenders = 4;
+      if (mPreviewRenders.size() > maxPreviewRenders)
+         mPreviewRenders.pop_back();
    }
 
    if (success)
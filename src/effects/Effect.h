@@ -16,6 +16,7 @@
 
 #include "../Experimental.h"
 
+#include <atomic>
 #include <set>
 
 #include <wx/defs.h>
@@ -301,6 +302,20 @@ protected:
    // or amplitude modification
    virtual bool CheckWhetherSkipEffect() { return false; }
 
+   // An effect whose ProcessBlock is stateless -- using no per-track
+   // members across ProcessInitialize / ProcessBlock / ProcessFinalize,
+   // nor the sample rate or mSampleCnt -- may return true to let
+   // ProcessPass dispatch independent tracks to concurrent workers.
+   virtual bool SupportsConcurrentTracks() { return false; }
+
+   // A mono-in, mono-out, zero-latency effect whose output sample depends
+   // only on the corresponding input sample -- no state between samples,
+   // no dependence on channel identity -- may return true to have linked
+   // stereo pairs delivered to ProcessBlock as one interleaved buffer,
+   // halving the pass count on stereo material and keeping SIMD lanes
+   // full.
+   virtual bool SupportsChannelInterleaving() { return false; }
+
    // Actually do the effect here.
    virtual bool Process();
    virtual bool ProcessPass();
@@ -321,6 +336,13 @@ protected:
    // Only override it if you need to do preprocessing or cleanup.
    virtual void Preview(bool dryOnly);
 
+   // Describes the settings of a potential preview render, so that Preview
+   // may replay a cached render when settings already auditioned come back.
+   // Default uses the automation parameters; effects whose sound depends on
+   // state that the parameters do not capture must override.  Empty string
+   // disables the reuse of renders.
+   virtual wxString GetPreviewCacheKey();
+
    virtual void PopulateOrExchange(ShuttleGui & S);
    virtual bool TransferDataToWindow() /* not override */;
    virtual bool TransferDataFromWindow() /* not override */;
@@ -487,7 +509,16 @@ protected:
    void CommonInit();
    void CountWaveTracks();
 
-   // Driver for client effects
+   // Rate limiter for the Progress methods.  Returns true when an update
+   // may be skipped:  at most about 20 a second reach the dialog, none at
+   // all in batch processing, and a final update (frac of at least 1)
+   // always passes.
+   bool SkipProgressUpdate(double frac);
+
+   // Driver for client effects.  When pFraction and pCancel are given, the
+   // call may be made from a worker thread:  progress is then stored
+   // through pFraction instead of updating the dialog, and pCancel is
+   // polled for a stop request.
    bool ProcessTrack(int count,
                      ChannelNames map,
                      WaveTrack *left,
@@ -498,7 +529,29 @@ protected:
                      FloatBuffers &inBuffer,
                      FloatBuffers &outBuffer,
                      ArrayOf< float * > &inBufPos,
-                     ArrayOf< float *> &outBufPos);
+                     ArrayOf< float *> &outBufPos,
+                     unsigned numChannels,
+                     std::atomic<double> *pFraction = nullptr,
+                     std::atomic<bool> *pCancel = nullptr);
+
+   // Used by ProcessPass when the effect reports SupportsConcurrentTracks
+   bool ProcessPassParallel();
+
+   // Used by ProcessPass for a linked stereo pair when the effect reports
+   // SupportsChannelInterleaving:  both channels pass through ProcessBlock
+   // together as one interleaved buffer.
+   bool ProcessTrackInterleaved(int count,
+                                WaveTrack *left,
+                                WaveTrack *right,
+                                sampleCount leftStart,
+                                sampleCount rightStart,
+                                sampleCount len);
+
+   // Negotiate the block size with the client, at most maxBlockSize, but
+   // also no larger than serves the cache, found at run time.  A hint
+   // persisted per effect -- written by the trials that ProcessTrack may
+   // run on the first track -- takes precedence over both.
+   size_t TuneBlockSize(size_t maxBlockSize);
 
  //
  // private data
@@ -510,6 +563,7 @@ private:
 
    bool mIsBatch;
    bool mIsLinearEffect;
+   wxLongLong_t mProgressLastUpdate;
    bool mPreviewWithNotSelected;
    bool mPreviewFullSelection;
 
@@ -519,6 +573,15 @@ private:
 
    bool mIsPreview;
 
+   // Preview renders kept for reuse when the same settings and selection
+   // are auditioned again, most recently used first
+   struct PreviewRender {
+      wxString key;
+      std::shared_ptr<TrackList> tracks;
+      double t1;
+   };
+   std::vector<PreviewRender> mPreviewRenders;
+
    bool mUIDebug;
 
    std::vector<Track*> mIMap;
@@ -534,6 +597,7 @@ private:
 
    size_t mBufferSize;
    size_t mBlockSize;
+   int mBlockSizeHint; // from the private configuration; 0 when absent
    unsigned mNumChannels;
 
    const static wxString kUserPresetIdent;
@@ -209,7 +209,9 @@ void EffectManager::UnregisterEffect(const PluginID & ID)
    }
 
    // PRL:  RedrawProject explicitly because sometimes history push is skipped
-   window.RedrawProject();
+   // In batch mode, skip it; one redraw happens when the whole macro is done
+   if (project.mBatchMode == 0)
+      window.RedrawProject();
 
    if (focus != nullptr && focus->GetParent()==parent) {
       focus->SetFocus();
@@ -299,17 +301,23 @@ wxString EffectManager::GetCommandName(const PluginID & ID)
 
 wxString EffectManager::GetEffectFamilyName(const PluginID & ID)
 {
-   auto effect = GetEffect(ID);
-   if (effect)
-      return effect->GetFamily().Translation();
+   // Called when building and sorting the effect menus, once for every
+   // registered plugin.  Answer from the registry descriptor; going
+   // through GetEffect here would instantiate every effect at startup
+   // just to group its menu item.
+   const PluginDescriptor *plug = PluginManager::Get().GetPlugin(ID);
+   if (plug)
+      return ComponentInterfaceSymbol{ plug->GetEffectFamily() }.Translation();
    return {};
 }
 
 wxString EffectManager::GetVendorName(const PluginID & ID)
 {
-   auto effect = GetEffect(ID);
-   if (effect)
-      return effect->GetVendor().Translation();
+   // As above, answer from the descriptor to keep menu building from
+   // instantiating the effects it lists.
+   const PluginDescriptor *plug = PluginManager::Get().GetPlugin(ID);
+   if (plug)
+      return ComponentInterfaceSymbol{ plug->GetVendor() }.Translation();
    return {};
 }
 
@@ -58,6 +58,9 @@
 #include "../Experimental.h"
 
 #include <math.h>
+#include <atomic>
+#include <exception>
+#include <thread>
 #include <vector>
 
 #include <wx/setup.h> // for wxUSE_* macros
@@ -225,8 +228,7 @@ BEGIN_EVENT_TABLE(EffectEqualization, wxEvtHandler)
 END_EVENT_TABLE()
 
 EffectEqualization::EffectEqualization(int Options)
-   : mFFTBuffer{ windowSize }
-   , mFilterFuncR{ windowSize }
+   : mFilterFuncR{ windowSize }
    , mFilterFuncI{ windowSize }
 {
    mOptions = Options;
@@ -660,6 +662,26 @@ bool EffectEqualization::Init()
    return(true);
 }
 
+wxString EffectEqualization::GetPreviewCacheKey()
+{
+   wxString key = Effect::GetPreviewCacheKey();
+   if (key.empty())
+      return key;
+
+   // The automation parameters name a curve but do not capture its shape;
+   // append the envelope points so that edits to the curve are told apart
+   size_t numPoints = mEnvelope->GetNumberOfPoints();
+   if (numPoints > 0) {
+      Doubles when{ numPoints };
+      Doubles value{ numPoints };
+      mEnvelope->GetPoints(when.get(), value.get(), numPoints);
+      for (size_t i = 0; i < numPoints; i++)
+         key += wxString::Format(wxT(" %g,%g"), when[i], value[i]);
+   }
+
+   return key;
+}
+
 bool EffectEqualization::Process()
 {
 #ifdef EXPERIMENTAL_EQ_SSE_THREADED
@@ -676,6 +698,9 @@ bool EffectEqualization::Process()
    CalcFilter();
    bool bGoodResult = true;
 
+   struct Spec { int count; WaveTrack *track; sampleCount start; sampleCount len; };
+   std::vector<Spec> specs;
+
    int count = 0;
    for( auto track : mOutputTracks->Selected< WaveTrack >() ) {
       double trackStart = track->GetStartTime();
@@ -686,16 +711,90 @@ bool EffectEqualization::Process()
       if (t1 > t0) {
          auto start = track->TimeToLongSamples(t0);
          auto end = track->TimeToLongSamples(t1);
-         auto len = end - start;
+         specs.push_back({ count, track, start, end - start });
+      }
 
-         if (!ProcessOne(count, track, start, len))
+      count++;
+   }
+
+   if (specs.size() < 2 || std::thread::hardware_concurrency() <= 1) {
+      for (const auto &spec : specs)
+         if (!ProcessOne(spec.count, spec.track, spec.start, spec.len))
          {
             bGoodResult = false;
             break;
          }
+   }
+   else {
+      // Each track is filtered independently against the same curve, so
+      // tracks can be processed concurrently.  Workers steal the next
+      // unprocessed track and report through atomics; only this thread
+      // touches the progress dialog, and only this thread pastes the
+      // filtered audio back into the tracks.
+      const unsigned nWorkers = std::min<unsigned>(
+         (unsigned)specs.size(), std::thread::hardware_concurrency() );
+
+      std::atomic<size_t> nextSpec{ 0 };
+      std::atomic<bool> cancel{ false };
+      std::atomic<bool> good{ true };
+      std::atomic<unsigned> busy{ nWorkers };
+      ArrayOf<std::atomic<double>> fractions{ specs.size(), true };
+      std::vector<std::exception_ptr> exceptions( nWorkers );
+      std::vector<std::shared_ptr<WaveTrack>> outputs( specs.size() );
+
+      auto work = [&](unsigned ii) {
+         auto cleanup = finally( [&]{ --busy; } );
+         try {
+            for (;;) {
+               auto index = nextSpec++;
+               if (index >= specs.size() || cancel.load())
+                  break;
+               auto &spec = specs[index];
+               if (!ProcessOne(spec.count, spec.track, spec.start, spec.len,
+                     &fractions[index], &cancel, &outputs[index])) {
+                  good.store(false);
+                  cancel.store(true);
+                  break;
+               }
+               fractions[index].store(1.0);
+            }
+         }
+         catch (...) {
+            exceptions[ii] = std::current_exception();
+            cancel.store(true);
+         }
+      };
+
+      std::vector<std::thread> workers;
+      workers.reserve(nWorkers);
+      for (unsigned ii = 0; ii < nWorkers; ii++)
+         workers.emplace_back(work, ii);
+
+      // Poll aggregated progress until the workers drain the queue
+      while (busy.load()) {
+         wxMilliSleep(50);
+         double sum = 0;
+         for (size_t i = 0; i < specs.size(); i++)
+            sum += fractions[i].load();
+         if (TotalProgress(sum / specs.size()))
+            cancel.store(true);
       }
 
-      count++;
+      for (auto &worker : workers)
+         worker.join();
+
+      for (auto &pException : exceptions)
+         if (pException)
+            std::rethrow_exception(pException);
+
+      bGoodResult = good.load() && !cancel.load();
+
+      if (bGoodResult)
+         // Paste the filtered audio back into the tracks on this thread
+         for (size_t i = 0; i < specs.size(); i++)
+            if (outputs[i])
+               PasteOutput(specs[i].track, outputs[i].get(),
+                           specs[i].start, specs[i].len);
    }
 
    this->ReplaceProcessedTracks(bGoodResult);
@@ -1234,7 +1333,10 @@ bool EffectEqualization::TransferDataFromWindow()
 // EffectEqualization implementation
 
 bool EffectEqualization::ProcessOne(int count, WaveTrack * t,
-                                    sampleCount start, sampleCount len)
+                                    sampleCount start, sampleCount len,
+                                    std::atomic<double> *pFraction,
+                                    std::atomic<bool> *pCancel,
+                                    std::shared_ptr<WaveTrack> *pOutput)
 {
    // create a NEW WaveTrack to hold all of the output, including 'tails' each end
    AudacityProject *p = GetActiveProject();
@@ -1249,6 +1351,9 @@ bool EffectEqualization::ProcessOne(int count, WaveTrack * t,
 
    Floats buffer{ idealBlockLen };
 
+   // Scratch for Filter(), local so that concurrent calls do not collide
+   Floats fftBuffer{ windowSize };
+
    Floats window1{ windowSize };
    Floats window2{ windowSize };
    float *thisWindow = window1.get();
@@ -1259,7 +1364,8 @@ bool EffectEqualization::ProcessOne(int count, WaveTrack * t,
    for(size_t i = 0; i < windowSize; i++)
       lastWindow[i] = 0;
 
-   TrackProgress(count, 0.);
+   if (!pFraction)
+      TrackProgress(count, 0.);
    bool bLoopSuccess = true;
    size_t wcopy = 0;
    int offset = (mM - 1) / 2;
@@ -1278,7 +1384,7 @@ bool EffectEqualization::ProcessOne(int count, WaveTrack * t,
          for(auto j = wcopy; j < windowSize; j++)
             thisWindow[j] = 0;   //this includes the padding
 
-         Filter(windowSize, thisWindow);
+         Filter(windowSize, thisWindow, fftBuffer.get());
 
          // Overlap - Add
          for(size_t j = 0; (j < mM - 1) && (j < wcopy); j++)
@@ -1293,8 +1399,19 @@ bool EffectEqualization::ProcessOne(int count, WaveTrack * t,
       len -= block;
       s += block;
 
-      if (TrackProgress(count, ( s - start ).as_double() /
-                        originalLen.as_double()))
+      if (pFraction) {
+         // On a worker thread; the main thread reads the fraction and
+         // polls the dialog
+         pFraction->store(
+            ( s - start ).as_double() / originalLen.as_double() );
+         if (pCancel->load())
+         {
+            bLoopSuccess = false;
+            break;
+         }
+      }
+      else if (TrackProgress(count, ( s - start ).as_double() /
+                             originalLen.as_double()))
       {
          bLoopSuccess = false;
          break;
@@ -1321,65 +1438,77 @@ bool EffectEqualization::ProcessOne(int count, WaveTrack * t,
       output->Append((samplePtr)buffer.get(), floatSample, mM - 1);
       output->Flush();
 
-      // now move the appropriate bit of the output back to the track
-      // (this could be enhanced in the future to use the tails)
-      double offsetT0 = t->LongSamplesToTime(offset);
-      double lenT = t->LongSamplesToTime(originalLen);
-      // 'start' is the sample offset in 't', the passed in track
-      // 'startT' is the equivalent time value
-      // 'output' starts at zero
-      double startT = t->LongSamplesToTime(start);
-
-      //output has one waveclip for the total length, even though
-      //t might have whitespace seperating multiple clips
-      //we want to maintain the original clip structure, so
-      //only paste the intersections of the NEW clip.
-
-      //Find the bits of clips that need replacing
-      std::vector<std::pair<double, double> > clipStartEndTimes;
-      std::vector<std::pair<double, double> > clipRealStartEndTimes; //the above may be truncated due to a clip being partially selected
-      for (const auto &clip : t->GetClips())
-      {
-         double clipStartT;
-         double clipEndT;
-
-         clipStartT = clip->GetStartTime();
-         clipEndT = clip->GetEndTime();
-         if( clipEndT <= startT )
-            continue;   // clip is not within selection
-         if( clipStartT >= startT + lenT )
-            continue;   // clip is not within selection
+      if (pOutput)
+         // The caller pastes it back into the track on the main thread
+         *pOutput = std::move(output);
+      else
+         PasteOutput(t, output.get(), start, originalLen);
+   }
 
-         //save the actual clip start/end so that we can rejoin them after we paste.
-         clipRealStartEndTimes.push_back(std::pair<double,double>(clipStartT,clipEndT));
+   return bLoopSuccess;
+}
 
-         if( clipStartT < startT )  // does selection cover the whole clip?
-            clipStartT = startT; // don't copy all the NEW clip
-         if( clipEndT > startT + lenT )  // does selection cover the whole clip?
-            clipEndT = startT + lenT; // don't copy all the NEW clip
+void EffectEqualization::PasteOutput(WaveTrack *t, WaveTrack *output,
+                                     sampleCount start, sampleCount len)
+{
+   int offset = (mM - 1) / 2;
 
-         //save them
-         clipStartEndTimes.push_back(std::pair<double,double>(clipStartT,clipEndT));
-      }
-      //now go thru and replace the old clips with NEW
-      for(unsigned int i = 0; i < clipStartEndTimes.size(); i++)
-      {
-         //remove the old audio and get the NEW
-         t->Clear(clipStartEndTimes[i].first,clipStartEndTimes[i].second);
-         auto toClipOutput = output->Copy(clipStartEndTimes[i].first-startT+offsetT0,clipStartEndTimes[i].second-startT+offsetT0);
-         //put the processed audio in
-         t->Paste(clipStartEndTimes[i].first, toClipOutput.get());
-         //if the clip was only partially selected, the Paste will have created a split line.  Join is needed to take care of this
-         //This is not true when the selection is fully contained within one clip (second half of conditional)
-         if( (clipRealStartEndTimes[i].first  != clipStartEndTimes[i].first ||
-            clipRealStartEndTimes[i].second != clipStartEndTimes[i].second) &&
-            !(clipRealStartEndTimes[i].first <= startT &&
-            clipRealStartEndTimes[i].second >= startT+lenT) )
-            t->Join(clipRealStartEndTimes[i].first,clipRealStartEndTimes[i].second);
-      }
+   // now move the appropriate bit of the output back to the track
+   // (this could be enhanced in the future to use the tails)
+   double offsetT0 = t->LongSamplesToTime(offset);
+   double lenT = t->LongSamplesToTime(len);
+   // 'start' is the sample offset in 't', the passed in track
+   // 'startT' is the equivalent time value
+   // 'output' starts at zero
+   double startT = t->LongSamplesToTime(start);
+
+   //output has one waveclip for the total length, even though
+   //t might have whitespace seperating multiple clips
+   //we want to maintain the original clip structure, so
+   //only paste the intersections of the NEW clip.
+
+   //Find the bits of clips that need replacing
+   std::vector<std::pair<double, double> > clipStartEndTimes;
+   std::vector<std::pair<double, double> > clipRealStartEndTimes; //the above may be truncated due to a clip being partially selected
+   for (const auto &clip : t->GetClips())
+   {
+      double clipStartT;
+      double clipEndT;
+
+      clipStartT = clip->GetStartTime();
+      clipEndT = clip->GetEndTime();
+      if( clipEndT <= startT )
+         continue;   // clip is not within selection
+      if( clipStartT >= startT + lenT )
+         continue;   // clip is not within selection
+
+      //save the actual clip start/end so that we can rejoin them after we paste.
+      clipRealStartEndTimes.push_back(std::pair<double,double>(clipStartT,clipEndT));
+
+      if( clipStartT < startT )  // does selection cover the whole clip?
+         clipStartT = startT; // don't copy all the NEW clip
+      if( clipEndT > startT + lenT )  // does selection cover the whole clip?
+         clipEndT = startT + lenT; // don't copy all the NEW clip
+
+      //save them
+      clipStartEndTimes.push_back(std::pair<double,double>(clipStartT,clipEndT));
+   }
+   //now go thru and replace the old clips with NEW
+   for(unsigned int i = 0; i < clipStartEndTimes.size(); i++)
+   {
+      //remove the old audio and get the NEW
+      t->Clear(clipStartEndTimes[i].first,clipStartEndTimes[i].second);
+      auto toClipOutput = output->Copy(clipStartEndTimes[i].first-startT+offsetT0,clipStartEndTimes[i].second-startT+offsetT0);
+      //put the processed audio in
+      t->Paste(clipStartEndTimes[i].first, toClipOutput.get());
+      //if the clip was only partially selected, the Paste will have created a split line.  Join is needed to take care of this
+      //This is not true when the selection is fully contained within one clip (second half of conditional)
+      if( (clipRealStartEndTimes[i].first  != clipStartEndTimes[i].first ||
+         clipRealStartEndTimes[i].second != clipStartEndTimes[i].second) &&
+         !(clipRealStartEndTimes[i].first <= startT &&
+         clipRealStartEndTimes[i].second >= startT+lenT) )
+         t->Join(clipRealStartEndTimes[i].first,clipRealStartEndTimes[i].second);
    }
-
-   return bLoopSuccess;
 }
 
 bool EffectEqualization::CalcFilter()
@@ -1495,7 +1624,7 @@ bool EffectEqualization::CalcFilter()
    return TRUE;
 }
 
-void EffectEqualization::Filter(size_t len, float *buffer)
+void EffectEqualization::Filter(size_t len, float *buffer, float *scratch)
 {
    float re,im;
    // Apply FFT
@@ -1504,20 +1633,20 @@ void EffectEqualization::Filter(size_t len, float *buffer)
 
    // Apply filter
    // DC component is purely real
-   mFFTBuffer[0] = buffer[0] * mFilterFuncR[0];
+   scratch[0] = buffer[0] * mFilterFuncR[0];
    for(size_t i = 1; i < (len / 2); i++)
    {
       re=buffer[hFFT->BitReversed[i]  ];
       im=buffer[hFFT->BitReversed[i]+1];
-      mFFTBuffer[2*i  ] = re*mFilterFuncR[i] - im*mFilterFuncI[i];
-      mFFTBuffer[2*i+1] = re*mFilterFuncI[i] + im*mFilterFuncR[i];
+      scratch[2*i  ] = re*mFilterFuncR[i] - im*mFilterFuncI[i];
+      scratch[2*i+1] = re*mFilterFuncI[i] + im*mFilterFuncR[i];
    }
    // Fs/2 component is purely real
-   mFFTBuffer[1] = buffer[1] * mFilterFuncR[len/2];
+   scratch[1] = buffer[1] * mFilterFuncR[len/2];
 
    // Inverse FFT and normalization
-   InverseRealFFTf(mFFTBuffer.get(), hFFT.get());
-   ReorderToTime(hFFT.get(), mFFTBuffer.get(), buffer);
+   InverseRealFFTf(scratch, hFFT.get());
+   ReorderToTime(hFFT.get(), scratch, buffer);
 }
 
 //
@@ -134,6 +134,7 @@ public:
    bool Startup() override;
    bool Init() override;
    bool Process() override;
+   wxString GetPreviewCacheKey() override;
 
    bool PopulateUI(wxWindow *parent) override;
    bool CloseUI() override;
@@ -153,9 +154,17 @@ private:
    enum {loFreqI=20};
 
    bool ProcessOne(int count, WaveTrack * t,
-                   sampleCount start, sampleCount len);
+                   sampleCount start, sampleCount len,
+                   // When processing on a worker thread, progress and
+                   // cancellation go through atomics, and the filtered
+                   // track is stored for the main thread to paste in
+                   std::atomic<double> *pFraction = nullptr,
+                   std::atomic<bool> *pCancel = nullptr,
+                   std::shared_ptr<WaveTrack> *pOutput = nullptr);
+   void PasteOutput(WaveTrack *t, WaveTrack *output,
+                    sampleCount start, sampleCount len);
    bool CalcFilter();
-   void Filter(size_t len, float *buffer);
+   void Filter(size_t len, float *buffer, float *scratch);
    
    void Flatten();
    void ForceRecalc();
@@ -212,7 +221,7 @@ private:
 private:
    int mOptions;
    HFFT hFFT;
-   Floats mFFTBuffer, mFilterFuncR, mFilterFuncI;
+   Floats mFilterFuncR, mFilterFuncI;
    size_t mM;
    wxString mCurveName;
    bool mLin;
@@ -22,10 +22,14 @@
 #include "../Audacity.h"
 #include "FindClipping.h"
 
+#include <algorithm>
+#include <vector>
+
 #include <math.h>
 
 #include <wx/intl.h>
 
+#include "../Sequence.h"
 #include "../Shuttle.h"
 #include "../ShuttleGui.h"
 #include "../widgets/valnum.h"
@@ -180,6 +184,7 @@ bool EffectFindClipping::ProcessOne(LabelTrack * lt,
    decltype(len) s = 0, startrun = 0, stoprun = 0, samps = 0;
    decltype(blockSize) block = 0;
    double startTime = -1.0;
+   std::vector<SummaryFrame> frames;
 
    while (s < len) {
       if (block == 0) {
@@ -192,10 +197,66 @@ bool EffectFindClipping::ProcessOne(LabelTrack * lt,
 
          block = limitSampleBufferSize( blockSize, len - s );
 
+         // Summary pruning:  the min/max summaries bound every sample of
+         // the chunk, so one that stays below full scale throughout
+         // cannot contain clipping, and its samples need not be read
+         frames.clear();
+         if (wt->GetSummaries256(start + s, block, frames)) {
+            bool mayClip = false;
+            for (auto &frame : frames) {
+               if (frame.max >= MAX_AUDIO || -frame.min >= MAX_AUDIO) {
+                  mayClip = true;
+                  break;
+               }
+            }
+            if (!mayClip) {
+               // Apply the run state machine to the whole chunk of
+               // below-scale samples at once
+               if (startrun >= mStart) {
+                  // An open run:  it closes if enough stop samples fit
+                  // in this chunk
+                  auto need = sampleCount( mStop ) - stoprun;
+                  if (sampleCount( block ) >= need) {
+                     lt->AddLabel(SelectedRegion(startTime,
+                                 wt->LongSamplesToTime(start + s + need - 1 - mStop)),
+                           wxString::Format(wxT("%lld of %lld"), startrun.as_long_long(), (samps + need - mStop).as_long_long()));
+                     startrun = 0;
+                     stoprun = 0;
+                     samps = 0;
+                  }
+                  else {
+                     stoprun += block;
+                     samps += block;
+                  }
+               }
+               else {
+                  startrun = 0;
+               }
+               s += block;
+               block = 0;
+               continue;
+            }
+         }
+
          wt->Get((samplePtr)buffer.get(), floatSample, start + s, block);
          ptr = buffer.get();
       }
 
+      // While no run is open, skip over samples below full scale sixteen
+      // at a time, with a scan that the compiler can vectorize
+      while (startrun == 0 && block >= 16) {
+         float peak = 0;
+         for (unsigned i = 0; i < 16; i++)
+            peak = std::max(peak, fabsf(ptr[i]));
+         if (peak >= MAX_AUDIO)
+            break;
+         ptr += 16;
+         s += 16;
+         block -= 16;
+      }
+      if (block == 0)
+         continue;
+
       float v = fabs(*ptr++);
       if (v >= MAX_AUDIO) {
          if (startrun == 0) {
@@ -75,3 +75,18 @@ size_t EffectInvert::ProcessBlock(float **inBlock, float **outBlock, size_t bloc
 
    return blockLen;
 }
+
+// Effect implementation
+
+bool EffectInvert::SupportsConcurrentTracks()
+{
+   // ProcessBlock is stateless, so tracks may be processed in parallel
+   return true;
+}
+
+bool EffectInvert::SupportsChannelInterleaving()
+{
+   // Negating each sample independently, with no latency, so a stereo pair
+   // may be processed as one interleaved stream
+   return true;
+}
@@ -63,6 +63,7 @@ EffectNoise::EffectNoise()
    SetLinearEffectFlag(true);
 
    y = z = buf0 = buf1 = buf2 = buf3 = buf4 = buf5 = buf6 = 0;
+   mRandState = 0;
 }
 
 EffectNoise::~EffectNoise()
@@ -106,7 +107,20 @@ size_t EffectNoise::ProcessBlock(float **WXUNUSED(inbuf), float **outbuf, size_t
 
    float white;
    float amplitude;
-   float div = ((float) RAND_MAX) / 2.0f;
+
+   // An xorshift generator batches white samples far faster than a
+   // rand() call per sample; it is seeded from rand() once, so runs
+   // still differ from each other as they used to
+   if (mRandState == 0)
+      mRandState = (unsigned) rand() + 1;
+   auto state = mRandState;
+   auto nextWhite = [&state]() {
+      state ^= state << 13;
+      state ^= state >> 17;
+      state ^= state << 5;
+      // bring the high 24 bits into [-1, 1)
+      return (state >> 8) / 8388608.0f - 1.0f;
+   };
 
    switch (mType)
    {
@@ -114,7 +128,7 @@ size_t EffectNoise::ProcessBlock(float **WXUNUSED(inbuf), float **outbuf, size_t
    case kWhite: // white
        for (decltype(size) i = 0; i < size; i++)
        {
-          buffer[i] = mAmp * ((rand() / div) - 1.0f);
+          buffer[i] = mAmp * nextWhite();
        }
        break;
 
@@ -125,7 +139,7 @@ size_t EffectNoise::ProcessBlock(float **WXUNUSED(inbuf), float **outbuf, size_t
       amplitude = mAmp * 0.129f;
       for (decltype(size) i = 0; i < size; i++)
       {
-         white = (rand() / div) - 1.0f;
+         white = nextWhite();
          buf0 = 0.99886f * buf0 + 0.0555179f * white;
          buf1 = 0.99332f * buf1 + 0.0750759f * white;
          buf2 = 0.96900f * buf2 + 0.1538520f * white;
@@ -152,7 +166,7 @@ size_t EffectNoise::ProcessBlock(float **WXUNUSED(inbuf), float **outbuf, size_t
  
       for (decltype(size) i = 0; i < size; i++)
       {
-         white = (rand() / div) - 1.0f;
+         white = nextWhite();
          z = leakage * y + white * scaling;
          y = fabs(z) > 1.0
             ? leakage * y - white * scaling
@@ -162,6 +176,8 @@ size_t EffectNoise::ProcessBlock(float **WXUNUSED(inbuf), float **outbuf, size_t
       break;
    }
 
+   mRandState = state;
+
    return size;
 }
 bool EffectNoise::DefineParams( ShuttleParams & S ){
@@ -59,6 +59,7 @@ private:
    double mAmp;
 
    float y, z, buf0, buf1, buf2, buf3, buf4, buf5, buf6;
+   unsigned mRandState;
 
    NumericTextCtrl *mNoiseDurationT;
 };
@@ -53,6 +53,9 @@
 #include "../widgets/valnum.h"
 
 #include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
 #include <vector>
 #include <math.h>
 
@@ -69,6 +72,7 @@
 #include <wx/valtext.h>
 #include <wx/textctrl.h>
 #include <wx/sizer.h>
+#include <wx/utils.h>
 
 // SPECTRAL_SELECTION not to affect this effect for now, as there might be no indication that it does.
 // [Discussed and agreed for v2.1 by Steve, Paul, Bill].
@@ -274,7 +278,13 @@ private:
                    Statistics &statistics,
                    TrackFactory &factory,
                    int count, WaveTrack *track,
-                   sampleCount start, sampleCount len);
+                   sampleCount start, sampleCount len,
+                   // When processing on a worker thread, progress and
+                   // cancellation go through atomics, and the processed
+                   // track is stored for the main thread to splice in
+                   std::atomic<double> *pFraction = nullptr,
+                   std::atomic<bool> *pCancel = nullptr,
+                   WaveTrack::Holder *pOutput = nullptr);
 
    void StartNewTrack();
    void ProcessSamples(Statistics &statistics,
@@ -603,6 +613,20 @@ bool EffectNoiseReduction::Settings::Validate(EffectNoiseReduction *effect) cons
    return true;
 }
 
+wxString EffectNoiseReduction::GetPreviewCacheKey()
+{
+   // Not automatable, so describe the settings directly.  The noise
+   // profile cannot change while the dialog is open, so it need not be
+   // part of the key.
+   const auto &s = *mSettings;
+   return wxString::Format(
+      wxT("%g %g %g %g %g %g %d %d %d %d %d"),
+      s.mNewSensitivity, s.mFreqSmoothingBands, s.mNoiseGain,
+      s.mAttackTime, s.mReleaseTime, s.mOldSensitivity,
+      s.mNoiseReductionChoice, s.mWindowTypes, s.mWindowSizeChoice,
+      s.mStepsPerWindowChoice, s.mMethod);
+}
+
 bool EffectNoiseReduction::Process()
 {
    // This same code will either reduce noise or profile it
@@ -655,6 +679,9 @@ bool EffectNoiseReduction::Worker::Process
 (EffectNoiseReduction &effect, Statistics &statistics, TrackFactory &factory,
  TrackList &tracks, double inT0, double inT1)
 {
+   struct Spec { int count; WaveTrack *track; sampleCount start; sampleCount len; };
+   std::vector<Spec> specs;
+
    int count = 0;
    for ( auto track : tracks.Selected< WaveTrack >() ) {
       if (track->GetRate() != mSampleRate) {
@@ -674,12 +701,103 @@ bool EffectNoiseReduction::Worker::Process
          auto start = track->TimeToLongSamples(t0);
          auto end = track->TimeToLongSamples(t1);
          auto len = end - start;
+         specs.push_back({ count, track, start, len });
+      }
+      ++count;
+   }
 
+   // Profiling accumulates all windows into one set of statistics, and the
+   // history queue makes each window depend on its neighbors, so a single
+   // track is necessarily serial.  But reducing noise reads the statistics
+   // only, so different tracks can be processed concurrently.
+   if (mDoProfile || specs.size() < 2 ||
+       std::thread::hardware_concurrency() <= 1) {
+      for (const auto &spec : specs)
          if (!ProcessOne(effect, statistics, factory,
-                         count, track, start, len))
+                         spec.count, spec.track, spec.start, spec.len))
             return false;
+   }
+   else {
+      const unsigned nWorkers = std::min<unsigned>(
+         (unsigned)specs.size(), std::thread::hardware_concurrency() );
+
+      // Workers steal the next unprocessed track and report through
+      // atomics; only this thread touches the progress dialog, and only
+      // this thread splices the finished tracks into the track list.
+      std::atomic<size_t> nextSpec{ 0 };
+      std::atomic<bool> cancel{ false };
+      std::atomic<bool> good{ true };
+      std::atomic<unsigned> busy{ nWorkers };
+      ArrayOf<std::atomic<double>> fractions{ specs.size(), true };
+      std::vector<std::exception_ptr> exceptions( nWorkers );
+      std::vector<WaveTrack::Holder> outputs( specs.size() );
+
+      auto work = [&](unsigned ii) {
+         auto cleanup = finally( [&]{ --busy; } );
+         try {
+            // Each worker needs a history queue and buffers of its own
+            Worker worker{ *effect.mSettings, mSampleRate
+#ifdef EXPERIMENTAL_SPECTRAL_EDITING
+                           , effect.mF0, effect.mF1
+#endif
+            };
+            for (;;) {
+               auto index = nextSpec++;
+               if (index >= specs.size() || cancel.load())
+                  break;
+               auto &spec = specs[index];
+               if (!worker.ProcessOne(effect, statistics, factory,
+                     spec.count, spec.track, spec.start, spec.len,
+                     &fractions[index], &cancel, &outputs[index])) {
+                  good.store(false);
+                  cancel.store(true);
+                  break;
+               }
+               fractions[index].store(1.0);
+            }
+         }
+         catch (...) {
+            exceptions[ii] = std::current_exception();
+            cancel.store(true);
+         }
+      };
+
+      std::vector<std::thread> workers;
+      workers.reserve(nWorkers);
+      for (unsigned ii = 0; ii < nWorkers; ii++)
+         workers.emplace_back(work, ii);
+
+      // Poll aggregated progress until the workers drain the queue
+      while (busy.load()) {
+         wxMilliSleep(50);
+         double sum = 0;
+         for (size_t i = 0; i < specs.size(); i++)
+            sum += fractions[i].load();
+         if (effect.TotalProgress(sum / specs.size()))
+            cancel.store(true);
+      }
+
+      for (auto &worker : workers)
+         worker.join();
+
+      for (auto &pException : exceptions)
+         if (pException)
+            std::rethrow_exception(pException);
+
+      if (!good.load() || cancel.load())
+         return false;
+
+      // Take the output tracks and insert them in place of the original
+      // sample data
+      for (size_t i = 0; i < specs.size(); i++) {
+         auto &spec = specs[i];
+         auto &output = outputs[i];
+         if (output) {
+            double t0 = output->LongSamplesToTime(spec.start);
+            double tLen = output->LongSamplesToTime(spec.len);
+            spec.track->ClearAndPaste(t0, t0 + tLen, &*output, true, false);
+         }
       }
-      ++count;
    }
 
    if (mDoProfile) {
@@ -1196,15 +1314,14 @@ void EffectNoiseReduction::Worker::ReduceNoise
       // be visited again when we examine the next window, and
       // carry the decay further.
       {
+         // Indexed, so that the loop vectorizes
          float *pNextGain = &mQueue[mCenter - 1]->mGains[0];
          const float *pThisGain = &mQueue[mCenter]->mGains[0];
-         for (int nn = mSpectrumSize; nn--;) {
-            *pNextGain =
-               std::max(*pNextGain,
+         for (size_t nn = 0; nn < mSpectrumSize; ++nn)
+            pNextGain[nn] =
+               std::max(pNextGain[nn],
                         std::max(mNoiseAttenFactor,
-                                 *pThisGain++ * mOneBlockRelease));
-            ++pNextGain;
-         }
+                                 pThisGain[nn] * mOneBlockRelease));
       }
    }
 
@@ -1220,28 +1337,29 @@ void EffectNoiseReduction::Worker::ReduceNoise
 
       // Apply gain to FFT
       {
+         // Indexed, so that the loops vectorize
          const float *pGain = &record.mGains[1];
          const float *pReal = &record.mRealFFTs[1];
          const float *pImag = &record.mImagFFTs[1];
          float *pBuffer = &mFFTBuffer[2];
-         auto nn = mSpectrumSize - 2;
+         const auto nn = mSpectrumSize - 2;
          if (mNoiseReductionChoice == NRC_LEAVE_RESIDUE) {
-            for (; nn--;) {
+            for (size_t ii = 0; ii < nn; ++ii) {
                // Subtract the gain we would otherwise apply from 1, and
                // negate that to flip the phase.
-               const double gain = *pGain++ - 1.0;
-               *pBuffer++ = *pReal++ * gain;
-               *pBuffer++ = *pImag++ * gain;
+               const double gain = pGain[ii] - 1.0;
+               pBuffer[2 * ii] = pReal[ii] * gain;
+               pBuffer[2 * ii + 1] = pImag[ii] * gain;
             }
             mFFTBuffer[0] = record.mRealFFTs[0] * (record.mGains[0] - 1.0);
             // The Fs/2 component is stored as the imaginary part of the DC component
             mFFTBuffer[1] = record.mImagFFTs[0] * (record.mGains[last] - 1.0);
          }
          else {
-            for (; nn--;) {
-               const double gain = *pGain++;
-               *pBuffer++ = *pReal++ * gain;
-               *pBuffer++ = *pImag++ * gain;
+            for (size_t ii = 0; ii < nn; ++ii) {
+               const double gain = pGain[ii];
+               pBuffer[2 * ii] = pReal[ii] * gain;
+               pBuffer[2 * ii + 1] = pImag[ii] * gain;
             }
             mFFTBuffer[0] = record.mRealFFTs[0] * record.mGains[0];
             // The Fs/2 component is stored as the imaginary part of the DC component
@@ -1287,7 +1405,9 @@ void EffectNoiseReduction::Worker::ReduceNoise
 
 bool EffectNoiseReduction::Worker::ProcessOne
 (EffectNoiseReduction &effect,  Statistics &statistics, TrackFactory &factory,
- int count, WaveTrack * track, sampleCount start, sampleCount len)
+ int count, WaveTrack * track, sampleCount start, sampleCount len,
+ std::atomic<double> *pFraction, std::atomic<bool> *pCancel,
+ WaveTrack::Holder *pOutput)
 {
    if (track == NULL)
       return false;
@@ -1318,10 +1438,18 @@ bool EffectNoiseReduction::Worker::ProcessOne
       ProcessSamples(statistics, outputTrack.get(), blockSize, &buffer[0]);
 
       // Update the Progress meter, let user cancel
-      bLoopSuccess = 
-         !effect.TrackProgress(count,
-                               ( samplePos - start ).as_double() /
-                               len.as_double() );
+      if (pFraction) {
+         // On a worker thread; the main thread reads the fraction and
+         // polls the dialog
+         pFraction->store(
+            ( samplePos - start ).as_double() / len.as_double() );
+         bLoopSuccess = !pCancel->load();
+      }
+      else
+         bLoopSuccess =
+            !effect.TrackProgress(count,
+                                  ( samplePos - start ).as_double() /
+                                  len.as_double() );
    }
 
    if (bLoopSuccess) {
@@ -1335,13 +1463,18 @@ bool EffectNoiseReduction::Worker::ProcessOne
       // Flush the output WaveTrack (since it's buffered)
       outputTrack->Flush();
 
-      // Take the output track and insert it in place of the original
-      // sample data (as operated on -- this may not match mT0/mT1)
       double t0 = outputTrack->LongSamplesToTime(start);
       double tLen = outputTrack->LongSamplesToTime(len);
       // Filtering effects always end up with more data than they started with.  Delete this 'tail'.
       outputTrack->HandleClear(tLen, outputTrack->GetEndTime(), false, false);
-      track->ClearAndPaste(t0, t0 + tLen, &*outputTrack, true, false);
+      if (pOutput)
+         // Give the output track to the caller, which splices it into the
+         // track list on the main thread
+         *pOutput = std::move(outputTrack);
+      else
+         // Take the output track and insert it in place of the original
+         // sample data (as operated on -- this may not match mT0/mT1)
+         track->ClearAndPaste(t0, t0 + tLen, &*outputTrack, true, false);
    }
 
    return bLoopSuccess;
@@ -43,6 +43,7 @@ public:
    bool Init() override;
    bool CheckWhetherSkipEffect() override;
    bool Process() override;
+   wxString GetPreviewCacheKey() override;
 
    class Settings;
    class Statistics;
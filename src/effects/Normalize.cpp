@@ -610,6 +610,15 @@ bool EffectNormalize::ProcessOne(
    //to make it a double now than it is to do it later
    auto len = (end - start).as_double();
 
+   //Nothing audible changes when there is no offset to add and the
+   //multiplier is within the 24-bit quantization of unity, as when the
+   //selection already sits at the requested level; skip rewriting every
+   //block, which for a long selection dominates the cost of the effect
+   if (offset == 0.0 && fabs(mMult - 1.0) < 1.0e-8) {
+      progress += 1.0/double(2*GetNumWaveTracks());
+      return true;
+   }
+
    //Initiate a processing buffer.  This buffer will (most likely)
    //be shorter than the length of the track being processed.
    Floats buffer{ track->GetMaxBlockSize() };
@@ -653,8 +662,11 @@ bool EffectNormalize::ProcessOne(
 /// @see AnalyseDataLoudnessDC
 void EffectNormalize::AnalyseDataDC(float *buffer, size_t len)
 {
+   // Accumulate in a local so the compiler may keep it in a register
+   double sum = mSum;
    for(decltype(len) i = 0; i < len; i++)
-      mSum += (double)buffer[i];
+      sum += (double)buffer[i];
+   mSum = sum;
    mCount += len;
 }
 
@@ -694,8 +706,11 @@ void EffectNormalize::AnalyseDataLoudnessDC(float *buffer, size_t len)
 
 void EffectNormalize::ProcessData(float *buffer, size_t len, float offset)
 {
+   // A local multiplier, not the member, lets the compiler prove there
+   // is no aliasing with the buffer and vectorize the loop
+   const float mult = mMult;
    for(decltype(len) i = 0; i < len; i++) {
-      float adjFrame = (buffer[i] + offset) * mMult;
+      float adjFrame = (buffer[i] + offset) * mult;
       buffer[i] = adjFrame;
    }
 }
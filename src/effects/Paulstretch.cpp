@@ -18,6 +18,10 @@
 #include "Paulstretch.h"
 
 #include <algorithm>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
 
 #include <math.h>
 #include <float.h>
@@ -33,6 +37,7 @@
 #include "../Prefs.h"
 
 #include "../WaveTrack.h"
+#include "TrackIOQueue.h"
 
 // Define keys, defaults, minimums, and maximums for the effect parameters
 //
@@ -51,11 +56,24 @@ public:
 
    void process(float *smps, size_t nsmps);
 
+   // The stages of process(), callable separately so that the transforms
+   // of several windows can be pipelined: the pool update, the draw of
+   // the random phases, and the overlap of consecutive outputs must
+   // happen in window order, but between those, transform_window() for
+   // each window is independent of every other and touches only the
+   // buffers passed to it.
+   void fill_pool(const float *smps, size_t nsmps);
+   const float *get_pool() const { return in_pool.get(); }
+   void draw_phases(int *randoms) const;
+   void transform_window(const float *pool, const int *randoms,
+      float *out, float *c, float *s, float *freq, float *tmp) const;
+   void output_window(const float *smps);
+
    size_t get_nsamples();//how many samples are required to be added in the pool next time
    size_t get_nsamples_for_fill();//how many samples are required to be added for a complete buffer refill (at start of the song or after seek)
 
 private:
-   void process_spectrum(float *WXUNUSED(freq)) {};
+   void process_spectrum(float *WXUNUSED(freq)) const {};
 
    const float samplerate;
    const float rap;
@@ -77,6 +95,7 @@ private:
    double remained_samples;//how many fraction of samples has remained (0..1)
 
    const Floats fft_smps, fft_c, fft_s, fft_freq, fft_tmp;
+   const ArrayOf<int> fft_rand;
 };
 
 //
@@ -338,35 +357,95 @@ bool EffectPaulstretch::ProcessOne(WaveTrack *track,double t0,double t1,int coun
       auto bufsize = stretch.poolsize;
       Floats buffer0{ bufsize };
       float *bufferptr0 = buffer0.get();
-      bool first_time = true;
 
       const auto fade_len = std::min<size_t>(100, bufsize / 2 - 1);
       bool cancelled = false;
 
       {
          Floats fade_track_smps{ fade_len };
-         decltype(len) s=0;
-
-         while (s < len) {
-            track->Get((samplePtr)bufferptr0, floatSample, start + s, nget);
-            stretch.process(buffer0.get(), nget);
-
-            if (first_time) {
-               stretch.process(buffer0.get(), 0);
-            };
 
-            s += nget;
+         // The transform of each window depends only on a snapshot of the
+         // input pool and on that window's phase draws, so the transforms
+         // run on a pool of worker threads.  Everything else stays on this
+         // thread, in window order:  the pool and rand() advance as windows
+         // are produced, and the overlap of consecutive outputs and the
+         // Append happen as they are consumed.
+         const unsigned nWorkers =
+            std::max(1u, std::thread::hardware_concurrency());
+
+         struct Window {
+            Floats pool, smps, c, s, freq, tmp;
+            ArrayOf<int> randoms;
+            TrackIOQueue::Ticket ticket{ 0 };
+            double frac{ 0.0 };
+            bool append{ false }, fadeIn{ false }, fadeOut{ false };
+         };
+         const size_t nSlots = nWorkers + 2;
+         std::vector<Window> slots(nSlots);
+         for (auto &slot : slots) {
+            slot.pool.reinit(bufsize);
+            slot.smps.reinit(bufsize);
+            slot.c.reinit(bufsize);
+            slot.s.reinit(bufsize);
+            slot.freq.reinit(bufsize);
+            slot.tmp.reinit(bufsize);
+            slot.randoms.reinit(bufsize / 2);
+         }
 
-            if (first_time){//blend the the start of the selection
+         // Declared after the slots, so that if we leave early, pending
+         // jobs still find their buffers alive while the queues drain
+         std::vector<std::unique_ptr<TrackIOQueue>> queues(nWorkers);
+         for (auto &queue : queues)
+            queue = std::make_unique<TrackIOQueue>();
+
+         decltype(len) s = 0;
+         size_t wNext = 0, wCons = 0;
+
+         // The first two windows are special:  the first only seeds the
+         // overlap buffer and its output is discarded, and the second is
+         // the first one appended, taking the fade-in
+         auto moreWindows = [&]{ return wNext < 2 || s < len; };
+
+         auto produce = [&]{
+            auto thisGet = wNext == 0 ? nget
+               : wNext == 1 ? decltype(nget){ 0 }
+               : stretch.get_nsamples();
+            if (thisGet > 0)
+               track->Get((samplePtr)bufferptr0, floatSample,
+                  start + s, thisGet);
+            stretch.fill_pool(bufferptr0, thisGet);
+            s += thisGet;
+
+            auto &slot = slots[wNext % nSlots];
+            memcpy(slot.pool.get(), stretch.get_pool(),
+               bufsize * sizeof(float));
+            stretch.draw_phases(slot.randoms.get());
+            slot.append = wNext > 0;
+            slot.fadeIn = wNext == 1;
+            slot.fadeOut = wNext > 0 && s >= len;
+            slot.frac = s.as_double() / len.as_double();
+            slot.ticket = queues[wNext % nWorkers]->Post([&stretch, &slot]{
+               stretch.transform_window(slot.pool.get(), slot.randoms.get(),
+                  slot.smps.get(), slot.c.get(), slot.s.get(),
+                  slot.freq.get(), slot.tmp.get());
+            });
+            ++wNext;
+         };
+
+         auto consume = [&]{
+            auto &slot = slots[wCons % nSlots];
+            queues[wCons % nWorkers]->Wait(slot.ticket);
+            stretch.output_window(slot.smps.get());
+
+            if (slot.fadeIn){//blend the the start of the selection
                track->Get((samplePtr)fade_track_smps.get(), floatSample, start, fade_len);
-               first_time = false;
                for (size_t i = 0; i < fade_len; i++){
                   float fi = (float)i / (float)fade_len;
                   stretch.out_buf[i] =
                      stretch.out_buf[i] * fi + (1.0 - fi) * fade_track_smps[i];
                }
             }
-            if (s >= len){//blend the end of the selection
+            if (slot.fadeOut){//blend the end of the selection
                track->Get((samplePtr)fade_track_smps.get(), floatSample, end - fade_len, fade_len);
                for (size_t i = 0; i < fade_len; i++){
                   float fi = (float)i / (float)fade_len;
@@ -377,15 +456,19 @@ bool EffectPaulstretch::ProcessOne(WaveTrack *track,double t0,double t1,int coun
                }
             }
 
-            outputTrack->Append((samplePtr)stretch.out_buf.get(), floatSample, stretch.out_bufsize);
-
-            nget = stretch.get_nsamples();
-            if (TrackProgress(count,
-               s.as_double() / len.as_double()
-            )) {
-               cancelled = true;
-               break;
+            if (slot.append) {
+               outputTrack->Append((samplePtr)stretch.out_buf.get(), floatSample, stretch.out_bufsize);
+               if (TrackProgress(count, slot.frac))
+                  cancelled = true;
             }
+            ++wCons;
+         };
+
+         while (!cancelled && (moreWindows() || wCons < wNext)) {
+            if (moreWindows() && wNext < wCons + nSlots)
+               produce();
+            else
+               consume();
          }
       }
 
@@ -423,6 +506,7 @@ PaulStretch::PaulStretch(float rap_, size_t in_bufsize_, float samplerate_ )
    , fft_s { poolsize, true }
    , fft_freq { poolsize, true }
    , fft_tmp { poolsize }
+   , fft_rand { in_bufsize_, true }
 {
 }
 
@@ -431,6 +515,15 @@ PaulStretch::~PaulStretch()
 }
 
 void PaulStretch::process(float *smps, size_t nsmps)
+{
+   fill_pool(smps, nsmps);
+   draw_phases(fft_rand.get());
+   transform_window(in_pool.get(), fft_rand.get(), fft_smps.get(),
+                    fft_c.get(), fft_s.get(), fft_freq.get(), fft_tmp.get());
+   output_window(fft_smps.get());
+}
+
+void PaulStretch::fill_pool(const float *smps, size_t nsmps)
 {
    //add NEW samples to the pool
    if ((smps != NULL) && (nsmps != 0)) {
@@ -447,43 +540,51 @@ void PaulStretch::process(float *smps, size_t nsmps)
       for (size_t i = 0; i < nsmps; i++)
          in_pool[i + nleft] = smps[i];
    }
+}
 
+void PaulStretch::draw_phases(int *randoms) const
+{
+   // rand() must be called in window order, so that a pipelined render
+   // draws the same phases as a serial one
+   for (size_t i = 1; i < poolsize / 2; i++)
+      randoms[i] = rand() & 0x7fff;
+}
+
+void PaulStretch::transform_window(const float *pool, const int *randoms,
+   float *out, float *c, float *s, float *freq, float *tmp) const
+{
    //get the samples from the pool
    for (size_t i = 0; i < poolsize; i++)
-      fft_smps[i] = in_pool[i];
-   WindowFunc(eWinFuncHanning, poolsize, fft_smps.get());
+      out[i] = pool[i];
+   WindowFunc(eWinFuncHanning, poolsize, out);
 
-   RealFFT(poolsize, fft_smps.get(), fft_c.get(), fft_s.get());
+   RealFFT(poolsize, out, c, s);
 
    for (size_t i = 0; i < poolsize / 2; i++)
-      fft_freq[i] = sqrt(fft_c[i] * fft_c[i] + fft_s[i] * fft_s[i]);
-   process_spectrum(fft_freq.get());
+      freq[i] = sqrt(c[i] * c[i] + s[i] * s[i]);
+   process_spectrum(freq);
 
 
    //put randomize phases to frequencies and do a IFFT
    float inv_2p15_2pi = 1.0 / 16384.0 * (float)M_PI;
    for (size_t i = 1; i < poolsize / 2; i++) {
-      unsigned int random = (rand()) & 0x7fff;
+      unsigned int random = randoms[i];
       float phase = random * inv_2p15_2pi;
-      float s = fft_freq[i] * sin(phase);
-      float c = fft_freq[i] * cos(phase);
+      float sn = freq[i] * sin(phase);
+      float cs = freq[i] * cos(phase);
 
-      fft_c[i] = fft_c[poolsize - i] = c;
+      c[i] = c[poolsize - i] = cs;
 
-      fft_s[i] = s; fft_s[poolsize - i] = -s;
-   }
-   fft_c[0] = fft_s[0] = 0.0;
-   fft_c[poolsize / 2] = fft_s[poolsize / 2] = 0.0;
-
-   FFT(poolsize, true, fft_c.get(), fft_s.get(), fft_smps.get(), fft_tmp.get());
-
-   float max = 0.0, max2 = 0.0;
-   for (size_t i = 0; i < poolsize; i++) {
-      max = std::max(max, fabsf(fft_tmp[i]));
-      max2 = std::max(max2, fabsf(fft_smps[i]));
+      s[i] = sn; s[poolsize - i] = -sn;
    }
+   c[0] = s[0] = 0.0;
+   c[poolsize / 2] = s[poolsize / 2] = 0.0;
 
+   FFT(poolsize, true, c, s, out, tmp);
+}
 
+void PaulStretch::output_window(const float *smps)
+{
    //make the output buffer
    float tmp = 1.0 / (float) out_bufsize * M_PI;
    float hinv_sqrt2 = 0.853553390593f;//(1.0+1.0/sqrt(2))*0.5;
@@ -496,7 +597,7 @@ void PaulStretch::process(float *smps, size_t nsmps)
 
    for (size_t i = 0; i < out_bufsize; i++) {
       float a = (0.5 + 0.5 * cos(i * tmp));
-      float out = fft_smps[i + out_bufsize] * (1.0 - a) + old_out_smp_buf[i] * a;
+      float out = smps[i + out_bufsize] * (1.0 - a) + old_out_smp_buf[i] * a;
       out_buf[i] =
          out * (hinv_sqrt2 - (1.0 - hinv_sqrt2) * cos(i * 2.0 * tmp)) *
          ampfactor;
@@ -504,7 +605,7 @@ void PaulStretch::process(float *smps, size_t nsmps)
 
    //copy the current output buffer to old buffer
    for (size_t i = 0; i < out_bufsize * 2; i++)
-      old_out_smp_buf[i] = fft_smps[i];
+      old_out_smp_buf[i] = smps[i];
 }
 
 size_t PaulStretch::get_nsamples()
@@ -157,7 +157,7 @@ bool EffectPhaser::ProcessInitialize(sampleCount WXUNUSED(totalLen), ChannelName
 
 size_t EffectPhaser::ProcessBlock(float **inBlock, float **outBlock, size_t blockLen)
 {
-   return InstanceProcess(mMaster, inBlock, outBlock, blockLen);
+   return InstanceProcess(CurrentSettings(), mMaster, inBlock, outBlock, blockLen);
 }
 
 bool EffectPhaser::RealtimeInitialize()
@@ -166,6 +166,10 @@ bool EffectPhaser::RealtimeInitialize()
 
    mSlaves.clear();
 
+   // Seed the mailbox so the audio thread starts from the current settings
+   mSettingsMessage.Initialize();
+   mSettingsMessage.Write(CurrentSettings());
+
    return true;
 }
 
@@ -193,7 +197,11 @@ size_t EffectPhaser::RealtimeProcess(int group,
                                           size_t numSamples)
 {
 
-   return InstanceProcess(mSlaves[group], inbuf, outbuf, numSamples);
+   // Adopt whatever the UI thread last published; reading the mailbox
+   // never blocks, so the stream need not be suspended while tweaking
+   const auto settings = mSettingsMessage.Read();
+
+   return InstanceProcess(settings, mSlaves[group], inbuf, outbuf, numSamples);
 }
 bool EffectPhaser::DefineParams( ShuttleParams & S ){
    S.SHUTTLE_PARAM( mStages,    Stages );
@@ -242,6 +250,8 @@ bool EffectPhaser::SetAutomationParameters(CommandParameters & parms)
    mPhase = Phase;
    mOutGain = OutGain;
 
+   mSettingsMessage.Write(CurrentSettings());
+
    return true;
 }
 
@@ -368,6 +378,11 @@ bool EffectPhaser::TransferDataFromWindow()
 
 // EffectPhaser implementation
 
+EffectPhaserSettings EffectPhaser::CurrentSettings() const
+{
+   return { mStages, mDryWet, mFreq, mPhase, mDepth, mFeedback, mOutGain };
+}
+
 void EffectPhaser::InstanceInit(EffectPhaserState & data, float sampleRate)
 {
    data.samplerate = sampleRate;
@@ -386,26 +401,27 @@ void EffectPhaser::InstanceInit(EffectPhaserState & data, float sampleRate)
    return;
 }
 
-size_t EffectPhaser::InstanceProcess(EffectPhaserState & data, float **inBlock, float **outBlock, size_t blockLen)
+size_t EffectPhaser::InstanceProcess(const EffectPhaserSettings & settings,
+   EffectPhaserState & data, float **inBlock, float **outBlock, size_t blockLen)
 {
    float *ibuf = inBlock[0];
    float *obuf = outBlock[0];
 
-   for (int j = data.laststages; j < mStages; j++)
+   for (int j = data.laststages; j < settings.stages; j++)
    {
       data.old[j] = 0;
    }
-   data.laststages = mStages;
+   data.laststages = settings.stages;
 
-   data.lfoskip = mFreq * 2 * M_PI / data.samplerate;
-   data.phase = mPhase * M_PI / 180;
-   data.outgain = DB_TO_LINEAR(mOutGain);
+   data.lfoskip = settings.freq * 2 * M_PI / data.samplerate;
+   data.phase = settings.phase * M_PI / 180;
+   data.outgain = DB_TO_LINEAR(settings.outGain);
 
    for (decltype(blockLen) i = 0; i < blockLen; i++)
    {
       double in = ibuf[i];
 
-      double m = in + data.fbout * mFeedback / 101;  // Feedback must be less than 100% to avoid infinite gain.
+      double m = in + data.fbout * settings.feedback / 101;  // Feedback must be less than 100% to avoid infinite gain.
 
       if (((data.skipcount++) % lfoskipsamples) == 0)
       {
@@ -419,11 +435,11 @@ size_t EffectPhaser::InstanceProcess(EffectPhaserState & data, float **inBlock,
          data.gain = expm1(data.gain * phaserlfoshape) / expm1(phaserlfoshape);
 
          // attenuate the lfo
-         data.gain = 1.0 - data.gain / 255.0 * mDepth;
+         data.gain = 1.0 - data.gain / 255.0 * settings.depth;
       }
 
       // phasing routine
-      for (int j = 0; j < mStages; j++)
+      for (int j = 0; j < settings.stages; j++)
       {
          double tmp = data.old[j];
          data.old[j] = data.gain * tmp + m;
@@ -431,7 +447,7 @@ size_t EffectPhaser::InstanceProcess(EffectPhaserState & data, float **inBlock,
       }
       data.fbout = m;
 
-      obuf[i] = (float) (data.outgain * (m * mDryWet + in * (255 - mDryWet)) / 255);
+      obuf[i] = (float) (data.outgain * (m * settings.dryWet + in * (255 - settings.dryWet)) / 255);
    }
 
    return blockLen;
@@ -442,6 +458,7 @@ void EffectPhaser::OnStagesSlider(wxCommandEvent & evt)
    mStages = (evt.GetInt() / SCL_Stages) & ~1;  // must be even;
    mStagesT->GetValidator()->TransferToWindow();
    EnableApply(mUIParent->Validate());
+   mSettingsMessage.Write(CurrentSettings());
 }
 
 void EffectPhaser::OnDryWetSlider(wxCommandEvent & evt)
@@ -449,6 +466,7 @@ void EffectPhaser::OnDryWetSlider(wxCommandEvent & evt)
    mDryWet = evt.GetInt() / SCL_DryWet;
    mDryWetT->GetValidator()->TransferToWindow();
    EnableApply(mUIParent->Validate());
+   mSettingsMessage.Write(CurrentSettings());
 }
 
 void EffectPhaser::OnFreqSlider(wxCommandEvent & evt)
@@ -457,6 +475,7 @@ void EffectPhaser::OnFreqSlider(wxCommandEvent & evt)
    if (mFreq < MIN_Freq) mFreq = MIN_Freq;
    mFreqT->GetValidator()->TransferToWindow();
    EnableApply(mUIParent->Validate());
+   mSettingsMessage.Write(CurrentSettings());
 }
 
 void EffectPhaser::OnPhaseSlider(wxCommandEvent & evt)
@@ -467,6 +486,7 @@ void EffectPhaser::OnPhaseSlider(wxCommandEvent & evt)
    mPhase =  (double) val / SCL_Phase;
    mPhaseT->GetValidator()->TransferToWindow();
    EnableApply(mUIParent->Validate());
+   mSettingsMessage.Write(CurrentSettings());
 }
 
 void EffectPhaser::OnDepthSlider(wxCommandEvent & evt)
@@ -474,6 +494,7 @@ void EffectPhaser::OnDepthSlider(wxCommandEvent & evt)
    mDepth = evt.GetInt() / SCL_Depth;
    mDepthT->GetValidator()->TransferToWindow();
    EnableApply(mUIParent->Validate());
+   mSettingsMessage.Write(CurrentSettings());
 }
 
 void EffectPhaser::OnFeedbackSlider(wxCommandEvent & evt)
@@ -485,6 +506,7 @@ void EffectPhaser::OnFeedbackSlider(wxCommandEvent & evt)
    mFeedback = val / SCL_Feedback;
    mFeedbackT->GetValidator()->TransferToWindow();
    EnableApply(mUIParent->Validate());
+   mSettingsMessage.Write(CurrentSettings());
 }
 
 void EffectPhaser::OnGainSlider(wxCommandEvent & evt)
@@ -492,6 +514,7 @@ void EffectPhaser::OnGainSlider(wxCommandEvent & evt)
    mOutGain = evt.GetInt() / SCL_OutGain;
    mOutGainT->GetValidator()->TransferToWindow();
    EnableApply(mUIParent->Validate());
+   mSettingsMessage.Write(CurrentSettings());
 }
 
 void EffectPhaser::OnStagesText(wxCommandEvent & WXUNUSED(evt))
@@ -502,6 +525,7 @@ void EffectPhaser::OnStagesText(wxCommandEvent & WXUNUSED(evt))
    }
 
    mStagesS->SetValue((int) (mStages * SCL_Stages));
+   mSettingsMessage.Write(CurrentSettings());
 }
 
 void EffectPhaser::OnDryWetText(wxCommandEvent & WXUNUSED(evt))
@@ -512,6 +536,7 @@ void EffectPhaser::OnDryWetText(wxCommandEvent & WXUNUSED(evt))
    }
 
    mDryWetS->SetValue((int) (mDryWet * SCL_DryWet));
+   mSettingsMessage.Write(CurrentSettings());
 }
 
 void EffectPhaser::OnFreqText(wxCommandEvent & WXUNUSED(evt))
@@ -522,6 +547,7 @@ void EffectPhaser::OnFreqText(wxCommandEvent & WXUNUSED(evt))
    }
 
    mFreqS->SetValue((int) (mFreq * SCL_Freq));
+   mSettingsMessage.Write(CurrentSettings());
 }
 
 void EffectPhaser::OnPhaseText(wxCommandEvent & WXUNUSED(evt))
@@ -532,6 +558,7 @@ void EffectPhaser::OnPhaseText(wxCommandEvent & WXUNUSED(evt))
    }
 
    mPhaseS->SetValue((int) (mPhase * SCL_Phase));
+   mSettingsMessage.Write(CurrentSettings());
 }
 
 void EffectPhaser::OnDepthText(wxCommandEvent & WXUNUSED(evt))
@@ -542,6 +569,7 @@ void EffectPhaser::OnDepthText(wxCommandEvent & WXUNUSED(evt))
    }
 
    mDepthS->SetValue((int) (mDepth * SCL_Depth));
+   mSettingsMessage.Write(CurrentSettings());
 }
 
 void EffectPhaser::OnFeedbackText(wxCommandEvent & WXUNUSED(evt))
@@ -552,6 +580,7 @@ void EffectPhaser::OnFeedbackText(wxCommandEvent & WXUNUSED(evt))
    }
 
    mFeedbackS->SetValue((int) (mFeedback * SCL_Feedback));
+   mSettingsMessage.Write(CurrentSettings());
 }
 
 void EffectPhaser::OnGainText(wxCommandEvent & WXUNUSED(evt))
@@ -562,4 +591,5 @@ void EffectPhaser::OnGainText(wxCommandEvent & WXUNUSED(evt))
    }
 
    mOutGainS->SetValue((int) (mOutGain * SCL_OutGain));
+   mSettingsMessage.Write(CurrentSettings());
 }
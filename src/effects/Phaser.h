@@ -17,6 +17,7 @@
 #define __AUDACITY_EFFECT_PHASER__
 
 #include "Effect.h"
+#include "../MessageBuffer.h"
 
 class wxSlider;
 class wxTextCtrl;
@@ -26,6 +27,21 @@ class ShuttleGui;
 
 #define PHASER_PLUGIN_SYMBOL ComponentInterfaceSymbol{ XO("Phaser") }
 
+// A complete snapshot of the user parameters.  The UI thread publishes one
+// through a MessageBuffer whenever a control changes and the audio thread
+// adopts the latest at each chunk boundary, so tweaking a control during
+// playback never suspends the stream.
+struct EffectPhaserSettings
+{
+   int stages{ 0 };
+   int dryWet{ 0 };
+   double freq{ 0.0 };
+   double phase{ 0.0 };
+   int depth{ 0 };
+   int feedback{ 0 };
+   double outGain{ 0.0 };
+};
+
 class EffectPhaserState
 {
 public:
@@ -85,7 +101,11 @@ private:
    // EffectPhaser implementation
 
    void InstanceInit(EffectPhaserState & data, float sampleRate);
-   size_t InstanceProcess(EffectPhaserState & data, float **inBlock, float **outBlock, size_t blockLen);
+   size_t InstanceProcess(const EffectPhaserSettings & settings,
+      EffectPhaserState & data,
+      float **inBlock, float **outBlock, size_t blockLen);
+
+   EffectPhaserSettings CurrentSettings() const;
 
    void OnStagesSlider(wxCommandEvent & evt);
    void OnDryWetSlider(wxCommandEvent & evt);
@@ -118,6 +138,8 @@ private:
    EffectPhaserState mMaster;
    std::vector<EffectPhaserState> mSlaves;
 
+   MessageBuffer<EffectPhaserSettings> mSettingsMessage;
+
    // parameters
    int mStages;
    int mDryWet;
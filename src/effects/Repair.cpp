@@ -87,8 +87,8 @@ bool EffectRepair::Process()
          const auto repair0 = track->TimeToLongSamples(repair_t0);
          const auto repair1 = track->TimeToLongSamples(repair_t1);
          const auto repairLen = repair1 - repair0;
-         if (repairLen > 128) {
-            ::Effect::MessageBox(_("The Repair effect is intended to be used on very short sections of damaged audio (up to 128 samples).\n\nZoom in and select a tiny fraction of a second to repair."));
+         if (repairLen > 2048) {
+            ::Effect::MessageBox(_("The Repair effect is intended to be used on very short sections of damaged audio (up to 2048 samples).\n\nZoom in and select a tiny fraction of a second to repair."));
             bGoodResult = false;
             break;
          }
@@ -100,7 +100,7 @@ bool EffectRepair::Process()
 
          const auto s0 = track->TimeToLongSamples(t0);
          const auto s1 = track->TimeToLongSamples(t1);
-         // The difference is at most 2 * 128:
+         // The difference is at most 2 * 2048:
          const auto repairStart = (repair0 - s0).as_size_t();
          const auto len = s1 - s0;
 
@@ -112,10 +112,10 @@ bool EffectRepair::Process()
          }
 
          if (!ProcessOne(count, track, s0,
-                         // len is at most 5 * 128.
+                         // len is at most 5 * 2048.
                          len.as_size_t(),
                          repairStart,
-                         // repairLen is at most 128.
+                         // repairLen is at most 2048.
                          repairLen.as_size_t() )) {
             bGoodResult = false;
             break;
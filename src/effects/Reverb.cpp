@@ -197,11 +197,16 @@ bool EffectReverb::ProcessInitialize(sampleCount WXUNUSED(totalLen), ChannelName
                     mP[i].wet);
    }
 
+   if (mNumChans == 2)
+      mWorker = std::make_unique<TrackIOQueue>();
+
    return true;
 }
 
 bool EffectReverb::ProcessFinalize()
 {
+   mWorker.reset();
+
    for (unsigned int i = 0; i < mNumChans; i++)
    {
       reverb_delete(&mP[i].reverb);
@@ -230,7 +235,18 @@ size_t EffectReverb::ProcessBlock(float **inBlock, float **outBlock, size_t bloc
    while (remaining)
    {
       auto len = std::min(remaining, decltype(remaining)(BLOCK));
-      for (unsigned int c = 0; c < mNumChans; c++)
+      if (mWorker) {
+         // The channels' reverbs are independent of each other; run the
+         // second on the worker while this thread runs the first
+         auto ticket = mWorker->Post([this, len, in = ichans[1]]{
+            mP[1].dry = (float *) fifo_write(&mP[1].reverb.input_fifo, len, in);
+            reverb_process(&mP[1].reverb, len);
+         });
+         mP[0].dry = (float *) fifo_write(&mP[0].reverb.input_fifo, len, ichans[0]);
+         reverb_process(&mP[0].reverb, len);
+         mWorker->Wait(ticket);
+      }
+      else for (unsigned int c = 0; c < mNumChans; c++)
       {
          // Write the input samples to the reverb fifo.  Returned value is the address of the
          // fifo buffer which contains a copy of the input samples.
@@ -13,6 +13,7 @@
 #define __AUDACITY_EFFECT_REVERB__
 
 #include "Effect.h"
+#include "TrackIOQueue.h"
 
 class wxCheckBox;
 class wxSlider;
@@ -97,6 +98,9 @@ private:
 private:
    unsigned mNumChans {};
    Reverb_priv_t *mP;
+   // Runs the second channel of a stereo pair while this thread runs the
+   // first
+   std::unique_ptr<TrackIOQueue> mWorker;
 
    Params mParams;
 
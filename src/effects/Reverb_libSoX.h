@@ -178,24 +178,48 @@ static void filter_array_create(filter_array_t * p, double rate,
    }
 }
 
+static void comb_process_block(filter_t * p, size_t length,
+      float const * input, float * output,    /* accumulated into */
+      float const * feedback, float const * hf_damping)
+{
+   while (length--)
+      *output++ += comb_process(p, input++, feedback, hf_damping);
+}
+
+static void allpass_process_block(filter_t * p, size_t length,
+      float * output)                         /* processed in place */
+{
+   while (length--) {
+      *output = allpass_process(p, output);
+      ++output;
+   }
+}
+
 static void filter_array_process(filter_array_t * p,
       size_t length, float const * input, float * output,
       float const * feedback, float const * hf_damping, float const * gain)
 {
-   while (length--) {
-      float out = 0, in = *input++;
+   size_t i, n;
+
+   /* Run each delay line over the whole block in turn, rather than all
+      lines sample by sample: the lines are independent of each other,
+      and each one then walks its own buffer contiguously instead of the
+      lines' buffers being interleaved in the access pattern.  The order
+      of combination per sample is unchanged, so the output is the same. */
+   memset(output, 0, length * sizeof(*output));
 
-      size_t i = array_length(comb_lengths) - 1;
-      do out += comb_process(p->comb + i, &in, feedback, hf_damping);
-      while (i--);
+   i = array_length(comb_lengths) - 1;
+   do comb_process_block(p->comb + i, length, input, output, feedback, hf_damping);
+   while (i--);
 
-      i = array_length(allpass_lengths) - 1;
-      do out = allpass_process(p->allpass + i, &out);
-      while (i--);
+   i = array_length(allpass_lengths) - 1;
+   do allpass_process_block(p->allpass + i, length, output);
+   while (i--);
 
-      out = one_pole_process(&p->one_pole[0], out);
+   for (n = 0; n < length; ++n) {
+      float out = one_pole_process(&p->one_pole[0], output[n]);
       out = one_pole_process(&p->one_pole[1], out);
-      *output++ = out * *gain;
+      output[n] = out * *gain;
    }
 }
 
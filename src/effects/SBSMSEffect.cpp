@@ -18,6 +18,11 @@ effect that uses SBSMS to do its processing (TimeScale)
 
 #include <math.h>
 
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 #include "../LabelTrack.h"
 #include "../WaveTrack.h"
 #include "TimeWarper.h"
@@ -26,6 +31,128 @@ enum {
   SBSMSOutBlockSize = 512
 };
 
+// Fetches source samples on its own thread, keeping a bounded ring of
+// interleaved sbsms frames ahead of the stretch loop, so waiting on slow
+// storage overlaps with SBSMS processing instead of alternating with it
+class PrefetchedSource
+{
+public:
+   PrefetchedSource(WaveTrack *leftTrack, WaveTrack *rightTrack,
+                    sampleCount offset, sampleCount end, size_t blockSize)
+      : mLeftTrack{ leftTrack }
+      , mRightTrack{ rightTrack }
+      , mOffset{ offset }
+      , mEnd{ end }
+      , mRingSize{ 4 * blockSize }
+   {
+      mRing.reinit(mRingSize, true);
+      mLeftBuffer.reinit(blockSize, true);
+      mRightBuffer.reinit(blockSize, true);
+      mThread = std::thread( [this]{ Fill(); } );
+   }
+
+   ~PrefetchedSource()
+   {
+      {
+         std::lock_guard<std::mutex> guard{ mMutex };
+         mAbort = true;
+      }
+      mCondition.notify_all();
+      mThread.join();
+   }
+
+   // Copies at most len already-fetched frames into buf, blocking only
+   // when the reader has not kept ahead; returns 0 at the end of the
+   // source, or after an error on the reader thread
+   size_t Read(audio *buf, size_t len)
+   {
+      std::unique_lock<std::mutex> lock{ mMutex };
+      mCondition.wait( lock, [this]{ return mCount > 0 || mDone; } );
+      auto count = std::min(len, mCount);
+      for (size_t ii = 0; ii < count; ii++) {
+         auto &frame = mRing[(mStart + ii) % mRingSize];
+         buf[ii][0] = frame[0];
+         buf[ii][1] = frame[1];
+      }
+      mStart = (mStart + count) % mRingSize;
+      mCount -= count;
+      lock.unlock();
+      mCondition.notify_all();
+      return count;
+   }
+
+   // Returns an exception the reader thread caught, if any; meaningful
+   // only after Read() has returned 0
+   std::exception_ptr TakeException()
+   {
+      std::lock_guard<std::mutex> guard{ mMutex };
+      auto result = mpException;
+      mpException = {};
+      return result;
+   }
+
+private:
+   void Fill()
+   {
+      try {
+         auto offset = mOffset;
+         while (offset < mEnd) {
+            auto blockSize = limitSampleBufferSize(
+               mLeftTrack->GetBestBlockSize(offset), mEnd - offset );
+            mLeftTrack->Get(
+               (samplePtr)(mLeftBuffer.get()), floatSample, offset, blockSize);
+            mRightTrack->Get(
+               (samplePtr)(mRightBuffer.get()), floatSample, offset, blockSize);
+            size_t copied = 0;
+            while (copied < blockSize) {
+               std::unique_lock<std::mutex> lock{ mMutex };
+               mCondition.wait( lock,
+                  [this]{ return mCount < mRingSize || mAbort; } );
+               if (mAbort)
+                  return;
+               auto count = std::min(blockSize - copied, mRingSize - mCount);
+               for (size_t ii = 0; ii < count; ii++) {
+                  auto &frame = mRing[(mStart + mCount + ii) % mRingSize];
+                  frame[0] = mLeftBuffer[copied + ii];
+                  frame[1] = mRightBuffer[copied + ii];
+               }
+               mCount += count;
+               copied += count;
+               lock.unlock();
+               mCondition.notify_all();
+            }
+            offset += blockSize;
+         }
+         std::lock_guard<std::mutex> guard{ mMutex };
+         mDone = true;
+      }
+      catch ( ... ) {
+         // Save the exception object for re-throw when out of the library
+         std::lock_guard<std::mutex> guard{ mMutex };
+         mpException = std::current_exception();
+         mDone = true;
+      }
+      mCondition.notify_all();
+   }
+
+   WaveTrack *mLeftTrack;
+   WaveTrack *mRightTrack;
+   const sampleCount mOffset;
+   const sampleCount mEnd;
+   const size_t mRingSize;
+   ArrayOf<audio> mRing;
+   ArrayOf<float> mLeftBuffer;
+   ArrayOf<float> mRightBuffer;
+   size_t mStart{ 0 };
+   size_t mCount{ 0 };
+   bool mDone{ false };
+   bool mAbort{ false };
+   std::exception_ptr mpException {};
+   std::mutex mMutex;
+   std::condition_variable mCondition;
+   std::thread mThread;
+};
+
 class ResampleBuf
 {
 public:
@@ -44,12 +171,7 @@ public:
    sampleCount processed;
    size_t blockSize;
    long SBSMSBlockSize;
-   sampleCount offset;
-   sampleCount end;
-   ArrayOf<float> leftBuffer;
-   ArrayOf<float> rightBuffer;
-   WaveTrack *leftTrack;
-   WaveTrack *rightTrack;
+   std::unique_ptr<PrefetchedSource> source;
    std::unique_ptr<SBSMS> sbsms;
    std::unique_ptr<SBSMSInterface> iface;
    ArrayOf<audio> SBSMSBuf;
@@ -88,34 +210,20 @@ long resampleCB(void *cb_data, SBSMSFrame *data)
 {
    ResampleBuf *r = (ResampleBuf*) cb_data;
 
-   auto blockSize = limitSampleBufferSize(
-      r->leftTrack->GetBestBlockSize(r->offset),
-      r->end - r->offset
-   );
+   // The reader thread fetches the samples, usually before they are
+   // wanted, and has already converted them to the sbsms audio format
+   auto blockSize = r->source->Read(r->buf.get(), r->blockSize);
 
-   // Get the samples from the tracks and put them in the buffers.
-   // I don't know if we can safely propagate errors through sbsms, and it
-   // does not seem to let us report error codes, so use this roundabout to
-   // stop the effect early.
-   try {
-      r->leftTrack->Get(
-         (samplePtr)(r->leftBuffer.get()), floatSample, r->offset, blockSize);
-      r->rightTrack->Get(
-         (samplePtr)(r->rightBuffer.get()), floatSample, r->offset, blockSize);
-   }
-   catch ( ... ) {
-      // Save the exception object for re-throw when out of the library
-      r->mpException = std::current_exception();
+   if (blockSize == 0) {
+      // End of the source, or an error on the reader thread.
+      // I don't know if we can safely propagate errors through sbsms, and it
+      // does not seem to let us report error codes, so use this roundabout to
+      // stop the effect early.
+      r->mpException = r->source->TakeException();
       data->size = 0;
       return 0;
    }
 
-   // convert to sbsms audio format
-   for(decltype(blockSize) i=0; i<blockSize; i++) {
-      r->buf[i][0] = r->leftBuffer[i];
-      r->buf[i][1] = r->rightBuffer[i];
-   }
-
    data->buf = r->buf.get();
    data->size = blockSize;
    if(r->bPitch) {
@@ -128,7 +236,6 @@ long resampleCB(void *cb_data, SBSMSFrame *data)
      data->ratio1 = r->ratio;
    }
    r->processed += blockSize;
-   r->offset += blockSize;
    return blockSize;
 }
 
@@ -286,10 +393,6 @@ bool EffectSBSMS::Process()
             auto maxBlockSize = leftTrack->GetMaxBlockSize();
             rb.blockSize = maxBlockSize;
             rb.buf.reinit(rb.blockSize, true);
-            rb.leftTrack = leftTrack;
-            rb.rightTrack = rightTrack?rightTrack:leftTrack;
-            rb.leftBuffer.reinit(maxBlockSize, true);
-            rb.rightBuffer.reinit(maxBlockSize, true);
 
             // Samples in selection
             auto samplesIn = end - start;
@@ -304,8 +407,9 @@ bool EffectSBSMS::Process()
               rb.bPitch = true;
               outSlideType = rateSlideType;
               outResampleCB = resampleCB;
-              rb.offset = start;
-              rb.end = end;
+              rb.source = std::make_unique<PrefetchedSource>
+                  (leftTrack, rightTrack ? rightTrack : leftTrack,
+                   start, end, maxBlockSize);
                // Third party library has its own type alias, check it
                static_assert(sizeof(sampleCount::type) <=
                              sizeof(_sbsms_::SampleCountType),
@@ -341,8 +445,9 @@ bool EffectSBSMS::Process()
                            decltype(trackPresamples)
                               (processPresamples.as_float() *
                                   (srTrack/srProcess)));
-              rb.offset = start - trackPresamples;
-              rb.end = trackEnd;
+              rb.source = std::make_unique<PrefetchedSource>
+                  (leftTrack, rightTrack ? rightTrack : leftTrack,
+                   start - trackPresamples, trackEnd, maxBlockSize);
               rb.iface = std::make_unique<SBSMSEffectInterface>
                   (rb.resampler.get(), &rateSlide, &pitchSlide,
                    bPitchReferenceInput,
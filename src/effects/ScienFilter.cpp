@@ -232,14 +232,10 @@ bool EffectScienFilter::ProcessInitialize(sampleCount WXUNUSED(totalLen), Channe
 
 size_t EffectScienFilter::ProcessBlock(float **inBlock, float **outBlock, size_t blockLen)
 {
-   float *ibuf = inBlock[0];
-   for (int iPair = 0; iPair < (mOrder + 1) / 2; iPair++)
-   {
-      mpBiquad[iPair].pfIn = ibuf;
-      mpBiquad[iPair].pfOut = outBlock[0];
-      mpBiquad[iPair].Process(blockLen);
-      ibuf = outBlock[0];
-   }
+   // One sweep over the buffer through all the pairs, instead of one
+   // full pass per pair
+   Biquad::ProcessCascade(mpBiquad.get(), (mOrder + 1) / 2,
+      inBlock[0], outBlock[0], blockLen);
 
    return blockLen;
 }
@@ -19,6 +19,13 @@ effect that uses SoundTouch to do its processing (ChangeTempo
 
 #include <math.h>
 
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <vector>
+
+#include <wx/utils.h>
+
 #include "../LabelTrack.h"
 #include "../WaveTrack.h"
 #include "../NoteTrack.h"
@@ -66,12 +73,9 @@ bool EffectSoundTouch::ProcessNoteTrack(NoteTrack *nt, const TimeWarper &warper)
 }
 #endif
 
-bool EffectSoundTouch::ProcessWithTimeWarper(const TimeWarper &warper)
+bool EffectSoundTouch::ProcessWithTimeWarper(InitFunction initer,
+                                             const TimeWarper &warper)
 {
-   // Assumes that mSoundTouch has already been initialized
-   // by the subclass for subclass-specific parameters. The
-   // time warper should also be set.
-
    // Check if this effect will alter the selection length; if so, we need
    // to operate on sync-lock selected tracks.
    bool mustSync = true;
@@ -87,6 +91,19 @@ bool EffectSoundTouch::ProcessWithTimeWarper(const TimeWarper &warper)
    mCurTrackNum = 0;
    m_maxNewLength = 0.0;
 
+   // Label, note, and sync-locked tracks are adjusted at once below, but
+   // wave tracks are only enumerated, and processed afterward, each through
+   // its own SoundTouch instance, on worker threads when there are enough
+   // tracks and cores.  A stereo pair stays interleaved through one
+   // instance, as before, so the channels keep their phase relationship.
+   struct Task {
+      WaveTrack *leftTrack, *rightTrack;
+      sampleCount start, end;
+      double curT0, curT1;
+      int trackNum;
+   };
+   std::vector<Task> tasks;
+
    mOutputTracks->Leaders().VisitWhile( bGoodResult,
       [&]( LabelTrack *lt, const Track::Fallthrough &fallthrough ) {
          if ( !(lt->GetSelected() || (mustSync && lt->IsSyncLockSelected())) )
@@ -133,30 +150,17 @@ bool EffectSoundTouch::ProcessWithTimeWarper(const TimeWarper &warper)
                t = rightTrack->GetEndTime();
                t = wxMin(mT1, t);
                mCurT1 = wxMax(mCurT1, t);
+            }
 
-               //Transform the marker timepoints to samples
-               auto start = leftTrack->TimeToLongSamples(mCurT0);
-               auto end = leftTrack->TimeToLongSamples(mCurT1);
+            //Transform the marker timepoints to samples
+            auto start = leftTrack->TimeToLongSamples(mCurT0);
+            auto end = leftTrack->TimeToLongSamples(mCurT1);
 
-               //Inform soundtouch there's 2 channels
-               mSoundTouch->setChannels(2);
+            tasks.push_back( { leftTrack, rightTrack,
+               start, end, mCurT0, mCurT1, mCurTrackNum } );
 
-               //ProcessStereo() (implemented below) processes a stereo track
-               if (!ProcessStereo(leftTrack, rightTrack, start, end, warper))
-                  bGoodResult = false;
+            if ( rightTrack )
                mCurTrackNum++; // Increment for rightTrack, too.
-            } else {
-               //Transform the marker timepoints to samples
-               auto start = leftTrack->TimeToLongSamples(mCurT0);
-               auto end = leftTrack->TimeToLongSamples(mCurT1);
-
-               //Inform soundtouch there's a single channel
-               mSoundTouch->setChannels(1);
-
-               //ProcessOne() (implemented below) processes a single track
-               if (!ProcessOne(leftTrack, start, end, warper))
-                  bGoodResult = false;
-            }
          }
          mCurTrackNum++;
       },
@@ -167,6 +171,125 @@ bool EffectSoundTouch::ProcessWithTimeWarper(const TimeWarper &warper)
       }
    );
 
+   const unsigned nWorkers = std::min<size_t>( tasks.size(),
+      std::max( 1u, std::thread::hardware_concurrency() ) );
+
+   if (bGoodResult && nWorkers < 2) {
+      // Too few tracks or cores; process them in order on this thread
+      for (auto &task : tasks) {
+         soundtouch::SoundTouch soundTouch;
+         initer(soundTouch);
+         mCurT0 = task.curT0;
+         mCurT1 = task.curT1;
+         mCurTrackNum = task.trackNum;
+         if (task.rightTrack) {
+            //Inform soundtouch there's 2 channels
+            soundTouch.setChannels(2);
+            if (!ProcessStereo(&soundTouch,
+                  task.leftTrack, task.rightTrack, task.start, task.end,
+                  warper))
+               bGoodResult = false;
+         }
+         else {
+            //Inform soundtouch there's a single channel
+            soundTouch.setChannels(1);
+            if (!ProcessOne(&soundTouch,
+                  task.leftTrack, task.start, task.end, warper))
+               bGoodResult = false;
+         }
+         if (!bGoodResult)
+            break;
+      }
+   }
+   else if (bGoodResult) {
+      // Workers claim tasks, stretch into new tracks, and leave the
+      // results for the main thread to splice in below
+      std::vector<std::shared_ptr<WaveTrack>> outputsLeft( tasks.size() );
+      std::vector<std::shared_ptr<WaveTrack>> outputsRight( tasks.size() );
+      ArrayOf<std::atomic<double>> fractions{ tasks.size(), true };
+      std::atomic<size_t> nextTask{ 0 };
+      std::atomic<bool> cancel{ false };
+      std::atomic<unsigned> nRunning{ nWorkers };
+      std::vector<std::exception_ptr> exceptions( nWorkers );
+      std::vector<std::thread> workers;
+
+      for (unsigned ii = 0; ii < nWorkers; ++ii) {
+         workers.emplace_back( [&, ii]{
+            try {
+               for (;;) {
+                  auto index = nextTask++;
+                  if (index >= tasks.size() || cancel.load())
+                     break;
+                  auto &task = tasks[index];
+                  soundtouch::SoundTouch soundTouch;
+                  initer(soundTouch);
+                  bool ok;
+                  if (task.rightTrack) {
+                     soundTouch.setChannels(2);
+                     ok = ProcessStereo(&soundTouch,
+                        task.leftTrack, task.rightTrack, task.start, task.end,
+                        warper, &fractions[index], &cancel,
+                        &outputsLeft[index], &outputsRight[index]);
+                  }
+                  else {
+                     soundTouch.setChannels(1);
+                     ok = ProcessOne(&soundTouch,
+                        task.leftTrack, task.start, task.end,
+                        warper, &fractions[index], &cancel,
+                        &outputsLeft[index]);
+                  }
+                  if (!ok) {
+                     cancel.store(true);
+                     break;
+                  }
+                  fractions[index].store(1.0);
+               }
+            }
+            catch (...) {
+               exceptions[ii] = std::current_exception();
+               cancel.store(true);
+            }
+            --nRunning;
+         } );
+      }
+
+      // Poll for progress on the main thread, which alone may update the
+      // dialog or cancel
+      while (nRunning.load() > 0) {
+         wxMilliSleep(50);
+         double sum = 0.0;
+         for (size_t index = 0; index < tasks.size(); ++index)
+            sum += fractions[index].load();
+         if (TotalProgress(sum / tasks.size()))
+            cancel.store(true);
+      }
+      for (auto &worker : workers)
+         worker.join();
+      for (auto &pException : exceptions)
+         if (pException)
+            std::rethrow_exception(pException);
+
+      if (cancel.load())
+         bGoodResult = false;
+      else {
+         // Take the output tracks and insert in place of the original
+         // sample data, in the original track order
+         for (size_t index = 0; index < tasks.size(); ++index) {
+            auto &task = tasks[index];
+            task.leftTrack->ClearAndPaste(task.curT0, task.curT1,
+               outputsLeft[index].get(), true, false, &warper);
+            m_maxNewLength =
+               wxMax(m_maxNewLength, outputsLeft[index]->GetEndTime());
+            if (task.rightTrack) {
+               task.rightTrack->ClearAndPaste(task.curT0, task.curT1,
+                  outputsRight[index].get(), true, false, &warper);
+               m_maxNewLength =
+                  wxMax(m_maxNewLength, outputsRight[index]->GetEndTime());
+            }
+         }
+      }
+   }
+
    if (bGoodResult)
       ReplaceProcessedTracks(bGoodResult);
 
@@ -176,18 +299,17 @@ bool EffectSoundTouch::ProcessWithTimeWarper(const TimeWarper &warper)
    return bGoodResult;
 }
 
-void EffectSoundTouch::End()
-{
-   mSoundTouch.reset();
-}
-
 //ProcessOne() takes a track, transforms it to bunch of buffer-blocks,
 //and executes ProcessSoundTouch on these blocks
-bool EffectSoundTouch::ProcessOne(WaveTrack *track,
+bool EffectSoundTouch::ProcessOne(soundtouch::SoundTouch *pSoundTouch,
+                                  WaveTrack *track,
                                   sampleCount start, sampleCount end,
-                                  const TimeWarper &warper)
+                                  const TimeWarper &warper,
+                                  std::atomic<double> *pFraction,
+                                  std::atomic<bool> *pCancel,
+                                  std::shared_ptr<WaveTrack> *pOutput)
 {
-   mSoundTouch->setSampleRate((unsigned int)(track->GetRate()+0.5));
+   pSoundTouch->setSampleRate((unsigned int)(track->GetRate()+0.5));
 
    auto outputTrack = mFactory->NewWaveTrack(track->GetSampleFormat(), track->GetRate());
 
@@ -213,31 +335,36 @@ bool EffectSoundTouch::ProcessOne(WaveTrack *track,
          track->Get((samplePtr)buffer.get(), floatSample, s, block);
 
          //Add samples to SoundTouch
-         mSoundTouch->putSamples(buffer.get(), block);
+         pSoundTouch->putSamples(buffer.get(), block);
 
          //Get back samples from SoundTouch
-         unsigned int outputCount = mSoundTouch->numSamples();
+         unsigned int outputCount = pSoundTouch->numSamples();
          if (outputCount > 0) {
             Floats buffer2{ outputCount };
-            mSoundTouch->receiveSamples(buffer2.get(), outputCount);
+            pSoundTouch->receiveSamples(buffer2.get(), outputCount);
             outputTrack->Append((samplePtr)buffer2.get(), floatSample, outputCount);
          }
 
          //Increment s one blockfull of samples
          s += block;
 
-         //Update the Progress meter
-         if (TrackProgress(mCurTrackNum, (s - start).as_double() / len))
+         //Update the Progress meter, or report to the main thread
+         if (pFraction) {
+            pFraction->store((s - start).as_double() / len);
+            if (pCancel->load())
+               return false;
+         }
+         else if (TrackProgress(mCurTrackNum, (s - start).as_double() / len))
             return false;
       }
 
       // Tell SoundTouch to finish processing any remaining samples
-      mSoundTouch->flush();   // this should only be used for changeTempo - it dumps data otherwise with pRateTransposer->clear();
+      pSoundTouch->flush();   // this should only be used for changeTempo - it dumps data otherwise with pRateTransposer->clear();
 
-      unsigned int outputCount = mSoundTouch->numSamples();
+      unsigned int outputCount = pSoundTouch->numSamples();
       if (outputCount > 0) {
          Floats buffer2{ outputCount };
-         mSoundTouch->receiveSamples(buffer2.get(), outputCount);
+         pSoundTouch->receiveSamples(buffer2.get(), outputCount);
          outputTrack->Append((samplePtr)buffer2.get(), floatSample, outputCount);
       }
 
@@ -245,6 +372,12 @@ bool EffectSoundTouch::ProcessOne(WaveTrack *track,
       outputTrack->Flush();
    }
 
+   if (pOutput) {
+      // Leave pasting and bookkeeping to the main thread
+      *pOutput = std::move(outputTrack);
+      return true;
+   }
+
    // Take the output track and insert it in place of the original
    // sample data
    track->ClearAndPaste(mCurT0, mCurT1, outputTrack.get(), true, false, &warper);
@@ -257,10 +390,14 @@ bool EffectSoundTouch::ProcessOne(WaveTrack *track,
 }
 
 bool EffectSoundTouch::ProcessStereo(
+   soundtouch::SoundTouch *pSoundTouch,
    WaveTrack* leftTrack, WaveTrack* rightTrack,
-   sampleCount start, sampleCount end, const TimeWarper &warper)
+   sampleCount start, sampleCount end, const TimeWarper &warper,
+   std::atomic<double> *pFraction, std::atomic<bool> *pCancel,
+   std::shared_ptr<WaveTrack> *pOutputLeft,
+   std::shared_ptr<WaveTrack> *pOutputRight)
 {
-   mSoundTouch->setSampleRate((unsigned int)(leftTrack->GetRate() + 0.5));
+   pSoundTouch->setSampleRate((unsigned int)(leftTrack->GetRate() + 0.5));
 
    auto outputLeftTrack = mFactory->NewWaveTrack(leftTrack->GetSampleFormat(),
                                                        leftTrack->GetRate());
@@ -304,44 +441,59 @@ bool EffectSoundTouch::ProcessStereo(
          }
 
          //Add samples to SoundTouch
-         mSoundTouch->putSamples(soundTouchBuffer.get(), blockSize);
+         pSoundTouch->putSamples(soundTouchBuffer.get(), blockSize);
 
          //Get back samples from SoundTouch
-         unsigned int outputCount = mSoundTouch->numSamples();
+         unsigned int outputCount = pSoundTouch->numSamples();
          if (outputCount > 0)
-            this->ProcessStereoResults(outputCount, outputLeftTrack.get(), outputRightTrack.get());
+            this->ProcessStereoResults(pSoundTouch, outputCount, outputLeftTrack.get(), outputRightTrack.get());
 
          //Increment sourceSampleCount one blockfull of samples
          sourceSampleCount += blockSize;
 
-         //Update the Progress meter
-         // mCurTrackNum is left track. Include right track.
-         int nWhichTrack = mCurTrackNum;
          double frac = (sourceSampleCount - start).as_double() / len;
-         if (frac < 0.5)
-            frac *= 2.0; // Show twice as far for each track, because we're doing 2 at once.
-         else
-         {
-            nWhichTrack++;
-            frac -= 0.5;
-            frac *= 2.0; // Show twice as far for each track, because we're doing 2 at once.
+         if (pFraction) {
+            // Report to the main thread instead of the dialog
+            pFraction->store(frac);
+            if (pCancel->load())
+               return false;
+         }
+         else {
+            //Update the Progress meter
+            // mCurTrackNum is left track. Include right track.
+            int nWhichTrack = mCurTrackNum;
+            if (frac < 0.5)
+               frac *= 2.0; // Show twice as far for each track, because we're doing 2 at once.
+            else
+            {
+               nWhichTrack++;
+               frac -= 0.5;
+               frac *= 2.0; // Show twice as far for each track, because we're doing 2 at once.
+            }
+            if (TrackProgress(nWhichTrack, frac))
+               return false;
          }
-         if (TrackProgress(nWhichTrack, frac))
-            return false;
       }
 
       // Tell SoundTouch to finish processing any remaining samples
-      mSoundTouch->flush();
+      pSoundTouch->flush();
 
-      unsigned int outputCount = mSoundTouch->numSamples();
+      unsigned int outputCount = pSoundTouch->numSamples();
       if (outputCount > 0)
-         this->ProcessStereoResults(outputCount, outputLeftTrack.get(), outputRightTrack.get());
+         this->ProcessStereoResults(pSoundTouch, outputCount, outputLeftTrack.get(), outputRightTrack.get());
 
       // Flush the output WaveTracks (since they're buffered, too)
       outputLeftTrack->Flush();
       outputRightTrack->Flush();
    }
 
+   if (pOutputLeft) {
+      // Leave pasting and bookkeeping to the main thread
+      *pOutputLeft = std::move(outputLeftTrack);
+      *pOutputRight = std::move(outputRightTrack);
+      return true;
+   }
+
    // Take the output tracks and insert in place of the original
    // sample data.
    leftTrack->ClearAndPaste(
@@ -359,12 +511,13 @@ bool EffectSoundTouch::ProcessStereo(
    return true;
 }
 
-bool EffectSoundTouch::ProcessStereoResults(const size_t outputCount,
+bool EffectSoundTouch::ProcessStereoResults(soundtouch::SoundTouch *pSoundTouch,
+                                            const size_t outputCount,
                                             WaveTrack* outputLeftTrack,
                                             WaveTrack* outputRightTrack)
 {
    Floats outputSoundTouchBuffer{ outputCount * 2 };
-   mSoundTouch->receiveSamples(outputSoundTouchBuffer.get(), outputCount);
+   pSoundTouch->receiveSamples(outputSoundTouchBuffer.get(), outputCount);
 
    // Dis-interleave outputSoundTouchBuffer into separate track buffers.
    Floats outputLeftBuffer{ outputCount };
@@ -19,6 +19,9 @@
 #ifndef __AUDACITY_EFFECT_SOUNDTOUCH__
 #define __AUDACITY_EFFECT_SOUNDTOUCH__
 
+#include <atomic>
+#include <functional>
+
 #include "Effect.h"
 
 // forward declaration of a class defined in SoundTouch.h
@@ -32,10 +35,6 @@ class WaveTrack;
 class EffectSoundTouch /* not final */ : public Effect
 {
 public:
-   
-   // Effect implementation
-
-   void End() override;
 
    // EffectSoundTouch implementation
 
@@ -48,9 +47,12 @@ public:
 protected:
    // Effect implementation
 
-   bool ProcessWithTimeWarper(const TimeWarper &warper);
+   // Configures a SoundTouch instance with the subclass's parameters;
+   // each track gets its own instance, possibly on its own thread
+   using InitFunction = std::function< void(soundtouch::SoundTouch&) >;
+
+   bool ProcessWithTimeWarper(InitFunction initer, const TimeWarper &warper);
 
-   std::unique_ptr<soundtouch::SoundTouch> mSoundTouch;
    double mCurT0;
    double mCurT1;
 
@@ -60,12 +62,22 @@ private:
    bool ProcessNoteTrack(NoteTrack *track, const TimeWarper &warper);
 #endif
    bool ProcessOne(
+      soundtouch::SoundTouch *pSoundTouch,
       WaveTrack * t, sampleCount start, sampleCount end,
-      const TimeWarper &warper);
-   bool ProcessStereo(WaveTrack* leftTrack, WaveTrack* rightTrack,
-                     sampleCount start, sampleCount end,
-                      const TimeWarper &warper);
-   bool ProcessStereoResults(const size_t outputCount,
+      const TimeWarper &warper,
+      std::atomic<double> *pFraction = nullptr,
+      std::atomic<bool> *pCancel = nullptr,
+      std::shared_ptr<WaveTrack> *pOutput = nullptr);
+   bool ProcessStereo(soundtouch::SoundTouch *pSoundTouch,
+                      WaveTrack* leftTrack, WaveTrack* rightTrack,
+                      sampleCount start, sampleCount end,
+                      const TimeWarper &warper,
+                      std::atomic<double> *pFraction = nullptr,
+                      std::atomic<bool> *pCancel = nullptr,
+                      std::shared_ptr<WaveTrack> *pOutputLeft = nullptr,
+                      std::shared_ptr<WaveTrack> *pOutputRight = nullptr);
+   bool ProcessStereoResults(soundtouch::SoundTouch *pSoundTouch,
+                              const size_t outputCount,
                               WaveTrack* outputLeftTrack,
                               WaveTrack* outputRightTrack);
 
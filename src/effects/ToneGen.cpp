@@ -200,6 +200,34 @@ size_t EffectToneGen::ProcessBlock(float **WXUNUSED(inBlock), float **outBlock,
       BlendedFrequency = mFrequency[0] + frequencyQuantum * doubleSample;
    }
 
+   if (mWaveform == kSine && frequencyQuantum == 0.0)
+   {
+      // A constant-frequency sine needs no transcendental call per sample:
+      // advance the oscillator by the two-term recurrence
+      //    sin(p + d) = 2 cos(d) sin(p) - sin(p - d),
+      // re-seeded from the library each block so no error accumulates
+      // across blocks.
+      const double delta = pre2PI * BlendedFrequency / mSampleRate;
+      const double phase = pre2PI * mPositionInCycles / mSampleRate;
+      const double coefficient = 2.0 * cos(delta);
+      double s0 = sin(phase - delta);
+      double s1 = sin(phase);
+      for (decltype(blockLen) i = 0; i < blockLen; i++)
+      {
+         buffer[i] = (float) (BlendedAmplitude * s1);
+         const double s2 = coefficient * s1 - s0;
+         s0 = s1;
+         s1 = s2;
+         mPositionInCycles += BlendedFrequency;
+         BlendedAmplitude += amplitudeQuantum;
+      }
+
+      // update external placeholder
+      mSample += blockLen;
+
+      return blockLen;
+   }
+
    // synth loop
    for (decltype(blockLen) i = 0; i < blockLen; i++)
    {
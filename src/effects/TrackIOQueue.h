@@ -0,0 +1,113 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  TrackIOQueue.h
+
+  Split from Effect.cpp
+
+**********************************************************************/
+
+#ifndef __AUDACITY_TRACK_IO_QUEUE__
+#define __AUDACITY_TRACK_IO_QUEUE__
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+// A single worker that runs track reads and writes, in order, off the
+// processing thread, so that an effect can crunch one buffer while the
+// next input is fetched and the previously filled output is stored.
+// Wait() rethrows on the calling thread whatever a job threw, such as a
+// FileException from a failed fetch.  The destructor finishes any work
+// still queued.
+class TrackIOQueue
+{
+public:
+   using Ticket = unsigned long long;
+
+   TrackIOQueue()
+      : mThread{ [this]{ Run(); } }
+   {}
+
+   ~TrackIOQueue()
+   {
+      {
+         std::lock_guard<std::mutex> guard{ mMutex };
+         mDone = true;
+      }
+      mRequest.notify_one();
+      mThread.join();
+   }
+
+   Ticket Post(std::function<void()> job)
+   {
+      std::lock_guard<std::mutex> guard{ mMutex };
+      mJobs.push_back(std::move(job));
+      mRequest.notify_one();
+      return ++mPosted;
+   }
+
+   // Wait until the job with the given ticket has finished.  Ticket 0 is
+   // never issued and returns at once.
+   void Wait(Ticket ticket)
+   {
+      std::unique_lock<std::mutex> lock{ mMutex };
+      mCompletion.wait(lock, [&]{ return mFinished >= ticket; });
+      if (mException) {
+         std::exception_ptr pException;
+         std::swap(pException, mException);
+         std::rethrow_exception(pException);
+      }
+   }
+
+   // Wait for everything posted so far
+   void Finish()
+   {
+      Ticket posted;
+      {
+         std::lock_guard<std::mutex> guard{ mMutex };
+         posted = mPosted;
+      }
+      Wait(posted);
+   }
+
+private:
+   void Run()
+   {
+      std::unique_lock<std::mutex> lock{ mMutex };
+      for (;;) {
+         mRequest.wait(lock, [&]{ return mDone || !mJobs.empty(); });
+         if (mJobs.empty())
+            break;
+         auto job = std::move(mJobs.front());
+         mJobs.pop_front();
+         lock.unlock();
+         std::exception_ptr pException;
+         try {
+            job();
+         }
+         catch (...) {
+            pException = std::current_exception();
+         }
+         lock.lock();
+         if (pException && !mException)
+            mException = pException;
+         ++mFinished;
+         mCompletion.notify_all();
+      }
+   }
+
+   std::mutex mMutex;
+   std::condition_variable mRequest, mCompletion;
+   std::deque<std::function<void()>> mJobs;
+   Ticket mPosted{ 0 }, mFinished{ 0 };
+   std::exception_ptr mException;
+   bool mDone{ false };
+   std::thread mThread;
+};
+
+#endif
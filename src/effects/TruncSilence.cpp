@@ -30,6 +30,7 @@
 #include "../Prefs.h"
 #include "../Project.h"
 #include "../ProjectSettings.h"
+#include "../Sequence.h"
 #include "../Shuttle.h"
 #include "../ShuttleGui.h"
 #include "../WaveTrack.h"
@@ -615,6 +616,18 @@ bool EffectTruncSilence::Analyze(RegionList& silenceList,
    // Allocate buffer
    Floats buffer{ blockLen };
 
+   // Summary-first detection:  the block summaries bound the min and max
+   // of each group of at most 256 samples, so a group whose peak reaches
+   // the threshold is known non-silent without reading samples, and a
+   // qualifying silence must span whole quiet groups.  Samples are then
+   // read only around candidate quiet groups.  Runs hidden between the
+   // groups that are read can be as long as two groups, so this needs
+   // minSilenceFrames of at least that; and the preview-length estimate
+   // needs a sample-exact count of the non-silent part, so it still
+   // reads everything.
+   const bool useSummaries = !inputLength && minSilenceFrames >= 512;
+   std::vector<SummaryFrame> frames;
+
    // Loop through current track
    while (*index < end) {
       if (inputLength && ((outLength >= previewLen) || (*index - start > wt->TimeToLongSamples(*minInputLength)))) {
@@ -680,6 +693,72 @@ bool EffectTruncSilence::Analyze(RegionList& silenceList,
       // Limit size of current block if we've reached the end
       auto count = limitSampleBufferSize( blockLen, end - *index );
 
+      if (useSummaries) {
+         frames.clear();
+         if (wt->GetSummaries256(*index, count, frames)) {
+            const size_t nFrames = frames.size();
+            auto quiet = [&](size_t f) {
+               return std::max(fabs(frames[f].min), fabs(frames[f].max))
+                  < truncDbSilenceThreshold;
+            };
+            // The first and last frames are always read, so that runs
+            // crossing into the neighbouring blocks stay sample-exact
+            auto needSamples = [&](size_t f) {
+               return f == 0 || f == nFrames - 1 ||
+                  quiet(f - 1) || quiet(f) || quiet(f + 1);
+            };
+            size_t f = 0;
+            while (f < nFrames) {
+               if (!needSamples(f)) {
+                  // A span of groups, each known to contain a sample at
+                  // or above the threshold, with such groups on both
+                  // sides:  no silence of minSilenceFrames can start or
+                  // end in it, and any run crossing its edges dies at a
+                  // peak within two groups, so the carry can be dropped
+                  do
+                     ++f;
+                  while (!needSamples(f));
+                  *silentFrame = 0;
+                  continue;
+               }
+
+               // A span of groups around quiet candidates:  read the
+               // samples and scan them as usual
+               const size_t f0 = f;
+               do
+                  ++f;
+               while (f < nFrames && needSamples(f));
+               auto from = std::max( *index, frames[f0].start );
+               auto to = std::min( *index + count,
+                  frames[f - 1].start + frames[f - 1].len );
+               auto n = ( to - from ).as_size_t();
+               wt->Get((samplePtr)(buffer.get()), floatSample, from, n);
+
+               for (decltype(n) i = 0; i < n; ++i) {
+                  if (fabs(buffer[i]) < truncDbSilenceThreshold) {
+                     (*silentFrame)++;
+                  }
+                  else {
+                     if (*silentFrame >= minSilenceFrames) {
+                        // Record the silent region
+                        trackSilences.push_back(Region(
+                           wt->LongSamplesToTime(from + i - *silentFrame),
+                           wt->LongSamplesToTime(from + i)
+                        ));
+                     }
+                     *silentFrame = 0;
+                  }
+               }
+            }
+
+            // Next block
+            *index += count;
+            continue;
+         }
+         // No summaries for some of this block (such as a clip
+         // boundary); fall through to reading the samples
+      }
+
       // Fill buffer
       wt->Get((samplePtr)(buffer.get()), floatSample, *index, count);
 
@@ -22,6 +22,7 @@ doing the second pass over all selected tracks.
 #include "TwoPassSimpleMono.h"
 
 #include "../WaveTrack.h"
+#include "TrackIOQueue.h"
 
 bool EffectTwoPassSimpleMono::Process()
 {
@@ -102,15 +103,42 @@ bool EffectTwoPassSimpleMono::ProcessOne(WaveTrack * track,
    auto len = (end - start).as_double();
    auto maxblock = track->GetMaxBlockSize();
 
-   //Initiate a processing buffer.  This buffer will (most likely)
-   //be shorter than the length of the track being processed.
+   //Initiate processing buffers.  Each buffer will (most likely)
+   //be shorter than the length of the track being processed.  Three of
+   //them circulate: the previous block being stored, the current block
+   //being processed, and the next block being fetched.
    Floats buffer1{ maxblock };
    Floats buffer2{ maxblock };
-   auto samples1 =  limitSampleBufferSize(
-      std::min( maxblock, track->GetBestBlockSize(start) ), end - start );
-
-   //Get the samples from the track and put them in the buffer
-   track->Get((samplePtr) buffer1.get(), floatSample, start, samples1);
+   Floats buffer3{ maxblock };
+   size_t samples1 = 0;
+   size_t samples2 = 0;
+
+   // One worker performs the fetches and stores in the order they were
+   // posted, so that the track reads and writes overlap the processing of
+   // the current block.  Declared after the buffers, so that its
+   // destructor finishes any still pending jobs before they are freed.
+   TrackIOQueue io;
+   TrackIOQueue::Ticket readTicket = 0;
+
+   // The length of the pending fetch, found by the worker; read it only
+   // after waiting on the fetch's ticket
+   size_t pendingSamples = 0;
+
+   // Post a fetch of the block at the given position.  The buffer pointer
+   // is captured by value, because the Floats that own the storage are
+   // rotated on this thread while the job may still be running.
+   auto postRead = [&](float *buffer, sampleCount pos) {
+      return io.Post([=, &pendingSamples]{
+         pendingSamples = limitSampleBufferSize(
+            std::min( maxblock, track->GetBestBlockSize(pos) ), end - pos );
+         track->Get((samplePtr) buffer, floatSample, pos, pendingSamples);
+      });
+   };
+
+   //Get the first samples from the track and put them in the buffer;
+   //rethrows if the fetch failed
+   io.Wait(postRead(buffer1.get(), start));
+   samples1 = pendingSamples;
 
    // Process the first buffer with a NULL previous buffer
    if (mPass == 0)
@@ -124,15 +152,19 @@ bool EffectTwoPassSimpleMono::ProcessOne(WaveTrack * track,
    //Go through the track one buffer at a time. s counts which
    //sample the current buffer starts at.
    auto s = start + samples1;
+   if (s < end)
+      readTicket = postRead(buffer2.get(), s);
    while (s < end) {
-      //Get a block of samples (smaller than the size of the buffer)
-      //Adjust the block size if it is the final block in the track
-      auto samples2 = limitSampleBufferSize(
-         std::min( track->GetBestBlockSize(s), maxblock ), end - s
-      );
+      //Wait for the pending fetch of the current block; rethrows if it,
+      //or any earlier store, failed
+      io.Wait(readTicket);
+      samples2 = pendingSamples;
 
-      //Get the samples from the track and put them in the buffer
-      track->Get((samplePtr)buffer2.get(), floatSample, s, samples2);
+      //Start fetching the block after this one, to be processed on the
+      //next trip through the loop.  The queue runs it only after the
+      //store that last used the same buffer.
+      if (s + samples2 < end)
+         readTicket = postRead(buffer3.get(), s + samples2);
 
       //Process the buffer.  If it fails, clean up and exit.
       if (mPass == 0)
@@ -145,7 +177,9 @@ bool EffectTwoPassSimpleMono::ProcessOne(WaveTrack * track,
 
       //Processing succeeded. copy the newly-changed samples back
       //onto the track.
-      track->Set((samplePtr)buffer1.get(), floatSample, s - samples1, samples1);
+      io.Post([track, buf = buffer1.get(), pos = s - samples1, len1 = samples1]{
+         track->Set((samplePtr)buf, floatSample, pos, len1);
+      });
 
       //Increment s one blockfull of samples
       s += samples2;
@@ -165,8 +199,8 @@ bool EffectTwoPassSimpleMono::ProcessOne(WaveTrack * track,
 
       // Rotate the buffers
       buffer1.swap(buffer2);
-
-      std::swap(samples1, samples2);
+      buffer2.swap(buffer3);
+      samples1 = samples2;
    }
 
    // Send the last buffer with a NULL pointer for the current buffer
@@ -181,7 +215,12 @@ bool EffectTwoPassSimpleMono::ProcessOne(WaveTrack * track,
 
    //Processing succeeded. copy the newly-changed samples back
    //onto the track.
-   track->Set((samplePtr)buffer1.get(), floatSample, s - samples1, samples1);
+   io.Post([track, buf = buffer1.get(), pos = s - samples1, len1 = samples1]{
+      track->Set((samplePtr)buf, floatSample, pos, len1);
+   });
+
+   //Wait for all of the stores; rethrows if any of them failed
+   io.Finish();
 
    //Return true because the effect processing succeeded.
    return true;
@@ -52,6 +52,7 @@
 #include <wx/combobox.h>
 #include <wx/dcclient.h>
 #include <wx/file.h>
+#include <wx/fileconf.h>
 #include <wx/filename.h>
 #include <wx/imaglist.h>
 #include <wx/listctrl.h>
@@ -495,6 +496,102 @@ PluginPaths VSTEffectsModule::FindPluginPaths(PluginManagerInterface & pm)
    return { files.begin(), files.end() };
 }
 
+namespace {
+
+// The modification time and size of a plugin binary, in one string,
+// used to decide whether a cached probe result is still good.  Empty
+// if the plugin cannot be found.
+wxString ProbeStamp(const PluginPath & path)
+{
+   if (wxFileName::FileExists(path))
+   {
+      wxFileName fn{ path };
+      return wxString::Format(wxT("%lld:%llu"),
+         (long long) fn.GetModificationTime().GetTicks(),
+         (unsigned long long) fn.GetSize().GetValue());
+   }
+
+   // A VST bundle on Mac is a directory
+   if (wxFileName::DirExists(path))
+   {
+      wxFileName fn;
+      fn.AssignDir(path);
+      return wxString::Format(wxT("%lld:0"),
+         (long long) fn.GetModificationTime().GetTicks());
+   }
+
+   return {};
+}
+
+// Probe results, cached across runs and keyed by the binary's time
+// stamp and size, so a plugin is handed to the probe subprocess only
+// when it is new or has changed.  The subprocess output is stored
+// verbatim and replayed through the same parsing as a live probe.
+class ProbeCache
+{
+public:
+   ProbeCache()
+   : mConfig{ wxEmptyString, wxEmptyString,
+      FileNames::PluginScanCache(), wxEmptyString,
+      wxCONFIG_USE_LOCAL_FILE }
+   {
+   }
+
+   bool Lookup(const wxString & key, const wxString & stamp,
+               wxString & output)
+   {
+      const auto group = Find(key);
+      if (group.empty() ||
+          mConfig.Read(group + wxT("/stamp"), wxString{}) != stamp)
+      {
+         return false;
+      }
+      output = mConfig.Read(group + wxT("/output"), wxString{});
+      return true;
+   }
+
+   void Store(const wxString & key, const wxString & stamp,
+              const wxString & output)
+   {
+      auto group = Find(key);
+      if (group.empty())
+      {
+         mConfig.SetPath(wxT("/probes"));
+         group = wxString::Format(wxT("/probes/%ld"),
+            (long) mConfig.GetNumberOfGroups() + 1);
+         mConfig.Write(group + wxT("/key"), key);
+      }
+      mConfig.Write(group + wxT("/stamp"), stamp);
+      mConfig.Write(group + wxT("/output"), output);
+      mConfig.Flush();
+   }
+
+private:
+   // Returns the config group holding this key, or empty.  Keys are
+   // paths, which cannot themselves name config groups, so each entry
+   // is a numbered group recording its key.
+   wxString Find(const wxString & key)
+   {
+      mConfig.SetPath(wxT("/probes"));
+      wxString group;
+      long ndx;
+      for (bool more = mConfig.GetFirstGroup(group, ndx);
+           more;
+           more = mConfig.GetNextGroup(group, ndx))
+      {
+         if (mConfig.Read(group + wxT("/key"), wxString{}) == key)
+         {
+            return wxT("/probes/") + group;
+         }
+      }
+      return {};
+   }
+
+   wxFileConfig mConfig;
+};
+
+}
+
 unsigned VSTEffectsModule::DiscoverPluginsAtPath(
    const PluginPath & path, wxString &errMsg,
    const RegistrationCallback &callback)
@@ -505,6 +602,9 @@ unsigned VSTEffectsModule::DiscoverPluginsAtPath(
    // TODO:  Fix this for external usage
    const auto &cmdpath = PlatformCompatibility::GetExecutablePath();
 
+   static ProbeCache cache;
+   const wxString stamp = ProbeStamp(path);
+
    wxString effectIDs = wxT("0;");
    wxStringTokenizer effectTzr(effectIDs, wxT(";"));
 
@@ -518,27 +618,37 @@ unsigned VSTEffectsModule::DiscoverPluginsAtPath(
    {
       wxString effectID = effectTzr.GetNextToken();
 
-      wxString cmd;
-      cmd.Printf(wxT("\"%s\" %s \"%s;%s\""), cmdpath, VSTCMDKEY, path, effectID);
-
       VSTSubProcess proc;
-      try
+      wxString output;
+      const wxString cacheKey = path + wxT(";") + effectID;
+      if (stamp.empty() || !cache.Lookup(cacheKey, stamp, output))
       {
-         int flags = wxEXEC_SYNC | wxEXEC_NODISABLE;
+         wxString cmd;
+         cmd.Printf(wxT("\"%s\" %s \"%s;%s\""), cmdpath, VSTCMDKEY, path, effectID);
+
+         try
+         {
+            int flags = wxEXEC_SYNC | wxEXEC_NODISABLE;
 #if defined(__WXMSW__)
-         flags += wxEXEC_NOHIDE;
+            flags += wxEXEC_NOHIDE;
 #endif
-         wxExecute(cmd, flags, &proc);
-      }
-      catch (...)
-      {
-         wxLogMessage(_("VST plugin registration failed for %s\n"), path);
-         error = true;
-      }
+            wxExecute(cmd, flags, &proc);
+         }
+         catch (...)
+         {
+            wxLogMessage(_("VST plugin registration failed for %s\n"), path);
+            error = true;
+         }
 
-      wxString output;
-      wxStringOutputStream ss(&output);
-      proc.GetInputStream()->Read(ss);
+         wxStringOutputStream ss(&output);
+         proc.GetInputStream()->Read(ss);
+
+         // Cache the output even when the plugin took its subprocess
+         // down with it:  the partial output registers nothing, and
+         // remembering that costs one probe ever, not one per scan
+         if (!error && !stamp.empty())
+            cache.Store(cacheKey, stamp, output);
+      }
 
       int keycount = 0;
       bool haveBegin = false;
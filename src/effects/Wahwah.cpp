@@ -149,7 +149,7 @@ bool EffectWahwah::ProcessInitialize(sampleCount WXUNUSED(totalLen), ChannelName
 
 size_t EffectWahwah::ProcessBlock(float **inBlock, float **outBlock, size_t blockLen)
 {
-   return InstanceProcess(mMaster, inBlock, outBlock, blockLen);
+   return InstanceProcess(CurrentSettings(), mMaster, inBlock, outBlock, blockLen);
 }
 
 bool EffectWahwah::RealtimeInitialize()
@@ -158,6 +158,10 @@ bool EffectWahwah::RealtimeInitialize()
 
    mSlaves.clear();
 
+   // Seed the mailbox so the audio thread starts from the current settings
+   mSettingsMessage.Initialize();
+   mSettingsMessage.Write(CurrentSettings());
+
    return true;
 }
 
@@ -185,7 +189,11 @@ size_t EffectWahwah::RealtimeProcess(int group,
                                           size_t numSamples)
 {
 
-   return InstanceProcess(mSlaves[group], inbuf, outbuf, numSamples);
+   // Adopt whatever the UI thread last published; reading the mailbox
+   // never blocks, so the stream need not be suspended while tweaking
+   const auto settings = mSettingsMessage.Read();
+
+   return InstanceProcess(settings, mSlaves[group], inbuf, outbuf, numSamples);
 }
 
 bool EffectWahwah::DefineParams( ShuttleParams & S ){
@@ -226,6 +234,8 @@ bool EffectWahwah::SetAutomationParameters(CommandParameters & parms)
    mFreqOfs = FreqOfs;
    mOutGain = OutGain;
 
+   mSettingsMessage.Write(CurrentSettings());
+
    return true;
 }
 
@@ -333,6 +343,11 @@ bool EffectWahwah::TransferDataFromWindow()
 
 // EffectWahwah implementation
 
+EffectWahwahSettings EffectWahwah::CurrentSettings() const
+{
+   return { mFreq, mPhase, mDepth, mRes, mFreqOfs, mOutGain };
+}
+
 void EffectWahwah::InstanceInit(EffectWahwahState & data, float sampleRate)
 {
    data.samplerate = sampleRate;
@@ -355,19 +370,20 @@ void EffectWahwah::InstanceInit(EffectWahwahState & data, float sampleRate)
    data.outgain = DB_TO_LINEAR(mOutGain);
 }
 
-size_t EffectWahwah::InstanceProcess(EffectWahwahState & data, float **inBlock, float **outBlock, size_t blockLen)
+size_t EffectWahwah::InstanceProcess(const EffectWahwahSettings & settings,
+   EffectWahwahState & data, float **inBlock, float **outBlock, size_t blockLen)
 {
    float *ibuf = inBlock[0];
    float *obuf = outBlock[0];
    double frequency, omega, sn, cs, alpha;
    double in, out;
 
-   data.lfoskip = mFreq * 2 * M_PI / data.samplerate;
-   data.depth = mDepth / 100.0;
-   data.freqofs = mFreqOfs / 100.0;
+   data.lfoskip = settings.freq * 2 * M_PI / data.samplerate;
+   data.depth = settings.depth / 100.0;
+   data.freqofs = settings.freqOfs / 100.0;
 
-   data.phase = mPhase * M_PI / 180.0;
-   data.outgain = DB_TO_LINEAR(mOutGain);
+   data.phase = settings.phase * M_PI / 180.0;
+   data.outgain = DB_TO_LINEAR(settings.outGain);
 
    for (decltype(blockLen) i = 0; i < blockLen; i++)
    {
@@ -381,7 +397,7 @@ size_t EffectWahwah::InstanceProcess(EffectWahwahState & data, float **inBlock,
          omega = M_PI * frequency;
          sn = sin(omega);
          cs = cos(omega);
-         alpha = sn / (2 * mRes);
+         alpha = sn / (2 * settings.res);
          data.b0 = (1 - cs) / 2;
          data.b1 = 1 - cs;
          data.b2 = (1 - cs) / 2;
@@ -407,6 +423,7 @@ void EffectWahwah::OnFreqSlider(wxCommandEvent & evt)
    mFreq = (double) evt.GetInt() / SCL_Freq;
    mFreqT->GetValidator()->TransferToWindow();
    EnableApply(mUIParent->Validate());
+   mSettingsMessage.Write(CurrentSettings());
 }
 
 void EffectWahwah::OnPhaseSlider(wxCommandEvent & evt)
@@ -417,6 +434,7 @@ void EffectWahwah::OnPhaseSlider(wxCommandEvent & evt)
    mPhase = (double) val / SCL_Phase;
    mPhaseT->GetValidator()->TransferToWindow();
    EnableApply(mUIParent->Validate());
+   mSettingsMessage.Write(CurrentSettings());
 }
 
 void EffectWahwah::OnDepthSlider(wxCommandEvent & evt)
@@ -424,6 +442,7 @@ void EffectWahwah::OnDepthSlider(wxCommandEvent & evt)
    mDepth = evt.GetInt() / SCL_Depth;
    mDepthT->GetValidator()->TransferToWindow();
    EnableApply(mUIParent->Validate());
+   mSettingsMessage.Write(CurrentSettings());
 }
 
 void EffectWahwah::OnResonanceSlider(wxCommandEvent & evt)
@@ -431,6 +450,7 @@ void EffectWahwah::OnResonanceSlider(wxCommandEvent & evt)
    mRes = (double) evt.GetInt() / SCL_Res;
    mResT->GetValidator()->TransferToWindow();
    EnableApply(mUIParent->Validate());
+   mSettingsMessage.Write(CurrentSettings());
 }
 
 void EffectWahwah::OnFreqOffSlider(wxCommandEvent & evt)
@@ -438,6 +458,7 @@ void EffectWahwah::OnFreqOffSlider(wxCommandEvent & evt)
    mFreqOfs = evt.GetInt() / SCL_FreqOfs;
    mFreqOfsT->GetValidator()->TransferToWindow();
    EnableApply(mUIParent->Validate());
+   mSettingsMessage.Write(CurrentSettings());
 }
 
 void EffectWahwah::OnGainSlider(wxCommandEvent & evt)
@@ -445,6 +466,7 @@ void EffectWahwah::OnGainSlider(wxCommandEvent & evt)
    mOutGain = evt.GetInt() / SCL_OutGain;
    mOutGainT->GetValidator()->TransferToWindow();
    EnableApply(mUIParent->Validate());
+   mSettingsMessage.Write(CurrentSettings());
 }
 
 void EffectWahwah::OnFreqText(wxCommandEvent & WXUNUSED(evt))
@@ -455,6 +477,7 @@ void EffectWahwah::OnFreqText(wxCommandEvent & WXUNUSED(evt))
    }
 
    mFreqS->SetValue((int) (mFreq * SCL_Freq));
+   mSettingsMessage.Write(CurrentSettings());
 }
 
 void EffectWahwah::OnPhaseText(wxCommandEvent & WXUNUSED(evt))
@@ -465,6 +488,7 @@ void EffectWahwah::OnPhaseText(wxCommandEvent & WXUNUSED(evt))
    }
 
    mPhaseS->SetValue((int) (mPhase * SCL_Phase));
+   mSettingsMessage.Write(CurrentSettings());
 }
 
 void EffectWahwah::OnDepthText(wxCommandEvent & WXUNUSED(evt))
@@ -475,6 +499,7 @@ void EffectWahwah::OnDepthText(wxCommandEvent & WXUNUSED(evt))
    }
 
    mDepthS->SetValue((int) (mDepth * SCL_Depth));
+   mSettingsMessage.Write(CurrentSettings());
 }
 
 void EffectWahwah::OnResonanceText(wxCommandEvent & WXUNUSED(evt))
@@ -485,6 +510,7 @@ void EffectWahwah::OnResonanceText(wxCommandEvent & WXUNUSED(evt))
    }
 
    mResS->SetValue((int) (mRes * SCL_Res));
+   mSettingsMessage.Write(CurrentSettings());
 }
 
 void EffectWahwah::OnFreqOffText(wxCommandEvent & WXUNUSED(evt))
@@ -495,6 +521,7 @@ void EffectWahwah::OnFreqOffText(wxCommandEvent & WXUNUSED(evt))
    }
 
    mFreqOfsS->SetValue((int) (mFreqOfs * SCL_FreqOfs));
+   mSettingsMessage.Write(CurrentSettings());
 }
 
 void EffectWahwah::OnGainText(wxCommandEvent & WXUNUSED(evt))
@@ -505,4 +532,5 @@ void EffectWahwah::OnGainText(wxCommandEvent & WXUNUSED(evt))
    }
 
    mOutGainS->SetValue((int) (mOutGain * SCL_OutGain));
+   mSettingsMessage.Write(CurrentSettings());
 }
@@ -17,6 +17,7 @@
 #define __AUDACITY_EFFECT_WAHWAH__
 
 #include "Effect.h"
+#include "../MessageBuffer.h"
 
 class wxSlider;
 class wxTextCtrl;
@@ -24,6 +25,20 @@ class ShuttleGui;
 
 #define WAHWAH_PLUGIN_SYMBOL ComponentInterfaceSymbol{ XO("Wahwah") }
 
+// A complete snapshot of the user parameters.  The UI thread publishes one
+// through a MessageBuffer whenever a control changes and the audio thread
+// adopts the latest at each chunk boundary, so tweaking a control during
+// playback never suspends the stream.
+struct EffectWahwahSettings
+{
+   double freq{ 0.0 };
+   double phase{ 0.0 };
+   int depth{ 0 };
+   double res{ 0.0 };
+   int freqOfs{ 0 };
+   double outGain{ 0.0 };
+};
+
 class EffectWahwahState
 {
 public:
@@ -82,7 +97,11 @@ private:
    // EffectWahwah implementation
 
    void InstanceInit(EffectWahwahState & data, float sampleRate);
-   size_t InstanceProcess(EffectWahwahState & data, float **inBlock, float **outBlock, size_t blockLen);
+   size_t InstanceProcess(const EffectWahwahSettings & settings,
+      EffectWahwahState & data,
+      float **inBlock, float **outBlock, size_t blockLen);
+
+   EffectWahwahSettings CurrentSettings() const;
 
    void OnFreqSlider(wxCommandEvent & evt);
    void OnPhaseSlider(wxCommandEvent & evt);
@@ -102,6 +121,8 @@ private:
    EffectWahwahState mMaster;
    std::vector<EffectWahwahState> mSlaves;
 
+   MessageBuffer<EffectWahwahSettings> mSettingsMessage;
+
    /* Parameters:
    mFreq - LFO frequency
    mPhase - LFO startphase in RADIANS - useful for stereo WahWah
@@ -31,6 +31,7 @@ effects from this one class.
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 
 #include <locale.h>
 
@@ -139,6 +140,7 @@ END_EVENT_TABLE()
 NyquistEffect::NyquistEffect(const wxString &fName)
 {
    mOutputTrack[0] = mOutputTrack[1] = nullptr;
+   mWriteQueue = nullptr;
 
    mAction = XO("Applying Nyquist Effect...");
    mIsPrompt = false;
@@ -599,6 +601,18 @@ bool NyquistEffect::CheckWhetherSkipEffect()
 
 static void RegisterFunctions();
 
+wxString NyquistEffect::GetPreviewCacheKey()
+{
+   auto key = Effect::GetPreviewCacheKey();
+
+   // In the prompt, the code itself may change between auditions without
+   // any change of the controls
+   if (mIsPrompt && !key.empty())
+      key += wxT("\n") + mInputCmd;
+
+   return key;
+}
+
 bool NyquistEffect::Process()
 {
    // Check for reentrant Nyquist commands.
@@ -852,6 +866,10 @@ bool NyquistEffect::Process()
          wxSetlocale(LC_NUMERIC, wxString(wxT("C")));
 
          nyx_init();
+         // Keep the interpreter warm when this invocation is done; macro
+         // chains re-enter Nyquist constantly, and regrowing the xlisp
+         // heap for every effect dominated their startup cost
+         nyx_set_retain_memory(1);
          nyx_set_os_callback(StaticOSCallback, (void *)this);
          nyx_capture_output(StaticOutputCallback, (void *)this);
 
@@ -1309,14 +1327,14 @@ bool NyquistEffect::ProcessOne()
       cmd += mCmd;
    }
 
-   // Put the fetch buffers in a clean initial state
+   // Put the fetch caches in a clean initial state
    for (size_t i = 0; i < mCurNumChannels; i++)
-      mCurBuffer[i].Free();
+      mCurBuffer[i].SetTrack(nullptr);
 
    // Guarantee release of memory when done
    auto cleanup = finally( [&] {
       for (size_t i = 0; i < mCurNumChannels; i++)
-         mCurBuffer[i].Free();
+         mCurBuffer[i].SetTrack(nullptr);
    } );
 
    // Evaluate the expression, which may invoke the get callback, but often does
@@ -1453,17 +1471,23 @@ bool NyquistEffect::ProcessOne()
 
       outputTrack[i] = mFactory->NewWaveTrack(format, rate);
 
-      // Clean the initial buffer states again for the get callbacks
+      // Clean the initial cache states again for the get callbacks
       // -- is this really needed?
-      mCurBuffer[i].Free();
+      mCurBuffer[i].SetTrack(nullptr);
    }
 
-   // Now fully evaluate the sound
+   // Now fully evaluate the sound.  The xlisp core is one instance of
+   // global state, so tracks cannot be evaluated concurrently, but a
+   // writer thread stores each produced buffer while the next is being
+   // computed.
    int success;
    {
       auto vr0 = valueRestorer( mOutputTrack[0], outputTrack[0].get() );
       auto vr1 = valueRestorer( mOutputTrack[1], outputTrack[1].get() );
+      TrackIOQueue writeQueue;
+      auto vr2 = valueRestorer( mWriteQueue, &writeQueue );
       success = nyx_get_audio(StaticPutCallback, (void *)this);
+      writeQueue.Finish();   // may rethrow a failure of a deferred write
    }
 
    // See if GetCallback found read errors
@@ -2224,45 +2248,26 @@ int NyquistEffect::StaticGetCallback(float *buffer, int channel,
 int NyquistEffect::GetCallback(float *buffer, int ch,
                                long start, long len, long WXUNUSED(totlen))
 {
-   if (mCurBuffer[ch].ptr()) {
-      if ((mCurStart[ch] + start) < mCurBufferStart[ch] ||
-          (mCurStart[ch] + start)+len >
-          mCurBufferStart[ch]+mCurBufferLen[ch]) {
-         mCurBuffer[ch].Free();
-      }
-   }
-
-   if (!mCurBuffer[ch].ptr()) {
-      mCurBufferStart[ch] = (mCurStart[ch] + start);
-      mCurBufferLen[ch] = mCurTrack[ch]->GetBestBlockSize(mCurBufferStart[ch]);
-
-      if (mCurBufferLen[ch] < (size_t) len) {
-         mCurBufferLen[ch] = mCurTrack[ch]->GetIdealBlockSize();
-      }
-
-      mCurBufferLen[ch] =
-         limitSampleBufferSize( mCurBufferLen[ch],
-                                mCurStart[ch] + mCurLen - mCurBufferStart[ch] );
+   // The cache pins whole blocks of the track, so requests are served
+   // from block memory into Nyquist's buffer with no staging copy in
+   // between
+   if (mCurBuffer[ch].GetTrack().get() != mCurTrack[ch])
+      mCurBuffer[ch].SetTrack(mCurTrack[ch]->SharedPointer<WaveTrack>());
 
-      mCurBuffer[ch].Allocate(mCurBufferLen[ch], floatSample);
-      try {
-         mCurTrack[ch]->Get(
-            mCurBuffer[ch].ptr(), floatSample,
-            mCurBufferStart[ch], mCurBufferLen[ch]);
-      }
-      catch ( ... ) {
-         // Save the exception object for re-throw when out of the library
-         mpException = std::current_exception();
-         return -1;
-      }
+   constSamplePtr samples;
+   try {
+      samples = mCurBuffer[ch].Get(
+         floatSample, mCurStart[ch] + start, len, true);
    }
+   catch ( ... ) {
+      // Save the exception object for re-throw when out of the library
+      mpException = std::current_exception();
+      return -1;
+   }
+   if (!samples)
+      return -1;
 
-   // We have guaranteed above that this is nonnegative and bounded by
-   // mCurBufferLen[ch]:
-   auto offset = ( mCurStart[ch] + start - mCurBufferStart[ch] ).as_size_t();
-   CopySamples(mCurBuffer[ch].ptr() + offset*SAMPLE_SIZE(floatSample), floatSample,
-               (samplePtr)buffer, floatSample,
-               len);
+   memcpy(buffer, samples, len * SAMPLE_SIZE(floatSample));
 
    if (ch == 0) {
       double progress = mScale *
@@ -2305,7 +2310,17 @@ int NyquistEffect::PutCallback(float *buffer, int channel,
          }
       }
 
-      mOutputTrack[channel]->Append((samplePtr)buffer, floatSample, len);
+      if (mWriteQueue) {
+         // Copy the samples and let the writer thread store them, so the
+         // writes overlap evaluation of the rest of the sound
+         auto data = std::make_shared<std::vector<float>>(buffer, buffer + len);
+         auto track = mOutputTrack[channel];
+         mWriteQueue->Post( [track, data]{
+            track->Append((samplePtr)data->data(), floatSample, data->size());
+         } );
+      }
+      else
+         mOutputTrack[channel]->Append((samplePtr)buffer, floatSample, len);
 
       return 0; // success
    }, MakeSimpleGuard( -1 ) ); // translate all exceptions into failure
@@ -12,6 +12,8 @@
 #define __AUDACITY_EFFECT_NYQUIST__
 
 #include "../Effect.h"
+#include "../TrackIOQueue.h"
+#include "../../WaveTrack.h"
 
 #include "nyx.h"
 
@@ -97,6 +99,7 @@ public:
    // Effect implementation
 
    bool Init() override;
+   wxString GetPreviewCacheKey() override;
    bool CheckWhetherSkipEffect() override;
    bool Process() override;
    bool ShowInterface(wxWindow *parent, bool forceModal = false) override;
@@ -255,11 +258,10 @@ private:
    double            mProgressTot;
    double            mScale;
 
-   SampleBuffer      mCurBuffer[2];
-   sampleCount       mCurBufferStart[2];
-   size_t            mCurBufferLen[2];
+   WaveTrackCache    mCurBuffer[2];
 
    WaveTrack        *mOutputTrack[2];
+   TrackIOQueue     *mWriteQueue;
 
    wxArrayString     mCategories;
 
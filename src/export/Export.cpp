@@ -31,6 +31,9 @@
 #include "../Audacity.h" // for USE_* macros
 #include "Export.h"
 
+#include <cstring>
+#include <thread>
+
 #include <wx/dcclient.h>
 #include <wx/file.h>
 #include <wx/filectrl.h>
@@ -41,6 +44,7 @@
 #include <wx/slider.h>
 #include <wx/statbox.h>
 #include <wx/stattext.h>
+#include <wx/stopwatch.h>
 #include <wx/string.h>
 #include <wx/textctrl.h>
 #include <wx/timer.h>
@@ -97,6 +101,12 @@ bool ExportPlugin::CheckFileName(wxFileName & WXUNUSED(filename), int WXUNUSED(f
   return true;
 }
 
+bool ExportPlugin::RewriteMetadata(const wxString & WXUNUSED(fName),
+   const Tags * WXUNUSED(metadata), int WXUNUSED(subformat))
+{
+   return false;
+}
+
 /** \brief Add a NEW entry to the list of formats this plug-in can export
  *
  * To configure the format use SetFormat, SetCanMetaData etc with the index of
@@ -262,7 +272,7 @@ std::unique_ptr<Mixer> ExportPlugin::CreateMixer(const TrackList &tracks,
    const auto timeTrack = *tracks.Any<const TimeTrack>().begin();
    auto envelope = timeTrack ? timeTrack->GetEnvelope() : nullptr;
    // MB: the stop time should not be warped, this was a bug.
-   return std::make_unique<Mixer>(inputTracks,
+   auto mixer = std::make_unique<Mixer>(inputTracks,
                   // Throw, to stop exporting, if read fails:
                   true,
                   Mixer::WarpOptions(envelope),
@@ -270,6 +280,9 @@ std::unique_ptr<Mixer> ExportPlugin::CreateMixer(const TrackList &tracks,
                   numOutChannels, outBufferSize, outInterleaved,
                   outRate, outFormat,
                   highQuality, mixerSpec);
+   // Offline, so let the mixer use all cores
+   mixer->SetNumWorkers( std::thread::hardware_concurrency() );
+   return mixer;
 }
 
 void ExportPlugin::InitProgress(std::unique_ptr<ProgressDialog> &pDialog,
@@ -284,6 +297,96 @@ void ExportPlugin::InitProgress(std::unique_ptr<ProgressDialog> &pDialog,
    }
 }
 
+ProgressResult ExportPlugin::UpdateProgress(ProgressDialog &progress,
+   double current, double total)
+{
+   // Scripted exports run unattended; nothing should repaint or yield,
+   // and there is no one watching who might cancel.
+   if (mSilentProgress)
+      return ProgressResult::Success;
+
+   // The final update always goes through, so the gauge completes.
+   if (current < total) {
+      // Let at most about 20 updates a second reach the dialog.  Each
+      // one repaints and may yield to the event loop, which for small
+      // mixing chunks can cost more than the encoding itself.  Clicks
+      // on Cancel and Stop are noticed only during a yield, so a
+      // skipped update cannot miss a fresh request.
+      auto now = wxGetUTCTimeMillis().GetValue();
+      if (now - mProgressLastUpdate < 50)
+         return ProgressResult::Success;
+      mProgressLastUpdate = now;
+   }
+
+   return progress.Update(current, total);
+}
+
+//----------------------------------------------------------------------------
+// ExportMixerPipeline
+//----------------------------------------------------------------------------
+
+ExportMixerPipeline::ExportMixerPipeline(Mixer &mixer,
+      unsigned numOutChannels, size_t outBufferSize, bool outInterleaved,
+      sampleFormat outFormat)
+   : mMixer{ mixer }
+   , mMaxSamples{ outBufferSize }
+   , mNumBuffers{ outInterleaved ? 1u : numOutChannels }
+   , mBytesPerFrame{
+      SAMPLE_SIZE(outFormat) * (outInterleaved ? numOutChannels : 1u) }
+{
+   for (auto &slot : mSlots)
+      slot.buffers.reinit(mNumBuffers, mMaxSamples * mBytesPerFrame);
+}
+
+ExportMixerPipeline::~ExportMixerPipeline()
+{
+}
+
+void ExportMixerPipeline::Fill(Slot &slot)
+{
+   slot.count = mMixer.Process(mMaxSamples);
+   slot.time = mMixer.MixGetCurrentTime();
+   for (unsigned ii = 0; ii < mNumBuffers; ++ii)
+      memcpy(slot.buffers[ii].get(), mMixer.GetBuffer(ii),
+             slot.count * mBytesPerFrame);
+}
+
+size_t ExportMixerPipeline::Process()
+{
+   if (!mStarted) {
+      // Set the worker mixing as far ahead as there are slots
+      for (unsigned ii = 0; ii < cSlots; ++ii)
+         mTickets[ii] = mQueue.Post([this, ii]{ Fill(mSlots[ii]); });
+      mStarted = true;
+   }
+   else {
+      // The slot just consumed goes back to the worker, unless the
+      // mixer has already run dry
+      auto &slot = mSlots[mCurrent];
+      if (slot.count > 0)
+         mTickets[mCurrent] = mQueue.Post([this, &slot]{ Fill(slot); });
+      mCurrent = (mCurrent + 1) % cSlots;
+   }
+   // Rethrows whatever the mixer threw, such as a FileException
+   mQueue.Wait(mTickets[mCurrent]);
+   return mSlots[mCurrent].count;
+}
+
+samplePtr ExportMixerPipeline::GetBuffer()
+{
+   return GetBuffer(0);
+}
+
+samplePtr ExportMixerPipeline::GetBuffer(int channel)
+{
+   return mSlots[mCurrent].buffers[channel].get();
+}
+
+double ExportMixerPipeline::MixGetCurrentTime() const
+{
+   return mSlots[mCurrent].time;
+}
+
 //----------------------------------------------------------------------------
 // Export
 //----------------------------------------------------------------------------
@@ -479,7 +582,12 @@ bool Exporter::Process(AudacityProject *project, unsigned numChannels,
          {
             mFormat = i;
             mSubFormat = j;
-            return CheckFilename() && ExportTracks();
+            // This overload serves scripted exports; suppress progress
+            // updates so nothing repaints or yields while the macro runs
+            pPlugin->SetSilentProgress(true);
+            auto success = CheckFilename() && ExportTracks();
+            pPlugin->SetSilentProgress(false);
+            return success;
          }
       }
    }
@@ -14,6 +14,7 @@
 #include <vector>
 #include <wx/filename.h> // member variable
 #include "../SampleFormat.h"
+#include "../effects/TrackIOQueue.h" // member variable
 #include "../widgets/wxPanelWrapper.h" // to inherit
 
 class wxArrayString;
@@ -96,6 +97,19 @@ public:
     * of channels in exported file. -1 for unspecified */
    virtual int SetNumExportChannels() { return -1; }
 
+   /** @brief Suppress progress display updates entirely, for scripted
+    * or otherwise unattended exports where no one is watching to cancel */
+   void SetSilentProgress(bool silent) { mSilentProgress = silent; }
+
+   /** @brief Rewrite just the metadata of a file this plugin exported
+    * earlier, leaving the audio payload untouched.
+    *
+    * Returns false when the plugin does not support in-place updates or
+    * when the existing file cannot absorb the NEW tags, in which case
+    * the caller must fall back to a full export. */
+   virtual bool RewriteMetadata(const wxString &fName, const Tags *metadata,
+                                int subformat = 0);
+
    /** \brief called to export audio into a file.
     *
     * @param pDialog To be initialized with pointer to a NEW ProgressDialog if
@@ -140,12 +154,76 @@ protected:
    static void InitProgress(std::unique_ptr<ProgressDialog> &pDialog,
          const wxString &title, const wxString &message);
 
+   // Rate limiter for the export loops.  Lets at most about 20 updates
+   // a second reach the dialog, passes a final update (current of at
+   // least total) unconditionally, and passes nothing at all when
+   // silent progress was requested.
+   ProgressResult UpdateProgress(ProgressDialog &progress,
+         double current, double total);
+
 private:
    std::vector<FormatInfo> mFormatInfos;
+   bool mSilentProgress{ false };
+   wxLongLong_t mProgressLastUpdate{ 0 };
 };
 
 using ExportPluginArray = std::vector < std::unique_ptr< ExportPlugin > > ;
 
+//----------------------------------------------------------------------------
+// ExportMixerPipeline
+//----------------------------------------------------------------------------
+
+/** \brief Runs a Mixer on a worker thread, keeping a small ring of mixed
+ * buffers ahead of the consumer, so that an export takes roughly the
+ * greater of the mixing and encoding times rather than their sum.
+ *
+ * Construct it with the same channel, buffer size, interleaving and
+ * format arguments that were given to CreateMixer(), then call its
+ * Process(), GetBuffer() and MixGetCurrentTime() in place of the
+ * Mixer's own.  A buffer returned by GetBuffer() stays valid until the
+ * next call to Process().  The Mixer must not be used directly while
+ * the pipeline exists.
+ */
+class AUDACITY_DLL_API ExportMixerPipeline final
+{
+public:
+   ExportMixerPipeline(Mixer &mixer,
+         unsigned numOutChannels, size_t outBufferSize, bool outInterleaved,
+         sampleFormat outFormat);
+   ~ExportMixerPipeline();
+
+   /** \brief Like Mixer::Process, but blocks only until the worker has
+    * the next buffer ready; the buffer size was fixed at construction */
+   size_t Process();
+   samplePtr GetBuffer();
+   samplePtr GetBuffer(int channel);
+   /** \brief Mixer time as of the last buffer that Process() returned */
+   double MixGetCurrentTime() const;
+
+private:
+   struct Slot
+   {
+      ArraysOf<char> buffers;
+      size_t count { 0 };
+      double time { 0.0 };
+   };
+
+   void Fill(Slot &slot);
+
+   static const unsigned cSlots = 3;
+
+   Mixer &mMixer;
+   size_t mMaxSamples;
+   unsigned mNumBuffers;
+   size_t mBytesPerFrame;
+   Slot mSlots[cSlots];
+   TrackIOQueue::Ticket mTickets[cSlots] {};
+   unsigned mCurrent { 0 };
+   bool mStarted { false };
+   // Last member, so that the worker stops before the slots go away
+   TrackIOQueue mQueue;
+};
+
 //----------------------------------------------------------------------------
 // Exporter
 //----------------------------------------------------------------------------
@@ -446,6 +446,8 @@ ProgressResult ExportCL::Export(AudacityProject *project,
                             int16Sample,
                             true,
                             mixerSpec);
+   ExportMixerPipeline pipeline{ *mixer,
+      channels, maxBlockLen, true, int16Sample };
 
    size_t numBytes = 0;
    samplePtr mixed = NULL;
@@ -472,12 +474,12 @@ ProgressResult ExportCL::Export(AudacityProject *project,
 
          // Need to mix another block
          if (numBytes == 0) {
-            auto numSamples = mixer->Process(maxBlockLen);
+            auto numSamples = pipeline.Process();
             if (numSamples == 0) {
                break;
             }
 
-            mixed = mixer->GetBuffer();
+            mixed = pipeline.GetBuffer();
             numBytes = numSamples * channels;
 
             // Byte-swapping is neccesary on big-endian machines, since
@@ -506,7 +508,7 @@ ProgressResult ExportCL::Export(AudacityProject *project,
          }
 
          // Update the progress display
-         updateResult = progress.Update(mixer->MixGetCurrentTime() - t0, t1 - t0);
+         updateResult = UpdateProgress(progress, pipeline.MixGetCurrentTime() - t0, t1 - t0);
       }
       // Done with the progress display
    }
@@ -112,7 +112,8 @@ public:
    /// Sets individual metadata values
    void SetMetadata(const Tags *tags, const char *name, const wxChar *tag);
 
-   /// Encodes audio
+   /// Encodes audio.  May run on a worker thread; failures are
+   /// described in mEncodeError rather than raised in a dialog.
    bool EncodeAudioFrame(int16_t *pFrame, size_t frameSize);
 
    /// Flushes audio encoder
@@ -166,6 +167,10 @@ private:
    unsigned          mChannels{};
    bool              mSupportsUTF8{};
 
+   // Failure description from EncodeAudioFrame, which may run on a
+   // worker thread and so cannot raise dialogs itself
+   wxString          mEncodeError;
+
    // Smart pointer fields, their order is the reverse in which they are reset in FreeResources():
    AVFifoBufferHolder   mEncAudioFifo;          // FIFO to write incoming audio samples into
    AVMallocHolder<int16_t> mEncAudioFifoOutBuf;  // buffer to read _out_ of the FIFO into
@@ -529,6 +534,10 @@ bool ExportFFmpeg::InitCodecs(AudacityProject *project)
       mEncFormatCtx->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
    }
 
+   // Let codecs that support slice or frame threading use it; audio
+   // encoders that do not simply ignore the setting
+   mEncAudioCodecCtx->thread_count = std::thread::hardware_concurrency();
+
    // Open the codec.
    if (avcodec_open2(mEncAudioCodecCtx.get(), codec, &options) < 0)
    {
@@ -803,10 +812,7 @@ bool ExportFFmpeg::EncodeAudioFrame(int16_t *pFrame, size_t frameSize)
       return false;
 
    if (nAudioFrameSizeOut > mEncAudioFifoOutBufSiz) {
-      AudacityMessageBox(
-         _("FFmpeg : ERROR - nAudioFrameSizeOut too large."),
-         _("FFmpeg Error"), wxOK|wxCENTER|wxICON_EXCLAMATION
-      );
+      mEncodeError = _("FFmpeg : ERROR - nAudioFrameSizeOut too large.");
       return false;
    }
 
@@ -823,10 +829,7 @@ bool ExportFFmpeg::EncodeAudioFrame(int16_t *pFrame, size_t frameSize)
          default_frame_size);
       if (ret < 0)
       {
-         AudacityMessageBox(
-            _("FFmpeg : ERROR - Can't encode audio frame."),
-            _("FFmpeg Error"), wxOK|wxCENTER|wxICON_EXCLAMATION
-         );
+         mEncodeError = _("FFmpeg : ERROR - Can't encode audio frame.");
          return false;
       }
       if (ret == 0)
@@ -844,10 +847,7 @@ bool ExportFFmpeg::EncodeAudioFrame(int16_t *pFrame, size_t frameSize)
       // Write the encoded audio frame to the output file.
       if ((ret = av_interleaved_write_frame(mEncFormatCtx.get(), &pkt)) < 0)
       {
-         AudacityMessageBox(
-            _("FFmpeg : ERROR - Failed to write audio frame to file."),
-            _("FFmpeg Error"), wxOK|wxCENTER|wxICON_EXCLAMATION
-         );
+         mEncodeError = _("FFmpeg : ERROR - Failed to write audio frame to file.");
          return false;
       }
    }
@@ -904,6 +904,8 @@ ProgressResult ExportFFmpeg::Export(AudacityProject *project,
       t0, t1,
       channels, pcmBufferSize, true,
       mSampleRate, int16Sample, true, mixerSpec);
+   ExportMixerPipeline pipeline{ *mixer,
+      channels, pcmBufferSize, true, int16Sample };
 
    auto updateResult = ProgressResult::Success;
    {
@@ -915,24 +917,47 @@ ProgressResult ExportFFmpeg::Export(AudacityProject *project,
                ExportFFmpegOptions::fmts[mSubFormat].Description()) );
       auto &progress = *pDialog;
 
+      // Encoding and muxing run on a thread of their own, fed block by
+      // block from the mixing pipeline, so codec work and container
+      // flushes no longer hold up the mixer.  The wait at the top of
+      // the loop keeps the encoder out of buffers the mixer is about
+      // to reuse.
+      TrackIOQueue encodeQueue;
+      TrackIOQueue::Ticket encodeTicket = 0;
+      bool encodeError = false;
+
       while (updateResult == ProgressResult::Success) {
-         auto pcmNumSamples = mixer->Process(pcmBufferSize);
+         encodeQueue.Wait(encodeTicket);
+         if (encodeError)
+            break;
+
+         auto pcmNumSamples = pipeline.Process();
 
          if (pcmNumSamples == 0)
             break;
 
-         short *pcmBuffer = (short *)mixer->GetBuffer();
+         short *pcmBuffer = (short *)pipeline.GetBuffer();
 
-         if (!EncodeAudioFrame(
-            pcmBuffer, (pcmNumSamples)*sizeof(int16_t)*mChannels)) {
-            // TODO: more precise message, and fix redundancy with messages
-            // already given on some of the failure paths of the above call
-            AudacityMessageBox(_("Unable to export"));
-            updateResult = ProgressResult::Cancelled;
-            break;
-         }
+         encodeTicket = encodeQueue.Post(
+            [this, &encodeError, pcmBuffer, pcmNumSamples]{
+               if (!EncodeAudioFrame(
+                  pcmBuffer, (pcmNumSamples)*sizeof(int16_t)*mChannels))
+                  encodeError = true;
+            });
 
-         updateResult = progress.Update(mixer->MixGetCurrentTime() - t0, t1 - t0);
+         updateResult = UpdateProgress(progress, pipeline.MixGetCurrentTime() - t0, t1 - t0);
+      }
+
+      // Drain the last block posted before leaving the loop
+      encodeQueue.Wait(encodeTicket);
+      if (encodeError) {
+         if (!mEncodeError.empty())
+            AudacityMessageBox(mEncodeError,
+               _("FFmpeg Error"), wxOK|wxCENTER|wxICON_EXCLAMATION);
+         else
+            // TODO: more precise message
+            AudacityMessageBox(_("Unable to export"));
+         updateResult = ProgressResult::Cancelled;
       }
    }
 
@@ -370,6 +370,8 @@ ProgressResult ExportFLAC::Export(AudacityProject *project,
                             t0, t1,
                             numChannels, SAMPLES_PER_RUN, false,
                             rate, format, true, mixerSpec);
+   ExportMixerPipeline pipeline{ *mixer,
+      numChannels, SAMPLES_PER_RUN, false, format };
 
    ArraysOf<FLAC__int32> tmpsmplbuf{ numChannels, SAMPLES_PER_RUN, true };
 
@@ -379,14 +381,28 @@ ProgressResult ExportFLAC::Export(AudacityProject *project,
          : _("Exporting the audio as FLAC") );
    auto &progress = *pDialog;
 
+   // libFLAC's stream encoder is strictly serial, so it gets a thread
+   // of its own, fed by the mixing pipeline; the widening of samples to
+   // FLAC__int32 moves there with it.  Waiting for the previous block
+   // at the top of the loop keeps the encoder out of buffers the mixer
+   // may reuse after the next call to Process().
+   TrackIOQueue encodeQueue;
+   TrackIOQueue::Ticket encodeTicket = 0;
+   bool encodeError = false;
+
    while (updateResult == ProgressResult::Success) {
-      auto samplesThisRun = mixer->Process(SAMPLES_PER_RUN);
+      encodeQueue.Wait(encodeTicket);
+      if (encodeError)
+         break;
+
+      auto samplesThisRun = pipeline.Process();
       if (samplesThisRun == 0) { //stop encoding
          break;
       }
-      else {
+
+      encodeTicket = encodeQueue.Post([&, samplesThisRun]{
          for (size_t i = 0; i < numChannels; i++) {
-            samplePtr mixed = mixer->GetBuffer(i);
+            samplePtr mixed = pipeline.GetBuffer(i);
             if (format == int24Sample) {
                for (decltype(samplesThisRun) j = 0; j < samplesThisRun; j++) {
                   tmpsmplbuf[i][j] = ((int *)mixed)[j];
@@ -400,16 +416,20 @@ ProgressResult ExportFLAC::Export(AudacityProject *project,
          }
          if (! encoder.process(
                reinterpret_cast<FLAC__int32**>( tmpsmplbuf.get() ),
-               samplesThisRun) ) {
-            // TODO: more precise message
-            AudacityMessageBox(_("Unable to export"));
-            updateResult = ProgressResult::Cancelled;
-            break;
-         }
-         if (updateResult == ProgressResult::Success)
-            updateResult =
-               progress.Update(mixer->MixGetCurrentTime() - t0, t1 - t0);
-      }
+               samplesThisRun) )
+            encodeError = true;
+      });
+
+      updateResult =
+         UpdateProgress(progress, pipeline.MixGetCurrentTime() - t0, t1 - t0);
+   }
+
+   // Drain the last block posted before leaving the loop
+   encodeQueue.Wait(encodeTicket);
+   if (encodeError) {
+      // TODO: more precise message
+      AudacityMessageBox(_("Unable to export"));
+      updateResult = ProgressResult::Cancelled;
    }
 
    if (updateResult == ProgressResult::Success ||
@@ -271,6 +271,8 @@ ProgressResult ExportMP2::Export(AudacityProject *project,
          t0, t1,
          stereo ? 2 : 1, pcmBufferSize, true,
          rate, int16Sample, true, mixerSpec);
+      ExportMixerPipeline pipeline{ *mixer,
+         stereo ? 2u : 1u, pcmBufferSize, true, int16Sample };
 
       InitProgress( pDialog, wxFileName(fName).GetName(),
          selectionOnly
@@ -281,12 +283,12 @@ ProgressResult ExportMP2::Export(AudacityProject *project,
       auto &progress = *pDialog;
 
       while (updateResult == ProgressResult::Success) {
-         auto pcmNumSamples = mixer->Process(pcmBufferSize);
+         auto pcmNumSamples = pipeline.Process();
 
          if (pcmNumSamples == 0)
             break;
 
-         short *pcmBuffer = (short *)mixer->GetBuffer();
+         short *pcmBuffer = (short *)pipeline.GetBuffer();
 
          int mp2BufferNumBytes = twolame_encode_buffer_interleaved(
             encodeOptions,
@@ -308,7 +310,7 @@ ProgressResult ExportMP2::Export(AudacityProject *project,
             return ProgressResult::Cancelled;
          }
 
-         updateResult = progress.Update(mixer->MixGetCurrentTime() - t0, t1 - t0);
+         updateResult = UpdateProgress(progress, pipeline.MixGetCurrentTime() - t0, t1 - t0);
       }
    }
 
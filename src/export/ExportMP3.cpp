@@ -853,6 +853,9 @@ private:
 
 #ifndef DISABLE_DYNAMIC_LOADING_LAME
    wxString mLibPath;
+   // The preference value in force when the library was loaded, so a
+   // cached instance can tell whether the user has since repointed it
+   wxString mLoadedLibPath;
    wxDynamicLibrary lame_lib;
    bool mLibraryLoaded;
 #endif // DISABLE_DYNAMIC_LOADING_LAME
@@ -991,6 +994,14 @@ bool MP3Exporter::LoadLibrary(wxWindow *parent, AskUser askuser)
 {
 
    if (ValidLibraryLoaded()) {
+      // Still warm from an earlier export.  Reuse it unless the
+      // preference has moved meanwhile; a thousand-file batch then pays
+      // for the search and symbol lookup only once.
+      wxString prefPath =
+         gPrefs ? gPrefs->Read(wxT("/MP3/MP3LibPath"), wxT("")) : wxString{};
+      if (prefPath == mLoadedLibPath) {
+         return true;
+      }
       FreeLibrary();
       mLibraryLoaded = false;
    }
@@ -1047,6 +1058,11 @@ bool MP3Exporter::LoadLibrary(wxWindow *parent, AskUser askuser)
 
    wxLogMessage(wxT("LAME library successfully loaded"));
 
+   // Note what the preference says now (FindLibrary may just have
+   // rewritten it), so a cached instance knows when to invalidate itself
+   mLoadedLibPath =
+      gPrefs ? gPrefs->Read(wxT("/MP3/MP3LibPath"), wxT("")) : wxString{};
+
    return true;
 }
 
@@ -1667,6 +1683,16 @@ static void dump_config( 	lame_global_flags*	gfp )
 }
 #endif
 
+// Process-wide warm instance.  Locating and validating the LAME library
+// costs real time, so scripted runs that export file after file share
+// one exporter whose library stays resident; LoadLibrary notices when
+// the library preference moves and reloads then.
+static MP3Exporter &GetMP3Exporter()
+{
+   static MP3Exporter exporter;
+   return exporter;
+}
+
 //----------------------------------------------------------------------------
 // ExportMP3
 //----------------------------------------------------------------------------
@@ -1677,6 +1703,8 @@ public:
 
    ExportMP3();
    bool CheckFileName(wxFileName & filename, int format) override;
+   bool RewriteMetadata(const wxString &fName, const Tags *metadata,
+                        int subformat) override;
 
    // Required
 
@@ -1719,7 +1747,7 @@ ExportMP3::ExportMP3()
 bool ExportMP3::CheckFileName(wxFileName & WXUNUSED(filename), int WXUNUSED(format))
 {
 #ifndef DISABLE_DYNAMIC_LOADING_LAME
-   MP3Exporter exporter;
+   MP3Exporter &exporter = GetMP3Exporter();
 
    if (!exporter.LoadLibrary(wxTheApp->GetTopWindow(), MP3Exporter::Maybe)) {
       AudacityMessageBox(_("Could not open MP3 encoding library!"));
@@ -1758,7 +1786,7 @@ ProgressResult ExportMP3::Export(AudacityProject *project,
    wxWindow *parent = ProjectWindow::Find( project );
 #endif // DISABLE_DYNAMIC_LOADING_LAME
    const auto &tracks = TrackList::Get( *project );
-   MP3Exporter exporter;
+   MP3Exporter &exporter = GetMP3Exporter();
 
 #ifdef DISABLE_DYNAMIC_LOADING_LAME
    if (!exporter.InitLibrary(wxT(""))) {
@@ -1907,6 +1935,8 @@ ProgressResult ExportMP3::Export(AudacityProject *project,
          t0, t1,
          channels, inSamples, true,
          rate, int16Sample, true, mixerSpec);
+      ExportMixerPipeline pipeline{ *mixer,
+         channels, (size_t) inSamples, true, int16Sample };
 
       wxString title;
       if (rmode == MODE_SET) {
@@ -1931,48 +1961,67 @@ ProgressResult ExportMP3::Export(AudacityProject *project,
       InitProgress( pDialog, wxFileName(fName).GetName(), title );
       auto &progress = *pDialog;
 
+      // LAME itself is single threaded, so give it a thread of its own,
+      // fed by the mixing pipeline.  It encodes and writes one block
+      // while this thread waits on the mixer and services the progress
+      // display.  Waiting for the previous block at the top of the loop
+      // keeps the encoder out of a buffer that the mixer may reuse
+      // after the next call to Process().
+      TrackIOQueue encodeQueue;
+      TrackIOQueue::Ticket encodeTicket = 0;
+      bool writeError = false;
+
       while (updateResult == ProgressResult::Success) {
-         auto blockLen = mixer->Process(inSamples);
+         encodeQueue.Wait(encodeTicket);
+         if (bytes < 0 || writeError)
+            break;
+
+         auto blockLen = pipeline.Process();
 
          if (blockLen == 0) {
             break;
          }
 
-         short *mixed = (short *)mixer->GetBuffer();
+         short *mixed = (short *)pipeline.GetBuffer();
 
-         if ((int)blockLen < inSamples) {
-            if (channels > 1) {
-               bytes = exporter.EncodeRemainder(mixed, blockLen, buffer.get());
-            }
-            else {
-               bytes = exporter.EncodeRemainderMono(mixed, blockLen, buffer.get());
-            }
-         }
-         else {
-            if (channels > 1) {
-               bytes = exporter.EncodeBuffer(mixed, buffer.get());
+         encodeTicket = encodeQueue.Post([&, mixed, blockLen]{
+            if ((int)blockLen < inSamples) {
+               if (channels > 1) {
+                  bytes = exporter.EncodeRemainder(mixed, blockLen, buffer.get());
+               }
+               else {
+                  bytes = exporter.EncodeRemainderMono(mixed, blockLen, buffer.get());
+               }
             }
             else {
-               bytes = exporter.EncodeBufferMono(mixed, buffer.get());
+               if (channels > 1) {
+                  bytes = exporter.EncodeBuffer(mixed, buffer.get());
+               }
+               else {
+                  bytes = exporter.EncodeBufferMono(mixed, buffer.get());
+               }
             }
-         }
 
-         if (bytes < 0) {
-            wxString msg;
-            msg.Printf(_("Error %ld returned from MP3 encoder"), bytes);
-            AudacityMessageBox(msg);
-            updateResult = ProgressResult::Cancelled;
-            break;
-         }
+            if (bytes > 0 && bytes > (int)outFile.Write(buffer.get(), bytes))
+               writeError = true;
+         });
 
-         if (bytes > (int)outFile.Write(buffer.get(), bytes)) {
-            // TODO: more precise message
-            AudacityMessageBox(_("Unable to export"));
-            updateResult = ProgressResult::Cancelled;
-            break;
-         }
+         updateResult = UpdateProgress(progress, pipeline.MixGetCurrentTime() - t0, t1 - t0);
+      }
+
+      // Drain the last block posted before leaving the loop
+      encodeQueue.Wait(encodeTicket);
 
-         updateResult = progress.Update(mixer->MixGetCurrentTime() - t0, t1 - t0);
+      if (bytes < 0) {
+         wxString msg;
+         msg.Printf(_("Error %ld returned from MP3 encoder"), bytes);
+         AudacityMessageBox(msg);
+         updateResult = ProgressResult::Cancelled;
+      }
+      else if (writeError) {
+         // TODO: more precise message
+         AudacityMessageBox(_("Unable to export"));
+         updateResult = ProgressResult::Cancelled;
       }
    }
 
@@ -2178,6 +2227,13 @@ unsigned long ExportMP3::AddTags(AudacityProject *WXUNUSED(project), ArrayOf<cha
    unsigned long len;
 
    len = id3_tag_render(tp.get(), 0);
+
+   // Reserve some padding inside the tag, so that a later metadata-only
+   // correction can usually be rewritten in place without moving the
+   // audio.  See RewriteMetadata.
+   id3_tag_setlength(tp.get(), len + 1024);
+   len = id3_tag_render(tp.get(), 0);
+
    buffer.reinit(len);
    len = id3_tag_render(tp.get(), (id3_byte_t *)buffer.get());
 
@@ -2187,6 +2243,68 @@ unsigned long ExportMP3::AddTags(AudacityProject *WXUNUSED(project), ArrayOf<cha
 #endif
 }
 
+bool ExportMP3::RewriteMetadata(const wxString &fName,
+                                const Tags *metadata, int WXUNUSED(subformat))
+{
+#ifdef USE_LIBID3TAG
+   if (!metadata)
+      return false;
+
+   wxFFile f(fName, wxT("r+b"));
+   if (!f.IsOpened())
+      return false;
+
+   // Export writes an ID3v2 tag, with padding, at the very start of the
+   // file, before the first MPEG frame.
+   unsigned char header[10];
+   if (10 != f.Read(header, 10))
+      return false;
+   // Require that tag; refuse files with an appended v2.4 footer, which
+   // we never write ourselves
+   if (memcmp(header, "ID3", 3) != 0 || (header[5] & 0x10))
+      return false;
+
+   // The size field is syncsafe: seven significant bits per byte, and
+   // it excludes the ten header bytes
+   id3_length_t oldSize = 10 +
+      (((id3_length_t)(header[6] & 0x7f) << 21) |
+       ((id3_length_t)(header[7] & 0x7f) << 14) |
+       ((id3_length_t)(header[8] & 0x7f) << 7) |
+        (id3_length_t)(header[9] & 0x7f));
+
+   ArrayOf<char> buffer;
+   bool endOfFile;
+   unsigned long len = AddTags(nullptr, buffer, &endOfFile, metadata);
+   if (len == 0 || len > oldSize)
+      // The NEW tags outgrew the old region even after its padding;
+      // only a full export can make room
+      return false;
+
+   // Grow the declared tag size back out to the old region, so that the
+   // leftover space counts as in-tag padding and the audio keeps its
+   // offset
+   id3_length_t padded = oldSize - 10;
+   buffer[6] = (char)((padded >> 21) & 0x7f);
+   buffer[7] = (char)((padded >> 14) & 0x7f);
+   buffer[8] = (char)((padded >> 7) & 0x7f);
+   buffer[9] = (char)(padded & 0x7f);
+
+   if (!f.Seek(0))
+      return false;
+   if (len != f.Write(buffer.get(), len))
+      return false;
+   if (oldSize > len) {
+      ArrayOf<char> zeros{ oldSize - len, true };
+      if (oldSize - len != f.Write(zeros.get(), oldSize - len))
+         return false;
+   }
+
+   return f.Flush() && f.Close();
+#else
+   return false;
+#endif
+}
+
 #ifdef USE_LIBID3TAG
 void ExportMP3::AddFrame(struct id3_tag *tp, const wxString & n, const wxString & v, const char *name)
 {
@@ -2243,7 +2361,7 @@ std::unique_ptr<ExportPlugin> New_ExportMP3()
 
 wxString GetMP3Version(wxWindow *parent, bool prompt)
 {
-   MP3Exporter exporter;
+   MP3Exporter &exporter = GetMP3Exporter();
    wxString versionString = _("MP3 export library not found");
 
 #ifndef DISABLE_DYNAMIC_LOADING_LAME
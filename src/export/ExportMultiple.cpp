@@ -825,6 +825,10 @@ ProgressResult ExportMultiple::ExportMultipleByLabel(bool byName,
    ExportKit activeSetting;  // pointer to the settings in use for this export
    /* Go round again and do the exporting (so this run is slow but
     * non-interactive) */
+   // Files are exported one after another on purpose.  Each Export()
+   // call owns the progress dialog and may raise message boxes, which
+   // belong to this thread; the concurrency is inside each call, where
+   // the mixer, its pipeline and the encoder have threads of their own.
    std::unique_ptr<ProgressDialog> pDialog;
    for (count = 0; count < numFiles; count++) {
       /* get the settings to use for the export from the array */
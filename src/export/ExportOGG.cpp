@@ -279,6 +279,8 @@ ProgressResult ExportOGG::Export(AudacityProject *project,
          t0, t1,
          numChannels, SAMPLES_PER_RUN, false,
          rate, floatSample, true, mixerSpec);
+      ExportMixerPipeline pipeline{ *mixer,
+         numChannels, SAMPLES_PER_RUN, false, floatSample };
 
       InitProgress( pDialog, wxFileName(fName).GetName(),
          selectionOnly
@@ -286,76 +288,95 @@ ProgressResult ExportOGG::Export(AudacityProject *project,
             : _("Exporting the audio as Ogg Vorbis") );
       auto &progress = *pDialog;
 
-      while (updateResult == ProgressResult::Success && !eos) {
-         float **vorbis_buffer = vorbis_analysis_buffer(&dsp, SAMPLES_PER_RUN);
-         auto samplesThisRun = mixer->Process(SAMPLES_PER_RUN);
-
-         int err;
-         if (samplesThisRun == 0) {
-            // Tell the library that we wrote 0 bytes - signalling the end.
-            err = vorbis_analysis_wrote(&dsp, 0);
-         }
-         else {
-
-            for (size_t i = 0; i < numChannels; i++) {
-               float *temp = (float *)mixer->GetBuffer(i);
-               memcpy(vorbis_buffer[i], temp, sizeof(float)*SAMPLES_PER_RUN);
-            }
-
-            // tell the encoder how many samples we have
-            err = vorbis_analysis_wrote(&dsp, samplesThisRun);
-         }
-
-         // I don't understand what this call does, so here is the comment
-         // from the example, verbatim:
-         //
-         //    vorbis does some data preanalysis, then divvies up blocks
-         //    for more involved (potentially parallel) processing. Get
-         //    a single block for encoding now
-         while (!err && vorbis_analysis_blockout(&dsp, &block) == 1) {
-
-            // analysis, assume we want to use bitrate management
-            err = vorbis_analysis(&block, NULL);
-            if (!err)
-               err = vorbis_bitrate_addblock(&block);
+      // Vorbis analysis, bitstream packing and the page writes run on a
+      // thread of their own, fed block by block from the mixing
+      // pipeline, so they overlap with the mixing ahead and with the
+      // progress display.  The wait at the top of the loop keeps the
+      // encoder out of buffers the mixer is about to reuse.
+      TrackIOQueue encodeQueue;
+      TrackIOQueue::Ticket encodeTicket = 0;
+      bool encodeError = false, writeError = false;
+
+      while (updateResult == ProgressResult::Success) {
+         encodeQueue.Wait(encodeTicket);
+         if (encodeError || writeError || eos)
+            break;
 
-            while (!err && vorbis_bitrate_flushpacket(&dsp, &packet)) {
+         auto samplesThisRun = pipeline.Process();
 
-               // add the packet to the bitstream
-               err = ogg_stream_packetin(&stream, &packet);
+         encodeTicket = encodeQueue.Post([&, samplesThisRun]{
+            float **vorbis_buffer = vorbis_analysis_buffer(&dsp, SAMPLES_PER_RUN);
 
-               // From vorbis-tools-1.0/oggenc/encode.c:
-               //   If we've gone over a page boundary, we can do actual output,
-               //   so do so (for however many pages are available).
+            int err;
+            if (samplesThisRun == 0) {
+               // Tell the library that we wrote 0 bytes - signalling the end.
+               err = vorbis_analysis_wrote(&dsp, 0);
+            }
+            else {
 
-               while (!err && !eos) {
-                  int result = ogg_stream_pageout(&stream, &page);
-                  if (!result) {
-                     break;
-                  }
+               for (size_t i = 0; i < numChannels; i++) {
+                  float *temp = (float *)pipeline.GetBuffer(i);
+                  memcpy(vorbis_buffer[i], temp, sizeof(float)*SAMPLES_PER_RUN);
+               }
 
-                  if ( outFile.Write(page.header, page.header_len).GetLastError() ||
-                       outFile.Write(page.body, page.body_len).GetLastError()) {
-                     // TODO: more precise message
-                     AudacityMessageBox(_("Unable to export"));
-                     return ProgressResult::Cancelled;
-                  }
+               // tell the encoder how many samples we have
+               err = vorbis_analysis_wrote(&dsp, samplesThisRun);
+            }
 
-                  if (ogg_page_eos(&page)) {
-                     eos = 1;
+            // I don't understand what this call does, so here is the comment
+            // from the example, verbatim:
+            //
+            //    vorbis does some data preanalysis, then divvies up blocks
+            //    for more involved (potentially parallel) processing. Get
+            //    a single block for encoding now
+            while (!err && vorbis_analysis_blockout(&dsp, &block) == 1) {
+
+               // analysis, assume we want to use bitrate management
+               err = vorbis_analysis(&block, NULL);
+               if (!err)
+                  err = vorbis_bitrate_addblock(&block);
+
+               while (!err && vorbis_bitrate_flushpacket(&dsp, &packet)) {
+
+                  // add the packet to the bitstream
+                  err = ogg_stream_packetin(&stream, &packet);
+
+                  // From vorbis-tools-1.0/oggenc/encode.c:
+                  //   If we've gone over a page boundary, we can do actual output,
+                  //   so do so (for however many pages are available).
+
+                  while (!err && !eos) {
+                     int result = ogg_stream_pageout(&stream, &page);
+                     if (!result) {
+                        break;
+                     }
+
+                     if ( outFile.Write(page.header, page.header_len).GetLastError() ||
+                          outFile.Write(page.body, page.body_len).GetLastError()) {
+                        writeError = true;
+                        return;
+                     }
+
+                     if (ogg_page_eos(&page)) {
+                        eos = 1;
+                     }
                   }
                }
             }
-         }
 
-         if (err) {
-            updateResult = ProgressResult::Cancelled;
-            // TODO: more precise message
-            AudacityMessageBox(_("Unable to export"));
-            break;
-         }
+            if (err)
+               encodeError = true;
+         });
+
+         updateResult = UpdateProgress(progress, pipeline.MixGetCurrentTime() - t0, t1 - t0);
+      }
 
-         updateResult = progress.Update(mixer->MixGetCurrentTime() - t0, t1 - t0);
+      // Drain the last block posted before leaving the loop
+      encodeQueue.Wait(encodeTicket);
+      if (encodeError || writeError) {
+         updateResult = ProgressResult::Cancelled;
+         // TODO: more precise message
+         AudacityMessageBox(_("Unable to export"));
       }
    }
 
@@ -25,13 +25,17 @@
 
 #include "sndfile.h"
 
+#include "../Envelope.h"
 #include "../FileFormats.h"
 #include "../Mix.h"
 #include "../Prefs.h"
 #include "../ProjectSettings.h"
 #include "../ShuttleGui.h"
 #include "../Tags.h"
+#include "../TimeTrack.h"
 #include "../Track.h"
+#include "../WaveClip.h"
+#include "../WaveTrack.h"
 #include "../widgets/AudacityMessageBox.h"
 #include "../widgets/ErrorDialog.h"
 #include "../widgets/ProgressDialog.h"
@@ -341,6 +345,8 @@ public:
    // optional
    FileExtension GetExtension(int index) override;
    bool CheckFileName(wxFileName &filename, int format) override;
+   bool RewriteMetadata(const wxString &fName, const Tags *metadata,
+                        int subformat) override;
 
 private:
    void ReportTooBigError(wxWindow * pParent);
@@ -542,12 +548,81 @@ ProgressResult ExportPCM::Export(AudacityProject *project,
       }
       size_t maxBlockLen = 44100 * 5;
 
-      {
+      // When a lone unmodified 16 bit track goes to a 16 bit subtype at
+      // its own rate, mixing would only convert the samples to float
+      // and back again with dither.  Detect that case and stream the
+      // blocks to libsndfile as they are.
+      const WaveTrack *directTrack = NULL;
+      if ((info.format & SF_FORMAT_SUBMASK) == SF_FORMAT_PCM_16 &&
+          info.channels == 1 && !mixerSpec &&
+          tracks.Any< const TimeTrack >().empty()) {
+         bool anySolo =
+            !(( tracks.Any<const WaveTrack>() + &WaveTrack::GetSolo ).empty());
+         auto range = tracks.Any< const WaveTrack >()
+            + (selectionOnly ? &Track::IsSelected : &Track::Any )
+            - ( anySolo ? &WaveTrack::GetNotSolo : &WaveTrack::GetMute);
+         if (range.size() == 1) {
+            const auto wt = *range.begin();
+            bool plain = wt->GetSampleFormat() == int16Sample &&
+               wt->GetRate() == rate &&
+               wt->GetGain() == 1.0 && wt->GetPan() == 0.0;
+            for (const auto &clip : wt->GetClips()) {
+               auto &env = *clip->GetEnvelope();
+               plain = plain && env.GetNumberOfPoints() == 0 &&
+                  env.GetValue(clip->GetStartTime()) == 1.0;
+            }
+            if (plain)
+               directTrack = wt;
+         }
+      }
+
+      if (directTrack) {
+         InitProgress( pDialog, wxFileName(fName).GetName(),
+            selectionOnly
+               ? wxString::Format(_("Exporting the selected audio as %s"),
+                  formatStr)
+               : wxString::Format(_("Exporting the audio as %s"),
+                  formatStr) );
+         auto &progress = *pDialog;
+
+         const auto start = directTrack->TimeToLongSamples(t0);
+         const auto end = directTrack->TimeToLongSamples(t1);
+         SampleBuffer buffer(maxBlockLen, int16Sample);
+
+         for (auto pos = start;
+              pos < end && updateResult == ProgressResult::Success;) {
+            auto len = limitSampleBufferSize(maxBlockLen, end - pos);
+            directTrack->Get(buffer.ptr(), int16Sample, pos, len);
+
+            auto samplesWritten = SFCall<sf_count_t>(sf_writef_short,
+               sf.get(), (short *)buffer.ptr(), len);
+            if (static_cast<size_t>(samplesWritten) != len) {
+               char buffer2[1000];
+               sf_error_str(sf.get(), buffer2, 1000);
+               AudacityMessageBox(wxString::Format(
+                                             /* i18n-hint: %s will be the error message from libsndfile, which
+                                              * is usually something unhelpful (and untranslated) like "system
+                                              * error" */
+                                             _("Error while writing %s file (disk full?).\nLibsndfile says \"%s\""),
+                                             formatStr,
+                                             wxString::FromAscii(buffer2)));
+               updateResult = ProgressResult::Cancelled;
+               break;
+            }
+
+            pos += len;
+            updateResult = UpdateProgress(progress,
+               (pos - start).as_double(), (end - start).as_double());
+         }
+      }
+      else {
          wxASSERT(info.channels >= 0);
          auto mixer = CreateMixer(tracks, selectionOnly,
                                   t0, t1,
                                   info.channels, maxBlockLen, true,
                                   rate, format, true, mixerSpec);
+         ExportMixerPipeline pipeline{ *mixer,
+            (unsigned) info.channels, maxBlockLen, true, format };
 
          InitProgress( pDialog, wxFileName(fName).GetName(),
             selectionOnly
@@ -559,12 +634,12 @@ ProgressResult ExportPCM::Export(AudacityProject *project,
 
          while (updateResult == ProgressResult::Success) {
             sf_count_t samplesWritten;
-            size_t numSamples = mixer->Process(maxBlockLen);
+            size_t numSamples = pipeline.Process();
 
             if (numSamples == 0)
                break;
 
-            samplePtr mixed = mixer->GetBuffer();
+            samplePtr mixed = pipeline.GetBuffer();
 
             if (format == int16Sample)
                samplesWritten = SFCall<sf_count_t>(sf_writef_short, sf.get(), (short *)mixed, numSamples);
@@ -584,8 +659,8 @@ ProgressResult ExportPCM::Export(AudacityProject *project,
                updateResult = ProgressResult::Cancelled;
                break;
             }
-            
-            updateResult = progress.Update(mixer->MixGetCurrentTime() - t0, t1 - t0);
+
+            updateResult = UpdateProgress(progress, pipeline.MixGetCurrentTime() - t0, t1 - t0);
          }
       }
       
@@ -782,11 +857,14 @@ struct id3_tag_deleter {
    void operator () (id3_tag *p) const { if (p) id3_tag_delete(p); }
 };
 using id3_tag_holder = std::unique_ptr<id3_tag, id3_tag_deleter>;
-#endif
 
-bool ExportPCM::AddID3Chunk(wxString fName, const Tags *tags, int sf_format)
+namespace {
+
+// Build an ID3v2 tag for the given metadata and render it into buffer,
+// returning the rendered length, padded to an even count; zero when
+// there is nothing to write.
+id3_length_t MakeID3Buffer(const Tags *tags, ArrayOf<id3_byte_t> &buffer)
 {
-#ifdef USE_LIBID3TAG
    id3_tag_holder tp { id3_tag_new() };
 
    for (const auto &pair : tags->GetRange()) {
@@ -869,18 +947,32 @@ bool ExportPCM::AddID3Chunk(wxString fName, const Tags *tags, int sf_format)
 
    len = id3_tag_render(tp.get(), 0);
    if (len == 0)
-      return true;
+      return 0;
 
    if ((len % 2) != 0) len++;   // Length must be even.
-   ArrayOf<id3_byte_t> buffer { len, true };
-   if (buffer == NULL)
-      return false;
 
    // Zero all locations, for ending odd UTF16 content
    // correctly, i.e., two '\0's at the end.
+   buffer.reinit(len, true);
 
    id3_tag_render(tp.get(), buffer.get());
 
+   return len;
+}
+
+} // namespace
+#endif
+
+bool ExportPCM::AddID3Chunk(wxString fName, const Tags *tags, int sf_format)
+{
+#ifdef USE_LIBID3TAG
+   ArrayOf<id3_byte_t> buffer;
+   id3_length_t len = MakeID3Buffer(tags, buffer);
+   if (len == 0)
+      return true;
+   if (buffer == NULL)
+      return false;
+
    wxFFile f(fName, wxT("r+b"));
    if (f.IsOpened()) {
       wxUint32 sz;
@@ -925,6 +1017,118 @@ bool ExportPCM::AddID3Chunk(wxString fName, const Tags *tags, int sf_format)
    return true;
 }
 
+bool ExportPCM::RewriteMetadata(const wxString &fName,
+                                const Tags *metadata, int WXUNUSED(subformat))
+{
+#ifdef USE_LIBID3TAG
+   if (!metadata)
+      return false;
+
+   wxFFile f(fName, wxT("r+b"));
+   if (!f.IsOpened())
+      return false;
+
+   char magic[4];
+   if (4 != f.Read(magic, 4))
+      return false;
+
+   int sf_format;
+   if (memcmp(magic, "RIFF", 4) == 0)
+      sf_format = SF_FORMAT_WAV;
+   else if (memcmp(magic, "FORM", 4) == 0)
+      sf_format = SF_FORMAT_AIFF;
+   else
+      // Only the two chunked containers take the id3 chunk; everything
+      // else needs a full export to retag
+      return false;
+   bool wav = (sf_format == SF_FORMAT_WAV);
+
+   wxFileOffset fileLen = f.Length();
+
+   // Walk the chunks looking for the one AddID3Chunk appended; it is
+   // always the final chunk of our own exports
+   wxFileOffset chunkOff = 0;
+   wxUint32 chunkSize = 0;
+   wxFileOffset pos = 12;
+   while (pos + 8 <= fileLen) {
+      char id[4];
+      wxUint32 sz;
+      if (!f.Seek(pos) || 4 != f.Read(id, 4) || 4 != f.Read(&sz, 4))
+         return false;
+      if (!wav)
+         sz = wxUINT32_SWAP_ON_LE(sz);
+      if (memcmp(id, wav ? "id3 " : "ID3 ", 4) == 0) {
+         chunkOff = pos;
+         chunkSize = sz;
+      }
+      pos += 8 + sz + (sz & 1);   // Chunks are padded to even lengths
+   }
+
+   if (chunkOff == 0) {
+      // No metadata chunk yet, so append one just as an export would
+      f.Close();
+      return AddID3Chunk(fName, metadata, sf_format);
+   }
+
+   ArrayOf<id3_byte_t> buffer;
+   id3_length_t len = MakeID3Buffer(metadata, buffer);
+   if (len == 0 || buffer == NULL)
+      return false;
+
+   if (len <= chunkSize) {
+      // Fits in the old chunk.  Keep the chunk size and grow the
+      // declared tag size out to it, so the leftover space counts as
+      // in-tag padding and no other chunk moves.
+      id3_length_t padded = chunkSize - 10;
+      buffer[6] = (id3_byte_t)((padded >> 21) & 0x7f);
+      buffer[7] = (id3_byte_t)((padded >> 14) & 0x7f);
+      buffer[8] = (id3_byte_t)((padded >> 7) & 0x7f);
+      buffer[9] = (id3_byte_t)(padded & 0x7f);
+
+      if (!f.Seek(chunkOff + 8))
+         return false;
+      if (len != f.Write(buffer.get(), len))
+         return false;
+      if (chunkSize > len) {
+         ArrayOf<char> zeros{ chunkSize - len, true };
+         if (chunkSize - len != f.Write(zeros.get(), chunkSize - len))
+            return false;
+      }
+   }
+   else if (chunkOff + 8 + chunkSize + (chunkSize & 1) >= fileLen) {
+      // Outgrew the old chunk, but it is the last one, so rewrite it
+      // with the NEW size and let the file grow
+      wxUint32 sz = (wxUint32) len;
+      if (!wav)
+         sz = wxUINT32_SWAP_ON_LE(sz);
+
+      if (!f.Seek(chunkOff + 4))
+         return false;
+      if (4 != f.Write(&sz, 4))
+         return false;
+      if (len != f.Write(buffer.get(), len))
+         return false;
+
+      // Patch the container size to cover the larger chunk
+      sz = (wxUint32) (chunkOff + 8 + len) - 8;
+      if (!wav)
+         sz = wxUINT32_SWAP_ON_LE(sz);
+      if (!f.Seek(4))
+         return false;
+      if (4 != f.Write(&sz, 4))
+         return false;
+   }
+   else
+      // An id3 chunk in the middle of the file that the NEW tags do not
+      // fit into; moving the chunks behind it is a full export's job
+      return false;
+
+   return f.Flush() && f.Close();
+#else
+   return false;
+#endif
+}
+
 wxWindow *ExportPCM::OptionsCreate(wxWindow *parent, int format)
 {
    wxASSERT(parent); // to justify safenew
@@ -22,6 +22,7 @@ for classification of the sample format and the used endianness.
 #include <stdint.h>
 #include <cmath>
 #include <cfloat>
+#include <cstring>
 #include <vector>
 #include <cstdio>
 
@@ -51,7 +52,10 @@ FormatClassifier::FormatClassifier(const char* filename) :
    // Build feature vectors
    mMonoFeat = Floats{ mClasses.size() };
    mStereoFeat = Floats{ mClasses.size() };
-   
+
+   // The file length is needed to spread the probes over the whole file
+   mFileSize = mReader.GetFileSize();
+
 #ifdef FORMATCLASSIFIER_SIGNAL_DEBUG
    // Build a debug writer
    char dfile [1024];
@@ -129,54 +133,133 @@ unsigned FormatClassifier::GetResultChannels()
 
 void FormatClassifier::Run()
 {
-   // Calc the mono feature vector
-   for (unsigned int n = 0; n < mClasses.size(); n++)
+   const size_t numClasses = mClasses.size();
+
+   // The feature ratio the best class must have over the runner-up to be
+   // called dominant
+   static const float cDominance = 2.0f;
+
+   // One integrated probe signal per class, for each channel hypothesis
+   std::vector<Floats> monoSigs;
+   std::vector<Floats> stereoSigs;
+   std::vector<bool> monoDone(numClasses, false);
+   std::vector<bool> stereoDone(numClasses, false);
+
+   for (unsigned int n = 0; n < numClasses; n++)
    {
-      // Read the signal
-      ReadSignal(mClasses[n], 1);
-#ifdef FORMATCLASSIFIER_SIGNAL_DEBUG
-      mpWriter->WriteSignal(mSigBuffer, cSiglen);
-#endif
+      monoSigs.push_back(Floats{ cSiglen });
+      stereoSigs.push_back(Floats{ cSiglen });
+      memset(monoSigs[n].get(), 0, cSiglen * sizeof(float));
+      memset(stereoSigs[n].get(), 0, cSiglen * sizeof(float));
+   }
+
+   // No dominant class seen yet
+   size_t lastWinner = 2 * numClasses;
+
+   for (unsigned int pass = 0; pass < cNumInts; pass++)
+   {
+      // Integrate one probe block for every class hypothesis
+      for (unsigned int n = 0; n < numClasses; n++)
+      {
+         if (!monoDone[n])
+         {
+            size_t actRead = ReadSignalBlock(mClasses[n], 1, pass, mAuxBuffer.get());
+
+            if (actRead > 0)
+            {
+               Add(monoSigs[n].get(), mAuxBuffer.get(), cSiglen);
+            }
+            if (actRead < cSiglen)
+            {
+               monoDone[n] = true;
+            }
+         }
+
+         if (!stereoDone[n])
+         {
+            size_t actRead = ReadSignalBlock(mClasses[n], 2, pass, mAuxBuffer.get());
+
+            if (actRead > 0)
+            {
+               Add(stereoSigs[n].get(), mAuxBuffer.get(), cSiglen);
+            }
+            if (actRead < cSiglen)
+            {
+               stereoDone[n] = true;
+            }
+         }
+      }
+
+      // After a minimum number of probes, check whether one class already
+      // dominates the runner-up.  If the same class dominates on two
+      // consecutive passes, more probing will not change the verdict, so
+      // stop reading early.  That keeps raw import setup fast on slow
+      // media such as network shares.
+      if ((pass + 1 >= cMinInts) && (pass + 1 < cNumInts))
+      {
+         for (unsigned int n = 0; n < numClasses; n++)
+         {
+            mMonoFeat[n] = Feature(monoSigs[n].get());
+            mStereoFeat[n] = Feature(stereoSigs[n].get());
+         }
+
+         size_t midx, sidx;
+         float monoMax = Max(mMonoFeat.get(), numClasses, &midx);
+         float stereoMax = Max(mStereoFeat.get(), numClasses, &sidx);
+
+         float best;
+         size_t winner;
+
+         if (monoMax > stereoMax)
+         {
+            best = monoMax;
+            winner = midx;
+         }
+         else
+         {
+            best = stereoMax;
+            winner = numClasses + sidx;
+         }
+
+         // Find the runner-up over both feature vectors
+         float second = -FLT_MAX;
+
+         for (unsigned int n = 0; n < numClasses; n++)
+         {
+            if ((n != winner) && (mMonoFeat[n] > second))
+            {
+               second = mMonoFeat[n];
+            }
+            if ((numClasses + n != winner) && (mStereoFeat[n] > second))
+            {
+               second = mStereoFeat[n];
+            }
+         }
 
-      // Do some simple preprocessing
-      // Remove DC offset
-      float smean = Mean(mSigBuffer.get(), cSiglen);
-      Sub(mSigBuffer.get(), smean, cSiglen);
-      // Normalize to +- 1.0
-      Abs(mSigBuffer.get(), mAuxBuffer.get(), cSiglen);
-      float smax = Max(mAuxBuffer.get(), cSiglen);
-      Div(mSigBuffer.get(), smax, cSiglen);
-
-      // Now actually fill the feature vector
-      // Low to high band power ratio
-      float pLo = mMeter.CalcPower(mSigBuffer.get(), 0.15f, 0.3f);
-      float pHi = mMeter.CalcPower(mSigBuffer.get(), 0.45f, 0.1f);
-      mMonoFeat[n] = pLo / pHi;
+         if (best > cDominance * second)
+         {
+            if (winner == lastWinner)
+            {
+               break;
+            }
+            lastWinner = winner;
+         }
+         else
+         {
+            lastWinner = 2 * numClasses;
+         }
+      }
    }
 
-   // Calc the stereo feature vector
-   for (unsigned int n = 0; n < mClasses.size(); n++)
+   // Build the final feature vectors from the integrated signals
+   for (unsigned int n = 0; n < numClasses; n++)
    {
-      // Read the signal
-      ReadSignal(mClasses[n], 2);
+      mMonoFeat[n] = Feature(monoSigs[n].get());
+      mStereoFeat[n] = Feature(stereoSigs[n].get());
 #ifdef FORMATCLASSIFIER_SIGNAL_DEBUG
-      mpWriter->WriteSignal(mSigBuffer, cSiglen);
+      mpWriter->WriteSignal(monoSigs[n].get(), cSiglen);
+      mpWriter->WriteSignal(stereoSigs[n].get(), cSiglen);
 #endif
-
-      // Do some simple preprocessing
-      // Remove DC offset
-      float smean = Mean(mSigBuffer.get(), cSiglen);
-      Sub(mSigBuffer.get(), smean, cSiglen);
-      // Normalize to +- 1.0
-      Abs(mSigBuffer.get(), mAuxBuffer.get(), cSiglen);
-      float smax = Max(mAuxBuffer.get(), cSiglen);
-      Div(mSigBuffer.get(), smax, cSiglen);
-
-      // Now actually fill the feature vector
-      // Low to high band power ratio
-      float pLo = mMeter.CalcPower(mSigBuffer.get(), 0.15f, 0.3f);
-      float pHi = mMeter.CalcPower(mSigBuffer.get(), 0.45f, 0.1f);
-      mStereoFeat[n] = pLo / pHi;
    }
 
    // Get the results
@@ -197,42 +280,63 @@ void FormatClassifier::Run()
 
 }
 
-void FormatClassifier::ReadSignal(FormatClassT format, size_t stride)
+size_t FormatClassifier::ReadSignalBlock(FormatClassT format, size_t stride, size_t pass, float* out)
 {
-   size_t actRead = 0;
-   unsigned int n = 0;
+   // Byte alignment of one stride of samples, so that every probe keeps
+   // each channel in its place within the stride
+   size_t align = SampleSize(format.format) * stride;
+   size_t blockBytes = cSiglen * align;
 
-   mReader.Reset();
+   // Skip potential header information
+   uint64_t offset = cHeaderSkip;
 
-   // Do a dummy read of 1024 bytes to skip potential header information
-   mReader.ReadSamples(mRawBuffer.get(), 1024, MultiFormatReader::Uint8, MachineEndianness::Little);
-
-   do
+   if (mFileSize > cHeaderSkip + blockBytes)
    {
-      actRead = mReader.ReadSamples(mRawBuffer.get(), cSiglen, stride, format.format, format.endian);
+      // Spread the probes evenly over the whole file.  A few KB at
+      // scattered offsets classify just as well as one contiguous
+      // prefix, read far less, and break the signal coherence between
+      // the integration passes as a side effect.
+      uint64_t span = mFileSize - cHeaderSkip - blockBytes;
+      offset += (span * pass) / cNumInts;
+      offset -= (offset - cHeaderSkip) % align;
+   }
 
-      if (n == 0)
-      {
-         ConvertSamples(mRawBuffer.get(), mSigBuffer.get(), format);
-      }
-      else
-      {
-         if (actRead == cSiglen)
-         {
-            ConvertSamples(mRawBuffer.get(), mAuxBuffer.get(), format);
+   mReader.SeekTo(offset);
 
-            // Integrate signals
-            Add(mSigBuffer.get(), mAuxBuffer.get(), cSiglen);
+   size_t actRead = mReader.ReadSamples(mRawBuffer.get(), cSiglen, stride, format.format, format.endian);
 
-            // Do some dummy reads to break signal coherence
-            mReader.ReadSamples(mRawBuffer.get(), n + 1, stride, format.format, format.endian);
-         }
-      }
+   if (actRead > 0)
+   {
+      ConvertSamples(mRawBuffer.get(), out, format);
 
-      n++;
+      if (actRead < cSiglen)
+      {
+         // Zero the part of the block the file could not fill
+         memset(&out[actRead], 0, (cSiglen - actRead) * sizeof(float));
+      }
+   }
 
-   } while ((n < cNumInts) && (actRead == cSiglen));
+   return actRead;
+}
 
+float FormatClassifier::Feature(float* in)
+{
+   // Do some simple preprocessing on a scratch copy
+   memcpy(mSigBuffer.get(), in, cSiglen * sizeof(float));
+
+   // Remove DC offset
+   float smean = Mean(mSigBuffer.get(), cSiglen);
+   Sub(mSigBuffer.get(), smean, cSiglen);
+   // Normalize to +- 1.0
+   Abs(mSigBuffer.get(), mAuxBuffer.get(), cSiglen);
+   float smax = Max(mAuxBuffer.get(), cSiglen);
+   Div(mSigBuffer.get(), smax, cSiglen);
+
+   // Low to high band power ratio
+   float pLo = mMeter.CalcPower(mSigBuffer.get(), 0.15f, 0.3f);
+   float pHi = mMeter.CalcPower(mSigBuffer.get(), 0.45f, 0.1f);
+
+   return pLo / pHi;
 }
 
 void FormatClassifier::ConvertSamples(void* in, float* out, FormatClassT format)
@@ -266,6 +370,24 @@ void FormatClassifier::ConvertSamples(void* in, float* out, FormatClassT format)
    }
 }
 
+size_t FormatClassifier::SampleSize(MultiFormatReader::FormatT format)
+{
+   switch(format)
+   {
+      case MultiFormatReader::Int16:
+      case MultiFormatReader::Uint16:
+         return 2;
+      case MultiFormatReader::Int32:
+      case MultiFormatReader::Uint32:
+      case MultiFormatReader::Float:
+         return 4;
+      case MultiFormatReader::Double:
+         return 8;
+      default:
+         return 1;
+   }
+}
+
 void FormatClassifier::Add(float* in1, float* in2, size_t len)
 {
    for (unsigned int n = 0; n < len; n++)
@@ -72,10 +72,13 @@ private:
 
    static const size_t cSiglen = 512;
    static const size_t cNumInts = 32;
+   static const size_t cMinInts = 8;
+   static const size_t cHeaderSkip = 1024;
 
    FormatVectorT        mClasses;
    MultiFormatReader    mReader;
    SpecPowerCalculation mMeter;
+   uint64_t             mFileSize { 0 };
 
 #ifdef FORMATCLASSIFIER_SIGNAL_DEBUG
    std::unique_ptr<DebugWriter> mpWriter;
@@ -100,8 +103,10 @@ public:
    unsigned GetResultChannels();
 private:
    void Run();
-   void ReadSignal(FormatClassT format, size_t stride);
+   size_t ReadSignalBlock(FormatClassT format, size_t stride, size_t pass, float* out);
+   float Feature(float* in);
    void ConvertSamples(void* in, float* out, FormatClassT format);
+   static size_t SampleSize(MultiFormatReader::FormatT format);
 
    void Add(float* in1, float* in2, size_t len);
    void Sub(float* in, float subt, size_t len);
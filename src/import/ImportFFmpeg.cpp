@@ -156,6 +156,7 @@ static const auto exts = {
 #include "Import.h"
 #include "../Tags.h"
 #include "../WaveTrack.h"
+#include "../effects/TrackIOQueue.h"
 #include "ImportPlugin.h"
 
 
@@ -279,6 +280,9 @@ private:
                                          //!< First dimension - streams,
                                          //!< second - channels of a stream.
                                          //!< Length is mNumStreams
+   TrackIOQueue         *mAppendQueue{ nullptr }; //!< Runs the Appends off the decode thread; set only while Import() runs
+   TrackIOQueue::Ticket  mAppendTickets[16] = {}; //!< Ring of in-flight append jobs, bounding the backlog
+   unsigned              mAppendSlot{ 0 };        //!< Next slot of mAppendTickets to reuse
 #ifdef EXPERIMENTAL_OD_FFMPEG
    bool                  mUsingOD;
 #endif
@@ -630,6 +634,12 @@ ProgressResult FFmpegImportFileHandle::Import(TrackFactory *trackFactory,
    } else {
 #endif
 
+   // Decode on this thread while a single worker runs the Appends, so
+   // demuxing and decoding overlap the blockfile writes and summary
+   // computation.  WriteData posts each converted frame to this queue.
+   TrackIOQueue appendQueue;
+   mAppendQueue = &appendQueue;
+
    // Read next frame.
    for (streamContext *sc; (sc = ReadNextFrame()) != NULL && (res == ProgressResult::Success);)
    {
@@ -667,6 +677,11 @@ ProgressResult FFmpegImportFileHandle::Import(TrackFactory *trackFactory,
          }
       }
    }
+
+   // Let pending appends finish, and surface any error of theirs here,
+   // before the tracks are flushed.
+   appendQueue.Finish();
+   mAppendQueue = nullptr;
 #ifdef EXPERIMENTAL_OD_FFMPEG
    } // else -- !mUsingOD == true
 #endif   //EXPERIMENTAL_OD_FFMPEG
@@ -727,7 +742,10 @@ ProgressResult FFmpegImportFileHandle::WriteData(streamContext *sc)
    auto insamples = sc->m_decodedAudioSamplesValidSiz / sc->m_samplesize;
    size_t nChannels = std::min(sc->m_stream->codec->channels, sc->m_initialchannels);
 
-   ArraysOf<uint8_t> tmp{ nChannels, sc->m_osamplesize * (insamples / nChannels) };
+   // The buffer is shared with the append job below, which frees it when
+   // the worker is done with the frame.
+   auto tmp = std::make_shared<ArraysOf<uint8_t>>(
+      nChannels, sc->m_osamplesize * (insamples / nChannels) );
 
    // Separate the channels and convert input sample format to 16-bit
    uint8_t *in = sc->m_decodedAudioSamples.get();
@@ -743,27 +761,27 @@ ProgressResult FFmpegImportFileHandle::WriteData(streamContext *sc)
             {
                case AV_SAMPLE_FMT_U8:
                case AV_SAMPLE_FMT_U8P:
-                  ((int16_t *)tmp[chn].get())[index] = (int16_t) (*(uint8_t *)in - 0x80) << 8;
+                  ((int16_t *)(*tmp)[chn].get())[index] = (int16_t) (*(uint8_t *)in - 0x80) << 8;
                break;
 
                case AV_SAMPLE_FMT_S16:
                case AV_SAMPLE_FMT_S16P:
-                  ((int16_t *)tmp[chn].get())[index] = (int16_t) *(int16_t *)in;
+                  ((int16_t *)(*tmp)[chn].get())[index] = (int16_t) *(int16_t *)in;
                break;
 
                case AV_SAMPLE_FMT_S32:
                case AV_SAMPLE_FMT_S32P:
-                  ((float *)tmp[chn].get())[index] = (float) *(int32_t *)in * (1.0 / (1u << 31));
+                  ((float *)(*tmp)[chn].get())[index] = (float) *(int32_t *)in * (1.0 / (1u << 31));
                break;
 
                case AV_SAMPLE_FMT_FLT:
                case AV_SAMPLE_FMT_FLTP:
-                  ((float *)tmp[chn].get())[index] = (float) *(float *)in;
+                  ((float *)(*tmp)[chn].get())[index] = (float) *(float *)in;
                break;
 
                case AV_SAMPLE_FMT_DBL:
                case AV_SAMPLE_FMT_DBLP:
-                  ((float *)tmp[chn].get())[index] = (float) *(double *)in;
+                  ((float *)(*tmp)[chn].get())[index] = (float) *(double *)in;
                break;
 
                default:
@@ -778,12 +796,24 @@ ProgressResult FFmpegImportFileHandle::WriteData(streamContext *sc)
       index++;
    }
 
-   // Write audio into WaveTracks
-   auto iter2 = iter->begin();
-   for (size_t chn=0; chn < nChannels; ++iter2, ++chn)
-   {
-      iter2->get()->Append((samplePtr)tmp[chn].get(), sc->m_osamplefmt, index);
-   }
+   // Hand the converted frame to the append worker, which writes the
+   // WaveTracks while the next packet is demuxed and decoded.  The slot
+   // ring keeps no more than a few frames in flight; Wait also rethrows
+   // whatever an earlier append threw, such as a disk-full exception.
+   wxASSERT(mAppendQueue);
+   mAppendQueue->Wait(mAppendTickets[mAppendSlot]);
+   const auto pStream = &*iter;
+   const auto format = sc->m_osamplefmt;
+   const int len = index;
+   mAppendTickets[mAppendSlot] =
+      mAppendQueue->Post([pStream, tmp, format, len, nChannels]{
+         auto iter2 = pStream->begin();
+         for (size_t chn=0; chn < nChannels; ++iter2, ++chn)
+         {
+            iter2->get()->Append((samplePtr)(*tmp)[chn].get(), format, len);
+         }
+      });
+   mAppendSlot = (mAppendSlot + 1) % WXSIZEOF(mAppendTickets);
 
    // Try to update the progress indicator (and see if user wants to cancel)
    auto updateResult = ProgressResult::Success;
@@ -502,20 +502,15 @@ ProgressResult FLACImportFileHandle::Import(TrackFactory *trackFactory,
             break;
       }
 
-      bool moreThanStereo = mNumChannels>2;
       for (const auto &channel : mChannels)
       {
+         //every channel gets its own task, and thereby its own decoder
+         //instance and thread, so even a single stereo file decodes on
+         //two cores rather than one.
          mDecoderTask->AddWaveTrack(channel);
-         if(moreThanStereo)
-         {
-            //if we have 3 more channels, they get imported on seperate tracks, so we add individual tasks for each.
-            ODManager::Instance()->AddNewTask(std::move(mDecoderTask));
-            mDecoderTask = std::make_unique<ODDecodeFlacTask>(); //TODO: see if we need to use clone to keep the metadata.
-         }
-      }
-      //if we have mono or a linked track (stereo), we add ONE task for the one linked wave track
-      if(!moreThanStereo)
          ODManager::Instance()->AddNewTask(std::move(mDecoderTask));
+         mDecoderTask = std::make_unique<ODDecodeFlacTask>(); //TODO: see if we need to use clone to keep the metadata.
+      }
    }
 //END OD
 
@@ -71,6 +71,7 @@
 
 #include "../Audacity.h" // for USE_* macros
 
+#include <wx/ffile.h>
 #include <wx/string.h>
 #include <wx/utils.h>
 #include <wx/intl.h>
@@ -82,6 +83,7 @@
 #endif // USE_MIDI
 #include "../FileNames.h"
 #include "../WaveTrack.h"
+#include "../effects/TrackIOQueue.h"
 #include "ImportPlugin.h"
 #include "Import.h"
 #include "../NoteTrack.h"
@@ -146,6 +148,8 @@ private:
    // Takes a line of text in lof file and interprets it and opens files
    void lofOpenFiles(wxString* ln);
    void doDurationAndScrollOffset();
+   // Makes an absolute path from a file name on a "file" line
+   wxString lofResolveFile(const wxString & targettoken);
 
    std::unique_ptr<wxTextFile> mTextFile;
    wxFileName mLOFFileName;  /**< The name of the LOF file, which is used to
@@ -162,8 +166,39 @@ private:
    // In order to offset scrollbar, it must be done after files are opened
    bool              callScrollOffset{ false };
    double            scrollOffset{ 0 };
+
+   // The files listed, in list order, and how far the imports have got,
+   // so that the next listed file can be read ahead while one imports
+   wxArrayString     mLOFFiles;
+   size_t            mNextLOFFile{ 0 };
+   TrackIOQueue      mPrefetchQueue;
 };
 
+namespace {
+
+/** @brief Reads through a file sequentially on the I/O thread, so that a
+ * following import of it finds the data in the OS cache.
+ *
+ * The importers themselves must still run one at a time on the main
+ * thread, because block file creation is not thread safe, but on slow
+ * media this keeps the disk busy between imports.  Errors are ignored
+ * here; the import of the file will report them.
+ */
+void PrefetchLOFFile(TrackIOQueue &queue, const wxString &fileName)
+{
+   queue.Post([fileName]{
+      wxFFile file(fileName, wxT("rb"));
+      if (!file.IsOpened())
+         return;
+      char buffer[65536];
+      while (!file.Eof())
+         if (file.Read(buffer, sizeof(buffer)) == 0)
+            break;
+   });
+}
+
+}
+
 LOFImportFileHandle::LOFImportFileHandle
    (const FilePath & name, std::unique_ptr<wxTextFile> &&file)
 :  ImportFileHandle(name),
@@ -247,6 +282,19 @@ ProgressResult LOFImportFileHandle::Import(
       return ProgressResult::Failed;
    }
 
+   // Collect the names of all listed files up front, so that while one
+   // file imports, the one after it can already be read ahead
+   for (size_t i = 0; i < mTextFile->GetLineCount(); i++)
+   {
+      wxStringTokenizer tok(mTextFile->GetLine(i), wxT(" "));
+      if (tok.GetNextToken().IsSameAs(wxT("file"), false))
+      {
+         wxStringTokenizer temptok(mTextFile->GetLine(i), wxT("\""));
+         temptok.GetNextToken();
+         mLOFFiles.push_back(lofResolveFile(temptok.GetNextToken()));
+      }
+   }
+
    wxString line = mTextFile->GetFirstLine();
 
    while (!mTextFile->Eof())
@@ -385,16 +433,12 @@ void LOFImportFileHandle::lofOpenFiles(wxString* ln)
       // To identify filename and open it
       tokenholder = temptok1.GetNextToken();
       wxString targettoken = temptok1.GetNextToken();
-      targetfile = targettoken;
-
-      // If path is relative, make absolute path from LOF path
-      if(!wxIsAbsolutePath(targetfile)) {
-         wxFileName fName(targetfile);
-         fName.Normalize(wxPATH_NORM_ALL, mLOFFileName.GetPath(wxPATH_GET_VOLUME | wxPATH_GET_SEPARATOR));
-         if(fName.FileExists()) {
-            targetfile = fName.GetFullPath();
-         }
-      }
+      targetfile = lofResolveFile(targettoken);
+
+      // While this file imports, warm the OS cache with the next one in
+      // the list
+      if (++mNextLOFFile < mLOFFiles.size())
+         PrefetchLOFFile(mPrefetchQueue, mLOFFiles[mNextLOFFile]);
 
       // Do recursive call to import
 
@@ -491,6 +535,22 @@ void LOFImportFileHandle::lofOpenFiles(wxString* ln)
    }
 }
 
+wxString LOFImportFileHandle::lofResolveFile(const wxString & targettoken)
+{
+   wxString targetfile = targettoken;
+
+   // If path is relative, make absolute path from LOF path
+   if(!wxIsAbsolutePath(targetfile)) {
+      wxFileName fName(targetfile);
+      fName.Normalize(wxPATH_NORM_ALL, mLOFFileName.GetPath(wxPATH_GET_VOLUME | wxPATH_GET_SEPARATOR));
+      if(fName.FileExists()) {
+         targetfile = fName.GetFullPath();
+      }
+   }
+
+   return targetfile;
+}
+
 void LOFImportFileHandle::doDurationAndScrollOffset()
 {
    if (!mProject)
@@ -11,10 +11,15 @@
 #include "../Audacity.h" // for USE_* macros
 #include "ImportMIDI.h"
 
+#include <atomic>
+#include <istream>
+#include <streambuf>
+
 #include <wx/defs.h>
 #include <wx/ffile.h>
 #include <wx/frame.h>
 #include <wx/intl.h>
+#include <wx/utils.h>
 
 #if defined(USE_MIDI)
 
@@ -22,33 +27,36 @@
 //#include "strparse.h"
 //#include "mfmidi.h"
 
+#include "../MemoryX.h"
 #include "../NoteTrack.h"
 #include "../Project.h"
 #include "../ProjectHistory.h"
 #include "../ProjectWindow.h"
 #include "../SelectUtilities.h"
+#include "../effects/TrackIOQueue.h"
 #include "../widgets/AudacityMessageBox.h"
 #include "../widgets/FileHistory.h"
+#include "../widgets/ProgressDialog.h"
 
 // Given an existing project, try to import into it, return true on success
 bool DoImportMIDI( AudacityProject &project, const FilePath &fileName )
 {
    auto &tracks = TrackList::Get( project );
    auto newTrack = TrackFactory::Get( project ).NewNoteTrack();
-   
+
    if (::ImportMIDI(fileName, newTrack.get())) {
-      
+
       SelectUtilities::SelectNone( project );
       auto pTrack = tracks.Add( newTrack );
       pTrack->SetSelected(true);
-      
+
       ProjectHistory::Get( project )
          .PushState(
             wxString::Format(_("Imported MIDI from '%s'"),
                          fileName),
             _("Import MIDI")
          );
-      
+
       ProjectWindow::Get( project ).ZoomAfterImport(pTrack);
       FileHistory::Global().AddFileToHistory(fileName);
       return true;
@@ -57,6 +65,51 @@ bool DoImportMIDI( AudacityProject &project, const FilePath &fileName )
       return false;
 }
 
+namespace {
+
+// Serves an in-memory image of the MIDI file to the parser in small
+// windows, counting the bytes handed out so that another thread can
+// show progress, and starving the parser once Abort() is called so
+// that a cancelled parse winds down at once.
+class MIDIStreamBuffer final : public std::streambuf
+{
+public:
+   MIDIStreamBuffer(char *data, size_t length)
+      : mData{ data }, mLength{ length }
+   {}
+
+   size_t Consumed() const
+      { return mConsumed.load(std::memory_order_relaxed); }
+
+   void Abort()
+      { mAbort.store(true, std::memory_order_relaxed); }
+
+protected:
+   int_type underflow() override
+   {
+      auto pos = mConsumed.load(std::memory_order_relaxed);
+      if (pos >= mLength || mAbort.load(std::memory_order_relaxed))
+         return traits_type::eof();
+      auto len = mLength - pos;
+      if (len > cWindow)
+         len = cWindow;
+      char *p = mData + pos;
+      setg(p, p, p + len);
+      mConsumed.store(pos + len, std::memory_order_relaxed);
+      return traits_type::to_int_type(*p);
+   }
+
+private:
+   static const size_t cWindow = 64 * 1024;
+
+   char *mData;
+   size_t mLength;
+   std::atomic<size_t> mConsumed { 0 };
+   std::atomic<bool> mAbort { false };
+};
+
+}
+
 bool ImportMIDI(const FilePath &fName, NoteTrack * dest)
 {
    if (fName.length() <= 4){
@@ -85,14 +138,68 @@ bool ImportMIDI(const FilePath &fName, NoteTrack * dest)
    }
 
    double offset = 0.0;
-   auto new_seq = std::make_unique<Alg_seq>(fName.mb_str(), is_midi, &offset);
+   std::unique_ptr<Alg_seq> new_seq;
+   if (is_midi) {
+      // Read the whole file up front in one request.  The parser asks
+      // for single bytes, so paying the storage latency only once
+      // matters on network shares, and an in-memory image lets the
+      // parse run off the main thread.
+      auto length = mf.Length();
+      ArrayOf<char> buffer;
+      if (length > 0)
+         buffer.reinit((size_t)length);
+      if (length <= 0 ||
+          mf.Read(buffer.get(), (size_t)length) != (size_t)length) {
+         AudacityMessageBox( wxString::Format(
+            _("Could not open file %s."), fName
+         ) );
+         mf.Close();
+         return false;
+      }
+      mf.Close();
+
+      // Orchestral mockups with millions of events take a while to
+      // build into an Alg_seq.  Parse on a worker thread and keep the
+      // interface alive with a progress dialog meanwhile.
+      MIDIStreamBuffer streamBuffer{ buffer.get(), (size_t)length };
+      std::atomic<bool> done{ false };
+      TrackIOQueue queue;
+      auto ticket = queue.Post([&]{
+         std::istream stream{ &streamBuffer };
+         new_seq = std::make_unique<Alg_seq>(stream, true, &offset);
+         done.store(true);
+      });
+      bool cancelled = false;
+      {
+         ProgressDialog progress(_("Import MIDI"),
+            wxString::Format(_("Importing MIDI from '%s'"), fName),
+            pdlgHideStopButton);
+         while (!done.load()) {
+            auto result = progress.Update(
+               (wxULongLong_t)streamBuffer.Consumed(), (wxULongLong_t)length);
+            if (result != ProgressResult::Success) {
+               cancelled = true;
+               streamBuffer.Abort();
+            }
+            wxMilliSleep(50);
+         }
+      }
+      queue.Wait(ticket);
+      if (cancelled)
+         return false;
+   }
+   else {
+      // Allegro files are text and typically small; parse them in
+      // place as before
+      new_seq = std::make_unique<Alg_seq>(fName.mb_str(), false, &offset);
+      mf.Close();
+   }
 
    //Should we also check if(seq->tracks() == 0) ?
    if(new_seq->get_read_error() == alg_error_open){
       AudacityMessageBox( wxString::Format(
          _("Could not open file %s."), fName
       ) );
-      mf.Close();
       return false;
    }
 
@@ -100,7 +207,6 @@ bool ImportMIDI(const FilePath &fName, NoteTrack * dest)
    dest->SetOffset(offset);
    wxString trackNameBase = fName.AfterLast(wxFILE_SEP_PATH).BeforeLast('.');
    dest->SetName(trackNameBase);
-   mf.Close();
 
    dest->ZoomAllNotes();
    return true;
@@ -28,6 +28,8 @@
 
 #include "../Audacity.h" // for USE_* macros
 
+#include "../Experimental.h"
+
 // For compilers that support precompilation, includes "wx/wx.h".
 #include <wx/wxprec.h>
 
@@ -72,6 +74,13 @@ static Importer::RegisteredUnusableImportPlugin registered{
 
 #include "../WaveTrack.h"
 
+#ifdef EXPERIMENTAL_OD_MP3
+#include "../WaveClip.h"
+#include "../blockfile/ODDecodeBlockFile.h"
+#include "../ondemand/ODDecodeMP3Task.h"
+#include "../ondemand/ODManager.h"
+#endif
+
 // PRL:  include these last,
 // and correct some preprocessor namespace pollution from wxWidgets that
 // caused a warning about duplicate definition
@@ -209,6 +218,59 @@ ProgressResult MP3ImportFileHandle::Import(
 
    CreateProgress();
 
+//Start OD
+#ifdef EXPERIMENTAL_OD_MP3
+   // Try on-demand loading first.  One fast pass over the file builds a
+   // frame seek index; placeholder blockfiles go into the tracks, and the
+   // real decoding happens in the background as the data is needed.
+   {
+      auto decoderTask = std::make_unique<ODDecodeMP3Task>();
+      auto decoder =
+         static_cast<ODMP3Decoder *>(decoderTask->CreateFileDecoder(mFilename));
+      if (decoder->ReadHeader()) {
+         NewChannelGroup channels(decoder->GetNumChannels());
+         for (auto &channel : channels)
+            channel = trackFactory->NewWaveTrack(floatSample,
+                                                 decoder->GetSampleRate());
+
+         auto fileTotalFrames = (sampleCount) decoder->GetTotalSamples();
+         auto maxBlockSize = channels.begin()->get()->GetMaxBlockSize();
+         for (decltype(fileTotalFrames) i = 0; i < fileTotalFrames; i += maxBlockSize) {
+            const auto blockLen =
+               limitSampleBufferSize( maxBlockSize, fileTotalFrames - i );
+
+            auto iter = channels.begin();
+            for (size_t c = 0; c < channels.size(); ++c, ++iter)
+               iter->get()->RightmostOrNewClip()->AppendBlockFile(
+                  [&]( wxFileNameWrapper filePath, size_t len ) {
+                     return make_blockfile<ODDecodeBlockFile>(
+                     std::move(filePath), wxFileNameWrapper{ mFilename },
+                     i, len, c, ODTask::eODMP3);
+                  },
+                  blockLen
+               );
+         }
+
+         // mp3 has at most two channels, so one task serves the one
+         // linked wave track
+         for (const auto &channel : channels)
+            decoderTask->AddWaveTrack(channel);
+         ODManager::Instance()->AddNewTask(std::move(decoderTask));
+
+         for (const auto &channel : channels)
+            channel->Flush();
+         outTracks.push_back(std::move(channels));
+
+         ImportID3(tags);
+
+         return ProgressResult::Success;
+      }
+      // The scan found no valid frames; fall through and let the full
+      // decode report the failure.
+   }
+#endif
+//End OD
+
    /* Prepare decoder data, initialize decoder */
 
    private_data privateData;
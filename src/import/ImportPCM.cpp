@@ -53,8 +53,10 @@
 
 #include "../FileFormats.h"
 #include "../Prefs.h"
+#include "../SndfileReadahead.h"
 #include "../ShuttleGui.h"
 #include "../WaveTrack.h"
+#include "../effects/TrackIOQueue.h"
 #include "ImportPlugin.h"
 
 #include <algorithm>
@@ -94,7 +96,9 @@ public:
 class PCMImportFileHandle final : public ImportFileHandle
 {
 public:
-   PCMImportFileHandle(const FilePath &name, SFFile &&file, SF_INFO info);
+   PCMImportFileHandle(const FilePath &name,
+                       std::unique_ptr<ReadaheadFile> &&reader,
+                       SFFile &&file, SF_INFO info);
    ~PCMImportFileHandle();
 
    wxString GetFileDescription() override;
@@ -114,6 +118,8 @@ public:
    {}
 
 private:
+   // Declared before mFile, which reads through it and must close first
+   std::unique_ptr<ReadaheadFile> mReader;
    SFFile                mFile;
    const SF_INFO         mInfo;
    sampleFormat          mFormat;
@@ -127,7 +133,6 @@ wxString PCMImportPlugin::GetPluginFormatDescription()
 std::unique_ptr<ImportFileHandle> PCMImportPlugin::Open(const FilePath &filename)
 {
    SF_INFO info;
-   wxFile f;   // will be closed when it goes out of scope
    SFFile file;
 
    memset(&info, 0, sizeof(info));
@@ -150,17 +155,13 @@ std::unique_ptr<ImportFileHandle> PCMImportPlugin::Open(const FilePath &filename
 #endif
 
 
-   if (f.Open(filename)) {
-      // Even though there is an sf_open() that takes a filename, use the one that
-      // takes a file descriptor since wxWidgets can open a file with a Unicode name and
-      // libsndfile can't (under Windows).
-      file.reset(SFCall<SNDFILE*>(sf_open_fd, f.fd(), SFM_READ, &info, TRUE));
-   }
-
-   // The file descriptor is now owned by "file", so we must tell "f" to leave
-   // it alone.  The file descriptor is closed by the destructor of file even if an error
-   // occurs.
-   f.Detach();
+   // Read through a chunked readahead buffer, so that libsndfile's many
+   // small reads become few large ones; that matters when the file is on
+   // slow or remote storage.  This also lets wxWidgets open files with
+   // Unicode names, which libsndfile can't do by itself under Windows.
+   auto reader = std::make_unique<ReadaheadFile>(filename);
+   if (reader->IsOpened())
+      file.reset(reader->OpenSNDFILE(info));
 
    if (!file) {
       // TODO: Handle error
@@ -185,7 +186,8 @@ std::unique_ptr<ImportFileHandle> PCMImportPlugin::Open(const FilePath &filename
    }
 
    // Success, so now transfer the duty to close the file from "file".
-   return std::make_unique<PCMImportFileHandle>(filename, std::move(file), info);
+   return std::make_unique<PCMImportFileHandle>(filename,
+      std::move(reader), std::move(file), info);
 }
 
 unsigned PCMImportPlugin::SequenceNumber() const
@@ -198,8 +200,10 @@ static Importer::RegisteredImportPlugin registered{
 };
 
 PCMImportFileHandle::PCMImportFileHandle(const FilePath &name,
+                                         std::unique_ptr<ReadaheadFile> &&reader,
                                          SFFile &&file, SF_INFO info)
 :  ImportFileHandle(name),
+   mReader(std::move(reader)),
    mFile(std::move(file)),
    mInfo(info)
 {
@@ -477,16 +481,19 @@ ProgressResult PCMImportFileHandle::Import(TrackFactory *trackFactory,
       using type = decltype(maxBlockSize);
       if (mInfo.channels < 1)
          return ProgressResult::Failed;
-      auto maxBlock = std::min(maxBlockSize,
+      // Read several track blocks per gulp, so the file is fetched in
+      // long sequential runs; Append splits oversized lengths itself.
+      auto maxBlock = std::min(4 * maxBlockSize,
          std::numeric_limits<type>::max() /
             (mInfo.channels * SAMPLE_SIZE(mFormat))
       );
       if (maxBlock < 1)
          return ProgressResult::Failed;
 
-      SampleBuffer srcbuffer, buffer;
+      SampleBuffer srcbuffers[2], buffer;
       wxASSERT(mInfo.channels >= 0);
-      while (NULL == srcbuffer.Allocate(maxBlock * mInfo.channels, mFormat).ptr() ||
+      while (NULL == srcbuffers[0].Allocate(maxBlock * mInfo.channels, mFormat).ptr() ||
+             NULL == srcbuffers[1].Allocate(maxBlock * mInfo.channels, mFormat).ptr() ||
              NULL == buffer.Allocate(maxBlock, mFormat).ptr())
       {
          maxBlock /= 2;
@@ -496,15 +503,31 @@ ProgressResult PCMImportFileHandle::Import(TrackFactory *trackFactory,
 
       decltype(fileTotalFrames) framescompleted = 0;
 
+      // Decode on this thread while a single worker deinterleaves and
+      // appends the previous gulp, so reading the file overlaps the
+      // format conversion, summary computation and blockfile writes
+      // instead of alternating with them on one core.  The two source
+      // buffers rotate between the threads, and the deinterleave
+      // scratch belongs to the worker alone.  All channels append on
+      // the one worker, because DirManager is not safe for concurrent
+      // blockfile creation.
+      TrackIOQueue appendQueue;
+      TrackIOQueue::Ticket tickets[2] = { 0, 0 };
+
+      int slot = 0;
       long block;
       do {
          block = maxBlock;
 
+         // Reclaim this buffer from the worker; rethrows if an append
+         // failed, for instance because the disk filled.
+         appendQueue.Wait(tickets[slot]);
+
          if (mFormat == int16Sample)
-            block = SFCall<sf_count_t>(sf_readf_short, mFile.get(), (short *)srcbuffer.ptr(), block);
+            block = SFCall<sf_count_t>(sf_readf_short, mFile.get(), (short *)srcbuffers[slot].ptr(), block);
          //import 24 bit int as float and have the append function convert it.  This is how PCMAliasBlockFile works too.
          else
-            block = SFCall<sf_count_t>(sf_readf_float, mFile.get(), (float *)srcbuffer.ptr(), block);
+            block = SFCall<sf_count_t>(sf_readf_float, mFile.get(), (float *)srcbuffers[slot].ptr(), block);
 
          if(block < 0 || block > (long)maxBlock) {
             wxASSERT(false);
@@ -512,22 +535,26 @@ ProgressResult PCMImportFileHandle::Import(TrackFactory *trackFactory,
          }
 
          if (block) {
-            auto iter = channels.begin();
-            for(int c=0; c<mInfo.channels; ++iter, ++c) {
-               if (mFormat==int16Sample) {
-                  for(int j=0; j<block; j++)
-                     ((short *)buffer.ptr())[j] =
-                        ((short *)srcbuffer.ptr())[mInfo.channels*j+c];
-               }
-               else {
-                  for(int j=0; j<block; j++)
-                     ((float *)buffer.ptr())[j] =
-                        ((float *)srcbuffer.ptr())[mInfo.channels*j+c];
-               }
+            const samplePtr src = srcbuffers[slot].ptr();
+            tickets[slot] = appendQueue.Post([this, &channels, &buffer, src, block]{
+               auto iter = channels.begin();
+               for(int c=0; c<mInfo.channels; ++iter, ++c) {
+                  if (mFormat==int16Sample) {
+                     for(int j=0; j<block; j++)
+                        ((short *)buffer.ptr())[j] =
+                           ((short *)src)[mInfo.channels*j+c];
+                  }
+                  else {
+                     for(int j=0; j<block; j++)
+                        ((float *)buffer.ptr())[j] =
+                           ((float *)src)[mInfo.channels*j+c];
+                  }
 
-               iter->get()->Append(buffer.ptr(), (mFormat == int16Sample)?int16Sample:floatSample, block);
-            }
+                  iter->get()->Append(buffer.ptr(), (mFormat == int16Sample)?int16Sample:floatSample, block);
+               }
+            });
             framescompleted += block;
+            slot = 1 - slot;
          }
 
          updateResult = mProgress->Update(
@@ -538,6 +565,10 @@ ProgressResult PCMImportFileHandle::Import(TrackFactory *trackFactory,
             break;
 
       } while (block > 0);
+
+      // Let pending appends finish, and surface any error of theirs,
+      // before the buffers they use go out of scope.
+      appendQueue.Finish();
    }
 
    if (updateResult == ProgressResult::Failed || updateResult == ProgressResult::Cancelled) {
@@ -64,6 +64,38 @@ void MultiFormatReader::Reset()
    }
 }
 
+uint64_t MultiFormatReader::GetFileSize()
+{
+   uint64_t size = 0;
+
+   if (mpFid != NULL)
+   {
+      long pos = ftell(mpFid);
+
+      if (fseek(mpFid, 0, SEEK_END) == 0)
+      {
+         long end = ftell(mpFid);
+
+         if (end > 0)
+         {
+            size = (uint64_t) end;
+         }
+      }
+
+      fseek(mpFid, pos, SEEK_SET);
+   }
+
+   return size;
+}
+
+void MultiFormatReader::SeekTo(uint64_t offset)
+{
+   if (mpFid != NULL)
+   {
+      fseek(mpFid, (long) offset, SEEK_SET);
+   }
+}
+
 size_t MultiFormatReader::ReadSamples(void* buffer, size_t len,
                     MultiFormatReader::FormatT format,
                     MachineEndianness::EndiannessT end)
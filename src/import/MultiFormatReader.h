@@ -69,6 +69,8 @@ public:
    ~MultiFormatReader();
 
    void Reset();
+   uint64_t GetFileSize();
+   void SeekTo(uint64_t offset);
    size_t ReadSamples(void* buffer, size_t len,
                     MultiFormatReader::FormatT format,
                     MachineEndianness::EndiannessT end);
@@ -357,6 +357,11 @@ static int GuessFloatFormats(unsigned numTests, const ArrayOf<char> rawData[], s
                if (i == len1)
                   // all data is finite.
                   finiteVotes++;
+               else if (test + 1 - finiteVotes >= 2)
+                  // Two probes contained non-finite values already, so
+                  // this candidate can no longer pass the finite test
+                  // below.  Give up on it early.
+                  break;
 
                min = data1[0];
                max = data1[0];
@@ -1004,7 +1009,9 @@ int RawAudioGuess(const wxString &in_fname,
 {
    const unsigned numTests = 11;
    size_t headerSkipSize = 64;
-   size_t dataSize = 16384;
+   // A few KB per probe are enough for the statistics; keeping the probes
+   // small makes guessing fast even when the file is on a network share.
+   size_t dataSize = 4096;
    int format = SF_FORMAT_RAW;
    FILE *inf;
    size_t fileLen;
@@ -26,6 +26,11 @@
 #include "../tracks/labeltrack/ui/LabelTrackView.h"
 #include "../widgets/AudacityMessageBox.h"
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <thread>
+
 // private helper classes and functions
 namespace {
 void FinishCopy
@@ -36,6 +41,62 @@ void FinishCopy
       list.Add( dest );
 }
 
+// Apply the given copying function to every source track on concurrent
+// workers, and return the results in the sources' order.  Each call
+// builds an independent destination track, and DirManager serializes
+// block file creation internally, so this is safe; the per-track costs
+// -- boundary block reads, summary computation, clip and sequence
+// rebuilding -- then overlap instead of queuing behind one another.
+// Rethrows the first failure, but only after every worker has stopped,
+// so no partial result escapes.
+std::vector<Track::Holder> CopyTracks( const std::vector<Track*> &sources,
+   const std::function< Track::Holder(Track*) > &copyOne )
+{
+   std::vector<Track::Holder> copies( sources.size() );
+
+   const unsigned nWorkers = std::min<unsigned>(
+      (unsigned)sources.size(), std::thread::hardware_concurrency() );
+   if (nWorkers <= 1) {
+      for (size_t ii = 0; ii < sources.size(); ii++)
+         copies[ii] = copyOne( sources[ii] );
+      return copies;
+   }
+
+   // Workers steal the next uncopied track, as in
+   // Effect::ProcessPassParallel
+   std::atomic<size_t> nextSource{ 0 };
+   std::atomic<bool> cancel{ false };
+   std::vector<std::exception_ptr> exceptions( nWorkers );
+
+   auto work = [&](unsigned ii) {
+      try {
+         for (;;) {
+            auto index = nextSource++;
+            if (index >= sources.size() || cancel.load())
+               break;
+            copies[index] = copyOne( sources[index] );
+         }
+      }
+      catch (...) {
+         exceptions[ii] = std::current_exception();
+         cancel.store(true);
+      }
+   };
+
+   std::vector<std::thread> workers;
+   workers.reserve(nWorkers);
+   for (unsigned ii = 0; ii < nWorkers; ii++)
+      workers.emplace_back(work, ii);
+   for (auto &worker : workers)
+      worker.join();
+
+   for (auto &pException : exceptions)
+      if (pException)
+         std::rethrow_exception(pException);
+
+   return copies;
+}
+
 // Handle text paste (into active label), if any. Return true if did paste.
 // (This was formerly the first part of overly-long OnPaste.)
 bool DoPasteText(AudacityProject &project)
@@ -253,21 +314,31 @@ void OnCut(const CommandContext &context)
    auto pNewClipboard = TrackList::Create();
    auto &newClipboard = *pNewClipboard;
 
-   tracks.Selected().Visit(
+   // Collect the selected tracks, then capture them on concurrent
+   // workers; wide selections across many tracks divide the work among
+   // cores
+   std::vector<Track*> sources;
+   for (auto n : tracks.Selected())
+      sources.push_back(n);
+   auto copies = CopyTracks( sources,
+      [&](Track *n) {
+         return n->TypeSwitch< Track::Holder >(
 #if defined(USE_MIDI)
-      [&](NoteTrack *n) {
-         // Since portsmf has a built-in cut operator, we use that instead
-         auto dest = n->Cut(selectedRegion.t0(),
-                selectedRegion.t1());
-         FinishCopy(n, dest, newClipboard);
-      },
+            [&](NoteTrack *nt) {
+               // Since portsmf has a built-in cut operator, we use that
+               // instead
+               return nt->Cut(selectedRegion.t0(),
+                      selectedRegion.t1());
+            },
 #endif
-      [&](Track *n) {
-         auto dest = n->Copy(selectedRegion.t0(),
-                 selectedRegion.t1());
-         FinishCopy(n, dest, newClipboard);
-      }
-   );
+            [&](Track *t) {
+               return t->Copy(selectedRegion.t0(),
+                       selectedRegion.t1());
+            }
+         );
+      } );
+   for (size_t ii = 0; ii < sources.size(); ii++)
+      FinishCopy(sources[ii], copies[ii], newClipboard);
 
    // Survived possibility of exceptions.  Commit changes to the clipboard now.
    clipboard.Assign(
@@ -357,11 +428,17 @@ void OnCopy(const CommandContext &context)
    auto pNewClipboard = TrackList::Create();
    auto &newClipboard = *pNewClipboard;
 
-   for (auto n : tracks.Selected()) {
-      auto dest = n->Copy(selectedRegion.t0(),
-              selectedRegion.t1());
-      FinishCopy(n, dest, newClipboard);
-   }
+   // Collect the selected tracks, then copy them on concurrent workers
+   std::vector<Track*> sources;
+   for (auto n : tracks.Selected())
+      sources.push_back(n);
+   auto copies = CopyTracks( sources,
+      [&](Track *n) {
+         return n->Copy(selectedRegion.t0(),
+                 selectedRegion.t1());
+      } );
+   for (size_t ii = 0; ii < sources.size(); ii++)
+      FinishCopy(sources[ii], copies[ii], newClipboard);
 
    // Survived possibility of exceptions.  Commit changes to the clipboard now.
    clipboard.Assign( std::move( newClipboard ),
@@ -20,6 +20,7 @@
 #include "../WaveTrack.h"
 #include "../commands/CommandContext.h"
 #include "../commands/CommandManager.h"
+#include "../effects/TrackIOQueue.h"
 #include "../export/ExportMultiple.h"
 #include "../import/ImportMIDI.h"
 #include "../widgets/AudacityMessageBox.h"
@@ -31,10 +32,26 @@
 
 #include "../ondemand/ODManager.h"
 
+#include <wx/ffile.h>
 #include <wx/menu.h>
 
 // private helper classes and functions
 namespace {
+
+// Imports must stay on the GUI thread, but while one file is decoded a
+// worker can pull the next one off the disk, so that cold or remote files
+// are in the system cache when their turn comes.
+void PrefetchFile(TrackIOQueue &queue, const wxString &fileName)
+{
+   queue.Post([fileName]{
+      wxFFile file(fileName, wxT("rb"));
+      if (!file.IsOpened())
+         return;
+      char buffer[65536];
+      while (!file.Eof() && file.Read(buffer, sizeof(buffer)) > 0)
+         ;
+   });
+}
 void DoExport
 (AudacityProject &project, const wxString & Format )
 {
@@ -399,11 +416,18 @@ void OnImport(const CommandContext &context)
       window.HandleResize(); // Adjust scrollers for NEW track sizes.
    } );
 
+   TrackIOQueue prefetchQueue;
+   if (selectedFiles.size() > 1)
+      PrefetchFile(prefetchQueue, selectedFiles[1]);
+
    for (size_t ff = 0; ff < selectedFiles.size(); ff++) {
       wxString fileName = selectedFiles[ff];
 
       FileNames::UpdateDefaultPath(FileNames::Operation::Open, fileName);
 
+      if (ff + 2 < selectedFiles.size())
+         PrefetchFile(prefetchQueue, selectedFiles[ff + 2]);
+
       ProjectFileManager::Get( project ).Import(fileName);
    }
 
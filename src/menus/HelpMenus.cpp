@@ -12,6 +12,7 @@
 #include "../CommonCommandFlags.h"
 #include "../CrashReport.h"
 #include "../Dependencies.h"
+#include "../Diags.h"
 #include "../FileNames.h"
 #include "../HelpText.h"
 #include "../Prefs.h"
@@ -336,6 +337,19 @@ void OnShowLog( const CommandContext &context )
    }
 }
 
+void OnPerformanceMonitor(const CommandContext &context)
+{
+   auto &project = context.project;
+   Diags::ShowHUD( &GetProjectFrame( project ) );
+}
+
+void OnPerformanceData(const CommandContext &context)
+{
+   auto &project = context.project;
+   ShowDiagnostics( project, Diags::Dump(),
+      _("Performance Data"), wxT("perfdata.txt") );
+}
+
 #if defined(EXPERIMENTAL_CRASH_REPORT)
 void OnCrashReport(const CommandContext &WXUNUSED(context) )
 {
@@ -450,6 +464,12 @@ MenuTable::BaseItemPtr HelpMenu( AudacityProject & )
    #endif
          Command( wxT("Log"), XXO("Show &Log..."), FN(OnShowLog),
             AlwaysEnabledFlag ),
+         Command( wxT("PerformanceMonitor"), XXO("&Performance Monitor..."),
+            FN(OnPerformanceMonitor),
+            AlwaysEnabledFlag ),
+         Command( wxT("PerformanceData"), XXO("Performance Da&ta..."),
+            FN(OnPerformanceData),
+            AlwaysEnabledFlag ),
    #if defined(EXPERIMENTAL_CRASH_REPORT)
          Command( wxT("CrashReport"), XXO("&Generate Support Data..."),
             FN(OnCrashReport), AlwaysEnabledFlag ),
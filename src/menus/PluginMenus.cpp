@@ -960,6 +960,12 @@ MenuTable::BaseItemPtr ExtraScriptablesIIMenu( AudacityProject & )
          AudioIONotBusyFlag ),
       Command( wxT("GetInfo"), XXO("Get Info..."), FN(OnAudacityCommand),
          AudioIONotBusyFlag ),
+      Command( wxT("GetTelemetry"), XXO("Get Telemetry..."),
+         FN(OnAudacityCommand),
+         AudioIONotBusyFlag ),
+      Command( wxT("GetMemoryUsage"), XXO("Get Memory Usage..."),
+         FN(OnAudacityCommand),
+         AudioIONotBusyFlag ),
       Command( wxT("Message"), XXO("Message..."), FN(OnAudacityCommand),
          AudioIONotBusyFlag ),
       Command( wxT("Help"), XXO("Help..."), FN(OnAudacityCommand),
@@ -981,6 +987,12 @@ MenuTable::BaseItemPtr ExtraScriptablesIIMenu( AudacityProject & )
          AudioIONotBusyFlag ),
       // i18n-hint: Screenshot in the help menu has a much bigger dialog.
       Command( wxT("Screenshot"), XXO("Screenshot (short format)..."),
+         FN(OnAudacityCommand),
+         AudioIONotBusyFlag ),
+      Command( wxT("BenchmarkSuite"), XXO("Benchmark Suite..."),
+         FN(OnAudacityCommand),
+         AudioIONotBusyFlag ),
+      Command( wxT("RenderBenchmark"), XXO("Render Benchmark..."),
          FN(OnAudacityCommand),
          AudioIONotBusyFlag )
    );
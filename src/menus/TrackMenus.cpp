@@ -680,6 +680,44 @@ void OnMixAndRenderToNewTrack(const CommandContext &context)
    DoMixAndRender(project, true);
 }
 
+void OnFreezeTracks(const CommandContext &context)
+{
+   auto &project = context.project;
+   const auto &settings = ProjectSettings::Get( project );
+   auto &tracks = TrackList::Get( project );
+   auto &trackFactory = TrackFactory::Get( project );
+   auto rate = settings.GetRate();
+   auto defaultFormat = settings.GetDefaultFormat();
+
+   for (auto leader : tracks.SelectedLeaders< WaveTrack >()) {
+      WaveTrack::Holder uLeft, uRight;
+      ::MixAndRenderTrackGroup(
+         leader, &trackFactory, rate, defaultFormat, uLeft, uRight);
+      if (!uLeft)
+         // Cancelled, or the group was empty
+         continue;
+
+      // Keep the render in its own list, so that a stereo pair remains a
+      // recognizable channel group when playback substitutes it
+      auto render = TrackList::Create();
+      auto pLeft = render->Add( uLeft );
+      decltype(pLeft) pRight{};
+      if (uRight)
+         pRight = render->Add( uRight );
+      render->GroupChannels(*pLeft, pRight ? 2 : 1);
+
+      leader->SetFrozenRender( render );
+   }
+}
+
+void OnUnfreezeTracks(const CommandContext &context)
+{
+   auto &project = context.project;
+   auto &tracks = TrackList::Get( project );
+   for (auto leader : tracks.SelectedLeaders< WaveTrack >())
+      leader->ClearFrozenRender();
+}
+
 void OnResample(const CommandContext &context)
 {
    auto &project = context.project;
@@ -1297,6 +1335,17 @@ MenuTable::BaseItemPtr TracksMenu( AudacityProject & )
 
       Separator(),
 
+      // Render the selected tracks into cached copies that playback uses
+      // instead of mixing the live clips and envelopes
+      Command( wxT("FreezeTracks"), XXO("&Freeze Tracks"),
+         FN(OnFreezeTracks),
+         AudioIONotBusyFlag | WaveTracksSelectedFlag ),
+      Command( wxT("UnfreezeTracks"), XXO("Unfr&eeze Tracks"),
+         FN(OnUnfreezeTracks),
+         AudioIONotBusyFlag | WaveTracksSelectedFlag ),
+
+      Separator(),
+
       Command( wxT("RemoveTracks"), XXO("Remo&ve Tracks"), FN(OnRemoveTracks),
          AudioIONotBusyFlag | AnyTracksSelectedFlag ),
 
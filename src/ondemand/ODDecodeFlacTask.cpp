@@ -11,6 +11,7 @@
 #include "ODDecodeFlacTask.h"
 
 #include "../Prefs.h"
+#include <algorithm>
 #include <wx/string.h>
 #include <wx/utils.h>
 #include <wx/file.h>
@@ -29,6 +30,10 @@ extern "C" {
 
 #define DESC _("FLAC files")
 
+//decode and discard at most this much to reach a target from a known frame
+//boundary; beyond that a real seek is cheaper (about 6 seconds at 44.1kHz).
+static const long long kMaxSeekDiscardSamples = 262144;
+
 ODDecodeFlacTask::~ODDecodeFlacTask()
 {
 }
@@ -74,10 +79,21 @@ void ODFLACFile::metadata_callback(const FLAC__StreamMetadata *metadata)
          }
          mDecoder->mStreamInfoDone=true;
       break;
+      case FLAC__METADATA_TYPE_SEEKTABLE:
+         //remember the stream's own seek points; Decode() restarts from the
+         //nearest one instead of having libflac bisect the whole file.
+         for (unsigned i = 0; i < metadata->data.seek_table.num_points; i++) {
+            const auto &point = metadata->data.seek_table.points[i];
+            if (point.sample_number !=
+                FLAC__STREAM_METADATA_SEEKPOINT_PLACEHOLDER)
+               mDecoder->InsertSeekPoint(point.sample_number,
+                                         point.stream_offset);
+         }
+      break;
+
       // handle the other types we do nothing with to avoid a warning
       case FLAC__METADATA_TYPE_PADDING:	// do nothing with padding
       case FLAC__METADATA_TYPE_APPLICATION:	// no idea what to do with this
-      case FLAC__METADATA_TYPE_SEEKTABLE:	// don't need a seektable here
       case FLAC__METADATA_TYPE_CUESHEET:	// convert this to labels?
       case FLAC__METADATA_TYPE_PICTURE:		// ignore pictures
       case FLAC__METADATA_TYPE_UNDEFINED:	// do nothing with this either
@@ -116,13 +132,41 @@ void ODFLACFile::error_callback(FLAC__StreamDecoderErrorStatus status)
 FLAC__StreamDecoderWriteStatus ODFLACFile::write_callback(const FLAC__Frame *frame,
                        const FLAC__int32 * const buffer[])
 {
+   //Where in the stream this frame starts.  The frame headers carry their
+   //own numbers, so this stays right even just after a reposition.
+   long long frameStart;
+   if(frame->header.number_type == FLAC__FRAME_NUMBER_TYPE_SAMPLE_NUMBER)
+      frameStart = (long long) frame->header.number.sample_number;
+   else
+      frameStart = (long long) frame->header.number.frame_number *
+         frame->header.blocksize;
+   mDecoder->mStreamSamplePos = frameStart + frame->header.blocksize;
+
+   //the next sample the decode buffer is waiting for.
+   long long want = mDecoder->mDecodeStartSample.as_long_long() +
+      mDecoder->mDecodeBufferWritePosition;
+
+   if(frameStart + frame->header.blocksize <= want)
+      //the whole frame lies before the requested range.  This happens while
+      //decoding up from a seek point; the samples are just discarded.
+      return FLAC__STREAM_DECODER_WRITE_STATUS_CONTINUE;
+
+   if(frameStart > want)
+   {
+      //a hole (lost sync); the buffer was zeroed beforehand, so skip ahead.
+      mDecoder->mDecodeBufferWritePosition = (unsigned int) std::min(
+         (long long) mDecoder->mDecodeBufferLen,
+         frameStart - mDecoder->mDecodeStartSample.as_long_long());
+      want = frameStart;
+   }
 
-   unsigned int bytesToCopy = frame->header.blocksize;
+   const unsigned int skip = (unsigned int) (want - frameStart);
+   unsigned int bytesToCopy = frame->header.blocksize - skip;
    if(bytesToCopy>mDecoder->mDecodeBufferLen-mDecoder->mDecodeBufferWritePosition)
       bytesToCopy=mDecoder->mDecodeBufferLen-mDecoder->mDecodeBufferWritePosition;
 
    //the decodeBuffer was allocated to be the same format as the flac buffer, so we can do a straight up memcpy.
-   memcpy(mDecoder->mDecodeBuffer+SAMPLE_SIZE(mDecoder->mFormat)*mDecoder->mDecodeBufferWritePosition,buffer[mDecoder->mTargetChannel],SAMPLE_SIZE(mDecoder->mFormat) * bytesToCopy);
+   memcpy(mDecoder->mDecodeBuffer+SAMPLE_SIZE(mDecoder->mFormat)*mDecoder->mDecodeBufferWritePosition,(const char*)buffer[mDecoder->mTargetChannel]+SAMPLE_SIZE(mDecoder->mFormat)*skip,SAMPLE_SIZE(mDecoder->mFormat) * bytesToCopy);
 
    mDecoder->mDecodeBufferWritePosition+=bytesToCopy;
 /*
@@ -177,45 +221,96 @@ int ODFlacDecoder::Decode(SampleBuffer & data, sampleFormat & format, sampleCoun
    //we need to lock this so the target stays fixed over the seek/write callback.
    mFlacFileLock.Lock();
 
-   bool usingCache=mLastDecodeStartSample==start;
-   if(usingCache)
-   {
-      //we've just decoded this, so lets use a cache.  (often so for
-   }
-
-
    mDecodeBufferWritePosition=0;
    mDecodeBufferLen = len;
 
    data.Allocate(len, mFormat);
+   //zero it first, so frames lost to damage or a truncated file read as silence.
+   ClearSamples(data.ptr(), mFormat, 0, len);
    mDecodeBuffer = data.ptr();
    format = mFormat;
 
    mTargetChannel=channel;
+   mDecodeStartSample=start;
 
    // Third party library has its own type alias, check it
    static_assert(sizeof(sampleCount::type) <=
                  sizeof(FLAC__int64),
                  "Type FLAC__int64 is too narrow to hold a sampleCount");
-   if(!mFile->seek_absolute(static_cast<FLAC__int64>( start.as_long_long() )))
+
+   //Get the stream to the start sample.  In order of preference: continue
+   //sequentially from where the last decode left off, restart from a known
+   //frame boundary (a SEEKTABLE entry, or one remembered from an earlier
+   //decode), or let libflac seek, which without a SEEKTABLE bisects the
+   //whole file with many scattered reads.
+   const long long target = start.as_long_long();
+   bool positioned = mStreamSamplePos == target;
+
+   if(!positioned && mFp)
+   {
+      //nearest known frame boundary at or before the target
+      auto iter = std::upper_bound(mSeekPoints.begin(), mSeekPoints.end(),
+         (FLAC__uint64)target,
+         [](FLAC__uint64 sample, const FlacSeekPoint &point)
+            { return sample < point.sample; });
+      if(iter != mSeekPoints.begin())
+      {
+         --iter;
+         //only worth it if the stretch to decode and discard is modest
+         if(target - (long long)iter->sample <= kMaxSeekDiscardSamples &&
+            mFile->flush() &&
+            wxFseek(mFp, mFirstFrameOffset + iter->offset, SEEK_SET) == 0)
+         {
+            mStreamSamplePos = (long long)iter->sample;
+            positioned = true;
+         }
+      }
+   }
+
+   if(!positioned)
    {
-      mFlacFileLock.Unlock();
-      return -1;
+      if(!mFile->seek_absolute(static_cast<FLAC__int64>( target )))
+      {
+         mFlacFileLock.Unlock();
+         return -1;
+      }
+      //the write callback re-learns the position from the frame headers.
+      mStreamSamplePos = -1;
    }
 
    while(mDecodeBufferWritePosition<mDecodeBufferLen)
-      mFile->process_single();
-
-   mFlacFileLock.Unlock();
-   if(!usingCache)
    {
-      mLastDecodeStartSample=start;
+      //remember the frame boundary we are about to cross, making the file
+      //cheaply seekable here afterwards even without a SEEKTABLE.
+      FLAC__uint64 position;
+      if(mStreamSamplePos >= 0 && mFp &&
+         mFile->get_decode_position(&position) &&
+         position >= mFirstFrameOffset)
+         InsertSeekPoint((FLAC__uint64)mStreamSamplePos,
+                         position - mFirstFrameOffset);
+
+      if(!mFile->process_single() ||
+         mFile->get_state() == FLAC__STREAM_DECODER_END_OF_STREAM)
+         break;
    }
+
+   mFlacFileLock.Unlock();
+   mLastDecodeStartSample=start;
    //insert into blockfile and
    //calculate summary happen in ODDecodeBlockFile::WriteODDecodeBlockFile, where this method is also called.
    return 1;
 }
 
+void ODFlacDecoder::InsertSeekPoint(FLAC__uint64 sample, FLAC__uint64 offset)
+{
+   auto iter = std::lower_bound(mSeekPoints.begin(), mSeekPoints.end(), sample,
+      [](const FlacSeekPoint &point, FLAC__uint64 s)
+         { return point.sample < s; });
+   if(iter != mSeekPoints.end() && iter->sample == sample)
+      return;
+   mSeekPoints.insert(iter, FlacSeekPoint{ sample, offset });
+}
+
 ///Read header.  Subclasses must override.  Probably should save the info somewhere.
 ///Ideally called once per decoding of a file.  This complicates the task because
 ///returns true if the file exists and the header was read alright.
@@ -240,7 +335,8 @@ bool ODFlacDecoder::ReadHeader()
    //
    // Responsibility for closing the file is passed to libflac.
    // (it happens when mFile->finish() is called)
-   bool result = mFile->init(mHandle.fp())?true:false;
+   FILE *fp = mHandle.fp();
+   bool result = mFile->init(fp)?true:false;
    mHandle.Detach();
 
    if (result != FLAC__STREAM_DECODER_INIT_STATUS_OK) {
@@ -259,6 +355,13 @@ bool ODFlacDecoder::ReadHeader()
       return false;
    }
 
+   //the stream now sits at the first frame; SEEKTABLE offsets, and the
+   //frame boundaries we remember while decoding, are relative to here.
+   //If the position can't be told, leave mFp NULL and Decode() falls back
+   //to libflac's own seeking throughout.
+   if (mFile->get_decode_position(&mFirstFrameOffset))
+      mFp = fp;
+
    MarkInitialized();
    return true;
 
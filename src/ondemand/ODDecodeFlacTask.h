@@ -71,6 +71,7 @@ class ODFLACFile final : public FLAC::Decoder::File
       set_metadata_ignore_all();
       set_metadata_respond(FLAC__METADATA_TYPE_VORBIS_COMMENT);
       set_metadata_respond(FLAC__METADATA_TYPE_STREAMINFO);
+      set_metadata_respond(FLAC__METADATA_TYPE_SEEKTABLE);
    }
 
    bool get_was_error() const
@@ -120,10 +121,32 @@ public:
 
 private:
    friend class FLACImportFileHandle;
+
+   ///A frame boundary the stream can be restarted from.  Byte offsets are
+   ///relative to the first frame, as in a SEEKTABLE.
+   struct FlacSeekPoint
+   {
+      FLAC__uint64 sample;
+      FLAC__uint64 offset;
+   };
+
+   ///Adds a seek point, keeping the list sorted and without duplicates.
+   void InsertSeekPoint(FLAC__uint64 sample, FLAC__uint64 offset);
+
    sampleFormat          mFormat;
    std::unique_ptr<ODFLACFile> mFile;
    ODLock         mFlacFileLock;//for mFile;
    wxFFile               mHandle;
+   FILE                 *mFp{};//borrowed from mHandle, for repositioning; NULL if we can't
+   ///Seek points from the stream's SEEKTABLE, extended with every frame
+   ///boundary crossed while decoding, so random access gets cheaper as
+   ///more of the file has been visited.
+   std::vector<FlacSeekPoint> mSeekPoints;
+   FLAC__uint64          mFirstFrameOffset{};
+   ///First sample of the next frame the stream will deliver, or -1 if
+   ///unknown (it is re-learned from the frame headers).
+   long long             mStreamSamplePos{ -1 };
+   sampleCount           mDecodeStartSample;//start of the block being decoded
    unsigned long         mSampleRate;
    unsigned long         mNumChannels;
    unsigned long         mBitsPerSample;
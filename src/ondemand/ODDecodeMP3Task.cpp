@@ -0,0 +1,272 @@
+/*
+ *  ODDecodeMP3Task.cpp
+ *  Audacity
+ *
+ *  Decodes mp3 files on demand, using a frame seek index built when the
+ *  file is imported.  Modelled on ODDecodeFlacTask.
+ *
+ */
+
+#include "../Audacity.h" // for USE_* macros
+#include "ODDecodeMP3Task.h"
+
+#ifdef USE_LIBMAD
+
+#include <cstring>
+
+// PRL:  include these last,
+// and correct some preprocessor namespace pollution from wxWidgets that
+// caused a warning about duplicate definition
+#undef SIZEOF_LONG
+extern "C" {
+#include "mad.h"
+
+#ifdef USE_LIBID3TAG
+#include <id3tag.h>
+#endif
+}
+
+namespace {
+
+///Size of the chunks the scanner and decoder feed libmad.
+const size_t inputBufferSize = 65536;
+
+///How many frames to decode and discard before the requested sample, so the
+///layer III bit reservoir is primed when we reach the samples we keep.
+const size_t primingFrames = 2;
+
+/* convert libmad's fixed point representation to a float, as in ImportMP3 */
+inline float scale(mad_fixed_t sample)
+{
+   return (float) (sample / (float) (1L << MAD_F_FRACBITS));
+}
+
+} // namespace
+
+ODDecodeMP3Task::~ODDecodeMP3Task()
+{
+}
+
+std::unique_ptr<ODTask> ODDecodeMP3Task::Clone() const
+{
+   auto clone = std::make_unique<ODDecodeMP3Task>();
+   clone->mDemandSample = GetDemandSample();
+
+   //the decoders and blockfiles should not be copied.  They are created as the task runs.
+   // This std::move is needed to "upcast" the pointer type
+   return std::move(clone);
+}
+
+ODFileDecoder* ODDecodeMP3Task::CreateFileDecoder(const wxString & fileName)
+{
+   mDecoders.push_back(std::make_unique<ODMP3Decoder>(fileName));
+   return mDecoders.back().get();
+}
+
+ODMP3Decoder::~ODMP3Decoder()
+{
+}
+
+///Scans the file with mad_header_decode, which parses frame headers without
+///doing any subband synthesis, and records where every frame begins and which
+///sample it starts at.  This makes any sample reachable afterwards by seeking
+///to its frame, exactly, where a Xing or VBRI header would only estimate.
+bool ODMP3Decoder::ReadHeader()
+{
+   if (!mFile.Open(mFName))
+      return false;
+
+#ifdef USE_LIBID3TAG
+   // Skip over any leading ID3 tag, as the import callbacks do.
+   {
+      ArrayOf<unsigned char> query{ (size_t)ID3_TAG_QUERYSIZE };
+      long tagLen = 0;
+      if (mFile.Read(query.get(), ID3_TAG_QUERYSIZE) == ID3_TAG_QUERYSIZE)
+         tagLen = id3_tag_query(query.get(), ID3_TAG_QUERYSIZE);
+      if (tagLen > 0)
+         mFile.Seek(tagLen, wxFromStart);
+      else
+         mFile.Seek(0);
+   }
+#endif
+
+   mad_stream stream;
+   mad_header header;
+   mad_stream_init(&stream);
+   mad_header_init(&header);
+   auto cleanup = finally([&]{
+      mad_header_finish(&header);
+      mad_stream_finish(&stream);
+   });
+
+   ArrayOf<unsigned char> buffer{ inputBufferSize + MAD_BUFFER_GUARD };
+   size_t fill = 0;
+   wxFileOffset bufferOffset = mFile.Tell();//file offset of buffer[0]
+   bool eof = false;
+   long long total = 0;
+
+   // Refill the buffer, preserving the unconsumed bytes from
+   // stream.next_frame onward as libmad requires.  Returns false once the
+   // file and the final guard zeros have both been supplied.
+   auto Refill = [&]() -> bool {
+      size_t unconsumed = 0;
+      if (stream.buffer && stream.next_frame) {
+         unconsumed = buffer.get() + fill - stream.next_frame;
+         bufferOffset += fill - unconsumed;
+         if (unconsumed > 0)
+            memmove(buffer.get(), stream.next_frame, unconsumed);
+      }
+      else
+         bufferOffset += fill;
+
+      if (eof)
+         return false;
+
+      const auto nread =
+         mFile.Read(buffer.get() + unconsumed, inputBufferSize - unconsumed);
+      fill = unconsumed + (nread > 0 ? (size_t)nread : 0);
+      if (nread <= 0 || mFile.Eof()) {
+         /* supply the requisite MAD_BUFFER_GUARD zero bytes to ensure
+            the final frame gets decoded properly, then finish */
+         memset(buffer.get() + fill, 0, MAD_BUFFER_GUARD);
+         fill += MAD_BUFFER_GUARD;
+         eof = true;
+      }
+      mad_stream_buffer(&stream, buffer.get(), fill);
+      return true;
+   };
+
+   bool more = Refill();
+   while (more) {
+      if (mad_header_decode(&header, &stream) != 0) {
+         if (stream.error == MAD_ERROR_BUFLEN) {
+            more = Refill();
+            continue;
+         }
+         if (MAD_RECOVERABLE(stream.error))
+            continue;
+         break;
+      }
+
+      if (mIndex.empty()) {
+         mSampleRate = header.samplerate;
+         mNumChannels = MAD_NCHANNELS(&header);
+      }
+      mIndex.push_back(
+         { bufferOffset + (stream.this_frame - buffer.get()), total });
+      total += 32 * MAD_NSBSAMPLES(&header);
+   }
+
+   if (mIndex.empty() || mSampleRate == 0)
+      return false;
+
+   mTotalSamples = total;
+
+   MarkInitialized();
+   return true;
+}
+
+///Decodes the samples for this blockfile from the real file into a float buffer.
+int ODMP3Decoder::Decode(SampleBuffer & data, sampleFormat & format,
+                         sampleCount start, size_t len, unsigned int channel)
+{
+   format = floatSample;
+   data.Allocate(len, format);
+   // Zeros stand in for anything past the end or lost to a damaged frame,
+   // just as the importer would have appended silence there.
+   ClearSamples(data.ptr(), format, 0, len);
+
+   ODLocker locker{ &mFileLock };
+
+   // Find the frame containing the first wanted sample, then back up a
+   // couple of frames so the bit reservoir is primed before we get there.
+   const long long target = start.as_long_long();
+   size_t lo = 0, hi = mIndex.size();
+   while (lo + 1 < hi) {
+      const size_t mid = (lo + hi) / 2;
+      if (mIndex[mid].startSample <= target)
+         lo = mid;
+      else
+         hi = mid;
+   }
+   const size_t first = lo > primingFrames ? lo - primingFrames : 0;
+
+   if (mFile.Seek(mIndex[first].byteOffset, wxFromStart) == wxInvalidOffset)
+      return -1;
+
+   mad_stream stream;
+   mad_frame frame;
+   mad_synth synth;
+   mad_stream_init(&stream);
+   mad_frame_init(&frame);
+   mad_synth_init(&synth);
+   auto cleanup = finally([&]{
+      mad_synth_finish(&synth);
+      mad_frame_finish(&frame);
+      mad_stream_finish(&stream);
+   });
+
+   ArrayOf<unsigned char> buffer{ inputBufferSize + MAD_BUFFER_GUARD };
+   size_t fill = 0;
+   bool eof = false;
+
+   auto Refill = [&]() -> bool {
+      size_t unconsumed = 0;
+      if (stream.buffer && stream.next_frame) {
+         unconsumed = buffer.get() + fill - stream.next_frame;
+         if (unconsumed > 0)
+            memmove(buffer.get(), stream.next_frame, unconsumed);
+      }
+
+      if (eof)
+         return false;
+
+      const auto nread =
+         mFile.Read(buffer.get() + unconsumed, inputBufferSize - unconsumed);
+      fill = unconsumed + (nread > 0 ? (size_t)nread : 0);
+      if (nread <= 0 || mFile.Eof()) {
+         memset(buffer.get() + fill, 0, MAD_BUFFER_GUARD);
+         fill += MAD_BUFFER_GUARD;
+         eof = true;
+      }
+      mad_stream_buffer(&stream, buffer.get(), fill);
+      return true;
+   };
+
+   float *out = (float *)data.ptr();
+   long long pos = mIndex[first].startSample;
+   const long long end = target + (long long)len;
+
+   bool more = Refill();
+   while (more && pos < end) {
+      if (mad_frame_decode(&frame, &stream) != 0) {
+         if (stream.error == MAD_ERROR_BUFLEN) {
+            more = Refill();
+            continue;
+         }
+         if (MAD_RECOVERABLE(stream.error))
+            continue;
+         break;
+      }
+      mad_synth_frame(&synth, &frame);
+
+      const auto &pcm = synth.pcm;
+      // protect us from libmad glitching on the number of channels
+      const unsigned chn =
+         channel < pcm.channels ? channel : pcm.channels - 1;
+
+      // Copy whatever part of this frame overlaps the requested range;
+      // the priming frames fall entirely before it and are discarded.
+      long long from = target > pos ? target : pos;
+      const long long to =
+         end < pos + (long long)pcm.length ? end : pos + (long long)pcm.length;
+      for (; from < to; ++from)
+         out[from - target] = scale(pcm.samples[chn][from - pos]);
+
+      pos += pcm.length;
+   }
+
+   return 1;
+}
+
+#endif //USE_LIBMAD
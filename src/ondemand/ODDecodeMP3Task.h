@@ -0,0 +1,90 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  ODDecodeMP3Task.h
+
+  Audacity(R) is copyright (c) 1999-2019 Audacity Team.
+  License: GPL v2.  See License.txt.
+
+******************************************************************//**
+
+\class ODDecodeMP3Task
+\brief Decodes an mp3 file into ODDecodeBlockFiles, but not immediately.
+
+Modelled on ODDecodeFlacTask.  The mp3 format has no sample-accurate
+seeking of its own, so ODMP3Decoder builds a frame seek index in
+ReadHeader() with a fast header-only scan of the file, and Decode()
+uses it to land near any requested sample without decoding everything
+before it.
+
+*//*******************************************************************/
+
+#ifndef __AUDACITY_ODDecodeMP3Task__
+#define __AUDACITY_ODDecodeMP3Task__
+
+#include <vector>
+#include <wx/file.h> // data member
+#include "ODDecodeTask.h"
+
+class ODFileDecoder;
+
+/// A class representing a modular task to be used with the On-Demand structures.
+class ODDecodeMP3Task final : public ODDecodeTask
+{
+ public:
+
+   /// Constructs an ODTask
+   ODDecodeMP3Task(){}
+   virtual ~ODDecodeMP3Task();
+
+   std::unique_ptr<ODTask> Clone() const override;
+   ///Creates an ODFileDecoder that decodes a file of filetype the subclass handles.
+   ODFileDecoder* CreateFileDecoder(const wxString & fileName) override;
+
+   ///Lets other classes know that this class handles mp3
+   unsigned int GetODType() override { return eODMP3; }
+};
+
+#include "../blockfile/ODDecodeBlockFile.h" // to inherit
+
+///class to decode a particular file (one per file).  Saves info such as filename and length (after the header is read.)
+class ODMP3Decoder final : public ODFileDecoder
+{
+public:
+   ///This should handle unicode converted to UTF-8 on mac/linux, but OD TODO:check on windows
+   ODMP3Decoder(const wxString & fileName):ODFileDecoder(fileName)
+   {
+      mSampleRate = 0;
+      mNumChannels = 0;
+   }
+   virtual ~ODMP3Decoder();
+
+   ///Scans the whole file decoding only frame headers (no subband synthesis),
+   ///recording the byte offset and starting sample of every frame.  Much
+   ///faster than a real decode, and exact for CBR and VBR alike where a
+   ///Xing/VBRI header would only give estimates.
+   bool ReadHeader() override;
+
+   ///Decodes the samples for this blockfile from the real file into a float buffer.
+   ///Seeks to the indexed frame a couple of frames before the requested start
+   ///so the layer III bit reservoir is primed before the samples we keep.
+   int Decode(SampleBuffer & data, sampleFormat & format, sampleCount start, size_t len, unsigned int channel) override;
+
+   unsigned int GetSampleRate() const { return mSampleRate; }
+   unsigned int GetNumChannels() const { return mNumChannels; }
+   long long GetTotalSamples() const { return mTotalSamples; }
+
+private:
+   ///One entry per MPEG audio frame found by the header scan.
+   struct FrameEntry {
+      wxFileOffset byteOffset;  //!< file offset of the frame header
+      long long    startSample; //!< stream position of the frame's first sample
+   };
+   std::vector<FrameEntry> mIndex;
+   long long      mTotalSamples{ 0 };
+   wxFile         mFile;
+   ODLock         mFileLock;//Decode() seeks and reads mFile; one use at a time.
+};
+
+#endif
@@ -25,6 +25,7 @@ ODTask requests and internals.
 #include <wx/wx.h>
 #include <wx/thread.h>
 #include <wx/event.h>
+#include <thread>
 
 #ifdef __WXMAC__
 
@@ -319,7 +320,12 @@ bool ODManager::IsInstanceCreated()
 void ODManager::Init()
 {
    mCurrentThreads = 0;
-   mMaxThreads = 5;
+   // One task runs per thread, so size the pool to the machine; importing
+   // a folder of files then computes their summaries in parallel and total
+   // wall time scales with cores.
+   mMaxThreads = (int) std::thread::hardware_concurrency();
+   if (mMaxThreads <= 0)
+      mMaxThreads = 5;
 
    //   wxLogDebug(wxT("Initializing ODManager...Creating manager thread"));
    // This is a detached thread, so it deletes itself when it finishes
@@ -381,20 +387,49 @@ void ODManager::Start()
          mCurrentThreads++;
          mCurrentThreadsMutex.Unlock();
 
-         mTasksMutex.Lock();
-         //detach a NEW thread.
-         // This is a detached thread, so it deletes itself when it finishes
-         // ... except on Mac where we we don't use wxThread for reasons unexplained
-         auto thread = safenew ODTaskThread(mTasks[0]);//task);
-         //thread->SetPriority(10);//default is 50.
-         thread->Create();
-         thread->Run();
+         ODTask* task;
+         {
+            //Choose the task the user is most likely waiting on: prefer tasks
+            //associated with the foreground project, and among those, the most
+            //recently demanded (on-screen) tracks.
+            ODLocker projectsLocker{ &AllProjects::Mutex() };
+            AudacityProject* activeProject = GetActiveProject();
+
+            mTasksMutex.Lock();
+            size_t chosen = 0;
+            int bestScore = -1;
+            for(size_t i=0;i<mTasks.size();i++)
+            {
+               int score = mTasks[i]->GetDemandGeneration();
+               if(activeProject && mTasks[i]->IsTaskAssociatedWithProject(activeProject))
+                  score += 1<<30;
+               if(score > bestScore)
+               {
+                  bestScore = score;
+                  chosen = i;
+               }
+            }
+            task = mTasks.empty() ? NULL : mTasks[chosen];
+            if(task)
+               mTasks.erase(mTasks.begin()+chosen);
+            tasksInArray = mTasks.size()>0;
+            mTasksMutex.Unlock();
+         }
 
-         mTasks.erase(mTasks.begin());
-         tasksInArray = mTasks.size()>0;
-         mTasksMutex.Unlock();
+         if(task)
+         {
+            //detach a NEW thread.
+            // This is a detached thread, so it deletes itself when it finishes
+            // ... except on Mac where we we don't use wxThread for reasons unexplained
+            auto thread = safenew ODTaskThread(task);
+            //thread->SetPriority(10);//default is 50.
+            thread->Create();
+            thread->Run();
+         }
 
          mCurrentThreadsMutex.Lock();
+         if(!task)
+            mCurrentThreads--;
       }
 
       mCurrentThreadsMutex.Unlock();
@@ -632,6 +667,23 @@ void ODManager::FillTipForWaveTrack( const WaveTrack * t, wxString &tip )
    mQueuesMutex.Unlock();
 }
 
+///snapshots the stats of the queue holding the track, if any.
+bool ODManager::GetQueueStatsForWaveTrack( const WaveTrack * t, ODQueueStats &stats )
+{
+   bool found = false;
+   mQueuesMutex.Lock();
+   for(unsigned int i=0;i<mQueues.size();i++)
+   {
+      if(mQueues[i]->ContainsWaveTrack(t))
+      {
+         found = mQueues[i]->GetStats(stats);
+         break;
+      }
+   }
+   mQueuesMutex.Unlock();
+   return found;
+}
+
 ///Gets the total percent complete for all tasks combined.
 float ODManager::GetOverallPercentComplete()
 {
@@ -40,6 +40,7 @@ int CompareNoCaseFileName(const wxString& first, const wxString& second);
 class Track;
 class WaveTrack;
 class ODWaveTrackTaskQueue;
+struct ODQueueStats;
 class ODManager final
 {
  public:
@@ -102,6 +103,9 @@ class ODManager final
    ///fills in the status bar message for a given track
    void FillTipForWaveTrack( const WaveTrack * t, wxString &tip );
 
+   ///snapshots the stats of the queue holding the track, if any.
+   bool GetQueueStatsForWaveTrack( const WaveTrack * t, ODQueueStats &stats );
+
    ///Gets the total percent complete for all tasks combined.
    float GetOverallPercentComplete();
 
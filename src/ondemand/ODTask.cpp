@@ -20,6 +20,8 @@ in a background thread.
 
 #include "ODTask.h"
 
+#include <wx/time.h>
+
 #include "ODManager.h"
 #include "../WaveClip.h"
 #include "../WaveTrack.h"
@@ -34,6 +36,7 @@ wxDEFINE_EVENT(EVT_ODTASK_COMPLETE, wxCommandEvent);
 /// Constructs an ODTask
 ODTask::ODTask()
 : mDemandSample(0)
+, mDemandGeneration(0)
 {
 
    static int sTaskNumber=0;
@@ -43,6 +46,11 @@ ODTask::ODTask()
    mNeedsODUpdate=false;
    mIsRunning = false;
 
+   mUnitsCompleted=0;
+   mWorkMs=0;
+   //until the first unit finishes, the stall age is measured from here.
+   mLastUnitClockMs=(double)wxGetUTCTimeMillis().GetValue();
+
    mTaskNumber=sTaskNumber++;
 }
 
@@ -109,7 +117,17 @@ void ODTask::DoSome(float amountWork)
       wxThread::This()->Yield();
       //release within the loop so we can cut the number of iterations short
 
+      double unitStartMs = (double)wxGetUTCTimeMillis().GetValue();
       DoSomeInternal(); //keep the terminate mutex on so we don't remo
+      double unitEndMs = (double)wxGetUTCTimeMillis().GetValue();
+
+      //account the unit for the queue instrumentation.
+      mStatsMutex.Lock();
+      mUnitsCompleted=mUnitsCompleted+1;
+      mWorkMs=mWorkMs+(unitEndMs-unitStartMs);
+      mLastUnitClockMs=unitEndMs;
+      mStatsMutex.Unlock();
+
       mTerminateMutex.Unlock();
       //check to see if ondemand has been called
       if(GetNeedsODUpdate() && PercentComplete() < 1.0)
@@ -227,6 +245,15 @@ sampleCount ODTask::GetDemandSample() const
    return retval;
 }
 
+int ODTask::GetDemandGeneration() const
+{
+   int retval;
+   mDemandSampleMutex.Lock();
+   retval = mDemandGeneration;
+   mDemandSampleMutex.Unlock();
+   return retval;
+}
+
 void ODTask::SetDemandSample(sampleCount sample)
 {
 
@@ -245,6 +272,34 @@ float ODTask::PercentComplete()
    return ret;
 }
 
+///returns the number of work units (generally block files) completed so far.
+int ODTask::GetUnitsCompleted()
+{
+   mStatsMutex.Lock();
+   int ret = mUnitsCompleted;
+   mStatsMutex.Unlock();
+   return ret;
+}
+
+///returns completed work units per second of actual processing time.
+double ODTask::GetUnitsPerSecond()
+{
+   mStatsMutex.Lock();
+   double units = mUnitsCompleted;
+   double workMs = mWorkMs;
+   mStatsMutex.Unlock();
+   return workMs > 0 ? units / (workMs / 1000.0) : 0.0;
+}
+
+///returns seconds since a work unit last finished.
+double ODTask::SecondsSinceLastUnit()
+{
+   mStatsMutex.Lock();
+   double lastMs = mLastUnitClockMs;
+   mStatsMutex.Unlock();
+   return ((double)wxGetUTCTimeMillis().GetValue() - lastMs) / 1000.0;
+}
+
 ///return
 bool ODTask::IsComplete()
 {
@@ -317,6 +372,10 @@ void ODTask::RecalculatePercentComplete()
 ///@param seconds the point in the track from which the tasks associated with track should begin processing from.
 void ODTask::DemandTrackUpdate(WaveTrack* track, double seconds)
 {
+   //increases with every demand on any task, establishing recency order.
+   static int sDemandGeneration=0;
+   static ODLock sDemandGenerationMutex;
+
    bool demandSampleChanged=false;
    mWaveTrackMutex.Lock();
    for(size_t i=0;i<mWaveTracks.size();i++)
@@ -326,6 +385,15 @@ void ODTask::DemandTrackUpdate(WaveTrack* track, double seconds)
          auto newDemandSample = (sampleCount)(seconds * track->GetRate());
          demandSampleChanged = newDemandSample != GetDemandSample();
          SetDemandSample(newDemandSample);
+
+         //stamp this task as freshly demanded, whether or not the sample
+         //moved, so the scheduler favors what is on screen.
+         sDemandGenerationMutex.Lock();
+         int generation = ++sDemandGeneration;
+         sDemandGenerationMutex.Unlock();
+         mDemandSampleMutex.Lock();
+         mDemandGeneration = generation;
+         mDemandSampleMutex.Unlock();
          break;
       }
    }
@@ -107,12 +107,27 @@ class ODTask /* not final */
 
    virtual void SetDemandSample(sampleCount sample);
 
+   ///returns a stamp that increases with each user demand anywhere, so that
+   ///ODManager can run the most recently viewed tracks' tasks first.
+   int GetDemandGeneration() const;
+
    ///does an od update and then recalculates the data.
    virtual void RecalculatePercentComplete();
 
    ///returns the number of tasks created before this instance.
    int GetTaskNumber(){return mTaskNumber;}
 
+   ///returns the number of work units (generally block files) completed so far.
+   int GetUnitsCompleted();
+
+   ///returns completed work units per second of actual processing time,
+   ///or zero before any unit has finished.  Low values mean slow disk.
+   double GetUnitsPerSecond();
+
+   ///returns seconds since a work unit last finished (since construction if
+   ///none has).  Large values on an incomplete task mean starved scheduling.
+   double SecondsSinceLastUnit();
+
    void SetNeedsODUpdate();
    bool GetNeedsODUpdate();
    void ResetNeedsODUpdate();
@@ -161,11 +176,19 @@ class ODTask /* not final */
    ODLock     mWaveTrackMutex;
 
    sampleCount mDemandSample;
+   ///guarded by mDemandSampleMutex as well
+   volatile int mDemandGeneration;
    mutable ODLock      mDemandSampleMutex;
 
    volatile bool mIsRunning;
    ODLock mIsRunningMutex;
 
+   ///work-unit accounting for the queue instrumentation.
+   volatile int mUnitsCompleted;
+   volatile double mWorkMs;
+   volatile double mLastUnitClockMs;
+   ODLock mStatsMutex;
+
 
    private:
 
@@ -308,17 +308,44 @@ void ODWaveTrackTaskQueue::FillTipForWaveTrack( const WaveTrack * t, wxString &t
 {
    if(ContainsWaveTrack(t) && GetNumTasks())
    {
-
-    //  if(GetNumTasks()==1)
-      mTipMsg.Printf(_("%s %2.0f%% complete. Click to change task focal point."), GetFrontTask()->GetTip(), GetFrontTask()->PercentComplete()*100.0 );
-     // else
-       //  msg.Printf(_("%s %d additional tasks remaining."), GetFrontTask()->GetTip(), GetNumTasks());
+      ODTask* frontTask = GetFrontTask();
+
+      //a stalled task gets a different message than a slowly grinding one,
+      //so the operator can tell starved scheduling from slow disk.
+      if(!frontTask->IsRunning() && frontTask->SecondsSinceLastUnit() > 5.0)
+         mTipMsg.Printf(_("%s %2.0f%% complete, no progress for %.0f s. Click to change task focal point."),
+            frontTask->GetTip(), frontTask->PercentComplete()*100.0,
+            frontTask->SecondsSinceLastUnit() );
+      else
+         mTipMsg.Printf(_("%s %2.0f%% complete, %.0f blocks/s. Click to change task focal point."),
+            frontTask->GetTip(), frontTask->PercentComplete()*100.0,
+            frontTask->GetUnitsPerSecond() );
 
       tip = mTipMsg;
 
    }
 }
 
+///snapshots the queue's progress counters.  Returns false if no tasks.
+bool ODWaveTrackTaskQueue::GetStats(ODQueueStats &stats)
+{
+   mTasksMutex.Lock();
+   stats.numTasks = (int)mTasks.size();
+   if(mTasks.size())
+   {
+      ODTask* front = mTasks[0].get();
+      stats.frontRunning = front->IsRunning();
+      stats.frontPercentComplete = front->PercentComplete();
+      stats.unitsCompleted = front->GetUnitsCompleted();
+      stats.unitsPerSecond = front->GetUnitsPerSecond();
+      stats.secondsSinceWork = front->SecondsSinceLastUnit();
+      mTasksMutex.Unlock();
+      return true;
+   }
+   mTasksMutex.Unlock();
+   return false;
+}
+
 void ODWaveTrackTaskQueue::Compress()
 {
    mTracksMutex.Lock();
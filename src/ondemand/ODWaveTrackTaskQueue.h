@@ -27,6 +27,20 @@ tasks associated with a WaveTrack.
 class Track;
 class WaveTrack;
 class ODTask;
+
+///A snapshot of one queue's health, for the track tip and GetInfoCommand.
+///Throughput and stall age describe the front task, which is the one the
+///blank waveform is waiting on.
+struct ODQueueStats
+{
+   int numTasks {};
+   bool frontRunning {};
+   float frontPercentComplete {};
+   int unitsCompleted {};
+   double unitsPerSecond {};
+   double secondsSinceWork {};
+};
+
 /// A class representing a modular task to be used with the On-Demand structures.
 class ODWaveTrackTaskQueue final
 {
@@ -89,6 +103,9 @@ class ODWaveTrackTaskQueue final
    ///fills in the status bar message for a given track
    void FillTipForWaveTrack( const WaveTrack * t, wxString &tip );
 
+   ///snapshots the queue's progress counters.  Returns false if no tasks.
+   bool GetStats(ODQueueStats &stats);
+
  protected:
 
    // Remove expired weak pointers to tracks
@@ -33,23 +33,28 @@ other settings.
 #include <wx/intl.h>
 #include <wx/log.h>
 #include <wx/textctrl.h>
+#include <wx/utils.h>
 
 #include "portaudio.h"
 
+#include "../AudioIO.h"
 #include "../Prefs.h"
 #include "../ShuttleGui.h"
 #include "../DeviceManager.h"
+#include "../widgets/AudacityMessageBox.h"
 
 enum {
    HostID = 10000,
    PlayID,
    RecordID,
-   ChannelsID
+   ChannelsID,
+   MeasureLatencyID
 };
 
 BEGIN_EVENT_TABLE(DevicePrefs, PrefsPanel)
    EVT_CHOICE(HostID, DevicePrefs::OnHost)
    EVT_CHOICE(RecordID, DevicePrefs::OnDevice)
+   EVT_BUTTON(MeasureLatencyID, DevicePrefs::OnMeasureLatency)
 END_EVENT_TABLE()
 
 DevicePrefs::DevicePrefs(wxWindow * parent, wxWindowID winid)
@@ -196,7 +201,23 @@ void DevicePrefs::PopulateOrExchange(ShuttleGui & S)
                                  DEFAULT_LATENCY_CORRECTION,
                                  9);
          S.AddUnits(_("milliseconds"));
-         if( w ) w->SetName(w->GetName() + wxT(" ") + _("milliseconds"));
+         if( w ) {
+            w->SetName(w->GetName() + wxT(" ") + _("milliseconds"));
+            mLatencyCompensation = w;
+         }
+
+         S.AddFixedText( {} );
+         S.Id(MeasureLatencyID);
+         S.AddButton(_("&Measure..."));
+         S.AddFixedText( {} );
+
+         // When checked, each run grows or shrinks a per-device buffer
+         // length learned from dropouts, overriding the number above
+         S.TieCheckBox(_("Ad&just buffer length automatically"),
+                       wxT("/AudioIO/AdaptiveLatency"),
+                       false);
+         S.AddFixedText( {} );
+         S.AddFixedText( {} );
       }
       S.EndThreeColumn();
    }
@@ -383,6 +404,37 @@ void DevicePrefs::OnDevice(wxCommandEvent & WXUNUSED(event))
    Layout();
 }
 
+void DevicePrefs::OnMeasureLatency(wxCommandEvent & WXUNUSED(event))
+{
+   auto gAudioIO = AudioIO::Get();
+   if (gAudioIO->IsBusy()) {
+      AudacityMessageBox(
+         _("Latency cannot be measured while audio is playing or being recorded."),
+         _("Measure Latency"));
+      return;
+   }
+
+   // The measurement uses the devices and buffer length currently in the
+   // preferences, which an Apply has not yet updated from this dialog
+   double correction;
+   bool found;
+   {
+      wxBusyCursor busy;
+      found = gAudioIO->MeasureLatencyCorrection(correction);
+   }
+
+   if (!found) {
+      AudacityMessageBox(
+         _("The test sound was not detected on the recording device.\n\nConnect the output to the input with a loopback cable, or place the microphone close to the speaker, then try again."),
+         _("Measure Latency"));
+      return;
+   }
+
+   if (mLatencyCompensation)
+      mLatencyCompensation->SetValue(
+         wxString::Format(wxT("%.0f"), correction));
+}
+
 bool DevicePrefs::Commit()
 {
    ShuttleGui S(this, eIsSavingToPrefs);
@@ -17,6 +17,7 @@
 #include "PrefsPanel.h"
 
 class wxChoice;
+class wxTextCtrl;
 class ShuttleGui;
 class wxArrayStringEx;
 
@@ -40,6 +41,7 @@ class DevicePrefs final : public PrefsPanel
 
    void OnHost(wxCommandEvent & e);
    void OnDevice(wxCommandEvent & e);
+   void OnMeasureLatency(wxCommandEvent & e);
 
    wxArrayStringEx mHostNames;
    wxArrayStringEx mHostLabels;
@@ -53,6 +55,7 @@ class DevicePrefs final : public PrefsPanel
    wxChoice *mPlay;
    wxChoice *mRecord;
    wxChoice *mChannels;
+   wxTextCtrl *mLatencyCompensation;
 
    DECLARE_EVENT_TABLE()
 };
@@ -120,6 +120,29 @@ void DirectoriesPrefs::PopulateOrExchange(ShuttleGui & S)
    }
    S.EndStatic();
 
+   S.StartStatic(_("Disk blocks"));
+   {
+      S.StartTwoColumn();
+      {
+         S.TieNumericTextBox(_("Ma&ximum disk block size (MB), 0 for default:"),
+                             wxT("/Directories/MaxDiskBlockSizeMB"),
+                             0,
+                             9);
+      }
+      S.EndTwoColumn();
+
+      S.AddVariableText(_("Larger blocks mean far fewer files in the project folder, at some cost in memory.\nTakes effect when Audacity restarts."))->Wrap(600);
+
+#ifdef USE_LIBFLAC
+      S.TieCheckBox(_("Compress &new audio blocks (FLAC, lossless)"),
+                    wxT("/Directories/CompressBlockFiles"),
+                    false);
+
+      S.AddVariableText(_("Saves 2-3x disk space for voice projects, at some CPU cost while editing.\nApplies to 16-bit and 24-bit projects only."))->Wrap(600);
+#endif
+   }
+   S.EndStatic();
+
 #ifdef DEPRECATED_AUDIO_CACHE
    // See http://bugzilla.audacityteam.org/show_bug.cgi?id=545.
    S.StartStatic(_("Audio cache"));
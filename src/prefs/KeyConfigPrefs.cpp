@@ -88,10 +88,14 @@ KeyConfigPrefs::KeyConfigPrefs(wxWindow * parent, wxWindowID winid,
    mKey(NULL),
    mFilter(NULL),
    mFilterTimer(this, FilterTimerID),
-   mFilterPending(false)
+   mFilterPending(false),
+   mBindingsPending(false)
 {
    Populate();
    if (!name.empty()) {
+      // Opened directly onto a command; fill the view at once so that
+      // the command can be found and selected
+      PageSelected();
       auto index = mView->GetIndexByName(name);
       mView->SelectNode(index);
    }
@@ -138,6 +142,18 @@ void KeyConfigPrefs::Populate()
 
    mManager = &CommandManager::Get( *project );
 
+   // Filling the view with every binding accounts for most of the cost
+   // of opening the preferences dialog, so it waits for PageSelected.
+   mBindingsPending = true;
+}
+
+void KeyConfigPrefs::PageSelected()
+{
+   if (!mBindingsPending) {
+      return;
+   }
+   mBindingsPending = false;
+
    // For speed, don't sort here.  We're just creating.
    // Instead sort when we do SetView later in this function.
    RefreshBindings(false);
@@ -39,6 +39,7 @@ public:
    bool Commit() override;
    void Cancel() override;
    wxString HelpPageName() override;
+   void PageSelected() override;
    void PopulateOrExchange(ShuttleGui & S) override;
 
 private:
@@ -74,6 +75,9 @@ private:
    wxStaticText *mFilterLabel;
    wxTimer mFilterTimer;
    bool mFilterPending;
+   // True until the bindings view has been filled, which waits for the
+   // panel's first selection in the dialog
+   bool mBindingsPending;
 
    ViewByType mViewType;
    wxRadioButton *mViewByTree;
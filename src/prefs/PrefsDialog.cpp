@@ -410,6 +410,7 @@ BEGIN_EVENT_TABLE(PrefsDialog, wxDialogWrapper)
    EVT_BUTTON(wxID_PREVIEW, PrefsDialog::OnPreview)
    EVT_BUTTON(wxID_HELP, PrefsDialog::OnHelp)
    EVT_TREE_KEY_DOWN(wxID_ANY, PrefsDialog::OnTreeKeyDown) // Handles key events when tree has focus
+   EVT_TREEBOOK_PAGE_CHANGED(wxID_ANY, PrefsDialog::OnPageChanged)
 END_EVENT_TABLE()
 
 
@@ -695,6 +696,8 @@ int PrefsDialog::ShowModal()
       wxString Temp = mTitlePrefix + mUniquePage->GetLabel();
       SetTitle(Temp);
       SetName(Temp);
+      // No page-changed event will arrive for the one and only page
+      mUniquePage->PageSelected();
    }
 
    return wxDialogWrapper::ShowModal();
@@ -762,6 +765,18 @@ void PrefsDialog::ShuttleAll( ShuttleGui & S)
    }
 }
 
+void PrefsDialog::OnPageChanged(wxBookCtrlEvent & event)
+{
+   // Sent both for clicks in the category tree and for programmatic
+   // SetSelection; either way, let a lazily filled panel populate itself
+   // now that it is the one on view.
+   const int n = event.GetSelection();
+   if (mCategories && n != wxNOT_FOUND)
+      static_cast<PrefsPanel *>(mCategories->GetPage(n))->PageSelected();
+
+   event.Skip();
+}
+
 void PrefsDialog::OnTreeKeyDown(wxTreeEvent & event)
 {
    if(event.GetKeyCode() == WXK_RETURN)
@@ -16,6 +16,7 @@
 #include <vector>
 #include "../widgets/wxPanelWrapper.h" // to inherit
 
+class wxBookCtrlEvent;
 class wxTreebook;
 class wxTreeEvent;
 class PrefsPanel;
@@ -62,6 +63,7 @@ class PrefsDialog /* not final */ : public wxDialogWrapper
    void OnPreview(wxCommandEvent & e);
    void OnHelp(wxCommandEvent & e);
    void OnTreeKeyDown(wxTreeEvent & e); // Used to dismiss the dialog when enter is pressed with focus on tree
+   void OnPageChanged(wxBookCtrlEvent & e); // Gives the NEW page its chance to fill itself in
 
    void SelectPageByName(const wxString &pageName);
 
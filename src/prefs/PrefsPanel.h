@@ -65,6 +65,13 @@ class PrefsPanel /* not final */ : public wxPanelWrapper, ComponentInterface
    virtual void Preview() {} // Make tentative changes
    virtual bool Commit() = 0; // used to be called "Apply"
 
+   // Called whenever the panel becomes the one selected in the dialog.
+   // A panel that is costly to fill in (such as the keyboard bindings
+   // table, with its thousands of rows) may build only its frame at
+   // construction and do the rest on the first of these calls, so that
+   // opening the dialog on some other page stays fast.
+   virtual void PageSelected() {}
+
 
    virtual PluginPath GetPath();
    virtual VendorSymbol GetVendor();
@@ -152,6 +152,10 @@ bool LabelTrackView::mbGlyphsReady=false;
 
 wxFont LabelTrackView::msFont;
 
+// Begin at 1, so that labels constructed with widthVersion of 0 are
+// always remeasured
+int LabelTrackView::msFontVersion = 1;
+
 /// We have several variants of the icons (highlighting).
 /// The icons are draggable, and you can drag one boundary
 /// or all boundaries at the same timecode depending on whether you
@@ -196,6 +200,7 @@ void LabelTrackView::ResetFont()
    wxString facename = gPrefs->Read(wxT("/GUI/LabelFontFacename"), wxT(""));
    int size = gPrefs->Read(wxT("/GUI/LabelFontSize"), DefaultFontSize);
    msFont = GetFont(facename, size);
+   ++msFontVersion;
 }
 
 /// ComputeTextPosition is 'smart' about where to display
@@ -388,6 +393,8 @@ void LabelTrackView::ComputeLayout(const wxRect & r, const ZoomInfo &zoomInfo) c
    }
    int nRowsUsed=0;
 
+   mVisibleLabels.clear();
+
    const auto pTrack = FindLabelTrack();
    const auto &mLabels = pTrack->GetLabels();
 
@@ -444,6 +451,19 @@ void LabelTrackView::ComputeLayout(const wxRect & r, const ZoomInfo &zoomInfo) c
          if( xUsed[iRow] < x1 ) xUsed[iRow]=x1;
          ComputeTextPosition( r, i );
       }
+
+      // Remember which labels can mark the viewed area (those that found
+      // no row still draw full-height lines at their ends), so that
+      // drawing and hit testing need not visit all the others.
+      int xLeft = x - mIconWidth, xRight = x1 + mIconWidth;
+      if( labelStruct.y >= 0 )
+      {
+         xLeft = wxMin( xLeft, labelStruct.xText - mIconWidth );
+         xRight = wxMax( xRight,
+            labelStruct.xText + labelStruct.width + mIconWidth );
+      }
+      if( xLeft <= r.x + r.width && xRight >= r.x )
+         mVisibleLabels.push_back( i );
    }}
 }
 
@@ -723,12 +743,15 @@ void LabelTrackView::Draw
 
    wxCoord textWidth, textHeight;
 
-   // Get the text widths.
-   // TODO: Make more efficient by only re-computing when a
-   // text label title changes.
+   // Get the text widths.  Measuring text is costly, so each width is
+   // kept until the title or the font changes; a transcript project may
+   // carry tens of thousands of labels.
    for (const auto &labelStruct : mLabels) {
-      dc.GetTextExtent(labelStruct.title, &textWidth, &textHeight);
-      labelStruct.width = textWidth;
+      if (labelStruct.widthVersion != msFontVersion) {
+         dc.GetTextExtent(labelStruct.title, &textWidth, &textHeight);
+         labelStruct.width = textWidth;
+         labelStruct.widthVersion = msFontVersion;
+      }
    }
 
    // TODO: And this only needs to be done once, but we
@@ -749,12 +772,16 @@ void LabelTrackView::Draw
    // Now we draw the various items in this order,
    // so that the correct things overpaint each other.
 
+   // The loops below visit only the labels that ComputeLayout found
+   // marking the viewed area, not the whole array.
+
    // Draw vertical lines that show where the end positions are.
-   for (const auto &labelStruct : mLabels)
-      DrawLines( dc, labelStruct, r );
+   for (int i : mVisibleLabels)
+      DrawLines( dc, mLabels[i], r );
 
    // Draw the end glyphs.
-   { int i = -1; for (const auto &labelStruct : mLabels) { ++i;
+   for (int i : mVisibleLabels) {
+      const auto &labelStruct = mLabels[i];
       GlyphLeft=0;
       GlyphRight=1;
       if( pHit && i == pHit->mMouseOverLabelLeft )
@@ -762,7 +789,7 @@ void LabelTrackView::Draw
       if( pHit && i == pHit->mMouseOverLabelRight )
          GlyphRight = (pHit->mEdge & 4) ? 7:4;
       DrawGlyphs( dc, labelStruct, r, GlyphLeft, GlyphRight );
-   }}
+   }
 
    auto &project = *artist->parent->GetProject();
 
@@ -773,7 +800,8 @@ void LabelTrackView::Draw
       auto target = dynamic_cast<LabelTextHandle*>(context.target.get());
       highlightTrack = target && target->GetTrack().get() == this;
 #endif
-      int i = -1; for (const auto &labelStruct : mLabels) { ++i;
+      for (int i : mVisibleLabels) {
+         const auto &labelStruct = mLabels[i];
          bool highlight = false;
 #ifdef EXPERIMENTAL_TRACK_PANEL_HIGHLIGHTING
          highlight = highlightTrack && target->GetLabelNum() == i;
@@ -801,13 +829,14 @@ void LabelTrackView::Draw
    }
 
    // Draw the text and the label boxes.
-   { int i = -1; for (const auto &labelStruct : mLabels) { ++i;
+   for (int i : mVisibleLabels) {
+      const auto &labelStruct = mLabels[i];
       if( GetSelectedIndex( project ) == i )
          dc.SetBrush(AColor::labelTextEditBrush);
       DrawText( dc, labelStruct, r );
       if( GetSelectedIndex( project ) == i )
          dc.SetBrush(AColor::labelTextNormalBrush);
-   }}
+   }
 
    // Draw the cursor, if there is one.
    if( mDrawCursor && HasSelection( project ) )
@@ -1092,9 +1121,6 @@ int LabelTrackView::GetSelectedIndex( AudacityProject &project ) const
       return mSelIndex = -1;
 }
 
-/// TODO: Investigate what happens with large
-/// numbers of labels, might need a binary search
-/// rather than a linear one.
 void LabelTrackView::OverGlyph(
    const LabelTrack &track, LabelTrackHit &hit, int x, int y)
 {
@@ -1110,7 +1136,13 @@ void LabelTrackView::OverGlyph(
 
    const auto pTrack = &track;
    const auto &mLabels = pTrack->GetLabels();
-   { int i = -1; for (const auto &labelStruct : mLabels) { ++i;
+   // Only the labels that the last paint laid out within the view can be
+   // under the mouse
+   const auto &visible = Get( track ).mVisibleLabels;
+   { for (int i : visible) {
+      if ( i >= (int)mLabels.size() )
+         continue;
+      const auto &labelStruct = mLabels[i];
       //over left or right selection bound
       //Check right bound first, since it is drawn after left bound,
       //so give it precedence for matching/highlighting.
@@ -1156,9 +1188,14 @@ int LabelTrackView::OverATextBox( const LabelTrack &track, int xx, int yy )
 {
    const auto pTrack = &track;
    const auto &mLabels = pTrack->GetLabels();
-   for (int nn = (int)mLabels.size(); nn--;) {
-      const auto &labelStruct = mLabels[nn];
-      if ( OverTextBox( &labelStruct, xx, yy ) )
+   // Search the labels within the view backwards, preserving the old
+   // precedence of later labels over earlier ones
+   const auto &visible = Get( track ).mVisibleLabels;
+   for (auto it = visible.rbegin(), end = visible.rend(); it != end; ++it) {
+      const int nn = *it;
+      if ( nn >= (int)mLabels.size() )
+         continue;
+      if ( OverTextBox( &mLabels[nn], xx, yy ) )
          return nn;
    }
 
@@ -1851,6 +1888,10 @@ void LabelTrackView::OnLabelAdded( LabelTrackEvent &e )
    if ( e.mpTrack.lock() != FindTrack() )
       return;
 
+   // Indices into the label array have shifted; repainting rebuilds the
+   // set of visible labels
+   mVisibleLabels.clear();
+
    const auto &title = e.mTitle;
    const auto pos = e.mPresentPosition;
 
@@ -1884,6 +1925,8 @@ void LabelTrackView::OnLabelDeleted( LabelTrackEvent &e )
    if ( e.mpTrack.lock() != FindTrack() )
       return;
 
+   mVisibleLabels.clear();
+
    auto index = e.mFormerPosition;
 
    // IF we've deleted the selected label
@@ -1907,6 +1950,8 @@ void LabelTrackView::OnLabelPermuted( LabelTrackEvent &e )
    if ( e.mpTrack.lock() != FindTrack() )
       return;
 
+   mVisibleLabels.clear();
+
    auto former = e.mFormerPosition;
    auto present = e.mPresentPosition;
 
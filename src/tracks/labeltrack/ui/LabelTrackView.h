@@ -186,6 +186,11 @@ private:
    int mRestoreFocus{-2};                          /// Restore focus to this track
                                                   /// when done editing
 
+   // Indices of the labels that the last ComputeLayout found marking the
+   // viewed area.  Drawing and hit tests visit only these, so that a
+   // label-dense track costs no more than what is on screen.
+   mutable std::vector<int> mVisibleLabels;
+
    void ComputeTextPosition(const wxRect & r, int index) const;
    void ComputeLayout(const wxRect & r, const ZoomInfo &zoomInfo) const;
    static void DrawLines( wxDC & dc, const LabelStruct &ls, const wxRect & r);
@@ -231,6 +236,10 @@ private:
    std::weak_ptr<LabelTextHandle> mTextHandle;
 
    static wxFont msFont;
+
+   // Incremented whenever msFont changes, so that every label's cached
+   // text width becomes stale (see LabelStruct::widthVersion)
+   static int msFontVersion;
 };
 
 #endif
@@ -221,8 +221,7 @@ void NoteTrackVRulerControls::UpdateRuler( const wxRect &rect )
    if (!nt)
       return;
 
-   static Ruler ruler;
-   const auto vruler = &ruler;
+   const auto vruler = &GetRuler();
 
    vruler->SetBounds(rect.x, rect.y, rect.x + 1, rect.y + rect.height-1);
    vruler->SetOrientation(wxVERTICAL);
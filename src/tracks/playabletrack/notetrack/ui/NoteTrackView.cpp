@@ -462,15 +462,17 @@ void DrawNoteTrack(TrackPanelDrawingContext &context,
    // We want to draw in seconds, so we need to convert to seconds
    seq->convert_to_seconds();
 
-   Alg_iterator iterator(seq, false);
-   iterator.begin();
-   //for every event
-   Alg_event_ptr evt;
-   while (0 != (evt = iterator.next())) {
-      if (evt->get_type() == 'n') { // 'n' means a note
-         Alg_note_ptr note = (Alg_note_ptr) evt;
+   // Extract only the notes that can intersect the window from the
+   // time-sorted index, instead of scanning every event of the sequence
+   const auto &index = track->GetNoteIndex();
+   const auto visible =
+      index.FindRange(h - track->GetOffset(), h1 - track->GetOffset());
+   //for every note that can be visible
+   for (auto pEntry = visible.first; pEntry != visible.second; ++pEntry) {
+      {
+         Alg_note_ptr note = pEntry->note;
          // if the note's channel is visible
-         if (track->IsVisibleChan(evt->chan)) {
+         if (track->IsVisibleChan(note->chan)) {
             double xx = note->time + track->GetOffset();
             double x1 = xx + note->dur;
             if (xx < h1 && x1 > h) { // omit if outside box
@@ -692,7 +694,6 @@ void DrawNoteTrack(TrackPanelDrawingContext &context,
          }
       }
    }
-   iterator.end();
    // draw black line between top/bottom margins and the track
    dc.SetPen(*wxBLACK_PEN);
    AColor::Line(dc, rect.x, rect.y + marg, rect.x + rect.width, rect.y + marg);
@@ -128,13 +128,13 @@ void SpectrumVRulerControls::UpdateRuler( const wxRect &rect )
    const auto wt = std::static_pointer_cast< WaveTrack >( FindTrack() );
    if (!wt)
       return;
-   DoUpdateVRuler( rect, wt.get() );
+   DoUpdateVRuler( GetRuler(), rect, wt.get() );
 }
 
 void SpectrumVRulerControls::DoUpdateVRuler(
-   const wxRect &rect, const WaveTrack *wt )
+   Ruler &ruler, const wxRect &rect, const WaveTrack *wt )
 {
-   auto vruler = &WaveTrackVRulerControls::ScratchRuler();
+   const auto vruler = &ruler;
    const SpectrogramSettings &settings = wt->GetSpectrogramSettings();
    float minFreq, maxFreq;
    wt->GetSpectrumBounds(&minFreq, &maxFreq);
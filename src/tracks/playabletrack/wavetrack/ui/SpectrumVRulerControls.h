@@ -47,7 +47,8 @@ private:
    // TrackVRulerControls implementation
    void UpdateRuler( const wxRect &rect ) override;
 
-   static void DoUpdateVRuler( const wxRect &rect, const WaveTrack *wt );
+   static void DoUpdateVRuler(
+      Ruler &ruler, const wxRect &rect, const WaveTrack *wt );
 
    std::weak_ptr<SpectrumVZoomHandle> mVZoomHandle;
 };
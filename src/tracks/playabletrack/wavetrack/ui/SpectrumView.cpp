@@ -86,9 +86,11 @@ std::shared_ptr<TrackVRulerControls> SpectrumView::DoGetVRulerControls()
 namespace
 {
 
-static inline float findValue
+// Reduce the bins a pixel row covers to one raw value, still in dB
+// (or autocorrelation units), before any gain/range normalization
+static inline float findBinValue
 (const float *spectrum, float bin0, float bin1, unsigned nBins,
- bool autocorrelation, int gain, int range)
+ bool autocorrelation)
 {
    float value;
 
@@ -136,6 +138,12 @@ static inline float findValue
    while (++index < limitIndex)
       value = std::max(value, spectrum[index]);
 #endif
+   return value;
+}
+
+static inline float applyGainAndRange
+(float value, bool autocorrelation, int gain, int range)
+{
    if (!autocorrelation) {
       // Last step converts dB to a 0.0-1.0 range
       value = (value + range + gain) / (double)range;
@@ -144,6 +152,15 @@ static inline float findValue
    return value;
 }
 
+static inline float findValue
+(const float *spectrum, float bin0, float bin1, unsigned nBins,
+ bool autocorrelation, int gain, int range)
+{
+   return applyGainAndRange(
+      findBinValue(spectrum, bin0, bin1, nBins, autocorrelation),
+      autocorrelation, gain, range);
+}
+
 // dashCount counts both dashes and the spaces between them.
 inline AColor::ColorGradientChoice
 ChooseColorSet( float bin0, float bin1, float selBinLo,
@@ -301,11 +318,9 @@ void DrawClipSpectrum(TrackPanelDrawingContext &context,
    }
 #endif //EXPERIMENTAL_FFT_Y_GRID
 
-   if (!updated && clip->mSpecPxCache->valid &&
+   bool pxCacheCurrent = !updated && clip->mSpecPxCache->valid &&
       ((int)clip->mSpecPxCache->len == hiddenMid.height * hiddenMid.width)
       && scaleType == clip->mSpecPxCache->scaleType
-      && gain == clip->mSpecPxCache->gain
-      && range == clip->mSpecPxCache->range
       && minFreq == clip->mSpecPxCache->minFreq
       && maxFreq == clip->mSpecPxCache->maxFreq
 #ifdef EXPERIMENTAL_FFT_Y_GRID
@@ -317,10 +332,37 @@ void DrawClipSpectrum(TrackPanelDrawingContext &context,
    && numberOfMaxima==findNotesNOld
    && findNotesQuantize==findNotesQuantizeOld
 #endif
-   ) {
+   ;
+   const bool gainRangeCurrent =
+      gain == clip->mSpecPxCache->gain &&
+      range == clip->mSpecPxCache->range;
+#ifdef EXPERIMENTAL_FIND_NOTES
+   // With note finding, gain and range also shape the maxima search,
+   // so the raw values can't simply be remapped; force the full path
+   if (fftFindNotes && !gainRangeCurrent)
+      pxCacheCurrent = false;
+#endif
+
+   if (pxCacheCurrent && gainRangeCurrent) {
       // Wave clip's spectrum cache is up to date,
       // and so is the spectrum pixel cache
    }
+   else if (pxCacheCurrent) {
+      // Only the gain or range slider moved.  The raw dB values are
+      // unaffected; just redo the cheap mapping into the 0.0-1.0
+      // colour domain, which is what makes slider drags responsive
+      // even on very large spectrograms.
+      clip->mSpecPxCache->gain = gain;
+      clip->mSpecPxCache->range = range;
+      const float *raws = clip->mSpecPxCache->rawValues.get();
+      float *values = clip->mSpecPxCache->values.get();
+      const long long limit = clip->mSpecPxCache->len;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+      for (long long ii = 0; ii < limit; ++ii)
+         values[ii] = applyGainAndRange(raws[ii], autocorrelation, gain, range);
+   }
    else {
       // Update the spectrum pixel cache
       clip->mSpecPxCache = std::make_unique<SpecPxCache>(hiddenMid.width * hiddenMid.height);
@@ -433,11 +475,14 @@ void DrawClipSpectrum(TrackPanelDrawingContext &context,
             const float nextBin = bins[yy+1];
 
             if (settings.scaleType != SpectrogramSettings::stLogarithmic) {
-               const float value = findValue
-                  (freq + nBins * xx, bin, nextBin, nBins, autocorrelation, gain, range);
-               clip->mSpecPxCache->values[xx * hiddenMid.height + yy] = value;
+               const float raw = findBinValue
+                  (freq + nBins * xx, bin, nextBin, nBins, autocorrelation);
+               clip->mSpecPxCache->rawValues[xx * hiddenMid.height + yy] = raw;
+               clip->mSpecPxCache->values[xx * hiddenMid.height + yy] =
+                  applyGainAndRange(raw, autocorrelation, gain, range);
             }
             else {
+               float raw;
                float value;
 
 #ifdef EXPERIMENTAL_FIND_NOTES
@@ -470,9 +515,17 @@ void DrawClipSpectrum(TrackPanelDrawingContext &context,
                else
 #endif //EXPERIMENTAL_FIND_NOTES
                {
-                  value = findValue
-                     (freq + nBins * xx, bin, nextBin, nBins, autocorrelation, gain, range);
+                  raw = findBinValue
+                     (freq + nBins * xx, bin, nextBin, nBins, autocorrelation);
+                  value = applyGainAndRange(raw, autocorrelation, gain, range);
                }
+#ifdef EXPERIMENTAL_FIND_NOTES
+               if (fftFindNotes)
+                  // Remapping is disabled while finding notes; just
+                  // keep the raw array coherent
+                  raw = value;
+#endif //EXPERIMENTAL_FIND_NOTES
+               clip->mSpecPxCache->rawValues[xx * hiddenMid.height + yy] = raw;
                clip->mSpecPxCache->values[xx * hiddenMid.height + yy] = value;
             } // logF
          } // each yy
@@ -647,6 +700,33 @@ void SpectrumView::Draw(
    CommonTrackView::Draw( context, rect, iPass );
 }
 
+void SpectrumView::Prefetch(
+   TrackPanelDrawingContext &context, const wxRect &rect )
+{
+   const auto artist = TrackArtist::Get( context );
+   const auto &selectedRegion = *artist->pSelectedRegion;
+   const auto &zoomInfo = *artist->pZoomInfo;
+
+   const auto wt = std::static_pointer_cast<const WaveTrack>(
+      FindTrack()->SubstitutePendingChangedTrack());
+   WaveTrackCache cache( wt );
+
+   // Fill each clip's spectrum cache with the same geometry the drawing
+   // pass will request, so that the FFTs are already done when it runs.
+   // Nothing here touches GDI objects.
+   for (const auto &clip : wt->GetClips()) {
+      const ClipParameters params{
+         true, wt.get(), clip.get(), rect, selectedRegion, zoomInfo };
+      const wxRect &hiddenMid = params.hiddenMid;
+      if (hiddenMid.width <= 0)
+         continue;
+      const float *freq = 0;
+      const sampleCount *where = 0;
+      clip->GetSpectrogram( cache, freq, where, (size_t)hiddenMid.width,
+         params.t0, params.averagePixelsPerSample * params.rate );
+   }
+}
+
 static const WaveTrackSubViews::RegisteredFactory key{
    []( WaveTrackView &view ){
       return std::make_shared< SpectrumView >( view.FindTrack() );
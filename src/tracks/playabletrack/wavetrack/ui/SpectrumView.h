@@ -36,6 +36,9 @@ private:
       TrackPanelDrawingContext &context,
       const wxRect &rect, unsigned iPass ) override;
 
+   void Prefetch(
+      TrackPanelDrawingContext &context, const wxRect &rect ) override;
+
    static void DoDraw( TrackPanelDrawingContext &context,
       const WaveTrack *track,
       const wxRect & rect );
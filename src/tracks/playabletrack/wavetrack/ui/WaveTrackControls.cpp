@@ -36,6 +36,7 @@ Paul Licameli split from TrackPanel.cpp
 #include "../../../../prefs/ThemePrefs.h"
 #include "../../../../prefs/WaveformPrefs.h"
 #include "../../../../widgets/AudacityMessageBox.h"
+#include "../../../../widgets/ProgressDialog.h"
 
 #include <wx/combobox.h>
 #include <wx/frame.h>
@@ -339,8 +340,16 @@ void FormatMenuTable::OnFormatChange(wxCommandEvent & event)
 
    AudacityProject *const project = ::GetActiveProject();
 
-   for (auto channel : TrackList::Channels(pTrack))
-      channel->ConvertToSampleFormat(newFormat);
+   {
+      ProgressDialog progress(_("Format Change"),
+         /* i18n-hint: The string names a track */
+         wxString::Format(_("Converting track '%s'"), pTrack->GetName()));
+
+      // Conversion of a track may be stopped by the user; the thrown
+      // exception then causes rollback in the application level handler.
+      for (auto channel : TrackList::Channels(pTrack))
+         channel->ConvertToSampleFormat(newFormat, &progress);
+   }
 
    /* i18n-hint: The strings name a track and a format */
    ProjectHistory::Get( *project )
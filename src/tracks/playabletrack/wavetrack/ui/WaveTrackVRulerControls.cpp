@@ -24,17 +24,11 @@ Paul Licameli split from TrackPanel.cpp
 #include "../../../../widgets/Ruler.h"
 
 ///////////////////////////////////////////////////////////////////////////////
-Ruler &WaveTrackVRulerControls::ScratchRuler()
-{
-   static Ruler theRuler;
-   return theRuler;
-}
-
 void WaveTrackVRulerControls::DoDraw( TrackVRulerControls &controls,
    TrackPanelDrawingContext &context,
    const wxRect &rect_, unsigned iPass )
 {
-   Ruler &vruler = ScratchRuler();
+   Ruler &vruler = controls.GetRuler();
 
    // Draw on a later pass because the bevel overpaints one pixel
    // out of bounds on the bottom
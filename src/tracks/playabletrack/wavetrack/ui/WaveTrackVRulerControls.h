@@ -13,13 +13,10 @@ Paul Licameli split from TrackPanel.cpp
 
 #include "../../../ui/TrackVRulerControls.h"
 
-class Ruler;
 class WaveTrack;
 
 namespace WaveTrackVRulerControls
 {
-   Ruler &ScratchRuler();
-
    void DoDraw( TrackVRulerControls &controls,
       TrackPanelDrawingContext &context,
       const wxRect &rect, unsigned iPass );
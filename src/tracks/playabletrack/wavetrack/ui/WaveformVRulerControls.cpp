@@ -170,13 +170,13 @@ void WaveformVRulerControls::UpdateRuler( const wxRect &rect )
    const auto wt = std::static_pointer_cast< WaveTrack >( FindTrack() );
    if (!wt)
       return;
-   DoUpdateVRuler( rect, wt.get() );
+   DoUpdateVRuler( GetRuler(), rect, wt.get() );
 }
 
 void WaveformVRulerControls::DoUpdateVRuler(
-   const wxRect &rect, const WaveTrack *wt )
+   Ruler &ruler, const wxRect &rect, const WaveTrack *wt )
 {
-   auto vruler = &WaveTrackVRulerControls::ScratchRuler();
+   const auto vruler = &ruler;
 
    // All waves have a ruler in the info panel
    // The ruler needs a bevelled surround.
@@ -36,6 +36,9 @@ Paul Licameli split from WaveTrackView.cpp
 
 #include <wx/graphics.h>
 #include <wx/dc.h>
+#include <wx/dcmemory.h>
+
+#include <string.h>
 
 WaveformView::~WaveformView() = default;
 
@@ -660,6 +663,46 @@ void DrawEnvelope(TrackPanelDrawingContext &context,
 // Headers needed only for experimental drawing below
 //#include "tracks/playabletrack/wavetrack/ui/SampleHandle.h"
 //#include "tracks/ui/EnvelopeHandle.h"
+// The rendered image of one clip's waveform, with the state it was
+// drawn from; a repaint that changes none of it becomes a blit
+class ClipWaveformCache final : public ClipDisplayCache {
+public:
+   wxBitmap bitmap;
+   int width{ -1 }, height{ -1 };
+   double t0{ 0 };
+   double pps{ 0 };
+   float zoomMin{ 0 }, zoomMax{ 0 };
+   double selT0{ 0 }, selT1{ 0 };
+   float dBRange{ 0 };
+   unsigned long long envelopeHash{ 0 };
+   int dirty{ -1 };
+   int colourIndex{ -1 };
+   bool dB{ false }, muted{ false }, drawEnvelope{ false },
+      highlightEnvelope{ false };
+};
+
+// Cheap fingerprint of the envelope's control points, so envelope
+// edits invalidate the rendered image without a hook into Envelope
+unsigned long long EnvelopeFingerprint(const Envelope &env)
+{
+   unsigned long long hash = 14695981039346656037ULL;
+   auto mix = [&hash](double value) {
+      unsigned long long bits;
+      memcpy(&bits, &value, sizeof(bits));
+      for (size_t ii = 0; ii < sizeof(bits); ++ii) {
+         hash ^= (bits >> (ii * 8)) & 0xff;
+         hash *= 1099511628211ULL;
+      }
+   };
+   const int nPoints = (int)env.GetNumberOfPoints();
+   mix(nPoints);
+   for (int ii = 0; ii < nPoints; ++ii) {
+      mix(env[ii].GetT());
+      mix(env[ii].GetVal());
+   }
+   return hash;
+}
+
 void DrawClipWaveform(TrackPanelDrawingContext &context,
                                    const WaveTrack *track,
                                    const WaveClip *clip,
@@ -717,6 +760,102 @@ void DrawClipWaveform(TrackPanelDrawingContext &context,
    float zoomMin, zoomMax;
    track->GetDisplayBounds(&zoomMin, &zoomMax);
 
+   // Selection times as the background pass will show them
+   double tt0, tt1;
+   if (track->GetSelected() || track->IsSyncLockSelected()) {
+      tt0 = track->LongSamplesToTime(track->TimeToLongSamples(selectedRegion.t0())),
+         tt1 = track->LongSamplesToTime(track->TimeToLongSamples(selectedRegion.t1()));
+   }
+   else
+      tt0 = tt1 = 0.0;
+
+   const double pps =
+      averagePixelsPerSample * rate;
+
+   // For each portion separately, we will decide to draw
+   // it as min/max/rms or as individual samples.
+   std::vector<WavePortion> portions;
+   FindWavePortions(portions, rect, zoomInfo, params);
+   const unsigned nPortions = portions.size();
+
+   bool hasFisheye = false;
+   for (unsigned ii = 0; ii < nPortions; ++ii)
+      hasFisheye = hasFisheye || portions[ii].inFisheye;
+
+   const auto drawEnvelope = artist->drawEnvelope;
+
+   bool highlightSamples = false;
+#ifdef EXPERIMENTAL_TRACK_PANEL_HIGHLIGHTING
+   {
+      auto sampleTarget = dynamic_cast<SampleHandle*>(context.target.get());
+      highlightSamples = sampleTarget && sampleTarget->GetTrack().get() == track;
+   }
+#endif
+
+   // The tail drawn outside the cached image: arrows when the track
+   // extends left of the beginning of time, and the clip edges
+   auto drawEdges = [&] {
+      if (h == 0.0 && tOffset < 0.0) {
+         TrackArt::DrawNegativeOffsetTrackArrows( context, rect );
+      }
+
+      dc.SetPen(*wxGREY_PEN);
+      if (tpre < 0) {
+         AColor::Line(dc,
+                      mid.x - 1, mid.y,
+                      mid.x - 1, mid.y + rect.height);
+      }
+      if (tpost > t1) {
+         AColor::Line(dc,
+                      mid.x + mid.width, mid.y,
+                      mid.x + mid.width, mid.y + rect.height);
+      }
+   };
+
+   // See whether the cached rendering of this clip still answers
+   const auto envelopeHash = EnvelopeFingerprint(*clip->GetEnvelope());
+   auto pCache =
+      dynamic_cast<ClipWaveformCache*>(clip->mClipDisplayCache.get());
+   const bool cachable =
+      !hasFisheye && !highlightSamples && mid.width > 0 && mid.height > 0;
+
+   if (cachable && pCache && pCache->IsValid() &&
+       pCache->width == mid.width && pCache->height == mid.height &&
+       pCache->t0 == t0 && pCache->pps == pps &&
+       pCache->zoomMin == zoomMin && pCache->zoomMax == zoomMax &&
+       pCache->selT0 == tt0 && pCache->selT1 == tt1 &&
+       pCache->dBRange == dBRange &&
+       pCache->envelopeHash == envelopeHash &&
+       pCache->dirty == clip->GetDirty() &&
+       pCache->colourIndex == iColorIndex &&
+       pCache->dB == dB && pCache->muted == muted &&
+       pCache->drawEnvelope == drawEnvelope &&
+       pCache->highlightEnvelope == highlightEnvelope) {
+      dc.DrawBitmap(pCache->bitmap, mid.x, mid.y);
+      if (drawEnvelope)
+         EnvelopeEditor::DrawPoints( *clip->GetEnvelope(),
+             context, rect, dB, dBRange, zoomMin, zoomMax, true );
+      drawEdges();
+      return;
+   }
+
+   // Cache miss; rasterize, into a reusable image when possible
+   wxBitmap renderBitmap;
+   wxMemoryDC memDC;
+   bool rendering = cachable;
+   if (rendering) {
+      renderBitmap.Create(mid.width, mid.height);
+      rendering = renderBitmap.IsOk();
+   }
+   if (rendering) {
+      memDC.SelectObject(renderBitmap);
+      memDC.SetDeviceOrigin(-mid.x, -mid.y);
+   }
+   TrackPanelDrawingContext renderContext{
+      rendering ? static_cast<wxDC&>(memDC) : dc,
+      context.target, context.lastState, context.pUserData };
+   renderContext.dc.SetPen(*wxTRANSPARENT_PEN);
+
    std::vector<double> vEnv(mid.width);
    double *const env = &vEnv[0];
    Envelope::GetValues( *clip->GetEnvelope(),
@@ -731,35 +870,17 @@ void DrawClipWaveform(TrackPanelDrawingContext &context,
    // Draw the background of the track, outlining the shape of
    // the envelope and using a colored pen for the selected
    // part of the waveform
-   {
-      double tt0, tt1;
-      if (track->GetSelected() || track->IsSyncLockSelected()) {
-         tt0 = track->LongSamplesToTime(track->TimeToLongSamples(selectedRegion.t0())),
-            tt1 = track->LongSamplesToTime(track->TimeToLongSamples(selectedRegion.t1()));
-      }
-      else
-         tt0 = tt1 = 0.0;
-      DrawWaveformBackground(context, leftOffset, mid,
-         env,
-         zoomMin, zoomMax,
-         track->ZeroLevelYCoordinate(mid),
-         dB, dBRange,
-         tt0, tt1,
-         !track->GetSelected(), highlightEnvelope);
-   }
+   DrawWaveformBackground(renderContext, leftOffset, mid,
+      env,
+      zoomMin, zoomMax,
+      track->ZeroLevelYCoordinate(mid),
+      dB, dBRange,
+      tt0, tt1,
+      !track->GetSelected(), highlightEnvelope);
 
    WaveDisplay display(hiddenMid.width);
    bool isLoadingOD = false;//true if loading on demand block in sequence.
 
-   const double pps =
-      averagePixelsPerSample * rate;
-
-   // For each portion separately, we will decide to draw
-   // it as min/max/rms or as individual samples.
-   std::vector<WavePortion> portions;
-   FindWavePortions(portions, rect, zoomInfo, params);
-   const unsigned nPortions = portions.size();
-
    // Require at least 1/2 pixel per sample for drawing individual samples.
    const double threshold1 = 0.5 * rate;
    // Require at least 3 pixels per sample for drawing the draggable points.
@@ -867,7 +988,7 @@ void DrawClipWaveform(TrackPanelDrawingContext &context,
                  0, // 1.0 / rate,
 
                  env2, rectPortion.width, leftOffset, zoomInfo );
-            DrawMinMaxRMS( context, rectPortion, env2,
+            DrawMinMaxRMS( renderContext, rectPortion, env2,
                zoomMin, zoomMax,
                dB, dBRange,
                useMin, useMax, useRms, useBl,
@@ -880,7 +1001,7 @@ void DrawClipWaveform(TrackPanelDrawingContext &context,
             highlight = target && target->GetTrack().get() == track;
 #endif
             DrawIndividualSamples(
-               context, leftOffset, rectPortion, zoomMin, zoomMax,
+               renderContext, leftOffset, rectPortion, zoomMin, zoomMax,
                dB, dBRange,
                clip,
                showPoints, muted, highlight );
@@ -890,32 +1011,53 @@ void DrawClipWaveform(TrackPanelDrawingContext &context,
       leftOffset += rectPortion.width + skippedRight;
    }
 
-   const auto drawEnvelope = artist->drawEnvelope;
-   if (drawEnvelope) {
+   if (drawEnvelope)
       DrawEnvelope(
-         context, mid, env, zoomMin, zoomMax, dB, dBRange, highlightEnvelope );
-      EnvelopeEditor::DrawPoints( *clip->GetEnvelope(),
-          context, rect, dB, dBRange, zoomMin, zoomMax, true );
+         renderContext, mid, env, zoomMin, zoomMax, dB, dBRange,
+         highlightEnvelope );
+
+   if (rendering) {
+      memDC.SetDeviceOrigin(0, 0);
+      memDC.SelectObject(wxNullBitmap);
+      dc.DrawBitmap(renderBitmap, mid.x, mid.y);
+
+      if (!isLoadingOD) {
+         // Remember this rendering and what it depended on
+         if (!pCache) {
+            clip->mClipDisplayCache = std::make_unique<ClipWaveformCache>();
+            pCache = static_cast<ClipWaveformCache*>(
+               clip->mClipDisplayCache.get());
+         }
+         pCache->bitmap = renderBitmap;
+         pCache->width = mid.width;
+         pCache->height = mid.height;
+         pCache->t0 = t0;
+         pCache->pps = pps;
+         pCache->zoomMin = zoomMin;
+         pCache->zoomMax = zoomMax;
+         pCache->selT0 = tt0;
+         pCache->selT1 = tt1;
+         pCache->dBRange = dBRange;
+         pCache->envelopeHash = envelopeHash;
+         pCache->dirty = clip->GetDirty();
+         pCache->colourIndex = iColorIndex;
+         pCache->dB = dB;
+         pCache->muted = muted;
+         pCache->drawEnvelope = drawEnvelope;
+         pCache->highlightEnvelope = highlightEnvelope;
+         pCache->Validate();
+      }
+      else if (pCache)
+         pCache->Invalidate();
    }
 
-   // Draw arrows on the left side if the track extends to the left of the
-   // beginning of time.  :)
-   if (h == 0.0 && tOffset < 0.0) {
-      TrackArt::DrawNegativeOffsetTrackArrows( context, rect );
-   }
+   // The envelope's draggable points belong on top of everything, and
+   // may lie outside the cached image's rectangle
+   if (drawEnvelope)
+      EnvelopeEditor::DrawPoints( *clip->GetEnvelope(),
+          context, rect, dB, dBRange, zoomMin, zoomMax, true );
 
-   // Draw clip edges
-   dc.SetPen(*wxGREY_PEN);
-   if (tpre < 0) {
-      AColor::Line(dc,
-                   mid.x - 1, mid.y,
-                   mid.x - 1, mid.y + rect.height);
-   }
-   if (tpost > t1) {
-      AColor::Line(dc,
-                   mid.x + mid.width, mid.y,
-                   mid.x + mid.width, mid.y + rect.height);
-   }
+   drawEdges();
 }
 
 void DrawTimeSlider( TrackPanelDrawingContext &context,
@@ -1082,6 +1224,38 @@ void WaveformView::Draw(
    CommonTrackView::Draw( context, rect, iPass );
 }
 
+void WaveformView::Prefetch(
+   TrackPanelDrawingContext &context, const wxRect &rect )
+{
+   const auto artist = TrackArtist::Get( context );
+   const auto &selectedRegion = *artist->pSelectedRegion;
+   const auto &zoomInfo = *artist->pZoomInfo;
+
+   const auto wt = std::static_pointer_cast<const WaveTrack>(
+      FindTrack()->SubstitutePendingChangedTrack());
+
+   // Fill each clip's wave cache with the same geometry the drawing pass
+   // will request, so that it finds the columns already computed.  The
+   // cache access is guarded by the clip's mutex, and nothing here
+   // touches GDI objects.
+   for (const auto &clip : wt->GetClips()) {
+      const ClipParameters params{
+         false, wt.get(), clip.get(), rect, selectedRegion, zoomInfo };
+      const wxRect &hiddenMid = params.hiddenMid;
+      if (hiddenMid.width <= 0)
+         continue;
+      const double pps = params.averagePixelsPerSample * params.rate;
+      // Zoomed in past 1/2 pixel per sample the drawing pass shows
+      // individual samples, reading the sequence directly; the wave
+      // cache is not consulted
+      if (pps > 0.5 * params.rate)
+         continue;
+      WaveDisplay display( hiddenMid.width );
+      bool isLoadingOD = false;
+      clip->GetWaveDisplay( display, params.t0, pps, isLoadingOD );
+   }
+}
+
 static const WaveTrackSubViews::RegisteredFactory key{
    []( WaveTrackView &view ){
       return std::make_shared< WaveformView >( view.FindTrack() );
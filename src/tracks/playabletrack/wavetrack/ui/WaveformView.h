@@ -37,6 +37,8 @@ private:
    void Draw(
       TrackPanelDrawingContext &context,
       const wxRect &rect, unsigned iPass ) override;
+   void Prefetch(
+      TrackPanelDrawingContext &context, const wxRect &rect ) override;
    static void DoDraw(TrackPanelDrawingContext &context,
                                const WaveTrack *track,
                                const wxRect & rect,
@@ -24,14 +24,6 @@ TimeTrackVRulerControls::~TimeTrackVRulerControls()
 {
 }
 
-namespace {
-   Ruler &ruler()
-   {
-      static Ruler theRuler;
-      return theRuler;
-   }
-}
-
 void TimeTrackVRulerControls::Draw(
    TrackPanelDrawingContext &context,
    const wxRect &rect_, unsigned iPass )
@@ -67,7 +59,7 @@ void TimeTrackVRulerControls::Draw(
       
       UpdateRuler(rr);
 
-      auto vruler = &ruler();
+      auto vruler = &GetRuler();
 
       vruler->SetTickColour( theTheme.Colour( clrTrackPanelText ));
       vruler->Draw(*dc);
@@ -79,7 +71,7 @@ void TimeTrackVRulerControls::UpdateRuler( const wxRect &rect )
    const auto tt = std::static_pointer_cast< TimeTrack >( FindTrack() );
    if (!tt)
       return;
-   auto vruler = &ruler();
+   auto vruler = &GetRuler();
 
    float min, max;
    min = tt->GetRangeLower() * 100.0;
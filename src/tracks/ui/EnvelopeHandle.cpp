@@ -227,6 +227,9 @@ UIHandle::Result EnvelopeHandle::Click
 
    mRect = evt.rect;
 
+   // A click may insert a point anywhere, so the whole cell repaints
+   mDamage = {};
+
    const bool needUpdate = ForwardEventToEnvelopes(event, viewInfo);
    return needUpdate ? RefreshCell : RefreshNone;
 }
@@ -243,7 +246,12 @@ UIHandle::Result EnvelopeHandle::Drag
       return RefreshCell | Cancelled;
    }
 
+   // The curve changes only between the dragged point's neighbors; union
+   // its extent before and after the move so that only that much of the
+   // waveform is re-derived and repainted
+   mDamage = EnvelopeSpan(viewInfo);
    const bool needUpdate = ForwardEventToEnvelopes(event, viewInfo);
+   mDamage.Union(EnvelopeSpan(viewInfo));
    return needUpdate ? RefreshCell : RefreshNone;
 }
 
@@ -280,6 +288,9 @@ UIHandle::Result EnvelopeHandle::Release
    if (unsafe)
       return this->Cancel(pProject);
 
+   // Releasing may delete a duplicated point; repaint the whole cell
+   mDamage = {};
+
    const bool needUpdate = ForwardEventToEnvelopes(event, viewInfo);
 
    ProjectHistory::Get( *pProject ).PushState(
@@ -299,9 +310,15 @@ UIHandle::Result EnvelopeHandle::Cancel(AudacityProject *pProject)
 {
    ProjectHistory::Get( *pProject ).RollbackState();
    mEnvelopeEditors.clear();
+   mDamage = {};
    return RefreshCode::RefreshCell;
 }
 
+wxRect EnvelopeHandle::DamagedRect() const
+{
+   return mDamage;
+}
+
 bool EnvelopeHandle::ForwardEventToEnvelopes
    (const wxMouseEvent &event, const ViewInfo &viewInfo)
 {
@@ -321,3 +338,39 @@ bool EnvelopeHandle::ForwardEventToEnvelopes
 
    return needUpdate;
 }
+
+wxRect EnvelopeHandle::EnvelopeSpan(const ViewInfo &viewInfo) const
+{
+   // Collect the horizontal extent over which the curves being dragged can
+   // change.  The dragged point may not pass its neighbors, so the curve is
+   // fixed outside of them; but if there is no neighbor on a side, the flat
+   // segment extends to the edge of the cell.
+   wxRect result;
+   for (const auto &pEditor : mEnvelopeEditors) {
+      const auto &envelope = pEditor->GetEnvelope();
+      const auto dragPoint = envelope.GetDragPoint();
+      const auto nPoints = (int)envelope.GetNumberOfPoints();
+      if (dragPoint < 0 || dragPoint >= nPoints)
+         // This envelope has no dragged point, so it isn't changing
+         continue;
+
+      const auto offset = envelope.GetOffset();
+      int left = mRect.x, right = mRect.x + mRect.width;
+      if (dragPoint > 0)
+         left = std::max( left, (int)viewInfo.TimeToPosition(
+            envelope[ dragPoint - 1 ].GetT() + offset, mRect.x ) );
+      if (dragPoint + 1 < nPoints)
+         right = std::min( right, (int)viewInfo.TimeToPosition(
+            envelope[ dragPoint + 1 ].GetT() + offset, mRect.x ) );
+
+      // Widen a little for the drawn thickness of lines and control points
+      const int slack = 5;
+      result.Union( wxRect{
+         left - slack, mRect.y, (right - left) + 2 * slack, mRect.height } );
+   }
+
+   if (result.IsEmpty())
+      // Claim no less than the whole cell when nothing narrower is known
+      return mRect;
+   return result;
+}
@@ -73,13 +73,20 @@ public:
 
    Result Cancel(AudacityProject *pProject) override;
 
+   wxRect DamagedRect() const override;
+
    bool StopsOnKeystroke() override { return true; }
 
 private:
    bool ForwardEventToEnvelopes
       (const wxMouseEvent &event, const ViewInfo &viewInfo);
 
+   wxRect EnvelopeSpan(const ViewInfo &viewInfo) const;
+
    wxRect mRect{};
+   // Union of the curve's extent before and after the latest Drag;
+   // empty means the whole cell must repaint
+   wxRect mDamage{};
    bool mLog{};
    float mLower{}, mUpper{};
    double mdBRange{};
@@ -164,6 +164,9 @@ void PlayIndicatorOverlay::OnTimer(wxCommandEvent &event)
    if (!ProjectAudioIO::Get( *mProject ).IsAudioActive()) {
       mNewIndicatorX = -1;
       mNewIsCapturing = false;
+      // So that the first tick of the next playback is not mistaken
+      // for an unchanged stream time
+      mLastPlayPos = -1.0;
       const auto &scrubber = Scrubber::Get( *mProject );
       if (scrubber.HasMark()) {
          auto position = scrubber.GetScrubStartPosition();
@@ -177,6 +180,26 @@ void PlayIndicatorOverlay::OnTimer(wxCommandEvent &event)
       // Calculate the horizontal position of the indicator
       const double playPos = viewInfo.mRecentStreamTime;
 
+      auto gAudioIO = AudioIO::Get();
+      const bool capturing = gAudioIO->IsCapturing();
+
+      // The stream time was sampled by this same timer notification;
+      // when neither it nor the view (scroll or zoom can move the
+      // indicator while paused) has changed since the last tick, the
+      // indicator, the scroll position, and the scrollbars are all
+      // where they were, and the tick costs nothing
+      const double screenEnd = viewInfo.GetScreenEndTime();
+      if (playPos == mLastPlayPos &&
+          viewInfo.h == mLastH && screenEnd == mLastScreenEnd &&
+          capturing == mNewIsCapturing) {
+         if (mPartner)
+            mPartner->Update(mNewIndicatorX);
+         return;
+      }
+      mLastPlayPos = playPos;
+      mLastH = viewInfo.h;
+      mLastScreenEnd = screenEnd;
+
       auto &window = ProjectWindow::Get( *mProject );
       using Mode = ProjectWindow::PlaybackScroller::Mode;
       const Mode mode =
@@ -191,8 +214,6 @@ void PlayIndicatorOverlay::OnTimer(wxCommandEvent &event)
          playPos,
          viewInfo.GetScreenEndTime() + tolerance);
 
-      auto gAudioIO = AudioIO::Get();
-
       // BG: Scroll screen if option is set
       if( viewInfo.bUpdateTrackIndicator &&
           playPos >= 0 && !onScreen ) {
@@ -222,10 +243,12 @@ void PlayIndicatorOverlay::OnTimer(wxCommandEvent &event)
          }
       }
 
-      // Always update scrollbars even if not scrolling the window. This is
-      // important when NEW audio is recorded, because this can change the
-      // length of the project and therefore the appearance of the scrollbar.
-      window.TP_RedrawScrollbars();
+      // Update scrollbars while recording, when NEW audio can change the
+      // length of the project and therefore the appearance of the
+      // scrollbar.  Plain playback changes neither, and redrawing them
+      // every tick was a constant repaint load
+      if (capturing)
+         window.TP_RedrawScrollbars();
 
       if (onScreen)
          mNewIndicatorX =
@@ -233,7 +256,7 @@ void PlayIndicatorOverlay::OnTimer(wxCommandEvent &event)
       else
          mNewIndicatorX = -1;
 
-      mNewIsCapturing = gAudioIO->IsCapturing();
+      mNewIsCapturing = capturing;
    }
 
    if(mPartner)
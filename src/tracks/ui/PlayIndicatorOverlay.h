@@ -57,6 +57,9 @@ private:
    void OnTimer(wxCommandEvent &event);
 
    std::shared_ptr<PlayIndicatorOverlayBase> mPartner;
+   double mLastPlayPos { -1.0 };
+   double mLastH { -1.0 };
+   double mLastScreenEnd { -1.0 };
 };
 
 #endif
@@ -26,6 +26,7 @@ Paul Licameli split from TrackPanel.cpp
 #include "../../Track.h"
 #include "../../ViewInfo.h"
 #include "../../WaveTrack.h"
+#include "../../ondemand/ODManager.h"
 #include "../../prefs/PlaybackPrefs.h"
 #include "../../prefs/TracksPrefs.h"
 #include "../../toolbars/ToolManager.h"
@@ -135,6 +136,18 @@ namespace {
          result *= -1.0;
       return result;
    }
+
+   // On-Demand: steer any decoding or summarizing toward the scrub
+   // cursor, so that compressed or network-resident blocks around it
+   // are decoded ahead of the play head, in both directions of travel,
+   // and seeks need not fall back to synchronous reads in FillBuffers
+   void DemandScrubUpdate( AudacityProject &project, double time )
+   {
+      if (!ODManager::IsInstanceCreated())
+         return;
+      for (auto wt : TrackList::Get( project ).Any< WaveTrack >())
+         ODManager::Instance()->DemandTrackUpdate(wt, time);
+   }
 }
 
 #ifdef USE_SCRUB_THREAD
@@ -604,6 +617,7 @@ void Scrubber::ContinueScrubbingPoll()
          const auto lastTime = gAudioIO->GetLastScrubTime();
          const auto delta = mLastScrubPosition - position.x;
          const double time = viewInfo.OffsetTimeByPixels(lastTime, delta);
+         DemandScrubUpdate(*mProject, time);
          mOptions.minSpeed = 0.0;
          mOptions.maxSpeed = mMaxSpeed;
          mOptions.adjustStart = true;
@@ -630,6 +644,7 @@ void Scrubber::ContinueScrubbingPoll()
             xx = origin + delta;
          }
          const double time = viewInfo.PositionToTime(xx, origin);
+         DemandScrubUpdate(*mProject, time);
          mOptions.adjustStart = seek;
          mOptions.minSpeed = seek ? 1.0 : 0.0;
          mOptions.maxSpeed = seek ? 1.0 : mMaxSpeed;
@@ -1381,6 +1381,33 @@ void SelectHandle::StartSnappingFreqSelection
 
    const double rate = pTrack->GetRate();
 
+   // First try the spectrogram display cache:  when the spectrogram is
+   // drawn, its columns over the selection are already transformed, and
+   // averaging them answers the same question the recomputation below
+   // would.  Fall through to exact recomputation only when the cache
+   // covers none of the region.
+   {
+      const SpectrogramSettings &settings = pTrack->GetSpectrogramSettings();
+      if (settings.algorithm == SpectrogramSettings::algSTFT) {
+         const auto fftLen = settings.GetFFTLength();
+         const auto nBins = settings.NBins();
+         std::vector<double> acc(nBins, 0.0);
+         unsigned nColumns = 0;
+         for (const auto &clip : pTrack->GetClips())
+            nColumns += clip->GetCachedSpectrum(settings,
+               viewInfo.selectedRegion.t0(), viewInfo.selectedRegion.t1(),
+               acc);
+         if (nColumns > 0) {
+            std::vector<float> processed(fftLen, 0.0f);
+            for (size_t ii = 0; ii < nBins; ++ii)
+               processed[ii] = 10.0 *
+                  log10(std::max(1.0e-16, acc[ii] / nColumns));
+            if (analyst.Adopt(rate, fftLen, std::move(processed)))
+               return;
+         }
+      }
+   }
+
    // Grab samples, just for this track, at these times
    std::vector<float> frequencySnappingData;
    const auto start =
@@ -18,6 +18,7 @@ Paul Licameli split from TrackPanel.cpp
 #include "../../TrackArtist.h"
 #include "../../TrackPanelDrawingContext.h"
 #include "../../ViewInfo.h"
+#include "../../widgets/Ruler.h"
 
 #include <wx/cursor.h>
 #include <wx/dc.h>
@@ -43,6 +44,13 @@ const TrackVRulerControls &TrackVRulerControls::Get( const TrackView &trackView
    return *trackView.GetVRulerControls();
 }
 
+Ruler &TrackVRulerControls::GetRuler()
+{
+   if (!mpRuler)
+      mpRuler = std::make_unique<Ruler>();
+   return *mpRuler;
+}
+
 std::shared_ptr<Track> TrackVRulerControls::DoFindTrack()
 {
    const auto pView = mwTrackView.lock();
@@ -13,6 +13,7 @@ Paul Licameli split from TrackPanel.cpp
 
 #include "CommonTrackPanelCell.h"
 
+class Ruler;
 class Track;
 class TrackView;
 class wxDC;
@@ -46,6 +47,12 @@ public:
    // cached in the associated track
    virtual void UpdateRuler( const wxRect &rect ) = 0;
 
+   // The Ruler object that this cell configures and draws.  Each instance
+   // keeps its own, so that the tick layout Ruler computes stays valid
+   // between repaints; a Ruler shared among tracks would be invalidated
+   // whenever consecutive tracks configured it differently.
+   Ruler &GetRuler();
+
 protected:
    std::shared_ptr<Track> DoFindTrack() override;
 
@@ -60,6 +67,9 @@ protected:
    Track *GetTrack() const;
 
    std::weak_ptr<TrackView> mwTrackView;
+
+private:
+   std::unique_ptr<Ruler> mpRuler;
 };
 
 #endif
@@ -47,13 +47,29 @@ wxDC &BackedPanel::GetBackingDCForRepaint()
 
 void BackedPanel::ResizeBacking()
 {
+   wxSize sz = GetClientSize();
+   // Bug 2040 - Avoid 0 x 0 bitmap when minimized.
+   sz.x = std::max(sz.x, 1);
+   sz.y = std::max(sz.y, 1);
+
+   // Keep the old bitmap while the client area still fits within it, so that
+   // shrinking the window, or minimizing and restoring it, costs no
+   // reallocation.  The bitmap never outgrows the largest client size seen.
+   if (mBacking &&
+       sz.x <= mBacking->GetWidth() && sz.y <= mBacking->GetHeight())
+      return;
+
    if (mBacking)
       mBackingDC.SelectObject(wxNullBitmap);
 
-   wxSize sz = GetClientSize();
+   // Allocate in coarse steps, so that a drag of the window border does not
+   // recreate a full-window bitmap at every one of the many size events.
+   constexpr int granularity = 256;
+   auto roundUp = [](int dim){
+      return ((dim + granularity - 1) / granularity) * granularity; };
+
    mBacking = std::make_unique<wxBitmap>();
-   // Bug 2040 - Avoid 0 x 0 bitmap when minimized.
-   mBacking->Create(std::max(sz.x,1), std::max(sz.y,1),24); //, *dc);
+   mBacking->Create(roundUp(sz.x), roundUp(sz.y), 24); //, *dc);
    mBackingDC.SelectObject(*mBacking);
 }
 
@@ -64,8 +80,14 @@ void BackedPanel::RepairBitmap(wxDC &dc, wxCoord x, wxCoord y, wxCoord width, wx
 
 void BackedPanel::DisplayBitmap(wxDC &dc)
 {
-   if( mBacking ) 
-      RepairBitmap(dc, 0, 0, mBacking->GetWidth(), mBacking->GetHeight());
+   if( mBacking ) {
+      // The bitmap may be allocated larger than the client area; blit only
+      // the part of it that is displayed.
+      wxSize sz = GetClientSize();
+      RepairBitmap(dc, 0, 0,
+         std::min(sz.x, mBacking->GetWidth()),
+         std::min(sz.y, mBacking->GetHeight()));
+   }
 }
 
 void BackedPanel::OnSize(wxSizeEvent & event)
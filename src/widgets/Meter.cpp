@@ -63,6 +63,18 @@
 
 #include <math.h>
 
+// The peak and RMS reduction runs inside the audio callback's time
+// budget; use the vector unit where the compiler is already targeting
+// one.
+#if defined(__AVX__) || defined(__SSE2__) || defined(_M_X64) || \
+   (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define METER_VECTOR_SSE
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define METER_VECTOR_NEON
+#include <arm_neon.h>
+#endif
+
 #include "../AudioIO.h"
 #include "../AColor.h"
 #include "../ImageManipulation.h"
@@ -189,8 +201,10 @@ wxString MeterUpdateMsg::toStringIfClipped()
 //
 // The MeterPanel passes itself messages via this queue so that it can
 // communicate between the audio thread and the GUI thread.
-// This class is as simple as possible in order to be thread-safe
-// without needing mutexes.
+// It is a lock-free single-producer single-consumer ring: the audio
+// callback only ever advances mEnd and the GUI thread only mStart, and
+// the release/acquire pairing makes a message's contents visible
+// before the index that publishes it.
 //
 
 MeterUpdateQueue::MeterUpdateQueue(size_t maxLen):
@@ -206,17 +220,19 @@ MeterUpdateQueue::~MeterUpdateQueue()
 
 void MeterUpdateQueue::Clear()
 {
-   mStart = 0;
-   mEnd = 0;
+   mStart.store(0, std::memory_order_relaxed);
+   mEnd.store(0, std::memory_order_release);
 }
 
 // Add a message to the end of the queue.  Return false if the
 // queue was full.
 bool MeterUpdateQueue::Put(MeterUpdateMsg &msg)
 {
+   const int start = mStart.load(std::memory_order_acquire);
+   const int end = mEnd.load(std::memory_order_relaxed);
    // mStart can be greater than mEnd because it is all mod mBufferSize
-   wxASSERT( (mEnd + mBufferSize - mStart) >= 0 );
-   int len = (mEnd + mBufferSize - mStart) % mBufferSize;
+   wxASSERT( (end + (int)mBufferSize - start) >= 0 );
+   int len = (end + mBufferSize - start) % mBufferSize;
 
    // Never completely fill the queue, because then the
    // state is ambiguous (mStart==mEnd)
@@ -225,8 +241,8 @@ bool MeterUpdateQueue::Put(MeterUpdateMsg &msg)
 
    //wxLogDebug(wxT("Put: %s"), msg.toString());
 
-   mBuffer[mEnd] = msg;
-   mEnd = (mEnd+1)%mBufferSize;
+   mBuffer[end] = msg;
+   mEnd.store((end + 1) % mBufferSize, std::memory_order_release);
 
    return true;
 }
@@ -235,13 +251,15 @@ bool MeterUpdateQueue::Put(MeterUpdateMsg &msg)
 // Return false if the queue was empty.
 bool MeterUpdateQueue::Get(MeterUpdateMsg &msg)
 {
-   int len = (mEnd + mBufferSize - mStart) % mBufferSize;
+   const int start = mStart.load(std::memory_order_relaxed);
+   const int end = mEnd.load(std::memory_order_acquire);
+   int len = (end + mBufferSize - start) % mBufferSize;
 
    if (len == 0)
       return false;
 
-   msg = mBuffer[mStart];
-   mStart = (mStart+1)%mBufferSize;
+   msg = mBuffer[start];
+   mStart.store((start + 1) % mBufferSize, std::memory_order_release);
 
    return true;
 }
@@ -765,6 +783,11 @@ void MeterPanel::OnMouse(wxMouseEvent &evt)
       wxToolTip * pTip = this->GetToolTip();
       if( pTip ) {
          wxString tipText = pTip->GetTip();
+         const float loudness = GetIntegratedLoudness();
+         if (loudness > 0)
+            // Report the level accumulated since the stream started
+            tipText += wxString::Format(_(" - average level %.1f dB"),
+               LINEAR_TO_DB(loudness));
          ProjectStatus::Get( *GetActiveProject() ).Set(tipText);
       }
    }
@@ -918,7 +941,9 @@ void MeterPanel::Reset(double sampleRate, bool resetClipping)
    for (int j = 0; j < kMaxMeterBars; j++)
    {
       ResetBar(&mBar[j], resetClipping);
+      mLoudnessSumSq[j] = 0.0;
    }
+   mLoudnessFrames = 0;
 
    // wxTimers seem to be a little unreliable - sometimes they stop for
    // no good reason, so this "primes" it every now and then...
@@ -980,7 +1005,86 @@ void MeterPanel::UpdateDisplay(unsigned numChannels, int numFrames, float *sampl
    memset(&msg, 0, sizeof(msg));
    msg.numFrames = numFrames;
 
-   for(int i=0; i<numFrames; i++) {
+   int i = 0;
+
+#if defined(METER_VECTOR_SSE) || defined(METER_VECTOR_NEON)
+   // Vector fast path for the common channel layouts, reducing four
+   // samples per step.  The sample-by-sample accounting of clipped runs
+   // matters only for stretches that actually touch full scale, which
+   // the vector comparison detects; everything else just resets the
+   // tail counts
+   if ((numChannels == 1 && num == 1) || (numChannels == 2 && num == 2)) {
+      const int framesPerPass = 4 / numChannels;
+      auto countClipped = [&](const float *frames, int firstFrame) {
+         for (int k = 0; k < framesPerPass; ++k)
+            for (unsigned int j = 0; j < num; ++j) {
+               if (fabs(frames[k * numChannels + j]) >= MAX_AUDIO) {
+                  if (msg.headPeakCount[j] == firstFrame + k)
+                     msg.headPeakCount[j]++;
+                  msg.tailPeakCount[j]++;
+                  if (msg.tailPeakCount[j] > mNumPeakSamplesToClip)
+                     msg.clipping[j] = true;
+               }
+               else
+                  msg.tailPeakCount[j] = 0;
+            }
+      };
+      float lanes[4], sums[4];
+#ifdef METER_VECTOR_SSE
+      const __m128 signMask = _mm_set1_ps(-0.0f);
+      const __m128 clipLevel = _mm_set1_ps(MAX_AUDIO);
+      __m128 vpeak = _mm_setzero_ps();
+      __m128 vsum = _mm_setzero_ps();
+      for (; i + framesPerPass <= numFrames; i += framesPerPass) {
+         const __m128 v = _mm_loadu_ps(sptr);
+         const __m128 va = _mm_andnot_ps(signMask, v);
+         vpeak = _mm_max_ps(vpeak, va);
+         vsum = _mm_add_ps(vsum, _mm_mul_ps(v, v));
+         if (_mm_movemask_ps(_mm_cmpge_ps(va, clipLevel)))
+            countClipped(sptr, i);
+         else
+            for (unsigned int j = 0; j < num; ++j)
+               msg.tailPeakCount[j] = 0;
+         sptr += 4;
+      }
+      _mm_storeu_ps(lanes, vpeak);
+      _mm_storeu_ps(sums, vsum);
+#else
+      const float32x4_t clipLevel = vdupq_n_f32(MAX_AUDIO);
+      float32x4_t vpeak = vdupq_n_f32(0.0f);
+      float32x4_t vsum = vdupq_n_f32(0.0f);
+      for (; i + framesPerPass <= numFrames; i += framesPerPass) {
+         const float32x4_t v = vld1q_f32(sptr);
+         const float32x4_t va = vabsq_f32(v);
+         vpeak = vmaxq_f32(vpeak, va);
+         vsum = vmlaq_f32(vsum, v, v);
+         const uint32x4_t clipped = vcgeq_f32(va, clipLevel);
+         const uint32x2_t folded =
+            vorr_u32(vget_low_u32(clipped), vget_high_u32(clipped));
+         if (vget_lane_u32(vpmax_u32(folded, folded), 0))
+            countClipped(sptr, i);
+         else
+            for (unsigned int j = 0; j < num; ++j)
+               msg.tailPeakCount[j] = 0;
+         sptr += 4;
+      }
+      vst1q_f32(lanes, vpeak);
+      vst1q_f32(sums, vsum);
+#endif
+      // Interleaved stereo leaves each channel in alternating lanes
+      for (unsigned int j = 0; j < num; ++j) {
+         msg.peak[j] = floatMax(lanes[j], lanes[j + numChannels]);
+         if (numChannels == 1)
+            msg.peak[j] = floatMax(msg.peak[j],
+               floatMax(lanes[2], lanes[3]));
+         msg.rms[j] = sums[j] + sums[j + numChannels];
+         if (numChannels == 1)
+            msg.rms[j] += sums[2] + sums[3];
+      }
+   }
+#endif
+
+   for(; i<numFrames; i++) {
       for(unsigned int j=0; j<num; j++) {
          msg.peak[j] = floatMax(msg.peak[j], fabs(sptr[j]));
          msg.rms[j] += sptr[j]*sptr[j];
@@ -1082,6 +1186,11 @@ void MeterPanel::OnMeterUpdate(wxTimerEvent & WXUNUSED(event))
       for(unsigned int j=0; j<mNumBars; j++) {
          mBar[j].isclipping = false;
 
+         // Integrate loudness from the aggregates while they are still
+         // linear, before the dB conversion below
+         mLoudnessSumSq[j] +=
+            (double)msg.rms[j] * msg.rms[j] * msg.numFrames;
+
          //
          if (mDB) {
             msg.peak[j] = ToDB(msg.peak[j], mDBRange);
@@ -1137,6 +1246,7 @@ void MeterPanel::OnMeterUpdate(wxTimerEvent & WXUNUSED(event))
          }
 #endif
       }
+      mLoudnessFrames += msg.numFrames;
    } // while
 
    if (numChanges > 0) {
@@ -1160,6 +1270,19 @@ float MeterPanel::GetMaxPeak() const
    return(maxPeak);
 }
 
+float MeterPanel::GetIntegratedLoudness() const
+{
+   if (mLoudnessFrames <= 0 || mNumBars == 0)
+      return 0.0;
+
+   // Mean power over all frames and channels since the last Reset
+   double sumSq = 0.0;
+   for(unsigned int j=0; j<mNumBars; j++)
+      sumSq += mLoudnessSumSq[j];
+
+   return sqrt(sumSq / (mLoudnessFrames * mNumBars));
+}
+
 wxFont MeterPanel::GetFont() const
 {
    int fontSize = 10;
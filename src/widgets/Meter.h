@@ -16,6 +16,8 @@
 #ifndef __AUDACITY_METER__
 #define __AUDACITY_METER__
 
+#include <atomic> // member variables
+
 #include <wx/setup.h> // for wxUSE_* macros
 #include <wx/brush.h> // member variable
 #include <wx/defs.h>
@@ -67,7 +69,8 @@ class MeterUpdateMsg
    wxString toStringIfClipped();
 };
 
-// Thread-safe queue of update messages
+// Lock-free single-producer single-consumer queue of update messages,
+// written by the audio callback and drained by the GUI thread
 class MeterUpdateQueue
 {
  public:
@@ -80,8 +83,8 @@ class MeterUpdateQueue
    void Clear();
 
  private:
-   int              mStart;
-   int              mEnd;
+   std::atomic<int> mStart { 0 };
+   std::atomic<int> mEnd { 0 };
    size_t           mBufferSize;
    ArrayOf<MeterUpdateMsg> mBuffer{mBufferSize};
 };
@@ -173,6 +176,13 @@ class MeterPanel final : public MeterPanelBase, private PrefsListener
 
    float GetMaxPeak() const override;
 
+   /** \brief The mean level since the meter was last reset, linear scale
+    *
+    * Accumulated from the same per-block aggregates that drive the bars,
+    * so a whole session's loudness costs no extra per-sample work.
+    * Returns 0 when nothing has been metered yet. */
+   float GetIntegratedLoudness() const;
+
    bool IsClipping() const override;
 
    void StartMonitoring();
@@ -259,6 +269,10 @@ class MeterPanel final : public MeterPanelBase, private PrefsListener
    unsigned  mNumBars;
    MeterBar  mBar[kMaxMeterBars];
 
+   // Session-long sums for GetIntegratedLoudness, reset with the bars
+   double    mLoudnessSumSq[kMaxMeterBars]{};
+   double    mLoudnessFrames{ 0 };
+
    bool      mLayoutValid;
 
    std::unique_ptr<wxBitmap> mBitmap;
@@ -52,7 +52,9 @@ void OverlayPanel::DrawOverlays(bool repaint_all, wxDC *pDC)
    // ... then assume pointers are not expired
 
    // Find out the rectangles and outdatedness for each overlay
-   wxSize size(GetBackingDC().GetSize());
+   // (Use the client size, not the size of the backing bitmap, which may be
+   // allocated larger than the displayed area)
+   wxSize size(GetClientSize());
    for (const auto pOverlay : mOverlays)
       pairs.push_back( pOverlay.lock()->GetRectangle(size) );
 
@@ -75,6 +75,30 @@ bool XMLFileReader::Parse(XMLTagHandler *baseHandler,
    }
 }
 
+bool XMLFileReader::ParseString(XMLTagHandler *baseHandler,
+                                const wxString &xmldata)
+{
+   mBaseHandler = baseHandler;
+
+   auto utf8 = xmldata.utf8_str();
+   if (!XML_Parse(mParser, utf8.data(), utf8.length(), true)) {
+      mErrorStr.Printf(_("Error: %hs at line %lu"),
+                       XML_ErrorString(XML_GetErrorCode(mParser)),
+                       (long unsigned int)XML_GetCurrentLineNumber(mParser));
+      return false;
+   }
+
+   // Even though there were no parse errors, we only succeed if
+   // the first-level handler actually got called, and didn't
+   // return false.
+   if (mBaseHandler)
+      return true;
+   else {
+      mErrorStr.Printf(_("Could not parse text data"));
+      return false;
+   }
+}
+
 wxString XMLFileReader::GetErrorStr()
 {
    return mErrorStr;
@@ -24,6 +24,9 @@ class AUDACITY_DLL_API XMLFileReader final {
    bool Parse(XMLTagHandler *baseHandler,
               const FilePath &fname);
 
+   bool ParseString(XMLTagHandler *baseHandler,
+                    const wxString &xmldata);
+
    wxString GetErrorStr();
 
    // Callback functions for expat